@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -30,7 +30,7 @@
 #include "dcmtk/dcmdata/cmdlnarg.h"
 #include "dcmtk/ofstd/ofconapp.h"
 #include "dcmtk/dcmdata/dcuid.h"       /* for dcmtk version name */
-#include "dcmtk/dcmdata/dcostrmz.h"    /* for dcmZlibCompressionLevel */
+#include "dcmtk/dcmdata/dcostrmz.h"    /* for dcmZlibCompressionLevel, dcmZlibCompressionThreads */
 #include "dcmtk/dcmdata/dcistrmz.h"    /* for dcmZlibExpectRFC1950Encoding */
 
 #ifdef WITH_ZLIB
@@ -94,6 +94,9 @@ int main(int argc, char *argv[])
   OFCmdUnsignedInt opt_itempad = 0;
 #ifdef WITH_ZLIB
   OFCmdUnsignedInt opt_compressionLevel = 0;
+#ifdef WITH_THREADS
+  OFCmdUnsignedInt opt_compressionThreads = 1;
+#endif
 #endif
 #ifdef DCMTK_ENABLE_CHARSET_CONVERSION
   const char *opt_convertToCharset = NULL;
@@ -219,9 +222,13 @@ int main(int argc, char *argv[])
       cmd.addOption("--padding-create",      "+p",  2, "[f]ile-pad [i]tem-pad: integer",
                                                        "align file on multiple of f bytes\nand items on multiple of i bytes");
 #ifdef WITH_ZLIB
-    cmd.addSubGroup("deflate compression level (only with --write-xfer-deflated):");
+    cmd.addSubGroup("deflate compression (only with --write-xfer-deflated):");
       cmd.addOption("--compression-level",   "+cl", 1, "[l]evel: integer (default: 6)",
                                                        "0=uncompressed, 1=fastest, 9=best compression");
+#ifdef WITH_THREADS
+      cmd.addOption("--compression-threads", "+ct", 1, "[n]umber: integer (1..64, default: 1)",
+                                                       "use n threads for compressing blocks of the\ndata stream in parallel");
+#endif
 #endif
 
     /* evaluate command line */
@@ -540,6 +547,14 @@ int main(int argc, char *argv[])
         app.checkValue(cmd.getValueAndCheckMinMax(opt_compressionLevel, 0, 9));
         dcmZlibCompressionLevel.set(OFstatic_cast(int, opt_compressionLevel));
       }
+#ifdef WITH_THREADS
+      if (cmd.findOption("--compression-threads"))
+      {
+        app.checkDependence("--compression-threads", "--write-xfer-deflated", opt_oxfer == EXS_DeflatedLittleEndianExplicit);
+        app.checkValue(cmd.getValueAndCheckMinMax(opt_compressionThreads, 1, 64));
+        dcmZlibCompressionThreads.set(OFstatic_cast(Uint32, opt_compressionThreads));
+      }
+#endif
 #endif
     }
 
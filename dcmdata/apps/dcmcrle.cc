@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2018, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -69,6 +69,7 @@ int main(int argc, char *argv[])
   OFBool           opt_createOffsetTable = OFTrue;
   OFBool           opt_uidcreation = OFFalse;
   OFBool           opt_secondarycapture = OFFalse;
+  OFCmdUnsignedInt opt_threads = 1;
 
   OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Encode DICOM file to RLE transfer syntax", rcsid);
   OFCommandLine cmd;
@@ -111,6 +112,11 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("SOP Instance UID:");
       cmd.addOption("--uid-never",           "+un",    "never assign new UID (default)");
       cmd.addOption("--uid-always",          "+ua",    "always assign new UID");
+#ifdef WITH_THREADS
+    cmd.addSubGroup("multi-threading:");
+      cmd.addOption("--threads",             "+pt", 1, "[n]umber: integer (1..64, default: 1)",
+                                                       "use n threads for compressing the RLE\nsegments of each frame");
+#endif
 
   cmd.addGroup("output options:");
     cmd.addSubGroup("post-1993 value representations:");
@@ -209,6 +215,11 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--uid-never")) opt_uidcreation = OFFalse;
       cmd.endOptionBlock();
 
+#ifdef WITH_THREADS
+      if (cmd.findOption("--threads"))
+        app.checkValue(cmd.getValueAndCheckMinMax(opt_threads, 1, 64));
+#endif
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--enable-new-vr")) dcmEnableGenerationOfNewVRs();
       if (cmd.findOption("--disable-new-vr")) dcmDisableGenerationOfNewVRs();
@@ -242,7 +253,8 @@ int main(int argc, char *argv[])
 
     // register RLE compression codec
     DcmRLEEncoderRegistration::registerCodecs(opt_uidcreation,
-      OFstatic_cast(Uint32, opt_fragmentSize), opt_createOffsetTable, opt_secondarycapture);
+      OFstatic_cast(Uint32, opt_fragmentSize), opt_createOffsetTable, opt_secondarycapture,
+      OFstatic_cast(Uint32, opt_threads));
 
     /* make sure data dictionary is loaded */
     if (!dcmDataDict.isDictionaryLoaded())
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2017, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -68,6 +68,7 @@ int main(int argc, char *argv[])
   // RLE parameters
   OFBool opt_uidcreation = OFFalse;
   OFBool opt_reversebyteorder = OFFalse;
+  OFCmdUnsignedInt opt_threads = 1;
 
   OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Decode RLE-compressed DICOM file", rcsid);
   OFCommandLine cmd;
@@ -95,6 +96,11 @@ int main(int argc, char *argv[])
     cmd.addSubGroup("RLE byte segment order:");
       cmd.addOption("--byte-order-default",  "+bd",    "most significant byte first (default)");
       cmd.addOption("--byte-order-reverse",  "+br",    "least significant byte first");
+#ifdef WITH_THREADS
+    cmd.addSubGroup("multi-threading:");
+      cmd.addOption("--threads",             "+pt", 1, "[n]umber: integer (1..64, default: 1)",
+                                                       "use n threads for decompressing the RLE\nsegments of each frame");
+#endif
 
   cmd.addGroup("output options:");
     cmd.addSubGroup("output file format:");
@@ -157,6 +163,11 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--byte-order-reverse")) opt_reversebyteorder = OFTrue;
       cmd.endOptionBlock();
 
+#ifdef WITH_THREADS
+      if (cmd.findOption("--threads"))
+        app.checkValue(cmd.getValueAndCheckMinMax(opt_threads, 1, 64));
+#endif
+
       cmd.beginOptionBlock();
       if (cmd.findOption("--read-file"))
       {
@@ -223,7 +234,8 @@ int main(int argc, char *argv[])
     OFLOG_DEBUG(dcmdrleLogger, rcsid << OFendl);
 
     // register global decompression codecs
-    DcmRLEDecoderRegistration::registerCodecs(opt_uidcreation, opt_reversebyteorder);
+    DcmRLEDecoderRegistration::registerCodecs(opt_uidcreation, opt_reversebyteorder,
+      OFstatic_cast(Uint32, opt_threads));
 
     /* make sure data dictionary is loaded */
     if (!dcmDataDict.isDictionaryLoaded())
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2007-2013, OFFIS e.V.
+ *  Copyright (C) 2007-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -32,6 +32,17 @@
 #include "dcmtk/dcmdata/libi2d/i2dplsc.h"
 #include "dcmtk/dcmdata/libi2d/i2dplvlp.h"
 #include "dcmtk/dcmdata/libi2d/i2dplnsc.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/ofstd/ofmap.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
+
+#if defined (HAVE_WINDOWS_H) || defined(HAVE_FNMATCH_H)
+#define PATTERN_MATCHING_AVAILABLE
+#endif
 
 #define OFFIS_CONSOLE_APPLICATION "img2dcm"
 static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v" OFFIS_DCMTK_VERSION " " OFFIS_DCMTK_RELEASEDATE " $";
@@ -41,6 +52,70 @@ static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v" OFFIS_DCMTK_VERS
 
 static OFLogger img2dcmLogger = OFLog::getLogger("dcmtk.apps." OFFIS_CONSOLE_APPLICATION);
 
+
+/* converter together with its own input and output plugin.
+ * In batch mode, each thread uses its own converter.
+ */
+struct Img2DcmConverter
+{
+  Img2DcmConverter() : i2d(), inputPlug(NULL), outPlug(NULL) {}
+
+  ~Img2DcmConverter()
+  {
+    delete outPlug;
+    delete inputPlug;
+  }
+
+  /// main class for controlling conversion
+  Image2Dcm i2d;
+
+  /// input plugin to use (i.e. file format to read)
+  I2DImgSource *inputPlug;
+
+  /// output plugin to use (i.e. SOP class to write)
+  I2DOutputPlug *outPlug;
+
+private:
+  /// private undefined copy constructor
+  Img2DcmConverter(const Img2DcmConverter&);
+
+  /// private undefined assignment operator
+  Img2DcmConverter& operator=(const Img2DcmConverter&);
+};
+
+
+/* options for writing the output DICOM files */
+struct Img2DcmWriteOptions
+{
+  Img2DcmWriteOptions()
+  : grpLengthEnc(EGL_recalcGL)
+  , lengthEnc(EET_ExplicitLength)
+  , padEnc(EPD_noChange)
+  , filepad(0)
+  , itempad(0)
+  , writeMode(EWM_fileformat)
+  {
+  }
+
+  /// group length encoding mode for output DICOM file
+  E_GrpLenEncoding grpLengthEnc;
+
+  /// item and sequence encoding mode for output DICOM file
+  E_EncodingType lengthEnc;
+
+  /// padding mode for output DICOM file
+  E_PaddingEncoding padEnc;
+
+  /// file pad length for output DICOM file
+  OFCmdUnsignedInt filepad;
+
+  /// item pad length for output DICOM file
+  OFCmdUnsignedInt itempad;
+
+  /// write only pure dataset, i.e. without meta header
+  E_FileWriteMode writeMode;
+};
+
 static OFCondition evaluateFromFileOptions(OFCommandLine& cmd,
                                            Image2Dcm& converter)
 {
@@ -86,8 +161,8 @@ static OFCondition evaluateFromFileOptions(OFCommandLine& cmd,
 
 static void addCmdLineOptions(OFCommandLine& cmd)
 {
-  cmd.addParam("imgfile-in",  "image input filename");
-  cmd.addParam("dcmfile-out", "DICOM output filename");
+  cmd.addParam("imgfile-in",  "image input filename or directory");
+  cmd.addParam("dcmfile-out", "DICOM output filename or directory");
 
   cmd.addGroup("general options:", LONGCOL, SHORTCOL + 2);
     cmd.addOption("--help",                  "-h",      "print this help text and exit", OFCommandLine::AF_Exclusive);
@@ -105,6 +180,14 @@ static void addCmdLineOptions(OFCommandLine& cmd)
       cmd.addOption("--series-from",         "-sef", 1, "[f]ilename: string",
                                                         "read patient/study/series from DICOM file f");
       cmd.addOption("--instance-inc",        "-ii",     "increase instance number read from DICOM file");
+    cmd.addSubGroup("input files:");
+      cmd.addOption("--scan-directories",    "+sd",     "convert all files in directory imgfile-in and\nwrite them to directory dcmfile-out");
+#ifdef PATTERN_MATCHING_AVAILABLE
+      cmd.addOption("--scan-pattern",        "+sp",  1, "[p]attern: string (only with --scan-directories)",
+                                                        "pattern for filename matching (wildcards)");
+#endif
+      cmd.addOption("--no-recurse",          "-r",      "do not recurse within directories (default)");
+      cmd.addOption("--recurse",             "+r",      "recurse within specified directories");
     cmd.addSubGroup("JPEG format:");
       cmd.addOption("--disable-progr",       "-dp",     "disable support for progressive JPEG");
       cmd.addOption("--disable-ext",         "-de",     "disable support for extended sequential JPEG");
@@ -125,6 +208,11 @@ static void addCmdLineOptions(OFCommandLine& cmd)
     cmd.addSubGroup("other processing options:");
       cmd.addOption("--key",                 "-k",   1, "[k]ey: gggg,eeee=\"str\", path or dict. name=\"str\"",
                                                         "add further attribute");
+#ifdef WITH_THREADS
+    cmd.addSubGroup("multi-threading:");
+      cmd.addOption("--threads",             "+pt",  1, "[n]umber: integer (1..64, default: 1)",
+                                                        "use n threads for converting files\n(only with --scan-directories)");
+#endif
 
   cmd.addGroup("output options:");
     cmd.addSubGroup("target SOP class:");
@@ -149,148 +237,57 @@ static void addCmdLineOptions(OFCommandLine& cmd)
 }
 
 
-static OFCondition startConversion(OFCommandLine& cmd,
-                                   int argc,
-                                   char *argv[])
+/* create the plugins of the given converter and configure it from the command line */
+static OFCondition configureConverter(OFCommandLine& cmd,
+                                      OFConsoleApplication& app,
+                                      Img2DcmConverter& converter)
 {
-  // Parse command line and exclusive options
-  prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
-  OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Convert standard image formats into DICOM format", rcsid);
-  if (app.parseCommandLine(cmd, argc, argv))
-  {
-    /* check exclusive options first */
-    if (cmd.hasExclusiveOption())
-    {
-      if (cmd.findOption("--version"))
-      {
-        app.printHeader(OFTrue /*print host identifier*/);
-        exit(0);
-      }
-    }
-  }
-
-  /* print resource identifier */
-  OFLOG_DEBUG(img2dcmLogger, rcsid << OFendl);
-
-  // Main class for controlling conversion
-  Image2Dcm i2d;
-  // Output plugin to use (i.e. SOP class to write)
-  I2DOutputPlug *outPlug = NULL;
-  // Input plugin to use (i.e. file format to read)
-  I2DImgSource *inputPlug = NULL;
-  // Group length encoding mode for output DICOM file
-  E_GrpLenEncoding grpLengthEnc = EGL_recalcGL;
-  // Item and Sequence encoding mode for output DICOM file
-  E_EncodingType lengthEnc = EET_ExplicitLength;
-  // Padding mode for output DICOM file
-  E_PaddingEncoding padEnc = EPD_noChange;
-  // File pad length for output DICOM file
-  OFCmdUnsignedInt filepad = 0;
-  // Item pad length for output DICOM file
-  OFCmdUnsignedInt itempad = 0;
-  // Write only pure dataset, i.e. without meta header
-  E_FileWriteMode writeMode = EWM_fileformat;
+  OFString tempStr;
+  Image2Dcm& i2d = converter.i2d;
   // Override keys are applied at the very end of the conversion "pipeline"
   OFList<OFString> overrideKeys;
-  // The transfer syntax proposed to be written by output plugin
-  E_TransferSyntax writeXfer;
-
-  // Parse rest of command line options
-  OFLog::configureFromCommandLine(cmd, app);
-
-  OFString pixDataFile, outputFile, tempStr;
-  cmd.getParam(1, tempStr);
-
-  if (tempStr.empty())
-  {
-    OFLOG_ERROR(img2dcmLogger, "No image input filename specified");
-    return EC_IllegalCall;
-  }
-  else
-    pixDataFile = tempStr;
-
-  cmd.getParam(2, tempStr);
-  if (tempStr.empty())
-  {
-    OFLOG_ERROR(img2dcmLogger, "No DICOM output filename specified");
-    return EC_IllegalCall;
-  }
-  else
-    outputFile = tempStr;
 
   if (cmd.findOption("--input-format"))
   {
     app.checkValue(cmd.getValue(tempStr));
     if (tempStr == "JPEG")
     {
-      inputPlug = new I2DJpegSource();
+      converter.inputPlug = new I2DJpegSource();
     }
     else if (tempStr == "BMP")
     {
-      inputPlug = new I2DBmpSource();
+      converter.inputPlug = new I2DBmpSource();
     }
     else
     {
       return makeOFCondition(OFM_dcmdata, 18, OF_error, "No plugin for selected input format available");
     }
-    if (!inputPlug)
+    if (!converter.inputPlug)
     {
       return EC_MemoryExhausted;
     }
   }
   else // default is JPEG
   {
-    inputPlug = new I2DJpegSource();
+    converter.inputPlug = new I2DJpegSource();
   }
-  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Instantiated input plugin: " << inputPlug->inputFormat());
+  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Instantiated input plugin: " << converter.inputPlug->inputFormat());
 
  // Find out which plugin to use
   cmd.beginOptionBlock();
   if (cmd.findOption("--sec-capture"))
-    outPlug = new I2DOutputPlugSC();
+    converter.outPlug = new I2DOutputPlugSC();
   if (cmd.findOption("--vl-photo"))
   {
-    outPlug = new I2DOutputPlugVLP();
+    converter.outPlug = new I2DOutputPlugVLP();
   }
   if (cmd.findOption("--new-sc"))
-    outPlug = new I2DOutputPlugNewSC();
-  cmd.endOptionBlock();
-  if (!outPlug) // default is the old Secondary Capture object
-    outPlug = new I2DOutputPlugSC();
-  if (outPlug == NULL) return EC_MemoryExhausted;
-  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Instantiated output plugin: " << outPlug->ident());
-
-  cmd.beginOptionBlock();
-  if (cmd.findOption("--write-file"))    writeMode = EWM_fileformat;
-  if (cmd.findOption("--write-dataset")) writeMode = EWM_dataset;
-  cmd.endOptionBlock();
-
-  cmd.beginOptionBlock();
-  if (cmd.findOption("--group-length-recalc")) grpLengthEnc = EGL_recalcGL;
-  if (cmd.findOption("--group-length-create")) grpLengthEnc = EGL_withGL;
-  if (cmd.findOption("--group-length-remove")) grpLengthEnc = EGL_withoutGL;
-  cmd.endOptionBlock();
-
-  cmd.beginOptionBlock();
-  if (cmd.findOption("--length-explicit"))  lengthEnc = EET_ExplicitLength;
-  if (cmd.findOption("--length-undefined")) lengthEnc = EET_UndefinedLength;
-  cmd.endOptionBlock();
-
-  cmd.beginOptionBlock();
-  if (cmd.findOption("--padding-off"))
-  {
-    filepad = 0;
-    itempad = 0;
-  }
-  else if (cmd.findOption("--padding-create"))
-  {
-    OFCmdUnsignedInt opt_filepad; OFCmdUnsignedInt opt_itempad;
-    app.checkValue(cmd.getValueAndCheckMin(opt_filepad, 0));
-    app.checkValue(cmd.getValueAndCheckMin(opt_itempad, 0));
-    itempad = opt_itempad;
-    filepad = opt_filepad;
-  }
+    converter.outPlug = new I2DOutputPlugNewSC();
   cmd.endOptionBlock();
+  if (!converter.outPlug) // default is the old Secondary Capture object
+    converter.outPlug = new I2DOutputPlugSC();
+  if (converter.outPlug == NULL) return EC_MemoryExhausted;
+  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Instantiated output plugin: " << converter.outPlug->ident());
 
   // create override attribute dataset (copied from findscu code)
   if (cmd.findOption("--key", 0, OFCommandLine::FOM_FirstFromLeft))
@@ -338,27 +335,19 @@ static OFCondition startConversion(OFCommandLine& cmd,
     inventType1 = OFFalse;
   cmd.endOptionBlock();
   i2d.setValidityChecking(doChecks, insertType2, inventType1);
-  outPlug->setValidityChecking(doChecks, insertType2, inventType1);
+  converter.outPlug->setValidityChecking(doChecks, insertType2, inventType1);
 
   // evaluate --xxx-from options and transfer syntax options
   OFCondition cond;
   cond = evaluateFromFileOptions(cmd, i2d);
   if (cond.bad())
-  {
-    delete outPlug; outPlug = NULL;
-    delete inputPlug; inputPlug = NULL;
     return cond;
-  }
 
-  if (inputPlug->inputFormat() == "JPEG")
+  if (converter.inputPlug->inputFormat() == "JPEG")
   {
-    I2DJpegSource *jpgSource = OFstatic_cast(I2DJpegSource*, inputPlug);
+    I2DJpegSource *jpgSource = OFstatic_cast(I2DJpegSource*, converter.inputPlug);
     if (!jpgSource)
-    {
-       delete outPlug; outPlug = NULL;
-       delete inputPlug; inputPlug = NULL;
-       return EC_MemoryExhausted;
-    }
+      return EC_MemoryExhausted;
     if ( cmd.findOption("--disable-progr") )
       jpgSource->setProgrSupport(OFFalse);
     if ( cmd.findOption("--disable-ext") )
@@ -368,32 +357,404 @@ static OFCondition startConversion(OFCommandLine& cmd,
     if ( cmd.findOption("--keep-appn") )
       jpgSource->setKeepAPPn(OFTrue);
   }
-  inputPlug->setImageFile(pixDataFile);
+  return EC_Normal;
+}
 
-  /* make sure data dictionary is loaded */
-  if (!dcmDataDict.isDictionaryLoaded())
-  {
-    OFLOG_WARN(img2dcmLogger, "no data dictionary loaded, check environment variable: "
-      << DCM_DICT_ENVIRONMENT_VARIABLE);
-  }
 
+/* convert a single image file and save the result */
+static OFCondition convertFile(Img2DcmConverter& converter,
+                               const OFString& pixDataFile,
+                               const OFString& outputFile,
+                               const Img2DcmWriteOptions& options)
+{
+  // The transfer syntax proposed to be written by output plugin
+  E_TransferSyntax writeXfer;
   DcmDataset *resultObject = NULL;
-  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Starting image conversion");
-  cond = i2d.convert(inputPlug, outPlug, resultObject, writeXfer);
+
+  converter.inputPlug->setImageFile(pixDataFile);
+  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Starting image conversion of file " << pixDataFile);
+  OFCondition cond = converter.i2d.convert(converter.inputPlug, converter.outPlug, resultObject, writeXfer);
 
   // Save
   if (cond.good())
   {
     OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Saving output DICOM to file " << outputFile);
     DcmFileFormat dcmff(resultObject);
-    cond = dcmff.saveFile(outputFile.c_str(), writeXfer, lengthEnc,  grpLengthEnc, padEnc, OFstatic_cast(Uint32, filepad), OFstatic_cast(Uint32, itempad), writeMode);
+    cond = dcmff.saveFile(outputFile.c_str(), writeXfer, options.lengthEnc, options.grpLengthEnc, options.padEnc,
+      OFstatic_cast(Uint32, options.filepad), OFstatic_cast(Uint32, options.itempad), options.writeMode);
+  }
+  delete resultObject;
+  return cond;
+}
+
+
+/* convert every step-th file of the given lists, starting with the file at index first.
+ * Returns the number of files that could not be converted.
+ */
+static size_t convertFiles(Img2DcmConverter& converter,
+                           const OFVector<OFString>& inputFiles,
+                           const OFVector<OFString>& outputFiles,
+                           const Img2DcmWriteOptions& options,
+                           size_t first,
+                           size_t step)
+{
+  size_t failures = 0;
+  for (size_t i = first; i < inputFiles.size(); i += step)
+  {
+    // the n-th file of the batch gets the instance number read from file plus n
+    // (only used with --instance-inc)
+    converter.i2d.setInstanceNumberIncrement(OFstatic_cast(Sint32, i + 1));
+    OFCondition cond = convertFile(converter, inputFiles[i], outputFiles[i], options);
+    if (cond.bad())
+    {
+      OFLOG_ERROR(img2dcmLogger, "Error converting file " << inputFiles[i] << ": " << cond.text());
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+
+#ifdef WITH_THREADS
+
+/* helper thread that converts every n-th file of a batch */
+class Img2DcmWorker: public OFThread
+{
+public:
+  Img2DcmWorker(Img2DcmConverter& converter,
+                const OFVector<OFString>& inputFiles,
+                const OFVector<OFString>& outputFiles,
+                const Img2DcmWriteOptions& options,
+                size_t first,
+                size_t step)
+  : OFThread()
+  , converter_(converter)
+  , inputFiles_(inputFiles)
+  , outputFiles_(outputFiles)
+  , options_(options)
+  , first_(first)
+  , step_(step)
+  , failures_(0)
+  {
+  }
+
+  /// converts the files assigned to this thread
+  void process()
+  {
+    failures_ = convertFiles(converter_, inputFiles_, outputFiles_, options_, first_, step_);
+  }
+
+  /// returns the number of files that could not be converted
+  size_t getNumberOfFailures() const
+  {
+    return failures_;
+  }
+
+protected:
+  /// thread entry point
+  virtual void run()
+  {
+    process();
+  }
+
+private:
+  /// private undefined copy constructor
+  Img2DcmWorker(const Img2DcmWorker&);
+
+  /// private undefined assignment operator
+  Img2DcmWorker& operator=(const Img2DcmWorker&);
+
+  Img2DcmConverter& converter_;
+  const OFVector<OFString>& inputFiles_;
+  const OFVector<OFString>& outputFiles_;
+  const Img2DcmWriteOptions& options_;
+  size_t first_;
+  size_t step_;
+  size_t failures_;
+};
+
+#endif
+
+
+/* determine the output filename for an input file found in the input directory,
+ * i.e. the same relative path in the output directory with extension ".dcm".
+ * The extension of the input file is either replaced or kept (e.g. "a.jpg.dcm").
+ */
+static OFString getBatchOutputFile(const OFString& inputDir,
+                                   const OFString& outputDir,
+                                   const OFString& inputFile,
+                                   const OFBool keepExtension)
+{
+  OFString relativeFile = inputFile;
+  OFString prefix = inputDir;
+  if (!prefix.empty() && (prefix[prefix.length() - 1] != PATH_SEPARATOR))
+    prefix += PATH_SEPARATOR;
+  if (relativeFile.compare(0, prefix.length(), prefix) == 0)
+    relativeFile.erase(0, prefix.length());
+
+  // replace the extension (if any) of the filename
+  const size_t dirPos = relativeFile.rfind(PATH_SEPARATOR);
+  const size_t extPos = relativeFile.rfind('.');
+  if (!keepExtension && (extPos != OFString_npos) && ((dirPos == OFString_npos) || (extPos > dirPos)))
+    relativeFile.erase(extPos);
+  relativeFile += ".dcm";
+
+  OFString result;
+  return OFStandard::combineDirAndFilename(result, outputDir, relativeFile, OFTrue /*allowEmptyDirName*/);
+}
+
+
+/* convert all image files found in the input directory */
+static OFCondition startBatchConversion(OFCommandLine& cmd,
+                                        OFConsoleApplication& app,
+                                        const OFString& inputDir,
+                                        const OFString& outputDir,
+                                        const Img2DcmWriteOptions& options)
+{
+  OFString pattern;
+  OFBool recurse = OFFalse;
+  OFCmdUnsignedInt numberOfThreads = 1;
+#ifdef PATTERN_MATCHING_AVAILABLE
+  if (cmd.findOption("--scan-pattern"))
+    app.checkValue(cmd.getValue(pattern));
+#endif
+  cmd.beginOptionBlock();
+  if (cmd.findOption("--no-recurse")) recurse = OFFalse;
+  if (cmd.findOption("--recurse")) recurse = OFTrue;
+  cmd.endOptionBlock();
+#ifdef WITH_THREADS
+  if (cmd.findOption("--threads"))
+    app.checkValue(cmd.getValueAndCheckMinMax(numberOfThreads, 1, 64));
+#endif
+
+  if (!OFStandard::dirExists(inputDir))
+    return makeOFCondition(OFM_dcmdata, 18, OF_error, "Image input directory does not exist");
+
+  // collect input files and determine output files
+  OFList<OFString> fileList;
+  OFStandard::searchDirectoryRecursively(inputDir, fileList, pattern, "" /*dirPrefix*/, recurse);
+  OFVector<OFString> inputFiles;
+  OFVector<OFString> outputFiles;
+  inputFiles.reserve(fileList.size());
+  outputFiles.reserve(fileList.size());
+  // number of existing files and output files using a particular filename
+  OFMap<OFString, size_t> usedNames;
+  OFListIterator(OFString) it = fileList.begin();
+  while (it != fileList.end())
+  {
+    inputFiles.push_back(*it);
+    outputFiles.push_back(getBatchOutputFile(inputDir, outputDir, *it, OFFalse /*keepExtension*/));
+    ++usedNames[outputFiles.back()];
+    ++it;
+  }
+  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Found " << inputFiles.size() << " files in directory " << inputDir);
+  if (inputFiles.empty())
+    return EC_Normal;
+  // files in the input directory must not be overwritten, even if not matching the pattern
+  if (!pattern.empty())
+  {
+    fileList.clear();
+    OFStandard::searchDirectoryRecursively(inputDir, fileList, "" /*pattern*/, "" /*dirPrefix*/, recurse);
+  }
+  for (it = fileList.begin(); it != fileList.end(); ++it)
+    ++usedNames[*it];
+
+  // keep the extension of the input file if the output filename is not unique,
+  // e.g. "a.jpg" and "a.bmp" are converted to "a.jpg.dcm" and "a.bmp.dcm"
+  size_t i;
+  for (i = 0; i < outputFiles.size(); ++i)
+  {
+    if (usedNames[outputFiles[i]] > 1)
+    {
+      outputFiles[i] = getBatchOutputFile(inputDir, outputDir, inputFiles[i], OFTrue /*keepExtension*/);
+      OFLOG_DEBUG(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Output filename for " << inputFiles[i]
+        << " is not unique, using " << outputFiles[i] << " instead");
+      ++usedNames[outputFiles[i]];
+    }
+  }
+  // this should rarely happen, e.g. for "a.jpg", "a.bmp" and "a.jpg.dcm"
+  for (i = 0; i < outputFiles.size(); ++i)
+  {
+    if (usedNames[outputFiles[i]] > 1)
+    {
+      OFLOG_ERROR(img2dcmLogger, "Cannot determine unique output filename for " << inputFiles[i]);
+      return makeOFCondition(OFM_dcmdata, 18, OF_error, "Output filenames are not unique");
+    }
+  }
+
+  // create output directories before the conversion starts (in a single thread)
+  OFCondition cond = OFStandard::createDirectory(outputDir, "" /*rootDir*/);
+  OFString dirName;
+  for (i = 0; (i < outputFiles.size()) && cond.good(); ++i)
+  {
+    OFStandard::getDirNameFromPath(dirName, outputFiles[i]);
+    if (!OFStandard::dirExists(dirName))
+      cond = OFStandard::createDirectory(dirName, outputDir);
+  }
+  if (cond.bad())
+    return cond;
+
+  // each thread uses its own converter and plugins, which are set up only once
+  if (numberOfThreads > inputFiles.size())
+    numberOfThreads = OFstatic_cast(OFCmdUnsignedInt, inputFiles.size());
+  const size_t numConverters = OFstatic_cast(size_t, numberOfThreads);
+  OFVector<Img2DcmConverter *> converters(numConverters, OFstatic_cast(Img2DcmConverter *, NULL));
+  for (i = 0; (i < numConverters) && cond.good(); ++i)
+  {
+    converters[i] = new Img2DcmConverter();
+    cond = configureConverter(cmd, app, *converters[i]);
+  }
+
+  size_t failures = 0;
+  if (cond.good())
+  {
+#ifdef WITH_THREADS
+    if (numConverters > 1)
+    {
+      OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Converting files using " << numConverters << " threads");
+      OFVector<Img2DcmWorker *> workers(numConverters, OFstatic_cast(Img2DcmWorker *, NULL));
+      OFVector<OFBool> running(numConverters, OFFalse);
+      for (i = 0; i < numConverters; ++i)
+      {
+        workers[i] = new Img2DcmWorker(*converters[i], inputFiles, outputFiles, options, i, numConverters);
+        // fall back to converting in this thread if no thread could be created
+        running[i] = (workers[i]->start() == 0);
+        if (!running[i]) workers[i]->process();
+      }
+      for (i = 0; i < numConverters; ++i)
+      {
+        if (running[i]) workers[i]->join();
+        failures += workers[i]->getNumberOfFailures();
+        delete workers[i];
+      }
+    }
+    else
+#endif
+      failures = convertFiles(*converters[0], inputFiles, outputFiles, options, 0, 1);
+  }
+
+  for (i = 0; i < numConverters; ++i)
+    delete converters[i];
+  if (cond.bad())
+    return cond;
+
+  OFLOG_INFO(img2dcmLogger, OFFIS_CONSOLE_APPLICATION ": Converted " << (inputFiles.size() - failures) << " of "
+    << inputFiles.size() << " files");
+  if (failures > 0)
+    return makeOFCondition(OFM_dcmdata, 18, OF_error, "Not all image files could be converted");
+  return EC_Normal;
+}
+
+
+static OFCondition startConversion(OFCommandLine& cmd,
+                                   int argc,
+                                   char *argv[])
+{
+  // Parse command line and exclusive options
+  prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
+  OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Convert standard image formats into DICOM format", rcsid);
+  if (app.parseCommandLine(cmd, argc, argv))
+  {
+    /* check exclusive options first */
+    if (cmd.hasExclusiveOption())
+    {
+      if (cmd.findOption("--version"))
+      {
+        app.printHeader(OFTrue /*print host identifier*/);
+        exit(0);
+      }
+    }
   }
 
-  // Cleanup and return
-  delete outPlug; outPlug = NULL;
-  delete inputPlug; inputPlug = NULL;
-  delete resultObject; resultObject = NULL;
+  /* print resource identifier */
+  OFLOG_DEBUG(img2dcmLogger, rcsid << OFendl);
+
+  // Options for writing the output DICOM files
+  Img2DcmWriteOptions options;
+  // Convert all image files of a directory
+  OFBool scanDir = OFFalse;
+
+  // Parse rest of command line options
+  OFLog::configureFromCommandLine(cmd, app);
+
+  OFString pixDataFile, outputFile, tempStr;
+  cmd.getParam(1, tempStr);
 
+  if (tempStr.empty())
+  {
+    OFLOG_ERROR(img2dcmLogger, "No image input filename specified");
+    return EC_IllegalCall;
+  }
+  else
+    pixDataFile = tempStr;
+
+  cmd.getParam(2, tempStr);
+  if (tempStr.empty())
+  {
+    OFLOG_ERROR(img2dcmLogger, "No DICOM output filename specified");
+    return EC_IllegalCall;
+  }
+  else
+    outputFile = tempStr;
+
+  if (cmd.findOption("--scan-directories")) scanDir = OFTrue;
+#ifdef PATTERN_MATCHING_AVAILABLE
+  if (cmd.findOption("--scan-pattern"))
+    app.checkDependence("--scan-pattern", "--scan-directories", scanDir);
+#endif
+  if (cmd.findOption("--recurse"))
+    app.checkDependence("--recurse", "--scan-directories", scanDir);
+#ifdef WITH_THREADS
+  if (cmd.findOption("--threads"))
+    app.checkDependence("--threads", "--scan-directories", scanDir);
+#endif
+
+  cmd.beginOptionBlock();
+  if (cmd.findOption("--write-file"))    options.writeMode = EWM_fileformat;
+  if (cmd.findOption("--write-dataset")) options.writeMode = EWM_dataset;
+  cmd.endOptionBlock();
+
+  cmd.beginOptionBlock();
+  if (cmd.findOption("--group-length-recalc")) options.grpLengthEnc = EGL_recalcGL;
+  if (cmd.findOption("--group-length-create")) options.grpLengthEnc = EGL_withGL;
+  if (cmd.findOption("--group-length-remove")) options.grpLengthEnc = EGL_withoutGL;
+  cmd.endOptionBlock();
+
+  cmd.beginOptionBlock();
+  if (cmd.findOption("--length-explicit"))  options.lengthEnc = EET_ExplicitLength;
+  if (cmd.findOption("--length-undefined")) options.lengthEnc = EET_UndefinedLength;
+  cmd.endOptionBlock();
+
+  cmd.beginOptionBlock();
+  if (cmd.findOption("--padding-off"))
+  {
+    options.filepad = 0;
+    options.itempad = 0;
+  }
+  else if (cmd.findOption("--padding-create"))
+  {
+    OFCmdUnsignedInt opt_filepad; OFCmdUnsignedInt opt_itempad;
+    app.checkValue(cmd.getValueAndCheckMin(opt_filepad, 0));
+    app.checkValue(cmd.getValueAndCheckMin(opt_itempad, 0));
+    options.itempad = opt_itempad;
+    options.filepad = opt_filepad;
+  }
+  cmd.endOptionBlock();
+
+  /* make sure data dictionary is loaded */
+  if (!dcmDataDict.isDictionaryLoaded())
+  {
+    OFLOG_WARN(img2dcmLogger, "no data dictionary loaded, check environment variable: "
+      << DCM_DICT_ENVIRONMENT_VARIABLE);
+  }
+
+  if (scanDir)
+    return startBatchConversion(cmd, app, pixDataFile, outputFile, options);
+
+  Img2DcmConverter converter;
+  OFCondition cond = configureConverter(cmd, app, converter);
+  if (cond.good())
+    cond = convertFile(converter, pixDataFile, outputFile, options);
   return cond;
 }
 
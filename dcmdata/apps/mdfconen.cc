@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2019, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -25,6 +25,7 @@
 #include "mdfdsman.h"
 #include "dcmtk/ofstd/ofstd.h"
 #include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcuidmap.h"
 #include "dcmtk/dcmdata/dcistrmz.h"    /* for dcmZlibExpectRFC1950Encoding */
 
 #define SHORTCOL 4
@@ -67,7 +68,8 @@ MdfConsoleEngine::MdfConsoleEngine(int argc, char *argv[],
     padenc_option(EPD_withoutPadding), filepad_option(0),
     itempad_option(0), ignore_missing_tags_option(OFFalse),
     no_reservation_checks(OFFalse), ignore_un_modifies(OFFalse),
-    create_if_necessary(OFFalse), was_created(OFFalse), jobs(NULL), files(NULL)
+    create_if_necessary(OFFalse), was_created(OFFalse), uid_map_file_option(),
+    uid_map(NULL), jobs(NULL), files(NULL)
 {
     char rcsid[200];
     // print application header
@@ -138,6 +140,8 @@ MdfConsoleEngine::MdfConsoleEngine(int argc, char *argv[],
             cmd->addOption("--gen-stud-uid",        "-gst",    "generate new Study Instance UID", OFCommandLine::AF_NoWarning);
             cmd->addOption("--gen-ser-uid",         "-gse",    "generate new Series Instance UID", OFCommandLine::AF_NoWarning);
             cmd->addOption("--gen-inst-uid",        "-gin",    "generate new SOP Instance UID", OFCommandLine::AF_NoWarning);
+            cmd->addOption("--map-uids",            "-mu",  1, "[f]ilename: string",
+                                                               "replace all instance UIDs by new UIDs, using\nthe persistent mapping table in file f", OFCommandLine::AF_NoWarning);
             cmd->addOption("--no-meta-uid",         "-nmu",    "do not update metaheader UIDs if related\nUIDs in the dataset are modified");
         cmd->addSubGroup("error handling:");
             cmd->addOption("--ignore-errors",       "-ie",     "continue with file, if modify error occurs");
@@ -297,6 +301,9 @@ void MdfConsoleEngine::parseNonJobOptions()
     if (cmd->findOption("--no-reserv-check"))
         no_reservation_checks = OFTrue;
 
+    if (cmd->findOption("--map-uids"))
+        app->checkValue(cmd->getValue(uid_map_file_option));
+
     if (cmd->findOption("--no-meta-uid"))
         update_metaheader_uids_option = OFFalse;
 
@@ -503,6 +510,16 @@ int MdfConsoleEngine::startProvidingService()
     int errors = 0;
     // parse command line into file and job list
     parseCommandLine();
+    // load UID mapping table (if required)
+    if (!uid_map_file_option.empty())
+    {
+        result = loadUIDMap();
+        if (result.bad())
+        {
+            OFLOG_ERROR(dcmodifyLogger, "unable to load UID mapping table " << uid_map_file_option << ": " << result.text());
+            return 1;
+        }
+    }
     // iterators for job and file loops
     OFListIterator(MdfJob) job_it;
     OFListIterator(MdfJob) job_last = jobs->end();;
@@ -525,6 +542,17 @@ int MdfConsoleEngine::startProvidingService()
                 errors += executeJob(*job_it, filename);
                 job_it++;
             }
+            // replace instance UIDs after all other modifications
+            if (uid_map != NULL)
+            {
+                OFLOG_INFO(dcmodifyLogger, "Replacing instance UIDs using mapping table: " << uid_map_file_option);
+                result = ds_man->remapUIDs(*uid_map, update_metaheader_uids_option);
+                if (result.bad())
+                {
+                    OFLOG_ERROR(dcmodifyLogger, "replacing UIDs in file " << filename << ": " << result.text());
+                    errors++;
+                }
+            }
             // if there were no errors or user wants to override them, save:
             if (errors == 0 || ignore_errors_option)
             {
@@ -573,6 +601,16 @@ int MdfConsoleEngine::startProvidingService()
         if ((file_it != file_last) || (errors > 0))
           OFLOG_INFO(dcmodifyLogger, "------------------------------------");
     }
+    // store new UID mappings, even if errors occurred for some files
+    if (uid_map != NULL)
+    {
+        result = saveUIDMap();
+        if (result.bad())
+        {
+            OFLOG_ERROR(dcmodifyLogger, "unable to save UID mapping table " << uid_map_file_option << ": " << result.text());
+            errors++;
+        }
+    }
     return errors;
 }
 
@@ -652,6 +690,30 @@ OFCondition MdfConsoleEngine::restoreFile(const char *filename)
 }
 
 
+OFCondition MdfConsoleEngine::loadUIDMap()
+{
+    delete uid_map;
+    uid_map = new DcmUIDMap();
+    // the mapping table is created if not yet existing
+    if (!OFStandard::fileExists(uid_map_file_option))
+        return EC_Normal;
+    OFLOG_INFO(dcmodifyLogger, "Loading UID mapping table: " << uid_map_file_option);
+    OFCondition result = uid_map->loadFile(uid_map_file_option);
+    if (result.good())
+        OFLOG_DEBUG(dcmodifyLogger, "UID mapping table contains " << uid_map->size() << " entries");
+    return result;
+}
+
+
+OFCondition MdfConsoleEngine::saveUIDMap()
+{
+    if (!uid_map->isModified())
+        return EC_Normal;
+    OFLOG_INFO(dcmodifyLogger, "Saving UID mapping table (" << uid_map->size() << " entries): " << uid_map_file_option);
+    return uid_map->saveFile(uid_map_file_option);
+}
+
+
 MdfConsoleEngine::~MdfConsoleEngine()
 {
     delete app;
@@ -659,4 +721,5 @@ MdfConsoleEngine::~MdfConsoleEngine()
     delete files;
     delete jobs;
     delete ds_man;
+    delete uid_map;
 }
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2018, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -32,6 +32,7 @@
 class MdfDatasetManager;
 class OFConsoleApplication;
 class OFCommandLine;
+class DcmUIDMap;
 
 
 /** class reflecting a modify operation (called Job in this context)
@@ -144,6 +145,16 @@ protected:
      */
     OFCondition restoreFile(const char *filename);
 
+    /** Load the UID mapping table from file (if the file exists)
+     *  @return OFCondition, whether loading was successful
+     */
+    OFCondition loadUIDMap();
+
+    /** Save the UID mapping table to file (if modified)
+     *  @return OFCondition, whether saving was successful
+     */
+    OFCondition saveUIDMap();
+
 private:
 
     /// helper class for console applications
@@ -207,6 +218,12 @@ private:
     /// Used to remember, whether a file was newly created.
     OFBool was_created;
 
+    /// name of the file storing the UID mapping table (empty if not used)
+    OFString uid_map_file_option;
+
+    /// table mapping old to new UIDs, used for all processed files
+    DcmUIDMap *uid_map;
+
     /// list of jobs to be executed
     OFList<MdfJob> *jobs;
 
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2017, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,6 +26,7 @@
 #include "dcmtk/ofstd/ofstd.h"
 #include "dcmtk/dcmdata/dctk.h"
 #include "dcmtk/dcmdata/dcpath.h"
+#include "dcmtk/dcmdata/dcuidmap.h"
 #include "dcmtk/dcmdata/dcistrmf.h"  /* for class DcmInputFileStream */
 
 #define INCLUDE_CSTDIO
@@ -615,6 +616,23 @@ OFCondition MdfDatasetManager::generateAndInsertUID(const DcmTagKey& uidKey)
 }
 
 
+OFCondition MdfDatasetManager::remapUIDs(DcmUIDMap &uidMap,
+                                         const OFBool update_metaheader)
+{
+    // if no file loaded : return an error
+    if (dfile==NULL)
+        return makeOFCondition(OFM_dcmdata,22,OF_error,"No file loaded yet!");
+
+    size_t count = 0;
+    OFCondition result = uidMap.remapUIDs(*dset, &count);
+    OFLOG_DEBUG(mdfdsmanLogger, "replaced UID values in " << count << " element(s)");
+    // force meta-header to refresh SOP Instance UID
+    if (result.good() && update_metaheader)
+        deleteRelatedMetaheaderTag(DCM_SOPInstanceUID);
+    return result;
+}
+
+
 OFCondition MdfDatasetManager::saveFile(const char *file_name,
                                         E_TransferSyntax opt_xfer,
                                         E_EncodingType opt_enctype,
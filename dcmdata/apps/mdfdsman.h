@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2017, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -33,6 +33,7 @@
 class DcmDataset;
 class DcmFileFormat;
 class DcmElement;
+class DcmUIDMap;
 
 
 /** This class encapsulates data structures and operations for modifying
@@ -150,6 +151,19 @@ public:
      */
     OFCondition generateAndInsertUID(const DcmTagKey &uidKey);
 
+    /** Replaces all instance UIDs in the dataset by new ones, using the given
+     *  mapping table (see DcmUIDMap::remapUIDs()). The same old UID is always
+     *  replaced by the same new UID, also across files, as long as the same
+     *  table is used.
+     *  @param uidMap [in/out] table mapping old to new UIDs. New entries are
+     *                added for all UIDs that are not yet mapped.
+     *  @param update_metaheader [in] if true, the related UIDs in the
+     *                metaheader are updated when the file is saved
+     *  @return EC_Normal, if remapping was successful, error otherwise
+     */
+    OFCondition remapUIDs(DcmUIDMap &uidMap,
+                          const OFBool update_metaheader = OFTrue);
+
      /** Saves current dataset back to a file. Caution: After saving
      *  MdfDatasetManager keeps working on old filename.
      *  @param file_name filename to save to
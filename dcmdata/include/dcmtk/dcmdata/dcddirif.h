@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,6 +26,7 @@
 #include "dcmtk/config/osconfig.h"
 
 #include "dcmtk/dcmdata/dcdicdir.h"
+#include "dcmtk/ofstd/oflist.h"
 
 
 /*------------------------------------*
@@ -301,6 +302,40 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
     OFCondition addDicomFile(const OFFilename &filename,
                              const OFFilename &directory = OFFilename());
 
+    /** add specified DICOM files to the current DICOMDIR.
+     *  This method has the same effect as calling addDicomFile() for each file of the
+     *  given list.  If more than one thread is requested, the files are loaded and
+     *  checked by a number of worker threads while the calling thread adds the records
+     *  to the DICOMDIR.  The records are always added in the order of the list, so the
+     *  resulting DICOMDIR does not depend on the number of threads.
+     *  Files that cannot be added are reported and appended to the list of bad files.
+     *  Processing stops at the first bad file if abort mode is enabled.
+     *  @param filenames list of names of the DICOM files to be added
+     *  @param directory directory where the DICOM files are stored (optional)
+     *  @param badFiles list to which the names of all files that cannot be added are
+     *    appended
+     *  @param goodFiles returns the number of files that have been added successfully.
+     *    In abort mode, this can be less than the number of files minus the number of
+     *    bad files.
+     *  @param numberOfThreads number of threads used for loading and checking the files.
+     *    The value is ignored if the toolkit has been compiled without thread support.
+     *  @return EC_Normal if no bad file was found or abort mode is disabled, an error
+     *    code otherwise
+     */
+    OFCondition addDicomFiles(const OFList<OFFilename> &filenames,
+                              const OFFilename &directory,
+                              OFList<OFFilename> &badFiles,
+                              size_t &goodFiles,
+                              const unsigned int numberOfThreads = 1);
+
+    /** check whether the given SOP instance is already referenced by a directory record
+     *  of the current DICOMDIR.  This check uses an in-memory index of the directory
+     *  records by UID, which is created on first use.
+     *  @param sopInstanceUID SOP instance UID to be checked (e.g. of a DICOM file)
+     *  @return OFTrue if the SOP instance is referenced, OFFalse otherwise
+     */
+    OFBool isSOPInstanceReferenced(const OFString &sopInstanceUID);
+
     /** set the file-set descriptor file ID and character set.
      *  Prior to any internal modification both 'filename' and 'charset' are checked
      *  using the above checking routines.  Existence of 'filename' is not checked.
@@ -404,6 +439,15 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
         return BackupMode;
     }
 
+    /** get current status of the "incremental write" mode.
+     *  See enableIncrementalWriteMode() for more details.
+     *  @return OFTrue if mode is enabled, OFFalse otherwise
+     */
+    OFBool incrementalWriteMode() const
+    {
+        return IncrementalWriteMode;
+    }
+
     /** get current status of the "pixel encoding check" mode.
      *  See disableEncodingCheck() for more details.
      *  @return OFTrue if check is enabled, OFFalse otherwise
@@ -516,6 +560,19 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
      */
     OFBool disableBackupMode(const OFBool newMode = OFFalse);
 
+    /** enable/disable the "incremental write" mode.
+     *  If this mode is enabled, an existing DICOMDIR that is appended to or updated
+     *  (see appendToDicomDir() and updateDicomDir()) is not written completely.
+     *  Instead, new records are appended to the existing file and only those records
+     *  are overwritten that have been changed.  See DcmDicomDir::setIncrementalWriteMode()
+     *  for details.  Please note that the file is modified in place, so the backup mode
+     *  should be enabled in order to preserve the original file in case of an error.
+     *  Default: off, always write the complete DICOMDIR
+     *  @param newMode enable mode if OFTrue, disable if OFFalse
+     *  @return previously stored value
+     */
+    OFBool enableIncrementalWriteMode(const OFBool newMode = OFTrue);
+
     /** disable/enable the "pixel encoding check".
      *  If this mode is disabled, the pixel encoding is not check for compliance
      *  with the selected application profile.
@@ -614,6 +671,16 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
                                       DcmFileFormat &fileformat,
                                       const OFBool checkFilename = OFTrue);
 
+    /** add loaded and successfully checked DICOM file to the current DICOMDIR
+     *  @param filename name of the DICOM file to be added
+     *  @param directory directory where the DICOM file is stored (optional)
+     *  @param fileformat object in which the loaded data is stored
+     *  @return EC_Normal upon success, an error code otherwise
+     */
+    OFCondition addCheckedDicomFile(const OFFilename &filename,
+                                    const OFFilename &directory,
+                                    DcmFileFormat &fileformat);
+
     /** check SOP class and transfer syntax for compliance with current profile
      *  @param metainfo object where the DICOM file meta information is stored
      *  @param dataset object where the DICOM dataset is stored
@@ -692,6 +759,17 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
     OFBool recordMatchesDataset(DcmDirectoryRecord *record,
                                 DcmItem *dataset);
 
+    /** add the given directory record and all its subordinate records to the UID index
+     *  @param parent parent of the record to be added
+     *  @param record directory record to be added
+     */
+    void addToRecordIndex(DcmDirectoryRecord *parent,
+                          DcmDirectoryRecord *record);
+
+    /** create the UID index of all directory records (if not already done)
+     */
+    void createRecordIndex();
+
     /** search for a given directory record
      *  @param parent higher-level structure where the records are stored
      *  @param recordType type of directory record to be searched for
@@ -1549,6 +1627,8 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
 
   private:
 
+    friend class DicomDirLoadWorker;
+
     /// pointer to the current DICOMDIR object
     DcmDicomDir *DicomDir;
 
@@ -1584,6 +1664,8 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
     OFBool IconImageMode;
     /// update existing file-set
     OFBool FilesetUpdateMode;
+    /// write existing file-set incrementally
+    OFBool IncrementalWriteMode;
 
     /// name of the DICOMDIR backup file
     OFFilename BackupFilename;
@@ -1619,6 +1701,22 @@ class DCMTK_DCMDATA_EXPORT DicomDirInterface
     /// current curve number used to invent missing attribute values
     unsigned long AutoCurveNumber;
 
+    /// entry of the UID index of directory records
+    struct RecordIndexEntry
+    {
+        /// parent of the directory record
+        DcmDirectoryRecord *Parent;
+        /// directory record with the UID
+        DcmDirectoryRecord *Record;
+    };
+
+    /** index of the study, series and instance records of the current DICOMDIR
+     *  by their UID (StudyInstanceUID, SeriesInstanceUID, ReferencedSOPInstanceUIDInFile)
+     */
+    OFMap<OFString, RecordIndexEntry> RecordIndex;
+    /// flag indicating whether the UID index contains all records of the current DICOMDIR
+    OFBool RecordIndexCreated;
+
     /// private undefined copy constructor
     DicomDirInterface(const DicomDirInterface &obj);
 
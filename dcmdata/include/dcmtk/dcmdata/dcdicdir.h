@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2014, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -121,6 +121,25 @@ public:
       const E_EncodingType enctype = EET_UndefinedLength,
       const E_GrpLenEncoding glenc = EGL_withoutGL );
 
+    /** enable or disable the incremental write mode.
+     *  If this mode is enabled and the DICOMDIR has been read from file, write() only
+     *  appends new directory records to the end of the existing file and overwrites
+     *  those parts of the file that have changed (e.g. the offset of the next record).
+     *  Please note that the file is modified in place, i.e. no temporary file is used.
+     *  The complete file is written as usual if this is not possible, e.g. because a
+     *  record has been removed or has changed its encoded length, the file has been
+     *  modified externally or a different encoding type is requested.
+     *  Default: off, always write the complete file
+     *  @param mode enable mode if OFTrue, disable if OFFalse
+     */
+    virtual void setIncrementalWriteMode(const OFBool mode);
+
+    /** get current status of the incremental write mode.
+     *  See setIncrementalWriteMode() for more details.
+     *  @return OFTrue if mode is enabled, OFFalse otherwise
+     */
+    virtual OFBool getIncrementalWriteMode() const;
+
     /** check the currently stored element value
      *  @param autocorrect correct value length if OFTrue
      *  @return status, EC_Normal if value length is correct, an error code otherwise
@@ -163,6 +182,7 @@ public:
                                      Uint32 beginOfFileSet,          // in
                                      E_TransferSyntax oxfer,         // in
                                      E_EncodingType enctype );       // in
+    OFCondition convertPointersToOffsets( DcmDataset &dset );        // inout
     OFCondition copyRecordPtrToSQ(   DcmDirectoryRecord *record,     // in
                                      DcmSequenceOfItems &toDirSQ,    // inout
                                      DcmDirectoryRecord **firstRec,  // out
@@ -182,7 +202,18 @@ public:
                                      E_TransferSyntax oxfer,        // in
                                      E_EncodingType enctype,        // in
                                      E_GrpLenEncoding glenc,        // in
-                                     DcmSequenceOfItems &unresRecs);// inout
+                                     DcmSequenceOfItems &unresRecs, // inout
+                                     OFBool computeOffsets = OFTrue);  // in
+
+    // support for the incremental write mode
+    void storeFileLayout(            DcmSequenceOfItems &recSeq,    // in
+                                     E_EncodingType enctype,        // in
+                                     Uint32 endOfRecords,           // in
+                                     offile_off_t fileSize );       // in
+    void determineFileLayout();
+    OFCondition writeIncrementally(  E_EncodingType enctype,        // in
+                                     E_GrpLenEncoding glenc,        // in
+                                     OFBool &written );             // out
 
   private:
 
@@ -216,6 +247,29 @@ public:
 
     /// container in which all MRDR (multi-reference directory records) for this DICOMDIR are kept
     DcmSequenceOfItems * MRDRSeq;
+
+    /// flag indicating whether write() should update an existing DICOMDIR file incrementally
+    OFBool incrementalWrite;
+
+    /** flag indicating whether the layout of the DICOMDIR file is known, i.e.\ whether
+     *  the following member variables describe the current file
+     */
+    OFBool layoutKnown;
+
+    /// encoding of the directory record sequence and its items in the DICOMDIR file
+    E_EncodingType layoutEncoding;
+
+    /// file offset of the first directory record in the DICOMDIR file
+    Uint32 layoutFirstRecord;
+
+    /// file offset directly after the last directory record in the DICOMDIR file
+    Uint32 layoutEndOfRecords;
+
+    /// size of the DICOMDIR file, used to detect modifications by other processes
+    offile_off_t layoutFileSize;
+
+    /// file offset and encoded length of each directory record stored in the DICOMDIR file
+    OFMap<const DcmDirectoryRecord *, OFPair<Uint32, Uint32> > layoutRecords;
 };
 
 #endif // DCDICDIR_H
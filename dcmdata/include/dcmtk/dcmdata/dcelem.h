@@ -142,6 +142,18 @@ class DCMTK_DCMDATA_EXPORT DcmElement
      */
     inline OFBool valueLoaded() const { return fValue != NULL || getLengthField() == 0; }
 
+    /** check if the value of this element still resides in a plain file (see
+     *  valueLoaded()) and determine its location, e.g. in order to refer to it
+     *  as bulk data.  The value is stored in the file in the byte order of the
+     *  transfer syntax that was used to read the element, and its size is
+     *  given by getLengthField().
+     *  @param filename name of the file containing the value returned in this parameter
+     *  @param offset position of the first byte of the value within the file returned
+     *    in this parameter
+     *  @return OFTrue if the value resides in a file, OFFalse otherwise
+     */
+    OFBool getValueFileReference(OFFilename &filename, offile_off_t &offset) const;
+
     /** initialize the transfer state of this object. This method must be called
      *  before this object is written to a stream or read (parsed) from a stream.
      */
@@ -940,6 +952,16 @@ class DCMTK_DCMDATA_EXPORT DcmElement
     virtual void writeJsonCloser(STD_NAMESPACE ostream &out,
                                  DcmJsonFormat &format);
 
+    /** write the element value Base64 encoded to the given stream.
+     *  If the value still resides in file, it is read and encoded block by block
+     *  without being loaded into memory.
+     *  @param out output stream to which the encoded value is written
+     *  @param byteOrder byte order in which the value is encoded
+     *  @return EC_Normal if successful, an error code otherwise
+     */
+    OFCondition writeBase64Value(STD_NAMESPACE ostream &out,
+                                 const E_ByteOrder byteOrder);
+
     /** return the current byte order of the value field
      *  @return current byte order of the value field
      */
@@ -312,6 +312,31 @@ class DCMTK_DCMDATA_EXPORT DcmFileFormat
                                  const E_FileReadMode readMode = ERM_autoDetect,
                                  const DcmTagKey &stopParsingAtElement = DCM_UndefinedTagKey);
 
+    /** load object from a DICOM file in bulk data mode.
+     *  This method works like loadFile(), but all element values larger than the
+     *  given threshold remain in file and are read through a single file handle
+     *  that is shared by all of them, i.e. accessing one of these values does not
+     *  re-open the file.  When the object is written with saveFile(), write() or
+     *  writeJson(), the values are copied block-wise from the source file to the
+     *  output without being loaded into memory.  The location of such a value can
+     *  be retrieved with DcmElement::getValueFileReference().
+     *  The file remains open until all elements referring to it have been deleted
+     *  or loaded into memory, e.g. with loadAllDataIntoMemory().
+     *  @param fileName name of the file to load (may contain wide chars if support enabled).
+     *  @param bulkDataThreshold element values with a larger size are not loaded
+     *    into memory but treated as bulk data
+     *  @param readXfer transfer syntax used to read the data (auto detection if EXS_Unknown)
+     *  @param groupLength flag, specifying how to handle the group length tags
+     *  @param readMode read file with or without meta header, i.e. as a fileformat or a
+     *    dataset.  Use ERM_fileOnly in order to force the presence of a meta header.
+     *  @return status, EC_Normal if successful, an error code otherwise
+     */
+    virtual OFCondition loadFileWithBulkData(const OFFilename &fileName,
+                                             const Uint32 bulkDataThreshold = DCM_MaxReadLength,
+                                             const E_TransferSyntax readXfer = EXS_Unknown,
+                                             const E_GrpLenEncoding groupLength = EGL_noChange,
+                                             const E_FileReadMode readMode = ERM_autoDetect);
+
     /** save object to a DICOM file.
      *  @param fileName name of the file to save (may contain wide chars if support enabled).
      *    Since there are various constructors for the OFFilename class, a "char *", "OFString"
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,6 +26,120 @@
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmdata/dcistrma.h"
 
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"  /* for class OFMutex */
+#endif
+
+
+/** class that manages a file handle which is shared by all input streams
+ *  reading from the same file, e.g. by all elements of a dataset whose values
+ *  have not been loaded into memory (bulk data).  Each stream maintains its
+ *  own position and reads through this object, so the file is opened only
+ *  once.  The class maintains a thread-safe reference counter, and when this
+ *  counter is decreased to zero, closes the file and deletes the handler.
+ */
+class DCMTK_DCMDATA_EXPORT DcmSharedFileHandler
+{
+public:
+
+  /** static method that permits creation of instances of
+   *  this class (only) on the heap, never on the stack.
+   *  A newly created instance always has a reference counter of 1.
+   *  @param filename name of file to be opened (may contain wide chars
+   *    if support enabled)
+   */
+  static DcmSharedFileHandler *newInstance(const OFFilename &filename);
+
+  /** returns the status of the file handle
+   *  @return EC_Normal if the file could be opened, an error code otherwise
+   */
+  OFCondition status() const
+  {
+    return status_;
+  }
+
+  /** returns the size of the file in bytes
+   *  @return size of file
+   */
+  offile_off_t size() const
+  {
+    return size_;
+  }
+
+  /** returns the name of the file
+   *  @return name of file
+   */
+  const OFFilename &getFilename() const
+  {
+    return filename_;
+  }
+
+  /** reads up to buflen bytes from the given position in file.
+   *  This method is thread-safe.
+   *  @param pos position in file from which to read
+   *  @param buf pointer to memory block, must not be NULL
+   *  @param buflen length of memory block
+   *  @return number of bytes actually read
+   */
+  offile_off_t read(offile_off_t pos, void *buf, offile_off_t buflen);
+
+  /// increase reference counter for this object
+  void increaseRefCount();
+
+  /** decreases reference counter for this object and closes the
+   *  file and deletes this object if the reference counter becomes zero.
+   */
+  void decreaseRefCount();
+
+private:
+
+  /** private constructor.
+   *  Instances of this class are always created through newInstance().
+   *  @param filename name of file to be opened
+   */
+  DcmSharedFileHandler(const OFFilename &filename);
+
+  /** private destructor. Instances of this class
+   *  are always deleted through the reference counting methods
+   */
+  virtual ~DcmSharedFileHandler();
+
+  /// private undefined copy constructor
+  DcmSharedFileHandler(const DcmSharedFileHandler& arg);
+
+  /// private undefined copy assignment operator
+  DcmSharedFileHandler& operator=(const DcmSharedFileHandler& arg);
+
+  /** number of references to this object.
+   *  Default initialized to 1 upon construction of this object
+   */
+  size_t refCount_;
+
+#ifdef WITH_THREADS
+  /// mutex for MT-safe reference counting and file access
+  /// @remark this member is only available if DCMTK is compiled with thread
+  /// support enabled.
+  OFMutex mutex_;
+#endif
+
+  /// the file we're actually reading from
+  OFFile file_;
+
+  /// status
+  OFCondition status_;
+
+  /// number of bytes in file
+  offile_off_t size_;
+
+  /** current position of the file pointer, or -1 if unknown.  Used to avoid
+   *  seeking (and thus discarding the stdio buffer) for sequential reads.
+   */
+  offile_off_t filePos_;
+
+  /// name of file
+  OFFilename filename_;
+};
+
 
 /** producer class that reads data from a plain file.
  */
@@ -39,6 +153,13 @@ public:
    */
   DcmFileProducer(const OFFilename &filename, offile_off_t offset = 0);
 
+  /** constructor. Reads from a file handle shared with other producers.
+   *  @param handler shared file handler, must not be NULL.
+   *    Reference counter of the handler is increased by this operation.
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmFileProducer(DcmSharedFileHandler *handler, offile_off_t offset = 0);
+
   /// destructor
   virtual ~DcmFileProducer();
 
@@ -103,6 +224,13 @@ private:
 
   /// number of bytes in file
   offile_off_t size_;
+
+  /// shared file handler, NULL if file_ is used
+  DcmSharedFileHandler *handler_;
+
+  /// current position in file, maintained for both file_ and handler_ in
+  /// order to avoid calling ftell() for each call of avail() and eos()
+  offile_off_t pos_;
 };
 
 
@@ -119,6 +247,14 @@ public:
    */
   DcmInputFileStreamFactory(const OFFilename &filename, offile_off_t offset);
 
+  /** constructor. The streams created by this factory read through
+   *  the given shared file handler instead of opening the file again.
+   *  @param handler shared file handler, must not be NULL.
+   *    Reference counter of the handler is increased by this operation.
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmInputFileStreamFactory(DcmSharedFileHandler *handler, offile_off_t offset);
+
   /// copy constructor
   DcmInputFileStreamFactory(const DcmInputFileStreamFactory &arg);
 
@@ -172,6 +308,9 @@ private:
   /// offset in file
   offile_off_t offset_;
 
+  /// shared file handler, may be NULL
+  DcmSharedFileHandler *handler_;
+
 };
 
 
@@ -187,6 +326,15 @@ public:
    */
   DcmInputFileStream(const OFFilename &filename, offile_off_t offset = 0);
 
+  /** constructor. Reads through the given shared file handler. All factory
+   *  objects created by newFactory() share the same handler, i.e. element
+   *  values that are loaded later do not require the file to be re-opened.
+   *  @param handler shared file handler, must not be NULL.
+   *    Reference counter of the handler is increased by this operation.
+   *  @param offset byte offset to skip from the start of file
+   */
+  DcmInputFileStream(DcmSharedFileHandler *handler, offile_off_t offset = 0);
+
   /// destructor
   virtual ~DcmInputFileStream();
 
@@ -214,6 +362,9 @@ private:
 
   /// filename
   OFFilename filename_;
+
+  /// shared file handler, may be NULL
+  DcmSharedFileHandler *handler_;
 };
 
 /** class that manages the life cycle of a temporary file.
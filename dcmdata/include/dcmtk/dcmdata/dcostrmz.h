@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -40,6 +40,18 @@ END_EXTERN_C
  */
 extern DCMTK_DCMDATA_EXPORT OFGlobal<int> dcmZlibCompressionLevel;
 
+/** global flag defining the number of threads used for zlib (deflate)
+ *  compression. If the value is greater than 1, the stream is compressed
+ *  by class DcmZLibParallelOutputFilter, which divides it into blocks that
+ *  are compressed in parallel. Default is 1, i.e. the stream is compressed
+ *  in a single thread by class DcmZLibOutputFilter. At most 64 threads are
+ *  used; each of them needs about 512 kB of memory.
+ *  @remark this flag is only available if DCMTK is compiled with
+ *  ZLIB support enabled. It is ignored if DCMTK is compiled without
+ *  thread support.
+ */
+extern DCMTK_DCMDATA_EXPORT OFGlobal<Uint32> dcmZlibCompressionThreads;
+
 /** zlib compression filter for output streams.
  *  @remark this class is only available if DCMTK is compiled with
  *  ZLIB support enabled.
@@ -179,5 +191,154 @@ private:
 
 };
 
+#ifdef WITH_THREADS
+
+class DcmZLibBlockCompressor;
+
+/** zlib compression filter for output streams that compresses the stream
+ *  in several threads. The stream is divided into blocks of 128 kbytes,
+ *  each of which is compressed independently (using the last 32 kbytes of
+ *  the preceding block as dictionary, so that the compression ratio is
+ *  almost the same as for DcmZLibOutputFilter) and terminated with a sync
+ *  flush, except for the last block. The concatenation of the compressed
+ *  blocks is a single deflate stream that can be decompressed by any zlib
+ *  compliant decoder, but it is not identical to the output of
+ *  DcmZLibOutputFilter. Compressed data that cannot be passed to the next
+ *  stage immediately is kept in a buffer that grows as needed.
+ *  @remark this class is only available if DCMTK is compiled with
+ *  ZLIB and thread support enabled.
+ */
+class DCMTK_DCMDATA_EXPORT DcmZLibParallelOutputFilter: public DcmOutputFilter
+{
+public:
+
+  /** constructor
+   *  @param numberOfThreads number of threads used for compression, i.e.\ the
+   *    number of blocks that are compressed in parallel. Values greater
+   *    than 64 are treated as 64.
+   */
+  DcmZLibParallelOutputFilter(Uint32 numberOfThreads);
+
+  /// destructor
+  virtual ~DcmZLibParallelOutputFilter();
+
+  /** returns the status of the consumer. Unless the status is good,
+   *  the consumer will not permit any operation.
+   *  @return status, true if good
+   */
+  virtual OFBool good() const;
+
+  /** returns the status of the consumer as an OFCondition object.
+   *  Unless the status is good, the consumer will not permit any operation.
+   *  @return status, EC_Normal if good
+   */
+  virtual OFCondition status() const;
+
+  /** returns true if the consumer is flushed, i.e. has no more data
+   *  pending in it's internal state that needs to be flushed before
+   *  the stream is closed.
+   *  @return true if consumer is flushed, false otherwise
+   */
+  virtual OFBool isFlushed() const;
+
+  /** returns the minimum number of bytes that can be written with the
+   *  next call to write().
+   *  @return minimum of space available in consumer
+   */
+  virtual offile_off_t avail() const;
+
+  /** processes as many bytes as possible from the given input block.
+   *  @param buf pointer to memory block, must not be NULL
+   *  @param buflen length of memory block
+   *  @return number of bytes actually processed.
+   */
+  virtual offile_off_t write(const void *buf, offile_off_t buflen);
+
+  /** instructs the consumer to flush its internal content until
+   *  either the consumer becomes "flushed" or I/O suspension occurs.
+   *  After a call to flush(), a call to write() will produce undefined
+   *  behaviour.
+   */
+  virtual void flush();
+
+  /** determines the consumer to which the filter is supposed
+   *  to write it's output.  Once a consumer for the output filter has
+   *  been defined, it cannot be changed anymore during the lifetime
+   *  of the object.
+   *  @param consumer reference to consumer, must not be circular chain
+   */
+  virtual void append(DcmConsumer& consumer);
+
+private:
+
+  /// private unimplemented copy constructor
+  DcmZLibParallelOutputFilter(const DcmZLibParallelOutputFilter&);
+
+  /// private unimplemented copy assignment operator
+  DcmZLibParallelOutputFilter& operator=(const DcmZLibParallelOutputFilter&);
+
+  /** writes the content of the output buffer to the next filter stage
+   *  until the output buffer becomes empty or the next filter stage
+   *  becomes full
+   */
+  void flushOutputBuffer();
+
+  /** compresses the blocks in the input buffer in parallel and appends
+   *  the compressed data to the output buffer. Afterwards, the input
+   *  buffer only contains the dictionary for the next block.
+   *  @param finalize true if the content of the input buffer constitutes
+   *    the end of the input stream, i.e. the last block should terminate
+   *    the compressed stream.
+   */
+  void compressInputBuffer(OFBool finalize);
+
+  /** appends the given data to the output buffer, enlarging it if necessary
+   *  @param buf pointer to data
+   *  @param buflen number of bytes in buf
+   */
+  void fillOutputBuffer(const unsigned char *buf, offile_off_t buflen);
+
+  /// pointer to consumer to which compressed output is written
+  DcmConsumer *current_;
+
+  /// status
+  OFCondition status_;
+
+  /// true if the last block of the stream has been compressed
+  OFBool flushed_;
+
+  /// number of threads, i.e. number of blocks compressed in parallel
+  Uint32 numberOfThreads_;
+
+  /// array of numberOfThreads_ block compressors
+  DcmZLibBlockCompressor **compressors_;
+
+  /** input buffer, consisting of the dictionary (i.e. the end of the
+   *  preceding input) followed by up to numberOfThreads_ blocks of input
+   */
+  unsigned char *inputBuf_;
+
+  /// number of bytes of the dictionary at the start of the input buffer
+  offile_off_t dictionaryCount_;
+
+  /// number of bytes of input following the dictionary in the input buffer
+  offile_off_t inputBufCount_;
+
+  /// output buffer
+  unsigned char *outputBuf_;
+
+  /// size of the output buffer
+  offile_off_t outputBufSize_;
+
+  /// offset of first byte in output buffer
+  offile_off_t outputBufStart_;
+
+  /// number of bytes in output buffer
+  offile_off_t outputBufCount_;
+
+};
+
+#endif
+
 #endif
 #endif
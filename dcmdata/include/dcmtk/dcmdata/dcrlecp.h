@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2014, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -44,13 +44,17 @@ public:
    *  @param pReverseDecompressionByteOrder flag indicating whether the byte order should
    *    be reversed upon decompression. Needed to correctly decode some incorrectly encoded
    *    images with more than one byte per sample.
+   *  @param pNumberOfThreads number of threads used for compressing or
+   *    decompressing the RLE segments of a frame in parallel (ignored if
+   *    DCMTK is compiled without thread support)
    */
   DcmRLECodecParameter(
     OFBool pCreateSOPInstanceUID = OFFalse,
     Uint32 pFragmentSize = 0,
     OFBool pCreateOffsetTable = OFTrue,
     OFBool pConvertToSC = OFFalse,
-    OFBool pReverseDecompressionByteOrder = OFFalse);
+    OFBool pReverseDecompressionByteOrder = OFFalse,
+    Uint32 pNumberOfThreads = 1);
 
   /// copy constructor
   DcmRLECodecParameter(const DcmRLECodecParameter& arg);
@@ -109,6 +113,15 @@ public:
     return reverseDecompressionByteOrder;
   }
 
+  /** returns the number of threads used for processing the RLE segments
+   *  of a frame in parallel
+   *  @return number of threads
+   */
+  Uint32 getNumberOfThreads() const
+  {
+    return numberOfThreads;
+  }
+
 
 private:
 
@@ -131,6 +144,9 @@ private:
    *  decompress certain incorrectly encoded RLE images
    */
   OFBool reverseDecompressionByteOrder;
+
+  /// number of threads used for processing the RLE segments of a frame in parallel
+  Uint32 numberOfThreads;
 };
 
 
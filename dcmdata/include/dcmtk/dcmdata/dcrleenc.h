@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2011, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -177,7 +177,17 @@ public:
   {
     if (buf)
     {
-      while (bufcount--) add(*buf++);
+      size_t run;
+      while (bufcount)
+      {
+        // all but the first byte of a run of identical bytes only increase
+        // the repeat counter, so the run can be added as a whole
+        run = runLength(buf, bufcount);
+        add(*buf);
+        if (! fail_) RLE_pcount_ += OFstatic_cast(int, run - 1);
+        buf += run;
+        bufcount -= run;
+      }
     }
   }
 
@@ -340,8 +350,9 @@ private:
    */
   inline void move(size_t numberOfBytes)
   {
-    size_t i=0;
-    while (i < numberOfBytes)
+    const unsigned char *source = RLE_buff_;
+    size_t count;
+    while (numberOfBytes > 0)
     {
       if (offset_ == DcmRLEEncoder_BLOCKSIZE)
       {
@@ -354,10 +365,43 @@ private:
           break;    // exit while loop
         }
       }
-      currentBlock_[offset_++] = RLE_buff_[i++];
+      count = DcmRLEEncoder_BLOCKSIZE - offset_;
+      if (count > numberOfBytes) count = numberOfBytes;
+      memcpy(currentBlock_ + offset_, source, count);
+      offset_ += count;
+      source += count;
+      numberOfBytes -= count;
     }
   }
 
+  /** determines the number of identical bytes at the start of the given buffer.
+   *  Long runs are compared one machine word at a time.
+   *  @param buf pointer to buffer, must not be NULL
+   *  @param bufcount number of bytes in buffer, must be greater than zero
+   *  @return length of the run, at least 1
+   */
+  static inline size_t runLength(const unsigned char *buf, size_t bufcount)
+  {
+    const unsigned char ch = *buf;
+    size_t result = 1;
+    // most runs in literal data are short, so check the first bytes individually
+    while ((result < bufcount) && (result < sizeof(size_t)) && (buf[result] == ch)) ++result;
+    if (result == sizeof(size_t))
+    {
+      // a word with all bytes set to ch
+      const size_t pattern = (OFstatic_cast(size_t, -1) / 255) * ch;
+      size_t word;
+      while (result + sizeof(size_t) <= bufcount)
+      {
+        memcpy(&word, buf + result, sizeof(size_t));
+        if (word != pattern) break;
+        result += sizeof(size_t);
+      }
+      while ((result < bufcount) && (buf[result] == ch)) ++result;
+    }
+    return result;
+  }
+
   /* member variables */
 
   /** this flag indicates a failure of the RLE codec.  Once a failure is
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2011, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -44,12 +44,15 @@ public:
    *  @param pCreateOffsetTable create offset table during image compression?
    *  @param pConvertToSC flag indicating whether image should be converted to
    *    Secondary Capture upon compression
+   *  @param pNumberOfThreads number of threads used for compressing the
+   *    RLE segments of a frame in parallel
    */
   static void registerCodecs(
     OFBool pCreateSOPInstanceUID = OFFalse,
     Uint32 pFragmentSize = 0,
     OFBool pCreateOffsetTable = OFTrue,
-    OFBool pConvertToSC = OFFalse);
+    OFBool pConvertToSC = OFFalse,
+    Uint32 pNumberOfThreads = 1);
 
   /** deregisters encoder.
    *  Attention: Must not be called while other threads might still use
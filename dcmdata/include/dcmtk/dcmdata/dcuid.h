@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -27,6 +27,7 @@
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 
 #include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/ofstd/ofstring.h"
 #include "dcmtk/dcmdata/dcdefine.h"
 
 #define INCLUDE_CSTDLIB
@@ -154,6 +155,70 @@ DCMTK_DCMDATA_EXPORT OFBool dcmIsImageStorageSOPClassUID(const char* uid);
  */
 DCMTK_DCMDATA_EXPORT char *dcmGenerateUniqueIdentifier(char *uid, const char* prefix=NULL);
 
+/** fast generator for a large number of Unique Identifiers.
+ *  In contrast to dcmGenerateUniqueIdentifier(), which determines the host ID,
+ *  process ID and system time and acquires a global lock for each new UID, this
+ *  class computes the constant part of the UID (prefix, host ID, process ID,
+ *  creation time and a process-wide unique generator number) only once and then
+ *  just appends a local counter. The generated UIDs are therefore one component
+ *  longer than those created by dcmGenerateUniqueIdentifier(), so the prefix
+ *  should be kept reasonably short. If the prefix is too long, the host ID,
+ *  process ID and/or creation time are omitted, i.e. the UIDs are only
+ *  guaranteed to be unique within the current process (a warning is logged).
+ *  The counter is never truncated; if it does not fit into the UID anymore, a
+ *  new constant part with a new generator number is computed.
+ *  An instance of this class is not thread-safe. Multi-threaded applications
+ *  should create one generator per thread, which requires no synchronization.
+ */
+class DCMTK_DCMDATA_EXPORT DcmUIDGenerator
+{
+public:
+
+    /** constructor
+     *  @param prefix prefix for UID creation. If NULL, a default of
+     *    SITE_INSTANCE_UID_ROOT will be used.
+     */
+    DcmUIDGenerator(const char *prefix = NULL);
+
+    /** create a new Unique Identifier in uid and return uid.
+     *  Care is taken to make sure that the generated UID is 64 characters or less.
+     *  @param uid pointer to buffer of 65 or more characters in which the UID is returned
+     *  @return pointer to UID, identical to uid parameter. The UID is empty if the
+     *    prefix is too long for creating unique UIDs (an error is logged).
+     */
+    char *generate(char *uid);
+
+    /** create a new Unique Identifier and return it as a string
+     *  @return newly created UID, empty if the prefix is too long
+     */
+    OFString generate();
+
+    /** get the prefix used for UID creation
+     *  @return prefix used for UID creation
+     */
+    const OFString &getPrefix() const
+    {
+        return Prefix;
+    }
+
+private:
+
+    /// determine the constant part of the UIDs (called again when the counter overflows)
+    void initialize();
+
+    /// prefix for UID creation
+    OFString Prefix;
+
+    /// constant part of the UIDs, i.e. everything but the counter
+    char Base[65];
+
+    /// length of the constant part of the UIDs
+    size_t BaseLength;
+
+    /// counter for the last component of the UIDs
+    Uint32 Counter;
+};
+
 /** performs a table lookup and returns a short modality identifier
  *  that can be used for building file names etc.
  *  Identifiers are defined for all storage SOP classes.
@@ -0,0 +1,233 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Class for the persistent mapping of old to new UIDs
+ *
+ */
+
+#ifndef DCUIDMAP_H
+#define DCUIDMAP_H
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/ofcond.h"
+#include "dcmtk/ofstd/offile.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/dcmdata/dctagkey.h"
+#include "dcmtk/dcmdata/dcuid.h"
+
+// forward declarations
+class DcmItem;
+
+
+/** table that maps old UIDs to newly generated UIDs, e.g.\ for the
+ *  de-identification of a large number of DICOM instances. The first time an
+ *  old UID is looked up, a new UID is created using a DcmUIDGenerator and
+ *  stored in the table, so that all references to the same UID (in the same
+ *  or in other datasets) are replaced consistently.
+ *  The table can be saved to and loaded from a text file, which contains one
+ *  mapping per line ("<old UID> <new UID>"), in order to continue a batch
+ *  run later or to re-identify instances by reading the file the other way
+ *  round. Lines starting with '#' are ignored.
+ *  In order to keep large tables (millions of UIDs) in memory, each mapping is
+ *  stored as a pair of null-terminated strings in a large memory block, and
+ *  an open addressing hash table is used for the look-up. Each mapping takes
+ *  the length of both UIDs plus 2 bytes, and 16 to 32 bytes in the hash table
+ *  (on 64-bit systems). For 1 million mappings with old UIDs of 51 and new
+ *  UIDs of about 60 characters, 119 bytes per mapping were measured, compared
+ *  to 240 bytes for a map with two strings per entry. The memory of a replaced
+ *  mapping (see addMapping()) is only freed by clear() or when the table is
+ *  destroyed.
+ *  All public methods are thread-safe if the toolkit is compiled with
+ *  multi-thread support.
+ */
+class DCMTK_DCMDATA_EXPORT DcmUIDMap
+{
+public:
+
+    /** constructor
+     *  @param prefix prefix for the newly generated UIDs. If NULL, a default of
+     *    SITE_INSTANCE_UID_ROOT will be used.
+     */
+    DcmUIDMap(const char *prefix = NULL);
+
+    /// destructor
+    ~DcmUIDMap();
+
+    /** load mappings from a text file. Existing entries of this table are
+     *  retained, entries with the same old UID are replaced.
+     *  @param filename name of the file to be read
+     *  @return status, EC_Normal if successful, an error code otherwise
+     */
+    OFCondition loadFile(const OFFilename &filename);
+
+    /** save all mappings of this table to a text file (sorted by old UID).
+     *  An existing file with the same name is replaced. The mappings are
+     *  written to a temporary file (filename + ".tmp") first, which is then
+     *  renamed, so the existing file is kept if writing fails. On systems
+     *  where renaming does not replace an existing file, the existing file is
+     *  moved to filename + ".bak" and only removed after the temporary file
+     *  has been renamed. If renaming fails, the temporary file is kept and
+     *  its name is reported in the returned error.
+     *  @param filename name of the file to be written
+     *  @return status, EC_Normal if successful, an error code otherwise
+     */
+    OFCondition saveFile(const OFFilename &filename);
+
+    /** get the new UID for the given old UID. If there is no such entry in
+     *  the table, a new UID is generated and stored.
+     *  @param oldUID old UID to be mapped
+     *  @param newUID variable receiving the new UID that replaces the old UID
+     *  @return status, EC_InvalidValue if no new UID could be generated (e.g.
+     *    because the prefix is too long), EC_Normal otherwise
+     */
+    OFCondition mapUID(const OFString &oldUID,
+                       OFString &newUID);
+
+    /** look up the new UID for the given old UID (without creating one)
+     *  @param oldUID old UID to be looked up
+     *  @param newUID variable receiving the new UID (if found)
+     *  @return OFTrue if an entry exists for the given old UID, OFFalse otherwise
+     */
+    OFBool findUID(const OFString &oldUID,
+                   OFString &newUID);
+
+    /** add a mapping to the table or replace an existing one
+     *  @param oldUID old UID
+     *  @param newUID new UID that replaces the old UID
+     *  @return status, EC_InvalidValue if one of the UIDs is not valid,
+     *    EC_Normal otherwise
+     */
+    OFCondition addMapping(const OFString &oldUID,
+                           const OFString &newUID);
+
+    /** replace all UID values in the given dataset or item (including nested
+     *  sequences) by their mapped counterparts. UIDs defined by the DICOM
+     *  standard (root "1.2.840.10008") as well as values of attributes that
+     *  identify a class (e.g.\ SOP Class UID or Transfer Syntax UID) are never
+     *  replaced. A File Meta Information header is not updated by this method.
+     *  @param item dataset or item to be processed
+     *  @param count optional pointer to a variable receiving the number of
+     *    modified elements
+     *  @return status, EC_Normal if successful, an error code otherwise
+     *    (EC_InvalidValue if no new UID could be generated). In case of error,
+     *    the dataset may already be partly modified.
+     */
+    OFCondition remapUIDs(DcmItem &item,
+                          size_t *count = NULL);
+
+    /** get number of mappings in this table
+     *  @return number of mappings
+     */
+    size_t size();
+
+    /** check whether this table has been modified since it was last loaded
+     *  from or saved to a file
+     *  @return OFTrue if modified, OFFalse otherwise
+     */
+    OFBool isModified();
+
+    /// remove all mappings from this table
+    void clear();
+
+protected:
+
+    /** check whether a UID value of the given attribute should be replaced
+     *  @param tag tag key of the attribute containing the UID
+     *  @param uid UID value to be checked
+     *  @return OFTrue if the UID should be replaced, OFFalse otherwise
+     */
+    static OFBool isMappable(const DcmTagKey &tag,
+                             const OFString &uid);
+
+private:
+
+    /** look up or create mapping, caller has to hold the lock
+     *  @param oldUID old UID to be mapped
+     *  @return pointer to the new UID, NULL if no new UID could be generated
+     */
+    const char *lookupOrCreate(const OFString &oldUID);
+
+    /** look up mapping, caller has to hold the lock
+     *  @param oldUID old UID to be looked up
+     *  @return pointer to the new UID, NULL if there is no such mapping
+     */
+    const char *lookup(const char *oldUID) const;
+
+    /** add mapping or replace an existing one, caller has to hold the lock
+     *  @param oldUID old UID
+     *  @param newUID new UID that replaces the old UID
+     *  @return pointer to the stored copy of the new UID
+     */
+    const char *store(const OFString &oldUID,
+                      const OFString &newUID);
+
+    /** get index of the hash table slot for the given old UID, i.e.\ the slot
+     *  containing the mapping or the empty slot where it would be inserted.
+     *  The hash table must not be empty.
+     *  @param oldUID old UID to be looked up
+     *  @return index of the slot
+     */
+    size_t findSlot(const char *oldUID) const;
+
+    /// double the size of the hash table (or create it) and re-insert all mappings
+    void growSlots();
+
+    /// remove all mappings and free the memory
+    void freeTable();
+
+    /// generator for the new UIDs
+    DcmUIDGenerator Generator;
+
+    /// memory blocks storing the mappings ("<old UID>\0<new UID>\0")
+    OFVector<char *> Blocks;
+
+    /// size of the last memory block
+    size_t BlockSize;
+
+    /// number of bytes used in the last memory block
+    size_t BlockUsed;
+
+    /** hash table with pointers to the mappings in the memory blocks,
+     *  NULL for empty slots. The number of slots is a power of 2.
+     */
+    const char **Slots;
+
+    /// number of slots in the hash table
+    size_t NumSlots;
+
+    /// number of mappings in the hash table
+    size_t NumEntries;
+
+    /// flag indicating whether the table has been modified
+    OFBool Modified;
+
+#ifdef WITH_THREADS
+    /// mutex protecting the table and the generator
+    OFMutex Mutex;
+#endif
+
+    /// private undefined copy constructor
+    DcmUIDMap(const DcmUIDMap &);
+
+    /// private undefined assignment operator
+    DcmUIDMap &operator=(const DcmUIDMap &);
+};
+
+#endif // DCUIDMAP_H
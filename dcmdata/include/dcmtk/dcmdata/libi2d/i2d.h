@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2001-2011, OFFIS e.V.
+ *  Copyright (C) 2001-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -54,18 +54,24 @@ public:
 
   /** Sets a DICOM file that should serve as a template for the resulting
     * DICOM object. Only the dataset of the given file is imported.
+    * The file is loaded during the first conversion and the dataset is
+    * kept in memory for all further conversions.
     * @param file - [in] The filename of the template DICOM file
     * @return none
     */
   void setTemplateFile(const OFString& file);
 
   /** Set file from which patient/study/series data should be imported from.
+   *  The file is loaded during the first conversion and the dataset is
+   *  kept in memory for all further conversions.
    *  @param file - [in] The DICOM file to read from
    *  @return none
    */
   void setSeriesFrom(const OFString& file);
 
-  /** Set file from which patient/study/series data should be imported from.
+  /** Set file from which patient/study data should be imported from.
+   *  The file is loaded during the first conversion and the dataset is
+   *  kept in memory for all further conversions.
    *  @param file - [in] The DICOM file to read from
    *  @return none
    */
@@ -79,6 +85,15 @@ public:
    */
   void setIncrementInstanceNumber(OFBool incInstNo);
 
+  /** Sets the value that is added to the instance number taken over from
+   *  DICOM file if incrementing is enabled (see setIncrementInstanceNumber()).
+   *  This allows for assigning different instance numbers to a number of
+   *  images converted from the same DICOM file, e.g.\ in batch mode.
+   *  @param increment - [in] The value to be added (default: 1)
+   *  @return none
+   */
+  void setInstanceNumberIncrement(const Sint32 increment);
+
   /** Enables/disables autotmatic insertion of the value "ISO_IR100" as
     * a value for the Specific Character Set attribute. If disabled,
     * no value is inserted for Specifific Character Set but instead
@@ -207,6 +222,21 @@ protected:
 
 private:
 
+  /// private undefined copy constructor
+  Image2Dcm(const Image2Dcm&);
+
+  /// private undefined assignment operator
+  Image2Dcm& operator=(const Image2Dcm&);
+
+  /** Loads the dataset of the given DICOM file, unless the dataset has
+   *  already been loaded before.
+   *  @param file - [in] The filename of the DICOM file
+   *  @param dataset - [in/out] The cached dataset, loaded if NULL
+   *  @return EC_Normal, if successful, error otherwise
+   */
+  static OFCondition loadDataset(const OFString& file,
+                                 DcmDataset*& dataset);
+
   /** Correctly inserts encapsulated pixel data.
    *  @param dset [in] - The dataset to which we should add this.
    *  @param pixData [in] - The data to add.
@@ -230,6 +260,10 @@ private:
   /// are taken over from this template file
   OFString m_templateFile;
 
+  /// The dataset of the template file (already cleaned up) if it has
+  /// been loaded, NULL otherwise
+  DcmDataset *m_templateDataset;
+
   /// If true, patient and study data is read from file
   OFBool m_readStudyLevel;
 
@@ -239,9 +273,16 @@ private:
   /// File to read study and series from
   OFString m_studySeriesFile;
 
-  /// If true, Instance Number ist read from file and incremented by 1
+  /// The dataset of the study/series file if it has been loaded,
+  /// NULL otherwise
+  DcmDataset *m_studySeriesDataset;
+
+  /// If true, Instance Number ist read from file and incremented
   OFBool m_incInstNoFromFile;
 
+  /// Value that is added to the Instance Number read from file (default: 1)
+  Sint32 m_instNoIncrement;
+
   ///  If true, some simple attribute checks (missing type 2 attributes or
   ///  missing type 1 values) are omitted
   OFBool m_disableAttribChecks;
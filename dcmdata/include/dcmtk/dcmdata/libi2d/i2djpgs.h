@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2007-2014, OFFIS e.V.
+ *  Copyright (C) 2007-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -316,6 +316,29 @@ protected:
    */
   inline int read1Byte(Uint8& result);
 
+  /** Read the next byte from the JPEG file. The file is read in blocks
+   *  into an internal buffer, since reading single bytes from a stdio
+   *  stream can be slow (especially if the stream must be locked because
+   *  several threads are running).
+   *  @return the byte read, or EOF if the end of the file has been reached
+   */
+  int readBufferedByte();
+
+  /** Get the current position in the JPEG file, taking the internal read
+   *  buffer into account.
+   *  @return the current position in the file, or -1 on error
+   */
+  offile_off_t tellFile();
+
+  /** Set the current position in the JPEG file and discard the internal read
+   *  buffer unless the new position is within the buffer. After seeking, the
+   *  file can also be read directly (i.e. with OFFile::fread()).
+   *  @param offset - [in] offset in bytes relative to the position given by whence
+   *  @param whence - [in] SEEK_SET, SEEK_CUR or SEEK_END
+   *  @return 0 if successful, -1 otherwise
+   */
+  int seekFile(offile_off_t offset, int whence);
+
   /** Deletes internal JPEG file map and frees memory.
    *  @return none
    */
@@ -328,6 +351,15 @@ protected:
   /// The JPEG file, if opened
   OFFile jpegFile;
 
+  /// Buffer for reading the JPEG file byte by byte
+  Uint8 m_readBuffer[4096];
+
+  /// Position of the next byte to be read in the read buffer
+  size_t m_readBufferPos;
+
+  /// Number of valid bytes in the read buffer
+  size_t m_readBufferCount;
+
   /// If true, JPEGs with progressive coding are not supported
   OFBool m_disableProgrTs;
 
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2007-2017, OFFIS e.V.
+ *  Copyright (C) 2007-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -29,13 +29,15 @@
 #include "dcmtk/dcmdata/dcuid.h"     /* for SITE_SERIES_UID_ROOT */
 #include "dcmtk/dcmdata/dcpixseq.h"  /* for DcmPixelSequence */
 #include "dcmtk/dcmdata/dcpath.h"    /* for override keys */
+#include "dcmtk/ofstd/oflimits.h"    /* for OFnumeric_limits */
 
 OFLogger DCM_dcmdataLibi2dLogger = OFLog::getLogger("dcmtk.dcmdata.libi2d");
 
 
 Image2Dcm::Image2Dcm() : m_overrideKeys(), m_templateFile(""),
-  m_readStudyLevel(OFFalse), m_readSeriesLevel(OFFalse), m_studySeriesFile(),
-  m_incInstNoFromFile(OFFalse), m_disableAttribChecks(OFFalse),
+  m_templateDataset(NULL), m_readStudyLevel(OFFalse), m_readSeriesLevel(OFFalse),
+  m_studySeriesFile(), m_studySeriesDataset(NULL), m_incInstNoFromFile(OFFalse), m_instNoIncrement(1),
+  m_disableAttribChecks(OFFalse),
   m_inventMissingType2Attribs(OFTrue), m_inventMissingType1Attribs(OFFalse),
   m_insertLatin1(OFTrue)
 {
@@ -60,14 +62,17 @@ OFCondition Image2Dcm::convert(I2DImgSource *inputPlug,
   // If specified, copy DICOM template file to export file
   if (!m_templateFile.empty())
   {
-    DcmFileFormat dcmff;
-    cond = dcmff.loadFile(m_templateFile.c_str());
-    if (cond.bad())
-      return cond;
-    // remove problematic attributes from dataset
-    cleanupTemplate(dcmff.getDataset());
+    // the template is only loaded and cleaned up once
+    if (m_templateDataset == NULL)
+    {
+      cond = loadDataset(m_templateFile, m_templateDataset);
+      if (cond.bad())
+        return cond;
+      // remove problematic attributes from dataset
+      cleanupTemplate(m_templateDataset);
+    }
     // copy from input file
-    tempDataset.reset(new DcmDataset(*(dcmff.getDataset())));
+    tempDataset.reset(new DcmDataset(*m_templateDataset));
   }
   else // otherwise, start with an empty DICOM file
     tempDataset.reset(new DcmDataset());
@@ -202,22 +207,18 @@ OFCondition Image2Dcm::applyStudyOrSeriesFromFile(DcmDataset *targetDset)
   DCMDATA_LIBI2D_DEBUG("Image2Dcm: Applying study and/or series information from file");
   if ( (!m_readSeriesLevel && !m_readStudyLevel) || m_studySeriesFile.empty() )
     return EC_IllegalCall;
-  DcmFileFormat dcmff;
   OFString errMsg;
   OFCondition cond;
 
-  // Open DICOM file to read patient/study/series information from
-  cond = dcmff.loadFile(m_studySeriesFile.c_str());
+  // Open DICOM file to read patient/study/series information from (only once)
+  cond = loadDataset(m_studySeriesFile, m_studySeriesDataset);
   if (cond.bad())
   {
     errMsg = "Error: Unable to open study / series file "; errMsg += m_studySeriesFile;
     return makeOFCondition(OFM_dcmdata, 18, OF_error, errMsg.c_str());
   }
 
-  DcmDataset *srcDset = NULL;
-  srcDset = dcmff.getDataset();
-  if (srcDset == NULL)
-    return EC_IllegalCall;
+  DcmDataset *srcDset = m_studySeriesDataset;
 
   // Patient level attributes (type 2 - if value cannot be read, insert empty value
   OFString value;
@@ -329,7 +330,9 @@ OFCondition Image2Dcm::incrementInstanceNumber(DcmDataset *targetDset)
     Sint32 instanceNumber;
     if ( targetDset->findAndGetSint32(DCM_InstanceNumber, instanceNumber).good() )
     {
-      instanceNumber++;
+      if ( (m_instNoIncrement > 0) && (instanceNumber > OFnumeric_limits<Sint32>::max() - m_instNoIncrement) )
+        return makeOFCondition(OFM_dcmdata, 18, OF_error, "Unable to increment Instance Number, value too large");
+      instanceNumber += m_instNoIncrement;
       char buf[100];
       sprintf(buf, "%ld", OFstatic_cast(long, instanceNumber));
       OFCondition cond = targetDset->putAndInsertOFStringArray(DCM_InstanceNumber, buf);
@@ -593,6 +596,8 @@ void Image2Dcm::setSeriesFrom(const OFString& file)
 {
   m_readSeriesLevel = OFTrue;
   m_studySeriesFile = file;
+  delete m_studySeriesDataset;
+  m_studySeriesDataset = NULL;
 }
 
 
@@ -600,6 +605,8 @@ void Image2Dcm::setStudyFrom(const OFString& file)
 {
   m_readStudyLevel = OFTrue;
   m_studySeriesFile = file;
+  delete m_studySeriesDataset;
+  m_studySeriesDataset = NULL;
 }
 
 
@@ -616,6 +623,27 @@ void Image2Dcm::setValidityChecking(OFBool doChecks,
 void Image2Dcm::setTemplateFile(const OFString& file)
 {
   m_templateFile = file;
+  delete m_templateDataset;
+  m_templateDataset = NULL;
+}
+
+
+OFCondition Image2Dcm::loadDataset(const OFString& file,
+                                   DcmDataset*& dataset)
+{
+  if (dataset != NULL)
+    return EC_Normal;
+  DCMDATA_LIBI2D_DEBUG("Image2Dcm: Loading dataset from file: " << file);
+  DcmFileFormat dcmff;
+  OFCondition cond = dcmff.loadFile(file.c_str());
+  if (cond.good())
+  {
+    // take over the dataset from the file, the meta header is not needed
+    dataset = dcmff.getAndRemoveDataset();
+    if (dataset == NULL)
+      cond = EC_IllegalCall;
+  }
+  return cond;
 }
 
 
@@ -626,6 +654,12 @@ void Image2Dcm::setIncrementInstanceNumber(OFBool incInstNo)
 }
 
 
+void Image2Dcm::setInstanceNumberIncrement(const Sint32 increment)
+{
+  m_instNoIncrement = increment;
+}
+
+
 void Image2Dcm::setOverrideKeys(const OFList<OFString>& ovkeys)
 {
   OFListConstIterator(OFString) it = ovkeys.begin();
@@ -732,4 +766,6 @@ OFString Image2Dcm::checkAndInventType2Attrib(const DcmTagKey& key,
 Image2Dcm::~Image2Dcm()
 {
   DCMDATA_LIBI2D_DEBUG("Freeing memory");
+  delete m_templateDataset;
+  delete m_studySeriesDataset;
 }
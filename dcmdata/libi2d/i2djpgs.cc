@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2007-2019, OFFIS e.V.
+ *  Copyright (C) 2007-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,6 +26,7 @@
 #include "dcmtk/dcmdata/dcerror.h"
 
 I2DJpegSource::I2DJpegSource() : m_jpegFileMap(), jpegFile(),
+  m_readBufferPos(0), m_readBufferCount(0),
   m_disableProgrTs(OFFalse), m_disableExtSeqTs(OFFalse), m_insistOnJFIF(OFFalse),
   m_keepAPPn(OFFalse), m_lossyCompressed(OFTrue)
 {
@@ -46,6 +47,7 @@ OFCondition I2DJpegSource::openFile(const OFString &filename)
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "No JPEG filename specified");
 
   // Try to open JPEG file
+  m_readBufferPos = m_readBufferCount = 0;
   if ((jpegFile.fopen(filename.c_str(), "rb")) == OFFalse)
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "Unable to open JPEG file");
 
@@ -232,6 +234,8 @@ OFCondition I2DJpegSource::readPixelData(Uint16& rows,
   }
   length = tLength;
   pixData = tPixelData;
+  // the file is not needed anymore, so do not keep it open (e.g. during batch conversion)
+  closeFile();
   return cond;
 }
 
@@ -269,7 +273,7 @@ OFCondition I2DJpegSource::getSOFImageParameters( const JPEGFileMapEntry& entry,
 
   // seek to the given SOFn marker
 
-  jpegFile.fseek(entry.bytePos, SEEK_SET);
+  seekFile(entry.bytePos, SEEK_SET);
   result = read2Bytes(length);  /* usual parameter length count */
   if (result == EOF)
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "Premature EOF in JPEG file");
@@ -324,7 +328,7 @@ OFCondition I2DJpegSource::getJFIFImageParameters( const JPEGFileMapEntry& entry
 
   // go to specified byte position and read on to value field
   Uint16 length;
-  jpegFile.fseek(entry.bytePos, SEEK_SET);
+  seekFile(entry.bytePos, SEEK_SET);
   int result = read2Bytes(length);  /* usual parameter length count */
   if (result == EOF)
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "Premature EOF in JPEG file");
@@ -394,10 +398,10 @@ OFCondition I2DJpegSource::copyJPEGStream(char*& pixelData,
   int marker = 0;
 
   // determine file size
-  offile_off_t result = jpegFile.fseek(0, SEEK_END);
+  offile_off_t result = seekFile(0, SEEK_END);
   if (result != 0)
     return EC_IllegalParameter;
-  offile_off_t filesize = jpegFile.ftell();
+  offile_off_t filesize = tellFile();
 
   // Only pixel data up to 2^32 bytes is supported (DICOM) and maximum size for "new" operator = size_t
 
@@ -425,7 +429,7 @@ OFCondition I2DJpegSource::copyJPEGStream(char*& pixelData,
   }
 
   // Go to starting position (SOI marker) of JPEG stream data
-  jpegFile.fseek(0, SEEK_SET);
+  seekFile(0, SEEK_SET);
 
   // Allocate buffer for raw JPEG data
   pixLength = OFstatic_cast(Uint32, filesize - (bytePosAfterJFIF - bytePosJFIF));
@@ -441,7 +445,7 @@ OFCondition I2DJpegSource::copyJPEGStream(char*& pixelData,
       return EC_IllegalCall;
     currBufferPos += 2;
     // read from end of JFIF to end of file
-    jpegFile.fseek(bytePosAfterJFIF - 1, SEEK_SET); // -1 because offsets start with 0
+    seekFile(bytePosAfterJFIF - 1, SEEK_SET); // -1 because offsets start with 0
     result = jpegFile.fread (currBufferPos, 1, OFstatic_cast(size_t, filesize - bytePosAfterJFIF + 1));
     if (result != filesize - bytePosAfterJFIF + 1)
       return EC_IllegalCall;
@@ -495,7 +499,7 @@ OFCondition I2DJpegSource::extractRawJPEGStream(char*& pixelData,
     else if (marker >= E_JPGMARKER_APP0 && marker <= E_JPGMARKER_APP15)
     {
       DCMDATA_LIBI2D_DEBUG("I2DJpegSource: Skipping application segment APP" << (marker - E_JPGMARKER_APP0));
-      jpegFile.fseek((*entry)->bytePos - jpegFile.ftell(), SEEK_CUR);
+      seekFile((*entry)->bytePos - tellFile(), SEEK_CUR);
       int result = read2Bytes( length);
       if (result == EOF)
       {
@@ -534,7 +538,7 @@ OFCondition I2DJpegSource::extractRawJPEGStream(char*& pixelData,
   char *currBufferPos = pixelData;
 
   // Go to starting position (SOI marker) of JPEG stream data
-  jpegFile.fseek(bytePosSOI-1, SEEK_SET);
+  seekFile(bytePosSOI-1, SEEK_SET);
 
   /* Copy everything but leave out APP segments
    */
@@ -557,7 +561,7 @@ OFCondition I2DJpegSource::extractRawJPEGStream(char*& pixelData,
       finished = OFTrue;
     }
     // read block
-    offile_off_t blockSize = endOfBlock - jpegFile.ftell();
+    offile_off_t blockSize = endOfBlock - tellFile();
     if (blockSize < 0)
     {
         DCMDATA_LIBI2D_ERROR("Length field in JPEG data bigger than remaining file");
@@ -570,7 +574,7 @@ OFCondition I2DJpegSource::extractRawJPEGStream(char*& pixelData,
             cond = EC_IllegalCall;
         else if (!finished)
         {
-            jpegFile.fseek(startOfNextBlock, SEEK_SET);
+            seekFile(startOfNextBlock, SEEK_SET);
             currBufferPos += blockSize;
         }
     }
@@ -601,7 +605,7 @@ OFCondition I2DJpegSource::createJPEGFileMap()
   if (cond.bad())
     return cond;
   entry = new JPEGFileMapEntry();
-  entry->bytePos = jpegFile.ftell();
+  entry->bytePos = tellFile();
   entry->marker = first;
   m_jpegFileMap.push_back(entry);
 
@@ -615,7 +619,7 @@ OFCondition I2DJpegSource::createJPEGFileMap()
     if (cond.good())
     {
       entry = new JPEGFileMapEntry();
-      entry->bytePos = jpegFile.ftell();
+      entry->bytePos = tellFile();
       entry->marker = marker;
       m_jpegFileMap.push_back(entry);
       if (marker == E_JPGMARKER_SOS)
@@ -705,7 +709,7 @@ OFString I2DJpegSource::jpegMarkerToString(const E_JPGMARKER& marker)
 int I2DJpegSource::read1Byte(Uint8& result)
 {
   int c;
-  c = jpegFile.fgetc();
+  c = readBufferedByte();
   if (c == EOF)
     return EOF;
   result = OFstatic_cast(Uint8, c);
@@ -713,15 +717,55 @@ int I2DJpegSource::read1Byte(Uint8& result)
 }
 
 
+/* Read one byte from the read buffer, refilling it if necessary */
+int I2DJpegSource::readBufferedByte()
+{
+  if (m_readBufferPos == m_readBufferCount)
+  {
+    m_readBufferPos = 0;
+    m_readBufferCount = jpegFile.fread(m_readBuffer, 1, sizeof(m_readBuffer));
+    if (m_readBufferCount == 0)
+      return EOF;
+  }
+  return m_readBuffer[m_readBufferPos++];
+}
+
+
+/* Get file position, i.e. the position of the next byte in the read buffer */
+offile_off_t I2DJpegSource::tellFile()
+{
+  offile_off_t pos = jpegFile.ftell();
+  if (pos < 0)
+    return pos;
+  return pos - OFstatic_cast(offile_off_t, m_readBufferCount - m_readBufferPos);
+}
+
+
+/* Set file position, skipping within the read buffer if possible */
+int I2DJpegSource::seekFile(offile_off_t offset, int whence)
+{
+  const offile_off_t remaining = OFstatic_cast(offile_off_t, m_readBufferCount - m_readBufferPos);
+  if ((whence == SEEK_CUR) && (offset >= 0) && (offset <= remaining))
+  {
+    m_readBufferPos += OFstatic_cast(size_t, offset);
+    return 0;
+  }
+  if (whence == SEEK_CUR)
+    offset -= remaining;
+  m_readBufferPos = m_readBufferCount = 0;
+  return jpegFile.fseek(offset, whence);
+}
+
+
 /* Read 2 bytes, convert to unsigned int */
 /* All 2-byte quantities in JPEG markers are MSB first */
 int I2DJpegSource::read2Bytes(Uint16& result)
 {
   int c1, c2;
-  c1 = jpegFile.fgetc();
+  c1 = readBufferedByte();
   if (c1 == EOF)
     return EOF;
-  c2 = jpegFile.fgetc();
+  c2 = readBufferedByte();
   if (c2 == EOF)
     return EOF;
   result = OFstatic_cast(Uint16, ((OFstatic_cast(Uint16, c1)) << 8) + OFstatic_cast(Uint16, c2));
@@ -787,8 +831,8 @@ OFCondition I2DJpegSource::firstMarker(E_JPGMARKER& result)
 {
   Uint8 c1, c2;
 
-  c1 = OFstatic_cast(Uint8, jpegFile.fgetc());
-  c2 = OFstatic_cast(Uint8, jpegFile.fgetc());
+  c1 = OFstatic_cast(Uint8, readBufferedByte());
+  c2 = OFstatic_cast(Uint8, readBufferedByte());
   if (c1 != 0xFF || c2 != E_JPGMARKER_SOI) {
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "Not a JPEG file");
   }
@@ -819,7 +863,7 @@ OFCondition I2DJpegSource::skipVariable()
     return makeOFCondition(OFM_dcmdata, 18, OF_error, "Erroneous JPEG marker length");
   length = OFstatic_cast(Uint16, length - 2);
   /* Skip over the remaining bytes */
-  jpegFile.fseek(length, SEEK_CUR);
+  seekFile(length, SEEK_CUR);
   return EC_Normal;
 }
 
@@ -903,6 +947,7 @@ void I2DJpegSource::clearMap()
 // closes underlying JPEG file
 void I2DJpegSource::closeFile()
 {
+  m_readBufferPos = m_readBufferCount = 0;
   jpegFile.fclose();
 }
 
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2018, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -42,6 +42,11 @@
 #include "dcmtk/ofstd/ofstream.h"
 #include "dcmtk/ofstd/ofbmanip.h"     /* for class OFBitmanipTemplate */
 #include "dcmtk/ofstd/ofcast.h"
+#include "dcmtk/ofstd/ofvector.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
 
 
 /*-------------------------*
@@ -1106,6 +1111,7 @@ DicomDirInterface::DicomDirInterface()
     ConsistencyCheck(OFTrue),
     IconImageMode(OFFalse),
     FilesetUpdateMode(OFFalse),
+    IncrementalWriteMode(OFFalse),
     BackupFilename(),
     BackupCreated(OFFalse),
     IconSize(64),
@@ -1120,7 +1126,9 @@ DicomDirInterface::DicomDirInterface()
     AutoInstanceNumber(1),
     AutoOverlayNumber(1),
     AutoLutNumber(1),
-    AutoCurveNumber(1)
+    AutoCurveNumber(1),
+    RecordIndex(),
+    RecordIndexCreated(OFFalse)
 {
     /* check whether (possibly required) RLE/JPEG/JP2K decoders are registered */
     RLESupport  = DcmCodecList::canChangeCoding(EXS_RLELossless, EXS_LittleEndianExplicit);
@@ -1146,6 +1154,8 @@ void DicomDirInterface::cleanup()
     delete DicomDir;
     /* invalidate references */
     DicomDir = NULL;
+    RecordIndex.clear();
+    RecordIndexCreated = OFFalse;
 }
 
 
@@ -1260,8 +1270,10 @@ OFCondition DicomDirInterface::appendToDicomDir(const E_ApplicationProfile profi
                 /* finally, create a DICOMDIR object based on the existing file */
                 DicomDir = new DcmDicomDir(filename);
                 if (DicomDir != NULL)
+                {
+                    DicomDir->setIncrementalWriteMode(IncrementalWriteMode);
                     result = DicomDir->error();
-                else
+                } else
                     result = EC_MemoryExhausted;
             }
         } else {
@@ -1305,8 +1317,10 @@ OFCondition DicomDirInterface::updateDicomDir(const E_ApplicationProfile profile
                 /* finally, create a DICOMDIR object based on the existing file */
                 DicomDir = new DcmDicomDir(filename);
                 if (DicomDir != NULL)
+                {
+                    DicomDir->setIncrementalWriteMode(IncrementalWriteMode);
                     result = DicomDir->error();
-                else
+                } else
                     result = EC_MemoryExhausted;
             }
         } else {
@@ -2985,6 +2999,89 @@ OFBool DicomDirInterface::recordMatchesDataset(DcmDirectoryRecord *record,
 }
 
 
+// get the attributes identifying records of the given type in the UID index
+static OFBool getRecordIndexKeys(const E_DirRecType recordType,
+                                 DcmTagKey &recordKey,
+                                 DcmTagKey &datasetKey,
+                                 char &level)
+{
+    OFBool result = OFTrue;
+    switch (recordType)
+    {
+        case ERT_root:
+        case ERT_Mrdr:
+        case ERT_Patient:
+            /* patients are not identified by a UID */
+            result = OFFalse;
+            break;
+        case ERT_Study:
+            recordKey = datasetKey = DCM_StudyInstanceUID;
+            level = 'T';
+            break;
+        case ERT_Series:
+            recordKey = datasetKey = DCM_SeriesInstanceUID;
+            level = 'S';
+            break;
+        default:
+            recordKey = DCM_ReferencedSOPInstanceUIDInFile;
+            datasetKey = DCM_SOPInstanceUID;
+            level = 'I';
+            break;
+    }
+    return result;
+}
+
+
+// add directory record (and all subordinate records) to the UID index
+void DicomDirInterface::addToRecordIndex(DcmDirectoryRecord *parent,
+                                         DcmDirectoryRecord *record)
+{
+    if (record != NULL)
+    {
+        DcmTagKey recordKey, datasetKey;
+        char level = 0;
+        OFString uid;
+        if (getRecordIndexKeys(record->getRecordType(), recordKey, datasetKey, level) &&
+            record->findAndGetOFStringArray(recordKey, uid).good() && !uid.empty())
+        {
+            /* keep the first record with this UID, as findExistingRecord() would do */
+            RecordIndexEntry entry;
+            entry.Parent = parent;
+            entry.Record = record;
+            RecordIndex.insert(OFMake_pair(OFString(1, level) + uid, entry));
+        }
+        /* iterate over all subordinate records */
+        DcmDirectoryRecord *subRecord = NULL;
+        while ((subRecord = record->nextSub(subRecord)) != NULL)
+            addToRecordIndex(record, subRecord);
+    }
+}
+
+
+// create the UID index of all directory records
+void DicomDirInterface::createRecordIndex()
+{
+    if (!RecordIndexCreated && (DicomDir != NULL))
+    {
+        DcmDirectoryRecord *rootRecord = &(DicomDir->getRootRecord());
+        DcmDirectoryRecord *record = NULL;
+        RecordIndex.clear();
+        while ((record = rootRecord->nextSub(record)) != NULL)
+            addToRecordIndex(rootRecord, record);
+        RecordIndexCreated = OFTrue;
+        DCMDATA_DEBUG("created index of " << RecordIndex.size() << " directory records by UID");
+    }
+}
+
+
+// check whether the given SOP instance is referenced by the DICOMDIR
+OFBool DicomDirInterface::isSOPInstanceReferenced(const OFString &sopInstanceUID)
+{
+    createRecordIndex();
+    return !sopInstanceUID.empty() && (RecordIndex.find(OFString(1, 'I') + sopInstanceUID) != RecordIndex.end());
+}
+
+
 // search for a given record
 DcmDirectoryRecord *DicomDirInterface::findExistingRecord(DcmDirectoryRecord *parent,
                                                           const E_DirRecType recordType,
@@ -2994,6 +3091,24 @@ DcmDirectoryRecord *DicomDirInterface::findExistingRecord(DcmDirectoryRecord *pa
     DcmDirectoryRecord *record = NULL;
     if (parent != NULL)
     {
+        DcmTagKey recordKey, datasetKey;
+        char level = 0;
+        OFString uid;
+        /* use the UID index for study, series and instance records (if possible) */
+        if ((dataset != NULL) && getRecordIndexKeys(recordType, recordKey, datasetKey, level) &&
+            dataset->findAndGetOFStringArray(datasetKey, uid).good() && !uid.empty())
+        {
+            createRecordIndex();
+            OFMap<OFString, RecordIndexEntry>::const_iterator iter = RecordIndex.find(OFString(1, level) + uid);
+            if (iter != RecordIndex.end())
+            {
+                if ((iter->second.Parent == parent) && (iter->second.Record->getRecordType() == recordType))
+                    return iter->second.Record;
+            }
+            /* a study record might not contain the UID, so a full search is needed */
+            else if (recordType != ERT_Study)
+                return NULL;
+        }
         /* iterate over all records */
         while (!found && ((record = parent->nextSub(record)) != NULL))
         {
@@ -4682,6 +4797,8 @@ DcmDirectoryRecord *DicomDirInterface::addRecord(DcmDirectoryRecord *parent,
                         delete record;
                         record = NULL;
                     }
+                    else if (RecordIndexCreated)
+                        addToRecordIndex(parent, record);
                 }
             }
         } else {
@@ -4863,89 +4980,331 @@ OFCondition DicomDirInterface::addDicomFile(const OFFilename &filename,
     /* first, make sure that a DICOMDIR object exists */
     if (DicomDir != NULL)
     {
-        /* create fully qualified pathname of the DICOM file to be added */
-        OFFilename pathname;
-        OFStandard::combineDirAndFilename(pathname, directory, filename, OFTrue /*allowEmptyDirName*/);
         /* then check the file name, load the file and check the content */
         DcmFileFormat fileformat;
         result = loadAndCheckDicomFile(filename, directory, fileformat, OFTrue /*checkFilename*/);
         if (result.good())
+            result = addCheckedDicomFile(filename, directory, fileformat);
+    }
+    return result;
+}
+
+
+#ifdef WITH_THREADS
+
+/** shared state of the worker threads that load and check DICOM files for
+ *  DicomDirInterface::addDicomFiles().  The files are processed in the order of
+ *  the list.  At most 'WindowSize' files are loaded but not yet added to the
+ *  DICOMDIR, each of them stored in the slot 'index % WindowSize'.
+ */
+struct DicomDirLoadQueue
+{
+    /** constructor
+     *  @param directory directory where the DICOM files are stored
+     *  @param windowSize maximum number of files loaded in advance
+     */
+    DicomDirLoadQueue(const OFFilename &directory,
+                      const size_t windowSize)
+      : Directory(directory),
+        Filenames(),
+        WindowSize(windowSize),
+        NextFile(0),
+        StopMode(OFFalse),
+        Mutex(),
+        FreeSlots(OFstatic_cast(unsigned int, windowSize)),
+        FileFormats(windowSize, OFstatic_cast(DcmFileFormat *, NULL)),
+        Results(windowSize),
+        ReadySlots(windowSize, OFstatic_cast(OFSemaphore *, NULL))
+    {
+        for (size_t i = 0; i < windowSize; ++i)
+            ReadySlots[i] = new OFSemaphore(0);
+    }
+
+    /** destructor
+     */
+    ~DicomDirLoadQueue()
+    {
+        for (size_t i = 0; i < WindowSize; ++i)
         {
-            DCMDATA_INFO("adding file: " << pathname);
-            /* start creating the DICOMDIR directory structure */
-            DcmDirectoryRecord *rootRecord = &(DicomDir->getRootRecord());
-            DcmMetaInfo *metainfo = fileformat.getMetaInfo();
-            /* massage filename into DICOM format (DOS conventions for path separators, uppercase) */
-            OFString fileID;
-            hostToDicomFilename(OFSTRING_GUARD(filename.getCharPointer()), fileID);
-            /* what kind of object (SOP Class) is stored in the file */
-            OFString sopClass;
-            metainfo->findAndGetOFString(DCM_MediaStorageSOPClassUID, sopClass);
-            /* if hanging protocol, palette or implant file then attach it to the root record and stop */
-            if (compare(sopClass, UID_HangingProtocolStorage))
+            delete FileFormats[i];
+            delete ReadySlots[i];
+        }
+    }
+
+    /// directory where the DICOM files are stored
+    const OFFilename &Directory;
+    /// names of the DICOM files to be loaded (in the order of processing)
+    OFVector<const OFFilename *> Filenames;
+    /// maximum number of files loaded in advance
+    const size_t WindowSize;
+    /// index of the next file to be loaded (protected by 'Mutex')
+    size_t NextFile;
+    /// flag indicating that no more files should be loaded (protected by 'Mutex')
+    OFBool StopMode;
+    /// mutex protecting the above members
+    OFMutex Mutex;
+    /// number of slots that are currently not in use
+    OFSemaphore FreeSlots;
+    /// loaded DICOM files (one per slot)
+    OFVector<DcmFileFormat *> FileFormats;
+    /// result of loading and checking the DICOM files (one per slot)
+    OFVector<OFCondition> Results;
+    /// semaphores signaling that a slot contains a loaded DICOM file
+    OFVector<OFSemaphore *> ReadySlots;
+
+  private:
+
+    /// private undefined copy constructor
+    DicomDirLoadQueue(const DicomDirLoadQueue &);
+
+    /// private undefined assignment operator
+    DicomDirLoadQueue &operator=(const DicomDirLoadQueue &);
+};
+
+
+/** worker thread that loads and checks DICOM files for DicomDirInterface::addDicomFiles()
+ */
+class DicomDirLoadWorker : public OFThread
+{
+  public:
+
+    /** constructor
+     *  @param ddir DICOMDIR interface used for loading and checking the files
+     *  @param queue shared state of all worker threads
+     */
+    DicomDirLoadWorker(DicomDirInterface &ddir,
+                       DicomDirLoadQueue &queue)
+      : OFThread(),
+        DicomDir(ddir),
+        Queue(queue)
+    {
+    }
+
+  protected:
+
+    /** load and check files until all files are processed or processing is stopped
+     */
+    virtual void run()
+    {
+        for (;;)
+        {
+            /* wait until a slot is available */
+            Queue.FreeSlots.wait();
+            Queue.Mutex.lock();
+            const size_t index = Queue.NextFile;
+            const OFBool done = Queue.StopMode || (index >= Queue.Filenames.size());
+            if (!done)
+                ++Queue.NextFile;
+            Queue.Mutex.unlock();
+            if (done)
             {
-                /* add a hanging protocol record below the root */
-                if (addRecord(rootRecord, ERT_HangingProtocol, &fileformat, fileID, pathname) == NULL)
-                    result = EC_CorruptedData;
+                /* pass the wake-up on to the next waiting thread */
+                Queue.FreeSlots.post();
+                break;
             }
-            else if (compare(sopClass, UID_ColorPaletteStorage))
+            const size_t slot = index % Queue.WindowSize;
+            DcmFileFormat *fileformat = new DcmFileFormat();
+            Queue.Results[slot] = DicomDir.loadAndCheckDicomFile(*Queue.Filenames[index], Queue.Directory,
+                *fileformat, OFTrue /*checkFilename*/);
+            Queue.FileFormats[slot] = fileformat;
+            Queue.ReadySlots[slot]->post();
+        }
+    }
+
+  private:
+
+    /// DICOMDIR interface used for loading and checking the files
+    DicomDirInterface &DicomDir;
+    /// shared state of all worker threads
+    DicomDirLoadQueue &Queue;
+};
+
+#endif
+
+
+// add DICOM files to the current DICOMDIR object
+OFCondition DicomDirInterface::addDicomFiles(const OFList<OFFilename> &filenames,
+                                             const OFFilename &directory,
+                                             OFList<OFFilename> &badFiles,
+                                             size_t &goodFiles,
+                                             const unsigned int numberOfThreads)
+{
+    goodFiles = 0;
+    /* first, make sure that a DICOMDIR object exists */
+    if (DicomDir == NULL)
+        return EC_IllegalParameter;
+    OFCondition result = EC_Normal;
+    OFListConstIterator(OFFilename) iter = filenames.begin();
+    const OFListConstIterator(OFFilename) last = filenames.end();
+#ifdef WITH_THREADS
+    if ((numberOfThreads > 1) && (filenames.size() > 1))
+    {
+        /* limit the number of files that are loaded in advance */
+        DicomDirLoadQueue queue(directory, 4 * OFstatic_cast(size_t, numberOfThreads));
+        while (iter != last)
+            queue.Filenames.push_back(&(*iter++));
+        OFVector<DicomDirLoadWorker *> workers;
+        for (unsigned int i = 0; i < numberOfThreads; ++i)
+        {
+            DicomDirLoadWorker *worker = new DicomDirLoadWorker(*this, queue);
+            if (worker->start() == 0)
+                workers.push_back(worker);
+            else
+                delete worker;
+        }
+        if (!workers.empty())
+        {
+            DCMDATA_DEBUG("loading and checking files with " << workers.size() << " thread(s)");
+            /* add the files to the DICOMDIR in the order of the list */
+            const size_t count = queue.Filenames.size();
+            size_t index = 0;
+            while ((index < count) && result.good())
             {
-                /* add a palette record below the root */
-                if (addRecord(rootRecord, ERT_Palette, &fileformat, fileID, pathname) == NULL)
-                    result = EC_CorruptedData;
+                const size_t slot = index % queue.WindowSize;
+                queue.ReadySlots[slot]->wait();
+                DcmFileFormat *fileformat = queue.FileFormats[slot];
+                queue.FileFormats[slot] = NULL;
+                result = queue.Results[slot];
+                if (result.good())
+                    result = addCheckedDicomFile(*queue.Filenames[index], directory, *fileformat);
+                delete fileformat;
+                queue.FreeSlots.post();
+                if (result.bad())
+                {
+                    badFiles.push_back(*queue.Filenames[index]);
+                    /* ignore inconsistent file, just warn (already done above) */
+                    if (!AbortMode)
+                        result = EC_Normal;
+                } else
+                    ++goodFiles;
+                ++index;
             }
-            else if (compare(sopClass, UID_GenericImplantTemplateStorage))
+            if (index < count)
             {
-                /* add an implant record below the root */
-                if (addRecord(rootRecord, ERT_Implant, &fileformat, fileID, pathname) == NULL)
-                    result = EC_CorruptedData;
+                /* stop loading files and wake up the waiting threads */
+                queue.Mutex.lock();
+                queue.StopMode = OFTrue;
+                queue.Mutex.unlock();
+                queue.FreeSlots.post();
             }
-            else if (compare(sopClass, UID_ImplantAssemblyTemplateStorage))
+            for (size_t i = 0; i < workers.size(); ++i)
             {
-                /* add an implant group record below the root */
-                if (addRecord(rootRecord, ERT_ImplantGroup, &fileformat, fileID, pathname) == NULL)
-                    result = EC_CorruptedData;
+                workers[i]->join();
+                delete workers[i];
             }
-            else if (compare(sopClass, UID_ImplantTemplateGroupStorage))
+            return result;
+        }
+        /* no thread could be started, process the files sequentially */
+        DCMDATA_WARN("cannot start threads, loading and checking files sequentially");
+        iter = filenames.begin();
+    }
+#else
+    (void) numberOfThreads;
+#endif
+    while ((iter != last) && result.good())
+    {
+        result = addDicomFile(*iter, directory);
+        if (result.bad())
+        {
+            badFiles.push_back(*iter);
+            /* ignore inconsistent file, just warn (already done above) */
+            if (!AbortMode)
+                result = EC_Normal;
+        } else
+            ++goodFiles;
+        ++iter;
+    }
+    return result;
+}
+
+
+// add loaded and checked DICOM file to the current DICOMDIR object
+OFCondition DicomDirInterface::addCheckedDicomFile(const OFFilename &filename,
+                                                   const OFFilename &directory,
+                                                   DcmFileFormat &fileformat)
+{
+    OFCondition result = EC_IllegalParameter;
+    /* first, make sure that a DICOMDIR object exists */
+    if (DicomDir != NULL)
+    {
+        /* create fully qualified pathname of the DICOM file to be added */
+        OFFilename pathname;
+        OFStandard::combineDirAndFilename(pathname, directory, filename, OFTrue /*allowEmptyDirName*/);
+        DCMDATA_INFO("adding file: " << pathname);
+        result = EC_Normal;
+        /* start creating the DICOMDIR directory structure */
+        DcmDirectoryRecord *rootRecord = &(DicomDir->getRootRecord());
+        DcmMetaInfo *metainfo = fileformat.getMetaInfo();
+        /* massage filename into DICOM format (DOS conventions for path separators, uppercase) */
+        OFString fileID;
+        hostToDicomFilename(OFSTRING_GUARD(filename.getCharPointer()), fileID);
+        /* what kind of object (SOP Class) is stored in the file */
+        OFString sopClass;
+        metainfo->findAndGetOFString(DCM_MediaStorageSOPClassUID, sopClass);
+        /* if hanging protocol, palette or implant file then attach it to the root record and stop */
+        if (compare(sopClass, UID_HangingProtocolStorage))
+        {
+            /* add a hanging protocol record below the root */
+            if (addRecord(rootRecord, ERT_HangingProtocol, &fileformat, fileID, pathname) == NULL)
+                result = EC_CorruptedData;
+        }
+        else if (compare(sopClass, UID_ColorPaletteStorage))
+        {
+            /* add a palette record below the root */
+            if (addRecord(rootRecord, ERT_Palette, &fileformat, fileID, pathname) == NULL)
+                result = EC_CorruptedData;
+        }
+        else if (compare(sopClass, UID_GenericImplantTemplateStorage))
+        {
+            /* add an implant record below the root */
+            if (addRecord(rootRecord, ERT_Implant, &fileformat, fileID, pathname) == NULL)
+                result = EC_CorruptedData;
+        }
+        else if (compare(sopClass, UID_ImplantAssemblyTemplateStorage))
+        {
+            /* add an implant group record below the root */
+            if (addRecord(rootRecord, ERT_ImplantGroup, &fileformat, fileID, pathname) == NULL)
+                result = EC_CorruptedData;
+        }
+        else if (compare(sopClass, UID_ImplantTemplateGroupStorage))
+        {
+            /* add an implant assy record below the root */
+            if (addRecord(rootRecord, ERT_ImplantAssy, &fileformat, fileID, pathname) == NULL)
+                result = EC_CorruptedData;
+        } else {
+            /* add a patient record below the root */
+            DcmDirectoryRecord *patientRecord = addRecord(rootRecord, ERT_Patient, &fileformat, fileID, pathname);
+            if (patientRecord != NULL)
             {
-                /* add an implant assy record below the root */
-                if (addRecord(rootRecord, ERT_ImplantAssy, &fileformat, fileID, pathname) == NULL)
-                    result = EC_CorruptedData;
-            } else {
-                /* add a patient record below the root */
-                DcmDirectoryRecord *patientRecord = addRecord(rootRecord, ERT_Patient, &fileformat, fileID, pathname);
-                if (patientRecord != NULL)
+                /* if patient management file then attach it to patient record and stop */
+                if (compare(sopClass, UID_RETIRED_DetachedPatientManagementMetaSOPClass))
                 {
-                    /* if patient management file then attach it to patient record and stop */
-                    if (compare(sopClass, UID_RETIRED_DetachedPatientManagementMetaSOPClass))
+                    result = patientRecord->assignToSOPFile(fileID.c_str(), pathname);
+                    DCMDATA_ERROR(result.text() << ": cannot assign patient record to file: " << pathname);
+                } else {
+                    /* add a study record below the current patient record */
+                    DcmDirectoryRecord *studyRecord = addRecord(patientRecord, ERT_Study, &fileformat, fileID, pathname);;
+                    if (studyRecord != NULL)
                     {
-                        result = patientRecord->assignToSOPFile(fileID.c_str(), pathname);
-                        DCMDATA_ERROR(result.text() << ": cannot assign patient record to file: " << pathname);
-                    } else {
-                        /* add a study record below the current patient record */
-                        DcmDirectoryRecord *studyRecord = addRecord(patientRecord, ERT_Study, &fileformat, fileID, pathname);;
-                        if (studyRecord != NULL)
+                        /* add a series record below the current study record */
+                        DcmDirectoryRecord *seriesRecord = addRecord(studyRecord, ERT_Series, &fileformat, fileID, pathname);;
+                        if (seriesRecord != NULL)
                         {
-                            /* add a series record below the current study record */
-                            DcmDirectoryRecord *seriesRecord = addRecord(studyRecord, ERT_Series, &fileformat, fileID, pathname);;
-                            if (seriesRecord != NULL)
-                            {
-                                /* add one of the instance record below the current series record */
-                                if (addRecord(seriesRecord, sopClassToRecordType(sopClass), &fileformat, fileID, pathname) == NULL)
-                                    result = EC_CorruptedData;
-                            } else
+                            /* add one of the instance record below the current series record */
+                            if (addRecord(seriesRecord, sopClassToRecordType(sopClass), &fileformat, fileID, pathname) == NULL)
                                 result = EC_CorruptedData;
                         } else
                             result = EC_CorruptedData;
-                    }
-                } else
-                    result = EC_CorruptedData;
-                /* invent missing attributes on all levels or PatientID only */
-                if (InventMode)
-                    inventMissingAttributes(rootRecord);
-                else if (InventPatientIDMode)
-                    inventMissingAttributes(rootRecord, OFFalse /*recurse*/);
-            }
+                    } else
+                        result = EC_CorruptedData;
+                }
+            } else
+                result = EC_CorruptedData;
+            /* invent missing attributes on all levels or PatientID only */
+            if (InventMode)
+                inventMissingAttributes(rootRecord);
+            else if (InventPatientIDMode)
+                inventMissingAttributes(rootRecord, OFFalse /*recurse*/);
         }
     }
     return result;
@@ -5116,6 +5475,18 @@ OFBool DicomDirInterface::disableBackupMode(const OFBool newMode)
 }
 
 
+// enable/disable the incremental write mode, i.e. whether to update an existing DICOMDIR in place
+OFBool DicomDirInterface::enableIncrementalWriteMode(const OFBool newMode)
+{
+    /* save current mode */
+    OFBool oldMode = IncrementalWriteMode;
+    /* set new mode */
+    IncrementalWriteMode = newMode;
+    /* return old mode */
+    return oldMode;
+}
+
+
 // enable/disable pixel encoding check, i.e. whether the pixel encoding is checked
 // for particular application profiles
 OFBool DicomDirInterface::disableEncodingCheck(const OFBool newMode)
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2017, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -53,6 +53,10 @@
 #include "dcmtk/ofstd/ofstd.h"
 #include "dcmtk/dcmdata/dcwcache.h"    /* for class DcmWriteCache */
 #include "dcmtk/dcmdata/dcvrui.h"      /* for class DcmUniqueIdentifier */
+#include "dcmtk/dcmdata/dcostrmb.h"    /* for class DcmOutputBufferStream */
+#include "dcmtk/ofstd/offile.h"        /* for class OFFile */
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/ofstd/oflimits.h"
 
 #ifndef O_BINARY
 #define O_BINARY 0                     /* only Windows has O_BINARY */
@@ -69,7 +73,14 @@ DcmDicomDir::DcmDicomDir()
     mustCreateNewDir(OFFalse),
     DirFile(new DcmFileFormat()),
     RootRec(NULL),
-    MRDRSeq(NULL)
+    MRDRSeq(NULL),
+    incrementalWrite(OFFalse),
+    layoutKnown(OFFalse),
+    layoutEncoding(EET_UndefinedLength),
+    layoutFirstRecord(0),
+    layoutEndOfRecords(0),
+    layoutFileSize(0),
+    layoutRecords()
 {
     dicomDirFileName.set(DEFAULT_DICOMDIR_NAME);
 
@@ -86,6 +97,7 @@ DcmDicomDir::DcmDicomDir()
     DcmTag mrdrSeqTag( DCM_DirectoryRecordSequence );
     MRDRSeq = new DcmSequenceOfItems( mrdrSeqTag );
 
+    determineFileLayout();
     errorFlag = convertLinearToTree();
 }
 
@@ -100,7 +112,14 @@ DcmDicomDir::DcmDicomDir(const OFFilename &fileName, const char *fileSetID)
     mustCreateNewDir(OFFalse),
     DirFile(new DcmFileFormat()),
     RootRec(NULL),
-    MRDRSeq(NULL)
+    MRDRSeq(NULL),
+    incrementalWrite(OFFalse),
+    layoutKnown(OFFalse),
+    layoutEncoding(EET_UndefinedLength),
+    layoutFirstRecord(0),
+    layoutEndOfRecords(0),
+    layoutFileSize(0),
+    layoutRecords()
 {
     if ( fileName.isEmpty() )
         dicomDirFileName.set(DEFAULT_DICOMDIR_NAME);
@@ -120,6 +139,7 @@ DcmDicomDir::DcmDicomDir(const OFFilename &fileName, const char *fileSetID)
     DcmTag mrdrSeqTag( DCM_DirectoryRecordSequence );
     MRDRSeq = new DcmSequenceOfItems( mrdrSeqTag );
 
+    determineFileLayout();
     errorFlag = convertLinearToTree();
 }
 
@@ -136,7 +156,14 @@ DcmDicomDir::DcmDicomDir( const DcmDicomDir & old )
     mustCreateNewDir(old.mustCreateNewDir),
     DirFile(new DcmFileFormat(*old.DirFile)),
     RootRec(new DcmDirectoryRecord(*old.RootRec)),
-    MRDRSeq(new DcmSequenceOfItems(*old.MRDRSeq))
+    MRDRSeq(new DcmSequenceOfItems(*old.MRDRSeq)),
+    incrementalWrite(old.incrementalWrite),
+    layoutKnown(OFFalse),
+    layoutEncoding(EET_UndefinedLength),
+    layoutFirstRecord(0),
+    layoutEndOfRecords(0),
+    layoutFileSize(0),
+    layoutRecords()
 {
 }
 
@@ -628,7 +655,19 @@ OFCondition DcmDicomDir::convertAllPointer( DcmDataset &dset,          // inout
         item_pos = lengthOfRecord( rec, oxfer, enctype ) + item_pos;
     }
 
-    /* calling convertGivenPointer() requires that the above for-loop has been run through */
+    /* calling convertPointersToOffsets() requires that the above for-loop has been run through */
+    return convertPointersToOffsets( dset );
+}
+
+
+// ********************************
+
+
+OFCondition DcmDicomDir::convertPointersToOffsets( DcmDataset &dset )  // inout
+{
+    OFCondition l_error = EC_Normal;
+    DcmSequenceOfItems &localDirRecSeq = getDirRecSeq( dset );
+
     OFCondition e1 = convertGivenPointer( &dset, DCM_OffsetOfTheFirstDirectoryRecordOfTheRootDirectoryEntity );
     OFCondition e2 = convertGivenPointer( &dset, DCM_OffsetOfTheLastDirectoryRecordOfTheRootDirectoryEntity );
 
@@ -723,7 +762,8 @@ OFCondition DcmDicomDir::convertTreeToLinear(Uint32 beginOfDataSet,
                                              E_TransferSyntax oxfer,
                                              E_EncodingType enctype,
                                              E_GrpLenEncoding glenc,
-                                             DcmSequenceOfItems &unresRecs )
+                                             DcmSequenceOfItems &unresRecs,
+                                             OFBool computeOffsets )
 {
     OFCondition l_error = EC_Normal;
     DcmDataset &dset = getDataset();    // guaranteed to exist
@@ -764,6 +804,10 @@ OFCondition DcmDicomDir::convertTreeToLinear(Uint32 beginOfDataSet,
     // compute group lengths before computing byte offsets
     dset.computeGroupLengthAndPadding(glenc, EPD_noChange, oxfer, enctype);
 
+    // the caller determines the byte offsets (incremental write mode)
+    if ( !computeOffsets )
+        return l_error;
+
     // convert maximum twice
     if ( convertAllPointer( dset, beginOfDataSet, oxfer, enctype ) == EC_InvalidVR )
         if ( convertAllPointer( dset, beginOfDataSet, oxfer, enctype ) == EC_InvalidVR )
@@ -1010,6 +1054,18 @@ OFCondition DcmDicomDir::write(const E_TransferSyntax oxfer,
     errorFlag = EC_Normal;
     E_TransferSyntax outxfer = DICOMDIR_DEFAULT_TRANSFERSYNTAX;
 
+    // update the existing file if possible (incremental write mode)
+    if (incrementalWrite)
+    {
+        OFBool written = OFFalse;
+        errorFlag = writeIncrementally(enctype, glenc, written);
+        if (written)
+        {
+            modified = OFFalse;
+            return errorFlag;
+        }
+    }
+
     // create a temporary file based on the DICOMDIR filename
     OFFilename tempFilename;
     OFStandard::appendFilenameExtension(tempFilename, dicomDirFileName, DICOMDIR_TEMP_SUFFIX);
@@ -1028,6 +1084,8 @@ OFCondition DcmDicomDir::write(const E_TransferSyntax oxfer,
     DcmSequenceOfItems &localDirRecSeq = getDirRecSeq(dset);
     DcmTag unresSeqTag(DCM_DirectoryRecordSequence);
     DcmSequenceOfItems localUnresRecs(unresSeqTag);
+    Uint32 endOfRecords = 0;
+    offile_off_t endOfFile = 0;
 
     // insert Media Stored SOP Class UID
     insertMediaSOPUID(metainfo);
@@ -1052,6 +1110,10 @@ OFCondition DcmDicomDir::write(const E_TransferSyntax oxfer,
         // do not calculate GroupLength and Padding twice!
         dset.write(*outStream, outxfer, enctype, &wcache, EGL_noChange);
         dset.transferEnd();
+
+        // remember the position of the directory records (for the incremental write mode)
+        endOfFile = outStream->tell();
+        endOfRecords = beginOfDataset + lengthUntilSQ(dset, outxfer, enctype) + localDirRecSeq.getLength(outxfer, enctype);
     }
 
     // outStream is closed here
@@ -1092,6 +1154,10 @@ OFCondition DcmDicomDir::write(const E_TransferSyntax oxfer,
     if (errorFlag == EC_Normal) {
         // remove temporary backup (if any)
         OFStandard::deleteFile(backupFilename);
+        storeFileLayout(localDirRecSeq, enctype, endOfRecords, endOfFile);
+    } else {
+        layoutKnown = OFFalse;
+        layoutRecords.clear();
     }
 
     // remove all records from sequence localDirRecSeq
@@ -1109,6 +1175,341 @@ OFCondition DcmDicomDir::write(const E_TransferSyntax oxfer,
 }
 
 
+// ********************************
+
+
+void DcmDicomDir::setIncrementalWriteMode(const OFBool mode)
+{
+    incrementalWrite = mode;
+}
+
+
+// ********************************
+
+
+OFBool DcmDicomDir::getIncrementalWriteMode() const
+{
+    return incrementalWrite;
+}
+
+
+// ********************************
+
+
+void DcmDicomDir::storeFileLayout( DcmSequenceOfItems &recSeq,   // in
+                                   E_EncodingType enctype,       // in
+                                   Uint32 endOfRecords,          // in
+                                   offile_off_t fileSize )       // in
+{
+    layoutKnown = OFFalse;
+    layoutRecords.clear();
+    DcmDataset &dset = getDataset();
+    // the directory records have to be at the end of the file
+    if ( recSeq.card() == 0 || dset.card() == 0 || dset.getElement(dset.card() - 1) != &recSeq )
+        return;
+    if ( OFstatic_cast(offile_off_t, endOfRecords) + (enctype == EET_UndefinedLength ? 8 : 0) != fileSize )
+        return;
+
+    // the records are stored one after the other, in the order of the sequence
+    OFVector<DcmDirectoryRecord *> records;
+    records.reserve( recSeq.card() );
+    DcmObject *obj = NULL;
+    while ( (obj = recSeq.nextInContainer(obj)) != NULL )
+        records.push_back( OFstatic_cast(DcmDirectoryRecord *, obj) );
+    Uint32 nextOffset = endOfRecords;
+    for (size_t i = records.size(); i > 0; i-- )
+    {
+        const Uint32 offset = records[i - 1]->getFileOffset();
+        if ( offset >= nextOffset )
+        {
+            DCMDATA_DEBUG("DcmDicomDir::storeFileLayout() Unexpected offset of Record with offset=" << offset);
+            layoutRecords.clear();
+            return;
+        }
+        layoutRecords[ records[i - 1] ] = OFMake_pair(offset, nextOffset - offset);
+        nextOffset = offset;
+    }
+    layoutKnown = OFTrue;
+    layoutEncoding = enctype;
+    layoutFirstRecord = nextOffset;
+    layoutEndOfRecords = endOfRecords;
+    layoutFileSize = fileSize;
+}
+
+
+// ********************************
+
+
+void DcmDicomDir::determineFileLayout()
+{
+    layoutKnown = OFFalse;
+    layoutRecords.clear();
+    if ( mustCreateNewDir || getDataset().getOriginalXfer() != DICOMDIR_DEFAULT_TRANSFERSYNTAX )
+        return;
+    DcmSequenceOfItems &localDirRecSeq = getDirRecSeq( getDataset() );
+    DcmDirectoryRecord *firstRec = OFstatic_cast(DcmDirectoryRecord *, localDirRecSeq.nextInContainer(NULL));
+    if ( firstRec == NULL )
+        return;
+
+    // the sequence and all items have to use the same type of length encoding
+    const E_EncodingType enctype = (localDirRecSeq.getLengthField() == DCM_UndefinedLength) ? EET_UndefinedLength : EET_ExplicitLength;
+    DcmObject *obj = NULL;
+    while ( (obj = localDirRecSeq.nextInContainer(obj)) != NULL )
+    {
+        if ( (obj->getLengthField() == DCM_UndefinedLength) != (enctype == EET_UndefinedLength) )
+            return;
+    }
+
+    const offile_off_t fileSize = OFstatic_cast(offile_off_t, OFStandard::getFileSize(dicomDirFileName));
+    Uint32 endOfRecords = 0;
+    if ( enctype == EET_UndefinedLength )
+    {
+        // the file ends with the sequence delimitation item
+        if ( fileSize < 8 || fileSize - 8 > OFstatic_cast(offile_off_t, OFnumeric_limits<Uint32>::max()) )
+            return;
+        endOfRecords = OFstatic_cast(Uint32, fileSize - 8);
+    } else {
+        if ( OFStandard::check32BitAddOverflow(firstRec->getFileOffset(), localDirRecSeq.getLengthField()) )
+            return;
+        endOfRecords = firstRec->getFileOffset() + localDirRecSeq.getLengthField();
+    }
+    storeFileLayout( localDirRecSeq, enctype, endOfRecords, fileSize );
+}
+
+
+// ********************************
+
+
+/* encode a directory record (or any other item) into the given memory buffer.
+ * Returns OFFalse if the encoded item does not exactly fill the buffer.
+ */
+static OFBool encodeItem( DcmItem *item,
+                          const E_EncodingType enctype,
+                          DcmWriteCache &wcache,
+                          Uint8 *buffer,
+                          const Uint32 length )
+{
+    DcmOutputBufferStream outStream( buffer, length );
+    item->transferInit();
+    OFCondition status = item->write( outStream, DICOMDIR_DEFAULT_TRANSFERSYNTAX, enctype, &wcache );
+    item->transferEnd();
+    return status.good() && outStream.filled() == OFstatic_cast(offile_off_t, length);
+}
+
+
+// ********************************
+
+
+OFCondition DcmDicomDir::writeIncrementally( E_EncodingType enctype,   // in
+                                             E_GrpLenEncoding glenc,   // in
+                                             OFBool &written )         // out
+{
+    written = OFFalse;
+    if ( !layoutKnown || mustCreateNewDir || enctype != layoutEncoding )
+    {
+        DCMDATA_DEBUG("DcmDicomDir::writeIncrementally() Cannot update existing file, writing complete DICOMDIR");
+        return EC_Normal;
+    }
+    if ( OFstatic_cast(offile_off_t, OFStandard::getFileSize(dicomDirFileName)) != layoutFileSize )
+    {
+        DCMDATA_DEBUG("DcmDicomDir::writeIncrementally() File has been modified externally, writing complete DICOMDIR");
+        return EC_Normal;
+    }
+
+    DcmDataset &dset = getDataset(); // guaranteed to exist
+    DcmMetaInfo &metainfo = *(getDirFileFormat().getMetaInfo());
+    DcmSequenceOfItems &localDirRecSeq = getDirRecSeq(dset);
+    // records which are not part of the tree structure require a complete write
+    if ( localDirRecSeq.card() > 0 )
+    {
+        DCMDATA_DEBUG("DcmDicomDir::writeIncrementally() Unresolved records found, writing complete DICOMDIR");
+        return EC_Normal;
+    }
+    // the same applies to elements that have been added after the directory records
+    if ( dset.getElement(dset.card() - 1) != &localDirRecSeq )
+    {
+        DCMDATA_DEBUG("DcmDicomDir::writeIncrementally() Directory Record Sequence is not the last element, writing complete DICOMDIR");
+        return EC_Normal;
+    }
+    const E_TransferSyntax outxfer = DICOMDIR_DEFAULT_TRANSFERSYNTAX;
+    DcmTag unresSeqTag(DCM_DirectoryRecordSequence);
+    DcmSequenceOfItems localUnresRecs(unresSeqTag);
+
+    insertMediaSOPUID(metainfo);
+    getDirFileFormat().validateMetaInfo(outxfer);
+
+    // convert to writable format, but keep the position of all records stored in the file
+    OFBool possible = convertTreeToLinear(0, outxfer, enctype, glenc, localUnresRecs, OFFalse /*computeOffsets*/).good();
+    OFVector<DcmDirectoryRecord *> storedRecs;
+    OFVector<DcmDirectoryRecord *> newRecs;
+    Uint32 endOfRecords = layoutEndOfRecords;
+    DcmObject *obj = NULL;
+    while ( possible && (obj = localDirRecSeq.nextInContainer(obj)) != NULL )
+    {
+        DcmDirectoryRecord *rec = OFstatic_cast(DcmDirectoryRecord *, obj);
+        const Uint32 length = lengthOfRecord( rec, outxfer, enctype );
+        OFMap<const DcmDirectoryRecord *, OFPair<Uint32, Uint32> >::const_iterator it = layoutRecords.find(rec);
+        if ( it != layoutRecords.end() && it->second.first == rec->getFileOffset() )
+        {
+            // modified records must keep their length in order to be overwritten
+            if ( it->second.second == length )
+                storedRecs.push_back(rec);
+            else
+                possible = OFFalse;
+        }
+        else if ( !OFStandard::check32BitAddOverflow(endOfRecords, length) )
+        {
+            // new records are appended to the existing ones
+            rec->setFileOffset( endOfRecords );
+            endOfRecords += length;
+            newRecs.push_back(rec);
+        } else
+            possible = OFFalse;
+    }
+    // records that have been removed require a complete write
+    if ( storedRecs.size() != layoutRecords.size() )
+        possible = OFFalse;
+    if ( possible )
+        possible = convertPointersToOffsets( dset ).good();
+
+    // encode the file meta information and the dataset up to the first record
+    Uint8 *buffer = NULL;
+    Uint8 *prefix = NULL;
+    if ( possible )
+    {
+        DcmWriteCache wcache;
+        prefix = new Uint8[layoutFirstRecord];
+        DcmOutputBufferStream outStream( prefix, layoutFirstRecord );
+        metainfo.transferInit();
+        OFCondition status = metainfo.write( outStream, META_HEADER_DEFAULT_TRANSFERSYNTAX, enctype, &wcache );
+        metainfo.transferEnd();
+        obj = NULL;
+        while ( status.good() && (obj = dset.nextInContainer(obj)) != &localDirRecSeq )
+        {
+            obj->transferInit();
+            status = obj->write( outStream, outxfer, enctype, &wcache );
+            obj->transferEnd();
+        }
+        // tag, VR and length of the directory record sequence (explicit VR little endian)
+        const Uint32 seqLength = (enctype == EET_UndefinedLength) ? DCM_UndefinedLength : endOfRecords - layoutFirstRecord;
+        const Uint16 group = DCM_DirectoryRecordSequence.getGroup();
+        const Uint16 element = DCM_DirectoryRecordSequence.getElement();
+        const Uint8 header[12] = {
+            OFstatic_cast(Uint8, group & 0xff), OFstatic_cast(Uint8, group >> 8),
+            OFstatic_cast(Uint8, element & 0xff), OFstatic_cast(Uint8, element >> 8),
+            'S', 'Q', 0, 0,
+            OFstatic_cast(Uint8, seqLength & 0xff), OFstatic_cast(Uint8, (seqLength >> 8) & 0xff),
+            OFstatic_cast(Uint8, (seqLength >> 16) & 0xff), OFstatic_cast(Uint8, seqLength >> 24) };
+        if ( status.good() && outStream.avail() == 12 )
+            outStream.write( header, 12 );
+        possible = status.good() && outStream.filled() == OFstatic_cast(offile_off_t, layoutFirstRecord);
+    }
+
+    OFFile file;
+    if ( possible && !file.fopen(dicomDirFileName, "r+b") )
+        possible = OFFalse;
+    if ( possible )
+    {
+        DcmWriteCache wcache;
+        OFCondition status = EC_Normal;
+        Uint32 bufferSize = 0;
+        size_t numChanged = 0;
+        written = OFTrue;
+
+        // append new records (and the sequence delimitation item)
+        if ( !newRecs.empty() || enctype == EET_UndefinedLength )
+        {
+            if ( file.fseek(layoutEndOfRecords, SEEK_SET) != 0 )
+                status = EC_InvalidStream;
+        }
+        for (size_t i = 0; status.good() && i < newRecs.size(); i++ )
+        {
+            const Uint32 length = lengthOfRecord( newRecs[i], outxfer, enctype );
+            if ( length > bufferSize )
+            {
+                delete[] buffer;
+                buffer = new Uint8[bufferSize = length];
+            }
+            if ( !encodeItem(newRecs[i], enctype, wcache, buffer, length) )
+                status = EC_CorruptedData;
+            else if ( file.fwrite(buffer, 1, length) != length )
+                status = EC_InvalidStream;
+        }
+        if ( status.good() && enctype == EET_UndefinedLength )
+        {
+            const Uint8 delimiter[8] = { 0xfe, 0xff, 0xdd, 0xe0, 0, 0, 0, 0 };
+            if ( file.fwrite(delimiter, 1, 8) != 8 )
+                status = EC_InvalidStream;
+        }
+
+        // overwrite modified records, e.g. with a new offset of the next record
+        for (size_t i = 0; status.good() && i < storedRecs.size(); i++ )
+        {
+            const Uint32 offset = storedRecs[i]->getFileOffset();
+            const Uint32 length = lengthOfRecord( storedRecs[i], outxfer, enctype );
+            if ( 2 * length > bufferSize )
+            {
+                delete[] buffer;
+                buffer = new Uint8[bufferSize = 2 * length];
+            }
+            if ( !encodeItem(storedRecs[i], enctype, wcache, buffer, length) )
+                status = EC_CorruptedData;
+            else if ( file.fseek(offset, SEEK_SET) != 0 || file.fread(buffer + length, 1, length) != length )
+                status = EC_InvalidStream;
+            else if ( memcmp(buffer, buffer + length, length) != 0 )
+            {
+                if ( file.fseek(offset, SEEK_SET) != 0 || file.fwrite(buffer, 1, length) != length )
+                    status = EC_InvalidStream;
+                ++numChanged;
+            }
+        }
+
+        // finally, overwrite file meta information and dataset header (if modified)
+        if ( status.good() )
+        {
+            delete[] buffer;
+            buffer = new Uint8[bufferSize = layoutFirstRecord];
+            if ( file.fseek(0, SEEK_SET) != 0 || file.fread(buffer, 1, layoutFirstRecord) != layoutFirstRecord )
+                status = EC_InvalidStream;
+            else if ( memcmp(buffer, prefix, layoutFirstRecord) != 0 )
+            {
+                if ( file.fseek(0, SEEK_SET) != 0 || file.fwrite(prefix, 1, layoutFirstRecord) != layoutFirstRecord )
+                    status = EC_InvalidStream;
+            }
+        }
+        if ( file.fclose() != 0 && status.good() )
+            status = EC_InvalidStream;
+
+        if ( status.good() )
+        {
+            DCMDATA_DEBUG("DcmDicomDir::writeIncrementally() Appended " << newRecs.size() << " and updated "
+                << numChanged << " of " << storedRecs.size() << " Records in file " << dicomDirFileName);
+            for (size_t i = 0; i < newRecs.size(); i++ )
+                layoutRecords[ newRecs[i] ] = OFMake_pair(newRecs[i]->getFileOffset(), lengthOfRecord( newRecs[i], outxfer, enctype ));
+            layoutEndOfRecords = endOfRecords;
+            layoutFileSize = OFstatic_cast(offile_off_t, endOfRecords) + (enctype == EET_UndefinedLength ? 8 : 0);
+        } else {
+            if ( status == EC_InvalidStream )
+            {
+                OFString text = OFStandard::getLastSystemErrorCode().message();
+                status = makeOFCondition(OFM_dcmdata, 19, OF_error, text.c_str());
+            }
+            DCMDATA_ERROR("DcmDicomDir: Cannot update DICOMDIR file " << dicomDirFileName << ": " << status.text());
+            layoutKnown = OFFalse;
+            layoutRecords.clear();
+        }
+        errorFlag = status;
+    }
+    delete[] buffer;
+    delete[] prefix;
+
+    // remove all records from sequence localDirRecSeq, they are still part of the tree
+    while (localDirRecSeq.card() > 0)
+        localDirRecSeq.remove(OFstatic_cast(unsigned long, 0));
+    return written ? errorFlag : EC_Normal;
+}
+
+
 // ********************************
 // ********************************
 
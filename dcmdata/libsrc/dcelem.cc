@@ -36,6 +36,7 @@
 #include "dcmtk/dcmdata/dcobject.h"
 #include "dcmtk/dcmdata/dcswap.h"
 #include "dcmtk/dcmdata/dcistrma.h"    /* for class DcmInputStream */
+#include "dcmtk/dcmdata/dcistrmf.h"    /* for class DcmInputFileStreamFactory */
 #include "dcmtk/dcmdata/dcostrma.h"    /* for class DcmOutputStream */
 #include "dcmtk/dcmdata/dcfcache.h"    /* for class DcmFileCache */
 #include "dcmtk/dcmdata/dcwcache.h"    /* for class DcmWriteCache */
@@ -1654,6 +1655,54 @@ void DcmElement::writeJsonCloser(STD_NAMESPACE ostream &out,
 }
 
 
+OFCondition DcmElement::writeBase64Value(STD_NAMESPACE ostream &out,
+                                         const E_ByteOrder byteOrder)
+{
+    OFCondition result = EC_Normal;
+    const Uint32 length = getLengthField();
+    if (valueLoaded())
+    {
+        Uint8 *byteValues = OFstatic_cast(Uint8 *, getValue(byteOrder));
+        result = OFStandard::encodeBase64(out, byteValues, OFstatic_cast(size_t, length));
+    }
+    else
+    {
+        /* the block size must be a multiple of 3 (so that no Base64 padding
+         * occurs between blocks) and of the largest value width (8)
+         */
+        const Uint32 blockSize = 49152;
+        Uint8 *buffer = new Uint8[blockSize];
+        /* keep the file open while reading the value block by block */
+        DcmFileCache cache;
+        Uint32 offset = 0;
+        while (result.good() && (offset < length))
+        {
+            const Uint32 numBytes = (length - offset < blockSize) ? (length - offset) : blockSize;
+            result = getPartialValue(buffer, offset, numBytes, &cache, byteOrder);
+            if (result.good())
+                result = OFStandard::encodeBase64(out, buffer, OFstatic_cast(size_t, numBytes));
+            offset += numBytes;
+        }
+        delete[] buffer;
+    }
+    return result;
+}
+
+
+OFBool DcmElement::getValueFileReference(OFFilename &filename,
+                                         offile_off_t &offset) const
+{
+    if (!valueLoaded() && fLoadValue && (fLoadValue->ident() == DFT_DcmInputFileStreamFactory))
+    {
+        const DcmInputFileStreamFactory *factory = OFstatic_cast(const DcmInputFileStreamFactory *, fLoadValue);
+        filename = factory->getFilename();
+        offset = factory->getOffset();
+        return OFTrue;
+    }
+    return OFFalse;
+}
+
+
 OFCondition DcmElement::writeJson(STD_NAMESPACE ostream &out,
                                   DcmJsonFormat &format)
 {
@@ -931,6 +931,60 @@ OFCondition DcmFileFormat::loadFileUntilTag(
 }
 
 
+OFCondition DcmFileFormat::loadFileWithBulkData(const OFFilename &fileName,
+                                                const Uint32 bulkDataThreshold,
+                                                const E_TransferSyntax readXfer,
+                                                const E_GrpLenEncoding groupLength,
+                                                const E_FileReadMode readMode)
+{
+    OFCondition l_error = EC_InvalidFilename;
+    /* check parameters first */
+    if (!fileName.isEmpty())
+    {
+        /* open file for input, all deferred element values share this file handle */
+        DcmSharedFileHandler *handler = DcmSharedFileHandler::newInstance(fileName);
+        DcmInputFileStream fileStream(handler);
+        /* the stream and the elements referring to the file keep their own references */
+        handler->decreaseRefCount();
+        /* check stream status */
+        l_error = fileStream.status();
+        if (l_error.good())
+        {
+            if (readMode == ERM_dataset)
+            {
+                /* read data set without meta header */
+                DcmDataset *dataset = getDataset();
+                l_error = dataset->clear();
+                if (l_error.good())
+                {
+                    dataset->transferInit();
+                    l_error = dataset->read(fileStream, readXfer, groupLength, bulkDataThreshold);
+                    dataset->transferEnd();
+                }
+            }
+            else
+            {
+                /* clear this object */
+                l_error = clear();
+                if (l_error.good())
+                {
+                    /* save old value */
+                    const E_FileReadMode oldMode = FileReadMode;
+                    FileReadMode = readMode;
+                    /* read data from file */
+                    transferInit();
+                    l_error = read(fileStream, readXfer, groupLength, bulkDataThreshold);
+                    transferEnd();
+                    /* restore old value */
+                    FileReadMode = oldMode;
+                }
+            }
+        }
+    }
+    return l_error;
+}
+
+
 OFCondition DcmFileFormat::saveFile(const OFFilename &fileName,
                                     const E_TransferSyntax writeXfer,
                                     const E_EncodingType encodingType,
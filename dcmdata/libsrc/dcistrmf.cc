@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2012, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -29,11 +29,90 @@
 #include "dcmtk/ofstd/ofstdinc.h"
 
 
+DcmSharedFileHandler::DcmSharedFileHandler(const OFFilename &filename)
+#ifdef WITH_THREADS
+: refCount_(1), mutex_(), file_(), status_(EC_Normal), size_(0), filePos_(-1), filename_(filename)
+#else
+: refCount_(1), file_(), status_(EC_Normal), size_(0), filePos_(-1), filename_(filename)
+#endif
+{
+  if (file_.fopen(filename, "rb"))
+  {
+     // Get number of bytes in file
+     file_.fseek(0L, SEEK_END);
+     size_ = file_.ftell();
+  }
+  else
+  {
+    OFString s("(unknown error code)");
+    file_.getLastErrorString(s);
+    status_ = makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
+  }
+}
+
+DcmSharedFileHandler::~DcmSharedFileHandler()
+{
+}
+
+DcmSharedFileHandler *DcmSharedFileHandler::newInstance(const OFFilename &filename)
+{
+  return new DcmSharedFileHandler(filename);
+}
+
+offile_off_t DcmSharedFileHandler::read(offile_off_t pos, void *buf, offile_off_t buflen)
+{
+  offile_off_t result = 0;
+  if (status_.good() && buf && buflen && (pos < size_))
+  {
+#ifdef WITH_THREADS
+    mutex_.lock();
+#endif
+    // only seek if another stream has moved the file pointer
+    if ((filePos_ == pos) || (file_.fseek(pos, SEEK_SET) == 0))
+    {
+      result = file_.fread(buf, 1, OFstatic_cast(size_t, buflen));
+      filePos_ = pos + result;
+    }
+    else filePos_ = -1;
+#ifdef WITH_THREADS
+    mutex_.unlock();
+#endif
+  }
+  return result;
+}
+
+void DcmSharedFileHandler::increaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  ++refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+}
+
+void DcmSharedFileHandler::decreaseRefCount()
+{
+#ifdef WITH_THREADS
+  mutex_.lock();
+#endif
+  size_t result = --refCount_;
+#ifdef WITH_THREADS
+  mutex_.unlock();
+#endif
+  if (result == 0) delete this;
+}
+
+/* ======================================================================= */
+
 DcmFileProducer::DcmFileProducer(const OFFilename &filename, offile_off_t offset)
 : DcmProducer()
 , file_()
 , status_(EC_Normal)
 , size_(0)
+, handler_(NULL)
+, pos_(0)
 {
   if (file_.fopen(filename, "rb"))
   {
@@ -46,6 +125,7 @@ DcmFileProducer::DcmFileProducer(const OFFilename &filename, offile_off_t offset
        file_.getLastErrorString(s);
        status_ = makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
      }
+     else pos_ = offset;
   }
   else
   {
@@ -55,8 +135,26 @@ DcmFileProducer::DcmFileProducer(const OFFilename &filename, offile_off_t offset
   }
 }
 
+DcmFileProducer::DcmFileProducer(DcmSharedFileHandler *handler, offile_off_t offset)
+: DcmProducer()
+, file_()
+, status_(EC_Normal)
+, size_(0)
+, handler_(handler)
+, pos_(offset)
+{
+  if (handler_)
+  {
+    handler_->increaseRefCount();
+    status_ = handler_->status();
+    size_ = handler_->size();
+  }
+  else status_ = EC_IllegalCall;
+}
+
 DcmFileProducer::~DcmFileProducer()
 {
+  if (handler_) handler_->decreaseRefCount();
 }
 
 OFBool DcmFileProducer::good() const
@@ -71,24 +169,35 @@ OFCondition DcmFileProducer::status() const
 
 OFBool DcmFileProducer::eos()
 {
+  if (handler_) return (pos_ >= size_);
   if (file_.open())
   {
-    return (file_.eof() || (size_ == file_.ftell()));
+    return (file_.eof() || (pos_ >= size_));
   }
   else return OFTrue;
 }
 
 offile_off_t DcmFileProducer::avail()
 {
-  if (file_.open()) return size_ - file_.ftell(); else return 0;
+  if (handler_) return (pos_ < size_) ? (size_ - pos_) : 0;
+  if (file_.open()) return (pos_ < size_) ? (size_ - pos_) : 0; else return 0;
 }
 
 offile_off_t DcmFileProducer::read(void *buf, offile_off_t buflen)
 {
   offile_off_t result = 0;
-  if (status_.good() && file_.open() && buf && buflen)
+  if (handler_)
+  {
+    if (status_.good())
+    {
+      result = handler_->read(pos_, buf, buflen);
+      pos_ += result;
+    }
+  }
+  else if (status_.good() && file_.open() && buf && buflen)
   {
     result = file_.fread(buf, 1, OFstatic_cast(size_t, buflen));
+    pos_ += result;
   }
   return result;
 }
@@ -96,26 +205,41 @@ offile_off_t DcmFileProducer::read(void *buf, offile_off_t buflen)
 offile_off_t DcmFileProducer::skip(offile_off_t skiplen)
 {
   offile_off_t result = 0;
-  if (status_.good() && file_.open() && skiplen)
+  if (handler_)
+  {
+    if (status_.good() && skiplen && (pos_ < size_))
+    {
+      result = (size_ - pos_ < skiplen) ? (size_ - pos_) : skiplen;
+      pos_ += result;
+    }
+  }
+  else if (status_.good() && file_.open() && skiplen)
   {
-    offile_off_t pos = file_.ftell();
-    result = (size_ - pos < skiplen) ? (size_ - pos) : skiplen;
+    result = (size_ - pos_ < skiplen) ? (size_ - pos_) : skiplen;
     if (file_.fseek(result, SEEK_CUR))
     {
       OFString s("(unknown error code)");
       file_.getLastErrorString(s);
       status_ = makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
     }
+    else pos_ += result;
   }
   return result;
 }
 
 void DcmFileProducer::putback(offile_off_t num)
 {
-  if (status_.good() && file_.open() && num)
+  if (handler_)
   {
-    offile_off_t pos = file_.ftell();
-    if (num <= pos)
+    if (status_.good() && num)
+    {
+      if (num <= pos_) pos_ -= num;
+      else status_ = EC_PutbackFailed; // tried to putback before start of file
+    }
+  }
+  else if (status_.good() && file_.open() && num)
+  {
+    if (num <= pos_)
     {
       if (file_.fseek(-num, SEEK_CUR))
       {
@@ -123,6 +247,7 @@ void DcmFileProducer::putback(offile_off_t num)
         file_.getLastErrorString(s);
         status_ = makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
       }
+      else pos_ -= num;
     }
     else status_ = EC_PutbackFailed; // tried to putback before start of file
   }
@@ -135,22 +260,36 @@ DcmInputFileStreamFactory::DcmInputFileStreamFactory(const OFFilename &filename,
 : DcmInputStreamFactory()
 , filename_(filename)
 , offset_(offset)
+, handler_(NULL)
 {
 }
 
+DcmInputFileStreamFactory::DcmInputFileStreamFactory(DcmSharedFileHandler *handler, offile_off_t offset)
+: DcmInputStreamFactory()
+, filename_(handler->getFilename())
+, offset_(offset)
+, handler_(handler)
+{
+  handler_->increaseRefCount();
+}
+
 DcmInputFileStreamFactory::DcmInputFileStreamFactory(const DcmInputFileStreamFactory& arg)
 : DcmInputStreamFactory(arg)
 , filename_(arg.filename_)
 , offset_(arg.offset_)
+, handler_(arg.handler_)
 {
+  if (handler_) handler_->increaseRefCount();
 }
 
 DcmInputFileStreamFactory::~DcmInputFileStreamFactory()
 {
+  if (handler_) handler_->decreaseRefCount();
 }
 
 DcmInputStream *DcmInputFileStreamFactory::create() const
 {
+  if (handler_) return new DcmInputFileStream(handler_, offset_);
   return new DcmInputFileStream(filename_, offset_);
 }
 
@@ -160,11 +299,26 @@ DcmInputFileStream::DcmInputFileStream(const OFFilename &filename, offile_off_t
 : DcmInputStream(&producer_) // safe because DcmInputStream only stores pointer
 , producer_(filename, offset)
 , filename_(filename)
+, handler_(NULL)
+{
+}
+
+DcmInputFileStream::DcmInputFileStream(DcmSharedFileHandler *handler, offile_off_t offset)
+: DcmInputStream(&producer_) // safe because DcmInputStream only stores pointer
+, producer_(handler, offset)
+, filename_()
+, handler_(handler)
 {
+  if (handler_)
+  {
+    handler_->increaseRefCount();
+    filename_ = handler_->getFilename();
+  }
 }
 
 DcmInputFileStream::~DcmInputFileStream()
 {
+  if (handler_) handler_->decreaseRefCount();
 }
 
 DcmInputStreamFactory *DcmInputFileStream::newFactory() const
@@ -173,7 +327,9 @@ DcmInputStreamFactory *DcmInputFileStream::newFactory() const
   if (currentProducer() == &producer_)
   {
     // no filter installed, can create factory object
-    result = new DcmInputFileStreamFactory(filename_, tell());
+    if (handler_)
+      result = new DcmInputFileStreamFactory(handler_, tell());
+      else result = new DcmInputFileStreamFactory(filename_, tell());
   }
   return result;
 }
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2010, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,7 +26,7 @@
 #include "dcmtk/dcmdata/dcistrmz.h"
 #include "dcmtk/dcmdata/dcerror.h"
 
-#define DCMZLIBINPUTFILTER_BUFSIZE 4096
+#define DCMZLIBINPUTFILTER_BUFSIZE 65536
 #define DCMZLIBINPUTFILTER_PUTBACKSIZE 1024
 
 OFGlobal<OFBool> dcmZlibExpectRFC1950Encoding(OFFalse);
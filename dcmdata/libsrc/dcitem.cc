@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2019, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -77,6 +77,27 @@
 #include "dcmtk/ofstd/ofcast.h"
 #include "dcmtk/ofstd/ofstd.h"
 
+// ********************************
+
+/* decode a 16 bit value stored in the given byte order */
+static inline Uint16 decodeUint16(const Uint8 *buf, const E_ByteOrder byteOrder)
+{
+    if (byteOrder == EBO_BigEndian)
+        return OFstatic_cast(Uint16, (buf[0] << 8) | buf[1]);
+    return OFstatic_cast(Uint16, buf[0] | (buf[1] << 8));
+}
+
+/* decode a 32 bit value stored in the given byte order */
+static inline Uint32 decodeUint32(const Uint8 *buf, const E_ByteOrder byteOrder)
+{
+    if (byteOrder == EBO_BigEndian)
+        return (OFstatic_cast(Uint32, buf[0]) << 24) | (OFstatic_cast(Uint32, buf[1]) << 16) |
+               (OFstatic_cast(Uint32, buf[2]) << 8) | OFstatic_cast(Uint32, buf[3]);
+    return OFstatic_cast(Uint32, buf[0]) | (OFstatic_cast(Uint32, buf[1]) << 8) |
+           (OFstatic_cast(Uint32, buf[2]) << 16) | (OFstatic_cast(Uint32, buf[3]) << 24);
+}
+
+
 // ********************************
 
 
@@ -983,7 +1004,9 @@ OFCondition DcmItem::readTagAndLength(DcmInputStream &inStream,
     /* check if either 4 (for implicit transfer syntaxes) or 6 (for explicit transfer */
     /* syntaxes) bytes are available in (i.e. can be read from) inStream. if an error */
     /* occurred while performing this check return this error */
-    if (inStream.avail() < OFstatic_cast(offile_off_t, xferSyn.isExplicitVR() ? 6 : 4))
+    const OFBool isExplicitVR = xferSyn.isExplicitVR();
+    const offile_off_t available = inStream.avail();
+    if (available < OFstatic_cast(offile_off_t, isExplicitVR ? 6 : 4))
         return EC_StreamNotifyClient;
 
     /* determine the byte ordering of the transfer syntax which was passed; */
@@ -992,29 +1015,53 @@ OFCondition DcmItem::readTagAndLength(DcmInputStream &inStream,
     if (byteOrder == EBO_unknown)
         return EC_IllegalCall;
 
-    /* read tag information (4 bytes) from inStream and create a corresponding DcmTag object */
+    /* each element header consists of at least 8 bytes (tag, VR and/or length field). */
+    /* if these are available, read them with a single call instead of reading each */
+    /* field separately, otherwise fall back to reading the header field by field. */
+    Uint8 header[8];
+    const OFBool bufferedHeader = (available >= 8);
     inStream.mark();
-    inStream.read(&groupTag, 2);
-    inStream.read(&elementTag, 2);
-    swapIfNecessary(gLocalByteOrder, byteOrder, &groupTag, 2, 2);
-    swapIfNecessary(gLocalByteOrder, byteOrder, &elementTag, 2, 2);
+    inStream.read(header, bufferedHeader ? 8 : 4);
+    /* number of bytes actually consumed from inStream so far */
+    Uint32 bytesConsumed = bufferedHeader ? 8 : 4;
+
+    /* decode tag information (4 bytes) */
+    groupTag = decodeUint16(header, byteOrder);
+    elementTag = decodeUint16(header + 2, byteOrder);
     // tag has been read
     bytesRead = 4;
-    DcmTag newTag(groupTag, elementTag);
-    DcmEVR newEVR = newTag.getEVR();
     // check whether tag is private
     OFBool isPrivate = groupTag & 1;
 
+    /* for explicit VR transfer syntaxes, the VR is taken from the dataset anyway, so the */
+    /* data dictionary only needs to be consulted if the user prefers the VR or the size */
+    /* of the length field from the dictionary. The only elements without VR are the */
+    /* item and delimitation items which can be recognized by their tag. */
+    const OFBool lookupInDictionary = !isExplicitVR ||
+        dcmPreferVRFromDataDictionary.get() || dcmPreferLengthFieldSizeFromDataDictionary.get();
+    const OFBool isItemOrDelimiter = (groupTag == 0xfffe) &&
+        ((elementTag == 0xe000) || (elementTag == 0xe00d) || (elementTag == 0xe0dd));
+    DcmTag newTag = lookupInDictionary ? DcmTag(groupTag, elementTag)
+                                       : DcmTag(groupTag, elementTag, DcmVR(isItemOrDelimiter ? EVR_na : EVR_UNKNOWN));
+    DcmEVR newEVR = newTag.getEVR();
+
     /* if the transfer syntax which was passed is an explicit VR syntax and if the current */
     /* item is not a delimitation item (note that delimitation items do not have a VR), go */
     /* ahead and read 2 bytes from inStream. These 2 bytes contain this item's VR value. */
-    if (xferSyn.isExplicitVR() && (newEVR != EVR_na))
+    if (isExplicitVR && (newEVR != EVR_na))
     {
         char vrstr[3];
         vrstr[2] = '\0';
 
         /* read 2 bytes */
-        inStream.read(vrstr, 2);
+        if (bufferedHeader)
+        {
+            vrstr[0] = OFstatic_cast(char, header[4]);
+            vrstr[1] = OFstatic_cast(char, header[5]);
+        } else {
+            inStream.read(vrstr, 2);
+            bytesConsumed += 2;
+        }
 
         /* create a corresponding DcmVR object */
         DcmVR vr(vrstr);
@@ -1103,7 +1150,7 @@ OFCondition DcmItem::readTagAndLength(DcmInputStream &inStream,
     /* the next thing we want to do is read the value in the length field from inStream. */
     /* determine if there is a corresponding amount of bytes (for the length field) still */
     /* available in inStream. If not, return an error. */
-    if (inStream.avail() < OFstatic_cast(offile_off_t, xferSyn.sizeofTagHeader(newEVR) - bytesRead))
+    if (inStream.avail() < OFstatic_cast(offile_off_t, xferSyn.sizeofTagHeader(newEVR) - bytesConsumed))
     {
         inStream.putback();    // the UnsetPutbackMark is in readSubElement
         bytesRead = 0;
@@ -1113,26 +1160,25 @@ OFCondition DcmItem::readTagAndLength(DcmInputStream &inStream,
 
     /* read the value in the length field. In some cases, it is 4 bytes wide, in other */
     /* cases only 2 bytes (see DICOM standard part 5, section 7.1.1) */
-    if (xferSyn.isImplicitVR() || newEVR == EVR_na) // note that delimitation items don't have a VR
+    if (!isExplicitVR || newEVR == EVR_na)         // note that delimitation items don't have a VR
     {
-        inStream.read(&valueLength, 4);            // length field is 4 bytes wide
-        swapIfNecessary(gLocalByteOrder, byteOrder, &valueLength, 4, 4);
+        if (!bufferedHeader)
+            inStream.read(header + 4, 4);
+        valueLength = decodeUint32(header + 4, byteOrder); // length field is 4 bytes wide
         bytesRead += 4;
     } else {                                       // the transfer syntax is explicit VR
         DcmVR vr(newEVR);
+        if (!bufferedHeader)
+            inStream.read(header + 6, 2);          // 2 reserved bytes or 2 bytes length field
         if (vr.usesExtendedLengthEncoding())
         {
-            Uint16 reserved;
-            inStream.read(&reserved, 2);           // 2 reserved bytes
-            inStream.read(&valueLength, 4);        // length field is 4 bytes wide
-            swapIfNecessary(gLocalByteOrder, byteOrder, &valueLength, 4, 4);
+            Uint8 lengthField[4];
+            inStream.read(lengthField, 4);         // length field is 4 bytes wide
+            valueLength = decodeUint32(lengthField, byteOrder);
             bytesRead += 6;
         } else {
-            Uint16 tmpValueLength;
-            inStream.read(&tmpValueLength, 2);     // length field is 2 bytes wide
-            swapIfNecessary(gLocalByteOrder, byteOrder, &tmpValueLength, 2, 2);
+            valueLength = decodeUint16(header + 6, byteOrder); // length field is 2 bytes wide
             bytesRead += 2;
-            valueLength = tmpValueLength;
         }
         /* check whether value in length field is appropriate for this VR */
         const size_t vrSize = vr.getValueWidth();
@@ -1336,6 +1382,7 @@ OFCondition DcmItem::readUntilTag(DcmInputStream & inStream,
         }
         DcmTag newTag;
         OFBool readStopElem = OFFalse;
+        const OFBool isImplicitVR = DcmXfer(xfer).isImplicitVR();
         /* start a loop in order to read all elements (attributes) which are contained in the inStream */
         while (inStream.good() && (getTransferredBytes() < getLengthField() || !lastElementComplete) && !readStopElem)
         {
@@ -1386,7 +1433,7 @@ OFCondition DcmItem::readUntilTag(DcmInputStream & inStream,
                     /* of an element; hence, lastElementComplete is not longer true */
                     lastElementComplete = OFFalse;
                     /* in case of implicit VR, check whether the "default VR" is really appropriate */
-                    if (DcmXfer(xfer).isImplicitVR())
+                    if (isImplicitVR)
                         checkAndUpdateVR(*this, newTag);
 
                     /* check if we want to stop parsing at this point, in the main dataset only */
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2010, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -21,7 +21,7 @@
 
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmdata/dcostrma.h"
-#include "dcmtk/dcmdata/dcostrmz.h" /* for DcmZLibOutputFilter */
+#include "dcmtk/dcmdata/dcostrmz.h" /* for DcmZLibOutputFilter, DcmZLibParallelOutputFilter */
 #include "dcmtk/dcmdata/dcerror.h"  /* for EC_IllegalCall */
 
 DcmOutputStream::DcmOutputStream(DcmConsumer *initial)
@@ -48,6 +48,12 @@ OFCondition DcmOutputStream::installCompressionFilter(E_StreamCompression filter
     {
 #ifdef WITH_ZLIB
       case ESC_zlib:
+#if defined(WITH_THREADS) && !defined(ZLIB_ENCODE_RFC1950_HEADER)
+        // compress blocks of the stream in parallel if requested
+        if (dcmZlibCompressionThreads.get() > 1)
+          compressionFilter_ = new DcmZLibParallelOutputFilter(dcmZlibCompressionThreads.get());
+        else
+#endif
         compressionFilter_ = new DcmZLibOutputFilter();
         if (compressionFilter_) 
         {
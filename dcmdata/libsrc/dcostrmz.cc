@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2010, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -26,7 +26,23 @@
 #include "dcmtk/dcmdata/dcostrmz.h"
 #include "dcmtk/dcmdata/dcerror.h"
 
-#define DCMZLIBOUTPUTFILTER_BUFSIZE 4096
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"    /* for class OFThread */
+#endif
+
+#define DCMZLIBOUTPUTFILTER_BUFSIZE 65536
+
+/* size of the blocks compressed independently by DcmZLibParallelOutputFilter */
+#define DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE 131072
+
+/* size of the dictionary used for each block, i.e. the deflate window size */
+#define DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE 32768
+
+/* maximum number of threads used by DcmZLibParallelOutputFilter. Each thread
+ * needs about 512 kB for its input block, output block and deflate state,
+ * and the size of all input blocks must not overflow a 32-bit computation.
+ */
+#define DCMZLIBPARALLELOUTPUTFILTER_MAXTHREADS 64
 
 /* taken from zutil.h */
 #if MAX_MEM_LEVEL >= 8
@@ -36,6 +52,7 @@
 #endif
 
 OFGlobal<int> dcmZlibCompressionLevel(Z_DEFAULT_COMPRESSION);
+OFGlobal<Uint32> dcmZlibCompressionThreads(1);
 
 // helper method to fix old-style casts warnings
 BEGIN_EXTERN_C
@@ -346,6 +363,446 @@ void DcmZLibOutputFilter::append(DcmConsumer& consumer)
   current_ = &consumer;
 }
 
+
+#ifdef WITH_THREADS
+
+/** helper class for DcmZLibParallelOutputFilter that compresses one block
+ *  of the input stream into a buffer of its own
+ */
+class DcmZLibBlockCompressor
+{
+public:
+
+  /// constructor
+  DcmZLibBlockCompressor()
+  : zstream_()
+  , initialized_(OFFalse)
+  , status_(EC_Normal)
+  , dictionary_(NULL)
+  , dictionaryCount_(0)
+  , input_(NULL)
+  , inputCount_(0)
+  , finalize_(OFFalse)
+  , outputBuf_(NULL)
+  , outputBufSize_(0)
+  , outputBufCount_(0)
+  {
+    zstream_.zalloc = Z_NULL;
+    zstream_.zfree = Z_NULL;
+    zstream_.opaque = Z_NULL;
+  }
+
+  /// destructor
+  ~DcmZLibBlockCompressor()
+  {
+    if (initialized_) deflateEnd(&zstream_);
+    delete[] outputBuf_;
+  }
+
+  /** initializes the compression engine
+   *  @param level compression level
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition init(int level)
+  {
+    /* windowBits is passed < 0 to suppress zlib header */
+    if (Z_OK == deflateInit2(&zstream_, level, Z_DEFLATED, -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY))
+      initialized_ = OFTrue;
+    else status_ = makeError();
+    return status_;
+  }
+
+  /** defines the block to be compressed by the next call to process()
+   *  @param dictionary pointer to the input data preceding the block
+   *  @param dictionaryCount number of bytes in dictionary
+   *  @param input pointer to the block
+   *  @param inputCount number of bytes in the block
+   *  @param finalize true if this is the last block of the stream
+   */
+  void setInput(const unsigned char *dictionary, offile_off_t dictionaryCount,
+    const unsigned char *input, offile_off_t inputCount, OFBool finalize)
+  {
+    dictionary_ = dictionary;
+    dictionaryCount_ = dictionaryCount;
+    input_ = input;
+    inputCount_ = inputCount;
+    finalize_ = finalize;
+    outputBufCount_ = 0;
+  }
+
+  /** compresses the block. Unless this is the last block of the stream,
+   *  the compressed data is terminated by a sync flush so that it ends on
+   *  a byte boundary and can be concatenated with the next block.
+   */
+  void process()
+  {
+    if (status_.bad()) return;
+    if ((Z_OK != deflateReset(&zstream_)) || ((dictionaryCount_ > 0) &&
+        (Z_OK != deflateSetDictionary(&zstream_, dictionary_, OFstatic_cast(uInt, dictionaryCount_)))))
+    {
+      status_ = makeError();
+      return;
+    }
+
+    // the sync flush marker and the final block need a few bytes in addition to the bound
+    offile_off_t size = OFstatic_cast(offile_off_t, deflateBound(&zstream_, OFstatic_cast(uLong, inputCount_))) + 16;
+    if (outputBufSize_ < size) resizeOutputBuffer(size);
+
+    zstream_.next_in = OFstatic_cast(Bytef *, OFconst_cast(unsigned char *, input_));
+    zstream_.avail_in = OFstatic_cast(uInt, inputCount_);
+    const int flushMode = finalize_ ? Z_FINISH : Z_SYNC_FLUSH;
+    int zstatus;
+    do
+    {
+      // enlarge output buffer if the compressed data does not fit (should never happen)
+      if (outputBufCount_ == outputBufSize_) resizeOutputBuffer(outputBufSize_ * 2);
+      zstream_.next_out = OFstatic_cast(Bytef *, outputBuf_ + outputBufCount_);
+      zstream_.avail_out = OFstatic_cast(uInt, outputBufSize_ - outputBufCount_);
+      zstatus = deflate(&zstream_, flushMode);
+      outputBufCount_ = outputBufSize_ - OFstatic_cast(offile_off_t, zstream_.avail_out);
+    } while ((zstatus == Z_OK) && (zstream_.avail_out == 0));
+
+    if ((zstatus != Z_OK) && (zstatus != Z_STREAM_END) && (zstatus != Z_BUF_ERROR)) status_ = makeError();
+  }
+
+  /** returns the status of the compressor
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition status() const
+  {
+    return status_;
+  }
+
+  /** returns the compressed data produced by the last call to process()
+   *  @return pointer to compressed data
+   */
+  const unsigned char *getOutput() const
+  {
+    return outputBuf_;
+  }
+
+  /** returns the number of compressed bytes produced by the last call to process()
+   *  @return number of bytes
+   */
+  offile_off_t getOutputCount() const
+  {
+    return outputBufCount_;
+  }
+
+private:
+
+  /// private unimplemented copy constructor
+  DcmZLibBlockCompressor(const DcmZLibBlockCompressor&);
+
+  /// private unimplemented copy assignment operator
+  DcmZLibBlockCompressor& operator=(const DcmZLibBlockCompressor&);
+
+  /** creates an error condition from the current zlib error message
+   *  @return error condition
+   */
+  OFCondition makeError() const
+  {
+    OFString etext = "ZLib Error: ";
+    if (zstream_.msg) etext += zstream_.msg;
+    return makeOFCondition(OFM_dcmdata, 16, OF_error, etext.c_str());
+  }
+
+  /** resizes the output buffer, keeping its content
+   *  @param size new size of the output buffer
+   */
+  void resizeOutputBuffer(offile_off_t size)
+  {
+    unsigned char *buf = new unsigned char[OFstatic_cast(size_t, size)];
+    if (outputBufCount_ > 0) memcpy(buf, outputBuf_, OFstatic_cast(size_t, outputBufCount_));
+    delete[] outputBuf_;
+    outputBuf_ = buf;
+    outputBufSize_ = size;
+  }
+
+  /// zlib stream, used for all blocks
+  z_stream zstream_;
+
+  /// true if zstream_ has been initialized
+  OFBool initialized_;
+
+  /// status
+  OFCondition status_;
+
+  /// input data preceding the block
+  const unsigned char *dictionary_;
+
+  /// number of bytes in dictionary_
+  offile_off_t dictionaryCount_;
+
+  /// block to be compressed
+  const unsigned char *input_;
+
+  /// number of bytes in input_
+  offile_off_t inputCount_;
+
+  /// true if the block is the last one of the stream
+  OFBool finalize_;
+
+  /// buffer for the compressed block
+  unsigned char *outputBuf_;
+
+  /// size of outputBuf_
+  offile_off_t outputBufSize_;
+
+  /// number of bytes in outputBuf_
+  offile_off_t outputBufCount_;
+};
+
+
+/** helper thread that runs a DcmZLibBlockCompressor
+ */
+class DcmZLibBlockCompressorThread: public OFThread
+{
+public:
+
+  /** constructor
+   *  @param compressor block compressor to run in this thread
+   */
+  DcmZLibBlockCompressorThread(DcmZLibBlockCompressor& compressor)
+  : OFThread()
+  , compressor_(compressor)
+  {
+  }
+
+protected:
+
+  /// thread entry point
+  virtual void run()
+  {
+    compressor_.process();
+  }
+
+private:
+
+  /// private unimplemented copy constructor
+  DcmZLibBlockCompressorThread(const DcmZLibBlockCompressorThread&);
+
+  /// private unimplemented copy assignment operator
+  DcmZLibBlockCompressorThread& operator=(const DcmZLibBlockCompressorThread&);
+
+  /// block compressor run in this thread
+  DcmZLibBlockCompressor& compressor_;
+};
+
+
+DcmZLibParallelOutputFilter::DcmZLibParallelOutputFilter(Uint32 numberOfThreads)
+: DcmOutputFilter()
+, current_(NULL)
+, status_(EC_Normal)
+, flushed_(OFFalse)
+, numberOfThreads_(numberOfThreads > 0 ? numberOfThreads : 1)
+, compressors_(NULL)
+, inputBuf_(NULL)
+, dictionaryCount_(0)
+, inputBufCount_(0)
+, outputBuf_(NULL)
+, outputBufSize_(0)
+, outputBufStart_(0)
+, outputBufCount_(0)
+{
+  if (numberOfThreads_ > DCMZLIBPARALLELOUTPUTFILTER_MAXTHREADS)
+    numberOfThreads_ = DCMZLIBPARALLELOUTPUTFILTER_MAXTHREADS;
+  inputBuf_ = new unsigned char[DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE + numberOfThreads_ * DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE];
+  compressors_ = new DcmZLibBlockCompressor *[numberOfThreads_];
+  const int level = dcmZlibCompressionLevel.get();
+  for (Uint32 i = 0; i < numberOfThreads_; ++i)
+  {
+    compressors_[i] = new DcmZLibBlockCompressor();
+    if (status_.good()) status_ = compressors_[i]->init(level);
+  }
+}
+
+DcmZLibParallelOutputFilter::~DcmZLibParallelOutputFilter()
+{
+  for (Uint32 i = 0; i < numberOfThreads_; ++i) delete compressors_[i];
+  delete[] compressors_;
+  delete[] inputBuf_;
+  delete[] outputBuf_;
+}
+
+
+OFBool DcmZLibParallelOutputFilter::good() const
+{
+  return status_.good();
+}
+
+OFCondition DcmZLibParallelOutputFilter::status() const
+{
+  return status_;
+}
+
+OFBool DcmZLibParallelOutputFilter::isFlushed() const
+{
+  if (status_.bad() || (current_ == NULL)) return OFTrue;
+  return (inputBufCount_ == 0) && (outputBufCount_ == 0) && flushed_ && current_->isFlushed();
+}
+
+
+offile_off_t DcmZLibParallelOutputFilter::avail() const
+{
+  // a complete batch can be processed unless compressed output is pending
+  if (status_.bad()) return 0;
+  const offile_off_t batchSize = numberOfThreads_ * DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE;
+  if (outputBufCount_ == 0) return batchSize;
+    else return batchSize - inputBufCount_;
+}
+
+void DcmZLibParallelOutputFilter::flushOutputBuffer()
+{
+  if (outputBufCount_)
+  {
+    offile_off_t written = current_->write(outputBuf_ + outputBufStart_, outputBufCount_);
+
+    // adjust counters
+    outputBufCount_ -= written;
+    outputBufStart_ += written;
+
+    // reset buffer start to make things faster
+    if (outputBufCount_ == 0) outputBufStart_ = 0;
+  }
+}
+
+void DcmZLibParallelOutputFilter::fillOutputBuffer(const unsigned char *buf, offile_off_t buflen)
+{
+  if (outputBufStart_ + outputBufCount_ + buflen > outputBufSize_)
+  {
+    // move pending output to the start of the buffer, enlarge buffer if still too small
+    if (outputBufCount_ + buflen > outputBufSize_)
+    {
+      offile_off_t size = 2 * outputBufSize_;
+      if (size < outputBufCount_ + buflen) size = outputBufCount_ + buflen;
+      unsigned char *newBuf = new unsigned char[OFstatic_cast(size_t, size)];
+      if (outputBufCount_ > 0) memcpy(newBuf, outputBuf_ + outputBufStart_, OFstatic_cast(size_t, outputBufCount_));
+      delete[] outputBuf_;
+      outputBuf_ = newBuf;
+      outputBufSize_ = size;
+    }
+    else memmove(outputBuf_, outputBuf_ + outputBufStart_, OFstatic_cast(size_t, outputBufCount_));
+    outputBufStart_ = 0;
+  }
+  memcpy(outputBuf_ + outputBufStart_ + outputBufCount_, buf, OFstatic_cast(size_t, buflen));
+  outputBufCount_ += buflen;
+}
+
+void DcmZLibParallelOutputFilter::compressInputBuffer(OFBool finalize)
+{
+  if ((inputBufCount_ == 0) && !finalize) return;
+
+  // the input follows the dictionary, which ends at a fixed position
+  unsigned char *input = inputBuf_ + DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE;
+  const unsigned char *streamStart = input - dictionaryCount_;
+
+  // an empty final block is needed to terminate the stream if there is no more input
+  Uint32 numberOfBlocks = OFstatic_cast(Uint32, (inputBufCount_ + DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE - 1) / DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE);
+  if (numberOfBlocks == 0) numberOfBlocks = 1;
+
+  Uint32 i;
+  for (i = 0; i < numberOfBlocks; ++i)
+  {
+    const unsigned char *block = input + i * DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE;
+    offile_off_t blockCount = inputBufCount_ - i * DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE;
+    if (blockCount > DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE) blockCount = DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE;
+    offile_off_t dictCount = block - streamStart;
+    if (dictCount > DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE) dictCount = DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE;
+    compressors_[i]->setInput(block - dictCount, dictCount, block, blockCount, finalize && (i + 1 == numberOfBlocks));
+  }
+
+  if (numberOfBlocks > 1)
+  {
+    DcmZLibBlockCompressorThread **threads = new DcmZLibBlockCompressorThread *[numberOfBlocks];
+    OFBool *running = new OFBool[numberOfBlocks];
+    for (i = 0; i < numberOfBlocks; ++i)
+    {
+      threads[i] = new DcmZLibBlockCompressorThread(*compressors_[i]);
+      // fall back to compressing in this thread if no thread could be created
+      running[i] = (threads[i]->start() == 0);
+      if (! running[i]) compressors_[i]->process();
+    }
+    for (i = 0; i < numberOfBlocks; ++i)
+    {
+      if (running[i]) threads[i]->join();
+      delete threads[i];
+    }
+    delete[] threads;
+    delete[] running;
+  }
+  else compressors_[0]->process();
+
+  // append the compressed blocks to the output in the original order
+  for (i = 0; (i < numberOfBlocks) && status_.good(); ++i)
+  {
+    status_ = compressors_[i]->status();
+    if (status_.good()) fillOutputBuffer(compressors_[i]->getOutput(), compressors_[i]->getOutputCount());
+  }
+
+  // keep the end of the input as dictionary for the next blocks
+  offile_off_t keep = dictionaryCount_ + inputBufCount_;
+  if (keep > DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE) keep = DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE;
+  memmove(input - keep, input + inputBufCount_ - keep, OFstatic_cast(size_t, keep));
+  dictionaryCount_ = keep;
+  inputBufCount_ = 0;
+  if (finalize) flushed_ = OFTrue;
+}
+
+offile_off_t DcmZLibParallelOutputFilter::write(const void *buf, offile_off_t buflen)
+{
+  if (status_.bad() || (current_ == NULL) || flushed_) return 0;
+
+  // flush output buffer if necessary
+  if (outputBufCount_ > 0) flushOutputBuffer();
+
+  const unsigned char *data = OFstatic_cast(const unsigned char *, buf);
+  const offile_off_t batchSize = numberOfThreads_ * DCMZLIBPARALLELOUTPUTFILTER_BLOCKSIZE;
+  offile_off_t result = 0;
+  while (status_.good() && (buflen > result))
+  {
+    // compress the input buffer once there is a block for each thread and more
+    // input arrives, unless the output of the previous batch is still pending
+    if (inputBufCount_ == batchSize)
+    {
+      if (outputBufCount_ > 0) break;
+      compressInputBuffer(OFFalse);
+      if (status_.good()) flushOutputBuffer();
+    }
+
+    // stuff as much into the input buffer as possible
+    offile_off_t len = batchSize - inputBufCount_;
+    if (len > buflen - result) len = buflen - result;
+    memcpy(inputBuf_ + DCMZLIBPARALLELOUTPUTFILTER_DICTSIZE + inputBufCount_, data + result, OFstatic_cast(size_t, len));
+    inputBufCount_ += len;
+    result += len;
+  }
+
+  // total number of bytes consumed from input
+  return result;
+}
+
+
+void DcmZLibParallelOutputFilter::flush()
+{
+  if (status_.good() && current_)
+  {
+    // compress pending input and terminate the compressed stream
+    if (! flushed_) compressInputBuffer(OFTrue);
+
+    // attempt to flush output buffer
+    if (status_.good() && (outputBufCount_ > 0)) flushOutputBuffer();
+  }
+}
+
+
+void DcmZLibParallelOutputFilter::append(DcmConsumer& consumer)
+{
+  current_ = &consumer;
+}
+
+#endif /* WITH_THREADS */
+
 #else  /* WITH_ZLIB */
 
 /* make sure that the object file is not completely empty if compiled
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2019, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -33,6 +33,300 @@
 #include "dcmtk/dcmdata/dcswap.h"    /* for swapIfNecessary() */
 #include "dcmtk/dcmdata/dcuid.h"     /* for dcmGenerateUniqueIdentifer()*/
 
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"    /* for class OFThread */
+#endif
+
+
+/** description of a compressed frame that is completely contained in a
+ *  single fragment, and of the buffer the frame is decompressed into
+ */
+struct DcmRLEDecoderStripeSet
+{
+  /// compressed frame, starting with the RLE header
+  const Uint8 *rleData;
+
+  /// number of bytes in the compressed frame
+  size_t rleLength;
+
+  /// RLE header in local byte order
+  Uint32 rleHeader[16];
+
+  /// number of stripes (RLE segments) of the frame
+  Uint32 numberOfStripes;
+
+  /// buffer for the decompressed frame
+  Uint8 *imageData;
+
+  /// number of bytes in each decompressed stripe
+  size_t bytesPerStripe;
+
+  /// number of bytes allocated per sample
+  Uint16 bytesAllocated;
+
+  /// number of samples per pixel
+  Uint16 samplesPerPixel;
+
+  /// planar configuration
+  Uint16 planarConfiguration;
+
+  /// assume incorrect LSB to MSB order of the RLE segments
+  OFBool reverseByteOrder;
+};
+
+
+/** computes the position of the first byte of a stripe in the decompressed frame
+ *  @param stripeSet description of the frame
+ *  @param stripeIndex index of the stripe
+ *  @param offsetBetweenSamples returns the offset between consecutive bytes of the stripe
+ *  @return pointer to the first byte of the stripe
+ */
+static Uint8 *getStripeStart(
+  const DcmRLEDecoderStripeSet& stripeSet,
+  Uint32 stripeIndex,
+  Uint32& offsetBetweenSamples)
+{
+  // which sample and byte are we currently decompressing?
+  const size_t sample = stripeIndex / stripeSet.bytesAllocated;
+  const size_t byte = stripeIndex % stripeSet.bytesAllocated;
+  size_t sampleOffset = 0;
+
+  // compute byte offsets
+  if (stripeSet.planarConfiguration == 0)
+  {
+    sampleOffset = sample * stripeSet.bytesAllocated;
+    offsetBetweenSamples = stripeSet.samplesPerPixel * stripeSet.bytesAllocated;
+  }
+  else
+  {
+    sampleOffset = sample * stripeSet.bytesAllocated * stripeSet.bytesPerStripe;
+    offsetBetweenSamples = stripeSet.bytesAllocated;
+  }
+
+  if (stripeSet.reverseByteOrder)
+  {
+    // assume incorrect LSB to MSB order of RLE segments as produced by some tools
+    return stripeSet.imageData + sampleOffset + byte;
+  }
+  return stripeSet.imageData + sampleOffset + stripeSet.bytesAllocated - byte - 1;
+}
+
+
+/** distributes the bytes of a decompressed stripe into the decompressed frame.
+ *  If the stripe is incomplete, the remaining pixels are filled with copies
+ *  of the last decoded byte.
+ *  @param outputBuffer decompressed stripe
+ *  @param decodedSize number of bytes in the decompressed stripe
+ *  @param bytesPerStripe expected number of bytes per stripe
+ *  @param pixelPointer position of the first byte of the stripe in the frame
+ *  @param offsetBetweenSamples offset between consecutive bytes of the stripe
+ */
+static void distributeStripe(
+  const Uint8 *outputBuffer,
+  size_t decodedSize,
+  size_t bytesPerStripe,
+  Uint8 *pixelPointer,
+  Uint32 offsetBetweenSamples)
+{
+  size_t pixel;
+  if (decodedSize > bytesPerStripe) decodedSize = bytesPerStripe;
+
+  if (offsetBetweenSamples == 1)
+  {
+    // the stripe is contiguous in the frame, e.g. for 8 bit monochrome images
+    memcpy(pixelPointer, outputBuffer, decodedSize);
+    pixelPointer += decodedSize;
+  }
+  else
+  {
+    for (pixel = 0; pixel < decodedSize; ++pixel)
+    {
+      *pixelPointer = outputBuffer[pixel];
+      pixelPointer += offsetBetweenSamples;
+    }
+  }
+
+  // fill the remainder of the stripe with copies of the last decoded pixel
+  const Uint8 lastPixelValue = (decodedSize > 0) ? outputBuffer[decodedSize - 1] : 0;
+  for (pixel = decodedSize; pixel < bytesPerStripe; ++pixel)
+  {
+    *pixelPointer = lastPixelValue;
+    pixelPointer += offsetBetweenSamples;
+  }
+}
+
+
+/** decompresses one stripe of a frame that is contained in a single fragment
+ *  and distributes the decompressed bytes into the output frame.
+ *  @param rledecoder RLE decoder to be used
+ *  @param stripeSet description of the frame
+ *  @param stripeIndex index of the stripe
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition decodeStripe(
+  DcmRLEDecoder& rledecoder,
+  const DcmRLEDecoderStripeSet& stripeSet,
+  Uint32 stripeIndex)
+{
+  const OFBool lastStripe = (stripeIndex + 1 == stripeSet.numberOfStripes);
+
+  // the last stripe ends with the fragment, the others where the next one starts
+  const size_t firstByte = stripeSet.rleHeader[stripeIndex + 1];
+  const size_t lastByte = lastStripe ? stripeSet.rleLength : stripeSet.rleHeader[stripeIndex + 2];
+  if ((firstByte > lastByte) || (lastByte > stripeSet.rleLength)) return EC_CannotChangeRepresentation;
+
+  // reset RLE codec and decompress the stripe
+  rledecoder.clear();
+  OFCondition result = rledecoder.decompress(OFconst_cast(Uint8 *, stripeSet.rleData + firstByte), lastByte - firstByte);
+
+  // special handling for zero pad byte at the end of the RLE stream
+  // which results in an EC_StreamNotifyClient return code
+  // or trailing garbage data which results in EC_CorruptedData
+  if (rledecoder.size() == stripeSet.bytesPerStripe) result = EC_Normal;
+
+  // make sure the RLE decoder has produced the right amount of data
+  const OFBool lastStripeOfColor = lastStripe || ((stripeSet.planarConfiguration == 1) && ((stripeIndex + 1) % stripeSet.bytesAllocated == 0));
+  if (lastStripeOfColor && (rledecoder.size() < stripeSet.bytesPerStripe))
+  {
+    // stripe ended prematurely? report a warning and continue
+    DCMDATA_WARN("RLE decoder is finished but has produced insufficient data for this stripe, filling remaining pixels");
+    result = EC_Normal;
+  }
+  else if (rledecoder.size() != stripeSet.bytesPerStripe)
+  {
+    DCMDATA_ERROR("RLE decoder is finished but has produced insufficient data for this stripe");
+    result = EC_CannotChangeRepresentation;
+  }
+
+  // distribute decompressed bytes into output image array
+  if (result.good())
+  {
+    Uint32 offsetBetweenSamples = 0;
+    Uint8 *pixelPointer = getStripeStart(stripeSet, stripeIndex, offsetBetweenSamples);
+    distributeStripe(OFstatic_cast(const Uint8 *, rledecoder.getOutputBuffer()), rledecoder.size(),
+      stripeSet.bytesPerStripe, pixelPointer, offsetBetweenSamples);
+  }
+  return result;
+}
+
+
+#ifdef WITH_THREADS
+
+/** helper thread that decompresses every n-th stripe of a frame
+ */
+class DcmRLEStripeDecoderWorker: public OFThread
+{
+public:
+  /** constructor
+   *  @param stripeSet description of the frame
+   *  @param firstStripe index of the first stripe decompressed by this thread
+   *  @param step distance between the stripes decompressed by this thread
+   */
+  DcmRLEStripeDecoderWorker(const DcmRLEDecoderStripeSet& stripeSet, Uint32 firstStripe, Uint32 step)
+  : OFThread()
+  , stripes(stripeSet)
+  , first(firstStripe)
+  , increment(step)
+  , result(EC_Normal)
+  {
+  }
+
+  /** decompresses the stripes assigned to this thread
+   */
+  void process()
+  {
+    DcmRLEDecoder rledecoder(stripes.bytesPerStripe);
+    if (rledecoder.fail()) result = EC_MemoryExhausted;
+    for (Uint32 stripeIndex = first; (stripeIndex < stripes.numberOfStripes) && result.good(); stripeIndex += increment)
+    {
+      result = decodeStripe(rledecoder, stripes, stripeIndex);
+    }
+  }
+
+  /** returns the result of the decompression
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition getResult() const
+  {
+    return result;
+  }
+
+protected:
+  /// thread entry point
+  virtual void run()
+  {
+    process();
+  }
+
+private:
+  /// private undefined copy constructor
+  DcmRLEStripeDecoderWorker(const DcmRLEStripeDecoderWorker&);
+
+  /// private undefined copy assignment operator
+  DcmRLEStripeDecoderWorker& operator=(const DcmRLEStripeDecoderWorker&);
+
+  /// description of the frame
+  const DcmRLEDecoderStripeSet& stripes;
+
+  /// index of the first stripe decompressed by this thread
+  Uint32 first;
+
+  /// distance between the stripes decompressed by this thread
+  Uint32 increment;
+
+  /// result of the decompression
+  OFCondition result;
+};
+
+#endif
+
+
+/** decompresses all stripes of a frame that is contained in a single fragment.
+ *  The stripes are independent of each other and are processed in parallel
+ *  if more than one thread is requested.
+ *  @param rledecoder RLE decoder used if the stripes are decompressed in this thread
+ *  @param stripeSet description of the frame
+ *  @param numberOfThreads number of threads to be used
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition decodeStripeSet(
+  DcmRLEDecoder& rledecoder,
+  const DcmRLEDecoderStripeSet& stripeSet,
+  Uint32 numberOfThreads)
+{
+  OFCondition result = EC_Normal;
+#ifdef WITH_THREADS
+  if (numberOfThreads > stripeSet.numberOfStripes) numberOfThreads = stripeSet.numberOfStripes;
+  if (numberOfThreads > 1)
+  {
+    DcmRLEStripeDecoderWorker *workers[15];
+    OFBool running[15];
+    Uint32 t;
+    for (t = 0; t < numberOfThreads; ++t)
+    {
+      workers[t] = new DcmRLEStripeDecoderWorker(stripeSet, t, numberOfThreads);
+      // fall back to decompressing in this thread if no thread could be created
+      running[t] = (workers[t]->start() == 0);
+      if (! running[t]) workers[t]->process();
+    }
+    for (t = 0; t < numberOfThreads; ++t)
+    {
+      if (running[t]) workers[t]->join();
+      if (result.good()) result = workers[t]->getResult();
+      delete workers[t];
+    }
+    return result;
+  }
+#else
+  (void) numberOfThreads;
+#endif
+  for (Uint32 stripeIndex = 0; (stripeIndex < stripeSet.numberOfStripes) && result.good(); ++stripeIndex)
+  {
+    result = decodeStripe(rledecoder, stripeSet, stripeIndex);
+  }
+  return result;
+}
+
 
 DcmRLECodecDecoder::DcmRLECodecDecoder()
 : DcmCodec()
@@ -139,6 +433,16 @@ OFCondition DcmRLECodecDecoder::decode(
         {
           Uint8 *imageData8 = OFreinterpret_cast(Uint8 *, imageData16);
 
+          // if each frame is contained in a single fragment (which is required by the
+          // DICOM standard), the start and end of all stripes are known in advance
+          const OFBool singleFragmentFrames = (pixSeq->card() == OFstatic_cast(unsigned long, imageFrames) + 1);
+          DcmRLEDecoderStripeSet stripeSet;
+          stripeSet.bytesPerStripe = bytesPerStripe;
+          stripeSet.bytesAllocated = imageBytesAllocated;
+          stripeSet.samplesPerPixel = imageSamplesPerPixel;
+          stripeSet.planarConfiguration = imagePlanarConfiguration;
+          stripeSet.reverseByteOrder = enableReverseByteOrder;
+
           while ((currentFrame < imageFrames) && result.good())
           {
             DCMDATA_DEBUG("RLE decoder processes frame " << currentFrame);
@@ -173,6 +477,19 @@ OFCondition DcmRLECodecDecoder::decode(
             }
 
             if (result.good())
+            {
+              stripeSet.numberOfStripes = numberOfStripes;
+              stripeSet.imageData = imageData8;
+            }
+
+            if (result.good() && singleFragmentFrames)
+            {
+              stripeSet.rleData = rleData;
+              stripeSet.rleLength = fragmentLength;
+              memcpy(stripeSet.rleHeader, rleHeader, sizeof(rleHeader));
+              result = decodeStripeSet(rledecoder, stripeSet, djcp->getNumberOfThreads());
+            }
+            else if (result.good())
             {
               // this variable keeps the number of bytes we have processed
               // for the current frame in earlier pixel fragments
@@ -185,21 +502,12 @@ OFCondition DcmRLECodecDecoder::decode(
               OFBool lastStripeOfColor = OFFalse;
               Uint32 inputBytes = 0;
 
-              // pointers for buffer copy operations
-              Uint8 *outputBuffer = NULL;
+              // pointer for buffer copy operations
               Uint8 *pixelPointer = NULL;
 
-              // byte offset for first sample in frame
-              Uint32 sampleOffset = 0;
-
               // byte offset between samples
               Uint32 offsetBetweenSamples = 0;
 
-              // temporary variables
-              Uint32 sample = 0;
-              Uint32 byte = 0;
-              Uint32 pixel = 0;
-
               // for each stripe in stripe set
               for (Uint32 stripeIndex = 0; (stripeIndex < numberOfStripes) && result.good(); ++stripeIndex)
               {
@@ -332,42 +640,9 @@ OFCondition DcmRLECodecDecoder::decode(
                 // distribute decompressed bytes into output image array
                 if (result.good())
                 {
-                  // which sample and byte are we currently compressing?
-                  sample = stripeIndex / imageBytesAllocated;
-                  byte = stripeIndex % imageBytesAllocated;
-
-                  // raw buffer containing bytesPerStripe bytes of uncompressed data
-                  outputBuffer = OFstatic_cast(Uint8 *, rledecoder.getOutputBuffer());
-
-                  // compute byte offsets
-                  if (imagePlanarConfiguration == 0)
-                  {
-                     sampleOffset = sample * imageBytesAllocated;
-                     offsetBetweenSamples = imageSamplesPerPixel * imageBytesAllocated;
-                  }
-                  else
-                  {
-                     sampleOffset = sample * imageBytesAllocated * imageColumns * imageRows;
-                     offsetBetweenSamples = imageBytesAllocated;
-                  }
-
-                  // initialize pointer to output data
-                  if (enableReverseByteOrder)
-                  {
-                    // assume incorrect LSB to MSB order of RLE segments as produced by some tools
-                    pixelPointer = imageData8 + sampleOffset + byte;
-                  }
-                  else
-                  {
-                    pixelPointer = imageData8 + sampleOffset + imageBytesAllocated - byte - 1;
-                  }
-
-                  // loop through all pixels of the frame
-                  for (pixel = 0; pixel < bytesPerStripe; ++pixel)
-                  {
-                    *pixelPointer = *outputBuffer++;
-                    pixelPointer += offsetBetweenSamples;
-                  }
+                  pixelPointer = getStripeStart(stripeSet, stripeIndex, offsetBetweenSamples);
+                  distributeStripe(OFstatic_cast(const Uint8 *, rledecoder.getOutputBuffer()), rledecoder.size(),
+                    bytesPerStripe, pixelPointer, offsetBetweenSamples);
                 }
               } /* for */
             }
@@ -512,136 +787,21 @@ OFCondition DcmRLECodecDecoder::decodeFrame(
     if ((numberOfStripes < 1) || (numberOfStripes > 15) || (numberOfStripes != OFstatic_cast(Uint32, imageBytesAllocated) * imageSamplesPerPixel))
         return EC_CannotChangeRepresentation;
 
-    // this variable keeps the current position within the current fragment
-    Uint32 byteOffset = 0;
-
-    OFBool lastStripe = OFFalse;
-    OFBool lastStripeOfColor = OFFalse;
-    Uint32 inputBytes = 0;
-
-    // pointers for buffer copy operations
-    Uint8 *outputBuffer = NULL;
-    Uint8 *pixelPointer = NULL;
     Uint16 *imageData16 = OFreinterpret_cast(Uint16 *, buffer);
-    Uint8 *imageData8 = OFreinterpret_cast(Uint8 *, buffer);
-
-    // byte offset for first sample in frame
-    Uint32 sampleOffset = 0;
-
-    // byte offset between samples
-    Uint32 offsetBetweenSamples = 0;
-
-    // temporary variables
-    Uint32 sample = 0;
-    Uint32 byte = 0;
-    Uint32 pixel = 0;
-    size_t bytesToDecode;
-
-    // for each stripe in stripe set
-    for (Uint32 stripeIndex = 0; stripeIndex < numberOfStripes; ++stripeIndex)
-    {
-        // reset RLE codec
-        rledecoder.clear();
-
-        // adjust start point for RLE stripe
-        byteOffset = rleHeader[stripeIndex + 1];
-
-        // byteOffset now points to the first byte of the new RLE stripe
-        // check if the current stripe is the last one for this frame
-        if (stripeIndex + 1 == numberOfStripes) lastStripe = OFTrue; else lastStripe = OFFalse;
-
-        if (lastStripe)
-        {
-            // the last stripe needs special handling because we cannot use the
-            // offset table to determine the number of bytes to feed to the codec
-            // if the RLE data is split in multiple fragments. We need to feed
-            // data fragment by fragment until the RLE codec has produced
-            // sufficient output.
-            bytesToDecode = OFstatic_cast(size_t, fragmentLength - byteOffset);
-        }
-        else
-        {
-            // not the last stripe. We can use the offset table to determine
-            // the number of bytes to feed to the RLE codec.
-            inputBytes = rleHeader[stripeIndex+2];
-            if (inputBytes < rleHeader[stripeIndex + 1]) return EC_CannotChangeRepresentation;
-
-            inputBytes -= rleHeader[stripeIndex + 1]; // number of bytes to feed to codec
-
-            bytesToDecode = OFstatic_cast(size_t, inputBytes);
-        }
-
-        // last fragment for this RLE stripe
-        result = rledecoder.decompress(rleData + byteOffset, bytesToDecode);
-
-        // special handling for zero pad byte at the end of the RLE stream
-        // which results in an EC_StreamNotifyClient return code
-        // or trailing garbage data which results in EC_CorruptedData
-        if (rledecoder.size() == bytesPerStripe) result = EC_Normal;
-
-        byteOffset += inputBytes;
-
-        // copy the decoded stuff over to the buffer here...
-        // make sure the RLE decoder has produced the right amount of data
-        lastStripeOfColor = lastStripe || ((imagePlanarConfiguration == 1) && ((stripeIndex + 1) % imageBytesAllocated == 0));
-        if (lastStripeOfColor && (rledecoder.size() < bytesPerStripe))
-        {
-            // stripe ended prematurely? report a warning and continue
-            DCMDATA_WARN("RLE decoder is finished but has produced insufficient data for this stripe, filling remaining pixels");
-            result = EC_Normal;
-        }
-        else if (rledecoder.size() != bytesPerStripe)
-        {
-            DCMDATA_ERROR("RLE decoder is finished but has produced insufficient data for this stripe");
-            return EC_CannotChangeRepresentation;
-        }
-
-        // distribute decompressed bytes into output image array
-        // which sample and byte are we currently decompressing?
-        sample = stripeIndex / imageBytesAllocated;
-        byte = stripeIndex % imageBytesAllocated;
-
-        // raw buffer containing bytesPerStripe bytes of uncompressed data
-        outputBuffer = OFstatic_cast(Uint8 *, rledecoder.getOutputBuffer());
-
-        // compute byte offsets
-        if (imagePlanarConfiguration == 0)
-        {
-            sampleOffset = sample * imageBytesAllocated;
-            offsetBetweenSamples = imageSamplesPerPixel * imageBytesAllocated;
-        }
-        else
-        {
-            sampleOffset = sample * imageBytesAllocated * imageColumns * imageRows;
-            offsetBetweenSamples = imageBytesAllocated;
-        }
 
-        // initialize pointer to output data
-        if (enableReverseByteOrder)
-        {
-            // assume incorrect LSB to MSB order of RLE segments as produced by some tools
-            pixelPointer = imageData8 + sampleOffset + byte;
-        }
-        else
-        {
-            pixelPointer = imageData8 + sampleOffset + imageBytesAllocated - byte - 1;
-        }
-
-        // copy the pixel data that was decoded
-        const size_t decoderSize = rledecoder.size();
-        for (pixel = 0; pixel < decoderSize; ++pixel)
-        {
-            *pixelPointer = *outputBuffer++;
-            pixelPointer += offsetBetweenSamples;
-        }
-        // and fill the remainder of the image with copies of the last decoded pixel
-        const Uint8 lastPixelValue = *(outputBuffer - 1);
-        for (pixel = OFstatic_cast(Uint32, decoderSize); pixel < bytesPerStripe; ++pixel)
-        {
-            *pixelPointer = lastPixelValue;
-            pixelPointer += offsetBetweenSamples;
-        }
-    }
+    // the frame is contained in a single fragment, decompress all of its stripes
+    DcmRLEDecoderStripeSet stripeSet;
+    stripeSet.rleData = rleData;
+    stripeSet.rleLength = fragmentLength;
+    memcpy(stripeSet.rleHeader, rleHeader, sizeof(rleHeader));
+    stripeSet.numberOfStripes = numberOfStripes;
+    stripeSet.imageData = OFreinterpret_cast(Uint8 *, buffer);
+    stripeSet.bytesPerStripe = bytesPerStripe;
+    stripeSet.bytesAllocated = imageBytesAllocated;
+    stripeSet.samplesPerPixel = imageSamplesPerPixel;
+    stripeSet.planarConfiguration = imagePlanarConfiguration;
+    stripeSet.reverseByteOrder = enableReverseByteOrder;
+    result = decodeStripeSet(rledecoder, stripeSet, djcp->getNumberOfThreads());
 
     /* remove used fragment from memory */
     pixItem->compact(); // there should only be one...
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -35,10 +35,185 @@
 #include "dcmtk/ofstd/ofstdinc.h"
 
 
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"    /* for class OFThread */
+#endif
+
+
 typedef OFList<DcmRLEEncoder *> DcmRLEEncoderList;
 typedef OFListIterator(DcmRLEEncoder *) DcmRLEEncoderListIterator;
 
 
+/** description of the stripes (RLE segments) of one frame to be compressed
+ */
+struct DcmRLEEncoderStripeSet
+{
+  /// RLE encoder for each stripe
+  DcmRLEEncoder *rleEncoder[15];
+
+  /// pointer to the first byte of each stripe in the uncompressed frame
+  const Uint8 *stripeData[15];
+
+  /// number of stripes of the frame
+  Uint32 numberOfStripes;
+
+  /// number of columns of the image
+  Uint16 columns;
+
+  /// number of rows of the image
+  Uint16 rows;
+
+  /// offset between consecutive bytes of a stripe in the uncompressed frame
+  Uint32 offsetBetweenSamples;
+};
+
+
+/** compresses one stripe of a frame, i.e.\ one byte of one sample of all pixels.
+ *  The bytes of each row are collected in a buffer and passed to the RLE encoder
+ *  as a block, which allows the encoder to detect runs of identical bytes quickly.
+ *  @param stripeSet description of the frame
+ *  @param stripeIndex index of the stripe
+ *  @param rowBuffer buffer of at least stripeSet.columns bytes
+ */
+static void encodeStripe(
+  const DcmRLEEncoderStripeSet& stripeSet,
+  Uint32 stripeIndex,
+  Uint8 *rowBuffer)
+{
+  DcmRLEEncoder *rleEncoder = stripeSet.rleEncoder[stripeIndex];
+  const Uint8 *pixelPointer = stripeSet.stripeData[stripeIndex];
+  const Uint32 offsetBetweenSamples = stripeSet.offsetBetweenSamples;
+  const Uint16 columns = stripeSet.columns;
+  Uint16 column;
+
+  for (Uint16 row = 0; row < stripeSet.rows; ++row)
+  {
+    if (offsetBetweenSamples == 1)
+    {
+      // the row is contiguous in the frame, e.g. for 8 bit monochrome images
+      rleEncoder->add(pixelPointer, columns);
+      pixelPointer += columns;
+    }
+    else
+    {
+      for (column = 0; column < columns; ++column)
+      {
+        rowBuffer[column] = *pixelPointer;
+        pixelPointer += offsetBetweenSamples;
+      }
+      rleEncoder->add(rowBuffer, columns);
+    }
+
+    // enforce DICOM rule that "Each row of the image shall be encoded
+    // separately and not cross a row boundary."
+    // (see DICOM part 5 section G.3.1)
+    rleEncoder->flush();
+  }
+}
+
+
+#ifdef WITH_THREADS
+
+/** helper thread that compresses every n-th stripe of a frame
+ */
+class DcmRLEStripeEncoderWorker: public OFThread
+{
+public:
+  /** constructor
+   *  @param stripeSet description of the frame
+   *  @param firstStripe index of the first stripe compressed by this thread
+   *  @param step distance between the stripes compressed by this thread
+   */
+  DcmRLEStripeEncoderWorker(const DcmRLEEncoderStripeSet& stripeSet, Uint32 firstStripe, Uint32 step)
+  : OFThread()
+  , stripes(stripeSet)
+  , first(firstStripe)
+  , increment(step)
+  {
+  }
+
+  /** compresses the stripes assigned to this thread
+   */
+  void process()
+  {
+    Uint8 *rowBuffer = new Uint8[stripes.columns];
+    for (Uint32 stripeIndex = first; stripeIndex < stripes.numberOfStripes; stripeIndex += increment)
+    {
+      encodeStripe(stripes, stripeIndex, rowBuffer);
+    }
+    delete[] rowBuffer;
+  }
+
+protected:
+  /// thread entry point
+  virtual void run()
+  {
+    process();
+  }
+
+private:
+  /// private undefined copy constructor
+  DcmRLEStripeEncoderWorker(const DcmRLEStripeEncoderWorker&);
+
+  /// private undefined copy assignment operator
+  DcmRLEStripeEncoderWorker& operator=(const DcmRLEStripeEncoderWorker&);
+
+  /// description of the frame
+  const DcmRLEEncoderStripeSet& stripes;
+
+  /// index of the first stripe compressed by this thread
+  Uint32 first;
+
+  /// distance between the stripes compressed by this thread
+  Uint32 increment;
+};
+
+#endif
+
+
+/** compresses all stripes of a frame. The stripes are independent of each
+ *  other and are processed in parallel if more than one thread is requested.
+ *  @param stripeSet description of the frame
+ *  @param numberOfThreads number of threads to be used
+ *  @param rowBuffer buffer of at least stripeSet.columns bytes, used if the
+ *    stripes are compressed in this thread
+ */
+static void encodeStripeSet(
+  const DcmRLEEncoderStripeSet& stripeSet,
+  Uint32 numberOfThreads,
+  Uint8 *rowBuffer)
+{
+#ifdef WITH_THREADS
+  if (numberOfThreads > stripeSet.numberOfStripes) numberOfThreads = stripeSet.numberOfStripes;
+  if (numberOfThreads > 1)
+  {
+    DcmRLEStripeEncoderWorker *workers[15];
+    OFBool running[15];
+    Uint32 t;
+    for (t = 0; t < numberOfThreads; ++t)
+    {
+      workers[t] = new DcmRLEStripeEncoderWorker(stripeSet, t, numberOfThreads);
+      // fall back to compressing in this thread if no thread could be created
+      running[t] = (workers[t]->start() == 0);
+      if (! running[t]) workers[t]->process();
+    }
+    for (t = 0; t < numberOfThreads; ++t)
+    {
+      if (running[t]) workers[t]->join();
+      delete workers[t];
+    }
+    return;
+  }
+#else
+  (void) numberOfThreads;
+#endif
+  for (Uint32 stripeIndex = 0; stripeIndex < stripeSet.numberOfStripes; ++stripeIndex)
+  {
+    encodeStripe(stripeSet, stripeIndex, rowBuffer);
+  }
+}
+
+
 // =======================================================================
 
 DcmRLECodecEncoder::DcmRLECodecEncoder()
@@ -205,20 +380,20 @@ OFCondition DcmRLECodecEncoder::encode(
     // create RLE stripe sets
     if (result.good())
     {
-      const Uint32 bytesPerStripe = columns * rows;
       const Uint32 frameSize = columns * rows * samplesPerPixel * bytesAllocated;
       Uint32 frameOffset = 0;
       Uint32 sampleOffset = 0;
       Uint32 offsetBetweenSamples = 0;
       Uint32 sample = 0;
       Uint32 byte = 0;
-      Uint32 pixel = 0;
-      Uint32 columnCounter = 0;
+      Uint32 stripe = 0;
 
       DcmRLEEncoder *rleEncoder = NULL;
       Uint32 rleSize = 0;
       Uint8 *rleData = NULL;
       Uint8 *rleData2 = NULL;
+      Uint8 *rowBuffer = new Uint8[columns];
+      DcmRLEEncoderStripeSet stripeSet;
 
       // warn about (possibly) non-standard fragmentation
       if (djcp->getFragmentSize() > 0)
@@ -229,11 +404,16 @@ OFCondition DcmRLECodecEncoder::encode(
          offsetBetweenSamples = samplesPerPixel * bytesAllocated;
          else offsetBetweenSamples = bytesAllocated;
 
+      stripeSet.columns = columns;
+      stripeSet.rows = rows;
+      stripeSet.offsetBetweenSamples = offsetBetweenSamples;
+
       // loop through all frames of the image
       for (Uint32 currentFrame = 0; ((currentFrame < OFstatic_cast(Uint32, numberOfFrames)) && result.good()); currentFrame++)
       {
         // offset to start of frame, in bytes
         frameOffset = frameSize * currentFrame;
+        stripe = 0;
 
         // loop through all samples of one frame
         for (sample = 0; sample < samplesPerPixel; sample++)
@@ -253,30 +433,23 @@ OFCondition DcmRLECodecEncoder::encode(
             if (rleEncoder)
             {
               rleEncoderList.push_back(rleEncoder);
-              columnCounter = columns;
-
-              // loop through all pixels of the frame
-              for (pixel = 0; pixel < bytesPerStripe; ++pixel)
-              {
-                rleEncoder->add(*pixelPointer);
-
-                // enforce DICOM rule that "Each row of the image shall be encoded
-                // separately and not cross a row boundary."
-                // (see DICOM part 5 section G.3.1)
-                if (--columnCounter == 0)
-                {
-                  rleEncoder->flush();
-                  columnCounter = columns;
-                }
-                pixelPointer += offsetBetweenSamples;
-              }
-
-              rleEncoder->flush();
-              if (rleEncoder->fail()) result = EC_MemoryExhausted;
+              stripeSet.rleEncoder[stripe] = rleEncoder;
+              stripeSet.stripeData[stripe++] = pixelPointer;
             } else result = EC_MemoryExhausted;
           }
         }
 
+        // compress all stripes of the frame
+        if (result.good())
+        {
+          stripeSet.numberOfStripes = stripe;
+          encodeStripeSet(stripeSet, djcp->getNumberOfThreads(), rowBuffer);
+          for (first = rleEncoderList.begin(); first != last; ++first)
+          {
+            if ((*first)->fail()) result = EC_MemoryExhausted;
+          }
+        }
+
         // store frame and erase RLE codec list
         if (result.good() && (rleEncoderList.size() > 0) && (rleEncoderList.size() < 16))
         {
@@ -336,6 +509,7 @@ OFCondition DcmRLECodecEncoder::encode(
 
       }
 
+      delete[] rowBuffer;
     }
 
     // store pixel sequence if everything went well.
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2017, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -22,6 +22,70 @@
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 #include "dcmtk/dcmdata/dcswap.h"
 
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+
+/* The following helper functions swap arrays of 2, 4 and 8 byte values.
+ * Each value is loaded into an integer with memcpy(), which avoids problems
+ * with unaligned buffers, and reversed with shift and mask operations that
+ * optimizing compilers translate into (vectorized) byte swap instructions.
+ */
+
+static void swapWords16(Uint8 *value, const size_t count)
+{
+    Uint16 word;
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(&word, value, sizeof(word));
+        word = OFstatic_cast(Uint16, (word >> 8) | (word << 8));
+        memcpy(value, &word, sizeof(word));
+        value += sizeof(word);
+    }
+}
+
+static void swapWords32(Uint8 *value, const size_t count)
+{
+    Uint32 word;
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(&word, value, sizeof(word));
+        word = ((word & 0x000000ffUL) << 24) | ((word & 0x0000ff00UL) << 8) |
+               ((word >> 8) & 0x0000ff00UL) | (word >> 24);
+        memcpy(value, &word, sizeof(word));
+        value += sizeof(word);
+    }
+}
+
+static void swapWords64(Uint8 *value, const size_t count)
+{
+#ifndef OF_NO_UINT64
+    Uint64 word;
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(&word, value, sizeof(word));
+        word = ((word & OFstatic_cast(Uint64, 0x00ff00ff00ff00ffULL)) << 8) | ((word >> 8) & OFstatic_cast(Uint64, 0x00ff00ff00ff00ffULL));
+        word = ((word & OFstatic_cast(Uint64, 0x0000ffff0000ffffULL)) << 16) | ((word >> 16) & OFstatic_cast(Uint64, 0x0000ffff0000ffffULL));
+        word = (word << 32) | (word >> 32);
+        memcpy(value, &word, sizeof(word));
+        value += sizeof(word);
+    }
+#else
+    /* swap both halves and exchange them */
+    Uint32 low, high;
+    swapWords32(value, count * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(&low, value, sizeof(low));
+        memcpy(&high, value + sizeof(low), sizeof(high));
+        memcpy(value, &high, sizeof(high));
+        memcpy(value + sizeof(high), &low, sizeof(low));
+        value += 2 * sizeof(low);
+    }
+#endif
+}
+
+
 OFCondition swapIfNecessary(const E_ByteOrder newByteOrder,
                             const E_ByteOrder oldByteOrder,
                             void * value, const Uint32 byteLength,
@@ -79,27 +143,19 @@ void swapBytes(void * value, const Uint32 byteLength,
      *   valWidth     - [in] Specifies how many bytes shall be treated together as one element.
      */
 {
-    Uint8 save;
+    Uint8 *base = OFstatic_cast(Uint8 *, value);
 
-    /* in case valWidth equals 2, swap correspondingly */
+    /* the common value widths are handled by specialized functions */
     if (valWidth == 2)
-    {
-        Uint8 *first = &OFstatic_cast(Uint8*, value)[0];
-        Uint8 *second = &OFstatic_cast(Uint8*, value)[1];
-        Uint32 times = byteLength / 2;
-        while(times)
-        {
-            --times;
-            save = *first;
-            *first = *second;
-            *second = save;
-            first += 2;
-            second += 2;
-        }
-    }
+        swapWords16(base, byteLength / 2);
+    else if (valWidth == 4)
+        swapWords32(base, byteLength / 4);
+    else if (valWidth == 8)
+        swapWords64(base, byteLength / 8);
     /* if valWidth is greater than 2, swap correspondingly */
     else if (valWidth > 2)
     {
+        Uint8 save;
         size_t i;
         const size_t halfWidth = valWidth / 2;
         const size_t offset = valWidth - 1;
@@ -107,7 +163,6 @@ void swapBytes(void * value, const Uint32 byteLength,
         Uint8 *end;
 
         Uint32 times = OFstatic_cast(Uint32, byteLength / valWidth);
-        Uint8  *base = OFstatic_cast(Uint8 *, value);
 
         while (times)
         {
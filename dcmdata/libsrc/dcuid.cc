@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -1710,12 +1710,12 @@ forcePositive(long i)
     return (i < 0) ? OFstatic_cast(unsigned long, -i) : OFstatic_cast(unsigned long, i);
 }
 
-char* dcmGenerateUniqueIdentifier(char* uid, const char* prefix)
+/* determines the host identifier (if not yet done) and returns the next value
+ * of the process-wide UID counter. Thread-safe.
+ */
+static unsigned int
+nextCounterOfCurrentUID()
 {
-    char buf[128]; /* be very safe */
-
-    uid[0] = '\0'; /* initialize */
-
 #ifdef WITH_THREADS
     uidCounterMutex.lock();
 #endif
@@ -1732,6 +1732,16 @@ char* dcmGenerateUniqueIdentifier(char* uid, const char* prefix)
 #ifdef WITH_THREADS
     uidCounterMutex.unlock();
 #endif
+    return counter;
+}
+
+char* dcmGenerateUniqueIdentifier(char* uid, const char* prefix)
+{
+    char buf[128]; /* be very safe */
+
+    uid[0] = '\0'; /* initialize */
+
+    unsigned int counter = nextCounterOfCurrentUID();
 
     if (prefix != NULL ) {
         addUIDComponent(uid, prefix);
@@ -1754,3 +1764,97 @@ char* dcmGenerateUniqueIdentifier(char* uid, const char* prefix)
 
     return uid;
 }
+
+
+// ********************************
+
+DcmUIDGenerator::DcmUIDGenerator(const char *prefix)
+  : Prefix((prefix != NULL) ? prefix : SITE_INSTANCE_UID_ROOT)
+  , BaseLength(0)
+  , Counter(0)
+{
+    Base[0] = '\0';
+}
+
+
+void DcmUIDGenerator::initialize()
+{
+    char buf[128]; /* be very safe */
+
+    /* the value of the process-wide counter makes this generator unique
+     * within the current process, so the own counter can start again at 1
+     */
+    unsigned int generator = nextCounterOfCurrentUID();
+    char generatorBuf[16];
+    const size_t generatorLen = sprintf(generatorBuf, ".%u", generator);
+
+    Base[0] = '\0';
+    BaseLength = 0;
+    Counter = 0;
+    if (Prefix.length() + generatorLen + 2 /* ".1" */ > maxUIDLen)
+    {
+        DCMDATA_ERROR("DcmUIDGenerator: prefix too long for creating UIDs: " << Prefix);
+        return;
+    }
+    addUIDComponent(Base, Prefix.c_str());
+
+    /* host ID, process ID and creation time are only added as long as there
+     * is enough space left for the generator number and a reasonable counter
+     * (".99999"). Otherwise, the UIDs are still unique within this process.
+     */
+    const unsigned long components[3] = { hostIdentifier,
+        forcePositive(OFStandard::getProcessID()),
+        forcePositive(OFstatic_cast(long, time(NULL))) };
+    OFBool omitted = OFFalse;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const size_t len = sprintf(buf, ".%lu", components[i]);
+        if (strlen(Base) + len + generatorLen + 6 <= maxUIDLen)
+            addUIDComponent(Base, buf);
+        else
+            omitted = OFTrue;
+    }
+    if (omitted)
+        DCMDATA_WARN("DcmUIDGenerator: prefix too long, UIDs might not be globally unique: " << Prefix);
+    addUIDComponent(Base, generatorBuf);
+
+    BaseLength = strlen(Base);
+    Counter = 1;
+}
+
+
+char *DcmUIDGenerator::generate(char *uid)
+{
+    /* start a new "session" on first use and on counter overflow */
+    if (Counter == 0)
+        initialize();
+
+    char buf[16];
+    int len = sprintf(buf, ".%lu", OFstatic_cast(unsigned long, Counter));
+
+    /* the counter must never be truncated, since this would result in duplicate
+     * UIDs. Instead, a new session is started (with a new generator number).
+     */
+    if ((Counter > 1) && (BaseLength + len > maxUIDLen))
+    {
+        initialize();
+        len = sprintf(buf, ".%lu", OFstatic_cast(unsigned long, Counter));
+    }
+    if ((Counter == 0) || (BaseLength + len > maxUIDLen))
+    {
+        /* prefix too long, an error has already been reported */
+        uid[0] = '\0';
+        return uid;
+    }
+    ++Counter;
+    memcpy(uid, Base, BaseLength);
+    memcpy(uid + BaseLength, buf, len + 1);
+    return uid;
+}
+
+
+OFString DcmUIDGenerator::generate()
+{
+    char uid[maxUIDLen + 1];
+    return OFString(generate(uid));
+}
@@ -0,0 +1,482 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Implementation of class DcmUIDMap
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/dcmdata/dcuidmap.h"
+#include "dcmtk/dcmdata/dcitem.h"
+#include "dcmtk/dcmdata/dcstack.h"
+#include "dcmtk/dcmdata/dcvrui.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/ofstd/ofstd.h"
+
+
+/* minimum size of the memory blocks storing the mappings */
+#define UIDMAP_BLOCK_SIZE 65536
+
+/* initial number of slots in the hash table (must be a power of 2) */
+#define UIDMAP_INITIAL_SLOTS 1024
+
+/* root of all UIDs defined by the DICOM standard */
+#define DICOM_STANDARD_UID_ROOT "1.2.840.10008."
+
+/* attributes with UID values that identify a class rather than an instance */
+static const DcmTagKey classUIDTags[] =
+{
+    DCM_AffectedSOPClassUID,
+    DCM_RequestedSOPClassUID,
+    DCM_MediaStorageSOPClassUID,
+    DCM_TransferSyntaxUID,
+    DCM_ImplementationClassUID,
+    DCM_PrivateInformationCreatorUID,
+    DCM_ReferencedSOPClassUIDInFile,
+    DCM_ReferencedTransferSyntaxUIDInFile,
+    DCM_SOPClassUID,
+    DCM_RelatedGeneralSOPClassUID,
+    DCM_OriginalSpecializedSOPClassUID,
+    DCM_CodingSchemeUID,
+    DCM_ReferencedSOPClassUID,
+    DCM_ContextUID,
+    DCM_MappingResourceUID,
+    DCM_ContextGroupExtensionCreatorUID
+};
+
+static const size_t numberOfClassUIDTags = sizeof(classUIDTags) / sizeof(classUIDTags[0]);
+
+
+#ifdef WITH_THREADS
+/* helper class that locks a mutex for the lifetime of the object */
+class DcmUIDMapLock
+{
+public:
+    DcmUIDMapLock(OFMutex &mutex) : Mutex(mutex) { Mutex.lock(); }
+    ~DcmUIDMapLock() { Mutex.unlock(); }
+private:
+    OFMutex &Mutex;
+    DcmUIDMapLock(const DcmUIDMapLock &);
+    DcmUIDMapLock &operator=(const DcmUIDMapLock &);
+};
+
+#define DCMUIDMAP_LOCK DcmUIDMapLock lock(Mutex)
+#else
+#define DCMUIDMAP_LOCK
+#endif
+
+
+/* FNV-1a hash function */
+static size_t hashUID(const char *uid)
+{
+    Uint32 hash = 2166136261U;
+    while (*uid != '\0')
+    {
+        hash ^= OFstatic_cast(unsigned char, *uid++);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/* comparison function for qsort() on the mappings (sorted by old UID) */
+extern "C" {
+static int DcmUIDMap_compareEntries(const void *a, const void *b)
+{
+    return strcmp(*OFstatic_cast(const char * const *, a), *OFstatic_cast(const char * const *, b));
+}
+}
+
+
+// ********************************
+
+DcmUIDMap::DcmUIDMap(const char *prefix)
+  : Generator(prefix)
+  , Blocks()
+  , BlockSize(0)
+  , BlockUsed(0)
+  , Slots(NULL)
+  , NumSlots(0)
+  , NumEntries(0)
+  , Modified(OFFalse)
+#ifdef WITH_THREADS
+  , Mutex()
+#endif
+{
+}
+
+
+DcmUIDMap::~DcmUIDMap()
+{
+    freeTable();
+}
+
+
+OFCondition DcmUIDMap::loadFile(const OFFilename &filename)
+{
+    OFFile file;
+    if (!file.fopen(filename, "r"))
+    {
+        OFString s("(unknown error code)");
+        file.getLastErrorString(s);
+        return makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
+    }
+    OFCondition result = EC_Normal;
+    char line[256];
+    char oldUID[128];
+    char newUID[128];
+    unsigned long lineNumber = 0;
+    DCMUIDMAP_LOCK;
+    while (result.good() && (file.fgets(line, sizeof(line)) != NULL))
+    {
+        ++lineNumber;
+        /* ignore empty lines and comments */
+        if ((line[0] == '#') || (sscanf(line, "%127s", oldUID) != 1))
+            continue;
+        if ((sscanf(line, "%127s %127s", oldUID, newUID) != 2) ||
+            DcmUniqueIdentifier::checkStringValue(oldUID, "1").bad() ||
+            DcmUniqueIdentifier::checkStringValue(newUID, "1").bad())
+        {
+            DCMDATA_ERROR("DcmUIDMap: invalid entry in line " << lineNumber << " of file: " << OFSTRING_GUARD(filename.getCharPointer()));
+            result = EC_InvalidValue;
+        } else
+            store(oldUID, newUID);
+    }
+    file.fclose();
+    /* a table that matches its file is not modified */
+    if (result.good())
+        Modified = OFFalse;
+    return result;
+}
+
+
+OFCondition DcmUIDMap::saveFile(const OFFilename &filename)
+{
+    /* write to a temporary file in the same directory first, so that the
+     * existing file is not destroyed if writing fails (e.g. disk full)
+     */
+    OFFilename tempFilename;
+    OFStandard::appendFilenameExtension(tempFilename, filename, ".tmp");
+    OFFile file;
+    if (!file.fopen(tempFilename, "w"))
+    {
+        OFString s("(unknown error code)");
+        file.getLastErrorString(s);
+        return makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
+    }
+    DCMUIDMAP_LOCK;
+    /* collect and sort the mappings, the hash table has no defined order */
+    OFVector<const char *> entries;
+    entries.reserve(NumEntries);
+    for (size_t i = 0; i < NumSlots; ++i)
+    {
+        if (Slots[i] != NULL)
+            entries.push_back(Slots[i]);
+    }
+    if (!entries.empty())
+        qsort(&entries[0], entries.size(), sizeof(const char *), DcmUIDMap_compareEntries);
+    OFBool ok = OFTrue;
+    for (size_t i = 0; ok && (i < entries.size()); ++i)
+    {
+        const char *oldUID = entries[i];
+        ok = (file.fputs(oldUID) >= 0) && (file.fputc(' ') != EOF) &&
+             (file.fputs(oldUID + strlen(oldUID) + 1) >= 0) && (file.fputc('\n') != EOF);
+    }
+    if (file.fclose() != 0)
+        ok = OFFalse;
+    if (!ok)
+    {
+        OFString s("(unknown error code)");
+        file.getLastErrorString(s);
+        OFStandard::deleteFile(tempFilename);
+        return makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
+    }
+    /* on some systems, an existing file is not replaced when renaming. In this
+     * case, the existing file is moved aside and only removed after the new
+     * file is in place. This fallback is not atomic, but at any time, either
+     * the existing, the backup or the temporary file contains all mappings.
+     */
+    if (!OFStandard::renameFile(tempFilename, filename))
+    {
+        OFString s = OFStandard::getLastSystemErrorCode().message();
+        OFBool renamed = OFFalse;
+        if (OFStandard::fileExists(filename))
+        {
+            OFFilename backupFilename;
+            OFStandard::appendFilenameExtension(backupFilename, filename, ".bak");
+            OFStandard::deleteFile(backupFilename);
+            if (OFStandard::renameFile(filename, backupFilename))
+            {
+                renamed = OFStandard::renameFile(tempFilename, filename);
+                s = OFStandard::getLastSystemErrorCode().message();
+                if (renamed)
+                    OFStandard::deleteFile(backupFilename);
+                else
+                    OFStandard::renameFile(backupFilename, filename);
+            } else
+                s = OFStandard::getLastSystemErrorCode().message();
+        }
+        if (!renamed)
+        {
+            /* keep the temporary file, it might be the only complete copy */
+            DCMDATA_ERROR("DcmUIDMap: cannot rename temporary file, mappings have been kept in: "
+                << OFSTRING_GUARD(tempFilename.getCharPointer()));
+            s += " (mappings kept in ";
+            s += OFSTRING_GUARD(tempFilename.getCharPointer());
+            s += ")";
+            return makeOFCondition(OFM_dcmdata, 18, OF_error, s.c_str());
+        }
+    }
+    Modified = OFFalse;
+    return EC_Normal;
+}
+
+
+OFCondition DcmUIDMap::mapUID(const OFString &oldUID,
+                              OFString &newUID)
+{
+    DCMUIDMAP_LOCK;
+    const char *uid = lookupOrCreate(oldUID);
+    if (uid == NULL)
+        return EC_InvalidValue;
+    newUID = uid;
+    return EC_Normal;
+}
+
+
+OFBool DcmUIDMap::findUID(const OFString &oldUID,
+                          OFString &newUID)
+{
+    DCMUIDMAP_LOCK;
+    const char *uid = lookup(oldUID.c_str());
+    if (uid == NULL)
+        return OFFalse;
+    newUID = uid;
+    return OFTrue;
+}
+
+
+OFCondition DcmUIDMap::addMapping(const OFString &oldUID,
+                                  const OFString &newUID)
+{
+    if (DcmUniqueIdentifier::checkStringValue(oldUID, "1").bad() ||
+        DcmUniqueIdentifier::checkStringValue(newUID, "1").bad())
+    {
+        return EC_InvalidValue;
+    }
+    DCMUIDMAP_LOCK;
+    store(oldUID, newUID);
+    Modified = OFTrue;
+    return EC_Normal;
+}
+
+
+OFCondition DcmUIDMap::remapUIDs(DcmItem &item,
+                                 size_t *count)
+{
+    OFCondition result = EC_Normal;
+    size_t modified = 0;
+    DcmStack stack;
+    OFString value;
+    OFString component;
+    OFString newValue;
+    DCMUIDMAP_LOCK;
+    /* iterate over all elements, including those in nested sequences */
+    while (result.good() && item.nextObject(stack, OFTrue).good())
+    {
+        DcmObject *object = stack.top();
+        if ((object->ident() != EVR_UI) || !object->isLeaf())
+            continue;
+        DcmElement *elem = OFstatic_cast(DcmElement *, object);
+        if (elem->getOFStringArray(value).bad() || value.empty())
+            continue;
+        /* process each value of a multi-valued element separately */
+        OFBool changed = OFFalse;
+        newValue.clear();
+        size_t pos = 0;
+        while (pos <= value.length())
+        {
+            size_t end = value.find('\\', pos);
+            if (end == OFString_npos)
+                end = value.length();
+            component = value.substr(pos, end - pos);
+            if (pos > 0)
+                newValue += '\\';
+            if (isMappable(elem->getTag(), component))
+            {
+                const char *uid = lookupOrCreate(component);
+                if (uid == NULL)
+                {
+                    result = EC_InvalidValue;
+                    break;
+                }
+                newValue += uid;
+                changed = OFTrue;
+            } else
+                newValue += component;
+            pos = end + 1;
+        }
+        if (changed && result.good())
+        {
+            result = elem->putOFStringArray(newValue);
+            ++modified;
+        }
+    }
+    if (count != NULL)
+        *count = modified;
+    return result;
+}
+
+
+size_t DcmUIDMap::size()
+{
+    DCMUIDMAP_LOCK;
+    return NumEntries;
+}
+
+
+OFBool DcmUIDMap::isModified()
+{
+    DCMUIDMAP_LOCK;
+    return Modified;
+}
+
+
+void DcmUIDMap::clear()
+{
+    DCMUIDMAP_LOCK;
+    Modified = (NumEntries > 0);
+    freeTable();
+}
+
+
+OFBool DcmUIDMap::isMappable(const DcmTagKey &tag,
+                             const OFString &uid)
+{
+    if (uid.empty() || (uid.compare(0, sizeof(DICOM_STANDARD_UID_ROOT) - 1, DICOM_STANDARD_UID_ROOT) == 0))
+        return OFFalse;
+    for (size_t i = 0; i < numberOfClassUIDTags; ++i)
+    {
+        if (tag == classUIDTags[i])
+            return OFFalse;
+    }
+    return OFTrue;
+}
+
+
+const char *DcmUIDMap::lookupOrCreate(const OFString &oldUID)
+{
+    const char *newUID = lookup(oldUID.c_str());
+    if (newUID == NULL)
+    {
+        char uid[65];
+        /* never store an empty UID, it would be used for all later lookups */
+        if (Generator.generate(uid)[0] == '\0')
+        {
+            DCMDATA_ERROR("DcmUIDMap: cannot create new UID for " << oldUID);
+            return NULL;
+        }
+        newUID = store(oldUID, uid);
+        Modified = OFTrue;
+    }
+    return newUID;
+}
+
+
+const char *DcmUIDMap::lookup(const char *oldUID) const
+{
+    if (NumEntries == 0)
+        return NULL;
+    const char *entry = Slots[findSlot(oldUID)];
+    return (entry != NULL) ? entry + strlen(entry) + 1 : NULL;
+}
+
+
+const char *DcmUIDMap::store(const OFString &oldUID,
+                             const OFString &newUID)
+{
+    /* keep the load factor of the hash table at 1/2 or less */
+    if (2 * (NumEntries + 1) > NumSlots)
+        growSlots();
+    /* copy both UIDs to the last memory block, start a new one if needed */
+    const size_t oldLength = strlen(oldUID.c_str());
+    const size_t newLength = strlen(newUID.c_str());
+    const size_t length = oldLength + newLength + 2;
+    if (Blocks.empty() || (BlockUsed + length > BlockSize))
+    {
+        BlockSize = (length > UIDMAP_BLOCK_SIZE) ? length : UIDMAP_BLOCK_SIZE;
+        BlockUsed = 0;
+        Blocks.push_back(new char[BlockSize]);
+    }
+    char *entry = Blocks.back() + BlockUsed;
+    BlockUsed += length;
+    memcpy(entry, oldUID.c_str(), oldLength + 1);
+    memcpy(entry + oldLength + 1, newUID.c_str(), newLength + 1);
+    /* an existing mapping is replaced, its memory is not re-used */
+    const size_t slot = findSlot(entry);
+    if (Slots[slot] == NULL)
+        ++NumEntries;
+    Slots[slot] = entry;
+    return entry + oldLength + 1;
+}
+
+
+size_t DcmUIDMap::findSlot(const char *oldUID) const
+{
+    /* linear probing */
+    size_t slot = hashUID(oldUID) & (NumSlots - 1);
+    while ((Slots[slot] != NULL) && (strcmp(Slots[slot], oldUID) != 0))
+        slot = (slot + 1) & (NumSlots - 1);
+    return slot;
+}
+
+
+void DcmUIDMap::growSlots()
+{
+    const char **oldSlots = Slots;
+    const size_t oldNumSlots = NumSlots;
+    NumSlots = (oldNumSlots > 0) ? 2 * oldNumSlots : UIDMAP_INITIAL_SLOTS;
+    Slots = new const char *[NumSlots];
+    for (size_t i = 0; i < NumSlots; ++i)
+        Slots[i] = NULL;
+    for (size_t i = 0; i < oldNumSlots; ++i)
+    {
+        if (oldSlots[i] != NULL)
+            Slots[findSlot(oldSlots[i])] = oldSlots[i];
+    }
+    delete[] oldSlots;
+}
+
+
+void DcmUIDMap::freeTable()
+{
+    for (size_t i = 0; i < Blocks.size(); ++i)
+        delete[] Blocks[i];
+    Blocks.clear();
+    BlockSize = 0;
+    BlockUsed = 0;
+    delete[] Slots;
+    Slots = NULL;
+    NumSlots = 0;
+    NumEntries = 0;
+}
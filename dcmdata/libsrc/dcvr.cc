@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2019, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -234,14 +234,18 @@ DcmVR::setVR(const char* vrName)
     vr = EVR_UNKNOWN;   /* default */
     if (vrName != NULL)
     {
+        char c1 = *vrName;
+        char c2 = (c1) ? (*(vrName + 1)) : ('\0');
         int found = OFFalse;
         int i = 0;
         for (i = 0; (!found && (i < DcmVRDict_DIM)); i++)
         {
             /* We only compare the first two characters of the passed string and
              * never accept a VR that is labeled for internal use only.
+             * This function is called for each element read in explicit VR,
+             * so the characters are compared directly instead of using strncmp().
              */
-            if ((strncmp(vrName, DcmVRDict[i].vrName, 2) == 0) &&
+            if ((DcmVRDict[i].vrName[0] == c1) && (DcmVRDict[i].vrName[1] == c2) &&
                 !(DcmVRDict[i].propertyFlags & DCMVR_PROP_INTERNAL))
             {
                 found = OFTrue;
@@ -257,8 +261,6 @@ DcmVR::setVR(const char* vrName)
          * letters as "real" future VRs (and thus assume extended length).
          * All other VR strings are treated as "illegal" VRs.
          */
-        char c1 = *vrName;
-        char c2 = (c1) ? (*(vrName + 1)) : ('\0');
         if ((c1 == '?') && (c2 == '?')) vr = EVR_UNKNOWN2B;
         if (!found && ((c1 < 'A') || (c1 > 'Z') || (c2 < 'A') || (c2 > 'Z'))) vr = EVR_UNKNOWN2B;
     }
@@ -164,6 +164,7 @@ OFCondition DcmOtherDouble::writeJson(STD_NAMESPACE ostream &out,
 {
     /* always write JSON Opener */
     writeJsonOpener(out, format);
+    OFCondition status = EC_Normal;
     /* for an empty value field, we do not need to do anything */
     if (getLengthField() > 0)
     {
@@ -179,13 +180,12 @@ OFCondition DcmOtherDouble::writeJson(STD_NAMESPACE ostream &out,
             /* encode binary data as Base64 */
             format.printInlineBinaryPrefix(out);
             out << "\"";
-            Uint8 *byteValues = OFstatic_cast(Uint8 *, getValue());
-            OFStandard::encodeBase64(out, byteValues, OFstatic_cast(size_t, getLengthField()));
+            status = writeBase64Value(out, gLocalByteOrder);
             out << "\"";
         }
     }
     /* write JSON Closer  */
     writeJsonCloser(out, format);
-    /* always report success */
-    return EC_Normal;
+    /* report the result of the Base64 encoding */
+    return status;
 }
@@ -166,6 +166,7 @@ OFCondition DcmOtherLong::writeJson(STD_NAMESPACE ostream &out,
 {
     /* write JSON Opener */
     writeJsonOpener(out, format);
+    OFCondition status = EC_Normal;
     /* for an empty value field, we do not need to do anything */
     if (getLengthField() > 0)
     {
@@ -181,13 +182,12 @@ OFCondition DcmOtherLong::writeJson(STD_NAMESPACE ostream &out,
             /* encode binary data as Base64 */
             format.printInlineBinaryPrefix(out);
             out << "\"";
-            Uint8 *byteValues = OFstatic_cast(Uint8 *, getValue());
-            OFStandard::encodeBase64(out, byteValues, OFstatic_cast(size_t, getLengthField()));
+            status = writeBase64Value(out, gLocalByteOrder);
             out << "\"";
         }
     }
     /* write JSON Closer */
     writeJsonCloser(out, format);
-    /* always report success */
-    return EC_Normal;
+    /* report the result of the Base64 encoding */
+    return status;
 }
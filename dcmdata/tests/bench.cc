@@ -0,0 +1,842 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Benchmark for parsing, writing and converting DICOM datasets
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTDIO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/cmdlnarg.h"
+#include "dcmtk/dcmdata/dcuid.h"      /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcjson.h"     /* for DcmJsonFormatCompact */
+#include "dcmtk/dcmdata/dcistrmb.h"   /* for class DcmInputBufferStream */
+#include "dcmtk/dcmdata/dcostrmb.h"   /* for class DcmOutputBufferStream */
+#include "dcmtk/dcmdata/dcrleerg.h"   /* for DcmRLEEncoderRegistration */
+#include "dcmtk/dcmdata/dcrledrg.h"   /* for DcmRLEDecoderRegistration */
+#include "dcmtk/ofstd/ofconapp.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/oftempf.h"
+#include "dcmtk/ofstd/ofvector.h"
+
+#define OFFIS_CONSOLE_APPLICATION "dcmdata_bench"
+
+static OFLogger benchLogger = OFLog::getLogger("dcmtk.test." OFFIS_CONSOLE_APPLICATION);
+
+static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v"
+  OFFIS_DCMTK_VERSION " " OFFIS_DCMTK_RELEASEDATE " $";
+
+// ********************************************
+
+#define SHORTCOL 3
+#define LONGCOL 19
+
+/// operations measured for each dataset
+enum E_BenchOperation
+{
+  /// write dataset to memory, explicit VR little endian
+  EBO_Write,
+  /// write dataset to memory, explicit VR big endian (i.e. with byte swapping)
+  EBO_WriteBigEndian,
+  /// read dataset from memory, explicit VR little endian
+  EBO_Read,
+  /// save file format to a file
+  EBO_Save,
+  /// load file format from a file
+  EBO_Load,
+  /// write dataset in JSON format
+  EBO_Json,
+  /// write dataset in XML format
+  EBO_Xml,
+  /// convert pixel data to RLE Lossless
+  EBO_RLEEncode,
+  /// convert pixel data from RLE Lossless
+  EBO_RLEDecode
+};
+
+/// number of operations, see E_BenchOperation
+static const size_t numBenchOperations = 9;
+
+/// names of the operations, used for the output
+static const char *benchOperationNames[numBenchOperations] =
+{
+  "write", "write-be", "read", "save", "load", "json", "xml", "rle-encode", "rle-decode"
+};
+
+/** stream buffer that discards all output and only counts the number of characters,
+ *  used to measure the JSON and XML output without the cost of storing the text
+ */
+class BenchCountingStreamBuf : public STD_NAMESPACE streambuf
+{
+public:
+  BenchCountingStreamBuf() : count_(0) { }
+
+  /// returns the number of characters written so far
+  size_t count() const { return count_; }
+
+protected:
+  virtual int_type overflow(int_type c)
+  {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      return traits_type::not_eof(c);
+    ++count_;
+    return c;
+  }
+
+  virtual STD_NAMESPACE streamsize xsputn(const char * /* s */, STD_NAMESPACE streamsize n)
+  {
+    count_ += OFstatic_cast(size_t, n);
+    return n;
+  }
+
+private:
+  /// number of characters written
+  size_t count_;
+};
+
+/// state shared by the operations on a single dataset
+struct BenchContext
+{
+  /// the generated file format
+  DcmFileFormat fileformat;
+  /// buffer containing the dataset encoded in explicit VR little endian
+  OFVector<Uint8> encoded;
+  /// number of bytes of the encoded dataset
+  size_t encodedLength;
+  /// buffer used by the write operations
+  OFVector<Uint8> writeBuffer;
+  /// name of the temporary file used by the save and load operations
+  OFString filename;
+  /// size of the file written by the save operation
+  size_t fileSize;
+  /// number of bytes of uncompressed pixel data, 0 if there is none
+  size_t pixelDataLength;
+  /// load all element values into memory (operation "load")
+  OFBool loadAll;
+};
+
+// ********************************************
+
+static void addCode(DcmItem& parent, const DcmTagKey& sequence, const char *value,
+                    const char *scheme, const char *meaning)
+{
+  DcmItem *item = NULL;
+  if (parent.findOrCreateSequenceItem(sequence, item, -2 /* append */).good())
+  {
+    item->putAndInsertString(DCM_CodeValue, value);
+    item->putAndInsertString(DCM_CodingSchemeDesignator, scheme);
+    item->putAndInsertString(DCM_CodeMeaning, meaning);
+  }
+}
+
+static void addCommonModules(DcmDataset& dset, const char *sopClass, const char *modality)
+{
+  char uid[100];
+  dset.putAndInsertString(DCM_SpecificCharacterSet, "ISO_IR 100");
+  dset.putAndInsertString(DCM_SOPClassUID, sopClass);
+  dset.putAndInsertString(DCM_SOPInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+  dset.putAndInsertString(DCM_StudyDate, "20260101");
+  dset.putAndInsertString(DCM_SeriesDate, "20260101");
+  dset.putAndInsertString(DCM_ContentDate, "20260101");
+  dset.putAndInsertString(DCM_StudyTime, "120000");
+  dset.putAndInsertString(DCM_SeriesTime, "120500");
+  dset.putAndInsertString(DCM_ContentTime, "120512.345");
+  dset.putAndInsertString(DCM_AccessionNumber, "A123456789");
+  dset.putAndInsertString(DCM_Modality, modality);
+  dset.putAndInsertString(DCM_Manufacturer, "OFFIS");
+  dset.putAndInsertString(DCM_InstitutionName, "Benchmark Hospital");
+  dset.putAndInsertString(DCM_ReferringPhysicianName, "Doe^John");
+  dset.putAndInsertString(DCM_StationName, "BENCH01");
+  dset.putAndInsertString(DCM_StudyDescription, "Synthetic study for benchmarking");
+  dset.putAndInsertString(DCM_SeriesDescription, "Synthetic series");
+  dset.putAndInsertString(DCM_ManufacturerModelName, "dcmdata_bench");
+  dset.putAndInsertString(DCM_PatientName, "Bench^Patient^^^");
+  dset.putAndInsertString(DCM_PatientID, "PID0000001");
+  dset.putAndInsertString(DCM_PatientBirthDate, "19700101");
+  dset.putAndInsertString(DCM_PatientSex, "O");
+  dset.putAndInsertString(DCM_PatientAge, "056Y");
+  dset.putAndInsertString(DCM_StudyInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_STUDY_UID_ROOT));
+  dset.putAndInsertString(DCM_SeriesInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_SERIES_UID_ROOT));
+  dset.putAndInsertString(DCM_StudyID, "1");
+  dset.putAndInsertString(DCM_SeriesNumber, "1");
+  dset.putAndInsertString(DCM_InstanceNumber, "1");
+}
+
+static void addImagePixelModule(DcmDataset& dset, const Uint16 rows, const Uint16 columns, const size_t frames)
+{
+  dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+  dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+  dset.putAndInsertUint16(DCM_Rows, rows);
+  dset.putAndInsertUint16(DCM_Columns, columns);
+  dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+  dset.putAndInsertUint16(DCM_BitsStored, 12);
+  dset.putAndInsertUint16(DCM_HighBit, 11);
+  dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+  // smooth pattern with some noise, so that RLE compression is realistic
+  const size_t count = OFstatic_cast(size_t, rows) * columns * frames;
+  Uint16 *pixels = new Uint16[count];
+  Uint32 noise = 12345;
+  size_t i = 0;
+  for (size_t f = 0; f < frames; ++f)
+  {
+    for (Uint16 y = 0; y < rows; ++y)
+    {
+      for (Uint16 x = 0; x < columns; ++x)
+      {
+        noise = noise * 1103515245 + 12345;
+        pixels[i++] = OFstatic_cast(Uint16, ((x + y + f * 8) & 0x3ff) + ((noise >> 16) & 0x0f));
+      }
+    }
+  }
+  dset.putAndInsertUint16Array(DCM_PixelData, pixels, OFstatic_cast(unsigned long, count));
+  delete[] pixels;
+}
+
+/** creates a single CT image with typical attributes
+ */
+static void createCTSlice(DcmFileFormat& fileformat)
+{
+  char uid[100];
+  DcmDataset& dset = *fileformat.getDataset();
+  addCommonModules(dset, UID_CTImageStorage, "CT");
+  dset.putAndInsertString(DCM_ImageType, "ORIGINAL\\PRIMARY\\AXIAL");
+  dset.putAndInsertString(DCM_ScanOptions, "HELICAL MODE");
+  dset.putAndInsertString(DCM_SliceThickness, "1.25");
+  dset.putAndInsertString(DCM_KVP, "120");
+  dset.putAndInsertString(DCM_DataCollectionDiameter, "500");
+  dset.putAndInsertString(DCM_ReconstructionDiameter, "350");
+  dset.putAndInsertString(DCM_GantryDetectorTilt, "0");
+  dset.putAndInsertString(DCM_TableHeight, "150");
+  dset.putAndInsertString(DCM_RotationDirection, "CW");
+  dset.putAndInsertString(DCM_ExposureTime, "1000");
+  dset.putAndInsertString(DCM_XRayTubeCurrent, "300");
+  dset.putAndInsertString(DCM_Exposure, "300");
+  dset.putAndInsertString(DCM_FilterType, "BODY FILTER");
+  dset.putAndInsertString(DCM_ConvolutionKernel, "STANDARD");
+  dset.putAndInsertString(DCM_PatientPosition, "HFS");
+  dset.putAndInsertString(DCM_AcquisitionNumber, "1");
+  dset.putAndInsertString(DCM_ImagePositionPatient, "-175\\-175\\100");
+  dset.putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+  dset.putAndInsertString(DCM_FrameOfReferenceUID, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+  dset.putAndInsertString(DCM_PositionReferenceIndicator, "");
+  dset.putAndInsertString(DCM_SliceLocation, "100");
+  dset.putAndInsertString(DCM_PixelSpacing, "0.683594\\0.683594");
+  dset.putAndInsertString(DCM_WindowCenter, "40");
+  dset.putAndInsertString(DCM_WindowWidth, "400");
+  dset.putAndInsertString(DCM_RescaleIntercept, "-1024");
+  dset.putAndInsertString(DCM_RescaleSlope, "1");
+  dset.putAndInsertString(DCM_RescaleType, "HU");
+  addImagePixelModule(dset, 512, 512, 1);
+}
+
+/** creates an enhanced CT image with per-frame functional groups
+ */
+static void createEnhancedMultiFrame(DcmFileFormat& fileformat, const size_t frames)
+{
+  char uid[100];
+  char buf[64];
+  DcmDataset& dset = *fileformat.getDataset();
+  addCommonModules(dset, UID_EnhancedCTImageStorage, "CT");
+  dset.putAndInsertString(DCM_ImageType, "ORIGINAL\\PRIMARY\\VOLUME\\NONE");
+  dset.putAndInsertString(DCM_FrameOfReferenceUID, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+  dset.putAndInsertString(DCM_PositionReferenceIndicator, "");
+  sprintf(buf, "%lu", OFstatic_cast(unsigned long, frames));
+  dset.putAndInsertString(DCM_NumberOfFrames, buf);
+  dset.putAndInsertString(DCM_ContentQualification, "PRODUCT");
+  dset.putAndInsertString(DCM_BurnedInAnnotation, "NO");
+  // multi-frame dimension module
+  const OFString dimensionUID = dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT);
+  DcmItem *item = NULL;
+  if (dset.findOrCreateSequenceItem(DCM_DimensionOrganizationSequence, item, -2).good())
+    item->putAndInsertString(DCM_DimensionOrganizationUID, dimensionUID.c_str());
+  const DcmTagKey dimensionTags[2] = { DCM_StackID, DCM_InStackPositionNumber };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (dset.findOrCreateSequenceItem(DCM_DimensionIndexSequence, item, -2).good())
+    {
+      item->putAndInsertString(DCM_DimensionOrganizationUID, dimensionUID.c_str());
+      item->putAndInsertTagKey(DCM_DimensionIndexPointer, dimensionTags[i]);
+      item->putAndInsertTagKey(DCM_FunctionalGroupPointer, DCM_FrameContentSequence);
+    }
+  }
+  // shared functional groups
+  DcmItem *shared = NULL;
+  if (dset.findOrCreateSequenceItem(DCM_SharedFunctionalGroupsSequence, shared, 0).good())
+  {
+    if (shared->findOrCreateSequenceItem(DCM_PixelMeasuresSequence, item, 0).good())
+    {
+      item->putAndInsertString(DCM_PixelSpacing, "0.683594\\0.683594");
+      item->putAndInsertString(DCM_SliceThickness, "1.25");
+    }
+    if (shared->findOrCreateSequenceItem(DCM_PlaneOrientationSequence, item, 0).good())
+      item->putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+    if (shared->findOrCreateSequenceItem(DCM_PixelValueTransformationSequence, item, 0).good())
+    {
+      item->putAndInsertString(DCM_RescaleIntercept, "-1024");
+      item->putAndInsertString(DCM_RescaleSlope, "1");
+      item->putAndInsertString(DCM_RescaleType, "HU");
+    }
+    if (shared->findOrCreateSequenceItem(DCM_FrameVOILUTSequence, item, 0).good())
+    {
+      item->putAndInsertString(DCM_WindowCenter, "40");
+      item->putAndInsertString(DCM_WindowWidth, "400");
+    }
+  }
+  // per-frame functional groups
+  for (size_t f = 0; f < frames; ++f)
+  {
+    DcmItem *perFrame = NULL;
+    if (dset.findOrCreateSequenceItem(DCM_PerFrameFunctionalGroupsSequence, perFrame, -2).good())
+    {
+      if (perFrame->findOrCreateSequenceItem(DCM_FrameContentSequence, item, 0).good())
+      {
+        const Uint32 indexValues[2] = { 1, OFstatic_cast(Uint32, f + 1) };
+        item->putAndInsertUint32Array(DCM_DimensionIndexValues, indexValues, 2);
+        item->putAndInsertUint16(DCM_FrameAcquisitionNumber, 1);
+        item->putAndInsertString(DCM_StackID, "1");
+        item->putAndInsertUint32(DCM_InStackPositionNumber, OFstatic_cast(Uint32, f + 1));
+        item->putAndInsertString(DCM_FrameAcquisitionDateTime, "20260101120000.000000");
+      }
+      if (perFrame->findOrCreateSequenceItem(DCM_PlanePositionSequence, item, 0).good())
+      {
+        sprintf(buf, "-175\\-175\\%lu.25", OFstatic_cast(unsigned long, f));
+        item->putAndInsertString(DCM_ImagePositionPatient, buf);
+      }
+    }
+  }
+  addImagePixelModule(dset, 256, 256, frames);
+}
+
+/** creates a DICOMDIR with the given number of image records, organized
+ *  as 100 images per patient, one study per patient and two series per study
+ */
+static void createDicomdir(DcmFileFormat& fileformat, const size_t images)
+{
+  char uid[100];
+  char buf[64];
+  DcmMetaInfo& meta = *fileformat.getMetaInfo();
+  meta.putAndInsertString(DCM_MediaStorageSOPClassUID, UID_MediaStorageDirectoryStorage);
+  meta.putAndInsertString(DCM_MediaStorageSOPInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+  DcmDataset& dset = *fileformat.getDataset();
+  dset.putAndInsertString(DCM_FileSetID, "BENCH");
+  dset.putAndInsertUint32(DCM_OffsetOfTheFirstDirectoryRecordOfTheRootDirectoryEntity, 0);
+  dset.putAndInsertUint32(DCM_OffsetOfTheLastDirectoryRecordOfTheRootDirectoryEntity, 0);
+  dset.putAndInsertUint16(DCM_FileSetConsistencyFlag, 0);
+  DcmItem *item = NULL;
+  OFString studyUID, seriesUID;
+  for (size_t i = 0; i < images; ++i)
+  {
+    const size_t patient = i / 100;
+    const size_t series = (i / 50) % 2;
+    if (i % 100 == 0)
+    {
+      if (dset.findOrCreateSequenceItem(DCM_DirectoryRecordSequence, item, -2).good())
+      {
+        item->putAndInsertUint32(DCM_OffsetOfTheNextDirectoryRecord, 0);
+        item->putAndInsertUint16(DCM_RecordInUseFlag, 0xffff);
+        item->putAndInsertUint32(DCM_OffsetOfReferencedLowerLevelDirectoryEntity, 0);
+        item->putAndInsertString(DCM_DirectoryRecordType, "PATIENT");
+        item->putAndInsertString(DCM_SpecificCharacterSet, "ISO_IR 100");
+        sprintf(buf, "Patient^%05lu", OFstatic_cast(unsigned long, patient));
+        item->putAndInsertString(DCM_PatientName, buf);
+        sprintf(buf, "PID%07lu", OFstatic_cast(unsigned long, patient));
+        item->putAndInsertString(DCM_PatientID, buf);
+        item->putAndInsertString(DCM_PatientBirthDate, "19700101");
+        item->putAndInsertString(DCM_PatientSex, "O");
+      }
+      if (dset.findOrCreateSequenceItem(DCM_DirectoryRecordSequence, item, -2).good())
+      {
+        studyUID = dcmGenerateUniqueIdentifier(uid, SITE_STUDY_UID_ROOT);
+        item->putAndInsertUint32(DCM_OffsetOfTheNextDirectoryRecord, 0);
+        item->putAndInsertUint16(DCM_RecordInUseFlag, 0xffff);
+        item->putAndInsertUint32(DCM_OffsetOfReferencedLowerLevelDirectoryEntity, 0);
+        item->putAndInsertString(DCM_DirectoryRecordType, "STUDY");
+        item->putAndInsertString(DCM_SpecificCharacterSet, "ISO_IR 100");
+        item->putAndInsertString(DCM_StudyDate, "20260101");
+        item->putAndInsertString(DCM_StudyTime, "120000");
+        item->putAndInsertString(DCM_StudyDescription, "Synthetic study");
+        item->putAndInsertString(DCM_StudyInstanceUID, studyUID.c_str());
+        item->putAndInsertString(DCM_StudyID, "1");
+        item->putAndInsertString(DCM_AccessionNumber, "A123456789");
+      }
+    }
+    if (i % 50 == 0)
+    {
+      if (dset.findOrCreateSequenceItem(DCM_DirectoryRecordSequence, item, -2).good())
+      {
+        seriesUID = dcmGenerateUniqueIdentifier(uid, SITE_SERIES_UID_ROOT);
+        item->putAndInsertUint32(DCM_OffsetOfTheNextDirectoryRecord, 0);
+        item->putAndInsertUint16(DCM_RecordInUseFlag, 0xffff);
+        item->putAndInsertUint32(DCM_OffsetOfReferencedLowerLevelDirectoryEntity, 0);
+        item->putAndInsertString(DCM_DirectoryRecordType, "SERIES");
+        item->putAndInsertString(DCM_SpecificCharacterSet, "ISO_IR 100");
+        item->putAndInsertString(DCM_Modality, "CT");
+        item->putAndInsertString(DCM_SeriesInstanceUID, seriesUID.c_str());
+        sprintf(buf, "%lu", OFstatic_cast(unsigned long, series + 1));
+        item->putAndInsertString(DCM_SeriesNumber, buf);
+      }
+    }
+    if (dset.findOrCreateSequenceItem(DCM_DirectoryRecordSequence, item, -2).good())
+    {
+      item->putAndInsertUint32(DCM_OffsetOfTheNextDirectoryRecord, 0);
+      item->putAndInsertUint16(DCM_RecordInUseFlag, 0xffff);
+      item->putAndInsertUint32(DCM_OffsetOfReferencedLowerLevelDirectoryEntity, 0);
+      item->putAndInsertString(DCM_DirectoryRecordType, "IMAGE");
+      item->putAndInsertString(DCM_SpecificCharacterSet, "ISO_IR 100");
+      sprintf(buf, "IMAGES\\P%05lu\\S%lu\\I%05lu", OFstatic_cast(unsigned long, patient),
+        OFstatic_cast(unsigned long, series), OFstatic_cast(unsigned long, i));
+      item->putAndInsertString(DCM_ReferencedFileID, buf);
+      item->putAndInsertString(DCM_ReferencedSOPClassUIDInFile, UID_CTImageStorage);
+      item->putAndInsertString(DCM_ReferencedSOPInstanceUIDInFile, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+      item->putAndInsertString(DCM_ReferencedTransferSyntaxUIDInFile, UID_LittleEndianExplicitTransferSyntax);
+      sprintf(buf, "%lu", OFstatic_cast(unsigned long, (i % 50) + 1));
+      item->putAndInsertString(DCM_InstanceNumber, buf);
+    }
+  }
+}
+
+static void addContentItems(DcmItem& parent, const size_t depth, const size_t width, size_t& counter)
+{
+  char buf[64];
+  for (size_t i = 0; i < width; ++i)
+  {
+    DcmItem *item = NULL;
+    if (parent.findOrCreateSequenceItem(DCM_ContentSequence, item, -2).good())
+    {
+      ++counter;
+      item->putAndInsertString(DCM_RelationshipType, "CONTAINS");
+      if (depth > 1)
+      {
+        item->putAndInsertString(DCM_ValueType, "CONTAINER");
+        addCode(*item, DCM_ConceptNameCodeSequence, "111028", "DCM", "Image Library");
+        item->putAndInsertString(DCM_ContinuityOfContent, "SEPARATE");
+        addContentItems(*item, depth - 1, width, counter);
+      }
+      else switch (counter % 3)
+      {
+        case 0:
+          item->putAndInsertString(DCM_ValueType, "TEXT");
+          addCode(*item, DCM_ConceptNameCodeSequence, "121071", "DCM", "Finding");
+          sprintf(buf, "Synthetic finding number %lu", OFstatic_cast(unsigned long, counter));
+          item->putAndInsertString(DCM_TextValue, buf);
+          break;
+        case 1:
+        {
+          item->putAndInsertString(DCM_ValueType, "NUM");
+          addCode(*item, DCM_ConceptNameCodeSequence, "410668003", "SCT", "Length");
+          DcmItem *value = NULL;
+          if (item->findOrCreateSequenceItem(DCM_MeasuredValueSequence, value, 0).good())
+          {
+            sprintf(buf, "%lu.5", OFstatic_cast(unsigned long, counter % 100));
+            value->putAndInsertString(DCM_NumericValue, buf);
+            addCode(*value, DCM_MeasurementUnitsCodeSequence, "mm", "UCUM", "millimeter");
+          }
+          break;
+        }
+        default:
+          item->putAndInsertString(DCM_ValueType, "CODE");
+          addCode(*item, DCM_ConceptNameCodeSequence, "121071", "DCM", "Finding");
+          addCode(*item, DCM_ConceptCodeSequence, "108369006", "SCT", "Neoplasm");
+          break;
+      }
+    }
+  }
+}
+
+/** creates a comprehensive SR document with a content tree of the given
+ *  depth, each container having the given number of children
+ */
+static void createStructuredReport(DcmFileFormat& fileformat, const size_t depth, const size_t width)
+{
+  DcmDataset& dset = *fileformat.getDataset();
+  addCommonModules(dset, UID_ComprehensiveSRStorage, "SR");
+  dset.putAndInsertString(DCM_ValueType, "CONTAINER");
+  addCode(dset, DCM_ConceptNameCodeSequence, "126000", "DCM", "Imaging Measurement Report");
+  dset.putAndInsertString(DCM_ContinuityOfContent, "SEPARATE");
+  dset.putAndInsertString(DCM_CompletionFlag, "COMPLETE");
+  dset.putAndInsertString(DCM_VerificationFlag, "UNVERIFIED");
+  size_t counter = 0;
+  if (depth > 0)
+    addContentItems(dset, depth, width, counter);
+}
+
+// ********************************************
+
+/** writes the dataset into the write buffer of the context
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition writeToBuffer(BenchContext& context, const E_TransferSyntax xfer, size_t& length)
+{
+  DcmDataset& dset = *context.fileformat.getDataset();
+  DcmOutputBufferStream out(&context.writeBuffer[0], context.writeBuffer.size());
+  dset.transferInit();
+  OFCondition cond = dset.write(out, xfer, EET_ExplicitLength, NULL);
+  dset.transferEnd();
+  // to avoid error messages, we must always flush the buffer
+  void *data = NULL;
+  offile_off_t written = 0;
+  out.flushBuffer(data, written);
+  length = OFstatic_cast(size_t, written);
+  // the stream asks for more space if the buffer is too small
+  if (cond == EC_StreamNotifyClient)
+    cond = EC_IllegalCall;
+  return cond;
+}
+
+/** converts the pixel data of the dataset to the given transfer syntax
+ *  and removes all other representations, so that the next conversion
+ *  actually has to encode or decode the pixel data
+ */
+static OFCondition convertPixelData(DcmDataset& dset, const E_TransferSyntax xfer)
+{
+  OFCondition cond = dset.chooseRepresentation(xfer, NULL);
+  if (cond.good())
+    dset.removeAllButCurrentRepresentations();
+  return cond;
+}
+
+/** performs an operation once
+ *  @param context state of the dataset
+ *  @param op the operation
+ *  @param seconds returns the time spent for the operation itself
+ *  @param bytes returns the number of bytes processed
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition runOperation(BenchContext& context, const E_BenchOperation op,
+                                double& seconds, size_t& bytes)
+{
+  OFCondition cond = EC_Normal;
+  DcmDataset& dset = *context.fileformat.getDataset();
+  bytes = context.encodedLength;
+  // preparations that are not measured
+  if (op == EBO_RLEEncode)
+    cond = convertPixelData(dset, EXS_LittleEndianExplicit);
+  else if (op == EBO_RLEDecode)
+    cond = convertPixelData(dset, EXS_RLELossless);
+  if (cond.bad())
+    return cond;
+  OFTimer timer;
+  switch (op)
+  {
+    case EBO_Write:
+      cond = writeToBuffer(context, EXS_LittleEndianExplicit, bytes);
+      break;
+    case EBO_WriteBigEndian:
+      cond = writeToBuffer(context, EXS_BigEndianExplicit, bytes);
+      break;
+    case EBO_Read:
+    {
+      DcmInputBufferStream in;
+      in.setBuffer(&context.encoded[0], context.encodedLength);
+      in.setEos();
+      DcmDataset result;
+      result.transferInit();
+      cond = result.read(in, EXS_LittleEndianExplicit);
+      result.transferEnd();
+      break;
+    }
+    case EBO_Save:
+      cond = context.fileformat.saveFile(context.filename, EXS_LittleEndianExplicit);
+      bytes = context.fileSize;
+      break;
+    case EBO_Load:
+    {
+      DcmFileFormat result;
+      cond = result.loadFile(context.filename);
+      if (cond.good() && context.loadAll)
+        cond = result.loadAllDataIntoMemory();
+      bytes = context.fileSize;
+      break;
+    }
+    case EBO_Json:
+    case EBO_Xml:
+    {
+      BenchCountingStreamBuf buf;
+      STD_NAMESPACE ostream out(&buf);
+      if (op == EBO_Json)
+        cond = dset.writeJson(out, DcmJsonFormatCompact());
+      else
+        cond = dset.writeXML(out);
+      bytes = buf.count();
+      break;
+    }
+    case EBO_RLEEncode:
+      cond = convertPixelData(dset, EXS_RLELossless);
+      bytes = context.pixelDataLength;
+      break;
+    case EBO_RLEDecode:
+      cond = convertPixelData(dset, EXS_LittleEndianExplicit);
+      bytes = context.pixelDataLength;
+      break;
+  }
+  seconds = timer.getDiff();
+  return cond;
+}
+
+/** prepares the context after the dataset has been created
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition prepareContext(BenchContext& context, const OFString& tempDir)
+{
+  DcmDataset& dset = *context.fileformat.getDataset();
+  const Uint32 length = dset.calcElementLength(EXS_LittleEndianExplicit, EET_ExplicitLength);
+  // the buffer must also hold the dataset in any other transfer syntax
+  context.writeBuffer.resize(OFstatic_cast(size_t, length) + 65536);
+  OFCondition cond = writeToBuffer(context, EXS_LittleEndianExplicit, context.encodedLength);
+  if (cond.bad())
+    return cond;
+  context.encoded.resize(context.encodedLength);
+  memcpy(&context.encoded[0], &context.writeBuffer[0], context.encodedLength);
+  context.pixelDataLength = 0;
+  DcmElement *pixelData = NULL;
+  if (dset.findAndGetElement(DCM_PixelData, pixelData).good())
+    context.pixelDataLength = pixelData->getLength();
+  // determine a name for the temporary file, the file itself is written by the "save" operation
+  OFString filename;
+  cond = OFTempFile::createFile(filename, NULL, O_RDWR, tempDir, OFFIS_CONSOLE_APPLICATION "_", ".dcm");
+  if (cond.bad())
+    return cond;
+  context.filename = filename;
+  cond = context.fileformat.saveFile(context.filename, EXS_LittleEndianExplicit);
+  if (cond.good())
+    context.fileSize = OFstatic_cast(size_t, OFStandard::getFileSize(context.filename));
+  return cond;
+}
+
+static void printResult(const OFBool csv, const char *dataset, const char *operation,
+                        const unsigned long iterations, const double seconds, const double bytes)
+{
+  const double objects = (seconds > 0) ? iterations / seconds : 0;
+  const double mbytes = (seconds > 0) ? bytes / seconds / 1000000.0 : 0;
+  if (csv)
+  {
+    COUT << dataset << "," << operation << "," << iterations << "," << seconds << ","
+         << OFstatic_cast(unsigned long, bytes / iterations) << "," << objects << "," << mbytes << OFendl;
+  } else {
+    COUT << STD_NAMESPACE left << STD_NAMESPACE setw(10) << dataset << " "
+         << STD_NAMESPACE setw(11) << operation << STD_NAMESPACE right
+         << STD_NAMESPACE setw(14) << OFstatic_cast(unsigned long, bytes / iterations)
+         << STD_NAMESPACE fixed << STD_NAMESPACE setprecision(2)
+         << STD_NAMESPACE setw(14) << objects
+         << STD_NAMESPACE setw(12) << mbytes << OFendl;
+    COUT.unsetf(STD_NAMESPACE ios::floatfield);
+  }
+}
+
+#define NUM_DATASETS 4
+
+int main(int argc, char *argv[])
+{
+  OFBool opt_datasets[NUM_DATASETS] = { OFFalse, OFFalse, OFFalse, OFFalse };
+  const char *datasetNames[NUM_DATASETS] = { "ct-slice", "enhanced", "dicomdir", "sr" };
+  OFCmdUnsignedInt opt_frames = 50;
+  OFCmdUnsignedInt opt_records = 2000;
+  OFCmdUnsignedInt opt_depth = 6;
+  OFCmdUnsignedInt opt_width = 4;
+  OFCmdUnsignedInt opt_iterations = 10;
+  OFCmdUnsignedInt opt_warmup = 1;
+  OFBool opt_loadAll = OFFalse;
+  OFBool opt_csv = OFFalse;
+  OFString opt_tempDir;
+
+  OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Measure parse and write throughput of dcmdata", rcsid);
+  OFCommandLine cmd;
+  cmd.setOptionColumns(LONGCOL, SHORTCOL);
+  cmd.setParamColumn(LONGCOL + SHORTCOL + 4);
+
+  cmd.addGroup("general options:", LONGCOL, SHORTCOL + 2);
+    cmd.addOption("--help",              "-h",     "print this help text and exit", OFCommandLine::AF_Exclusive);
+    cmd.addOption("--version",                     "print version information and exit", OFCommandLine::AF_Exclusive);
+    OFLog::addOptions(cmd);
+
+  cmd.addGroup("benchmark options:");
+    cmd.addSubGroup("datasets (default: all):");
+      cmd.addOption("--ct-slice",        "+ct",    "CT image with 512 x 512 pixels");
+      cmd.addOption("--enhanced",        "+mf",    "enhanced CT multi-frame image with\nper-frame functional groups");
+      cmd.addOption("--dicomdir",        "+dd",    "DICOMDIR with patient, study, series\nand image records");
+      cmd.addOption("--sr",              "+sr",    "comprehensive SR with deep content tree");
+    cmd.addSubGroup("dataset size:");
+      cmd.addOption("--frames",          "+nf", 1, "[n]umber: integer (default: 50)",
+                                                   "number of frames of enhanced image");
+      cmd.addOption("--records",         "+nr", 1, "[n]umber: integer (default: 2000)",
+                                                   "number of image records of DICOMDIR");
+      cmd.addOption("--sr-depth",        "+sd", 1, "[n]umber: integer (default: 6)",
+                                                   "depth of SR content tree");
+      cmd.addOption("--sr-width",        "+sw", 1, "[n]umber: integer (default: 4)",
+                                                   "number of children per SR container");
+    cmd.addSubGroup("repetitions:");
+      cmd.addOption("--iterations",      "+n",  1, "[n]umber: integer (default: 10)",
+                                                   "number of measured runs per operation");
+      cmd.addOption("--warmup",          "+w",  1, "[n]umber: integer (default: 1)",
+                                                   "number of runs before measuring");
+    cmd.addSubGroup("loading:");
+      cmd.addOption("--load-on-demand",  "-la",    "load large element values on demand (default)");
+      cmd.addOption("--load-all",        "+la",    "load all element values into memory");
+
+  cmd.addGroup("output options:");
+    cmd.addOption("--temp-dir",          "+td", 1, "[d]irectory: string",
+                                                   "directory for temporary files\n(default: system specific)");
+    cmd.addOption("--print-table",       "+pt",    "print results as table (default)");
+    cmd.addOption("--print-csv",         "+pc",    "print results as comma separated values");
+
+  /* evaluate command line */
+  prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
+  if (app.parseCommandLine(cmd, argc, argv))
+  {
+    /* check exclusive options first */
+    if (cmd.hasExclusiveOption())
+    {
+      if (cmd.findOption("--version"))
+      {
+        app.printHeader(OFTrue /*print host identifier*/);
+        return 0;
+      }
+    }
+
+    /* general options */
+    OFLog::configureFromCommandLine(cmd, app);
+
+    /* benchmark options */
+    if (cmd.findOption("--ct-slice")) opt_datasets[0] = OFTrue;
+    if (cmd.findOption("--enhanced")) opt_datasets[1] = OFTrue;
+    if (cmd.findOption("--dicomdir")) opt_datasets[2] = OFTrue;
+    if (cmd.findOption("--sr")) opt_datasets[3] = OFTrue;
+    if (cmd.findOption("--frames"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_frames, 1));
+    if (cmd.findOption("--records"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_records, 1));
+    if (cmd.findOption("--sr-depth"))
+      app.checkValue(cmd.getValueAndCheckMinMax(opt_depth, 1, 16));
+    if (cmd.findOption("--sr-width"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_width, 1));
+    if (cmd.findOption("--iterations"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_iterations, 1));
+    if (cmd.findOption("--warmup"))
+      app.checkValue(cmd.getValue(opt_warmup));
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--load-on-demand")) opt_loadAll = OFFalse;
+    if (cmd.findOption("--load-all")) opt_loadAll = OFTrue;
+    cmd.endOptionBlock();
+
+    /* output options */
+    if (cmd.findOption("--temp-dir"))
+      app.checkValue(cmd.getValue(opt_tempDir));
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--print-table")) opt_csv = OFFalse;
+    if (cmd.findOption("--print-csv")) opt_csv = OFTrue;
+    cmd.endOptionBlock();
+  }
+
+  /* print resource identifier */
+  OFLOG_DEBUG(benchLogger, rcsid << OFendl);
+
+  /* make sure data dictionary is loaded */
+  if (!dcmDataDict.isDictionaryLoaded())
+  {
+    OFLOG_FATAL(benchLogger, "no data dictionary loaded, check environment variable: "
+      << DCM_DICT_ENVIRONMENT_VARIABLE);
+    return 1;
+  }
+
+  /* if no dataset is selected, use all of them */
+  if (!opt_datasets[0] && !opt_datasets[1] && !opt_datasets[2] && !opt_datasets[3])
+  {
+    for (size_t i = 0; i < NUM_DATASETS; ++i)
+      opt_datasets[i] = OFTrue;
+  }
+
+  DcmRLEEncoderRegistration::registerCodecs();
+  DcmRLEDecoderRegistration::registerCodecs();
+
+  if (opt_csv)
+    COUT << "dataset,operation,iterations,seconds,bytes,objects_per_second,mb_per_second" << OFendl;
+  else
+  {
+    COUT << "dataset    operation            bytes     objects/s        MB/s" << OFendl;
+    COUT << "---------------------------------------------------------------" << OFendl;
+  }
+
+  int result = 0;
+  for (size_t d = 0; (d < NUM_DATASETS) && (result == 0); ++d)
+  {
+    if (!opt_datasets[d])
+      continue;
+    BenchContext context;
+    context.loadAll = opt_loadAll;
+    OFTimer timer;
+    switch (d)
+    {
+      case 0:
+        createCTSlice(context.fileformat);
+        break;
+      case 1:
+        createEnhancedMultiFrame(context.fileformat, opt_frames);
+        break;
+      case 2:
+        createDicomdir(context.fileformat, opt_records);
+        break;
+      default:
+        createStructuredReport(context.fileformat, opt_depth, opt_width);
+        break;
+    }
+    OFCondition cond = prepareContext(context, opt_tempDir);
+    OFLOG_INFO(benchLogger, "created dataset '" << datasetNames[d] << "' with " << context.encodedLength
+      << " bytes in " << timer.getDiff() << " s");
+    for (size_t o = 0; (o < numBenchOperations) && cond.good(); ++o)
+    {
+      const E_BenchOperation op = OFstatic_cast(E_BenchOperation, o);
+      // the conversion to RLE is only meaningful for datasets with pixel data
+      if (((op == EBO_RLEEncode) || (op == EBO_RLEDecode)) && (context.pixelDataLength == 0))
+        continue;
+      double seconds = 0;
+      size_t bytes = 0;
+      for (OFCmdUnsignedInt i = 0; (i < opt_warmup) && cond.good(); ++i)
+        cond = runOperation(context, op, seconds, bytes);
+      double totalSeconds = 0;
+      double totalBytes = 0;
+      for (OFCmdUnsignedInt i = 0; (i < opt_iterations) && cond.good(); ++i)
+      {
+        cond = runOperation(context, op, seconds, bytes);
+        totalSeconds += seconds;
+        totalBytes += OFstatic_cast(double, bytes);
+      }
+      if (cond.good())
+        printResult(opt_csv, datasetNames[d], benchOperationNames[o], opt_iterations, totalSeconds, totalBytes);
+      else
+        OFLOG_ERROR(benchLogger, "operation '" << benchOperationNames[o] << "' failed for dataset '"
+          << datasetNames[d] << "': " << cond.text());
+    }
+    if (cond.bad())
+    {
+      OFLOG_FATAL(benchLogger, "benchmark for dataset '" << datasetNames[d] << "' failed: " << cond.text());
+      result = 1;
+    }
+    if (!context.filename.empty())
+      OFStandard::deleteFile(context.filename);
+  }
+
+  DcmRLEEncoderRegistration::cleanup();
+  DcmRLEDecoderRegistration::cleanup();
+
+  return result;
+}
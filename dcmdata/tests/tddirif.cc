@@ -0,0 +1,320 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: tests for class DicomDirInterface, e.g. for adding files
+ *           with several threads and for the incremental write mode
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcddirif.h"
+
+
+#define INCREMENTAL_DICOMDIR "TDDIRINC"
+#define FULL_DICOMDIR        "TDDIRFUL"
+#define SERIAL_DICOMDIR      "TDDIRSER"
+#define THREADED_DICOMDIR    "TDDIRTHR"
+
+#define STUDY_UID_1   "1.2.276.0.7230010.3.1.2.4711.1"
+#define STUDY_UID_2   "1.2.276.0.7230010.3.1.2.4711.2"
+#define SERIES_UID_1  "1.2.276.0.7230010.3.1.3.4711.1"
+#define SERIES_UID_2  "1.2.276.0.7230010.3.1.3.4711.2"
+#define SERIES_UID_3  "1.2.276.0.7230010.3.1.3.4711.3"
+
+
+/* create a small secondary capture image and store it in the current directory */
+static void createImageFile(const char *filename,
+                            const char *patientName,
+                            const char *patientID,
+                            const char *studyUID,
+                            const char *studyDescription,
+                            const char *seriesUID,
+                            const char *instanceNumber)
+{
+  DcmFileFormat fileformat;
+  DcmDataset *dataset = fileformat.getDataset();
+  const Uint8 pixelData[4] = { 0, 1, 2, 3 };
+  OFString instanceUID = "1.2.276.0.7230010.3.1.4.4711.";
+  instanceUID += filename + 6;
+  OFCHECK(dataset->putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+  OFCHECK(dataset->putAndInsertString(DCM_SOPInstanceUID, instanceUID.c_str()).good());
+  OFCHECK(dataset->putAndInsertString(DCM_PatientName, patientName).good());
+  OFCHECK(dataset->putAndInsertString(DCM_PatientID, patientID).good());
+  OFCHECK(dataset->putAndInsertString(DCM_StudyInstanceUID, studyUID).good());
+  OFCHECK(dataset->putAndInsertString(DCM_StudyDate, "20260101").good());
+  OFCHECK(dataset->putAndInsertString(DCM_StudyTime, "120000").good());
+  OFCHECK(dataset->putAndInsertString(DCM_StudyDescription, studyDescription).good());
+  OFCHECK(dataset->putAndInsertString(DCM_StudyID, "1").good());
+  OFCHECK(dataset->putAndInsertString(DCM_AccessionNumber, "").good());
+  OFCHECK(dataset->putAndInsertString(DCM_SeriesInstanceUID, seriesUID).good());
+  OFCHECK(dataset->putAndInsertString(DCM_SeriesNumber, "1").good());
+  OFCHECK(dataset->putAndInsertString(DCM_Modality, "OT").good());
+  OFCHECK(dataset->putAndInsertString(DCM_InstanceNumber, instanceNumber).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_SamplesPerPixel, 1).good());
+  OFCHECK(dataset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2").good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_Rows, 2).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_Columns, 2).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_BitsAllocated, 8).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_BitsStored, 8).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_HighBit, 7).good());
+  OFCHECK(dataset->putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+  OFCHECK(dataset->putAndInsertUint8Array(DCM_PixelData, pixelData, 4).good());
+  OFCHECK(fileformat.saveFile(filename, EXS_LittleEndianExplicit).good());
+}
+
+
+/* create, append to or update a DICOMDIR file and add the given DICOM files to it */
+static void addFilesToDicomDir(const char *dicomdir,
+                               const char *file1,
+                               const char *file2,
+                               const OFBool create,
+                               const OFBool update,
+                               const OFBool incremental,
+                               const E_EncodingType enctype)
+{
+  DicomDirInterface ddir;
+  ddir.disableBackupMode();
+  ddir.enableIncrementalWriteMode(incremental);
+  OFCondition result;
+  if (create)
+    result = ddir.createNewDicomDir(DicomDirInterface::AP_GeneralPurpose, dicomdir);
+  else if (update)
+    result = ddir.updateDicomDir(DicomDirInterface::AP_GeneralPurpose, dicomdir);
+  else
+    result = ddir.appendToDicomDir(DicomDirInterface::AP_GeneralPurpose, dicomdir);
+  OFCHECK(result.good());
+  if (result.good())
+  {
+    if (file1 != NULL)
+      OFCHECK(ddir.addDicomFile(file1).good());
+    if (file2 != NULL)
+      OFCHECK(ddir.addDicomFile(file2).good());
+    OFCHECK(ddir.writeDicomDir(enctype).good());
+  }
+}
+
+
+/* convert a record and its children to a string, ignoring the attributes that
+ * contain file offsets since they depend on the layout of the file
+ */
+static void recordToString(DcmDirectoryRecord *record, OFString &result)
+{
+  const unsigned long count = record->card();
+  for (unsigned long i = 0; i < count; ++i)
+  {
+    DcmElement *elem = record->getElement(i);
+    const DcmTagKey key = elem->getTag();
+    if ((key != DCM_OffsetOfTheNextDirectoryRecord) &&
+        (key != DCM_OffsetOfReferencedLowerLevelDirectoryEntity))
+    {
+      OFString value;
+      elem->getOFStringArray(value);
+      result += key.toString();
+      result += "=";
+      result += value;
+      result += "\n";
+    }
+  }
+  const unsigned long numSub = record->cardSub();
+  result += "{\n";
+  for (unsigned long j = 0; j < numSub; ++j)
+    recordToString(record->getSub(j), result);
+  result += "}\n";
+}
+
+
+/* load a DICOMDIR file and convert its record tree to a string */
+static OFString dicomDirToString(const char *filename)
+{
+  OFString result;
+  DcmDicomDir dicomdir(filename);
+  OFCHECK(dicomdir.error().good());
+  recordToString(&dicomdir.getRootRecord(), result);
+  return result;
+}
+
+
+/* get the file offset of the first record with the given instance number */
+static Uint32 getRecordOffset(DcmDirectoryRecord *record, const char *instanceNumber)
+{
+  OFString value;
+  if ((record->getRecordType() == ERT_Image) &&
+      record->findAndGetOFString(DCM_InstanceNumber, value).good() &&
+      (value == instanceNumber))
+  {
+    return record->getFileOffset();
+  }
+  const unsigned long numSub = record->cardSub();
+  for (unsigned long i = 0; i < numSub; ++i)
+  {
+    const Uint32 offset = getRecordOffset(record->getSub(i), instanceNumber);
+    if (offset > 0)
+      return offset;
+  }
+  return 0;
+}
+
+
+static Uint32 getRecordOffset(const char *filename, const char *instanceNumber)
+{
+  DcmDicomDir dicomdir(filename);
+  return getRecordOffset(&dicomdir.getRootRecord(), instanceNumber);
+}
+
+
+static void testIncrementalWrite(const E_EncodingType enctype)
+{
+  /* some of the attribute values are of odd length and therefore padded */
+  createImageFile("TDDIRF1", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "1");
+  createImageFile("TDDIRF2", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "2");
+  createImageFile("TDDIRF3", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_2, "3");
+  createImageFile("TDDIRF4", "Doe^Joe", "P2", STUDY_UID_2, "OTHER", SERIES_UID_3, "4");
+  createImageFile("TDDIRF5", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "5");
+
+  /* create two identical DICOMDIR files */
+  addFilesToDicomDir(INCREMENTAL_DICOMDIR, "TDDIRF1", "TDDIRF2", OFTrue, OFFalse, OFFalse, enctype);
+  addFilesToDicomDir(FULL_DICOMDIR, "TDDIRF1", "TDDIRF2", OFTrue, OFFalse, OFFalse, enctype);
+  OFCHECK_EQUAL(dicomDirToString(INCREMENTAL_DICOMDIR), dicomDirToString(FULL_DICOMDIR));
+
+  /* append a new series (modifies the existing series record) and a new patient */
+  addFilesToDicomDir(INCREMENTAL_DICOMDIR, "TDDIRF3", "TDDIRF4", OFFalse, OFFalse, OFTrue, enctype);
+  addFilesToDicomDir(FULL_DICOMDIR, "TDDIRF3", "TDDIRF4", OFFalse, OFFalse, OFFalse, enctype);
+  OFCHECK_EQUAL(dicomDirToString(INCREMENTAL_DICOMDIR), dicomDirToString(FULL_DICOMDIR));
+
+  /* append an image to the first series (modifies the last image record of this series) */
+  addFilesToDicomDir(INCREMENTAL_DICOMDIR, "TDDIRF5", NULL, OFFalse, OFFalse, OFTrue, enctype);
+  addFilesToDicomDir(FULL_DICOMDIR, "TDDIRF5", NULL, OFFalse, OFFalse, OFFalse, enctype);
+  OFCHECK_EQUAL(dicomDirToString(INCREMENTAL_DICOMDIR), dicomDirToString(FULL_DICOMDIR));
+  /* the new record is stored in tree order by a full rewrite, but appended otherwise */
+  OFCHECK(getRecordOffset(INCREMENTAL_DICOMDIR, "5") > getRecordOffset(INCREMENTAL_DICOMDIR, "4"));
+  OFCHECK(getRecordOffset(FULL_DICOMDIR, "5") < getRecordOffset(FULL_DICOMDIR, "4"));
+
+  /* update an attribute value without changing its padded length (record is overwritten in place) */
+  createImageFile("TDDIRF1", "Doe^Jane", "P1", STUDY_UID_1, "STUDY BB", SERIES_UID_1, "1");
+  addFilesToDicomDir(INCREMENTAL_DICOMDIR, "TDDIRF1", NULL, OFFalse, OFTrue, OFTrue, enctype);
+  addFilesToDicomDir(FULL_DICOMDIR, "TDDIRF1", NULL, OFFalse, OFTrue, OFFalse, enctype);
+  OFCHECK_EQUAL(dicomDirToString(INCREMENTAL_DICOMDIR), dicomDirToString(FULL_DICOMDIR));
+  OFCHECK(getRecordOffset(INCREMENTAL_DICOMDIR, "5") > getRecordOffset(INCREMENTAL_DICOMDIR, "4"));
+
+  /* update an attribute value with a different length (falls back to a full rewrite) */
+  createImageFile("TDDIRF1", "Doe^Jane", "P1", STUDY_UID_1, "STUDY BBB", SERIES_UID_1, "1");
+  addFilesToDicomDir(INCREMENTAL_DICOMDIR, "TDDIRF1", NULL, OFFalse, OFTrue, OFTrue, enctype);
+  addFilesToDicomDir(FULL_DICOMDIR, "TDDIRF1", NULL, OFFalse, OFTrue, OFFalse, enctype);
+  OFCHECK_EQUAL(dicomDirToString(INCREMENTAL_DICOMDIR), dicomDirToString(FULL_DICOMDIR));
+  OFCHECK(getRecordOffset(INCREMENTAL_DICOMDIR, "5") < getRecordOffset(INCREMENTAL_DICOMDIR, "4"));
+
+  OFStandard::deleteFile(INCREMENTAL_DICOMDIR);
+  OFStandard::deleteFile(FULL_DICOMDIR);
+  OFStandard::deleteFile("TDDIRF1");
+  OFStandard::deleteFile("TDDIRF2");
+  OFStandard::deleteFile("TDDIRF3");
+  OFStandard::deleteFile("TDDIRF4");
+  OFStandard::deleteFile("TDDIRF5");
+}
+
+
+OFTEST(dcmdata_dicomDirIncrementalWrite_undefinedLength)
+{
+  testIncrementalWrite(EET_UndefinedLength);
+}
+
+
+OFTEST(dcmdata_dicomDirIncrementalWrite_explicitLength)
+{
+  testIncrementalWrite(EET_ExplicitLength);
+}
+
+
+/* add the given files to a new DICOMDIR using the given number of threads */
+static void addFilesWithThreads(const char *dicomdir,
+                                const OFList<OFFilename> &filenames,
+                                const unsigned int numberOfThreads,
+                                const OFBool abortMode,
+                                size_t &goodFiles,
+                                size_t &badFiles)
+{
+  DicomDirInterface ddir;
+  OFList<OFFilename> badFileList;
+  goodFiles = badFiles = 0;
+  ddir.enableAbortMode(abortMode);
+  OFCHECK(ddir.createNewDicomDir(DicomDirInterface::AP_GeneralPurpose, dicomdir).good());
+  const OFCondition result = ddir.addDicomFiles(filenames, OFFilename(), badFileList, goodFiles, numberOfThreads);
+  OFCHECK(result.good() || abortMode);
+  OFCHECK(ddir.writeDicomDir().good());
+  badFiles = badFileList.size();
+}
+
+
+OFTEST(dcmdata_dicomDirAddFiles)
+{
+  /* files of different patients, studies and series in mixed order */
+  createImageFile("TDDIRF1", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "1");
+  createImageFile("TDDIRF2", "Doe^Joe", "P2", STUDY_UID_2, "OTHER", SERIES_UID_3, "2");
+  createImageFile("TDDIRF3", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_2, "3");
+  createImageFile("TDDIRF4", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "4");
+  createImageFile("TDDIRF5", "Doe^Joe", "P2", STUDY_UID_2, "OTHER", SERIES_UID_3, "5");
+  createImageFile("TDDIRF6", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_2, "6");
+  createImageFile("TDDIRF7", "Doe^Jane", "P1", STUDY_UID_1, "STUDY A", SERIES_UID_1, "7");
+  OFList<OFFilename> filenames;
+  filenames.push_back("TDDIRF7");
+  filenames.push_back("TDDIRF2");
+  filenames.push_back("TDDIRF1");
+  filenames.push_back("TDDIRF0"); /* does not exist */
+  filenames.push_back("TDDIRF5");
+  filenames.push_back("TDDIRF3");
+  filenames.push_back("TDDIRF6");
+  filenames.push_back("TDDIRF4");
+
+  /* the result must not depend on the number of threads, including the order of the records */
+  size_t goodFiles = 0;
+  size_t badFiles = 0;
+  addFilesWithThreads(SERIAL_DICOMDIR, filenames, 1, OFFalse, goodFiles, badFiles);
+  OFCHECK_EQUAL(goodFiles, 7);
+  OFCHECK_EQUAL(badFiles, 1);
+  addFilesWithThreads(THREADED_DICOMDIR, filenames, 4, OFFalse, goodFiles, badFiles);
+  OFCHECK_EQUAL(goodFiles, 7);
+  OFCHECK_EQUAL(badFiles, 1);
+  OFCHECK_EQUAL(dicomDirToString(SERIAL_DICOMDIR), dicomDirToString(THREADED_DICOMDIR));
+
+  /* in abort mode, processing stops at the first bad file */
+  addFilesWithThreads(SERIAL_DICOMDIR, filenames, 1, OFTrue, goodFiles, badFiles);
+  OFCHECK_EQUAL(goodFiles, 3);
+  OFCHECK_EQUAL(badFiles, 1);
+  addFilesWithThreads(THREADED_DICOMDIR, filenames, 4, OFTrue, goodFiles, badFiles);
+  OFCHECK_EQUAL(goodFiles, 3);
+  OFCHECK_EQUAL(badFiles, 1);
+  OFCHECK_EQUAL(dicomDirToString(SERIAL_DICOMDIR), dicomDirToString(THREADED_DICOMDIR));
+  filenames.push_front("TDDIRF0");
+  addFilesWithThreads(THREADED_DICOMDIR, filenames, 4, OFTrue, goodFiles, badFiles);
+  OFCHECK_EQUAL(goodFiles, 0);
+  OFCHECK_EQUAL(badFiles, 1);
+
+  OFStandard::deleteFile(SERIAL_DICOMDIR);
+  OFStandard::deleteFile(THREADED_DICOMDIR);
+  OFStandard::deleteFile("TDDIRF1");
+  OFStandard::deleteFile("TDDIRF2");
+  OFStandard::deleteFile("TDDIRF3");
+  OFStandard::deleteFile("TDDIRF4");
+  OFStandard::deleteFile("TDDIRF5");
+  OFStandard::deleteFile("TDDIRF6");
+  OFStandard::deleteFile("TDDIRF7");
+}
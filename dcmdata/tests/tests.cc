@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2011-2017 OFFIS e.V.
+ *  Copyright (C) 2011-2026 OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -24,6 +24,7 @@
 #include "dcmtk/ofstd/oftest.h"
 
 OFTEST_REGISTER(dcmdata_partialElementAccess);
+OFTEST_REGISTER(dcmdata_bulkDataAccess);
 OFTEST_REGISTER(dcmdata_i2d_bmp);
 OFTEST_REGISTER(dcmdata_checkStringValue);
 OFTEST_REGISTER(dcmdata_determineVM);
@@ -96,6 +97,7 @@ OFTEST_REGISTER(dcmdata_parser_wrongExplicitVRinDataset_defaultVR_dictLen);
 OFTEST_REGISTER(dcmdata_parser_wrongExplicitVRinDataset_dictVR_defaultLen);
 OFTEST_REGISTER(dcmdata_parser_wrongExplicitVRinDataset_preferDataDict);
 OFTEST_REGISTER(dcmdata_parser_undefinedLengthUNSequence);
+OFTEST_REGISTER(dcmdata_parser_suspendedReading);
 OFTEST_REGISTER(dcmdata_readingDataDictionary);
 OFTEST_REGISTER(dcmdata_usingDataDictionary);
 OFTEST_REGISTER(dcmdata_specificCharacterSet_1);
@@ -106,4 +108,17 @@ OFTEST_REGISTER(dcmdata_attribute_filter);
 OFTEST_REGISTER(dcmdata_attribute_matching);
 OFTEST_REGISTER(dcmdata_newDicomElementPrivate);
 OFTEST_REGISTER(dcmdata_generateUniqueIdentifier);
+OFTEST_REGISTER(dcmdata_uidGenerator);
+OFTEST_REGISTER(dcmdata_uidGeneratorLongPrefix);
+OFTEST_REGISTER(dcmdata_uidMap);
+OFTEST_REGISTER(dcmdata_uidMapLarge);
+OFTEST_REGISTER(dcmdata_rleEncoderDecoder);
+OFTEST_REGISTER(dcmdata_rleCodec);
+#ifdef WITH_ZLIB
+OFTEST_REGISTER(dcmdata_zlibParallelOutputFilter);
+#endif
+OFTEST_REGISTER(dcmdata_swapBytes);
+OFTEST_REGISTER(dcmdata_dicomDirIncrementalWrite_undefinedLength);
+OFTEST_REGISTER(dcmdata_dicomDirIncrementalWrite_explicitLength);
+OFTEST_REGISTER(dcmdata_dicomDirAddFiles);
 OFTEST_MAIN("dcmdata")
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2017, OFFIS e.V.
+ *  Copyright (C) 2017-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -15,7 +15,8 @@
  *
  *  Author:  Marco Eichelberg
  *
- *  Purpose: test program for function dcmGenerateUniqueIdentifier
+ *  Purpose: test program for function dcmGenerateUniqueIdentifier,
+ *           class DcmUIDGenerator and class DcmUIDMap
  *
  */
 
@@ -23,7 +24,11 @@
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 
 #include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/oftempf.h"
+#include "dcmtk/ofstd/ofmap.h"
 #include "dcmtk/dcmdata/dcuid.h"
+#include "dcmtk/dcmdata/dcuidmap.h"
+#include "dcmtk/dcmdata/dctk.h"
 
 
 OFTEST(dcmdata_generateUniqueIdentifier)
@@ -54,3 +59,194 @@ OFTEST(dcmdata_generateUniqueIdentifier)
      if (! generated_uid_is_not_unique) break;
   }
 }
+
+
+OFTEST(dcmdata_uidGenerator)
+{
+  // two generators in the same process must never create the same UID
+  DcmUIDGenerator gen1;
+  DcmUIDGenerator gen2(SITE_INSTANCE_UID_ROOT);
+  OFMap<OFString, size_t> uids;
+  char uid[65];
+
+  for (size_t i = 0; i < 10000; ++i)
+  {
+     OFString uid1 = gen1.generate(uid);
+     OFString uid2 = gen2.generate();
+     OFCHECK(uid1.length() <= 64);
+     OFCHECK(DcmUniqueIdentifier::checkStringValue(uid1, "1").good());
+     OFCHECK(uid1.compare(0, strlen(SITE_INSTANCE_UID_ROOT), SITE_INSTANCE_UID_ROOT) == 0);
+     OFCHECK(uids.insert(OFMake_pair(uid1, i)).second);
+     OFCHECK(uids.insert(OFMake_pair(uid2, i)).second);
+  }
+  OFCHECK_EQUAL(uids.size(), 20000);
+}
+
+
+OFTEST(dcmdata_uidGeneratorLongPrefix)
+{
+  // with a prefix of 50 characters, there is not enough space for host ID,
+  // process ID and creation time, but the UIDs must still be different
+  const char *prefix = "1.2.276.0.7230010.3.1.4.1234567890.1234567890.1234";
+  OFCHECK_EQUAL(strlen(prefix), 50);
+  DcmUIDGenerator gen1(prefix);
+  DcmUIDGenerator gen2(prefix);
+  OFMap<OFString, size_t> uids;
+  for (size_t i = 0; i < 10000; ++i)
+  {
+     OFString uid1 = gen1.generate();
+     OFString uid2 = gen2.generate();
+     OFCHECK(uid1.length() <= 64);
+     OFCHECK(DcmUniqueIdentifier::checkStringValue(uid1, "1").good());
+     OFCHECK(uid1.compare(0, 51, OFString(prefix) + ".") == 0);
+     OFCHECK(uids.insert(OFMake_pair(uid1, i)).second);
+     OFCHECK(uids.insert(OFMake_pair(uid2, i)).second);
+  }
+  OFCHECK_EQUAL(uids.size(), 20000);
+
+  // no UID can be created if the prefix does not leave room for the counter
+  DcmUIDGenerator gen3("1.2.276.0.7230010.3.1.4.1234567890.1234567890.1234567890.1234");
+  OFCHECK(gen3.generate().empty());
+}
+
+
+OFTEST(dcmdata_uidMap)
+{
+  DcmUIDMap map("1.2.3");
+  DcmDataset dset;
+  OFString value;
+  size_t count = 0;
+
+  // create a dataset with instance and class UIDs, some of them nested
+  OFCHECK(dset.putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage).good());
+  OFCHECK(dset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.1").good());
+  OFCHECK(dset.putAndInsertString(DCM_StudyInstanceUID, "1.2.276.0.7230010.3.1.2.1").good());
+  OFCHECK(dset.putAndInsertString(DCM_FrameOfReferenceUID, "1.2.840.10008.1.4.1.1").good());
+  OFCHECK(dset.putAndInsertString(DCM_RelatedGeneralSOPClassUID, "1.2.276.0.7230010.3.9.9").good());
+  DcmItem *item = NULL;
+  OFCHECK(dset.findOrCreateSequenceItem(DCM_ReferencedImageSequence, item).good());
+  if (item != NULL)
+  {
+    OFCHECK(item->putAndInsertString(DCM_ReferencedSOPClassUID, UID_CTImageStorage).good());
+    OFCHECK(item->putAndInsertString(DCM_ReferencedSOPInstanceUID, "1.2.276.0.7230010.3.1.4.1").good());
+  }
+  OFCHECK(map.remapUIDs(dset, &count).good());
+  OFCHECK_EQUAL(count, 3);
+  OFCHECK_EQUAL(map.size(), 2);
+  OFCHECK(map.isModified());
+
+  // instance UIDs are replaced consistently, everything else is unchanged
+  OFString newUID;
+  OFCHECK(map.findUID("1.2.276.0.7230010.3.1.4.1", newUID));
+  OFCHECK(newUID.compare(0, 6, "1.2.3.") == 0);
+  OFCHECK(dset.findAndGetOFString(DCM_SOPInstanceUID, value).good());
+  OFCHECK_EQUAL(value, newUID);
+  OFCHECK(dset.findAndGetOFString(DCM_ReferencedSOPInstanceUID, value, 0, OFTrue /*searchIntoSub*/).good());
+  OFCHECK_EQUAL(value, newUID);
+  OFCHECK(dset.findAndGetOFString(DCM_SOPClassUID, value).good());
+  OFCHECK_EQUAL(value, UID_CTImageStorage);
+  OFCHECK(dset.findAndGetOFString(DCM_FrameOfReferenceUID, value).good());
+  OFCHECK_EQUAL(value, "1.2.840.10008.1.4.1.1");
+  OFCHECK(dset.findAndGetOFString(DCM_RelatedGeneralSOPClassUID, value).good());
+  OFCHECK_EQUAL(value, "1.2.276.0.7230010.3.9.9");
+  OFString mapped1, mapped2;
+  OFCHECK(map.mapUID("1.2.276.0.7230010.3.1.2.1", mapped1).good());
+  OFCHECK(map.mapUID("1.2.276.0.7230010.3.1.2.1", mapped2).good());
+  OFCHECK_EQUAL(mapped1, mapped2);
+  OFCHECK(map.addMapping("1.2.4", "not a UID").bad());
+
+  // save the table and load it again
+  OFTempFile temp;
+  OFCHECK(temp.getStatus().good());
+  OFCHECK(map.saveFile(temp.getFilename()).good());
+  OFCHECK(!map.isModified());
+  OFFilename tempFilename;
+  OFStandard::appendFilenameExtension(tempFilename, temp.getFilename(), ".tmp");
+  OFCHECK(!OFStandard::fileExists(tempFilename));
+  DcmUIDMap map2;
+  OFCHECK(map2.loadFile(temp.getFilename()).good());
+  OFCHECK_EQUAL(map2.size(), 2);
+  OFCHECK(map2.findUID("1.2.276.0.7230010.3.1.4.1", value));
+  OFCHECK_EQUAL(value, newUID);
+  OFCHECK(!map2.isModified());
+
+  // the temporary file is kept if it cannot replace the existing one
+  // (here: a directory with the same name)
+  const OFFilename dirName("TUIDMAPD");
+  OFFilename dirTempFilename;
+  OFStandard::appendFilenameExtension(dirTempFilename, dirName, ".tmp");
+  OFCHECK(OFStandard::createDirectory(dirName, "").good());
+  OFCHECK(map.saveFile(dirName).bad());
+  OFCHECK(OFStandard::dirExists(dirName));
+  OFCHECK(OFStandard::fileExists(dirTempFilename));
+  DcmUIDMap map4;
+  OFCHECK(map4.loadFile(dirTempFilename).good());
+  OFCHECK_EQUAL(map4.size(), 2);
+  OFStandard::deleteFile(dirTempFilename);
+  STDIO_NAMESPACE remove(dirName.getCharPointer());
+
+  // no empty UIDs are stored if the prefix is too long for creating new UIDs
+  DcmUIDMap map3("1.2.276.0.7230010.3.1.4.1234567890.1234567890.1234567890.1234");
+  OFCHECK(map3.mapUID("1.2.276.0.7230010.3.1.4.1", value) == EC_InvalidValue);
+  OFCHECK_EQUAL(map3.size(), 0);
+  OFCHECK(map3.remapUIDs(dset, &count) == EC_InvalidValue);
+  OFCHECK_EQUAL(count, 0);
+  OFCHECK_EQUAL(map3.size(), 0);
+  OFCHECK(!map3.isModified());
+  OFCHECK(dset.findAndGetOFString(DCM_SOPInstanceUID, value).good());
+  OFCHECK_EQUAL(value, newUID);
+}
+
+
+OFTEST(dcmdata_uidMapLarge)
+{
+  DcmUIDMap map("1.2.3");
+  char oldUID[65];
+  OFString newUID;
+  OFString value;
+
+  // create enough mappings for the hash table to grow several times
+  for (unsigned long i = 0; i < 20000; ++i)
+  {
+    OFStandard::snprintf(oldUID, sizeof(oldUID), "1.2.276.0.7230010.3.1.4.%lu", i);
+    OFCHECK(map.mapUID(oldUID, newUID).good());
+    OFCHECK(map.findUID(oldUID, value));
+    OFCHECK_EQUAL(value, newUID);
+  }
+  OFCHECK_EQUAL(map.size(), 20000);
+  OFCHECK(map.findUID("1.2.276.0.7230010.3.1.4.0", value));
+  OFCHECK(!map.findUID("1.2.276.0.7230010.3.1.4.20000", value));
+
+  // replacing a mapping does not change the number of mappings
+  OFCHECK(map.addMapping("1.2.276.0.7230010.3.1.4.123", "1.2.3.4.5.6.7.8.9.10.11.12.13").good());
+  OFCHECK_EQUAL(map.size(), 20000);
+  OFCHECK(map.mapUID("1.2.276.0.7230010.3.1.4.123", value).good());
+  OFCHECK_EQUAL(value, "1.2.3.4.5.6.7.8.9.10.11.12.13");
+
+  // the file is sorted by old UID
+  OFTempFile temp;
+  OFCHECK(map.saveFile(temp.getFilename()).good());
+  OFFile file;
+  OFCHECK(file.fopen(temp.getFilename(), "r"));
+  char line[256];
+  OFString previous;
+  size_t lines = 0;
+  while (file.fgets(line, sizeof(line)) != NULL)
+  {
+    OFString current(line);
+    OFCHECK(previous < current);
+    previous = current;
+    ++lines;
+  }
+  file.fclose();
+  OFCHECK_EQUAL(lines, 20000);
+
+  // all mappings are removed
+  map.clear();
+  OFCHECK_EQUAL(map.size(), 0);
+  OFCHECK(!map.findUID("1.2.276.0.7230010.3.1.4.0", value));
+  OFCHECK(map.loadFile(temp.getFilename()).good());
+  OFCHECK_EQUAL(map.size(), 20000);
+  OFCHECK(map.findUID("1.2.276.0.7230010.3.1.4.123", value));
+  OFCHECK_EQUAL(value, "1.2.3.4.5.6.7.8.9.10.11.12.13");
+}
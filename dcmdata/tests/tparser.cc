@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2011-2018, OFFIS e.V.
+ *  Copyright (C) 2011-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -488,3 +488,76 @@ OFTEST(dcmdata_parser_undefinedLengthUNSequence)
         return;
     }
 }
+
+static void testSuspendedReading(const E_TransferSyntax xfer)
+{
+    DcmDataset source;
+    OFCHECK(source.putAndInsertString(DCM_PatientName, "Doe^John").good());
+    OFCHECK(source.putAndInsertString(DCM_PatientID, "12345").good());
+    OFCHECK(source.putAndInsertUint16(DCM_Rows, 512).good());
+    DcmItem *item = NULL;
+    OFCHECK(source.findOrCreateSequenceItem(DCM_ProcedureCodeSequence, item).good());
+    if (item)
+        OFCHECK(item->putAndInsertString(DCM_CodeValue, "ABC").good());
+    const Uint8 pixels[6] = { VALUE, VALUE, VALUE, VALUE, VALUE, VALUE };
+    OFCHECK(source.putAndInsertUint8Array(DCM_PixelData, pixels, sizeof(pixels)).good());
+
+    // write the dataset with undefined length sequences and items, so that
+    // the stream also contains item and delimitation items
+    OFVector<Uint8> buffer(4096);
+    DcmOutputBufferStream out(&buffer[0], buffer.size());
+    source.transferInit();
+    OFCondition cond = source.write(out, xfer, EET_UndefinedLength, NULL);
+    source.transferEnd();
+    void *outBuffer;
+    offile_off_t outLength;
+    out.flushBuffer(outBuffer, outLength);
+    if (cond.bad())
+    {
+        OFCHECK_FAIL("Writing should have worked, but got error: " << cond.text());
+        return;
+    }
+
+    // read the dataset again in small chunks, so that element headers are
+    // split across several buffers and the parser has to suspend
+    const Uint8 *data = OFstatic_cast(const Uint8 *, outBuffer);
+    for (offile_off_t chunkSize = 2; chunkSize <= 10; chunkSize += 2)
+    {
+        DcmDataset dset;
+        DcmInputBufferStream stream;
+        offile_off_t pos = 0;
+        dset.transferInit();
+        do
+        {
+            const offile_off_t len = (outLength - pos < chunkSize) ? (outLength - pos) : chunkSize;
+            stream.setBuffer(data + pos, len);
+            pos += len;
+            if (pos == outLength)
+                stream.setEos();
+            cond = dset.read(stream, xfer);
+            stream.releaseBuffer();
+        } while ((cond == EC_StreamNotifyClient) && (pos < outLength));
+        dset.transferEnd();
+        if (cond.bad())
+        {
+            OFCHECK_FAIL("Parsing with chunk size " << chunkSize << " should have worked, but got error: " << cond.text());
+            continue;
+        }
+        OFString value;
+        OFCHECK(dset.findAndGetOFString(DCM_PatientName, value).good());
+        OFCHECK_EQUAL(value, "Doe^John");
+        OFCHECK(dset.findAndGetOFString(DCM_CodeValue, value, 0, OFTrue).good());
+        OFCHECK_EQUAL(value, "ABC");
+        Uint16 rows = 0;
+        OFCHECK(dset.findAndGetUint16(DCM_Rows, rows).good());
+        OFCHECK_EQUAL(rows, 512);
+        OFCHECK_EQUAL(dset.card(), source.card());
+    }
+}
+
+OFTEST(dcmdata_parser_suspendedReading)
+{
+    testSuspendedReading(EXS_LittleEndianImplicit);
+    testSuspendedReading(EXS_LittleEndianExplicit);
+    testSuspendedReading(EXS_BigEndianExplicit);
+}
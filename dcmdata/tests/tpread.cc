@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -33,6 +33,7 @@
 #include "dcmtk/dcmdata/dcostrmz.h"    /* for dcmZlibCompressionLevel */
 #include "dcmtk/dcmdata/dcistrmz.h"    /* for dcmZlibExpectRFC1950Encoding */
 #include "dcmtk/dcmdata/dcfcache.h"
+#include "dcmtk/dcmdata/dcjson.h"      /* for DcmJsonFormatCompact */
 
 #ifdef WITH_ZLIB
 #include <zlib.h>        /* for zlibVersion() */
@@ -412,3 +413,73 @@ OFTEST(dcmdata_partialElementAccess)
 #endif
     delete[] buffer;
 }
+
+OFTEST(dcmdata_bulkDataAccess)
+{
+    /* make sure data dictionary is loaded */
+    if (!dcmDataDict.isDictionaryLoaded())
+    {
+      OFCHECK_FAIL("no data dictionary loaded, check environment variable: " DCM_DICT_ENVIRONMENT_VARIABLE);
+      return;
+    }
+
+    OFRandom rnd;
+    DcmFileFormat dfile;
+
+    unsigned char *buffer = new unsigned char[BUFSIZE];
+    unsigned char *bufptr = buffer;
+    for (int i = BUFSIZE; i; --i)
+    {
+      *bufptr++ = OFstatic_cast(unsigned char, rnd.getRND32());
+    }
+
+    createTestDataset(dfile.getDataset(), buffer);
+    OFCHECK(dfile.saveFile("test_bulk.dcm", EXS_BigEndianExplicit).good());
+
+    DcmFileFormat dfile_bulk;
+    OFCHECK(dfile_bulk.loadFileWithBulkData("test_bulk.dcm", 1024).good());
+    DcmDataset *dset = dfile_bulk.getDataset();
+
+    // the large values remain in file and know their location
+    DcmElement *delem = NULL;
+    OFFilename filename;
+    offile_off_t offset = 0;
+    OFCHECK(dset->findAndGetElement(DCM_EncapsulatedDocument, delem).good());
+    OFCHECK(delem != NULL && !delem->valueLoaded());
+    OFCHECK(delem != NULL && delem->getValueFileReference(filename, offset));
+    OFCHECK_EQUAL(OFString(filename.getCharPointer()), "test_bulk.dcm");
+    OFCHECK(offset > 0);
+
+    // all values are read through the shared file handle
+    OFCondition cond = sequentialNonOverlappingRead(rnd, dset, buffer);
+    if (cond.bad()) { OFCHECK_FAIL(cond.text()); }
+    cond = randomRead(rnd, dset, buffer);
+    if (cond.bad()) { OFCHECK_FAIL(cond.text()); }
+
+    // writing does not load the values into memory
+    OFCHECK(dfile_bulk.saveFile("test_bulk2.dcm", EXS_LittleEndianExplicit).good());
+    OFOStringStream json;
+    OFCHECK(dset->writeJson(json, DcmJsonFormatCompact()).good());
+    json << OFStringStream_ends;
+    OFCHECK(!delem->valueLoaded());
+
+    // compare with the output created from a dataset in memory
+    DcmFileFormat dfile_copy;
+    OFCHECK(dfile_copy.loadFile("test_bulk2.dcm").good());
+    OFCHECK(dfile_copy.loadAllDataIntoMemory().good());
+    cond = sequentialNonOverlappingRead(rnd, dfile_copy.getDataset(), buffer);
+    if (cond.bad()) { OFCHECK_FAIL(cond.text()); }
+    OFOStringStream json_copy;
+    OFCHECK(dfile_copy.getDataset()->writeJson(json_copy, DcmJsonFormatCompact()).good());
+    json_copy << OFStringStream_ends;
+    OFSTRINGSTREAM_GETOFSTRING(json, json_str)
+    OFSTRINGSTREAM_GETOFSTRING(json_copy, json_copy_str)
+    OFCHECK_EQUAL(json_str, json_copy_str);
+
+    // release all references to the files before deleting them
+    dfile_bulk.clear();
+    dfile_copy.clear();
+    unlink("test_bulk.dcm");
+    unlink("test_bulk2.dcm");
+    delete[] buffer;
+}
@@ -0,0 +1,155 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: tests for the RLE encoder and decoder
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcrleenc.h"
+#include "dcmtk/dcmdata/dcrledec.h"
+#include "dcmtk/dcmdata/dcrleerg.h"
+#include "dcmtk/dcmdata/dcrledrg.h"
+
+
+/* fill the buffer with a mixture of long and short replicate runs and literal runs */
+static void fillBuffer(Uint8 *buffer, const size_t size)
+{
+  size_t i = 0;
+  Uint32 seed = 42;
+  while (i < size)
+  {
+    seed = seed * 1103515245 + 12345;
+    const size_t mode = (seed >> 16) % 4;
+    const size_t length = 1 + (seed >> 8) % ((mode == 0) ? 1000 : 200);
+    for (size_t j = 0; (j < length) && (i < size); ++j, ++i)
+    {
+      if (mode == 3)
+        buffer[i] = OFstatic_cast(Uint8, i * 7 + j);
+      else if (mode == 2)
+        buffer[i] = OFstatic_cast(Uint8, (seed >> 24) + (j & 1));
+      else
+        buffer[i] = OFstatic_cast(Uint8, seed >> 24);
+    }
+  }
+}
+
+
+OFTEST(dcmdata_rleEncoderDecoder)
+{
+  const size_t size = 100000;
+  Uint8 *buffer = new Uint8[size];
+  fillBuffer(buffer, size);
+
+  // adding a block must give the same result as adding single bytes
+  DcmRLEEncoder blockEncoder(1);
+  DcmRLEEncoder byteEncoder(1);
+  blockEncoder.add(buffer, size);
+  blockEncoder.flush();
+  for (size_t i = 0; i < size; ++i) byteEncoder.add(buffer[i]);
+  byteEncoder.flush();
+  OFCHECK(!blockEncoder.fail());
+  OFCHECK_EQUAL(blockEncoder.size(), byteEncoder.size());
+  OFCHECK_EQUAL(blockEncoder.size() % 2, 0);
+
+  Uint8 *blockData = new Uint8[blockEncoder.size()];
+  Uint8 *byteData = new Uint8[byteEncoder.size()];
+  blockEncoder.write(blockData);
+  byteEncoder.write(byteData);
+  OFCHECK(memcmp(blockData, byteData, blockEncoder.size()) == 0);
+
+  // decompressing must restore the original data. A zero pad byte at the end
+  // of the stream starts a literal run, which results in EC_StreamNotifyClient.
+  DcmRLEDecoder decoder(size);
+  OFCondition result = decoder.decompress(blockData, blockEncoder.size());
+  OFCHECK(result.good() || (result == EC_StreamNotifyClient));
+  OFCHECK_EQUAL(decoder.size(), size);
+  OFCHECK(memcmp(decoder.getOutputBuffer(), buffer, size) == 0);
+
+  // also if the compressed data is passed in several blocks
+  decoder.clear();
+  for (size_t offset = 0; offset < blockEncoder.size(); offset += 333)
+  {
+    const size_t count = (blockEncoder.size() - offset < 333) ? blockEncoder.size() - offset : 333;
+    result = decoder.decompress(blockData + offset, count);
+    OFCHECK(result.good() || (result == EC_StreamNotifyClient));
+  }
+  OFCHECK_EQUAL(decoder.size(), size);
+  OFCHECK(memcmp(decoder.getOutputBuffer(), buffer, size) == 0);
+
+  delete[] blockData;
+  delete[] byteData;
+  delete[] buffer;
+}
+
+
+/* compress and decompress a two frame RGB image with 16 bits per sample,
+ * i.e.\ six RLE segments per frame, using the given number of threads
+ */
+static void testRLECodec(const Uint32 numberOfThreads, const Uint16 planarConfiguration)
+{
+  const Uint16 rows = 37;
+  const Uint16 columns = 53;
+  const size_t size = OFstatic_cast(size_t, rows) * columns * 3 * 2 * 2;
+  Uint8 *buffer = new Uint8[size];
+  fillBuffer(buffer, size);
+
+  DcmRLEEncoderRegistration::registerCodecs(OFFalse, 0, OFTrue, OFFalse, numberOfThreads);
+  DcmRLEDecoderRegistration::registerCodecs(OFFalse, OFFalse, numberOfThreads);
+
+  DcmDataset dataset;
+  OFCHECK(dataset.putAndInsertUint16(DCM_Rows, rows).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_Columns, columns).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_SamplesPerPixel, 3).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_PlanarConfiguration, planarConfiguration).good());
+  OFCHECK(dataset.putAndInsertString(DCM_PhotometricInterpretation, "RGB").good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_BitsAllocated, 16).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_BitsStored, 16).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_HighBit, 15).good());
+  OFCHECK(dataset.putAndInsertUint16(DCM_PixelRepresentation, 0).good());
+  OFCHECK(dataset.putAndInsertString(DCM_NumberOfFrames, "2").good());
+  OFCHECK(dataset.putAndInsertUint16Array(DCM_PixelData, OFreinterpret_cast(Uint16 *, buffer), OFstatic_cast(unsigned long, size / 2)).good());
+
+  OFCHECK(dataset.chooseRepresentation(EXS_RLELossless, NULL).good());
+  OFCHECK(dataset.canWriteXfer(EXS_RLELossless));
+  dataset.removeAllButCurrentRepresentations();
+
+  OFCHECK(dataset.chooseRepresentation(EXS_LittleEndianExplicit, NULL).good());
+  const Uint16 *pixelData = NULL;
+  unsigned long count = 0;
+  OFCHECK(dataset.findAndGetUint16Array(DCM_PixelData, pixelData, &count).good());
+  OFCHECK_EQUAL(count, size / 2);
+  if (pixelData != NULL)
+    OFCHECK(memcmp(pixelData, buffer, size) == 0);
+
+  DcmRLEEncoderRegistration::cleanup();
+  DcmRLEDecoderRegistration::cleanup();
+  delete[] buffer;
+}
+
+
+OFTEST(dcmdata_rleCodec)
+{
+  testRLECodec(1, 0);
+  testRLECodec(1, 1);
+  testRLECodec(4, 0);
+  testRLECodec(4, 1);
+}
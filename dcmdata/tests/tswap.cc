@@ -0,0 +1,71 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: tests for the byte order functions
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dcswap.h"
+
+
+/* swap the values of the given width at an unaligned position and compare with a byte-wise reference */
+static void testSwapBytes(const size_t valWidth)
+{
+  const size_t count = 37;
+  Uint8 buffer[count * 12 + 1];
+  Uint8 *data = buffer + 1;
+  size_t i, j;
+  for (i = 0; i < sizeof(buffer); ++i)
+    buffer[i] = OFstatic_cast(Uint8, i * 13 + 5);
+
+  swapBytes(data, OFstatic_cast(Uint32, count * valWidth), valWidth);
+  OFBool ok = OFTrue;
+  for (i = 0; i < count; ++i)
+  {
+    for (j = 0; j < valWidth; ++j)
+    {
+      const size_t original = 1 + i * valWidth + (valWidth - 1 - j);
+      if (data[i * valWidth + j] != OFstatic_cast(Uint8, original * 13 + 5)) ok = OFFalse;
+    }
+  }
+  OFCHECK(ok);
+
+  // bytes following the swapped values are not modified
+  OFCHECK_EQUAL(data[count * valWidth], OFstatic_cast(Uint8, (1 + count * valWidth) * 13 + 5));
+}
+
+
+OFTEST(dcmdata_swapBytes)
+{
+  testSwapBytes(2);
+  testSwapBytes(4);
+  testSwapBytes(6);
+  testSwapBytes(8);
+
+  // swapping twice restores the original data
+  Uint16 words[3] = { 0x1234, 0xabcd, 0x00ff };
+  OFCHECK(swapIfNecessary(EBO_BigEndian, EBO_LittleEndian, words, sizeof(words), sizeof(Uint16)).good());
+  OFCHECK_EQUAL(words[0], 0x3412);
+  OFCHECK_EQUAL(words[2], 0xff00);
+  OFCHECK(swapIfNecessary(EBO_LittleEndian, EBO_BigEndian, words, sizeof(words), sizeof(Uint16)).good());
+  OFCHECK_EQUAL(words[1], 0xabcd);
+  OFCHECK(swapIfNecessary(EBO_unknown, EBO_BigEndian, words, sizeof(words), sizeof(Uint16)).bad());
+}
@@ -0,0 +1,144 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmdata
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: tests for the zlib compression filters
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+
+#ifdef WITH_ZLIB
+
+#include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/dcmdata/dcostrmb.h"
+#include "dcmtk/dcmdata/dcistrmb.h"
+#include "dcmtk/dcmdata/dcostrmz.h"
+
+
+/* create a dataset with about one megabyte of partly compressible pixel data */
+static void createDataset(DcmDataset& dataset, Uint8 *pixelData, const size_t size)
+{
+  Uint32 seed = 4711;
+  for (size_t i = 0; i < size; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    pixelData[i] = OFstatic_cast(Uint8, ((i / 1000) % 2) ? (seed >> 28) : (i >> 7));
+  }
+  OFCHECK(dataset.putAndInsertString(DCM_SOPClassUID, UID_SecondaryCaptureImageStorage).good());
+  OFCHECK(dataset.putAndInsertString(DCM_SOPInstanceUID, "1.2.276.0.7230010.3.1.4.1").good());
+  OFCHECK(dataset.putAndInsertString(DCM_PatientName, "Doe^John").good());
+  OFCHECK(dataset.putAndInsertUint8Array(DCM_PixelData, pixelData, OFstatic_cast(unsigned long, size)).good());
+}
+
+
+/* write the dataset with deflate compression through a small buffer stream
+ * in the same way as the DIMSE layer does and return the compressed stream
+ */
+static void writeDeflated(DcmDataset& dataset, const Uint32 numberOfThreads, OFString& stream)
+{
+  char buffer[4096];
+  DcmOutputBufferStream outStream(buffer, sizeof(buffer));
+  OFBool written = OFFalse;
+  OFBool last = OFFalse;
+  dcmZlibCompressionThreads.set(numberOfThreads);
+  dataset.transferInit();
+  stream.clear();
+  while (!last)
+  {
+    if (!written)
+    {
+      OFCondition result = dataset.write(outStream, EXS_DeflatedLittleEndianExplicit, EET_ExplicitLength, NULL);
+      OFCHECK(result.good() || (result == EC_StreamNotifyClient));
+      if (result.good()) written = OFTrue;
+      else if (result != EC_StreamNotifyClient) break;
+    }
+    if (written) outStream.flush();
+    void *data = NULL;
+    offile_off_t length = 0;
+    outStream.flushBuffer(data, length);
+    stream.append(OFstatic_cast(const char *, data), OFstatic_cast(size_t, length));
+    last = written && outStream.isFlushed();
+  }
+  dataset.transferEnd();
+  dcmZlibCompressionThreads.set(1);
+}
+
+
+/* read a deflate compressed dataset from the given stream */
+static OFCondition readDeflated(DcmDataset& dataset, const OFString& stream)
+{
+  DcmInputBufferStream inStream;
+  inStream.setBuffer(stream.data(), OFstatic_cast(offile_off_t, stream.size()));
+  inStream.setEos();
+  dataset.transferInit();
+  OFCondition result = dataset.read(inStream, EXS_DeflatedLittleEndianExplicit);
+  dataset.transferEnd();
+  inStream.releaseBuffer();
+  return result;
+}
+
+
+OFTEST(dcmdata_zlibParallelOutputFilter)
+{
+  const size_t size = 1000000;
+  Uint8 *pixelData = new Uint8[size];
+  DcmDataset dataset;
+  createDataset(dataset, pixelData, size);
+
+  OFString serialStream;
+  OFString parallelStream;
+  writeDeflated(dataset, 1, serialStream);
+  writeDeflated(dataset, 4, parallelStream);
+  OFCHECK(serialStream.size() > 0);
+  OFCHECK(serialStream.size() < size);
+  OFCHECK(parallelStream.size() > 0);
+  OFCHECK(parallelStream.size() < size);
+
+  // both streams must decompress to the original dataset
+  const OFString *streams[2] = { &serialStream, &parallelStream };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    DcmDataset result;
+    OFCHECK(readDeflated(result, *streams[i]).good());
+    OFString value;
+    OFCHECK(result.findAndGetOFString(DCM_PatientName, value).good());
+    OFCHECK_EQUAL(value, "Doe^John");
+    const Uint8 *resultData = NULL;
+    unsigned long count = 0;
+    OFCHECK(result.findAndGetUint8Array(DCM_PixelData, resultData, &count).good());
+    OFCHECK_EQUAL(count, size);
+    if ((resultData != NULL) && (count == size))
+      OFCHECK(memcmp(resultData, pixelData, size) == 0);
+  }
+
+  // a dataset smaller than a single block must also work
+  DcmDataset smallDataset;
+  OFCHECK(smallDataset.putAndInsertString(DCM_PatientName, "Doe^Jane").good());
+  writeDeflated(smallDataset, 4, parallelStream);
+  DcmDataset smallResult;
+  OFCHECK(readDeflated(smallResult, parallelStream).good());
+  OFString value;
+  OFCHECK(smallResult.findAndGetOFString(DCM_PatientName, value).good());
+  OFCHECK_EQUAL(value, "Doe^Jane");
+
+  delete[] pixelData;
+}
+
+#endif /* WITH_ZLIB */
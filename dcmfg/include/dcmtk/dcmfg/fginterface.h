@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2019, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -39,6 +39,15 @@ class IODMultiframeDimensionModule;
 /** Main interface class to access functional groups from DICOM Enhanced
  *  objects. Allows reading, modifying and writing functional groups back
  *  and forth from DICOM datasets.
+ *  Per-frame functional groups read from a dataset are kept in a compact
+ *  form: Identical groups (e.g.\ a Pixel Measures group that is the same for
+ *  all frames but not stored as shared group) are stored only once, and
+ *  frames only refer to them. The FGBase objects of a frame are created on
+ *  first access (e.g.\ by get() or getPerFrame()). Frames that are never
+ *  accessed are written back without being converted to FGBase objects at
+ *  all. Image Position (Patient) and Dimension Index Values of such frames
+ *  can be accessed directly (see getImagePositionPatient() and
+ *  getDimensionIndexValues()).
  */
 class DCMTK_DCMFG_EXPORT FGInterface
 {
@@ -137,6 +146,35 @@ public:
    */
   const FunctionalGroups* getShared() const;
 
+  /** Get Image Position (Patient) for a frame, no matter whether the Plane
+   *  Position (Patient) functional group is stored per frame or shared.
+   *  For frames that have been read but not yet accessed otherwise, the
+   *  values are taken from a contiguous array filled while reading, i.e.\
+   *  without creating any functional group objects.
+   *  @param  frameNo The frame number of interest (starts from 0)
+   *  @param  coordinateX X coordinate of upper left hand corner voxel in mm
+   *  @param  coordinateY Y coordinate of upper left hand corner voxel in mm
+   *  @param  coordinateZ Z coordinate of upper left hand corner voxel in mm
+   *  @return EC_Normal if successful, FG_EC_NoSuchGroup if there is no Plane
+   *          Position (Patient) functional group for the frame, other error
+   *          otherwise
+   */
+  virtual OFCondition getImagePositionPatient(const Uint32 frameNo,
+                                              Float64& coordinateX,
+                                              Float64& coordinateY,
+                                              Float64& coordinateZ);
+
+  /** Get all Dimension Index Values of the Frame Content functional group for
+   *  a frame. For frames that have been read but not yet accessed otherwise,
+   *  the values are taken from a contiguous array filled while reading.
+   *  @param  frameNo The frame number of interest (starts from 0)
+   *  @param  values Vector receiving the values (cleared before)
+   *  @return EC_Normal if successful, FG_EC_NoSuchGroup if there is no Frame
+   *          Content functional group for the frame, other error otherwise
+   */
+  virtual OFCondition getDimensionIndexValues(const Uint32 frameNo,
+                                              OFVector<Uint32>& values);
+
   /** Add functional group that should be shared for all frames. This will
    *  delete all per-frame groups of the same type if existing.
    *  @param  group   The group to be added. The group is copied.
@@ -300,18 +338,95 @@ protected:
    */
   virtual OFCondition convertSharedToPerFrame(const DcmFGTypes::E_FGType fgType);
 
+  /** Check whether the functional groups of the given frame are still only
+   *  available in the compact form created while reading
+   *  @param  frameNo The frame number to check
+   *  @return OFTrue if no FGBase objects have been created for the frame yet
+   */
+  OFBool isCompactFrame(const Uint32 frameNo) const;
+
+  /** Create the FGBase objects for a frame that is still in compact form.
+   *  Does nothing if the frame is not in compact form.
+   *  @param  frameNo The frame number of the functional groups to be created
+   */
+  void materializeFrame(const Uint32 frameNo) const;
+
+  /** Remove all per-frame functional groups in compact form
+   */
+  void clearCompactFrames();
+
+  /** Check a single per-frame functional group, used by check()
+   *  @param  frameNo The frame number the group belongs to
+   *  @param  groupType The type of the functional group
+   *  @param  sharedType Whether the group may be shared, per-frame or both
+   *  @param  foundFrameContent Set to OFTrue if the group is a Frame Content
+   *          functional group, left unchanged otherwise
+   *  @param  numErrors Increased by the number of errors found
+   */
+  void checkPerFrameGroup(const Uint32 frameNo,
+                          const DcmFGTypes::E_FGType groupType,
+                          const DcmFGTypes::E_FGSharedType sharedType,
+                          OFBool& foundFrameContent,
+                          size_t& numErrors);
+
 private:
 
   /// Shared functional groups
   FunctionalGroups m_shared;
 
   /// Link from frame number (map key) to the list of functional groups (value)
-  /// relevant for the frame
-  PerFrameGroups m_perFrame;
+  /// relevant for the frame. Frames in compact form are added on first access
+  /// (also from const methods).
+  mutable PerFrameGroups m_perFrame;
 
   /// If enabled, functional group structure is checked on write(). Otherwise,
   /// checks are skipped.
   OFBool m_checkOnWrite;
+
+  /// A unique per-frame functional group as read from the dataset
+  struct CompactGroup
+  {
+    /// Item containing (a copy of) the functional group sequence only
+    DcmItem* m_item;
+
+    /// Type of the functional group as created by the factory
+    DcmFGTypes::E_FGType m_type;
+
+    /// Whether the functional group may be shared, per-frame or both
+    DcmFGTypes::E_FGSharedType m_sharedType;
+  };
+
+  /// Unique per-frame functional groups read from the dataset, frames in
+  /// compact form refer to these by index
+  OFVector<CompactGroup> m_compactGroups;
+
+  /// Indices into m_compactGroups for all frames read. The groups of frame i
+  /// are found at positions m_compactFrameStart[i] to
+  /// m_compactFrameStart[i+1]-1.
+  OFVector<Uint32> m_compactFrameGroups;
+
+  /// Start position of each frame in m_compactFrameGroups (plus end marker)
+  OFVector<size_t> m_compactFrameStart;
+
+  /// For each frame read: OFTrue if the frame is still in compact form, i.e.\ it
+  /// has not been materialized into m_perFrame (or deleted) yet
+  mutable OFVector<OFBool> m_compactPending;
+
+  /// Number of frames still in compact form
+  mutable size_t m_numCompactPending;
+
+  /// Image Position (Patient) for each frame read (three values per frame)
+  OFVector<Float64> m_compactPositions;
+
+  /// For each frame read: OFTrue if m_compactPositions contains valid values
+  OFVector<OFBool> m_compactHasPosition;
+
+  /// Dimension Index Values of all frames read. The values of frame i are found
+  /// at positions m_compactDimIndexStart[i] to m_compactDimIndexStart[i+1]-1.
+  OFVector<Uint32> m_compactDimIndexValues;
+
+  /// Start position of each frame in m_compactDimIndexValues (plus end marker)
+  OFVector<size_t> m_compactDimIndexStart;
 };
 
 #endif // MODMULTIFRAMEFGH_H
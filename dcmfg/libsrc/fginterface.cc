@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2019, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -26,12 +26,25 @@
 #include "dcmtk/dcmfg/fginterface.h"
 #include "dcmtk/dcmfg/fg.h"
 #include "dcmtk/dcmfg/fgfact.h"   // for creating new functional groups
+#include "dcmtk/dcmfg/fgfracon.h"
+#include "dcmtk/dcmfg/fgplanpo.h"
+#include "dcmtk/dcmdata/dcostrmb.h"
+#include "dcmtk/dcmdata/dcwcache.h"
 
 
 FGInterface::FGInterface() :
 m_shared(),
 m_perFrame(),
-m_checkOnWrite(OFTrue)
+m_checkOnWrite(OFTrue),
+m_compactGroups(),
+m_compactFrameGroups(),
+m_compactFrameStart(),
+m_compactPending(),
+m_numCompactPending(0),
+m_compactPositions(),
+m_compactHasPosition(),
+m_compactDimIndexValues(),
+m_compactDimIndexStart()
 {
 }
 
@@ -53,14 +66,37 @@ void FGInterface::clear()
     delete fg;
   }
 
+  // Clear per-frame functional groups not materialized yet
+  clearCompactFrames();
+
   // Clear shared functional groups
   m_shared.clear();
 }
 
 
+void FGInterface::clearCompactFrames()
+{
+  OFVector<CompactGroup>::iterator it = m_compactGroups.begin();
+  while (it != m_compactGroups.end())
+  {
+    delete (*it).m_item;
+    it++;
+  }
+  m_compactGroups.clear();
+  m_compactFrameGroups.clear();
+  m_compactFrameStart.clear();
+  m_compactPending.clear();
+  m_numCompactPending = 0;
+  m_compactPositions.clear();
+  m_compactHasPosition.clear();
+  m_compactDimIndexValues.clear();
+  m_compactDimIndexStart.clear();
+}
+
+
 size_t FGInterface::getNumberOfFrames()
 {
-  return m_perFrame.size();
+  return m_perFrame.size() + m_numCompactPending;
 }
 
 
@@ -74,7 +110,8 @@ OFCondition FGInterface::addShared(const FGBase& group)
   }
 
   // Delete all per frame groups of this type
-  for (size_t count = 0; count < m_perFrame.size(); count++)
+  const size_t numFrames = getNumberOfFrames();
+  for (size_t count = 0; count < numFrames; count++)
   {
     deletePerFrame(OFstatic_cast(Uint32, count), group.getType());
   }
@@ -160,14 +197,13 @@ FGBase* FGInterface::get(const Uint32 frameNo,
 
 const FunctionalGroups* FGInterface::getPerFrame(const Uint32 frameNo) const
 {
- if (frameNo > m_perFrame.size())
- {
-   return NULL;
- }
- else
- {
-   return (*(m_perFrame.find(frameNo))).second;
- }
+  materializeFrame(frameNo);
+  OFMap<Uint32, FunctionalGroups*>::const_iterator it = m_perFrame.find(frameNo);
+  if (it == m_perFrame.end())
+  {
+    return NULL;
+  }
+  return (*it).second;
 }
 
 
@@ -177,6 +213,60 @@ const FunctionalGroups* FGInterface::getShared() const
 }
 
 
+OFCondition FGInterface::getImagePositionPatient(const Uint32 frameNo,
+                                                 Float64& coordinateX,
+                                                 Float64& coordinateY,
+                                                 Float64& coordinateZ)
+{
+  // Fast path: frame not materialized yet, use values stored while reading
+  if (isCompactFrame(frameNo) && m_compactHasPosition[frameNo])
+  {
+    coordinateX = m_compactPositions[3 * frameNo];
+    coordinateY = m_compactPositions[3 * frameNo + 1];
+    coordinateZ = m_compactPositions[3 * frameNo + 2];
+    return EC_Normal;
+  }
+  FGBase* group = get(frameNo, DcmFGTypes::EFG_PLANEPOSPATIENT);
+  if (group == NULL)
+  {
+    return FG_EC_NoSuchGroup;
+  }
+  return OFstatic_cast(FGPlanePosPatient*, group)->getImagePositionPatient(coordinateX, coordinateY, coordinateZ);
+}
+
+
+OFCondition FGInterface::getDimensionIndexValues(const Uint32 frameNo,
+                                                 OFVector<Uint32>& values)
+{
+  values.clear();
+  // Fast path: frame not materialized yet, use values stored while reading
+  if (isCompactFrame(frameNo))
+  {
+    const size_t start = m_compactDimIndexStart[frameNo];
+    const size_t end = m_compactDimIndexStart[frameNo + 1];
+    if (start < end)
+    {
+      values.reserve(end - start);
+      for (size_t pos = start; pos < end; pos++)
+        values.push_back(m_compactDimIndexValues[pos]);
+      return EC_Normal;
+    }
+  }
+  FGBase* group = get(frameNo, DcmFGTypes::EFG_FRAMECONTENT);
+  if (group == NULL)
+  {
+    return FG_EC_NoSuchGroup;
+  }
+  FGFrameContent* frameContent = OFstatic_cast(FGFrameContent*, group);
+  Uint32 value = 0;
+  for (signed long pos = 0; frameContent->getDimensionIndexValues(value, pos).good(); pos++)
+  {
+    values.push_back(value);
+  }
+  return EC_Normal;
+}
+
+
 // Read enhanced multi-frame information from DICOM item, usually DcmDataset
 OFCondition FGInterface::read(DcmItem& dataset)
 {
@@ -233,6 +323,29 @@ OFCondition FGInterface::readSharedFG(DcmItem& dataset)
 
 
 
+/* Encode functional group sequence into a string that is used for detecting
+ * identical groups of different frames
+ */
+static OFBool encodeFunctionalGroup(DcmElement& fgSequence,
+                                    DcmWriteCache& wcache,
+                                    OFString& encoded)
+{
+  const E_TransferSyntax xfer = EXS_LittleEndianExplicit;
+  const Uint32 length = fgSequence.calcElementLength(xfer, EET_ExplicitLength);
+  if ((length == 0) || (length == DCM_UndefinedLength))
+    return OFFalse;
+  OFVector<char> buffer(length);
+  DcmOutputBufferStream outStream(&buffer[0], length);
+  fgSequence.transferInit();
+  OFCondition result = fgSequence.write(outStream, xfer, EET_ExplicitLength, &wcache);
+  fgSequence.transferEnd();
+  if (result.bad() || (outStream.filled() != OFstatic_cast(offile_off_t, length)))
+    return OFFalse;
+  encoded.assign(&buffer[0], length);
+  return OFTrue;
+}
+
+
 OFCondition FGInterface::readPerFrameFG(DcmItem& dataset)
 {
   /* read per-frame functional groups */
@@ -252,42 +365,159 @@ OFCondition FGInterface::readPerFrameFG(DcmItem& dataset)
     return FG_EC_NoPerFrameFG;
   }
 
+  /* The functional groups are not converted to FGBase objects here but
+   * stored in compact form: Identical groups are kept only once, and the
+   * frames only refer to them. FGBase objects are created on first access.
+   */
+  clearCompactFrames();
+  m_compactFrameStart.reserve(numFrames + 1);
+  m_compactPending.reserve(numFrames);
+  m_compactPositions.resize(3 * numFrames, 0.0);
+  m_compactHasPosition.resize(numFrames, OFFalse);
+  m_compactDimIndexStart.reserve(numFrames + 1);
+  // Used for detecting identical groups, only needed while reading
+  OFMap<OFString, Uint32> knownGroups;
+  // Group type and shared type for each functional group sequence tag
+  OFMap<DcmTagKey, OFPair<DcmFGTypes::E_FGType, DcmFGTypes::E_FGSharedType> > knownTypes;
+  DcmWriteCache wcache;
+  OFString encoded;
+
   /* Read functional groups for each item (one per frame) */
   DcmItem *oneFrameItem = OFstatic_cast(DcmItem*, perFrame->nextInContainer(NULL));
   Uint32 count = 0;
   while (oneFrameItem != NULL)
   {
-    OFunique_ptr<FunctionalGroups> perFrameGroups(new FunctionalGroups());
-    if (!oneFrameItem)
-    {
-      DCMFG_ERROR("Could not get functional group item for frame #" << count << " (internal error)");
-    }
-    else if (!perFrameGroups.get())
+    const size_t frameStart = m_compactFrameGroups.size();
+    m_compactFrameStart.push_back(frameStart);
+    m_compactDimIndexStart.push_back(m_compactDimIndexValues.size());
+    const size_t card = oneFrameItem->card();
+    for (size_t elemCount = 0; elemCount < card; elemCount++)
     {
-      DCMFG_ERROR("Could not create functional groups for frame #" << count << ": Memory exhausted?");
-    }
-    else
-    {
-      result = readSingleFG(*oneFrameItem, *perFrameGroups);
-      if (result.good())
+      DcmElement *elem = oneFrameItem->getElement(OFstatic_cast(unsigned long, elemCount));
+      if (elem->getVR() != EVR_SQ)
       {
-        if ( !m_perFrame.insert( OFMake_pair(count, perFrameGroups.release()) ).second )
+        DCMFG_WARN("Found non-sequence element in functional group sequence item (ignored): " << elem->getTag());
+        continue;
+      }
+      // Determine group type the same way as the factory would do
+      OFMap<DcmTagKey, OFPair<DcmFGTypes::E_FGType, DcmFGTypes::E_FGSharedType> >::iterator type = knownTypes.find(elem->getTag());
+      if (type == knownTypes.end())
+      {
+        FGBase *fg = FGFactory::instance().create(elem->getTag());
+        if (fg == NULL)
         {
-          DCMFG_ERROR("Could not store functional groups for frame #" << count << " (internal error)");
+          DCMFG_WARN("Cannot understand functional group for sequence tag: " << elem->getTag());
+          continue;
         }
+        type = knownTypes.insert(OFMake_pair(elem->getTag(), OFMake_pair(fg->getType(), fg->getSharedType()))).first;
+        delete fg;
+      }
+      // Look for identical group read before (for this or another frame)
+      Uint32 index = OFstatic_cast(Uint32, m_compactGroups.size());
+      OFBool isNew = OFTrue;
+      if (encodeFunctionalGroup(*elem, wcache, encoded))
+      {
+        OFPair<OFMap<OFString, Uint32>::iterator, bool> known = knownGroups.insert(OFMake_pair(encoded, index));
+        isNew = known.second;
+        index = (*known.first).second;
+      }
+      if (isNew)
+      {
+        CompactGroup group;
+        group.m_item = new DcmItem();
+        group.m_item->insert(OFstatic_cast(DcmElement*, elem->clone()));
+        group.m_type = (*type).second.first;
+        group.m_sharedType = (*type).second.second;
+        m_compactGroups.push_back(group);
       }
+      // A group of the same type replaces the one read before (as for FunctionalGroups::insert())
+      size_t pos = frameStart;
+      while ((pos < m_compactFrameGroups.size()) && (m_compactGroups[m_compactFrameGroups[pos]].m_type != m_compactGroups[index].m_type))
+        pos++;
+      if (pos < m_compactFrameGroups.size())
+        m_compactFrameGroups[pos] = index;
       else
+        m_compactFrameGroups.push_back(index);
+    }
+    // Store numeric values of frequently used attributes in contiguous arrays
+    for (size_t pos = frameStart; pos < m_compactFrameGroups.size(); pos++)
+    {
+      const CompactGroup& group = m_compactGroups[m_compactFrameGroups[pos]];
+      if (group.m_type == DcmFGTypes::EFG_PLANEPOSPATIENT)
+      {
+        m_compactHasPosition[count] =
+          group.m_item->findAndGetFloat64(DCM_ImagePositionPatient, m_compactPositions[3 * count], 0, OFTrue).good() &&
+          group.m_item->findAndGetFloat64(DCM_ImagePositionPatient, m_compactPositions[3 * count + 1], 1, OFTrue).good() &&
+          group.m_item->findAndGetFloat64(DCM_ImagePositionPatient, m_compactPositions[3 * count + 2], 2, OFTrue).good();
+      }
+      else if (group.m_type == DcmFGTypes::EFG_FRAMECONTENT)
       {
-        DCMFG_ERROR("Could not read functional groups for frame #" << count << ": " << result.text());
+        DcmElement *dimIndex = NULL;
+        if (group.m_item->findAndGetElement(DCM_DimensionIndexValues, dimIndex, OFTrue).good())
+        {
+          Uint32 value = 0;
+          const unsigned long vm = dimIndex->getVM();
+          for (unsigned long i = 0; (i < vm) && dimIndex->getUint32(value, i).good(); i++)
+            m_compactDimIndexValues.push_back(value);
+        }
       }
     }
+    m_compactPending.push_back(OFTrue);
     oneFrameItem = OFstatic_cast(DcmItem*, perFrame->nextInContainer(oneFrameItem));
     count++;
   }
+  m_compactFrameStart.push_back(m_compactFrameGroups.size());
+  m_compactDimIndexStart.push_back(m_compactDimIndexValues.size());
+  m_numCompactPending = count;
+  DCMFG_DEBUG("Read " << m_compactFrameGroups.size() << " per-frame functional groups for " << count << " frames, "
+    << m_compactGroups.size() << " of them are unique");
   return EC_Normal; // for now we always return EC_Normal...
 }
 
 
+OFBool FGInterface::isCompactFrame(const Uint32 frameNo) const
+{
+  return (frameNo < m_compactPending.size()) && m_compactPending[frameNo];
+}
+
+
+void FGInterface::materializeFrame(const Uint32 frameNo) const
+{
+  if (!isCompactFrame(frameNo))
+    return;
+  m_compactPending[frameNo] = OFFalse;
+  m_numCompactPending--;
+
+  FunctionalGroups* perFrameGroups = new FunctionalGroups();
+  for (size_t pos = m_compactFrameStart[frameNo]; pos < m_compactFrameStart[frameNo + 1]; pos++)
+  {
+    const CompactGroup& group = m_compactGroups[m_compactFrameGroups[pos]];
+    const DcmTagKey fgTag = group.m_item->getElement(0)->getTag();
+    FGBase *fg = FGFactory::instance().create(fgTag);
+    if (fg == NULL)
+    {
+      DCMFG_ERROR("Could not create functional group for frame #" << frameNo << ": " << fgTag);
+      continue;
+    }
+    if (fg->read(*group.m_item).bad())
+    {
+      DCMFG_WARN("Cannot read functional group: " << DcmFGTypes::tagKey2FGString(fgTag) << " " << fgTag << " (ignored)");
+    }
+    // we also accept groups which could be instantiated but could not be read
+    if (perFrameGroups->insert(fg, OFTrue).bad())
+    {
+      DCMFG_ERROR("Could not insert functional group: " << DcmFGTypes::tagKey2FGString(fgTag) << " " << fgTag << " (internal error)");
+      delete fg;
+    }
+  }
+  if ( !m_perFrame.insert( OFMake_pair(frameNo, perFrameGroups) ).second )
+  {
+    DCMFG_ERROR("Could not store functional groups for frame #" << frameNo << " (internal error)");
+    delete perFrameGroups;
+  }
+}
+
+
 
 OFCondition FGInterface::readSingleFG(DcmItem& fgItem,
                                       FunctionalGroups& groups)
@@ -377,6 +607,7 @@ FGBase* FGInterface::getPerFrame(const Uint32 frameNo,
                                  const DcmFGTypes::E_FGType fgType)
 {
   FGBase* group = NULL;
+  materializeFrame(frameNo);
   OFMap<Uint32, FunctionalGroups*>::iterator it = m_perFrame.find(frameNo);
   if ( it != m_perFrame.end() )
   {
@@ -404,6 +635,16 @@ OFBool FGInterface::deleteShared(const DcmFGTypes::E_FGType fgType)
 OFBool FGInterface::deletePerFrame(const Uint32 frameNo,
                                    const DcmFGTypes::E_FGType fgType)
 {
+  if (isCompactFrame(frameNo))
+  {
+    // Only create the frame's FGBase objects if there is something to delete
+    size_t pos = m_compactFrameStart[frameNo];
+    while ((pos < m_compactFrameStart[frameNo + 1]) && (m_compactGroups[m_compactFrameGroups[pos]].m_type != fgType))
+      pos++;
+    if (pos == m_compactFrameStart[frameNo + 1])
+      return OFFalse;
+    materializeFrame(frameNo);
+  }
   OFMap<Uint32, FunctionalGroups*>::iterator it = m_perFrame.find(frameNo);
   if (it != m_perFrame.end())
   {
@@ -426,7 +667,7 @@ OFBool FGInterface::deletePerFrame(const Uint32 frameNo,
 size_t FGInterface::deletePerFrame(const DcmFGTypes::E_FGType fgType)
 {
   size_t numDeleted = 0;
-  const size_t numFrames = m_perFrame.size();
+  const size_t numFrames = getNumberOfFrames();
   for (size_t frameNo = 0; frameNo < numFrames; frameNo++)
   {
     if (deletePerFrame(OFstatic_cast(Uint32, frameNo), fgType))
@@ -440,19 +681,20 @@ size_t FGInterface::deletePerFrame(const DcmFGTypes::E_FGType fgType)
 
 size_t FGInterface::deleteFrame(const Uint32 frameNo)
 {
+  if (isCompactFrame(frameNo))
+  {
+    // The compact representation is simply not used any more for this frame
+    m_compactPending[frameNo] = OFFalse;
+    m_numCompactPending--;
+    return OFFalse;
+  }
   OFMap<Uint32, FunctionalGroups*>::iterator it = m_perFrame.find(frameNo);
   if (it != m_perFrame.end())
   {
-    if ( (*it).second )
-    {
-      FunctionalGroups::iterator fg = (*it).second->begin();
-      while (fg != (*it).second->end())
-      {
-        delete (*fg).second;
-        fg++;
-      }
-    }
+    // deleting the container also deletes all of its functional groups
+    FunctionalGroups* groups = (*it).second;
     m_perFrame.erase(it);
+    delete groups;
   }
   return OFFalse;
 }
@@ -472,6 +714,7 @@ OFBool FGInterface::getCheckOnWrite()
 
 FunctionalGroups* FGInterface::getOrCreatePerFrameGroups(const Uint32 frameNo)
 {
+  materializeFrame(frameNo);
   OFMap<Uint32, FunctionalGroups*>::iterator it = m_perFrame.find(frameNo);
   if (it != m_perFrame.end())
     return (*it).second;
@@ -499,20 +742,50 @@ OFCondition FGInterface::writePerFrameFG(DcmItem& dataset)
 {
   DCMFG_DEBUG("Writing per-frame functional groups");
   OFCondition result = dataset.insertEmptyElement(DCM_PerFrameFunctionalGroupsSequence, OFTrue); // start with empty sequence
+  DcmSequenceOfItems* perFrameSeq = NULL;
+  if (result.good())
+  {
+    result = dataset.findAndGetSequence(DCM_PerFrameFunctionalGroupsSequence, perFrameSeq);
+  }
   if (result.bad())
   {
     DCMFG_ERROR("Could not create Per-frame Functional Groups Sequence");
     return result;
   }
 
-  /* Iterate over frames */
+  /* Iterate over frames in order of their frame numbers. A frame is either
+   * still in compact form or has been materialized, never both.
+   */
   OFMap<Uint32, FunctionalGroups*>::iterator it = m_perFrame.begin();
-  size_t numFrames = m_perFrame.size();
+  Uint32 compactFrame = 0;
+  const Uint32 numCompactFrames = OFstatic_cast(Uint32, m_compactPending.size());
+  while ((compactFrame < numCompactFrames) && !m_compactPending[compactFrame])
+    compactFrame++;
+  size_t numFrames = getNumberOfFrames();
   for ( size_t count = 0; (count < numFrames)  && result.good(); count++)
   {
-    DcmItem* perFrameItem = NULL;
-    result = dataset.findOrCreateSequenceItem(DCM_PerFrameFunctionalGroupsSequence, perFrameItem, OFstatic_cast(long, count));
-    if (result.good())
+    // append new item, much faster than accessing the item by its index
+    DcmItem* perFrameItem = new DcmItem();
+    result = perFrameSeq->append(perFrameItem);
+    if (result.bad())
+    {
+      DCMFG_ERROR("Cannot create item in Per-frame Functional Groups Sequence");
+      delete perFrameItem;
+    }
+    else if ( (compactFrame < numCompactFrames) && ((it == m_perFrame.end()) || (compactFrame < (*it).first)) )
+    {
+      /* Write groups of frame in compact form, i.e. copy the original sequences */
+      DCMFG_DEBUG("Writing per-frame groups (unmodified) for frame #" << count);
+      for (size_t pos = m_compactFrameStart[compactFrame]; result.good() && (pos < m_compactFrameStart[compactFrame + 1]); pos++)
+      {
+        DcmElement* fgSequence = m_compactGroups[m_compactFrameGroups[pos]].m_item->getElement(0);
+        result = perFrameItem->insert(OFstatic_cast(DcmElement*, fgSequence->clone()), OFTrue);
+      }
+      compactFrame++;
+      while ((compactFrame < numCompactFrames) && !m_compactPending[compactFrame])
+        compactFrame++;
+    }
+    else
     {
       /* Iterate over groups for each frame */
       FunctionalGroups::iterator groupIt = (*it).second->begin();
@@ -522,12 +795,8 @@ OFCondition FGInterface::writePerFrameFG(DcmItem& dataset)
         result = (*groupIt).second->write(*perFrameItem);
         groupIt++;
       }
+      it++;
     }
-    else
-    {
-      DCMFG_ERROR("Cannot create item in Per-frame Functional Groups Sequence");
-    }
-    it++;
   }
   return result;
 }
@@ -608,7 +877,7 @@ OFCondition FGInterface::convertSharedToPerFrame(const DcmFGTypes::E_FGType fgTy
   }
 
   OFCondition result;
-  size_t numFrames = m_perFrame.size();
+  size_t numFrames = getNumberOfFrames();
   // Walk over all existing frames and copy "old" shared group to them
   size_t count = 0;
   for (count = 0; result.good() && (count < numFrames); count++)
@@ -652,50 +921,50 @@ FGBase* FGInterface::get(const Uint32 frameNo,
 
 OFBool FGInterface::check()
 {
-  size_t numFrames = m_perFrame.size();
+  size_t numFrames = getNumberOfFrames();
   DCMFG_DEBUG("Checking functional group structure for " << numFrames << " frames");
   size_t numErrors = 0;
-  for (size_t frameCount = 0; frameCount < numFrames; frameCount++)
+  // Check frames in compact form without creating FGBase objects
+  const Uint32 numCompactFrames = OFstatic_cast(Uint32, m_compactPending.size());
+  for (Uint32 frameNo = 0; frameNo < numCompactFrames; frameNo++)
   {
-    DCMFG_TRACE("Checking frame " << frameCount << "...");
+    if (!m_compactPending[frameNo])
+      continue;
+    DCMFG_TRACE("Checking frame " << frameNo << "...");
+    OFBool foundFrameContent = OFFalse;
+    for (size_t pos = m_compactFrameStart[frameNo]; pos < m_compactFrameStart[frameNo + 1]; pos++)
+    {
+      const CompactGroup& group = m_compactGroups[m_compactFrameGroups[pos]];
+      checkPerFrameGroup(frameNo, group.m_type, group.m_sharedType, foundFrameContent, numErrors);
+    }
+    if (!foundFrameContent)
+    {
+      DCMFG_ERROR("Frame Content Functional group missing for frame #" << frameNo);
+      numErrors++;
+    }
+  }
+  // Check all other frames
+  OFMap<Uint32, FunctionalGroups*>::iterator frameFG = m_perFrame.begin();
+  OFMap<Uint32, FunctionalGroups*>::iterator frameEnd = m_perFrame.end();
+  while (frameFG != frameEnd)
+  {
+    const Uint32 frameNo = (*frameFG).first;
+    DCMFG_TRACE("Checking frame " << frameNo << "...");
     // Every frame requires the FrameContent functional group, check "en passant"
     OFBool foundFrameContent = OFFalse;
-    OFMap<Uint32, FunctionalGroups*>::iterator frameFG = m_perFrame.begin();
-    OFMap<Uint32, FunctionalGroups*>::iterator end = m_perFrame.end();
-    while (frameFG != end)
+    FunctionalGroups::iterator group = (*frameFG).second->begin();
+    FunctionalGroups::iterator groupEnd = (*frameFG).second->end();
+    while (group != groupEnd)
     {
-      FunctionalGroups::iterator group = (*frameFG).second->begin();
-      FunctionalGroups::iterator groupEnd = (*frameFG).second->end();
-      while (group != groupEnd)
-      {
-        // Check that per-frame group is not a shared group at the same time
-        DcmFGTypes::E_FGType groupType = group->second->getType();
-        if ( (groupType != DcmFGTypes::EFG_UNDEFINED) &&
-          (groupType != DcmFGTypes::EFG_UNKNOWN) )
-        {
-          if (m_shared.find(groupType) != NULL)
-          {
-            DCMFG_ERROR("Functional group of type " << DcmFGTypes::FGType2OFString(groupType) << " is shared AND per-frame for frame " << frameCount);
-            numErrors++;
-          }
-          if (groupType == DcmFGTypes::EFG_FRAMECONTENT)
-            foundFrameContent = OFTrue;
-        }
-        // Check if "per-frame" is allowed for this group;
-        if (group->second->getSharedType() == DcmFGTypes::EFGS_ONLYSHARED)
-        {
-          DCMFG_ERROR("Functional group of type " << DcmFGTypes::FGType2OFString(groupType) << " can never be per-frame, but found for frame " << frameCount);
-          numErrors++;
-        }
-        group++;
-      }
-      frameFG++;
+      checkPerFrameGroup(frameNo, group->second->getType(), group->second->getSharedType(), foundFrameContent, numErrors);
+      group++;
     }
     if (!foundFrameContent)
     {
-      DCMFG_ERROR("Frame Content Functional group missing for frame #" << frameCount);
+      DCMFG_ERROR("Frame Content Functional group missing for frame #" << frameNo);
       numErrors++;
     }
+    frameFG++;
   }
 
   // Check whether shared groups contain FGs that are only permitted per-frame
@@ -716,3 +985,30 @@ OFBool FGInterface::check()
 
   return OFTrue;
 }
+
+
+void FGInterface::checkPerFrameGroup(const Uint32 frameNo,
+                                     const DcmFGTypes::E_FGType groupType,
+                                     const DcmFGTypes::E_FGSharedType sharedType,
+                                     OFBool& foundFrameContent,
+                                     size_t& numErrors)
+{
+  // Check that per-frame group is not a shared group at the same time
+  if ( (groupType != DcmFGTypes::EFG_UNDEFINED) &&
+    (groupType != DcmFGTypes::EFG_UNKNOWN) )
+  {
+    if (m_shared.find(groupType) != NULL)
+    {
+      DCMFG_ERROR("Functional group of type " << DcmFGTypes::FGType2OFString(groupType) << " is shared AND per-frame for frame " << frameNo);
+      numErrors++;
+    }
+    if (groupType == DcmFGTypes::EFG_FRAMECONTENT)
+      foundFrameContent = OFTrue;
+  }
+  // Check if "per-frame" is allowed for this group;
+  if (sharedType == DcmFGTypes::EFGS_ONLYSHARED)
+  {
+    DCMFG_ERROR("Functional group of type " << DcmFGTypes::FGType2OFString(groupType) << " can never be per-frame, but found for frame " << frameNo);
+    numErrors++;
+  }
+}
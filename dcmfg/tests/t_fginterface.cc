@@ -0,0 +1,138 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmfg
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Tests for compact per-frame storage in FGInterface
+ *
+ */
+
+#include "dcmtk/config/osconfig.h" /* make sure OS specific configuration is included first */
+
+#include "dcmtk/dcmfg/fginterface.h"
+#include "dcmtk/dcmfg/fgfracon.h"
+#include "dcmtk/dcmfg/fgpixmsr.h"
+#include "dcmtk/dcmfg/fgplanor.h"
+#include "dcmtk/dcmfg/fgplanpo.h"
+#include "dcmtk/ofstd/ofcond.h"
+#include "dcmtk/ofstd/oftest.h"
+
+static const Uint32 NUM_FRAMES = 5;
+
+static void create_groups(FGInterface& fg)
+{
+    FGPixelMeasures pixMsr;
+    OFCHECK(pixMsr.setPixelSpacing("0.5\\0.5").good());
+    OFCHECK(fg.addShared(pixMsr).good());
+    // Same orientation for all frames, but stored per-frame
+    FGPlaneOrientationPatient planOr;
+    OFCHECK(planOr.setImageOrientationPatient("1", "0", "0", "0", "1", "0").good());
+    for (Uint32 frameNo = 0; frameNo < NUM_FRAMES; frameNo++)
+    {
+        FGFrameContent fracon;
+        OFCHECK(fracon.setDimensionIndexValues(frameNo + 1, 0).good());
+        OFCHECK(fracon.setDimensionIndexValues(7, 1).good());
+        OFCHECK(fg.addPerFrame(frameNo, fracon).good());
+        FGPlanePosPatient planPo;
+        char buf[20];
+        sprintf(buf, "%u", OFstatic_cast(unsigned int, frameNo * 2));
+        OFCHECK(planPo.setImagePositionPatient("-10", "20.5", buf).good());
+        OFCHECK(fg.addPerFrame(frameNo, planPo).good());
+        OFCHECK(fg.addPerFrame(frameNo, planOr).good());
+    }
+}
+
+static OFString dump(DcmItem& item)
+{
+    OFStringStream stream;
+    item.print(stream);
+    OFSTRINGSTREAM_GETOFSTRING(stream, result)
+    return result;
+}
+
+OFTEST(dcmfg_interface_compact)
+{
+    FGInterface source;
+    create_groups(source);
+    DcmDataset original;
+    OFCHECK(source.write(original).good());
+
+    // Read back, all per-frame groups are kept in compact form
+    FGInterface fg;
+    OFCHECK(fg.read(original).good());
+    OFCHECK_EQUAL(fg.getNumberOfFrames(), NUM_FRAMES);
+    Float64 x = 0, y = 0, z = 0;
+    OFVector<Uint32> dimIndex;
+    for (Uint32 frameNo = 0; frameNo < NUM_FRAMES; frameNo++)
+    {
+        OFCHECK(fg.getImagePositionPatient(frameNo, x, y, z).good());
+        OFCHECK_EQUAL(x, -10.0);
+        OFCHECK_EQUAL(y, 20.5);
+        OFCHECK_EQUAL(z, frameNo * 2.0);
+        OFCHECK(fg.getDimensionIndexValues(frameNo, dimIndex).good());
+        OFCHECK_EQUAL(dimIndex.size(), 2);
+        if (dimIndex.size() == 2)
+        {
+            OFCHECK_EQUAL(dimIndex[0], frameNo + 1);
+            OFCHECK_EQUAL(dimIndex[1], 7);
+        }
+    }
+    OFCHECK(fg.check());
+
+    // Writing without any access must result in the same dataset
+    DcmDataset unchanged;
+    OFCHECK(fg.write(unchanged).good());
+    OFCHECK_EQUAL(dump(unchanged), dump(original));
+
+    // Accessing a frame creates its functional groups, modify one of them
+    FGPlanePosPatient* planPo = OFstatic_cast(FGPlanePosPatient*, fg.get(2, DcmFGTypes::EFG_PLANEPOSPATIENT));
+    OFCHECK(planPo != NULL);
+    if (planPo != NULL)
+        OFCHECK(planPo->setImagePositionPatient("1", "2", "3").good());
+    OFCHECK(fg.getImagePositionPatient(2, x, y, z).good());
+    OFCHECK_EQUAL(z, 3.0);
+    OFCHECK(fg.getPerFrame(3) != NULL);
+    OFCHECK(fg.get(4, DcmFGTypes::EFG_PIXELMEASURES) != NULL);
+    OFCHECK_EQUAL(fg.getNumberOfFrames(), NUM_FRAMES);
+
+    // Frames are still written in order, mixing compact and created groups
+    DcmDataset modified;
+    OFCHECK(fg.write(modified).good());
+    FGInterface check;
+    OFCHECK(check.read(modified).good());
+    for (Uint32 frameNo = 0; frameNo < NUM_FRAMES; frameNo++)
+    {
+        OFCHECK(check.getImagePositionPatient(frameNo, x, y, z).good());
+        OFCHECK_EQUAL(z, (frameNo == 2) ? 3.0 : frameNo * 2.0);
+        OFCHECK(check.getDimensionIndexValues(frameNo, dimIndex).good());
+        OFCHECK(!dimIndex.empty() && (dimIndex[0] == frameNo + 1));
+    }
+
+    // Sharing a group removes it from all frames
+    FGPlaneOrientationPatient planOr;
+    OFCHECK(planOr.setImageOrientationPatient("1", "0", "0", "0", "1", "0").good());
+    OFCHECK(fg.addShared(planOr).good());
+    OFCHECK_EQUAL(fg.deletePerFrame(DcmFGTypes::EFG_PLANEORIENTPATIENT), 0);
+    OFCHECK(fg.check());
+
+    // Deleting a frame in compact form
+    fg.deleteFrame(OFstatic_cast(Uint32, NUM_FRAMES - 1));
+    OFCHECK_EQUAL(fg.getNumberOfFrames(), NUM_FRAMES - 1);
+    DcmDataset reduced;
+    OFCHECK(fg.write(reduced).good());
+    DcmSequenceOfItems* seq = NULL;
+    OFCHECK(reduced.findAndGetSequence(DCM_PerFrameFunctionalGroupsSequence, seq).good());
+    OFCHECK(seq != NULL && seq->card() == NUM_FRAMES - 1);
+}
@@ -24,4 +24,5 @@
 
 OFTEST_REGISTER(dcmfg_derivation_image);
 OFTEST_REGISTER(dcmfg_frame_content);
+OFTEST_REGISTER(dcmfg_interface_compact);
 OFTEST_MAIN("dcmfg")
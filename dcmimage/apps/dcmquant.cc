@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2001-2018, OFFIS e.V.
+ *  Copyright (C) 2001-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -90,6 +90,7 @@ int main(int argc, char *argv[])
     OFBool              opt_entries_word = OFFalse;
     OFBool              opt_palette_fs = OFFalse;
     OFCmdUnsignedInt    opt_palette_col = 256;
+    OFCmdUnsignedInt    opt_threads = 1;              /* default: single-threaded */
 
     DcmLargestDimensionType opt_largeType = DcmLargestDimensionType_default;
     DcmRepresentativeColorType opt_repType = DcmRepresentativeColorType_default;
@@ -171,6 +172,10 @@ int main(int argc, char *argv[])
       cmd.addOption("--floyd-steinberg",     "+pf",    "use Floyd-Steinberg error diffusion");
       cmd.addOption("--colors",              "+pc", 1, "number of colors: 2..65536 (default 256)",
                                                        "number of colors to quantize to");
+#ifdef WITH_THREADS
+      cmd.addOption("--threads",             "+pt", 1, "[n]umber: integer (1..64, default: 1)",
+                                                       "use n threads for histogram and color mapping");
+#endif
 
      cmd.addSubGroup("SOP Class UID:");
       cmd.addOption("--class-default",       "+cd",    "keep SOP Class UID (default)");
@@ -305,6 +310,9 @@ int main(int argc, char *argv[])
       if (cmd.findOption("--lut-entries-word")) opt_entries_word = OFTrue;
       if (cmd.findOption("--floyd-steinberg")) opt_palette_fs = OFTrue;
       if (cmd.findOption("--colors")) cmd.getValueAndCheckMinMax(opt_palette_col, 2, 65536);
+#ifdef WITH_THREADS
+      if (cmd.findOption("--threads")) app.checkValue(cmd.getValueAndCheckMinMax(opt_threads, 1, 64));
+#endif
 
       cmd.beginOptionBlock();
       if (cmd.findOption("--mc-dimension-rgb")) opt_largeType = DcmLargestDimensionType_default;
@@ -457,7 +465,7 @@ int main(int argc, char *argv[])
     // create palette color image
     error = DcmQuant::createPaletteColorImage(
       di, *dataset, opt_palette_ow, opt_entries_word, opt_palette_fs, opt_palette_col,
-      derivationDescription, opt_largeType, opt_repType);
+      derivationDescription, opt_largeType, opt_repType, opt_threads);
 
     // update image type
     if (error.good()) error = DcmCodec::updateImageType(dataset);
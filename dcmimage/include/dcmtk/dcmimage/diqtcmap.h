@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -75,9 +75,41 @@ public:
     T1& fs,
     T2 *tp)
   {
-    unsigned long cols = sourceImage.getWidth();
-    unsigned long rows = sourceImage.getHeight();
     const int bits = sizeof(DcmQuantComponent)*8;
+    const void *data = sourceImage.getOutputData(bits, frameNumber, 0);
+    if (data)
+    {
+      createRows(OFstatic_cast(const DcmQuantComponent *, data), sourceImage.getWidth(),
+        sourceImage.getHeight(), maxval, cht, colormap, fs, tp);
+    }
+  }
+
+  /** converts a band of consecutive rows of a color image into palette color.
+   *  The color table is only read, so several threads may convert different
+   *  bands of the same frame concurrently as long as each of them uses its
+   *  own hash table and error diffusion object.
+   *  @param cp pointer to the first pixel of the band, color-by-pixel RGB
+   *  @param cols number of columns in image
+   *  @param rows number of rows in band
+   *  @param maxval maximum pixel value to which all color samples
+   *    were down-sampled, see create()
+   *  @param cht color hash table caching the results of previous look-ups
+   *  @param colormap color LUT to which the color image is mapped.
+   *  @param fs error diffusion object, see create()
+   *  @param tp pointer to an array to which the palette color image data
+   *    is written.  The array must be large enough to store cols times rows
+   *    values of type T2.
+   */
+  static void createRows(
+    const DcmQuantComponent *cp,
+    unsigned long cols,
+    unsigned long rows,
+    unsigned long maxval,
+    DcmQuantColorHashTable& cht,
+    const DcmQuantColorTable& colormap,
+    T1& fs,
+    T2 *tp)
+  {
     DcmQuantPixel px;
     long limitcol;
     long col; // must be signed!
@@ -90,40 +122,35 @@ public:
     DcmQuantScaleTable scaletable;
     scaletable.createTable(OFstatic_cast(DcmQuantComponent, -1), maxval);
 
-    const void *data = sourceImage.getOutputData(bits, frameNumber, 0);
-    if (data)
+    for (unsigned long row = 0; row < rows; ++row)
     {
-      const DcmQuantComponent *cp = OFstatic_cast(const DcmQuantComponent *, data);
-      for (unsigned long row = 0; row < rows; ++row)
+      fs.startRow(col, limitcol);
+      do
       {
-        fs.startRow(col, limitcol);
-        do
-        {
-            currentpixel = cp + col + col + col;
-            cr = *currentpixel++;
-            cg = *currentpixel++;
-            cb = *currentpixel;
-            px.scale(cr, cg, cb, scaletable);
+          currentpixel = cp + col + col + col;
+          cr = *currentpixel++;
+          cg = *currentpixel++;
+          cb = *currentpixel;
+          px.scale(cr, cg, cb, scaletable);
 
-            fs.adjust(px, col, maxval_l);
+          fs.adjust(px, col, maxval_l);
 
-            // Check hash table to see if we have already matched this color.
-            ind = cht.lookup(px);
-            if (ind < 0)
-            {
-              ind = colormap.computeIndex(px);
-              cht.add(px, ind);
-            }
+          // Check hash table to see if we have already matched this color.
+          ind = cht.lookup(px);
+          if (ind < 0)
+          {
+            ind = colormap.computeIndex(px);
+            cht.add(px, ind);
+          }
 
-            fs.propagate(px, colormap.getPixel(ind), col);
-            tp[col] = OFstatic_cast(T2, ind);
-            fs.nextCol(col);
-        } while ( col != limitcol );
-        fs.finishRow();
-        cp += (cols * 3); // advance source pointer by one row
-        tp += cols;  // advance target pointer by one row
-      } // for all rows
-    } // if (data)
+          fs.propagate(px, colormap.getPixel(ind), col);
+          tp[col] = OFstatic_cast(T2, ind);
+          fs.nextCol(col);
+      } while ( col != limitcol );
+      fs.finishRow();
+      cp += (cols * 3); // advance source pointer by one row
+      tp += cols;  // advance target pointer by one row
+    } // for all rows
   }
 };
 
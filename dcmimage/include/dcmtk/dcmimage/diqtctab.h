@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -29,6 +29,7 @@
 #include "dcmtk/dcmimage/diqtpix.h"   /* for DcmQuantPixel */
 #include "dcmtk/dcmimage/diqthash.h"  /* for DcmQuantHistogramItem */
 #include "dcmtk/ofstd/ofstring.h"     /* for class OFString */
+#include "dcmtk/ofstd/ofvector.h"     /* for class OFVector */
 
 
 class DicomImage;
@@ -72,9 +73,13 @@ public:
    *  @param maxcolors maximum number of colors allowed in histogram.
    *    If necessary, pixel sample values are down-sampled to enforce
    *    this maximum.
+   *  @param numberOfThreads number of threads used for counting colors
    *  @return EC_Normal if successful, an error code otherwise.
    */
-  OFCondition computeHistogram(DicomImage& image, unsigned long maxcolors);
+  OFCondition computeHistogram(
+    DicomImage& image,
+    unsigned long maxcolors,
+    unsigned long numberOfThreads = 1);
 
   /** after a call to computeHistogram(), this method
    *  returns the maximum pixel value to which all color samples
@@ -157,6 +162,10 @@ public:
     DcmRepresentativeColorType repType);
 
   /** determines for a given color the closest match in the color LUT.
+   *  After a call to medianCut(), only the palette entries that may be
+   *  closest to any color within the cell of the RGB cube that contains px
+   *  are examined (see computeCells()).  If several entries have the same
+   *  distance, the one with the lowest index is returned.
    *  @param px color to look up in LUT
    *  @return index of closest match in LUT, -1 if look-up table empty
    */
@@ -169,6 +178,26 @@ public:
     int g1 = OFstatic_cast(int, px.getGreen());
     int b1 = OFstatic_cast(int, px.getBlue());
     long dist = 2000000000;
+    if (cellWidth > 0)
+    {
+      const unsigned long cell = cellNumber(r1, g1, b1);
+      const int *candidate = &cellCandidates[cellStart[cell]];
+      const int *lastCandidate = candidate + (cellStart[cell + 1] - cellStart[cell]);
+      for (; candidate != lastCandidate; ++candidate)
+      {
+        const int *rgb = &paletteRGB[3 * *candidate];
+        r2 = r1 - rgb[0];
+        g2 = g1 - rgb[1];
+        b2 = b1 - rgb[2];
+        newdist = r2*r2 + g2*g2 + b2*b2;
+        if (newdist < dist)
+        {
+          result = *candidate;
+          dist = newdist;
+        }
+      }
+      return result;
+    }
     for (unsigned long i = 0; i < numColors; ++i)
     {
         r2 = r1 - OFstatic_cast(int, array[i]->getRed());
@@ -210,6 +239,33 @@ private:
    */
   void computeClusters();
 
+  /** after a call to medianCut(), this method partitions the RGB cube
+   *  [0..maxval]^3 into cells and determines for each cell the list of
+   *  palette entries that may be the closest match for any color within
+   *  the cell, i.e. all entries whose minimum distance to the cell does
+   *  not exceed the smallest maximum distance of any entry to the cell.
+   *  This data is used by computeIndex() to avoid a linear search over
+   *  the complete color table.
+   */
+  void computeCells();
+
+  /** returns the number of the cell containing the given color
+   *  @param r red component
+   *  @param g green component
+   *  @param b blue component
+   *  @return cell number, < cellsPerAxis^3
+   */
+  inline unsigned long cellNumber(int r, int g, int b) const
+  {
+    unsigned long cr = OFstatic_cast(unsigned long, r) / cellWidth;
+    unsigned long cg = OFstatic_cast(unsigned long, g) / cellWidth;
+    unsigned long cb = OFstatic_cast(unsigned long, b) / cellWidth;
+    if (cr >= cellsPerAxis) cr = cellsPerAxis - 1;
+    if (cg >= cellsPerAxis) cg = cellsPerAxis - 1;
+    if (cb >= cellsPerAxis) cb = cellsPerAxis - 1;
+    return (cr * cellsPerAxis + cg) * cellsPerAxis + cb;
+  }
+
   /// private undefined copy constructor
   DcmQuantColorTable(const DcmQuantColorTable& src);
 
@@ -227,6 +283,23 @@ private:
    */
   unsigned long maxval;
 
+  /// number of cells per color axis used by computeIndex(), 0 if not computed
+  unsigned long cellsPerAxis;
+
+  /// width of a cell in pixel values, 0 if the cells have not been computed
+  unsigned long cellWidth;
+
+  /** for each cell, the index of the first candidate in cellCandidates.
+   *  Contains one additional entry marking the end of the last list.
+   */
+  OFVector<unsigned long> cellStart;
+
+  /// concatenated lists of candidate palette entries, in ascending order
+  OFVector<int> cellCandidates;
+
+  /// palette colors as contiguous R,G,B triples used by computeIndex()
+  OFVector<int> paletteRGB;
+
 };
 
 #endif
@@ -25,17 +25,23 @@
 
 
 #include "dcmtk/config/osconfig.h"
+#include "dcmtk/ofstd/oftypes.h"     /* for Uint32 */
 #include "dcmtk/ofstd/ofvector.h"
 #include "dcmtk/dcmimage/diqtpix.h"   /* for DcmQuantPixel */
-#include "dcmtk/dcmimage/diqthitl.h"  /* for DcmQuantHistogramItemList */
+#include "dcmtk/dcmimage/diqthitm.h"  /* for DcmQuantHistogramItem */
 
 
 class DicomImage;
+class DcmQuantScaleTable;
+class DcmQuantHistogramWorker;
 
 /** this class implements a hash table for colors.
  *  Each entry of the hash table consists of an RGB
  *  color (DcmQuantPixel object) and an integer value (e. g. counter).
  *  This class is used during the quantization of a color image.
+ *  The table uses open addressing with linear probing on a flat array
+ *  of small entries, which avoids one heap allocation per color and keeps
+ *  the probe sequence within a few cache lines.
  */
 class DCMTK_DCMIMAGE_EXPORT DcmQuantColorHashTable
 {
@@ -53,7 +59,9 @@ public:
    */
   inline void add(const DcmQuantPixel& colorP, int value)
   {
-    item(colorP).push_front(colorP, value);
+    Entry& e = slot(colorP);
+    e.value = value;
+    if (! e.used) insert(e, colorP);
   }
 
   /** looks up the given color in the hash table.
@@ -63,8 +71,8 @@ public:
    */
   inline int lookup(const DcmQuantPixel& colorP) const
   {
-    DcmQuantHistogramItemListPointer const p(m_Table[colorP.hash()]);
-    return p ? p->lookup(colorP) : -1;
+    const Entry& e = slot(colorP);
+    return e.used ? e.value : -1;
   }
 
   /** adds all pixels of all frames of the given image (which must be a
@@ -78,12 +86,17 @@ public:
    *    of colors in the image if necessary.
    *  @param maxcolors maximum number of colors allowed.  If more colors are found,
    *    the method immediately returns with a return value of zero.
+   *  @param numberOfThreads number of threads used for counting the pixels of
+   *    each frame.  Each thread counts a band of rows into a private table;
+   *    the partial tables are merged afterwards.  Values < 2 (or a DCMTK
+   *    build without thread support) select the single-threaded code path.
    *  @return number of colors found, 0 if too many colors.
    */
   unsigned long addToHashTable(
     DicomImage& image,
     unsigned long newmaxval,
-    unsigned long maxcolors);
+    unsigned long maxcolors,
+    unsigned long numberOfThreads = 1);
 
   /** counts the number of entries in the hash table
    *  @return number of entries in hash table
@@ -102,27 +115,145 @@ public:
 
 private:
 
-  typedef OFVector<DcmQuantHistogramItemListPointer> table_type;
+  /// a single slot of the open addressing table
+  struct Entry
+  {
+    /// default constructor, creates an unused slot
+    Entry()
+    : red(0)
+    , green(0)
+    , blue(0)
+    , used(OFFalse)
+    , value(0)
+    {
+    }
+
+    /// red color component
+    DcmQuantComponent red;
+
+    /// green color component
+    DcmQuantComponent green;
+
+    /// blue color component
+    DcmQuantComponent blue;
+
+    /// true if this slot is occupied
+    OFBool used;
+
+    /// integer value (counter or color index) assigned to the color
+    int value;
+  };
+
+  typedef OFVector<Entry> table_type;
   typedef table_type::iterator table_iterator;
   typedef table_type::const_iterator const_table_iterator;
 
+  /// worker threads count pixels into private tables
+  friend class DcmQuantHistogramWorker;
+
   /// private undefined copy constructor
   DcmQuantColorHashTable(const DcmQuantColorHashTable& src);
 
   /// private undefined copy assignment operator
   DcmQuantColorHashTable& operator=(const DcmQuantColorHashTable& src);
 
-  /** Retrieves the specified item from the hash table.
-   *  If the item has not been created a new item is created and is returned.
+  /** computes the initial probe position for the given color.
+   *  @param colorP color
+   *  @return index into m_Table
    */
-  DcmQuantHistogramItemList& item(const DcmQuantPixel& colorP)
+  inline size_t position(const DcmQuantPixel& colorP) const
   {
-    DcmQuantHistogramItemListPointer& p(m_Table[colorP.hash()]);
-    return p ? *p : *(p = new DcmQuantHistogramItemList());
+    // DcmQuantPixel::hash() is limited to DcmQuantHashSize buckets,
+    // we need a hash that spreads over the full (growing) table
+    Uint32 h = OFstatic_cast(Uint32, colorP.getRed()) * 0x9E3779B1UL;
+    h = (h ^ OFstatic_cast(Uint32, colorP.getGreen())) * 0x85EBCA77UL;
+    h = (h ^ OFstatic_cast(Uint32, colorP.getBlue())) * 0xC2B2AE3DUL;
+    return OFstatic_cast(size_t, h ^ (h >> 16)) & m_Mask;
   }
 
-  /// hash array of lists for color/value pairs
+  /** returns the slot that either contains the given color or the
+   *  empty slot at which the color would be inserted.
+   *  @param colorP color to look up
+   *  @return reference to slot
+   */
+  inline Entry& slot(const DcmQuantPixel& colorP)
+  {
+    size_t i = position(colorP);
+    while (m_Table[i].used && ! matches(m_Table[i], colorP)) i = (i + 1) & m_Mask;
+    return m_Table[i];
+  }
+
+  /// const version of slot()
+  inline const Entry& slot(const DcmQuantPixel& colorP) const
+  {
+    size_t i = position(colorP);
+    while (m_Table[i].used && ! matches(m_Table[i], colorP)) i = (i + 1) & m_Mask;
+    return m_Table[i];
+  }
+
+  /** checks whether the given slot stores the given color
+   *  @param e slot
+   *  @param colorP color
+   *  @return true if colors are equal, false otherwise
+   */
+  static inline OFBool matches(const Entry& e, const DcmQuantPixel& colorP)
+  {
+    return (e.red == colorP.getRed()) && (e.green == colorP.getGreen()) && (e.blue == colorP.getBlue());
+  }
+
+  /** increases the counter for the given color by the given amount.
+   *  If the color is not yet present, it is added with the given counter.
+   *  @param colorP color
+   *  @param count number of occurences to add
+   *  @return 1 if the color was newly added, 0 otherwise
+   */
+  inline unsigned long count(const DcmQuantPixel& colorP, int count = 1)
+  {
+    Entry& e = slot(colorP);
+    if (e.used)
+    {
+      e.value += count;
+      return 0;
+    }
+    e.value = count;
+    insert(e, colorP);
+    return 1;
+  }
+
+  /** marks the given empty slot as used for the given color and grows
+   *  the table if the load factor becomes too high.  After this call,
+   *  the reference e may be invalid.
+   *  @param e empty slot returned by slot()
+   *  @param colorP color to store in slot
+   */
+  void insert(Entry& e, const DcmQuantPixel& colorP);
+
+  /** counts the given pixels, scaled with the given table
+   *  @param cp pointer to the first sample of the first pixel (R,G,B interleaved)
+   *  @param numPixels number of pixels to count
+   *  @param scaletable scale table applied to each sample
+   *  @param maxcolors maximum number of colors allowed in this table
+   *  @return OFFalse if more than maxcolors colors were found, OFTrue otherwise
+   */
+  OFBool countPixels(
+    const DcmQuantComponent *cp,
+    unsigned long numPixels,
+    const DcmQuantScaleTable& scaletable,
+    unsigned long maxcolors);
+
+  /** adds all entries of the given table to this table, summing up counters
+   *  @param src table to merge into this table
+   */
+  void merge(const DcmQuantColorHashTable& src);
+
+  /// hash array of color/value pairs, size is a power of two
   table_type m_Table;
+
+  /// bit mask applied to hash values, equals m_Table.size() - 1
+  size_t m_Mask;
+
+  /// number of used slots
+  unsigned long m_Entries;
 };
 
 
@@ -58,6 +58,12 @@ public:
    *    in the Median Cut algorithm
    *  @param repType algorithm for choosing a representative color for each
    *    box in the Median Cut algorithm
+   *  @param numberOfThreads number of threads used for computing the image
+   *    histogram and for mapping the image to the color palette.  Each thread
+   *    processes a band of rows of the current frame.  Mapping with
+   *    Floyd-Steinberg error diffusion is always performed by a single thread
+   *    since the error terms are propagated from row to row.  This parameter
+   *    has no effect if DCMTK was compiled without thread support.
    *  @return EC_Normal if successful, an error code otherwise.
    */
   static OFCondition createPaletteColorImage(
@@ -69,7 +75,8 @@ public:
     Uint32 numberOfColors,
     OFString& description,
     DcmLargestDimensionType largeType = DcmLargestDimensionType_default,
-    DcmRepresentativeColorType repType = DcmRepresentativeColorType_default);
+    DcmRepresentativeColorType repType = DcmRepresentativeColorType_default,
+    Uint32 numberOfThreads = 1);
 
   /** create Derivation Description. If a derivation description
    *  already exists, the old text is appended to the new text.
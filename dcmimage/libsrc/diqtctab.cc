@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -32,6 +32,9 @@
 #include "dcmtk/dcmdata/dcdeftag.h"  /* for tag constants */
 #include "dcmtk/dcmdata/dcuid.h"     /* for OFFIS_DCMTK_VERSION */
 
+/// maximum number of cells per color axis used for the nearest color search
+#define DcmQuantMaxCellsPerAxis 16
+
 #define INCLUDE_CSTDIO
 #include "dcmtk/ofstd/ofstdinc.h"
 
@@ -65,6 +68,11 @@ DcmQuantColorTable::DcmQuantColorTable()
 : array(NULL)
 , numColors(0)
 , maxval(0)
+, cellsPerAxis(0)
+, cellWidth(0)
+, cellStart()
+, cellCandidates()
+, paletteRGB()
 {
 }
 
@@ -85,12 +93,18 @@ void DcmQuantColorTable::clear()
   }
   numColors = 0;
   maxval = 0;
+  cellsPerAxis = 0;
+  cellWidth = 0;
+  cellStart.clear();
+  cellCandidates.clear();
+  paletteRGB.clear();
 }
 
 
 OFCondition DcmQuantColorTable::computeHistogram(
   DicomImage& image,
-  unsigned long maxcolors)
+  unsigned long maxcolors,
+  unsigned long numberOfThreads)
 {
   // reset object to initial state
   clear();
@@ -106,7 +120,7 @@ OFCondition DcmQuantColorTable::computeHistogram(
   while (! done)
   {
     htable = new DcmQuantColorHashTable();
-    numColors = htable->addToHashTable(image, maxval, maxcolors);
+    numColors = htable->addToHashTable(image, maxval, maxcolors, numberOfThreads);
     if (numColors > 0) done = OFTrue;
     else
     {
@@ -325,12 +339,80 @@ OFCondition DcmQuantColorTable::medianCut(
       }
   }
 
-  // All done, now compute clusters
+  // All done, now compute clusters and the nearest color search index
   computeClusters();
+  computeCells();
   return EC_Normal;
 }
 
 
+void DcmQuantColorTable::computeCells()
+{
+  cellStart.clear();
+  cellCandidates.clear();
+  paletteRGB.clear();
+  cellsPerAxis = 0;
+  cellWidth = 0;
+  if (numColors == 0) return;
+
+  // copy the palette into a contiguous array
+  paletteRGB.resize(3 * numColors);
+  for (unsigned long i = 0; i < numColors; ++i)
+  {
+    paletteRGB[3*i]   = OFstatic_cast(int, array[i]->getRed());
+    paletteRGB[3*i+1] = OFstatic_cast(int, array[i]->getGreen());
+    paletteRGB[3*i+2] = OFstatic_cast(int, array[i]->getBlue());
+  }
+
+  cellsPerAxis = (maxval + 1 < DcmQuantMaxCellsPerAxis) ? maxval + 1 : DcmQuantMaxCellsPerAxis;
+  const unsigned long width = (maxval + cellsPerAxis) / cellsPerAxis;
+  const unsigned long numCells = cellsPerAxis * cellsPerAxis * cellsPerAxis;
+  cellStart.reserve(numCells + 1);
+
+  OFVector<long> mindist(numColors);
+  long lo[3], hi[3], d, dmin, dmax, threshold;
+  unsigned long c, i;
+  int k;
+  for (unsigned long cell = 0; cell < numCells; ++cell)
+  {
+    // boundaries of the current cell
+    lo[0] = OFstatic_cast(long, (cell / (cellsPerAxis * cellsPerAxis)) * width);
+    lo[1] = OFstatic_cast(long, ((cell / cellsPerAxis) % cellsPerAxis) * width);
+    lo[2] = OFstatic_cast(long, (cell % cellsPerAxis) * width);
+    for (k = 0; k < 3; ++k) hi[k] = lo[k] + OFstatic_cast(long, width) - 1;
+
+    // the closest entry for any color in the cell is at most as far away
+    // as the smallest of the maximum distances of all entries to the cell
+    threshold = -1;
+    for (i = 0; i < numColors; ++i)
+    {
+      dmin = 0;
+      dmax = 0;
+      for (k = 0; k < 3; ++k)
+      {
+        c = 3*i + k;
+        if (paletteRGB[c] < lo[k]) d = lo[k] - paletteRGB[c];
+        else if (paletteRGB[c] > hi[k]) d = paletteRGB[c] - hi[k];
+        else d = 0;
+        dmin += d * d;
+        d = (paletteRGB[c] - lo[k] > hi[k] - paletteRGB[c]) ? paletteRGB[c] - lo[k] : hi[k] - paletteRGB[c];
+        dmax += d * d;
+      }
+      mindist[i] = dmin;
+      if ((threshold < 0) || (dmax < threshold)) threshold = dmax;
+    }
+
+    cellStart.push_back(cellCandidates.size());
+    for (i = 0; i < numColors; ++i)
+      if (mindist[i] <= threshold) cellCandidates.push_back(OFstatic_cast(int, i));
+  }
+  cellStart.push_back(cellCandidates.size());
+
+  // enable the cell based search in computeIndex()
+  cellWidth = width;
+}
+
+
 void DcmQuantColorTable::computeClusters()
 {
   unsigned long i;
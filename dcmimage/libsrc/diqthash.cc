@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2017, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -22,12 +22,99 @@
 
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmimage/diqthash.h"
+#include "dcmtk/dcmimage/diqtstab.h"   /* for DcmQuantScaleTable */
 #include "dcmtk/dcmdata/dcxfer.h"      /* for E_TransferSyntax */
-#include "dcmtk/dcmimgle/dcmimage.h"    /* for DicomImage */
+#include "dcmtk/dcmimgle/dcmimage.h"   /* for DicomImage */
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"      /* for OFThread */
+#endif
+
+/// initial number of slots in the color hash table, must be a power of two
+#define DcmQuantInitialTableSize 32768
+
+
+#ifdef WITH_THREADS
+
+/** helper thread that counts the colors of a band of image rows
+ *  into a private hash table.
+ */
+class DcmQuantHistogramWorker: public OFThread
+{
+public:
+  /** constructor
+   *  @param scaletable scale table applied to each sample
+   *  @param maxcolors maximum number of colors allowed
+   */
+  DcmQuantHistogramWorker(const DcmQuantScaleTable& scaletable, unsigned long maxcolors)
+  : OFThread()
+  , table()
+  , data(NULL)
+  , numPixels(0)
+  , scale(scaletable)
+  , maxColors(maxcolors)
+  , overflow(OFFalse)
+  {
+  }
+
+  /** sets the band of pixels counted by the next call to start()
+   *  @param cp pointer to the first sample of the first pixel
+   *  @param pixels number of pixels in band
+   */
+  void setBand(const DcmQuantComponent *cp, unsigned long pixels)
+  {
+    data = cp;
+    numPixels = pixels;
+  }
+
+  /// the private histogram of this thread
+  DcmQuantColorHashTable table;
+
+  /// pointer to the pixel data counted by this thread
+  const DcmQuantComponent *data;
+
+  /// number of pixels counted by this thread
+  unsigned long numPixels;
+
+  /// scale table applied to each sample
+  const DcmQuantScaleTable& scale;
+
+  /// maximum number of colors allowed
+  unsigned long maxColors;
+
+  /// set to true if more than maxColors colors were found
+  OFBool overflow;
+
+  /// counts the current band of pixels in the calling thread
+  void process()
+  {
+    if (! overflow) overflow = ! table.countPixels(data, numPixels, scale, maxColors);
+  }
+
+protected:
+
+  /// counts the current band of pixels
+  virtual void run()
+  {
+    process();
+  }
+
+private:
+
+  /// private undefined copy constructor
+  DcmQuantHistogramWorker(const DcmQuantHistogramWorker&);
+
+  /// private undefined copy assignment operator
+  DcmQuantHistogramWorker& operator=(const DcmQuantHistogramWorker&);
+};
+
+#endif
 
 
 DcmQuantColorHashTable::DcmQuantColorHashTable()
-: m_Table(DcmQuantHashSize, OFnullptr)
+: m_Table(DcmQuantInitialTableSize)
+, m_Mask(DcmQuantInitialTableSize - 1)
+, m_Entries(0)
 {
 
 }
@@ -35,16 +122,38 @@ DcmQuantColorHashTable::DcmQuantColorHashTable()
 
 DcmQuantColorHashTable::~DcmQuantColorHashTable()
 {
-  for (table_iterator it = m_Table.begin(); it != m_Table.end(); delete *it++);
+}
+
+
+void DcmQuantColorHashTable::insert(Entry& e, const DcmQuantPixel& colorP)
+{
+  e.red = colorP.getRed();
+  e.green = colorP.getGreen();
+  e.blue = colorP.getBlue();
+  e.used = OFTrue;
+
+  // keep the load factor below 1/2 so that probe sequences remain short
+  if (++m_Entries * 2 > m_Table.size())
+  {
+    table_type oldTable(m_Table.size() * 2);
+    oldTable.swap(m_Table);
+    m_Mask = m_Table.size() - 1;
+    DcmQuantPixel px;
+    for (const_table_iterator it = oldTable.begin(); it != oldTable.end(); ++it)
+    {
+      if (it->used)
+      {
+        px.assign(it->red, it->green, it->blue);
+        slot(px) = *it;
+      }
+    }
+  }
 }
 
 
 unsigned long DcmQuantColorHashTable::countEntries() const
 {
-  unsigned long result = 0;
-  for (const_table_iterator it = m_Table.begin(); it != m_Table.end(); ++it)
-    if (*it) result += OFstatic_cast(unsigned long, (*it)->size());
-  return result;
+  return m_Entries;
 }
 
 
@@ -55,27 +164,73 @@ unsigned long DcmQuantColorHashTable::createHistogram(DcmQuantHistogramItemPoint
   if (array)
   {
     unsigned long counter = 0;
-    for (table_iterator it = m_Table.begin(); it != m_Table.end(); ++it)
-      if (*it) (*it)->moveto(array, counter, numcolors);
+    DcmQuantPixel px;
+    for (table_iterator it = m_Table.begin(); (it != m_Table.end()) && (counter < numcolors); ++it)
+    {
+      if (it->used)
+      {
+        px.assign(it->red, it->green, it->blue);
+        array[counter++] = new DcmQuantHistogramItem(px, it->value);
+      }
+    }
   }
+
+  // the contents of the table have been moved into the array
+  table_type(DcmQuantInitialTableSize).swap(m_Table);
+  m_Mask = DcmQuantInitialTableSize - 1;
+  m_Entries = 0;
   return numcolors;
 }
 
 
+OFBool DcmQuantColorHashTable::countPixels(
+  const DcmQuantComponent *cp,
+  unsigned long numPixels,
+  const DcmQuantScaleTable& scaletable,
+  unsigned long maxcolors)
+{
+  DcmQuantPixel px;
+  DcmQuantComponent r, g, b;
+  for (unsigned long i = 0; i < numPixels; i++)
+  {
+    // get pixel
+    r = *cp++;
+    g = *cp++;
+    b = *cp++;
+    px.scale(r, g, b, scaletable);
+
+    // lookup and increase if already in hash table
+    if (count(px) && (m_Entries > maxcolors)) return OFFalse;
+  }
+  return OFTrue;
+}
+
+
+void DcmQuantColorHashTable::merge(const DcmQuantColorHashTable& src)
+{
+  DcmQuantPixel px;
+  for (const_table_iterator it = src.m_Table.begin(); it != src.m_Table.end(); ++it)
+  {
+    if (it->used)
+    {
+      px.assign(it->red, it->green, it->blue);
+      count(px, it->value);
+    }
+  }
+}
+
+
 unsigned long DcmQuantColorHashTable::addToHashTable(
   DicomImage& image,
   unsigned long newmaxval,
-  unsigned long maxcolors)
+  unsigned long maxcolors,
+  unsigned long numberOfThreads)
 {
   const unsigned long cols = image.getWidth();
   const unsigned long rows = image.getHeight();
   const unsigned long frames = image.getFrameCount();
   const int bits = sizeof(DcmQuantComponent)*8;
 
-  unsigned long numcolors = 0;
-  unsigned long j, k;
-  const DcmQuantComponent *cp;
-  DcmQuantPixel px;
   const void *data = NULL;
 
   // compute maxval
@@ -85,30 +240,65 @@ unsigned long DcmQuantColorHashTable::addToHashTable(
   DcmQuantScaleTable scaletable;
   scaletable.createTable(maxval, newmaxval);
 
-  DcmQuantComponent r, g, b;
+  // never use more threads than there are rows in a frame
+  if (numberOfThreads > rows) numberOfThreads = rows;
 
-  for (unsigned long ff=0; ff<frames; ff++)
+#ifdef WITH_THREADS
+  if (numberOfThreads > 1)
   {
-    data = image.getOutputData(bits, ff, 0);
-    if (data)
+    OFVector<DcmQuantHistogramWorker *> workers;
+    OFVector<OFBool> running(numberOfThreads, OFFalse);
+    for (unsigned long t = 0; t < numberOfThreads; t++)
+      workers.push_back(new DcmQuantHistogramWorker(scaletable, maxcolors));
+
+    OFBool overflow = OFFalse;
+    for (unsigned long ff=0; (ff<frames) && !overflow; ff++)
     {
-      cp = OFstatic_cast(const DcmQuantComponent *, data);
-      for (j = 0; j < rows; j++)
+      // the image must be rendered by a single thread, only counting is parallel
+      data = image.getOutputData(bits, ff, 0);
+      if (data)
       {
-        for (k = 0; k < cols; k++)
+        const DcmQuantComponent *cp = OFstatic_cast(const DcmQuantComponent *, data);
+        unsigned long firstRow = 0;
+        for (unsigned long t = 0; t < numberOfThreads; t++)
         {
-          // get pixel
-          r = *cp++;
-          g = *cp++;
-          b = *cp++;
-          px.scale(r, g, b, scaletable);
-
-          // lookup and increase if already in hash table
-          numcolors += item(px).add(px);
-          if (numcolors > maxcolors) return 0;
+          const unsigned long lastRow = rows * (t + 1) / numberOfThreads;
+          workers[t]->setBand(cp + firstRow * cols * 3, (lastRow - firstRow) * cols);
+          // fall back to counting in this thread if no thread could be created
+          running[t] = (workers[t]->start() == 0);
+          if (! running[t]) workers[t]->process();
+          firstRow = lastRow;
+        }
+        for (unsigned long t = 0; t < numberOfThreads; t++)
+        {
+          if (running[t]) workers[t]->join();
+          if (workers[t]->overflow) overflow = OFTrue;
         }
       }
     }
+
+    // merge the partial histograms
+    for (unsigned long t = 0; t < numberOfThreads; t++)
+    {
+      if (! overflow)
+      {
+        merge(workers[t]->table);
+        if (m_Entries > maxcolors) overflow = OFTrue;
+      }
+      delete workers[t];
+    }
+    return overflow ? 0 : m_Entries;
   }
-  return numcolors;
+#endif
+
+  for (unsigned long ff=0; ff<frames; ff++)
+  {
+    data = image.getOutputData(bits, ff, 0);
+    if (data)
+    {
+      if (! countPixels(OFstatic_cast(const DcmQuantComponent *, data), rows * cols, scaletable, maxcolors))
+        return 0;
+    }
+  }
+  return m_Entries;
 }
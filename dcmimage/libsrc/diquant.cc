@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2002-2016, OFFIS e.V.
+ *  Copyright (C) 2002-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -37,6 +37,162 @@
 #include "dcmtk/dcmdata/dcpixel.h"    /* for DcmPixelData */
 #include "dcmtk/dcmdata/dcsequen.h"   /* for DcmSequenceOfItems */
 #include "dcmtk/dcmdata/dcuid.h"      /* for dcmGenerateUniqueIdentifier() */
+#include "dcmtk/ofstd/oftimer.h"      /* for OFTimer */
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"     /* for OFThread */
+
+
+/** helper thread that maps a band of rows of a color image
+ *  to the color palette, without error diffusion.
+ */
+class DcmQuantMappingWorker: public OFThread
+{
+public:
+  /** constructor
+   *  @param cols number of columns in image
+   *  @param maxval maximum pixel value of the color table
+   *  @param colormap color table to map to
+   */
+  DcmQuantMappingWorker(unsigned long cols, unsigned long maxval, const DcmQuantColorTable& colormap)
+  : OFThread()
+  , cht()
+  , id(cols)
+  , columns(cols)
+  , maxVal(maxval)
+  , colorTable(colormap)
+  , data(NULL)
+  , numRows(0)
+  , target8(NULL)
+  , target16(NULL)
+  {
+  }
+
+  /** sets the band of rows mapped by the next call to start()
+   *  @param cp pointer to the first pixel of the band
+   *  @param rows number of rows in band
+   *  @param tp8 target for 8 bit palette indices, NULL if tp16 is used
+   *  @param tp16 target for 16 bit palette indices, NULL if tp8 is used
+   */
+  void setBand(const DcmQuantComponent *cp, unsigned long rows, Uint8 *tp8, Uint16 *tp16)
+  {
+    data = cp;
+    numRows = rows;
+    target8 = tp8;
+    target16 = tp16;
+  }
+
+  /// maps the current band of rows in the calling thread
+  void process()
+  {
+    if (target8)
+      DcmQuantColorMapping<DcmQuantIdent, Uint8>::createRows(data, columns, numRows, maxVal, cht, colorTable, id, target8);
+      else DcmQuantColorMapping<DcmQuantIdent, Uint16>::createRows(data, columns, numRows, maxVal, cht, colorTable, id, target16);
+  }
+
+protected:
+
+  /// maps the current band of rows
+  virtual void run()
+  {
+    process();
+  }
+
+private:
+
+  /// private undefined copy constructor
+  DcmQuantMappingWorker(const DcmQuantMappingWorker&);
+
+  /// private undefined copy assignment operator
+  DcmQuantMappingWorker& operator=(const DcmQuantMappingWorker&);
+
+  /// private color cache of this thread, kept for all frames
+  DcmQuantColorHashTable cht;
+
+  /// identity error diffusion object
+  DcmQuantIdent id;
+
+  /// number of columns in image
+  unsigned long columns;
+
+  /// maximum pixel value of the color table
+  unsigned long maxVal;
+
+  /// color table to map to
+  const DcmQuantColorTable& colorTable;
+
+  /// first pixel of the current band
+  const DcmQuantComponent *data;
+
+  /// number of rows in the current band
+  unsigned long numRows;
+
+  /// target for 8 bit palette indices
+  Uint8 *target8;
+
+  /// target for 16 bit palette indices
+  Uint16 *target16;
+};
+
+
+/** maps all frames of the given image to the color palette, splitting
+ *  each frame into bands of rows that are processed in parallel.
+ *  @param sourceImage color image
+ *  @param maxval maximum pixel value of the color table
+ *  @param colormap color table to map to
+ *  @param numberOfThreads number of threads, must be in [2..rows]
+ *  @param tp8 target for 8 bit palette indices, NULL if tp16 is used
+ *  @param tp16 target for 16 bit palette indices, NULL if tp8 is used
+ */
+static void mapFramesParallel(
+  DicomImage& sourceImage,
+  unsigned long maxval,
+  const DcmQuantColorTable& colormap,
+  unsigned long numberOfThreads,
+  Uint8 *tp8,
+  Uint16 *tp16)
+{
+  const unsigned long cols = sourceImage.getWidth();
+  const unsigned long rows = sourceImage.getHeight();
+  const unsigned long frames = sourceImage.getFrameCount();
+  const int bits = sizeof(DcmQuantComponent)*8;
+
+  OFVector<DcmQuantMappingWorker *> workers;
+  OFVector<OFBool> running(numberOfThreads, OFFalse);
+  for (unsigned long t = 0; t < numberOfThreads; t++)
+    workers.push_back(new DcmQuantMappingWorker(cols, maxval, colormap));
+
+  for (unsigned long ff = 0; ff < frames; ff++)
+  {
+    // the image must be rendered by a single thread, only the mapping is parallel
+    const void *data = sourceImage.getOutputData(bits, ff, 0);
+    if (data)
+    {
+      const DcmQuantComponent *cp = OFstatic_cast(const DcmQuantComponent *, data);
+      const unsigned long offset = cols * rows * ff;
+      unsigned long firstRow = 0;
+      for (unsigned long t = 0; t < numberOfThreads; t++)
+      {
+        const unsigned long lastRow = rows * (t + 1) / numberOfThreads;
+        const unsigned long pos = offset + firstRow * cols;
+        workers[t]->setBand(cp + firstRow * cols * 3, lastRow - firstRow,
+          tp8 ? tp8 + pos : NULL, tp16 ? tp16 + pos : NULL);
+        // fall back to mapping in this thread if no thread could be created
+        running[t] = (workers[t]->start() == 0);
+        if (! running[t]) workers[t]->process();
+        firstRow = lastRow;
+      }
+      for (unsigned long t = 0; t < numberOfThreads; t++)
+      {
+        if (running[t]) workers[t]->join();
+      }
+    }
+  }
+
+  for (unsigned long t = 0; t < numberOfThreads; t++) delete workers[t];
+}
+
+#endif
 
 
 OFCondition DcmQuant::createPaletteColorImage(
@@ -48,7 +204,8 @@ OFCondition DcmQuant::createPaletteColorImage(
     Uint32 numberOfColors,
     OFString& description,
     DcmLargestDimensionType largeType,
-    DcmRepresentativeColorType repType)
+    DcmRepresentativeColorType repType,
+    Uint32 numberOfThreads)
 {
     // make sure we're operating on a color image
     if (sourceImage.isMonochrome()) return EC_IllegalCall;
@@ -61,29 +218,37 @@ OFCondition DcmQuant::createPaletteColorImage(
     // Create histogram of the colors, clustered if necessary
     DCMIMAGE_DEBUG("computing image histogram");
 
+    unsigned long cols = sourceImage.getWidth();
+    unsigned long rows = sourceImage.getHeight();
+    unsigned long frames = sourceImage.getFrameCount();
+
+    // never use more threads than there are rows in a frame
+    if (numberOfThreads > rows) numberOfThreads = OFstatic_cast(Uint32, rows);
+    if (numberOfThreads < 1) numberOfThreads = 1;
+
+    OFTimer timer;
     DcmQuantColorTable chv;
-    result = chv.computeHistogram(sourceImage, DcmQuantMaxColors);
+    result = chv.computeHistogram(sourceImage, DcmQuantMaxColors, numberOfThreads);
     if (result.bad()) return result;
 
     unsigned long maxval = chv.getMaxVal();
-    DCMIMAGE_DEBUG("image histogram: found " << chv.getColors() << " colors (at maxval=" << maxval << ")");
+    DCMIMAGE_DEBUG("image histogram: found " << chv.getColors() << " colors (at maxval=" << maxval << ") in " << timer);
 
     // apply median-cut to histogram, making the new colormap.
-    unsigned long cols = sourceImage.getWidth();
-    unsigned long rows = sourceImage.getHeight();
-    unsigned long frames = sourceImage.getFrameCount();
-
     DCMIMAGE_DEBUG("computing color map using Heckbert's median cut algorithm");
 
+    timer.reset();
     DcmQuantColorTable colormap;
     result = colormap.medianCut(chv, cols * rows * frames, maxval, numberOfColors, largeType, repType);
     if (result.bad()) return result;
     chv.clear(); // frees most memory used by chv.
+    DCMIMAGE_DEBUG("color map with " << colormap.getColors() << " entries computed in " << timer);
 
     // map the colors in the image to their closest match in the
     // new colormap, and write 'em out.
     DcmQuantColorHashTable cht;
     DCMIMAGE_DEBUG("mapping image data to color table");
+    timer.reset();
 
     DcmQuantFloydSteinberg fs;
     if (floydSteinberg)
@@ -113,6 +278,16 @@ OFCondition DcmQuant::createPaletteColorImage(
          result = target.insert(pixelData, OFTrue);
          if (result.good())
          {
+#ifdef WITH_THREADS
+            // error diffusion propagates from row to row, thus only the direct mapping is parallelized
+            if ((numberOfThreads > 1) && ! floydSteinberg)
+            {
+              DCMIMAGE_DEBUG("using " << numberOfThreads << " threads for color mapping");
+              mapFramesParallel(sourceImage, maxval, colormap, numberOfThreads,
+                isByteData ? imageData8 : NULL, isByteData ? NULL : imageData16);
+            }
+            else
+#endif
             for (unsigned long ff=0; ff<frames; ff++)
             {
               if (isByteData)
@@ -128,6 +303,7 @@ OFCondition DcmQuant::createPaletteColorImage(
                   else DcmQuantColorMapping<DcmQuantIdent,    Uint16>::create(sourceImage, ff, maxval, cht, colormap, id, imageData16 + cols*rows*ff);
              }
             } // for all frames
+            DCMIMAGE_DEBUG("image data mapped to color table in " << timer);
 
             // image creation is complete, finally adjust byte order if necessary
             if (isByteData)
@@ -1282,8 +1282,9 @@ storeSCU(T_ASC_Association *assoc, const char *fname)
   /* which is encapsulated in the file will be available through the DcmFileFormat object. */
   /* In detail, it will be available through calls to DcmFileFormat::getMetaInfo() (for */
   /* meta header information) and DcmFileFormat::getDataset() (for data set information). */
+  /* Large element values (e.g. pixel data) are not loaded but streamed from the file when sent. */
   DcmFileFormat dcmff;
-  OFCondition cond = dcmff.loadFile(fname, EXS_Unknown, EGL_noChange, DCM_MaxReadLength, opt_readMode);
+  OFCondition cond = dcmff.loadFileWithBulkData(fname, DCM_MaxReadLength, EXS_Unknown, EGL_noChange, opt_readMode);
 
   /* figure out if an error occured while the file was read*/
   if (cond.bad()) {
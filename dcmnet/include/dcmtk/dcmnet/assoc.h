@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -248,6 +248,7 @@ struct DCMTK_DCMNET_EXPORT T_ASC_Association
     unsigned short nextMsgID;     /* should be incremented by user */
     unsigned long sendPDVLength;  /* max length of PDV to send out */
     unsigned char *sendPDVBuffer; /* buffer of size sendPDVLength */
+    DcmAssociationStatistics *statistics; /* performance counters, NULL if not attached */
 };
 
 /*
@@ -639,6 +640,17 @@ ASC_dumpConnectionParameters(OFString& str, T_ASC_Association *association);
 
 DCMTK_DCMNET_EXPORT void ASC_activateCallback(T_ASC_Parameters *params, DUL_ModeCallback *cb);
 
+/** attaches performance counters to an association. From then on, the PDUs and
+ *  bytes sent and received, the latencies of the DIMSE operations and the time
+ *  spent in the different processing phases are recorded in the given object.
+ *  PDUs exchanged before this function is called (e.g.\ the A-ASSOCIATE-RQ)
+ *  are not counted.
+ *  @param association the association
+ *  @param stats performance counters, NULL to detach. The object is not copied
+ *    and must remain valid as long as it is attached to the association.
+ */
+DCMTK_DCMNET_EXPORT void ASC_setStatistics(T_ASC_Association *association, DcmAssociationStatistics *stats);
+
 /*
  * Association Inquiries
  */
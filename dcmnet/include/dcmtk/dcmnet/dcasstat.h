@@ -0,0 +1,379 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Performance counters and timing information for an association
+ *
+ */
+
+#ifndef DCASSTAT_H
+#define DCASSTAT_H
+
+#include "dcmtk/config/osconfig.h"  /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftypes.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/ofstd/ofstream.h"
+#include "dcmtk/ofstd/offile.h"     /* for class OFFilename */
+#include "dcmtk/ofstd/ofcond.h"
+#include "dcmtk/dcmnet/dndefine.h"
+
+struct T_DIMSE_Message;
+
+
+/** Performance counters and timing information of a single association.
+ *  An instance of this class can be attached to an association using
+ *  ASC_setStatistics(). From then on, the DUL layer counts the PDUs and bytes
+ *  sent and received as well as the time spent in network I/O, and the DIMSE
+ *  layer measures the latency of each DIMSE operation and the time spent for
+ *  encoding and decoding datasets and for writing received datasets to file.
+ *  The collected values can be queried using the get...() methods or exported
+ *  in the text format used by Prometheus.
+ *  This class is not thread-safe. Since an association is only used by a
+ *  single thread at a time, this is no restriction for the counters of a
+ *  single association. Counters of several associations can be combined
+ *  using merge().
+ */
+class DCMTK_DCMNET_EXPORT DcmAssociationStatistics
+{
+public:
+
+  /// phases of the processing of an association that are timed separately
+  enum E_Phase
+  {
+    /// reading and writing PDUs, including the time waiting for the peer
+    EP_Network,
+    /// encoding and decoding of command and data sets
+    EP_Dataset,
+    /// writing received data sets to file
+    EP_Storage
+  };
+
+  /// number of phases, see E_Phase
+  static const size_t NumberOfPhases = 3;
+
+  /// DIMSE operations for which latencies are recorded
+  enum E_Operation
+  {
+    /// C-ECHO
+    EO_CEcho,
+    /// C-STORE
+    EO_CStore,
+    /// C-FIND
+    EO_CFind,
+    /// C-GET
+    EO_CGet,
+    /// C-MOVE
+    EO_CMove,
+    /// N-EVENT-REPORT
+    EO_NEventReport,
+    /// N-GET
+    EO_NGet,
+    /// N-SET
+    EO_NSet,
+    /// N-ACTION
+    EO_NAction,
+    /// N-CREATE
+    EO_NCreate,
+    /// N-DELETE
+    EO_NDelete
+  };
+
+  /// number of operations, see E_Operation
+  static const size_t NumberOfOperations = 11;
+
+  /// number of finite upper bounds of the latency histograms
+  static const size_t NumberOfBuckets = 12;
+
+  /// upper bounds of the buckets of the latency histograms (in seconds)
+  static const double BucketBounds[NumberOfBuckets];
+
+  /** histogram of the latencies of a DIMSE operation
+   */
+  struct DCMTK_DCMNET_EXPORT LatencyHistogram
+  {
+    /// constructor, creates an empty histogram
+    LatencyHistogram();
+
+    /** adds a single latency to the histogram
+     *  @param seconds latency in seconds
+     */
+    void add(const double seconds);
+
+    /** adds all values of another histogram to this histogram
+     *  @param other the histogram to be added
+     */
+    void merge(const LatencyHistogram& other);
+
+    /// number of latencies added
+    unsigned long Count;
+
+    /// sum of all latencies added (in seconds)
+    double Sum;
+
+    /// maximum latency added (in seconds)
+    double Max;
+
+    /** number of latencies per bucket. Bucket i counts the latencies
+     *  greater than BucketBounds[i-1] and less than or equal to BucketBounds[i].
+     *  The last bucket counts all latencies greater than the largest bound.
+     */
+    unsigned long Buckets[NumberOfBuckets + 1];
+  };
+
+  /// default constructor
+  DcmAssociationStatistics();
+
+  /// destructor
+  virtual ~DcmAssociationStatistics();
+
+  /** resets all counters
+   */
+  void clear();
+
+  /** adds all counters of another instance to this instance, e.g.\ in order
+   *  to compute the total of all associations handled by a server.
+   *  Requests still waiting for a response are not taken over.
+   *  @param other the counters to be added
+   */
+  void merge(const DcmAssociationStatistics& other);
+
+  /** returns the current time in seconds, used for all measurements of this class.
+   *  This is the time returned by OFTimer::getTime().
+   *  @return time in seconds since an arbitrary point in time
+   */
+  static double now();
+
+  // --- methods called by the DUL and DIMSE layers
+
+  /** records that a PDU has been received
+   *  @param bytes number of bytes of the PDU including the PDU header
+   */
+  void pduReceived(const unsigned long bytes);
+
+  /** records that a PDU has been sent
+   *  @param bytes number of bytes of the PDU including the PDU header
+   */
+  void pduSent(const unsigned long bytes);
+
+  /** adds the given time to a processing phase
+   *  @param phase the processing phase
+   *  @param seconds time in seconds
+   */
+  void addPhaseTime(const E_Phase phase, const double seconds);
+
+  /** records that a DIMSE command has been received. If the command is a
+   *  request, the time is remembered so that the latency of the operation
+   *  can be computed when the final response is sent.
+   *  @param msg the DIMSE command
+   */
+  void messageReceived(const T_DIMSE_Message& msg);
+
+  /** records that a DIMSE command has been sent. If the command is a
+   *  request, the time is remembered so that the latency of the operation
+   *  can be computed when the final response is received.
+   *  @param msg the DIMSE command
+   */
+  void messageSent(const T_DIMSE_Message& msg);
+
+  // --- structured access to the counters
+
+  /** returns the number of bytes received
+   *  @return number of bytes received, including PDU headers
+   */
+  Uint64 getBytesReceived() const { return m_bytesReceived; }
+
+  /** returns the number of bytes sent
+   *  @return number of bytes sent, including PDU headers
+   */
+  Uint64 getBytesSent() const { return m_bytesSent; }
+
+  /** returns the number of PDUs received
+   *  @return number of PDUs received
+   */
+  unsigned long getPDUsReceived() const { return m_pdusReceived; }
+
+  /** returns the number of PDUs sent
+   *  @return number of PDUs sent
+   */
+  unsigned long getPDUsSent() const { return m_pdusSent; }
+
+  /** returns the number of DIMSE commands received
+   *  @return number of DIMSE commands received
+   */
+  unsigned long getMessagesReceived() const { return m_messagesReceived; }
+
+  /** returns the number of DIMSE commands sent
+   *  @return number of DIMSE commands sent
+   */
+  unsigned long getMessagesSent() const { return m_messagesSent; }
+
+  /** returns the time spent in a processing phase
+   *  @param phase the processing phase
+   *  @return time in seconds
+   */
+  double getPhaseTime(const E_Phase phase) const;
+
+  /** returns the latencies of the operations performed for the peer, i.e.\ the
+   *  times from the receipt of a request to the sending of the final response.
+   *  @param op the DIMSE operation
+   *  @return histogram of the latencies
+   */
+  const LatencyHistogram& getPerformedLatencies(const E_Operation op) const;
+
+  /** returns the latencies of the operations requested from the peer, i.e.\ the
+   *  times from the sending of a request to the receipt of the final response.
+   *  @param op the DIMSE operation
+   *  @return histogram of the latencies
+   */
+  const LatencyHistogram& getRequestedLatencies(const E_Operation op) const;
+
+  /** returns the name of a DIMSE operation
+   *  @param op the DIMSE operation
+   *  @return name of the operation, e.g.\ "C-STORE"
+   */
+  static const char *operationName(const E_Operation op);
+
+  /** returns the name of a processing phase
+   *  @param phase the processing phase
+   *  @return name of the phase, e.g.\ "network"
+   */
+  static const char *phaseName(const E_Phase phase);
+
+  // --- export
+
+  /** writes a short human readable summary of the counters to a stream
+   *  @param out output stream
+   */
+  void print(STD_NAMESPACE ostream& out) const;
+
+  /** writes all counters in the Prometheus text exposition format to a stream.
+   *  Histograms are only written for operations that occurred at least once.
+   *  @param out output stream
+   *  @param labels optional labels added to each sample, e.g.\ 'aetitle="STORESCP"'
+   */
+  void writePrometheus(STD_NAMESPACE ostream& out,
+                       const OFString& labels = "") const;
+
+  /** writes all counters in the Prometheus text exposition format to a file.
+   *  The file is written to a temporary file (filename + ".tmp") first which
+   *  is then renamed, so that a concurrent reader never sees an incomplete
+   *  file. On systems where renaming does not replace an existing file, the
+   *  existing file is renamed to filename + ".bak" first and only removed
+   *  after the new file is in place. This fallback is not atomic: a reader
+   *  might not find the file for a short time. If the file cannot be replaced
+   *  at all, it is left unchanged and the temporary file is kept.
+   *  @param filename name of the file to be written
+   *  @param labels optional labels added to each sample
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition savePrometheusFile(const OFFilename& filename,
+                                 const OFString& labels = "") const;
+
+  /** helper class that adds the time between its construction and destruction
+   *  to a processing phase, excluding the network time recorded in the meantime.
+   *  Does nothing if no statistics object is given.
+   */
+  class DCMTK_DCMNET_EXPORT PhaseTimer
+  {
+  public:
+    /** constructor, starts the timer
+     *  @param stats statistics to be updated, may be NULL
+     *  @param phase the processing phase
+     */
+    PhaseTimer(DcmAssociationStatistics *stats, const E_Phase phase);
+
+    /// destructor, adds the elapsed time to the phase
+    ~PhaseTimer();
+
+  private:
+    /// private undefined copy constructor
+    PhaseTimer(const PhaseTimer&);
+
+    /// private undefined copy assignment operator
+    PhaseTimer& operator=(const PhaseTimer&);
+
+    /// statistics to be updated, may be NULL
+    DcmAssociationStatistics *m_stats;
+
+    /// the processing phase
+    E_Phase m_phase;
+
+    /// time when the timer was started
+    double m_start;
+
+    /// network time when the timer was started
+    double m_networkStart;
+  };
+
+private:
+
+  /** maps a DIMSE command to an operation
+   *  @param msg DIMSE command
+   *  @param op returns the operation
+   *  @param isRequest returns whether the command is a request
+   *  @param isFinal returns whether the command is a final (i.e.\ not a pending) response
+   *  @return OFTrue if the command belongs to an operation with a latency, OFFalse otherwise
+   */
+  static OFBool mapCommand(const T_DIMSE_Message& msg, E_Operation& op,
+                           OFBool& isRequest, OFBool& isFinal);
+
+  /** writes a single latency histogram in Prometheus format
+   *  @param out output stream
+   *  @param name metric name
+   *  @param labels labels of the histogram (without bucket label)
+   *  @param hist the histogram
+   */
+  static void writePrometheusHistogram(STD_NAMESPACE ostream& out,
+                                       const char *name,
+                                       const OFString& labels,
+                                       const LatencyHistogram& hist);
+
+  /// number of bytes received
+  Uint64 m_bytesReceived;
+
+  /// number of bytes sent
+  Uint64 m_bytesSent;
+
+  /// number of PDUs received
+  unsigned long m_pdusReceived;
+
+  /// number of PDUs sent
+  unsigned long m_pdusSent;
+
+  /// number of DIMSE commands received
+  unsigned long m_messagesReceived;
+
+  /// number of DIMSE commands sent
+  unsigned long m_messagesSent;
+
+  /// time spent per processing phase (in seconds)
+  double m_phaseTime[NumberOfPhases];
+
+  /// latencies of the operations performed for the peer
+  LatencyHistogram m_performed[NumberOfOperations];
+
+  /// latencies of the operations requested from the peer
+  LatencyHistogram m_requested[NumberOfOperations];
+
+  /// time when the last request was received per operation, negative if none is pending
+  double m_performedStart[NumberOfOperations];
+
+  /// time when the last request was sent per operation, negative if none is pending
+  double m_requestedStart[NumberOfOperations];
+};
+
+#endif // DCASSTAT_H
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2017, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -178,11 +178,34 @@ public:
    */
   const DcmPresentationContextList *getPresentationContextList(const char *key) const;
 
+  /** returns the first entry for the given abstract syntax in the list of
+   *  presentation contexts identified by the given key. In contrast to a
+   *  search through the list, this method uses an index and takes logarithmic
+   *  time, which matters when evaluating association requests with many
+   *  presentation contexts.
+   *  @param key presentation context list to search
+   *  @param abstractSyntax abstract syntax UID to search
+   *  @return pointer to presentation context list entry if found, NULL otherwise
+   */
+  const DcmPresentationContextItem *getPresentationContext(const char *key, const char *abstractSyntax) const;
+
 private:
 
+  /// type of the index of a single presentation context list, maps abstract syntax UIDs to list entries
+  typedef OFMap<OFString, const DcmPresentationContextItem *> AbstractSyntaxIndex;
+
+  /** adds all entries of the given list to the index
+   *  @param key presentation context list key
+   *  @param list the presentation context list
+   */
+  void addToIndex(const OFString& key, const DcmPresentationContextList& list);
+
   /// map of presentation context lists
   OFMap<OFString, DcmPresentationContextList *> map_;
 
+  /// index of the entries of all presentation context lists, organized by list key
+  OFMap<OFString, AbstractSyntaxIndex> index_;
+
 };
 
 #endif
@@ -0,0 +1,169 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Cache for datasets converted to a network transfer syntax
+ *
+ */
+
+#ifndef DCTRCACH_H
+#define DCTRCACH_H
+
+#include "dcmtk/config/osconfig.h"  /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofmap.h"
+#include "dcmtk/ofstd/ofstring.h"
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/dcmdata/dcxfer.h"
+#include "dcmtk/dcmnet/dndefine.h"
+
+class DcmDataset;
+
+
+/** Cache for datasets that have been converted to another transfer syntax,
+ *  e.g.\ decompressed or compressed for network transmission. Sending the
+ *  same SOP instance to several peers usually requires the same conversion
+ *  each time, which is expensive for compressed transfer syntaxes. If a
+ *  DcmSCU object is given an instance of this class (see
+ *  DcmSCU::setTranscodingCache()), the result of each conversion is stored
+ *  in the cache, and later conversions of the same SOP instance to the same
+ *  transfer syntax use the cached dataset instead. The same cache can be
+ *  shared by several SCUs, also across associations and (if DCMTK is compiled
+ *  with thread support) threads.
+ *
+ *  Entries are identified by SOP Instance UID and transfer syntax. Since the
+ *  content of a SOP instance must not change without changing its UID, this
+ *  is sufficient for correctly behaving applications; otherwise the cache
+ *  should be cleared after modifying a SOP instance. The total size of the
+ *  cached datasets is limited; if the limit is exceeded, the least recently
+ *  used entries are removed.
+ */
+class DCMTK_DCMNET_EXPORT DcmTranscodingCache
+{
+public:
+
+  /** constructor
+   *  @param maxSize maximum total size of the cached datasets in bytes
+   */
+  DcmTranscodingCache(const size_t maxSize = 64 * 1024 * 1024);
+
+  /** destructor
+   */
+  virtual ~DcmTranscodingCache();
+
+  /** set the maximum total size of the cached datasets. If the current size
+   *  exceeds the new maximum, the least recently used entries are removed.
+   *  @param maxSize maximum total size of the cached datasets in bytes
+   */
+  void setMaxSize(const size_t maxSize);
+
+  /** get the maximum total size of the cached datasets
+   *  @return maximum total size in bytes
+   */
+  size_t getMaxSize() const;
+
+  /** get the current total size of the cached datasets
+   *  @return current total size in bytes
+   */
+  size_t getSize();
+
+  /** get the number of cached datasets
+   *  @return number of entries
+   */
+  size_t getNumberOfEntries();
+
+  /** get a copy of the cached dataset for the given SOP instance and
+   *  transfer syntax
+   *  @param sopInstanceUID SOP Instance UID of the dataset
+   *  @param xfer transfer syntax the dataset has been converted to
+   *  @param dataset dataset that is replaced by a copy of the cached dataset
+   *    if there is such an entry, and left unchanged otherwise
+   *  @return OFTrue if the entry has been found, OFFalse otherwise
+   */
+  OFBool get(const OFString &sopInstanceUID,
+             const E_TransferSyntax xfer,
+             DcmDataset &dataset);
+
+  /** store a copy of the given dataset, which has been converted to the given
+   *  transfer syntax. Only the current representation of the pixel data is
+   *  kept in the cache. An existing entry for the same SOP instance and
+   *  transfer syntax is replaced. Datasets larger than the maximum size of
+   *  the cache are not stored.
+   *  @param sopInstanceUID SOP Instance UID of the dataset
+   *  @param xfer transfer syntax the dataset has been converted to
+   *  @param dataset the converted dataset
+   */
+  void put(const OFString &sopInstanceUID,
+           const E_TransferSyntax xfer,
+           const DcmDataset &dataset);
+
+  /** remove all entries from the cache
+   */
+  void clear();
+
+private:
+
+  /// private undefined copy constructor
+  DcmTranscodingCache(const DcmTranscodingCache &);
+
+  /// private undefined copy assignment operator
+  DcmTranscodingCache &operator=(const DcmTranscodingCache &);
+
+  /// entry of the cache
+  struct Entry
+  {
+    /// key of the entry, see makeKey()
+    OFString key;
+    /// the cached dataset
+    DcmDataset *dataset;
+    /// size of the dataset in bytes
+    size_t size;
+  };
+
+  /** create the key for the given SOP instance and transfer syntax
+   *  @param sopInstanceUID SOP Instance UID
+   *  @param xfer transfer syntax
+   *  @return key
+   */
+  static OFString makeKey(const OFString &sopInstanceUID,
+                          const E_TransferSyntax xfer);
+
+  /** remove least recently used entries until the total size does not
+   *  exceed the given limit. Must only be called while the mutex is locked.
+   *  @param limit maximum total size in bytes
+   */
+  void shrink(const size_t limit);
+
+#ifdef WITH_THREADS
+  /// mutex protecting the cache
+  OFMutex mutex_;
+#endif
+
+  /// cached entries, the most recently used one first
+  OFList<Entry> entries_;
+
+  /// index of the cached entries by key
+  OFMap<OFString, OFListIterator(Entry)> index_;
+
+  /// current total size of the cached datasets in bytes
+  size_t size_;
+
+  /// maximum total size of the cached datasets in bytes
+  size_t maxSize_;
+};
+
+#endif // DCTRCACH_H
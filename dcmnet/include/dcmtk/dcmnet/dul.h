@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -76,6 +76,7 @@
 class DcmTransportConnection;
 class DcmTransportLayer;
 class LST_HEAD;
+class DcmAssociationStatistics;
 
 // include this file in doxygen documentation
 
@@ -515,6 +516,9 @@ DCMTK_DCMNET_EXPORT OFCondition DUL_setTransportLayer(DUL_NETWORKKEY *callerNetw
 DCMTK_DCMNET_EXPORT void DUL_activateCompatibilityMode(DUL_ASSOCIATIONKEY *dulassoc, unsigned long mode);
 DCMTK_DCMNET_EXPORT void DUL_activateCallback(DUL_ASSOCIATIONKEY *dulassoc, DUL_ModeCallback *cb);
 
+/* attach performance counters to the association, NULL to detach */
+DCMTK_DCMNET_EXPORT void DUL_setStatistics(DUL_ASSOCIATIONKEY *dulassoc, DcmAssociationStatistics *stats);
+
 /*
  * function allowing to retrieve the peer certificate from the DUL layer
  */
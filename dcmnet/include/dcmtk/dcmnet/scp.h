@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2009-2018, OFFIS e.V.
+ *  Copyright (C) 2009-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -30,6 +30,7 @@
 #include "dcmtk/dcmnet/assoc.h"
 #include "dcmtk/dcmnet/dimse.h"     /* DIMSE network layer */
 #include "dcmtk/dcmnet/scpcfg.h"
+#include "dcmtk/dcmnet/dcasstat.h"
 #include "dcmtk/dcmnet/diutil.h"    /* for DCMNET_WARN() */
 
 
@@ -343,6 +344,13 @@ public:
    */
   void setAlwaysAcceptDefaultRole(const OFBool enabled);
 
+  /** Set whether performance counters are collected for each association. If enabled,
+   *  the counters of an association are passed to notifyAssociationStatistics() when
+   *  the association has been handled. Statistics are disabled by default.
+   *  @param enabled [in] Enable collection of statistics if OFTrue
+   */
+  void setStatisticsEnabled(const OFBool enabled);
+
   /* Get methods for SCP settings */
 
   /** Returns TCP/IP port number SCP listens for new connection requests
@@ -417,6 +425,11 @@ public:
    */
   OFBool getProgressNotificationMode() const;
 
+  /** Returns whether performance counters are collected for each association.
+   *  @return OFTrue if statistics are enabled, OFFalse otherwise
+   */
+  OFBool getStatisticsEnabled() const;
+
   /** Get access to the configuration of the SCP. Note that the functionality
    *  on the configuration object is shadowed by other API functions of DcmSCP.
    *  The existing functions are provided in order to not break users of this
@@ -435,6 +448,17 @@ public:
    */
   virtual OFCondition setConfig(const DcmSCPConfig& config);
 
+  /** Tells DcmSCP to accept secure TLS connections described by the given TLS layer.
+   *  The transport layer is used by listen() for all incoming associations. It is
+   *  not copied, i.e.\ the caller remains responsible for deleting it after the SCP
+   *  has stopped listening. Passing NULL switches back to unencrypted connections.
+   *  @param tlayer [in] The TLS transport layer including all TLS parameters
+   *  @return EC_Normal if given transport layer is ok. The transport layer can only
+   *          be changed if the SCP is not yet connected, otherwise
+   *          NET_EC_AlreadyConnected is returned.
+   */
+  virtual OFCondition useSecureConnection(DcmTransportLayer *tlayer);
+
   /* ************************************************************* */
   /*  Methods for receiving runtime (i.e. connection time) infos   */
   /* ************************************************************* */
@@ -474,6 +498,13 @@ public:
    */
   Uint32 getPeerMaxPDULength() const;
 
+  /** Returns the performance counters of the current (or, if none is running, the
+   *  last) association. The counters are only updated if statistics are enabled,
+   *  see setStatisticsEnabled().
+   *  @return Performance counters of the current or last association
+   */
+  const DcmAssociationStatistics& getAssociationStatistics() const;
+
   /// DcmThreadSCP needs access to configuration (m_cfg), at least
   friend class DcmThreadSCP;
 
@@ -495,6 +526,14 @@ protected:
                                OFString &abstractSyntax,
                                OFString &transferSyntax);
 
+  /** Returns the performance counters attached to the current association, e.g.\ in
+   *  order to measure the time spent for storing a received dataset by means of
+   *  DcmAssociationStatistics::PhaseTimer.
+   *  @return Performance counters of the current association, NULL if statistics are
+   *          disabled or there is no association running
+   */
+  DcmAssociationStatistics *getActiveAssociationStatistics();
+
   /** Aborts the current association by sending an A-ABORT request to the SCU.
    *  This method allows derived classes to abort an association in case of severe errors.
    *  @return status, EC_Normal if successful, an error code otherwise
@@ -579,6 +618,15 @@ protected:
    */
   virtual void notifyAssociationTermination();
 
+  /** Overwrite this function to be notified about the performance counters of an
+   *  association after it has been handled, e.g.\ in order to merge them into the
+   *  counters of the whole server or to export them. Only called if statistics
+   *  are enabled, see setStatisticsEnabled(). The standard handler prints a summary
+   *  to the DEBUG logger.
+   *  @param stats [in] Performance counters of the association
+   */
+  virtual void notifyAssociationStatistics(const DcmAssociationStatistics& stats);
+
   /** Overwrite this function to be notified about a connection timeout in
    *  non-blocking mode (see setConnectionBlockingMode() and setConnectionTimeout()
    *  methods). In blocking mode, this method has no effect since it's never called.
@@ -1138,6 +1186,12 @@ private:
   /// Current association run by this SCP
   T_ASC_Association *m_assoc;
 
+  /// Performance counters of the current or last association
+  DcmAssociationStatistics m_statistics;
+
+  /// Transport layer for secure connections, NULL if TLS is not used (not owned)
+  DcmTransportLayer *m_tLayer;
+
   /// SCP configuration. The configuration is a shared object since in some scenarios one
   /// might like to share a single configuration instance with multiple SCPs without copying
   /// it, e.g. in the context of the DcmSCPPool class.
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2012-2017, OFFIS e.V.
+ *  Copyright (C) 2012-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -208,6 +208,13 @@ public:
    */
   void setProgressNotificationMode(const OFBool mode);
 
+  /** Set whether performance counters are collected for each association, see
+   *  DcmSCP::getAssociationStatistics() and DcmSCP::notifyAssociationStatistics().
+   *  Statistics are disabled by default.
+   *  @param enabled [in] Enable collection of statistics if OFTrue
+   */
+  void setStatisticsEnabled(const OFBool enabled);
+
   /** Option to always accept a default role as association acceptor.
    *  If OFFalse (default) the acceptor will reject a presentation context proposed
    *  with Default role (no role selection at all) when it is configured for role
@@ -296,6 +303,12 @@ public:
    */
   OFBool getProgressNotificationMode() const;
 
+  /** Returns whether performance counters are collected for each association.
+   *  Statistics are disabled by default.
+   *  @return OFTrue if statistics are enabled, OFFalse otherwise
+   */
+  OFBool getStatisticsEnabled() const;
+
   /** Dump presentation contexts to given output stream, useful for debugging.
    *  @param out [out] The output stream
    *  @param profileName [in] The profile to dump. If empty (default), the currently
@@ -393,6 +406,9 @@ protected:
 
   /// Progress notification mode (default: OFTrue)
   OFBool m_progressNotificationMode;
+
+  /// Collect performance counters for each association (default: OFFalse)
+  OFBool m_statisticsEnabled;
 };
 
 /** Enables sharing configurations by multiple DcmSCPs.
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2008-2017, OFFIS e.V.
+ *  Copyright (C) 2008-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -31,6 +31,8 @@
 #include "dcmtk/dcmnet/dcasccfg.h"  /* for holding association config file infos */
 #include "dcmtk/ofstd/oflist.h"
 
+class DcmTranscodingCache;
+
 
 // include this file in doxygen documentation
 
@@ -669,6 +671,16 @@ public:
    */
   void setDatasetConversionMode(const OFBool mode);
 
+  /** Set the cache for datasets converted to the network transfer syntax. If set, the
+   *  result of each conversion performed by sendSTORERequest() is stored in the cache,
+   *  and converting the same SOP instance to the same transfer syntax again uses the
+   *  cached dataset. This only has an effect if dataset conversion is enabled (see
+   *  setDatasetConversionMode()). The cache can be shared by several SCUs.
+   *  @param cache [in] The cache to be used (not owned by this class), or NULL to use
+   *                    no cache (default)
+   */
+  void setTranscodingCache(DcmTranscodingCache *cache);
+
   /** Set the mode that specifies whether the progress of sending and receiving DIMSE
    *  messages is notified by calling notifySENDProgress() and notifyRECEIVEProgress(),
    *  respectively. The progress notification is enabled by default.
@@ -761,6 +773,11 @@ public:
    */
   OFBool getDatasetConversionMode() const;
 
+  /** Returns the cache for datasets converted to the network transfer syntax
+   *  @return The cache used, or NULL if none (default)
+   */
+  DcmTranscodingCache *getTranscodingCache() const;
+
   /** Returns the mode that specifies whether the progress of sending and receiving DIMSE
    *  messages is notified by calling notifySENDProgress() and notifyRECEIVEProgress(),
    *  respectively. The progress notification is enabled by default.
@@ -968,6 +985,9 @@ protected:
 
 private:
 
+  /// The association pool needs access to the association and its parameters
+  friend class DcmSCUPool;
+
   /** Private undefined copy-constructor. Shall never be called.
    *  @param src Source object
    */
@@ -1068,6 +1088,9 @@ private:
   /// Progress notification mode (default: enabled)
   OFBool m_progressNotificationMode;
 
+  /// Cache for datasets converted to the network transfer syntax (default: none, not owned)
+  DcmTranscodingCache *m_transcodingCache;
+
   /** Returns next available message ID free to be used by SCU
    *  @return Next free message ID
    */
@@ -0,0 +1,249 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Class managing a pool of established associations that can be
+ *           reused by several SCUs, possibly running in different threads.
+ *
+ */
+
+#ifndef SCUPOOL_H
+#define SCUPOOL_H
+
+#include "dcmtk/config/osconfig.h"  /* make sure OS specific configuration is included first */
+
+#ifdef WITH_THREADS // Without threads this does not make sense...
+
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofmap.h"
+#include "dcmtk/dcmnet/scu.h"
+
+#define INCLUDE_CTIME
+#include "dcmtk/ofstd/ofstdinc.h"
+
+/** Pool of established associations for DcmSCU objects. Applications that
+ *  send many short requests to the same peer (e.g. a router issuing C-FIND
+ *  queries) can use this class instead of negotiating and releasing a new
+ *  association for each request. Associations are identified by the peer
+ *  (host name, port and AE titles), the set of presentation contexts that
+ *  has been requested and the class of the SCU object, so an association is
+ *  only handed out to an SCU that would have negotiated the very same
+ *  association itself.
+ *
+ *  An SCU is obtained by configuring a new object of class DcmSCU or of a
+ *  derived class (peer, AE titles, presentation contexts, etc.) that has been
+ *  created with new, and passing it to acquire(). If a suitable idle
+ *  association is available, the object passed is deleted and replaced by
+ *  the SCU owning that association, which takes over the request related
+ *  settings (e.g. timeouts) of the object passed; otherwise a new association
+ *  is negotiated for the object passed. The SCU returned is always of the
+ *  same class as the object passed, so it can safely be cast to that class
+ *  and has the same overridden handlers. However, member variables of a
+ *  derived class are not copied, i.e.\ such an SCU must not keep request
+ *  related state in additional member variables, or has to reset this state
+ *  after acquire(). After use, the SCU is handed back to the pool by calling
+ *  release(), which takes over ownership in any case. All methods can be
+ *  called from different threads concurrently, but each SCU must only be
+ *  used by one thread at a time.
+ *
+ *  Before an idle association is handed out, the pool checks whether the peer
+ *  has closed it in the meantime. If the association has been idle for longer
+ *  than the health check interval and the Verification SOP Class has been
+ *  accepted for it, a C-ECHO request is sent in addition. Associations that
+ *  have been idle for longer than the maximum idle time are released.
+ *  @remark This class is only available if DCMTK is compiled with thread
+ *  support enabled.
+ */
+class DCMTK_DCMNET_EXPORT DcmSCUPool
+{
+public:
+
+  /** Constructor
+   */
+  DcmSCUPool();
+
+  /** Destructor, releases all idle associations. SCUs that have been
+   *  acquired but not released yet are not affected.
+   */
+  virtual ~DcmSCUPool();
+
+  /** Set the maximum number of idle associations that are kept per peer and
+   *  set of presentation contexts. Further associations handed back to the
+   *  pool are released. Default: 4.
+   *  @param count The maximum number of idle associations per peer and
+   *    set of presentation contexts
+   */
+  void setMaxIdleAssociations(const size_t count);
+
+  /** Set the number of seconds an association may be idle before it is
+   *  released by the pool. This should be shorter than the time after which
+   *  the peer gives up idle associations. Default: 60 seconds.
+   *  @param seconds The maximum idle time in seconds
+   */
+  void setMaxIdleTime(const Uint32 seconds);
+
+  /** Set the number of seconds after which an idle association is checked
+   *  with a C-ECHO request before it is handed out again. A value of 0 means
+   *  that the check is performed each time. The check is only performed if
+   *  the Verification SOP Class is part of the presentation contexts of the
+   *  association. Default: 10 seconds.
+   *  @param seconds The health check interval in seconds
+   */
+  void setHealthCheckInterval(const Uint32 seconds);
+
+  /** Get the maximum number of idle associations per peer and set of
+   *  presentation contexts.
+   *  @return The maximum number of idle associations
+   */
+  size_t getMaxIdleAssociations() const;
+
+  /** Get the maximum idle time of an association.
+   *  @return The maximum idle time in seconds
+   */
+  Uint32 getMaxIdleTime() const;
+
+  /** Get the health check interval.
+   *  @return The health check interval in seconds
+   */
+  Uint32 getHealthCheckInterval() const;
+
+  /** Obtain an SCU with an established association. If an idle association
+   *  matching the configuration of the given SCU is available in the pool
+   *  and owned by an SCU of the same class, the given SCU is deleted and
+   *  replaced by the SCU owning that association. The settings of the given
+   *  SCU that do not affect the association negotiation, i.e.\ DIMSE and ACSE
+   *  timeout, DIMSE blocking mode, storage directory and mode, verbose
+   *  presentation context mode, dataset conversion mode, transcoding cache
+   *  and progress notification mode, are copied to the SCU returned.
+   *  Otherwise, initNetwork() and negotiateAssociation() are called on the
+   *  given SCU. In any case, the caller owns the SCU returned and should hand
+   *  it back to the pool by calling release() after use.
+   *  @param scu [in/out] On input, an SCU that has been created with new and
+   *    configured (peer, AE titles, presentation contexts, etc.) but is not
+   *    connected yet. It may be of a class derived from DcmSCU.
+   *    On output, an SCU with an established association if the method
+   *    succeeded, or the unconnected SCU passed if it failed.
+   *  @return EC_Normal if an association could be provided, an error code
+   *    otherwise
+   */
+  OFCondition acquire(DcmSCU *&scu);
+
+  /** Hand an SCU back to the pool. If the SCU is still connected and the
+   *  maximum number of idle associations has not been reached yet, the
+   *  association is kept for later use; otherwise the association is
+   *  released and the SCU is deleted. In any case, the pool takes over
+   *  ownership of the SCU.
+   *  @param scu The SCU to be handed back, usually obtained by acquire().
+   *    If NULL, the call is ignored.
+   *  @param reusable If OFFalse, the association is released in any case,
+   *    e.g. because an error occurred that makes its further use
+   *    questionable.
+   */
+  void release(DcmSCU *scu,
+               const OFBool reusable = OFTrue);
+
+  /** Release all idle associations that are currently kept in the pool.
+   */
+  void closeIdleAssociations();
+
+  /** Get the number of idle associations currently kept in the pool.
+   *  @return The number of idle associations
+   */
+  size_t getNumberOfIdleAssociations();
+
+protected:
+
+  /** Check whether an idle association can still be used. If this method
+   *  returns OFFalse, the association is aborted by the caller.
+   *  @param scu The SCU owning the association
+   *  @param idleTime Number of seconds the association has been idle
+   *  @return OFTrue if the association can be used, OFFalse otherwise
+   */
+  virtual OFBool checkAssociation(DcmSCU &scu,
+                                  const time_t idleTime);
+
+private:
+
+  /** Private undefined copy-constructor. Shall never be called.
+   *  @param src Source object
+   */
+  DcmSCUPool(const DcmSCUPool &src);
+
+  /** Private undefined operator=. Shall never be called.
+   *  @param src Source object
+   *  @return Reference to this
+   */
+  DcmSCUPool &operator=(const DcmSCUPool &src);
+
+  /// Idle association kept in the pool
+  struct IdleAssociation
+  {
+    /// The SCU owning the association
+    DcmSCU *scu;
+    /// Point in time the SCU has been handed back to the pool
+    time_t since;
+  };
+
+  /** Create the key that identifies the associations an SCU would negotiate,
+   *  i.e.\ its peer and the requested presentation contexts, and its class.
+   *  @param scu The SCU
+   *  @return The key
+   */
+  static OFString makeKey(const DcmSCU &scu);
+
+  /** Copy the settings that only affect the processing of requests on an
+   *  established association (timeouts, blocking mode, storage directory,
+   *  etc.) from one SCU to another. Used for handing out an idle association
+   *  with the settings of the SCU passed to acquire().
+   *  @param src The SCU to copy the settings from
+   *  @param dst The SCU to copy the settings to
+   */
+  static void copySettings(const DcmSCU &src,
+                           DcmSCU &dst);
+
+  /** Move all associations that have been idle for too long to the given
+   *  list. Must only be called while the mutex is locked.
+   *  @param now The current time
+   *  @param expired List the expired SCUs are appended to
+   */
+  void collectExpired(const time_t now,
+                      OFList<DcmSCU *> &expired);
+
+  /** Release the associations of the given SCUs and delete them.
+   *  @param scus The SCUs to be closed
+   */
+  static void closeAll(OFList<DcmSCU *> &scus);
+
+  /// Mutex protecting the list of idle associations
+  OFMutex m_mutex;
+
+  /// Idle associations, the most recently used one at the end of each list
+  OFMap<OFString, OFList<IdleAssociation> > m_idle;
+
+  /// Maximum number of idle associations per key
+  size_t m_maxIdleAssociations;
+
+  /// Maximum idle time in seconds
+  Uint32 m_maxIdleTime;
+
+  /// Health check interval in seconds
+  Uint32 m_healthCheckInterval;
+};
+
+#endif // WITH_THREADS
+
+#endif // SCUPOOL_H
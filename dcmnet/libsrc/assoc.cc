@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -98,6 +98,7 @@
 
 #include "dcmtk/dcmnet/assoc.h"       /* always include the module header */
 #include "dcmtk/dcmnet/diutil.h"
+#include "dcmtk/ofstd/ofvector.h"
 
 #define INCLUDE_CSTDLIB
 #define INCLUDE_CSTDIO
@@ -809,22 +810,20 @@ ASC_getPresentationContext(T_ASC_Parameters * params,
     return EC_Normal;
 }
 
-OFCondition
-ASC_acceptPresentationContext(
+/* accept the given proposed presentation context, see ASC_acceptPresentationContext() */
+static OFCondition
+acceptProposedContext(
     T_ASC_Parameters * params,
-    T_ASC_PresentationContextID presentationContextID,
+    DUL_PRESENTATIONCONTEXT *proposedContext,
     const char* transferSyntax,
     T_ASC_SC_ROLE acceptedRole,
     const OFBool alwaysAcceptDefaultRole)
 {
-    DUL_PRESENTATIONCONTEXT *proposedContext, *acceptedContext;
+    DUL_PRESENTATIONCONTEXT *acceptedContext;
     OFCondition cond = EC_Normal;
     LST_HEAD *lst;
+    const T_ASC_PresentationContextID presentationContextID = proposedContext->presentationContextID;
 
-    proposedContext = findPresentationContextID(
-                              params->DULparams.requestedPresentationContext,
-                                                presentationContextID);
-    if (proposedContext == NULL) return ASC_BADPRESENTATIONCONTEXTID;
     OFStandard::strlcpy(proposedContext->acceptedTransferSyntax, transferSyntax, sizeof(proposedContext->acceptedTransferSyntax));
 
     /* we want to mark this proposed context as being ok */
@@ -894,21 +893,34 @@ ASC_acceptPresentationContext(
     return EC_Normal;
 }
 
-
 OFCondition
-ASC_refusePresentationContext(
+ASC_acceptPresentationContext(
     T_ASC_Parameters * params,
     T_ASC_PresentationContextID presentationContextID,
+    const char* transferSyntax,
+    T_ASC_SC_ROLE acceptedRole,
+    const OFBool alwaysAcceptDefaultRole)
+{
+    DUL_PRESENTATIONCONTEXT *proposedContext = findPresentationContextID(
+                              params->DULparams.requestedPresentationContext,
+                                                presentationContextID);
+    if (proposedContext == NULL) return ASC_BADPRESENTATIONCONTEXTID;
+    return acceptProposedContext(params, proposedContext, transferSyntax,
+        acceptedRole, alwaysAcceptDefaultRole);
+}
+
+
+/* refuse the given proposed presentation context, see ASC_refusePresentationContext() */
+static OFCondition
+refuseProposedContext(
+    T_ASC_Parameters * params,
+    DUL_PRESENTATIONCONTEXT *proposedContext,
     T_ASC_P_ResultReason resultReason)
 {
-    DUL_PRESENTATIONCONTEXT *proposedContext, *acceptedContext;
+    DUL_PRESENTATIONCONTEXT *acceptedContext;
     OFCondition cond = EC_Normal;
     LST_HEAD *lst;
-
-    proposedContext = findPresentationContextID(
-                             params->DULparams.requestedPresentationContext,
-                                                presentationContextID);
-    if (proposedContext == NULL) return ASC_BADPRESENTATIONCONTEXTID;
+    const T_ASC_PresentationContextID presentationContextID = proposedContext->presentationContextID;
 
     /* we want to mark this proposed context as being refused */
     proposedContext->result = resultReason;
@@ -959,6 +971,19 @@ ASC_refusePresentationContext(
     return EC_Normal;
 }
 
+OFCondition
+ASC_refusePresentationContext(
+    T_ASC_Parameters * params,
+    T_ASC_PresentationContextID presentationContextID,
+    T_ASC_P_ResultReason resultReason)
+{
+    DUL_PRESENTATIONCONTEXT *proposedContext = findPresentationContextID(
+                             params->DULparams.requestedPresentationContext,
+                                                presentationContextID);
+    if (proposedContext == NULL) return ASC_BADPRESENTATIONCONTEXTID;
+    return refuseProposedContext(params, proposedContext, resultReason);
+}
+
 
 OFCondition
 ASC_findAcceptedPresentationContext(
@@ -1096,51 +1121,91 @@ ASC_findAcceptedPresentationContextID(
 }
 
 
-OFCondition
-ASC_acceptContextsWithTransferSyntax(
+/* comparison function for qsort() and bsearch() on arrays of UID strings */
+extern "C" {
+static int ASC_compareUIDStrings(const void *a, const void *b)
+{
+    return strcmp(*OFstatic_cast(const char * const *, a), *OFstatic_cast(const char * const *, b));
+}
+}
+
+/* Accepts each proposed presentation context whose abstract syntax is one
+ * of abstractSyntaxes[] with the first transfer syntax of transferSyntaxes[]
+ * that has also been proposed. The remaining presentation contexts are
+ * refused unless they have already been accepted. This is equivalent to
+ * calling ASC_acceptContextsWithTransferSyntax() for each transfer syntax
+ * from the least to the most preferred one, but only takes a single pass
+ * through the list of proposed presentation contexts.
+ */
+static OFCondition
+acceptContextsWithPreferredTransferSyntaxes(
     T_ASC_Parameters * params,
-    const char* transferSyntax,
-    int abstractSyntaxCount, const char* abstractSyntaxes[],
+    const char* abstractSyntaxes[], int abstractSyntaxCount,
+    const char* transferSyntaxes[], int transferSyntaxCount,
     T_ASC_SC_ROLE acceptedRole)
 {
     OFCondition cond = EC_Normal;
-    int n, i, j, k;
-    DUL_PRESENTATIONCONTEXT *dpc;
-    T_ASC_PresentationContext pc;
-    OFBool accepted = OFFalse;
-    OFBool abstractOK = OFFalse;
+    DUL_PRESENTATIONCONTEXT *pc, *dpc;
+    DUL_TRANSFERSYNTAX *transfer;
+    LST_HEAD **l;
+    LST_HEAD **t;
+    int i;
+
+    if (transferSyntaxCount < 1) return EC_Normal;
 
-    n = ASC_countPresentationContexts(params);
     // No presentation context proposed at all? Return error.
-    if (n == 0)
+    if (ASC_countPresentationContexts(params) == 0)
     {
       return ASC_NOPRESENTATIONCONTEXTPROPOSED;
     }
 
-    for (i = 0; i < n; i++) {
-        cond = ASC_getPresentationContext(params, i, &pc);
-        if (cond.bad()) return cond;
-        abstractOK = OFFalse;
-        accepted = OFFalse;
-        for (j = 0; j < abstractSyntaxCount && !accepted; j++) {
-            if (strcmp(pc.abstractSyntax, abstractSyntaxes[j]) == 0) {
-                abstractOK = OFTrue;
-                /* check the transfer syntax */
-                for (k = 0; (k < (int)pc.transferSyntaxCount) && !accepted; k++) {
-                    if (strcmp(pc.proposedTransferSyntaxes[k], transferSyntax) == 0) {
-                        accepted = OFTrue;
+    /* sort the abstract syntaxes for a binary search */
+    OFVector<const char*> sortedAbstractSyntaxes(abstractSyntaxes, abstractSyntaxes + abstractSyntaxCount);
+    if (abstractSyntaxCount > 1)
+        qsort(&sortedAbstractSyntaxes[0], abstractSyntaxCount, sizeof(const char*), ASC_compareUIDStrings);
+
+    /* the proposed presentation contexts are accessed directly (instead of
+     * using ASC_getPresentationContext()) since accepting or refusing a
+     * context does not modify this list
+     */
+    l = &(params->DULparams.requestedPresentationContext);
+    pc = (DUL_PRESENTATIONCONTEXT*) LST_Head(l);
+    (void)LST_Position(l, (LST_NODE*)pc);
+    while (pc)
+    {
+        const char *abstractSyntax = pc->abstractSyntax;
+        OFBool abstractOK = (abstractSyntaxCount > 0) &&
+            (bsearch(&abstractSyntax, &sortedAbstractSyntaxes[0], abstractSyntaxCount,
+                     sizeof(const char*), ASC_compareUIDStrings) != NULL);
+
+        /* find the most preferred transfer syntax that has been proposed */
+        int preferred = transferSyntaxCount;
+        if (abstractOK)
+        {
+            t = &pc->proposedTransferSyntax;
+            transfer = (DUL_TRANSFERSYNTAX*) LST_Head(t);
+            (void)LST_Position(t, (LST_NODE*)transfer);
+            while (transfer && (preferred > 0))
+            {
+                for (i = 0; i < preferred; i++)
+                {
+                    if (strcmp(transfer->transferSyntax, transferSyntaxes[i]) == 0)
+                    {
+                        preferred = i;
+                        break;
                     }
                 }
+                transfer = (DUL_TRANSFERSYNTAX*) LST_Next(t);
             }
         }
-        if (accepted) {
-            cond = ASC_acceptPresentationContext(
-                params, pc.presentationContextID,
-                transferSyntax, acceptedRole);
+
+        if (preferred < transferSyntaxCount)
+        {
+            cond = acceptProposedContext(params, pc,
+                transferSyntaxes[preferred], acceptedRole, OFFalse);
             // SCP/SCU role selection failed, reject presentation context
             if (cond == ASC_SCPSCUROLESELECTIONFAILED) {
-                cond = ASC_refusePresentationContext(params,
-                    pc.presentationContextID, ASC_P_NOREASON);
+                cond = refuseProposedContext(params, pc, ASC_P_NOREASON);
             }
             if (cond.bad()) return cond;
         } else {
@@ -1149,7 +1214,7 @@ ASC_acceptContextsWithTransferSyntax(
             /* do not refuse if already accepted */
             dpc = findPresentationContextID(
                               params->DULparams.acceptedPresentationContext,
-                                            pc.presentationContextID);
+                                            pc->presentationContextID);
             if ((dpc == NULL) ||
                 ((dpc != NULL) && (dpc->result != ASC_P_ACCEPTANCE))) {
 
@@ -1166,17 +1231,27 @@ ASC_acceptContextsWithTransferSyntax(
                     (dpc->result == ASC_P_TRANSFERSYNTAXESNOTSUPPORTED))
                     reason = ASC_P_TRANSFERSYNTAXESNOTSUPPORTED;
 
-                cond = ASC_refusePresentationContext(params,
-                                              pc.presentationContextID,
-                                              reason);
+                cond = refuseProposedContext(params, pc, reason);
                 if (cond.bad()) return cond;
             }
         }
-
+        pc = (DUL_PRESENTATIONCONTEXT*) LST_Next(l);
     }
     return EC_Normal;
 }
 
+OFCondition
+ASC_acceptContextsWithTransferSyntax(
+    T_ASC_Parameters * params,
+    const char* transferSyntax,
+    int abstractSyntaxCount, const char* abstractSyntaxes[],
+    T_ASC_SC_ROLE acceptedRole)
+{
+    return acceptContextsWithPreferredTransferSyntaxes(params,
+        abstractSyntaxes, abstractSyntaxCount,
+        &transferSyntax, 1, acceptedRole);
+}
+
 OFCondition
 ASC_acceptContextsWithPreferredTransferSyntaxes(
     T_ASC_Parameters * params,
@@ -1184,21 +1259,9 @@ ASC_acceptContextsWithPreferredTransferSyntaxes(
     const char* transferSyntaxes[], int transferSyntaxCount,
     T_ASC_SC_ROLE acceptedRole)
 {
-    int i;
-    OFCondition cond = EC_Normal;
-    /*
-    ** Accept in the order "least wanted" to "most wanted" transfer
-    ** syntax.  Accepting a transfer syntax will override previously
-    ** accepted transfer syntaxes.
-    */
-    for (i=transferSyntaxCount-1; i>=0; i--)
-    {
-        cond = ASC_acceptContextsWithTransferSyntax(
-            params, transferSyntaxes[i],
-            abstractSyntaxCount, abstractSyntaxes, acceptedRole);
-        if (cond.bad()) return cond;
-    }
-    return cond;
+    return acceptContextsWithPreferredTransferSyntaxes(params,
+        abstractSyntaxes, abstractSyntaxCount,
+        transferSyntaxes, transferSyntaxCount, acceptedRole);
 }
 
 void ASC_getRequestedExtNegList(T_ASC_Parameters* params, SOPClassExtendedNegotiationSubItemList** extNegList)
@@ -2180,6 +2243,15 @@ void ASC_activateCallback(T_ASC_Parameters *params, DUL_ModeCallback *cb)
   if (params) params->modeCallback = cb;
 }
 
+void ASC_setStatistics(T_ASC_Association *association, DcmAssociationStatistics *stats)
+{
+  if (association)
+  {
+    association->statistics = stats;
+    DUL_setStatistics(association->DULassociation, stats);
+  }
+}
+
 
 // Deprecated wrapper functions follow
 void ASC_printRejectParameters(FILE *f, const T_ASC_RejectParameters *rej)
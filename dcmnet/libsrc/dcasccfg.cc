@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2017, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -452,8 +452,7 @@ OFCondition DcmAssociationConfiguration::evaluateAssociationParameters(
   OFListConstIterator(DcmRoleSelectionItem) rslast;
   DcmUIDHandler uid;
   const DcmTransferSyntaxList *transferSyntaxList = NULL;
-  OFListConstIterator(DcmPresentationContextItem) first;
-  OFListConstIterator(DcmPresentationContextItem) last = contextList->end();
+  const DcmPresentationContextItem *contextItem = NULL;
   OFListConstIterator(DcmUIDHandler) tsfirst;
   OFListConstIterator(DcmUIDHandler) tslast;
   int numContexts = ASC_countPresentationContexts(assoc.params);
@@ -467,19 +466,9 @@ OFCondition DcmAssociationConfiguration::evaluateAssociationParameters(
     if (result.bad()) return result;
 
     // check if the abstract syntax is in our list of abstract syntaxes
-    first = contextList->begin();
-    found = OFFalse;
-    while (first != last)
-    {
-      if (0 == strcmp((*first).getAbstractSyntax(), pc.abstractSyntax))
-      {
-        found = OFTrue;
-        break; /* out of while loop */
-      }
-      ++first;
-    }
+    contextItem = contexts_.getPresentationContext(contextKey, pc.abstractSyntax);
 
-    if (!found)
+    if (!contextItem)
     {
       // abstract syntax not supported, reject presentation context
       result = ASC_refusePresentationContext(assoc.params, pc.presentationContextID,
@@ -489,7 +478,7 @@ OFCondition DcmAssociationConfiguration::evaluateAssociationParameters(
     else
     {
       // abstract syntax is supported, get transfer syntax list and SCP/SCU role
-      transferSyntaxKey = (*first).getTransferSyntaxKey();
+      transferSyntaxKey = contextItem->getTransferSyntaxKey();
       transferSyntaxList = xferSyntaxes_.getTransferSyntaxList(transferSyntaxKey);
       if (! transferSyntaxList)
       {
@@ -0,0 +1,450 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Performance counters and timing information for an association
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/dcmnet/dcasstat.h"
+#include "dcmtk/dcmnet/dimse.h"
+#include "dcmtk/dcmnet/cond.h"
+#include "dcmtk/dcmnet/diutil.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/ofstd.h"
+
+
+const double DcmAssociationStatistics::BucketBounds[NumberOfBuckets] =
+{
+  0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+};
+
+
+DcmAssociationStatistics::LatencyHistogram::LatencyHistogram()
+: Count(0)
+, Sum(0)
+, Max(0)
+{
+  for (size_t i = 0; i <= NumberOfBuckets; ++i)
+    Buckets[i] = 0;
+}
+
+
+void DcmAssociationStatistics::LatencyHistogram::add(const double seconds)
+{
+  size_t i = 0;
+  while ((i < NumberOfBuckets) && (seconds > BucketBounds[i]))
+    ++i;
+  ++Buckets[i];
+  ++Count;
+  Sum += seconds;
+  if (seconds > Max)
+    Max = seconds;
+}
+
+
+void DcmAssociationStatistics::LatencyHistogram::merge(const LatencyHistogram& other)
+{
+  for (size_t i = 0; i <= NumberOfBuckets; ++i)
+    Buckets[i] += other.Buckets[i];
+  Count += other.Count;
+  Sum += other.Sum;
+  if (other.Max > Max)
+    Max = other.Max;
+}
+
+
+DcmAssociationStatistics::DcmAssociationStatistics()
+: m_bytesReceived(0)
+, m_bytesSent(0)
+, m_pdusReceived(0)
+, m_pdusSent(0)
+, m_messagesReceived(0)
+, m_messagesSent(0)
+{
+  clear();
+}
+
+
+DcmAssociationStatistics::~DcmAssociationStatistics()
+{
+}
+
+
+void DcmAssociationStatistics::clear()
+{
+  m_bytesReceived = 0;
+  m_bytesSent = 0;
+  m_pdusReceived = 0;
+  m_pdusSent = 0;
+  m_messagesReceived = 0;
+  m_messagesSent = 0;
+  for (size_t i = 0; i < NumberOfPhases; ++i)
+    m_phaseTime[i] = 0;
+  for (size_t i = 0; i < NumberOfOperations; ++i)
+  {
+    m_performed[i] = LatencyHistogram();
+    m_requested[i] = LatencyHistogram();
+    m_performedStart[i] = -1;
+    m_requestedStart[i] = -1;
+  }
+}
+
+
+void DcmAssociationStatistics::merge(const DcmAssociationStatistics& other)
+{
+  m_bytesReceived += other.m_bytesReceived;
+  m_bytesSent += other.m_bytesSent;
+  m_pdusReceived += other.m_pdusReceived;
+  m_pdusSent += other.m_pdusSent;
+  m_messagesReceived += other.m_messagesReceived;
+  m_messagesSent += other.m_messagesSent;
+  for (size_t i = 0; i < NumberOfPhases; ++i)
+    m_phaseTime[i] += other.m_phaseTime[i];
+  for (size_t i = 0; i < NumberOfOperations; ++i)
+  {
+    m_performed[i].merge(other.m_performed[i]);
+    m_requested[i].merge(other.m_requested[i]);
+  }
+}
+
+
+double DcmAssociationStatistics::now()
+{
+  return OFTimer::getTime();
+}
+
+
+void DcmAssociationStatistics::pduReceived(const unsigned long bytes)
+{
+  ++m_pdusReceived;
+  m_bytesReceived += bytes;
+}
+
+
+void DcmAssociationStatistics::pduSent(const unsigned long bytes)
+{
+  ++m_pdusSent;
+  m_bytesSent += bytes;
+}
+
+
+void DcmAssociationStatistics::addPhaseTime(const E_Phase phase, const double seconds)
+{
+  // the clock might have been adjusted in the meantime
+  if (seconds > 0)
+    m_phaseTime[phase] += seconds;
+}
+
+
+OFBool DcmAssociationStatistics::mapCommand(const T_DIMSE_Message& msg,
+                                            E_Operation& op,
+                                            OFBool& isRequest,
+                                            OFBool& isFinal)
+{
+  isRequest = OFFalse;
+  isFinal = OFTrue;
+  switch (msg.CommandField)
+  {
+    case DIMSE_C_ECHO_RQ:         isRequest = OFTrue; /* fall through */
+    case DIMSE_C_ECHO_RSP:        op = EO_CEcho; break;
+    case DIMSE_C_STORE_RQ:        isRequest = OFTrue; /* fall through */
+    case DIMSE_C_STORE_RSP:       op = EO_CStore; break;
+    case DIMSE_C_FIND_RQ:         isRequest = OFTrue; op = EO_CFind; break;
+    case DIMSE_C_FIND_RSP:
+      op = EO_CFind;
+      isFinal = !DICOM_PENDING_STATUS(msg.msg.CFindRSP.DimseStatus);
+      break;
+    case DIMSE_C_GET_RQ:          isRequest = OFTrue; op = EO_CGet; break;
+    case DIMSE_C_GET_RSP:
+      op = EO_CGet;
+      isFinal = !DICOM_PENDING_STATUS(msg.msg.CGetRSP.DimseStatus);
+      break;
+    case DIMSE_C_MOVE_RQ:         isRequest = OFTrue; op = EO_CMove; break;
+    case DIMSE_C_MOVE_RSP:
+      op = EO_CMove;
+      isFinal = !DICOM_PENDING_STATUS(msg.msg.CMoveRSP.DimseStatus);
+      break;
+    case DIMSE_N_EVENT_REPORT_RQ: isRequest = OFTrue; /* fall through */
+    case DIMSE_N_EVENT_REPORT_RSP: op = EO_NEventReport; break;
+    case DIMSE_N_GET_RQ:          isRequest = OFTrue; /* fall through */
+    case DIMSE_N_GET_RSP:         op = EO_NGet; break;
+    case DIMSE_N_SET_RQ:          isRequest = OFTrue; /* fall through */
+    case DIMSE_N_SET_RSP:         op = EO_NSet; break;
+    case DIMSE_N_ACTION_RQ:       isRequest = OFTrue; /* fall through */
+    case DIMSE_N_ACTION_RSP:      op = EO_NAction; break;
+    case DIMSE_N_CREATE_RQ:       isRequest = OFTrue; /* fall through */
+    case DIMSE_N_CREATE_RSP:      op = EO_NCreate; break;
+    case DIMSE_N_DELETE_RQ:       isRequest = OFTrue; /* fall through */
+    case DIMSE_N_DELETE_RSP:      op = EO_NDelete; break;
+    default:
+      // C-CANCEL has no response, so there is no latency to be measured
+      return OFFalse;
+  }
+  return OFTrue;
+}
+
+
+void DcmAssociationStatistics::messageReceived(const T_DIMSE_Message& msg)
+{
+  ++m_messagesReceived;
+  E_Operation op;
+  OFBool isRequest, isFinal;
+  if (mapCommand(msg, op, isRequest, isFinal))
+  {
+    if (isRequest)
+      m_performedStart[op] = now();
+    else if (isFinal && (m_requestedStart[op] >= 0))
+    {
+      m_requested[op].add(now() - m_requestedStart[op]);
+      m_requestedStart[op] = -1;
+    }
+  }
+}
+
+
+void DcmAssociationStatistics::messageSent(const T_DIMSE_Message& msg)
+{
+  ++m_messagesSent;
+  E_Operation op;
+  OFBool isRequest, isFinal;
+  if (mapCommand(msg, op, isRequest, isFinal))
+  {
+    if (isRequest)
+      m_requestedStart[op] = now();
+    else if (isFinal && (m_performedStart[op] >= 0))
+    {
+      m_performed[op].add(now() - m_performedStart[op]);
+      m_performedStart[op] = -1;
+    }
+  }
+}
+
+
+double DcmAssociationStatistics::getPhaseTime(const E_Phase phase) const
+{
+  return m_phaseTime[phase];
+}
+
+
+const DcmAssociationStatistics::LatencyHistogram& DcmAssociationStatistics::getPerformedLatencies(const E_Operation op) const
+{
+  return m_performed[op];
+}
+
+
+const DcmAssociationStatistics::LatencyHistogram& DcmAssociationStatistics::getRequestedLatencies(const E_Operation op) const
+{
+  return m_requested[op];
+}
+
+
+const char *DcmAssociationStatistics::operationName(const E_Operation op)
+{
+  switch (op)
+  {
+    case EO_CEcho:        return "C-ECHO";
+    case EO_CStore:       return "C-STORE";
+    case EO_CFind:        return "C-FIND";
+    case EO_CGet:         return "C-GET";
+    case EO_CMove:        return "C-MOVE";
+    case EO_NEventReport: return "N-EVENT-REPORT";
+    case EO_NGet:         return "N-GET";
+    case EO_NSet:         return "N-SET";
+    case EO_NAction:      return "N-ACTION";
+    case EO_NCreate:      return "N-CREATE";
+    case EO_NDelete:      return "N-DELETE";
+  }
+  return "unknown";
+}
+
+
+const char *DcmAssociationStatistics::phaseName(const E_Phase phase)
+{
+  switch (phase)
+  {
+    case EP_Network: return "network";
+    case EP_Dataset: return "dataset";
+    case EP_Storage: return "storage";
+  }
+  return "unknown";
+}
+
+
+void DcmAssociationStatistics::print(STD_NAMESPACE ostream& out) const
+{
+  out << "PDUs received: " << m_pdusReceived << " (" << m_bytesReceived << " bytes), sent: "
+      << m_pdusSent << " (" << m_bytesSent << " bytes)" << OFendl;
+  out << "DIMSE messages received: " << m_messagesReceived << ", sent: " << m_messagesSent << OFendl;
+  out << "Time spent:";
+  for (size_t i = 0; i < NumberOfPhases; ++i)
+  {
+    const E_Phase phase = OFstatic_cast(E_Phase, i);
+    out << (i ? ", " : " ") << phaseName(phase) << " " << getPhaseTime(phase) << " s";
+  }
+  out << OFendl;
+  for (size_t i = 0; i < NumberOfOperations; ++i)
+  {
+    const E_Operation op = OFstatic_cast(E_Operation, i);
+    const LatencyHistogram *hists[2] = { &m_performed[i], &m_requested[i] };
+    const char *roles[2] = { "performed", "requested" };
+    for (size_t r = 0; r < 2; ++r)
+    {
+      const LatencyHistogram& hist = *hists[r];
+      if (hist.Count > 0)
+      {
+        out << operationName(op) << " " << roles[r] << ": " << hist.Count
+            << ", mean " << (hist.Sum * 1000 / hist.Count) << " ms, max "
+            << (hist.Max * 1000) << " ms" << OFendl;
+      }
+    }
+  }
+}
+
+
+void DcmAssociationStatistics::writePrometheusHistogram(STD_NAMESPACE ostream& out,
+                                                        const char *name,
+                                                        const OFString& labels,
+                                                        const LatencyHistogram& hist)
+{
+  unsigned long cumulated = 0;
+  for (size_t i = 0; i < NumberOfBuckets; ++i)
+  {
+    cumulated += hist.Buckets[i];
+    out << name << "_bucket{" << labels << ",le=\"" << BucketBounds[i] << "\"} " << cumulated << "\n";
+  }
+  out << name << "_bucket{" << labels << ",le=\"+Inf\"} " << hist.Count << "\n";
+  out << name << "_sum{" << labels << "} " << hist.Sum << "\n";
+  out << name << "_count{" << labels << "} " << hist.Count << "\n";
+}
+
+
+void DcmAssociationStatistics::writePrometheus(STD_NAMESPACE ostream& out,
+                                               const OFString& labels) const
+{
+  // labels to be appended to the labels of each sample
+  const OFString extra = labels.empty() ? OFString() : "," + labels;
+
+  out << "# HELP dcmtk_net_bytes_total Number of bytes transferred including PDU headers.\n";
+  out << "# TYPE dcmtk_net_bytes_total counter\n";
+  out << "dcmtk_net_bytes_total{direction=\"received\"" << extra << "} " << m_bytesReceived << "\n";
+  out << "dcmtk_net_bytes_total{direction=\"sent\"" << extra << "} " << m_bytesSent << "\n";
+  out << "# HELP dcmtk_net_pdus_total Number of PDUs transferred.\n";
+  out << "# TYPE dcmtk_net_pdus_total counter\n";
+  out << "dcmtk_net_pdus_total{direction=\"received\"" << extra << "} " << m_pdusReceived << "\n";
+  out << "dcmtk_net_pdus_total{direction=\"sent\"" << extra << "} " << m_pdusSent << "\n";
+  out << "# HELP dcmtk_net_dimse_messages_total Number of DIMSE messages transferred.\n";
+  out << "# TYPE dcmtk_net_dimse_messages_total counter\n";
+  out << "dcmtk_net_dimse_messages_total{direction=\"received\"" << extra << "} " << m_messagesReceived << "\n";
+  out << "dcmtk_net_dimse_messages_total{direction=\"sent\"" << extra << "} " << m_messagesSent << "\n";
+  out << "# HELP dcmtk_net_phase_seconds_total Time spent per processing phase.\n";
+  out << "# TYPE dcmtk_net_phase_seconds_total counter\n";
+  for (size_t i = 0; i < NumberOfPhases; ++i)
+  {
+    const E_Phase phase = OFstatic_cast(E_Phase, i);
+    out << "dcmtk_net_phase_seconds_total{phase=\"" << phaseName(phase) << "\"" << extra << "} "
+        << getPhaseTime(phase) << "\n";
+  }
+  out << "# HELP dcmtk_net_dimse_latency_seconds Latency of DIMSE operations from request to final response.\n";
+  out << "# TYPE dcmtk_net_dimse_latency_seconds histogram\n";
+  for (size_t i = 0; i < NumberOfOperations; ++i)
+  {
+    const OFString op = OFString("operation=\"") + operationName(OFstatic_cast(E_Operation, i)) + "\"";
+    if (m_performed[i].Count > 0)
+      writePrometheusHistogram(out, "dcmtk_net_dimse_latency_seconds", op + ",role=\"performed\"" + extra, m_performed[i]);
+    if (m_requested[i].Count > 0)
+      writePrometheusHistogram(out, "dcmtk_net_dimse_latency_seconds", op + ",role=\"requested\"" + extra, m_requested[i]);
+  }
+}
+
+
+OFCondition DcmAssociationStatistics::savePrometheusFile(const OFFilename& filename,
+                                                         const OFString& labels) const
+{
+  if (filename.isEmpty())
+    return EC_InvalidFilename;
+  OFString tempName = filename.getCharPointer();
+  tempName += ".tmp";
+  STD_NAMESPACE ofstream out(tempName.c_str(), STD_NAMESPACE ios::out | STD_NAMESPACE ios::trunc);
+  if (!out.good())
+    return NET_EC_CannotWriteStatistics;
+  writePrometheus(out, labels);
+  out.close();
+  if (out.fail())
+  {
+    OFStandard::deleteFile(tempName);
+    return NET_EC_CannotWriteStatistics;
+  }
+  // on some systems, an existing file is not replaced when renaming. In this
+  // case, the existing file is moved aside first and only removed after the
+  // new file is in place, so the file is missing for a short time but never
+  // lost. This fallback is not atomic, i.e. a concurrent reader might fail.
+  if (!OFStandard::renameFile(tempName, filename))
+  {
+    OFBool renamed = OFFalse;
+    if (OFStandard::fileExists(filename))
+    {
+      OFFilename backupName;
+      OFStandard::appendFilenameExtension(backupName, filename, ".bak");
+      OFStandard::deleteFile(backupName);
+      if (OFStandard::renameFile(filename, backupName))
+      {
+        renamed = OFStandard::renameFile(tempName, filename);
+        if (renamed)
+          OFStandard::deleteFile(backupName);
+        else
+          OFStandard::renameFile(backupName, filename);
+      }
+    }
+    if (!renamed)
+    {
+      // keep the temporary file, it is the only copy of the current counters
+      DCMNET_WARN("cannot replace statistics file " << filename << ", counters kept in " << tempName);
+      return NET_EC_CannotWriteStatistics;
+    }
+  }
+  return EC_Normal;
+}
+
+
+DcmAssociationStatistics::PhaseTimer::PhaseTimer(DcmAssociationStatistics *stats,
+                                                 const E_Phase phase)
+: m_stats(stats)
+, m_phase(phase)
+, m_start(0)
+, m_networkStart(0)
+{
+  if (m_stats)
+  {
+    m_start = DcmAssociationStatistics::now();
+    m_networkStart = m_stats->getPhaseTime(EP_Network);
+  }
+}
+
+
+DcmAssociationStatistics::PhaseTimer::~PhaseTimer()
+{
+  if (m_stats)
+  {
+    const double elapsed = DcmAssociationStatistics::now() - m_start;
+    const double network = m_stats->getPhaseTime(EP_Network) - m_networkStart;
+    // different clock readings may result in a slightly negative difference
+    if (elapsed > network)
+      m_stats->addPhaseTime(m_phase, elapsed - network);
+  }
+}
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2003-2017, OFFIS e.V.
+ *  Copyright (C) 2003-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -55,6 +55,7 @@ DcmPresentationContextItem& DcmPresentationContextItem::operator=(const DcmPrese
 
 DcmPresentationContextMap::DcmPresentationContextMap()
 : map_()
+, index_()
 {
 }
 
@@ -64,6 +65,8 @@ DcmPresentationContextMap::~DcmPresentationContextMap()
 }
 
 DcmPresentationContextMap::DcmPresentationContextMap(const DcmPresentationContextMap& arg)
+: map_()
+, index_()
 {
   /* Copy all map entries */
   OFMap<OFString, DcmPresentationContextList *>::const_iterator first = arg.map_.begin();
@@ -72,6 +75,7 @@ DcmPresentationContextMap::DcmPresentationContextMap(const DcmPresentationContex
   {
     DcmPresentationContextList* copy = new DcmPresentationContextList( *(*first).second );
     map_.insert( OFPair<const OFString, DcmPresentationContextList*>( (*first).first, copy ) );
+    addToIndex( (*first).first, *copy );
     ++first;
   }
 }
@@ -88,6 +92,7 @@ DcmPresentationContextMap& DcmPresentationContextMap::operator=(const DcmPresent
     {
       DcmPresentationContextList* copy = new DcmPresentationContextList( *(*first).second );
       map_.insert(OFPair<const OFString, DcmPresentationContextList*>( (*first).first, copy ) );
+      addToIndex( (*first).first, *copy );
       ++first;
     }
   }
@@ -102,6 +107,7 @@ void DcmPresentationContextMap::clear()
     delete (*first).second;
     map_.erase(first);
   }
+  index_.clear();
 }
 
 
@@ -168,9 +174,31 @@ OFCondition DcmPresentationContextMap::add(
 
   // insert values into list.
   (value)->push_back(DcmPresentationContextItem(uid, transferSyntaxKey));
+
+  // add to index unless the abstract syntax is already in the list,
+  // in which case the first entry remains the one found by a lookup
+  AbstractSyntaxIndex& index = index_[skey];
+  if (index.find(uid.str()) == index.end())
+    index[uid.str()] = &(value)->back();
   return EC_Normal;
 }
 
+void DcmPresentationContextMap::addToIndex(
+  const OFString& key,
+  const DcmPresentationContextList& list)
+{
+  AbstractSyntaxIndex& index = index_[key];
+  OFListConstIterator(DcmPresentationContextItem) first = list.begin();
+  OFListConstIterator(DcmPresentationContextItem) last = list.end();
+  while (first != last)
+  {
+    OFString uid((*first).getAbstractSyntax());
+    if (index.find(uid) == index.end())
+      index[uid] = &(*first);
+    ++first;
+  }
+}
+
 OFBool DcmPresentationContextMap::isKnownKey(const char *key) const
 {
   if (!key) return OFFalse;
@@ -217,3 +245,16 @@ const DcmPresentationContextList *DcmPresentationContextMap::getPresentationCont
   }
   return result;
 }
+
+const DcmPresentationContextItem *DcmPresentationContextMap::getPresentationContext(
+  const char *key,
+  const char *abstractSyntax) const
+{
+  if ((key == NULL) || (abstractSyntax == NULL)) return NULL;
+
+  OFMap<OFString, AbstractSyntaxIndex>::const_iterator it = index_.find(OFString(key));
+  if (it == index_.end()) return NULL;
+  AbstractSyntaxIndex::const_iterator entry = (*it).second.find(OFString(abstractSyntax));
+  if (entry == (*it).second.end()) return NULL;
+  return (*entry).second;
+}
@@ -0,0 +1,183 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Cache for datasets converted to a network transfer syntax
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/dcmnet/dctrcach.h"
+#include "dcmtk/dcmnet/diutil.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+
+
+#ifdef WITH_THREADS
+#define DCMTRCACHE_LOCK mutex_.lock()
+#define DCMTRCACHE_UNLOCK mutex_.unlock()
+#else
+#define DCMTRCACHE_LOCK
+#define DCMTRCACHE_UNLOCK
+#endif
+
+
+DcmTranscodingCache::DcmTranscodingCache(const size_t maxSize)
+#ifdef WITH_THREADS
+  : mutex_()
+  , entries_()
+#else
+  : entries_()
+#endif
+  , index_()
+  , size_(0)
+  , maxSize_(maxSize)
+{
+}
+
+
+DcmTranscodingCache::~DcmTranscodingCache()
+{
+  clear();
+}
+
+
+void DcmTranscodingCache::setMaxSize(const size_t maxSize)
+{
+  DCMTRCACHE_LOCK;
+  maxSize_ = maxSize;
+  shrink(maxSize_);
+  DCMTRCACHE_UNLOCK;
+}
+
+
+size_t DcmTranscodingCache::getMaxSize() const
+{
+  return maxSize_;
+}
+
+
+size_t DcmTranscodingCache::getSize()
+{
+  DCMTRCACHE_LOCK;
+  const size_t result = size_;
+  DCMTRCACHE_UNLOCK;
+  return result;
+}
+
+
+size_t DcmTranscodingCache::getNumberOfEntries()
+{
+  DCMTRCACHE_LOCK;
+  const size_t result = entries_.size();
+  DCMTRCACHE_UNLOCK;
+  return result;
+}
+
+
+OFBool DcmTranscodingCache::get(const OFString &sopInstanceUID,
+                                const E_TransferSyntax xfer,
+                                DcmDataset &dataset)
+{
+  OFBool result = OFFalse;
+  DCMTRCACHE_LOCK;
+  OFMap<OFString, OFListIterator(Entry)>::iterator it = index_.find(makeKey(sopInstanceUID, xfer));
+  if (it != index_.end())
+  {
+    /* move entry to the front of the list (most recently used) */
+    if ((*it).second != entries_.begin())
+      entries_.splice(entries_.begin(), entries_, (*it).second);
+    /* copying is much cheaper than converting the dataset again */
+    dataset = *entries_.front().dataset;
+    result = OFTrue;
+  }
+  DCMTRCACHE_UNLOCK;
+  return result;
+}
+
+
+void DcmTranscodingCache::put(const OFString &sopInstanceUID,
+                              const E_TransferSyntax xfer,
+                              const DcmDataset &dataset)
+{
+  /* create the copy without holding the lock */
+  DcmDataset *copy = new DcmDataset(dataset);
+  copy->removeAllButCurrentRepresentations();
+  const Uint32 length = copy->calcElementLength(xfer, EET_ExplicitLength);
+  Entry entry;
+  entry.key = makeKey(sopInstanceUID, xfer);
+  entry.dataset = copy;
+  entry.size = OFstatic_cast(size_t, length);
+
+  DCMTRCACHE_LOCK;
+  if (entry.size <= maxSize_)
+  {
+    /* replace existing entry, if any */
+    OFMap<OFString, OFListIterator(Entry)>::iterator it = index_.find(entry.key);
+    if (it != index_.end())
+    {
+      size_ -= (*(*it).second).size;
+      delete (*(*it).second).dataset;
+      entries_.erase((*it).second);
+      index_.erase(it);
+    }
+    shrink(maxSize_ - entry.size);
+    entries_.push_front(entry);
+    index_[entry.key] = entries_.begin();
+    size_ += entry.size;
+    copy = NULL;
+  }
+  DCMTRCACHE_UNLOCK;
+
+  if (copy != NULL)
+  {
+    DCMNET_DEBUG("dataset of SOP instance " << sopInstanceUID << " is too large for the transcoding cache ("
+      << length << " bytes)");
+    delete copy;
+  }
+}
+
+
+void DcmTranscodingCache::clear()
+{
+  DCMTRCACHE_LOCK;
+  shrink(0);
+  DCMTRCACHE_UNLOCK;
+}
+
+
+OFString DcmTranscodingCache::makeKey(const OFString &sopInstanceUID,
+                                      const E_TransferSyntax xfer)
+{
+  OFString key(sopInstanceUID);
+  key += '\\';
+  key += DcmXfer(xfer).getXferID();
+  return key;
+}
+
+
+void DcmTranscodingCache::shrink(const size_t limit)
+{
+  while (!entries_.empty() && (size_ > limit))
+  {
+    Entry &last = entries_.back();
+    size_ -= last.size;
+    index_.erase(last.key);
+    delete last.dataset;
+    entries_.pop_back();
+  }
+}
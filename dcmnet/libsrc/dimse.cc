@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2019, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -102,6 +102,7 @@
 #include "dcmtk/dcmnet/diutil.h"
 #include "dcmtk/dcmnet/dimse.h"        /* always include the module header */
 #include "dcmtk/dcmnet/cond.h"
+#include "dcmtk/dcmnet/dcasstat.h"
 #include "dimcmd.h"
 #include "dcmtk/dcmdata/dcdeftag.h"    /* for tag names */
 #include "dcmtk/dcmdata/dcdict.h"      /* for dcmDataDict */
@@ -691,6 +692,8 @@ sendDcmDataset(
     /* the following variable is currently unused, leave it for future use */
     unsigned long pdvCount = 0;
     DcmWriteCache wcache;
+    /* the time spent for encoding is accounted to the dataset phase (excluding network time) */
+    DcmAssociationStatistics::PhaseTimer timer(assoc->statistics, DcmAssociationStatistics::EP_Dataset);
 
     /* initialize some local variables (we want to use the association's send buffer */
     /* to store data) this buffer can only take a certain number of elements */
@@ -916,7 +919,12 @@ DIMSE_sendMessage(
       /* to create a data object with the actual instance data that shall be sent */
       else if ((dataObject == NULL)&&(dataFileName != NULL))
       {
-        if (! dcmff.loadFile(dataFileName, EXS_Unknown).good())
+        OFCondition loadCond;
+        {
+          DcmAssociationStatistics::PhaseTimer timer(assoc->statistics, DcmAssociationStatistics::EP_Storage);
+          loadCond = dcmff.loadFile(dataFileName, EXS_Unknown);
+        }
+        if (! loadCond.good())
         {
           DCMNET_WARN(DIMSE_warn_str(assoc) << "sendMessage: cannot open DICOM file ("
             << dataFileName << "): " << OFStandard::getLastSystemErrorCode().message());
@@ -979,6 +987,9 @@ DIMSE_sendMessage(
 
       /* Send the DIMSE command. DIMSE commands are always little endian implicit. */
       cond = sendDcmDataset(assoc, cmdObj, presID, EXS_LittleEndianImplicit, DUL_COMMANDPDV, NULL, NULL);
+
+      /* update the performance counters, if any */
+      if (cond.good() && assoc->statistics) assoc->statistics->messageSent(*msg);
     }
 
     /* Then we still have to send the actual instance data if the DIMSE command information variable */
@@ -1098,6 +1109,9 @@ DIMSE_receiveCommand(
     /* set PDV counter to 0 */
     pdvCount = 0;
 
+    /* the time spent for decoding is accounted to the dataset phase (excluding network time) */
+    DcmAssociationStatistics::PhaseTimer timer(assoc->statistics, DcmAssociationStatistics::EP_Dataset);
+
     /* create a new DcmDataset variable to capture the DIMSE command which we are about to receive */
     cmdSet = new DcmDataset();
     if (cmdSet == NULL) return EC_MemoryExhausted;
@@ -1257,6 +1271,9 @@ DIMSE_receiveCommand(
     else
         delete cmdSet;
 
+    /* update the performance counters, if any */
+    if (cond == EC_Normal && assoc->statistics) assoc->statistics->messageReceived(*msg);
+
     /* set the Presentation Context ID we received (out parameter) */
     *presID = pid;
 
@@ -1417,6 +1434,9 @@ DIMSE_receiveDataSetInFile(
 
     if ((assoc == NULL) || (presID==NULL) || (filestream==NULL)) return DIMSE_NULLKEY;
 
+    /* the time spent for writing is accounted to the storage phase (excluding network time) */
+    DcmAssociationStatistics::PhaseTimer timer(assoc->statistics, DcmAssociationStatistics::EP_Storage);
+
     *presID = 0;        /* invalid value */
     offile_off_t written = 0;
     while (!last)
@@ -1526,6 +1546,9 @@ DIMSE_receiveDataSetInMemory(
     /* check if the data dictionary is available. If not return an error */
     if (!isDataDictPresent()) return DIMSE_NODATADICT;
 
+    /* the time spent for decoding is accounted to the dataset phase (excluding network time) */
+    DcmAssociationStatistics::PhaseTimer timer(assoc->statistics, DcmAssociationStatistics::EP_Dataset);
+
     /* if we need to create a DcmDataset object at the given address, do so */
     if (*dataObject == NULL) {
         dset = new DcmDataset();
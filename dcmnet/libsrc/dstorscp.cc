@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2013-2017, OFFIS e.V.
+ *  Copyright (C) 2013-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -276,7 +276,10 @@ Uint16 DcmStorageSCP::checkAndProcessSTORERequest(const T_DIMSE_C_StoreRQ &reqMe
                 if (OFStandard::fileExists(filename))
                     DCMNET_WARN("file already exists, overwriting: " << filename);
                 // store the received dataset to file (with default settings)
-                status = fileformat.saveFile(filename);
+                {
+                    DcmAssociationStatistics::PhaseTimer timer(getActiveAssociationStatistics(), DcmAssociationStatistics::EP_Storage);
+                    status = fileformat.saveFile(filename);
+                }
                 if (status.good())
                 {
                     // call the notification handler (default implementation outputs to the logger)
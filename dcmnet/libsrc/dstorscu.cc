@@ -827,9 +827,9 @@ OFCondition DcmStorageSCU::sendSOPInstances()
                     }
                 } else {
                     DCMNET_DEBUG("sending SOP instance from file: " << (*CurrentTransferEntry)->Filename);
-                    // load SOP instance from DICOM file
-                    status = fileformat.loadFile((*CurrentTransferEntry)->Filename, EXS_Unknown, EGL_noChange,
-                        DCM_MaxReadLength, (*CurrentTransferEntry)->FileReadMode);
+                    // load SOP instance from DICOM file (large values are streamed when sent)
+                    status = fileformat.loadFileWithBulkData((*CurrentTransferEntry)->Filename, DCM_MaxReadLength,
+                        EXS_Unknown, EGL_noChange, (*CurrentTransferEntry)->FileReadMode);
                     if (status.good())
                     {
                         // do not store the dataset pointer in the transfer entry, because this pointer
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -305,6 +305,15 @@ void DUL_activateCallback(DUL_ASSOCIATIONKEY *dulassoc, DUL_ModeCallback *cb)
   }
 }
 
+void DUL_setStatistics(DUL_ASSOCIATIONKEY *dulassoc, DcmAssociationStatistics *stats)
+{
+  if (dulassoc)
+  {
+    PRIVATE_ASSOCIATIONKEY *assoc = (PRIVATE_ASSOCIATIONKEY *)dulassoc;
+    assoc->statistics = stats;
+  }
+}
+
 void DUL_returnAssociatePDUStorage(DUL_ASSOCIATIONKEY *dulassoc, void *& pdu, unsigned long& pdusize)
 {
   if (dulassoc)
@@ -2327,6 +2336,7 @@ createAssociationKey(PRIVATE_NETWORKKEY ** networkKey,
     key->logHandle = NULL;
     key->connection = NULL;
     key->modeCallback = NULL;
+    key->statistics = NULL;
     *associationKey = key;
     return EC_Normal;
 }
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2018, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -122,6 +122,7 @@ END_EXTERN_C
 #include "dcmtk/dcmnet/dcmtrans.h"
 #include "dcmtk/dcmnet/dcmlayer.h"
 #include "dcmtk/dcmnet/diutil.h"
+#include "dcmtk/dcmnet/dcasstat.h"
 #include "dcmtk/ofstd/ofsockad.h" /* for class OFSockAddr */
 
 /* At least Solaris doesn't define this */
@@ -256,6 +257,7 @@ sendPDataTCP(PRIVATE_ASSOCIATIONKEY ** association,
 static OFCondition
 writeDataPDU(PRIVATE_ASSOCIATIONKEY ** association,
              DUL_DATAPDU * pdu);
+static void notePDUSent(PRIVATE_ASSOCIATIONKEY * association, unsigned long bytes);
 static void clearPDUCache(PRIVATE_ASSOCIATIONKEY ** association);
 static void closeTransport(PRIVATE_ASSOCIATIONKEY ** association);
 static void closeTransportTCP(PRIVATE_ASSOCIATIONKEY ** association);
@@ -2614,6 +2616,7 @@ sendAssociationRQTCP(PRIVATE_NETWORKKEY ** /*network*/,
       msg += ") occurred in routine: sendAssociationRQTCP";
       return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
     }
+    notePDUSent(*association, associateRequest.length + 6);
     if (b != buffer) free(b);
     return EC_Normal;
 }
@@ -2697,6 +2700,7 @@ sendAssociationACTCP(PRIVATE_NETWORKKEY ** /*network*/,
       msg += ") occurred in routine: sendAssociationACTCP";
       return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
     }
+    notePDUSent(*association, associateReply.length + 6);
     if (b != buffer) free(b);
     return EC_Normal;
 }
@@ -2771,6 +2775,7 @@ sendAssociationRJTCP(PRIVATE_NETWORKKEY ** /*network*/,
           msg += ") occurred in routine: sendAssociationRJTCP";
           return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
         }
+        notePDUSent(*association, pdu.length + 6);
     }
     if (b != buffer) free(b);
     return cond;
@@ -2831,6 +2836,7 @@ sendAbortTCP(DUL_ABORTITEMS * abortItems,
           msg += ") occurred in routine: sendAbortTCP";
           return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
         }
+        notePDUSent(*association, pdu.length + 6);
     }
     if (b != buffer) free(b);
 
@@ -2891,6 +2897,7 @@ sendReleaseRQTCP(PRIVATE_ASSOCIATIONKEY ** association)
           msg += ") occurred in routine: sendReleaseRQTCP";
           return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
         }
+        notePDUSent(*association, pdu.length + 6);
     }
     if (b != buffer)
         free(b);
@@ -2952,6 +2959,7 @@ sendReleaseRPTCP(PRIVATE_ASSOCIATIONKEY ** association)
           msg += ") occurred in routine: sendReleaseRPTCP";
           return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
         }
+        notePDUSent(*association, pdu.length + 6);
     }
     if (b != buffer) free(b);
 
@@ -3093,6 +3101,10 @@ writeDataPDU(PRIVATE_ASSOCIATIONKEY ** association,
     OFCondition cond = streamDataPDUHead(pdu, head, sizeof(head), &length);
     if (cond.bad()) return cond;
 
+    /* if performance counters are attached, measure the time spent for sending */
+    DcmAssociationStatistics *stats = (*association)->statistics;
+    const double start = stats ? DcmAssociationStatistics::now() : 0;
+
     /* send the PDU head information (see above) */
     do
     {
@@ -3124,10 +3136,37 @@ writeDataPDU(PRIVATE_ASSOCIATIONKEY ** association,
         return makeDcmnetCondition(DULC_TCPIOERROR, OF_error, msg.c_str());
     }
 
+    if (stats)
+    {
+        stats->addPhaseTime(DcmAssociationStatistics::EP_Network, DcmAssociationStatistics::now() - start);
+        notePDUSent(*association, length + pdu->presentationDataValue.length - 2);
+    }
+
     /* return ok */
     return EC_Normal;
 }
 
+/* notePDUSent
+**
+** Purpose:
+**      Count a PDU that was sent in the performance counters of the
+**      association, if any are attached.
+**
+** Parameter Dictionary:
+**      association     Handle to the Association
+**      bytes           Number of bytes of the PDU including the PDU header
+**
+** Return Values:
+**      None
+*/
+
+static void
+notePDUSent(PRIVATE_ASSOCIATIONKEY * association, unsigned long bytes)
+{
+    if (association->statistics)
+        association->statistics->pduSent(bytes);
+}
+
 /* closeTransport
 **
 ** Purpose:
@@ -3501,7 +3540,10 @@ readPDUHeadTCP(PRIVATE_ASSOCIATIONKEY ** association,
 
     /* try to receive PDU header (6 bytes) over the network, mind blocking */
     /* options; in the end, buffer will contain the 6 bytes that were read. */
+    DcmAssociationStatistics *stats = (*association)->statistics;
+    const double start = stats ? DcmAssociationStatistics::now() : 0;
     OFCondition cond = defragmentTCP((*association)->connection, block, (*association)->timerStart, timeout, buffer, 6, &length);
+    if (stats) stats->addPhaseTime(DcmAssociationStatistics::EP_Network, DcmAssociationStatistics::now() - start);
 
     /* if receiving was not successful, return the corresponding error value */
     if (cond.bad()) return cond;
@@ -3619,9 +3661,16 @@ readPDUBodyTCP(PRIVATE_ASSOCIATIONKEY ** association,
       /* PDVs of the current PDU are (*association)->nextPDULength bytes long. Hence, in detail */
       /* we want to try to receive (*association)->nextPDULength bytes of data on the network) */
       /* The information that was received will be available through the buffer variable. */
+      DcmAssociationStatistics *stats = (*association)->statistics;
+      const double start = stats ? DcmAssociationStatistics::now() : 0;
       cond = defragmentTCP((*association)->connection,
                          block, (*association)->timerStart, timeout,
                          buffer, (*association)->nextPDULength, &length);
+      if (stats)
+      {
+        stats->addPhaseTime(DcmAssociationStatistics::EP_Network, DcmAssociationStatistics::now() - start);
+        if (cond.good()) stats->pduReceived(6 + (*association)->nextPDULength);
+      }
     }
 
     /* return result value */
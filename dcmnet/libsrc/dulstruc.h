@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1994-2017, OFFIS e.V.
+ *  Copyright (C) 1994-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were partly developed by
@@ -147,6 +147,7 @@ typedef struct {
     unsigned long fragmentBufferLength;
     unsigned char *fragmentBuffer;
     DUL_ModeCallback *modeCallback;
+    DcmAssociationStatistics *statistics;
 }   PRIVATE_ASSOCIATIONKEY;
 
 #define KEY_NETWORK "KEY NETWORK"
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2009-2018, OFFIS e.V.
+ *  Copyright (C) 2009-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -29,6 +29,8 @@
 
 DcmSCP::DcmSCP() :
   m_assoc(NULL),
+  m_statistics(),
+  m_tLayer(NULL),
   m_cfg()
 {
   OFStandard::initializeNetwork();
@@ -66,6 +68,18 @@ OFCondition DcmSCP::setConfig(const DcmSCPConfig& config)
   return EC_Normal;
 }
 
+// ----------------------------------------------------------------------------
+
+OFCondition DcmSCP::useSecureConnection(DcmTransportLayer *tlayer)
+{
+  if (isConnected())
+  {
+    return NET_EC_AlreadyConnected;
+  }
+  m_tLayer = tlayer;
+  return EC_Normal;
+}
+
 
 // ----------------------------------------------------------------------------
 
@@ -103,6 +117,17 @@ OFCondition DcmSCP::listen()
   if( cond.bad() )
     return cond;
 
+  // Use secure transport layer if configured
+  if( m_tLayer )
+  {
+    cond = ASC_setTransportLayer( network, m_tLayer, OFFalse /* do not take over ownership */ );
+    if( cond.bad() )
+    {
+      ASC_dropNetwork( &network );
+      return cond;
+    }
+  }
+
   // drop root privileges now and revert to the calling user id (if we are running as setuid root)
   cond = OFStandard::dropPrivileges();
   if (cond.bad())
@@ -327,7 +352,7 @@ OFCondition DcmSCP::waitForAssociationRQ(T_ASC_Network *network)
   Uint32 timeout = m_cfg->getConnectionTimeout();
 
   // Listen to a socket for timeout seconds and wait for an association request
-  OFCondition cond = ASC_receiveAssociation( network, &m_assoc, m_cfg->getMaxReceivePDULength(), NULL, NULL, OFFalse,
+  OFCondition cond = ASC_receiveAssociation( network, &m_assoc, m_cfg->getMaxReceivePDULength(), NULL, NULL, m_tLayer != NULL,
                                              m_cfg->getConnectionBlockingMode(), OFstatic_cast(int, timeout) );
 
   // In case of a timeout in non-blocking mode, call notifier (and return
@@ -455,6 +480,14 @@ OFCondition DcmSCP::processAssociationRQ()
     return EC_Normal;
   }
 
+  // Attach performance counters, so that the acknowledgement is counted as well
+  const OFBool statisticsEnabled = m_cfg->getStatisticsEnabled();
+  if (statisticsEnabled)
+  {
+    m_statistics.clear();
+    ASC_setStatistics(m_assoc, &m_statistics);
+  }
+
   // If the negotiation was successful, accept the association request
   cond = ASC_acknowledgeAssociation( m_assoc );
   if( cond.bad() )
@@ -474,6 +507,12 @@ OFCondition DcmSCP::processAssociationRQ()
   // Go ahead and handle the association (i.e. handle the caller's requests) in this process
   handleAssociation();
 
+  if (statisticsEnabled)
+  {
+    ASC_setStatistics(m_assoc, NULL);
+    notifyAssociationStatistics(m_statistics);
+  }
+
   return EC_Normal;
 }
 
@@ -1776,6 +1815,13 @@ void DcmSCP::setAlwaysAcceptDefaultRole(const OFBool enabled)
 
 // ----------------------------------------------------------------------------
 
+void DcmSCP::setStatisticsEnabled(const OFBool enabled)
+{
+  m_cfg->setStatisticsEnabled(enabled);
+}
+
+// ----------------------------------------------------------------------------
+
 /* Get methods for SCP settings and current association information */
 
 OFBool DcmSCP::getRefuseAssociation() const
@@ -1869,6 +1915,13 @@ OFBool DcmSCP::getProgressNotificationMode() const
 
 // ----------------------------------------------------------------------------
 
+OFBool DcmSCP::getStatisticsEnabled() const
+{
+  return m_cfg->getStatisticsEnabled();
+}
+
+// ----------------------------------------------------------------------------
+
 OFBool DcmSCP::isConnected() const
 {
   return (m_assoc != NULL) && (m_assoc->DULassociation != NULL);
@@ -1912,6 +1965,20 @@ OFString DcmSCP::getPeerIP() const
 
 // ----------------------------------------------------------------------------
 
+const DcmAssociationStatistics& DcmSCP::getAssociationStatistics() const
+{
+  return m_statistics;
+}
+
+// ----------------------------------------------------------------------------
+
+DcmAssociationStatistics *DcmSCP::getActiveAssociationStatistics()
+{
+  return (m_assoc != NULL) ? m_assoc->statistics : NULL;
+}
+
+// ----------------------------------------------------------------------------
+
 void DcmSCP::dropAndDestroyAssociation()
 {
 
@@ -1996,6 +2063,19 @@ void DcmSCP::notifyAssociationTermination()
 
 // ----------------------------------------------------------------------------
 
+void DcmSCP::notifyAssociationStatistics(const DcmAssociationStatistics& stats)
+{
+  if (DCM_dcmnetLogger.isEnabledFor(OFLogger::DEBUG_LOG_LEVEL))
+  {
+    OFOStringStream stream;
+    stats.print(stream);
+    OFSTRINGSTREAM_GETOFSTRING(stream, result)
+    DCMNET_DEBUG("Association statistics:" << OFendl << result);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
 void DcmSCP::notifyConnectionTimeout()
 {
   DCMNET_TRACE("Connection timeout encountered in non-blocking mode");
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2012-2017, OFFIS e.V.
+ *  Copyright (C) 2012-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -40,7 +40,8 @@ DcmSCPConfig::DcmSCPConfig() :
   m_verbosePCMode(OFFalse),
   m_connectionTimeout(1000),
   m_respondWithCalledAETitle(OFTrue),
-  m_progressNotificationMode(OFTrue)
+  m_progressNotificationMode(OFTrue),
+  m_statisticsEnabled(OFFalse)
 {
 }
 
@@ -67,7 +68,8 @@ DcmSCPConfig::DcmSCPConfig(const DcmSCPConfig &old) :
   m_verbosePCMode(old.m_verbosePCMode),
   m_connectionTimeout(old.m_connectionTimeout),
   m_respondWithCalledAETitle(old.m_respondWithCalledAETitle),
-  m_progressNotificationMode(old.m_progressNotificationMode)
+  m_progressNotificationMode(old.m_progressNotificationMode),
+  m_statisticsEnabled(old.m_statisticsEnabled)
 {
   // nothing more to do
 }
@@ -93,6 +95,7 @@ DcmSCPConfig& DcmSCPConfig::operator=(const DcmSCPConfig &obj)
     m_connectionTimeout = obj.m_connectionTimeout;
     m_respondWithCalledAETitle = obj.m_respondWithCalledAETitle;
     m_progressNotificationMode = obj.m_progressNotificationMode;
+    m_statisticsEnabled = obj.m_statisticsEnabled;
   }
   return *this;
 }
@@ -197,6 +200,13 @@ void DcmSCPConfig::setProgressNotificationMode(const OFBool mode)
 
 // ----------------------------------------------------------------------------
 
+void DcmSCPConfig::setStatisticsEnabled(const OFBool enabled)
+{
+  m_statisticsEnabled = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
 void DcmSCPConfig::setAlwaysAcceptDefaultRole(const OFBool enabled)
 {
   m_assocConfig.setAlwaysAcceptDefaultRole(enabled);
@@ -297,6 +307,13 @@ OFBool DcmSCPConfig::getProgressNotificationMode() const
 
 // ----------------------------------------------------------------------------
 
+OFBool DcmSCPConfig::getStatisticsEnabled() const
+{
+  return m_statisticsEnabled;
+}
+
+// ----------------------------------------------------------------------------
+
 // Reads association configuration from config file
 OFCondition DcmSCPConfig::loadAssociationCfgFile(const OFString &assocFile)
 {
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2008-2018, OFFIS e.V.
+ *  Copyright (C) 2008-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -23,6 +23,7 @@
 
 #include "dcmtk/dcmnet/scu.h"
 #include "dcmtk/dcmnet/diutil.h"    /* for dcmnet logger */
+#include "dcmtk/dcmnet/dctrcach.h"
 #include "dcmtk/dcmdata/dcuid.h"    /* for dcmFindUIDName() */
 #include "dcmtk/dcmdata/dcostrmf.h" /* for class DcmOutputFileStream */
 #include "dcmtk/ofstd/ofmem.h"      /* for OFunique_ptr */
@@ -53,7 +54,8 @@ DcmSCU::DcmSCU() :
   m_storageMode(DCMSCU_STORAGE_DISK),
   m_verbosePCMode(OFFalse),
   m_datasetConversionMode(OFFalse),
-  m_progressNotificationMode(OFTrue)
+  m_progressNotificationMode(OFTrue),
+  m_transcodingCache(NULL)
 {
   OFStandard::initializeNetwork();
 }
@@ -774,14 +776,23 @@ OFCondition DcmSCU::sendSTORERequest(const T_ASC_PresentationContextID presID,
       DcmXfer netXfer = DcmXfer(transferSyntax.c_str()).getXfer();
       if (netXfer.getXfer() != xferSyntax)
       {
-        DCMNET_INFO("Converting transfer syntax: " << xfer.getXferName() << " -> "
-          << netXfer.getXferName());
-        cond = dataset->chooseRepresentation(netXfer.getXfer(), NULL);
-        if (cond.bad())
+        /* Use the result of an earlier conversion, if available */
+        if ((m_transcodingCache != NULL) && m_transcodingCache->get(sopInstanceUID, netXfer.getXfer(), *dataset))
         {
-           DCMNET_ERROR("No conversion to transfer syntax " << netXfer.getXferName() << " possible!");
-           delete fileformat;
-           return cond;
+          DCMNET_INFO("Using cached conversion of transfer syntax: " << xfer.getXferName() << " -> "
+            << netXfer.getXferName());
+        } else {
+          DCMNET_INFO("Converting transfer syntax: " << xfer.getXferName() << " -> "
+            << netXfer.getXferName());
+          cond = dataset->chooseRepresentation(netXfer.getXfer(), NULL);
+          if (cond.bad())
+          {
+             DCMNET_ERROR("No conversion to transfer syntax " << netXfer.getXferName() << " possible!");
+             delete fileformat;
+             return cond;
+          }
+          if (m_transcodingCache != NULL)
+            m_transcodingCache->put(sopInstanceUID, netXfer.getXfer(), *dataset);
         }
       }
     }
@@ -2337,6 +2348,12 @@ void DcmSCU::setDatasetConversionMode(const OFBool mode)
 }
 
 
+void DcmSCU::setTranscodingCache(DcmTranscodingCache *cache)
+{
+  m_transcodingCache = cache;
+}
+
+
 void DcmSCU::setProgressNotificationMode(const OFBool mode)
 {
   m_progressNotificationMode = mode;
@@ -2434,6 +2451,12 @@ OFBool DcmSCU::getDatasetConversionMode() const
 }
 
 
+DcmTranscodingCache *DcmSCU::getTranscodingCache() const
+{
+  return m_transcodingCache;
+}
+
+
 OFBool DcmSCU::getProgressNotificationMode() const
 {
   return m_progressNotificationMode;
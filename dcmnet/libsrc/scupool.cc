@@ -0,0 +1,319 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Class managing a pool of established associations that can be
+ *           reused by several SCUs, possibly running in different threads.
+ *
+ */
+
+#include "dcmtk/config/osconfig.h" /* make sure OS specific configuration is included first */
+
+#ifdef WITH_THREADS // Without threads pool does not make sense...
+
+#include "dcmtk/dcmnet/scupool.h"
+#include "dcmtk/dcmnet/diutil.h"
+
+#include <typeinfo>
+
+// ----------------------------------------------------------------------------
+
+DcmSCUPool::DcmSCUPool()
+  : m_mutex(),
+    m_idle(),
+    m_maxIdleAssociations(4),
+    m_maxIdleTime(60),
+    m_healthCheckInterval(10)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+DcmSCUPool::~DcmSCUPool()
+{
+  closeIdleAssociations();
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::setMaxIdleAssociations(const size_t count)
+{
+  m_maxIdleAssociations = count;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::setMaxIdleTime(const Uint32 seconds)
+{
+  m_maxIdleTime = seconds;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::setHealthCheckInterval(const Uint32 seconds)
+{
+  m_healthCheckInterval = seconds;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t DcmSCUPool::getMaxIdleAssociations() const
+{
+  return m_maxIdleAssociations;
+}
+
+// ----------------------------------------------------------------------------
+
+Uint32 DcmSCUPool::getMaxIdleTime() const
+{
+  return m_maxIdleTime;
+}
+
+// ----------------------------------------------------------------------------
+
+Uint32 DcmSCUPool::getHealthCheckInterval() const
+{
+  return m_healthCheckInterval;
+}
+
+// ----------------------------------------------------------------------------
+
+OFCondition DcmSCUPool::acquire(DcmSCU *&scu)
+{
+  if (scu == NULL)
+    return EC_IllegalParameter;
+  if (scu->isConnected())
+    return NET_EC_AlreadyConnected;
+
+  const OFString key = makeKey(*scu);
+  OFList<DcmSCU *> expired;
+  for (;;)
+  {
+    /* take the most recently used idle association for this key, if any */
+    IdleAssociation candidate;
+    candidate.scu = NULL;
+    candidate.since = 0;
+    const time_t now = time(NULL);
+    m_mutex.lock();
+    collectExpired(now, expired);
+    OFMap<OFString, OFList<IdleAssociation> >::iterator it = m_idle.find(key);
+    if (it != m_idle.end())
+    {
+      candidate = (*it).second.back();
+      (*it).second.pop_back();
+      if ((*it).second.empty())
+        m_idle.erase(it);
+    }
+    m_mutex.unlock();
+    /* network operations are performed without holding the lock */
+    closeAll(expired);
+    if (candidate.scu == NULL)
+      break;
+
+    if (checkAssociation(*candidate.scu, now - candidate.since))
+    {
+      DCMNET_DEBUG("Reusing idle association to " << candidate.scu->getPeerAETitle()
+        << " (idle for " << OFstatic_cast(long, now - candidate.since) << " seconds)");
+      copySettings(*scu, *candidate.scu);
+      delete scu;
+      scu = candidate.scu;
+      return EC_Normal;
+    }
+    DCMNET_DEBUG("Idle association to " << candidate.scu->getPeerAETitle()
+      << " is not usable anymore, aborting it");
+    candidate.scu->abortAssociation();
+    delete candidate.scu;
+  }
+
+  /* no idle association available, negotiate a new one */
+  OFCondition result = scu->initNetwork();
+  if (result.good())
+    result = scu->negotiateAssociation();
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::release(DcmSCU *scu,
+                         const OFBool reusable)
+{
+  if (scu == NULL)
+    return;
+
+  OFList<DcmSCU *> closing;
+  if (reusable && scu->isConnected())
+  {
+    const time_t now = time(NULL);
+    const OFString key = makeKey(*scu);
+    m_mutex.lock();
+    collectExpired(now, closing);
+    OFList<IdleAssociation> &idle = m_idle[key];
+    if (idle.size() < m_maxIdleAssociations)
+    {
+      IdleAssociation entry;
+      entry.scu = scu;
+      entry.since = now;
+      idle.push_back(entry);
+      scu = NULL;
+    }
+    else if (idle.empty())
+      m_idle.erase(key);
+    m_mutex.unlock();
+  }
+  if (scu != NULL)
+    closing.push_back(scu);
+  closeAll(closing);
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::closeIdleAssociations()
+{
+  OFList<DcmSCU *> closing;
+  m_mutex.lock();
+  for (OFMap<OFString, OFList<IdleAssociation> >::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+  {
+    for (OFListIterator(IdleAssociation) entry = (*it).second.begin(); entry != (*it).second.end(); ++entry)
+      closing.push_back((*entry).scu);
+  }
+  m_idle.clear();
+  m_mutex.unlock();
+  closeAll(closing);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t DcmSCUPool::getNumberOfIdleAssociations()
+{
+  size_t count = 0;
+  m_mutex.lock();
+  for (OFMap<OFString, OFList<IdleAssociation> >::const_iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+    count += (*it).second.size();
+  m_mutex.unlock();
+  return count;
+}
+
+// ----------------------------------------------------------------------------
+
+OFBool DcmSCUPool::checkAssociation(DcmSCU &scu,
+                                    const time_t idleTime)
+{
+  if (!scu.isConnected())
+    return OFFalse;
+  /* an idle association should not receive anything, so any data waiting
+   * is an A-RELEASE-RQ or A-ABORT from the peer, or the connection has been
+   * closed. In any case, the association cannot be used anymore.
+   */
+  if (ASC_dataWaiting(scu.m_assoc, 0))
+    return OFFalse;
+  /* send C-ECHO if the association has been idle for a while */
+  if ((idleTime >= OFstatic_cast(time_t, m_healthCheckInterval)) &&
+      (ASC_findAcceptedPresentationContextID(scu.m_assoc, UID_VerificationSOPClass) != 0))
+  {
+    return scu.sendECHORequest(0).good();
+  }
+  return OFTrue;
+}
+
+// ----------------------------------------------------------------------------
+
+OFString DcmSCUPool::makeKey(const DcmSCU &scu)
+{
+  char buf[64];
+  /* never hand out an SCU of a different class, e.g. a plain DcmSCU instead
+   * of a derived class with overridden handlers
+   */
+  OFString key = typeid(scu).name();
+  key += '\\';
+  key += scu.m_peer;
+  sprintf(buf, "\\%hu\\%lu\\%d\\", scu.m_peerPort, OFstatic_cast(unsigned long, scu.m_maxReceivePDULength),
+    OFstatic_cast(int, scu.getTLSEnabled()));
+  key += buf;
+  key += scu.m_peerAETitle;
+  key += '\\';
+  key += scu.m_ourAETitle;
+  key += '\\';
+  key += scu.m_assocConfigFilename;
+  key += '\\';
+  key += scu.m_assocConfigProfile;
+  for (OFListConstIterator(DcmSCU::DcmSCUPresContext) pc = scu.m_presContexts.begin(); pc != scu.m_presContexts.end(); ++pc)
+  {
+    sprintf(buf, "\\%d", OFstatic_cast(int, (*pc).roleSelect));
+    key += buf;
+    key += '\\';
+    key += (*pc).abstractSyntaxName;
+    for (OFListConstIterator(OFString) ts = (*pc).transferSyntaxes.begin(); ts != (*pc).transferSyntaxes.end(); ++ts)
+    {
+      key += ',';
+      key += *ts;
+    }
+  }
+  return key;
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::copySettings(const DcmSCU &src,
+                              DcmSCU &dst)
+{
+  dst.setDIMSETimeout(src.getDIMSETimeout());
+  dst.setACSETimeout(src.getACSETimeout());
+  dst.setDIMSEBlockingMode(src.getDIMSEBlockingMode());
+  dst.setStorageDir(src.getStorageDir());
+  dst.setStorageMode(src.getStorageMode());
+  dst.setVerbosePCMode(src.getVerbosePCMode());
+  dst.setDatasetConversionMode(src.getDatasetConversionMode());
+  dst.setTranscodingCache(src.getTranscodingCache());
+  dst.setProgressNotificationMode(src.getProgressNotificationMode());
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::collectExpired(const time_t now,
+                                OFList<DcmSCU *> &expired)
+{
+  OFMap<OFString, OFList<IdleAssociation> >::iterator it = m_idle.begin();
+  while (it != m_idle.end())
+  {
+    /* the oldest idle associations are at the front of each list */
+    OFList<IdleAssociation> &idle = (*it).second;
+    while (!idle.empty() && (now - idle.front().since > OFstatic_cast(time_t, m_maxIdleTime)))
+    {
+      expired.push_back(idle.front().scu);
+      idle.pop_front();
+    }
+    if (idle.empty())
+      m_idle.erase(it++);
+    else
+      ++it;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void DcmSCUPool::closeAll(OFList<DcmSCU *> &scus)
+{
+  while (!scus.empty())
+  {
+    DcmSCU *scu = scus.front();
+    scus.pop_front();
+    if (scu->isConnected())
+      scu->releaseAssociation();
+    delete scu;
+  }
+}
+
+#endif // WITH_THREADS
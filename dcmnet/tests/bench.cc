@@ -0,0 +1,903 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: Benchmark for C-ECHO, C-STORE and C-FIND over a loopback connection
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#define INCLUDE_CSTDLIB
+#define INCLUDE_CSTDIO
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/dcmnet/scp.h"
+#include "dcmtk/dcmnet/scu.h"
+#include "dcmtk/dcmdata/cmdlnarg.h"
+#include "dcmtk/dcmdata/dcuid.h"      /* for dcmtk version name */
+#include "dcmtk/dcmdata/dcrleerg.h"   /* for DcmRLEEncoderRegistration */
+#include "dcmtk/ofstd/ofconapp.h"
+#include "dcmtk/ofstd/oftimer.h"
+#include "dcmtk/ofstd/ofvector.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
+
+#ifdef WITH_OPENSSL
+#include "dcmtk/dcmtls/tlslayer.h"
+#include "dcmtk/ofstd/oftempf.h"
+BEGIN_EXTERN_C
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+END_EXTERN_C
+#endif
+
+#define OFFIS_CONSOLE_APPLICATION "dcmnet_bench"
+
+static OFLogger benchLogger = OFLog::getLogger("dcmtk.test." OFFIS_CONSOLE_APPLICATION);
+
+static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v"
+  OFFIS_DCMTK_VERSION " " OFFIS_DCMTK_RELEASEDATE " $";
+
+// ********************************************
+
+#define SHORTCOL 4
+#define LONGCOL 20
+
+#define BENCH_SCP_AETITLE "BENCH_SCP"
+#define BENCH_SCU_AETITLE "BENCH_SCU"
+
+#ifdef WITH_THREADS
+
+/// DIMSE operations measured by the benchmark
+enum E_BenchOperation
+{
+  /// negotiation and release of an association
+  EBO_Association,
+  /// C-ECHO
+  EBO_Echo,
+  /// C-STORE
+  EBO_Store,
+  /// C-FIND
+  EBO_Find
+};
+
+/// number of operations, see E_BenchOperation
+static const size_t numBenchOperations = 4;
+
+/// names of the operations, used for the output
+static const char *benchOperationNames[numBenchOperations] =
+{
+  "associate", "c-echo", "c-store", "c-find"
+};
+
+/// a single configuration to be measured
+struct BenchConfig
+{
+  /// maximum PDU size used by both SCU and SCP
+  Uint32 pduSize;
+  /// transfer syntax used for C-STORE and C-FIND
+  E_TransferSyntax xfer;
+  /// use TLS for all associations
+  OFBool tls;
+};
+
+/// results of a single operation for a single configuration
+struct BenchResult
+{
+  /// default constructor
+  BenchResult() : latencies(), bytes(0) { }
+  /// latencies of all operations (in seconds)
+  OFVector<double> latencies;
+  /// number of dataset bytes sent by all operations
+  double bytes;
+};
+
+
+/** SCP used by the benchmark. Handles C-ECHO, C-STORE (received datasets are
+ *  kept in memory and discarded) and C-FIND (a configurable number of pending
+ *  responses with a fixed dataset is returned for each request). The SCP runs
+ *  in its own thread and stops listening as soon as requestStop() is called.
+ */
+class BenchSCP : public DcmSCP, public OFThread
+{
+public:
+
+  /** constructor
+   *  @param findResponses number of pending responses per C-FIND request
+   */
+  BenchSCP(const size_t findResponses)
+  : DcmSCP()
+  , OFThread()
+  , m_findResponses(findResponses)
+  , m_findResponse()
+  , m_mutex()
+  , m_stop(OFFalse)
+  , m_result(EC_Normal)
+  {
+    m_findResponse.putAndInsertString(DCM_QueryRetrieveLevel, "STUDY");
+    m_findResponse.putAndInsertString(DCM_PatientName, "Bench^Patient");
+    m_findResponse.putAndInsertString(DCM_PatientID, "PID0000001");
+    m_findResponse.putAndInsertString(DCM_StudyDate, "20260101");
+    m_findResponse.putAndInsertString(DCM_StudyDescription, "Synthetic study for benchmarking");
+    m_findResponse.putAndInsertString(DCM_StudyInstanceUID, "1.2.276.0.7230010.3.1.2.1234567890.1.1");
+  }
+
+  /** tells the SCP to stop listening after the current association or
+   *  after the next connection timeout
+   */
+  void requestStop()
+  {
+    m_mutex.lock();
+    m_stop = OFTrue;
+    m_mutex.unlock();
+  }
+
+  /** returns the result of listen()
+   *  @return result of listen(), only valid after the thread has been joined
+   */
+  OFCondition result() const
+  {
+    return m_result;
+  }
+
+protected:
+
+  /// runs the SCP
+  virtual void run()
+  {
+    m_result = listen();
+  }
+
+  /// @return OFTrue if the SCP should stop
+  OFBool stopRequested()
+  {
+    m_mutex.lock();
+    const OFBool result = m_stop;
+    m_mutex.unlock();
+    return result;
+  }
+
+  virtual OFBool stopAfterCurrentAssociation()
+  {
+    return stopRequested();
+  }
+
+  virtual OFBool stopAfterConnectionTimeout()
+  {
+    return stopRequested();
+  }
+
+  virtual OFCondition handleIncomingCommand(T_DIMSE_Message *incomingMsg,
+                                            const DcmPresentationContextInfo &presInfo)
+  {
+    OFCondition cond;
+    if (incomingMsg->CommandField == DIMSE_C_STORE_RQ)
+    {
+      DcmDataset *dataset = NULL;
+      T_DIMSE_C_StoreRQ &req = incomingMsg->msg.CStoreRQ;
+      cond = receiveSTORERequest(req, presInfo.presentationContextID, dataset);
+      delete dataset;
+      if (cond.good())
+        cond = sendSTOREResponse(presInfo.presentationContextID, req, STATUS_Success);
+    }
+    else if (incomingMsg->CommandField == DIMSE_C_FIND_RQ)
+    {
+      DcmDataset *dataset = NULL;
+      T_DIMSE_C_FindRQ &req = incomingMsg->msg.CFindRQ;
+      cond = receiveFINDRequest(req, presInfo.presentationContextID, dataset);
+      delete dataset;
+      for (size_t i = 0; (i < m_findResponses) && cond.good(); ++i)
+        cond = sendFINDResponse(presInfo.presentationContextID, req.MessageID, req.AffectedSOPClassUID,
+                                &m_findResponse, STATUS_Pending);
+      if (cond.good())
+        cond = sendFINDResponse(presInfo.presentationContextID, req.MessageID, req.AffectedSOPClassUID,
+                                NULL, STATUS_Success);
+    }
+    else
+      cond = DcmSCP::handleIncomingCommand(incomingMsg, presInfo);
+    return cond;
+  }
+
+private:
+
+  /// number of pending responses per C-FIND request
+  size_t m_findResponses;
+
+  /// dataset sent with each pending C-FIND response
+  DcmDataset m_findResponse;
+
+  /// mutex protecting m_stop
+  OFMutex m_mutex;
+
+  /// flag indicating that the SCP should stop
+  OFBool m_stop;
+
+  /// result of listen()
+  OFCondition m_result;
+};
+
+/** SCU used by the benchmark, only makes the TLS setup accessible
+ */
+class BenchSCU : public DcmSCU
+{
+public:
+
+  /** tells the SCU to use a secure TLS connection
+   *  @param tlayer TLS transport layer, not owned by the SCU
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  OFCondition enableTLS(DcmTransportLayer *tlayer)
+  {
+    return useSecureConnection(tlayer);
+  }
+};
+
+// ********************************************
+
+/** creates a CT image with the given number of rows and columns
+ */
+static void createImage(DcmDataset& dset, const Uint16 size)
+{
+  char uid[100];
+  dset.putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage);
+  dset.putAndInsertString(DCM_SOPInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_INSTANCE_UID_ROOT));
+  dset.putAndInsertString(DCM_StudyDate, "20260101");
+  dset.putAndInsertString(DCM_StudyTime, "120000");
+  dset.putAndInsertString(DCM_Modality, "CT");
+  dset.putAndInsertString(DCM_PatientName, "Bench^Patient");
+  dset.putAndInsertString(DCM_PatientID, "PID0000001");
+  dset.putAndInsertString(DCM_StudyInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_STUDY_UID_ROOT));
+  dset.putAndInsertString(DCM_SeriesInstanceUID, dcmGenerateUniqueIdentifier(uid, SITE_SERIES_UID_ROOT));
+  dset.putAndInsertString(DCM_ImagePositionPatient, "-175\\-175\\100");
+  dset.putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+  dset.putAndInsertString(DCM_PixelSpacing, "0.683594\\0.683594");
+  dset.putAndInsertUint16(DCM_SamplesPerPixel, 1);
+  dset.putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+  dset.putAndInsertUint16(DCM_Rows, size);
+  dset.putAndInsertUint16(DCM_Columns, size);
+  dset.putAndInsertUint16(DCM_BitsAllocated, 16);
+  dset.putAndInsertUint16(DCM_BitsStored, 12);
+  dset.putAndInsertUint16(DCM_HighBit, 11);
+  dset.putAndInsertUint16(DCM_PixelRepresentation, 0);
+  // smooth pattern with some noise, so that RLE compression is realistic
+  const size_t count = OFstatic_cast(size_t, size) * size;
+  Uint16 *pixels = new Uint16[count];
+  Uint32 noise = 12345;
+  for (size_t i = 0; i < count; ++i)
+  {
+    noise = noise * 1103515245 + 12345;
+    pixels[i] = OFstatic_cast(Uint16, (((i % size) + (i / size)) & 0x3ff) + ((noise >> 16) & 0x0f));
+  }
+  dset.putAndInsertUint16Array(DCM_PixelData, pixels, OFstatic_cast(unsigned long, count));
+  delete[] pixels;
+}
+
+/** compares two latencies, used for sorting by qsort()
+ */
+static int compareLatencies(const void *a, const void *b)
+{
+  const double x = *OFstatic_cast(const double *, a);
+  const double y = *OFstatic_cast(const double *, b);
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+#ifdef WITH_OPENSSL
+
+/** creates a private key and a self-signed certificate for the SCP
+ *  and writes both in PEM format to the given files
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition createCertificate(const OFString& keyFile, const OFString& certFile)
+{
+  OFCondition result = EC_IllegalCall;
+  EVP_PKEY *pkey = NULL;
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+  if (ctx && (EVP_PKEY_keygen_init(ctx) > 0) && (EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) > 0))
+    EVP_PKEY_keygen(ctx, &pkey);
+  EVP_PKEY_CTX_free(ctx);
+  X509 *cert = X509_new();
+  if (pkey && cert)
+  {
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_get_notBefore(cert), 0);
+    X509_gmtime_adj(X509_get_notAfter(cert), 86400L);
+    X509_set_pubkey(cert, pkey);
+    X509_NAME *name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+      OFreinterpret_cast(const unsigned char *, OFFIS_CONSOLE_APPLICATION), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    if (X509_sign(cert, pkey, EVP_sha256()) > 0)
+    {
+      FILE *f = fopen(keyFile.c_str(), "wb");
+      OFBool ok = (f != NULL) && PEM_write_PrivateKey(f, pkey, NULL, NULL, 0, NULL, NULL);
+      if (f) fclose(f);
+      f = fopen(certFile.c_str(), "wb");
+      ok = ok && (f != NULL) && PEM_write_X509(f, cert);
+      if (f) fclose(f);
+      result = ok ? EC_Normal : EC_CouldNotCreateTemporaryFile;
+    }
+  }
+  X509_free(cert);
+  EVP_PKEY_free(pkey);
+  return result;
+}
+
+/** creates a TLS transport layer
+ *  @param role network role of the transport layer
+ *  @param keyFile private key of the SCP (only used for the acceptor)
+ *  @param certFile certificate of the SCP (only used for the acceptor)
+ *  @param sessionResumption enable the resumption of TLS sessions if OFTrue
+ *  @param readAhead enable read-ahead if OFTrue
+ *  @return transport layer, NULL in case of error
+ */
+static DcmTLSTransportLayer *createTransportLayer(const T_ASC_NetworkRole role,
+                                                  const OFString& keyFile,
+                                                  const OFString& certFile,
+                                                  const OFBool sessionResumption,
+                                                  const OFBool readAhead)
+{
+  DcmTLSTransportLayer *tLayer = new DcmTLSTransportLayer(role, NULL, OFFalse);
+  OFBool ok = (tLayer->setTLSProfile(TSP_Profile_BCP195) == TCS_ok)
+    && (tLayer->activateCipherSuites() == TCS_ok)
+    && (tLayer->setSessionCaching(sessionResumption) == TCS_ok)
+    && (tLayer->setReadAhead(readAhead) == TCS_ok);
+  if (ok && (role == NET_ACCEPTOR))
+  {
+    ok = (tLayer->setPrivateKeyFile(keyFile.c_str(), DCF_Filetype_PEM) == TCS_ok)
+      && (tLayer->setCertificateFile(certFile.c_str(), DCF_Filetype_PEM) == TCS_ok)
+      && tLayer->checkPrivateKeyMatchesCertificate();
+  }
+  // the certificate is self-signed, the benchmark does not measure certificate checks
+  tLayer->setCertificateVerification(DCV_ignoreCertificate);
+  if (!ok)
+  {
+    delete tLayer;
+    tLayer = NULL;
+  }
+  return tLayer;
+}
+
+/** returns the number of TLS sessions that have been resumed by the SCP
+ *  @param scpLayer TLS transport layer of the SCP
+ *  @return number of resumed sessions
+ */
+static long getResumedSessions(DcmTransportLayer *scpLayer)
+{
+  return SSL_CTX_sess_hits(OFstatic_cast(DcmTLSTransportLayer *, scpLayer)->getNativeHandle());
+}
+
+#endif
+
+/** runs all associations of a single configuration
+ *  @return EC_Normal if successful, an error code otherwise
+ */
+static OFCondition runConfig(const BenchConfig& config,
+                             const Uint16 port,
+                             const OFBool operations[numBenchOperations],
+                             const size_t associations,
+                             const size_t count,
+                             const size_t findResponses,
+                             DcmDataset& image,
+                             const double imageBytes,
+                             DcmTransportLayer *scpLayer,
+                             DcmTransportLayer *scuLayer,
+                             BenchResult results[numBenchOperations])
+{
+  const char *xferUID = DcmXfer(config.xfer).getXferID();
+  OFList<OFString> xfers;
+  xfers.push_back(xferUID);
+  OFList<OFString> echoXfers;
+  echoXfers.push_back(UID_LittleEndianImplicitTransferSyntax);
+
+  // prepare and start the SCP
+  BenchSCP scp(findResponses);
+  DcmSCPConfig& scpConfig = scp.getConfig();
+  scpConfig.setPort(port);
+  scpConfig.setAETitle(BENCH_SCP_AETITLE);
+  scpConfig.setMaxReceivePDULength(config.pduSize);
+  scpConfig.setConnectionBlockingMode(DUL_NOBLOCK);
+  scpConfig.setConnectionTimeout(1);
+  scpConfig.addPresentationContext(UID_VerificationSOPClass, echoXfers);
+  scpConfig.addPresentationContext(UID_CTImageStorage, xfers);
+  scpConfig.addPresentationContext(UID_FINDStudyRootQueryRetrieveInformationModel, xfers);
+  if (config.tls)
+    scp.useSecureConnection(scpLayer);
+  if (scp.start() != 0)
+    return EC_IllegalCall;
+
+  DcmDataset query;
+  query.putAndInsertString(DCM_QueryRetrieveLevel, "STUDY");
+  query.putAndInsertString(DCM_PatientName, "Bench*");
+  query.insertEmptyElement(DCM_PatientID);
+  query.insertEmptyElement(DCM_StudyDate);
+  query.insertEmptyElement(DCM_StudyDescription);
+  query.insertEmptyElement(DCM_StudyInstanceUID);
+
+  OFCondition cond = EC_Normal;
+  for (size_t a = 0; (a < associations) && cond.good(); ++a)
+  {
+    BenchSCU scu;
+    scu.setAETitle(BENCH_SCU_AETITLE);
+    scu.setPeerAETitle(BENCH_SCP_AETITLE);
+    scu.setPeerHostName("localhost");
+    scu.setPeerPort(port);
+    scu.setMaxReceivePDULength(config.pduSize);
+    scu.addPresentationContext(UID_VerificationSOPClass, echoXfers);
+    scu.addPresentationContext(UID_CTImageStorage, xfers);
+    scu.addPresentationContext(UID_FINDStudyRootQueryRetrieveInformationModel, xfers);
+    cond = scu.initNetwork();
+    if (cond.good() && config.tls)
+      cond = scu.enableTLS(scuLayer);
+    if (cond.bad())
+      break;
+    OFTimer timer;
+    cond = scu.negotiateAssociation();
+    // the SCP thread might not yet be listening when the first association is requested
+    for (int retry = 0; (a == 0) && cond.bad() && (retry < 50); ++retry)
+    {
+      OFStandard::milliSleep(100);
+      timer.reset();
+      cond = scu.negotiateAssociation();
+    }
+    double associate = timer.getDiff();
+    if (cond.bad())
+      break;
+    if (operations[EBO_Echo])
+    {
+      const T_ASC_PresentationContextID presID = scu.findPresentationContextID(UID_VerificationSOPClass, "");
+      for (size_t i = 0; (i < count) && cond.good(); ++i)
+      {
+        timer.reset();
+        cond = scu.sendECHORequest(presID);
+        results[EBO_Echo].latencies.push_back(timer.getDiff());
+      }
+    }
+    if (operations[EBO_Store])
+    {
+      const T_ASC_PresentationContextID presID = scu.findPresentationContextID(UID_CTImageStorage, xferUID);
+      Uint16 status = 0;
+      for (size_t i = 0; (i < count) && cond.good(); ++i)
+      {
+        timer.reset();
+        cond = scu.sendSTORERequest(presID, "", &image, status);
+        results[EBO_Store].latencies.push_back(timer.getDiff());
+        results[EBO_Store].bytes += imageBytes;
+        if (cond.good() && (status != STATUS_Success))
+          cond = DIMSE_BADMESSAGE;
+      }
+    }
+    if (operations[EBO_Find])
+    {
+      const T_ASC_PresentationContextID presID = scu.findPresentationContextID(UID_FINDStudyRootQueryRetrieveInformationModel, xferUID);
+      for (size_t i = 0; (i < count) && cond.good(); ++i)
+      {
+        timer.reset();
+        cond = scu.sendFINDRequest(presID, &query, NULL);
+        results[EBO_Find].latencies.push_back(timer.getDiff());
+      }
+    }
+    timer.reset();
+    if (cond.good())
+      cond = scu.releaseAssociation();
+    else
+      scu.abortAssociation();
+    associate += timer.getDiff();
+    if (operations[EBO_Association])
+      results[EBO_Association].latencies.push_back(associate);
+  }
+
+  scp.requestStop();
+  scp.join();
+  if (cond.good() && scp.result().bad() && (scp.result() != NET_EC_StopAfterConnectionTimeout)
+    && (scp.result() != NET_EC_StopAfterAssociation))
+  {
+    cond = scp.result();
+  }
+  return cond;
+}
+
+static void printResult(const OFBool csv,
+                        const BenchConfig& config,
+                        const char *operation,
+                        BenchResult& result)
+{
+  const size_t n = result.latencies.size();
+  if (n == 0)
+    return;
+  qsort(&result.latencies[0], n, sizeof(double), compareLatencies);
+  double total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += result.latencies[i];
+  const double ops = (total > 0) ? n / total : 0;
+  const double mbytes = (total > 0) ? result.bytes / total / 1000000.0 : 0;
+  // latencies in milliseconds
+  const double mean = total / n * 1000.0;
+  const double p50 = result.latencies[n / 2] * 1000.0;
+  const double p99 = result.latencies[(n * 99) / 100] * 1000.0;
+  const double max = result.latencies[n - 1] * 1000.0;
+  const char *xfer = DcmXfer(config.xfer).getXferName();
+  if (csv)
+  {
+    COUT << config.pduSize << ",\"" << xfer << "\"," << (config.tls ? "yes" : "no") << ","
+         << operation << "," << n << "," << ops << "," << mbytes << ","
+         << mean << "," << p50 << "," << p99 << "," << max << OFendl;
+  } else {
+    OFString xferName(xfer);
+    if (xferName.length() > 28)
+      xferName.erase(28);
+    COUT << STD_NAMESPACE right << STD_NAMESPACE setw(7) << config.pduSize << " "
+         << STD_NAMESPACE left << STD_NAMESPACE setw(28) << xferName.c_str() << " "
+         << STD_NAMESPACE setw(3) << (config.tls ? "yes" : "no") << " "
+         << STD_NAMESPACE setw(9) << operation << STD_NAMESPACE right
+         << STD_NAMESPACE setw(7) << n
+         << STD_NAMESPACE fixed << STD_NAMESPACE setprecision(1)
+         << STD_NAMESPACE setw(10) << ops
+         << STD_NAMESPACE setw(9) << mbytes
+         << STD_NAMESPACE setprecision(3)
+         << STD_NAMESPACE setw(9) << mean
+         << STD_NAMESPACE setw(9) << p50
+         << STD_NAMESPACE setw(9) << p99
+         << STD_NAMESPACE setw(9) << max << OFendl;
+    COUT.unsetf(STD_NAMESPACE ios::floatfield);
+  }
+}
+
+#endif /* WITH_THREADS */
+
+int main(int argc, char *argv[])
+{
+  OFBool opt_operations[4] = { OFTrue, OFFalse, OFFalse, OFFalse };
+  OFCmdUnsignedInt opt_port = 11112;
+  OFCmdUnsignedInt opt_count = 100;
+  OFCmdUnsignedInt opt_associations = 2;
+  OFCmdUnsignedInt opt_findResponses = 10;
+  OFCmdUnsignedInt opt_imageSize = 512;
+  OFVector<Uint32> opt_pduSizes;
+  OFVector<E_TransferSyntax> opt_xfers;
+  OFBool opt_plain = OFTrue;
+  OFBool opt_tls = OFFalse;
+  OFBool opt_csv = OFFalse;
+  OFBool opt_sessionResumption = OFFalse;
+  OFBool opt_readAhead = OFFalse;
+  const char *opt_tcpNoDelay = NULL;
+  OFString opt_keyFile;
+  OFString opt_certFile;
+  OFString opt_tempDir;
+
+  OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION, "Measure DIMSE throughput and latency on a loopback connection", rcsid);
+  OFCommandLine cmd;
+  cmd.setOptionColumns(LONGCOL, SHORTCOL);
+  cmd.setParamColumn(LONGCOL + SHORTCOL + 4);
+
+  cmd.addGroup("general options:", LONGCOL, SHORTCOL + 2);
+    cmd.addOption("--help",              "-h",     "print this help text and exit", OFCommandLine::AF_Exclusive);
+    cmd.addOption("--version",                     "print version information and exit", OFCommandLine::AF_Exclusive);
+    OFLog::addOptions(cmd);
+
+  cmd.addGroup("benchmark options:");
+    cmd.addSubGroup("operations (default: all):");
+      cmd.addOption("--echo",            "+e",     "measure C-ECHO");
+      cmd.addOption("--store",           "+s",     "measure C-STORE");
+      cmd.addOption("--find",            "+f",     "measure C-FIND");
+    cmd.addSubGroup("repetitions:");
+      cmd.addOption("--count",           "+n",  1, "[n]umber: integer (default: 100)",
+                                                   "number of operations of each kind\nper association");
+      cmd.addOption("--associations",    "+a",  1, "[n]umber: integer (default: 2)",
+                                                   "number of associations per configuration");
+    cmd.addSubGroup("datasets:");
+      cmd.addOption("--image-size",      "+is", 1, "[n]umber: integer (default: 512)",
+                                                   "number of rows and columns of C-STORE image");
+      cmd.addOption("--find-responses",  "+fr", 1, "[n]umber: integer (default: 10)",
+                                                   "number of pending responses per C-FIND");
+    cmd.addSubGroup("configurations (all combinations are measured):");
+      cmd.addOption("--pdu",             "+pd", 1, "[n]umber of bytes: integer (4096..131072)",
+                                                   "maximum PDU size, may be repeated\n(default: 16384 and 131072)");
+      cmd.addOption("--xfer-implicit",   "+xi",    "implicit VR little endian");
+      cmd.addOption("--xfer-little",     "+xe",    "explicit VR little endian");
+      cmd.addOption("--xfer-big",        "+xb",    "explicit VR big endian");
+#ifdef WITH_ZLIB
+      cmd.addOption("--xfer-deflated",   "+xd",    "deflated explicit VR little endian");
+#endif
+      cmd.addOption("--xfer-rle",        "+xr",    "RLE lossless (C-STORE image is compressed\nbefore measuring)\n(default: implicit and explicit little endian)");
+#ifdef WITH_OPENSSL
+    cmd.addSubGroup("transport layer security (TLS):");
+      cmd.addOption("--disable-tls",     "-tls",   "use unencrypted connections only (default)");
+      cmd.addOption("--enable-tls",      "+tls",   "use unencrypted and TLS connections");
+      cmd.addOption("--tls-only",        "+tlo",   "use TLS connections only");
+      cmd.addOption("--key-file",        "+kf", 1, "[f]ilename: string",
+                                                   "private key of the SCP in PEM format\n(default: generate temporary key)");
+      cmd.addOption("--cert-file",       "+cf", 1, "[f]ilename: string",
+                                                   "certificate of the SCP in PEM format\n(default: generate self-signed certificate)");
+      cmd.addOption("--session-resumption", "+sr",  "resume TLS sessions of previous associations\n(default: full handshake for each association)");
+      cmd.addOption("--read-ahead",      "+ra",    "enable TLS read-ahead");
+#endif
+
+  cmd.addGroup("network options:");
+    cmd.addOption("--port",              "+P",  1, "[n]umber: integer (default: 11112)",
+                                                   "port number of the loopback SCP");
+    cmd.addOption("--nagle-default",     "-nd",    "use the Nagle algorithm as configured at\ncompile time or by TCP_NODELAY (default)");
+    cmd.addOption("--disable-nagle",     "+nd",    "disable the Nagle algorithm (TCP_NODELAY=1)");
+    cmd.addOption("--enable-nagle",      "+ne",    "enable the Nagle algorithm (TCP_NODELAY=0)");
+
+  cmd.addGroup("output options:");
+#ifdef WITH_OPENSSL
+    cmd.addOption("--temp-dir",          "+td", 1, "[d]irectory: string",
+                                                   "directory for temporary files\n(default: system specific)");
+#endif
+    cmd.addOption("--print-table",       "+pt",    "print results as table (default)");
+    cmd.addOption("--print-csv",         "+pc",    "print results as comma separated values");
+
+  /* evaluate command line */
+  prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
+  if (app.parseCommandLine(cmd, argc, argv))
+  {
+    /* check exclusive options first */
+    if (cmd.hasExclusiveOption())
+    {
+      if (cmd.findOption("--version"))
+      {
+        app.printHeader(OFTrue /*print host identifier*/);
+        return 0;
+      }
+    }
+
+    /* general options */
+    OFLog::configureFromCommandLine(cmd, app);
+
+    /* benchmark options */
+    if (cmd.findOption("--echo")) opt_operations[1] = OFTrue;
+    if (cmd.findOption("--store")) opt_operations[2] = OFTrue;
+    if (cmd.findOption("--find")) opt_operations[3] = OFTrue;
+    if (cmd.findOption("--count"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_count, 1));
+    if (cmd.findOption("--associations"))
+      app.checkValue(cmd.getValueAndCheckMin(opt_associations, 1));
+    if (cmd.findOption("--image-size"))
+      app.checkValue(cmd.getValueAndCheckMinMax(opt_imageSize, 1, 4096));
+    if (cmd.findOption("--find-responses"))
+      app.checkValue(cmd.getValue(opt_findResponses));
+    if (cmd.findOption("--pdu", 0, OFCommandLine::FOM_FirstFromLeft))
+    {
+      OFCmdUnsignedInt pduSize = 0;
+      do
+      {
+        app.checkValue(cmd.getValueAndCheckMinMax(pduSize, ASC_MINIMUMPDUSIZE, ASC_MAXIMUMPDUSIZE));
+        opt_pduSizes.push_back(OFstatic_cast(Uint32, pduSize));
+      } while (cmd.findOption("--pdu", 0, OFCommandLine::FOM_NextFromLeft));
+    }
+    if (cmd.findOption("--xfer-implicit")) opt_xfers.push_back(EXS_LittleEndianImplicit);
+    if (cmd.findOption("--xfer-little")) opt_xfers.push_back(EXS_LittleEndianExplicit);
+    if (cmd.findOption("--xfer-big")) opt_xfers.push_back(EXS_BigEndianExplicit);
+#ifdef WITH_ZLIB
+    if (cmd.findOption("--xfer-deflated")) opt_xfers.push_back(EXS_DeflatedLittleEndianExplicit);
+#endif
+    if (cmd.findOption("--xfer-rle")) opt_xfers.push_back(EXS_RLELossless);
+#ifdef WITH_OPENSSL
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--disable-tls"))
+    {
+      opt_plain = OFTrue;
+      opt_tls = OFFalse;
+    }
+    if (cmd.findOption("--enable-tls"))
+    {
+      opt_plain = OFTrue;
+      opt_tls = OFTrue;
+    }
+    if (cmd.findOption("--tls-only"))
+    {
+      opt_plain = OFFalse;
+      opt_tls = OFTrue;
+    }
+    cmd.endOptionBlock();
+    if (cmd.findOption("--key-file"))
+    {
+      app.checkDependence("--key-file", "--enable-tls or --tls-only", opt_tls);
+      app.checkValue(cmd.getValue(opt_keyFile));
+    }
+    if (cmd.findOption("--cert-file"))
+    {
+      app.checkDependence("--cert-file", "--enable-tls or --tls-only", opt_tls);
+      app.checkValue(cmd.getValue(opt_certFile));
+    }
+    if (opt_keyFile.empty() != opt_certFile.empty())
+      app.printError("--key-file and --cert-file must be used together");
+    if (cmd.findOption("--session-resumption"))
+    {
+      app.checkDependence("--session-resumption", "--enable-tls or --tls-only", opt_tls);
+      opt_sessionResumption = OFTrue;
+    }
+    if (cmd.findOption("--read-ahead"))
+    {
+      app.checkDependence("--read-ahead", "--enable-tls or --tls-only", opt_tls);
+      opt_readAhead = OFTrue;
+    }
+#endif
+
+    /* network options */
+    if (cmd.findOption("--port"))
+      app.checkValue(cmd.getValueAndCheckMinMax(opt_port, 1, 65535));
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--nagle-default")) opt_tcpNoDelay = NULL;
+    if (cmd.findOption("--disable-nagle")) opt_tcpNoDelay = "1";
+    if (cmd.findOption("--enable-nagle")) opt_tcpNoDelay = "0";
+    cmd.endOptionBlock();
+
+    /* output options */
+#ifdef WITH_OPENSSL
+    if (cmd.findOption("--temp-dir"))
+      app.checkValue(cmd.getValue(opt_tempDir));
+#endif
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--print-table")) opt_csv = OFFalse;
+    if (cmd.findOption("--print-csv")) opt_csv = OFTrue;
+    cmd.endOptionBlock();
+  }
+
+  /* print resource identifier */
+  OFLOG_DEBUG(benchLogger, rcsid << OFendl);
+
+#ifdef WITH_THREADS
+  /* make sure data dictionary is loaded */
+  if (!dcmDataDict.isDictionaryLoaded())
+  {
+    OFLOG_FATAL(benchLogger, "no data dictionary loaded, check environment variable: "
+      << DCM_DICT_ENVIRONMENT_VARIABLE);
+    return 1;
+  }
+
+  /* if no operation is selected, measure all of them */
+  if (!opt_operations[1] && !opt_operations[2] && !opt_operations[3])
+    opt_operations[1] = opt_operations[2] = opt_operations[3] = OFTrue;
+  if (opt_pduSizes.empty())
+  {
+    opt_pduSizes.push_back(16384);
+    opt_pduSizes.push_back(131072);
+  }
+  if (opt_xfers.empty())
+  {
+    opt_xfers.push_back(EXS_LittleEndianImplicit);
+    opt_xfers.push_back(EXS_LittleEndianExplicit);
+  }
+
+  /* the DUL layer evaluates this environment variable for each connection */
+  if (opt_tcpNoDelay)
+  {
+#ifdef _WIN32
+    _putenv_s("TCP_NODELAY", opt_tcpNoDelay);
+#else
+    setenv("TCP_NODELAY", opt_tcpNoDelay, 1 /* overwrite */);
+#endif
+  }
+
+  DcmRLEEncoderRegistration::registerCodecs();
+
+  int result = 0;
+  DcmTransportLayer *scpLayer = NULL;
+  DcmTransportLayer *scuLayer = NULL;
+#ifdef WITH_OPENSSL
+  OFTempFile *tempKeyFile = NULL;
+  OFTempFile *tempCertFile = NULL;
+  if (opt_tls)
+  {
+    DcmTLSTransportLayer::initializeOpenSSL();
+    if (opt_keyFile.empty())
+    {
+      tempKeyFile = new OFTempFile(O_RDWR, opt_tempDir, OFFIS_CONSOLE_APPLICATION "_", ".key");
+      tempCertFile = new OFTempFile(O_RDWR, opt_tempDir, OFFIS_CONSOLE_APPLICATION "_", ".pem");
+      opt_keyFile = tempKeyFile->getFilename();
+      opt_certFile = tempCertFile->getFilename();
+      if (tempKeyFile->getStatus().bad() || tempCertFile->getStatus().bad()
+        || createCertificate(opt_keyFile, opt_certFile).bad())
+      {
+        OFLOG_FATAL(benchLogger, "cannot create temporary key and certificate");
+        result = 1;
+      }
+    }
+    if (result == 0)
+    {
+      scpLayer = createTransportLayer(NET_ACCEPTOR, opt_keyFile, opt_certFile, opt_sessionResumption, opt_readAhead);
+      scuLayer = createTransportLayer(NET_REQUESTOR, opt_keyFile, opt_certFile, opt_sessionResumption, opt_readAhead);
+      if ((scpLayer == NULL) || (scuLayer == NULL))
+      {
+        OFLOG_FATAL(benchLogger, "cannot initialize TLS transport layer");
+        result = 1;
+      }
+    }
+  }
+#endif
+
+  if (result == 0)
+  {
+    if (opt_csv)
+      COUT << "pdu_size,transfer_syntax,tls,operation,count,operations_per_second,mb_per_second,"
+           << "mean_ms,p50_ms,p99_ms,max_ms" << OFendl;
+    else
+    {
+      COUT << "    PDU transfer syntax              TLS operation  count     ops/s     MB/s"
+           << "  mean ms   p50 ms   p99 ms   max ms" << OFendl;
+      COUT << "---------------------------------------------------------------------------"
+           << "------------------------------------" << OFendl;
+    }
+  }
+
+  for (size_t x = 0; (x < opt_xfers.size()) && (result == 0); ++x)
+  {
+    // create the image in the transfer syntax to be measured, so that only the network is measured
+    DcmFileFormat fileformat;
+    DcmDataset& image = *fileformat.getDataset();
+    createImage(image, OFstatic_cast(Uint16, opt_imageSize));
+    OFCondition cond = image.chooseRepresentation(opt_xfers[x], NULL);
+    if (cond.good())
+      image.removeAllButCurrentRepresentations();
+    const double imageBytes = image.calcElementLength(opt_xfers[x], EET_ExplicitLength);
+    for (size_t p = 0; (p < opt_pduSizes.size()) && cond.good(); ++p)
+    {
+      for (int t = 0; (t < 2) && cond.good(); ++t)
+      {
+        BenchConfig config;
+        config.pduSize = opt_pduSizes[p];
+        config.xfer = opt_xfers[x];
+        config.tls = (t == 1);
+        if ((config.tls && !opt_tls) || (!config.tls && !opt_plain))
+          continue;
+        BenchResult results[numBenchOperations];
+#ifdef WITH_OPENSSL
+        const long resumed = config.tls ? getResumedSessions(scpLayer) : 0;
+#endif
+        cond = runConfig(config, OFstatic_cast(Uint16, opt_port), opt_operations, opt_associations,
+          opt_count, opt_findResponses, image, imageBytes, scpLayer, scuLayer, results);
+        if (cond.good())
+        {
+          for (size_t o = 0; o < numBenchOperations; ++o)
+            printResult(opt_csv, config, benchOperationNames[o], results[o]);
+#ifdef WITH_OPENSSL
+          if (config.tls)
+            OFLOG_INFO(benchLogger, (getResumedSessions(scpLayer) - resumed) << " of " << opt_associations
+              << " TLS sessions resumed");
+#endif
+        }
+      }
+    }
+    if (cond.bad())
+    {
+      OFLOG_FATAL(benchLogger, "benchmark for transfer syntax " << DcmXfer(opt_xfers[x]).getXferName()
+        << " failed: " << cond.text());
+      result = 1;
+    }
+  }
+
+  delete scuLayer;
+  delete scpLayer;
+#ifdef WITH_OPENSSL
+  delete tempKeyFile;
+  delete tempCertFile;
+#endif
+  DcmRLEEncoderRegistration::cleanup();
+
+  return result;
+#else /* WITH_THREADS */
+  OFLOG_FATAL(benchLogger, "this benchmark requires thread support");
+  return 1;
+#endif
+}
@@ -0,0 +1,139 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: test program for presentation context negotiation
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dcuid.h"
+#include "dcmtk/dcmnet/assoc.h"
+#include "dcmtk/dcmnet/dcasccfg.h"
+
+
+/* transfer syntaxes proposed for each presentation context */
+static const char *proposedTransferSyntaxes[] =
+{
+    UID_LittleEndianImplicitTransferSyntax,
+    UID_LittleEndianExplicitTransferSyntax,
+    UID_JPEGProcess14SV1TransferSyntax
+};
+
+/* create association parameters with the presentation contexts used by the tests below */
+static T_ASC_Parameters *createParameters()
+{
+    T_ASC_Parameters *params = NULL;
+    OFCHECK(ASC_createAssociationParameters(&params, ASC_DEFAULTMAXPDU).good());
+    /* context 1: CT Image Storage, all transfer syntaxes */
+    OFCHECK(ASC_addPresentationContext(params, 1, UID_CTImageStorage, proposedTransferSyntaxes, 3).good());
+    /* context 3: MR Image Storage, implicit little endian only */
+    OFCHECK(ASC_addPresentationContext(params, 3, UID_MRImageStorage, proposedTransferSyntaxes, 1).good());
+    /* context 5: Verification, not in the list of supported abstract syntaxes */
+    OFCHECK(ASC_addPresentationContext(params, 5, UID_VerificationSOPClass, proposedTransferSyntaxes, 1).good());
+    /* context 7: CT Image Storage again, JPEG lossless only */
+    OFCHECK(ASC_addPresentationContext(params, 7, UID_CTImageStorage, proposedTransferSyntaxes + 2, 1).good());
+    return params;
+}
+
+/* check result of the negotiation for a single presentation context */
+static void checkContext(T_ASC_Parameters *params,
+                         int position,
+                         T_ASC_PresentationContextID id,
+                         T_ASC_P_ResultReason reason,
+                         const char *transferSyntax)
+{
+    T_ASC_PresentationContext pc;
+    OFCHECK(ASC_getPresentationContext(params, position, &pc).good());
+    OFCHECK_EQUAL(pc.presentationContextID, id);
+    OFCHECK_EQUAL(pc.resultReason, reason);
+    if (transferSyntax != NULL)
+        OFCHECK_EQUAL(OFString(pc.acceptedTransferSyntax), transferSyntax);
+}
+
+
+OFTEST(dcmnet_asc_acceptContextsWithPreferredTransferSyntaxes)
+{
+    const char *abstractSyntaxes[] = { UID_MRImageStorage, UID_CTImageStorage };
+    const char *transferSyntaxes[] = { UID_LittleEndianExplicitTransferSyntax, UID_LittleEndianImplicitTransferSyntax };
+
+    T_ASC_Parameters *params = createParameters();
+    OFCHECK(ASC_acceptContextsWithPreferredTransferSyntaxes(params, abstractSyntaxes, 2, transferSyntaxes, 2).good());
+    OFCHECK_EQUAL(ASC_countAcceptedPresentationContexts(params), 2);
+    checkContext(params, 0, 1, ASC_P_ACCEPTANCE, UID_LittleEndianExplicitTransferSyntax);
+    checkContext(params, 1, 3, ASC_P_ACCEPTANCE, UID_LittleEndianImplicitTransferSyntax);
+    checkContext(params, 2, 5, ASC_P_ABSTRACTSYNTAXNOTSUPPORTED, NULL);
+    checkContext(params, 3, 7, ASC_P_TRANSFERSYNTAXESNOTSUPPORTED, NULL);
+
+    /* a second call may change the transfer syntax of accepted contexts but must not refuse them */
+    const char *jpegTransferSyntax[] = { UID_JPEGProcess14SV1TransferSyntax };
+    OFCHECK(ASC_acceptContextsWithPreferredTransferSyntaxes(params, abstractSyntaxes, 2, jpegTransferSyntax, 1).good());
+    OFCHECK_EQUAL(ASC_countAcceptedPresentationContexts(params), 3);
+    checkContext(params, 0, 1, ASC_P_ACCEPTANCE, UID_JPEGProcess14SV1TransferSyntax);
+    checkContext(params, 1, 3, ASC_P_ACCEPTANCE, UID_LittleEndianImplicitTransferSyntax);
+    checkContext(params, 3, 7, ASC_P_ACCEPTANCE, UID_JPEGProcess14SV1TransferSyntax);
+    OFCHECK(ASC_destroyAssociationParameters(&params).good());
+}
+
+
+OFTEST(dcmnet_asc_acceptContextsWithTransferSyntax)
+{
+    const char *abstractSyntaxes[] = { UID_CTImageStorage, UID_MRImageStorage };
+
+    T_ASC_Parameters *params = createParameters();
+    OFCHECK(ASC_acceptContextsWithTransferSyntax(params, UID_LittleEndianExplicitTransferSyntax, 2, abstractSyntaxes).good());
+    OFCHECK_EQUAL(ASC_countAcceptedPresentationContexts(params), 1);
+    checkContext(params, 0, 1, ASC_P_ACCEPTANCE, UID_LittleEndianExplicitTransferSyntax);
+    checkContext(params, 1, 3, ASC_P_TRANSFERSYNTAXESNOTSUPPORTED, NULL);
+    checkContext(params, 2, 5, ASC_P_ABSTRACTSYNTAXNOTSUPPORTED, NULL);
+    checkContext(params, 3, 7, ASC_P_TRANSFERSYNTAXESNOTSUPPORTED, NULL);
+    OFCHECK(ASC_destroyAssociationParameters(&params).good());
+}
+
+
+OFTEST(dcmnet_asc_evaluateAssociationParameters)
+{
+    DcmAssociationConfiguration cfg;
+    OFCHECK(cfg.addTransferSyntax("TS", UID_JPEGProcess14SV1TransferSyntax).good());
+    OFCHECK(cfg.addTransferSyntax("TS", UID_LittleEndianImplicitTransferSyntax).good());
+    OFCHECK(cfg.addTransferSyntax("Explicit", UID_LittleEndianExplicitTransferSyntax).good());
+    OFCHECK(cfg.addPresentationContext("PC", UID_CTImageStorage, "TS").good());
+    OFCHECK(cfg.addPresentationContext("PC", UID_MRImageStorage, "Explicit").good());
+    /* duplicate entry, the first one for an abstract syntax applies */
+    OFCHECK(cfg.addPresentationContext("PC", UID_CTImageStorage, "Explicit").good());
+    OFCHECK(cfg.addProfile("Profile", "PC").good());
+
+    T_ASC_Association assoc;
+    assoc.params = createParameters();
+    OFCHECK(cfg.evaluateAssociationParameters("Profile", assoc).good());
+    OFCHECK_EQUAL(ASC_countAcceptedPresentationContexts(assoc.params), 2);
+    checkContext(assoc.params, 0, 1, ASC_P_ACCEPTANCE, UID_JPEGProcess14SV1TransferSyntax);
+    checkContext(assoc.params, 1, 3, ASC_P_TRANSFERSYNTAXESNOTSUPPORTED, NULL);
+    checkContext(assoc.params, 2, 5, ASC_P_ABSTRACTSYNTAXNOTSUPPORTED, NULL);
+    checkContext(assoc.params, 3, 7, ASC_P_ACCEPTANCE, UID_JPEGProcess14SV1TransferSyntax);
+    OFCHECK(ASC_destroyAssociationParameters(&assoc.params).good());
+
+    /* copies of the configuration must use the same entries */
+    DcmAssociationConfiguration copy(cfg);
+    assoc.params = createParameters();
+    OFCHECK(copy.evaluateAssociationParameters("Profile", assoc).good());
+    OFCHECK_EQUAL(ASC_countAcceptedPresentationContexts(assoc.params), 2);
+    checkContext(assoc.params, 0, 1, ASC_P_ACCEPTANCE, UID_JPEGProcess14SV1TransferSyntax);
+    OFCHECK(ASC_destroyAssociationParameters(&assoc.params).good());
+}
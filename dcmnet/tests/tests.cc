@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2012-2017, OFFIS e.V.
+ *  Copyright (C) 2012-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -23,7 +23,11 @@
 
 #include "dcmtk/ofstd/oftest.h"
 
+OFTEST_REGISTER(dcmnet_asc_acceptContextsWithPreferredTransferSyntaxes);
+OFTEST_REGISTER(dcmnet_asc_acceptContextsWithTransferSyntax);
+OFTEST_REGISTER(dcmnet_asc_evaluateAssociationParameters);
 OFTEST_REGISTER(dcmnet_dimseDump_nullByte);
+OFTEST_REGISTER(dcmnet_transcodingCache);
 
 #ifdef WITH_THREADS
 OFTEST_REGISTER(dcmnet_scp_pool);
@@ -31,11 +35,16 @@ OFTEST_REGISTER(dcmnet_scp_builtin_verification_support);
 OFTEST_REGISTER(dcmnet_scp_fail_on_invalid_association_configuration);
 OFTEST_REGISTER(dcmnet_scp_fail_on_disallowed_host);
 OFTEST_REGISTER(dcmnet_scp_stop_after_current_association);
+OFTEST_REGISTER(dcmnet_scp_association_statistics);
 OFTEST_REGISTER(dcmnet_scp_stop_after_timeout);
 OFTEST_REGISTER(dcmnet_scp_no_stop_wo_request_noblock);
 OFTEST_REGISTER(dcmnet_scp_no_stop_wo_request_block);
 OFTEST_REGISTER(dcmnet_scp_no_term_notify_without_association);
 OFTEST_REGISTER(dcmnet_scp_role_selection);
+OFTEST_REGISTER(dcmnet_scu_pool);
+#ifdef WITH_OPENSSL
+OFTEST_REGISTER(dcmnet_tls_session_resumption);
+#endif // WITH_OPENSSL
 #endif // WITH_THREADS
 
 OFTEST_MAIN("dcmnet")
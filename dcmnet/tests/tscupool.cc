@@ -0,0 +1,188 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: test program for class DcmSCUPool
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#ifdef WITH_THREADS
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmnet/scppool.h"
+#include "dcmtk/dcmnet/scupool.h"
+#include "dcmtk/dcmnet/dctrcach.h"
+
+struct TestSCPPool : DcmSCPPool<>, OFThread
+{
+    OFCondition result;
+protected:
+    void run()
+    {
+        result = listen();
+    }
+};
+
+
+/* SCU class that must not share associations with plain DcmSCU objects */
+struct TestDerivedSCU : DcmSCU
+{
+};
+
+
+/* configure an SCU to connect to the test pool */
+static DcmSCU *configureSCU(DcmSCU *scu,
+                            const OFBool withExplicitVR)
+{
+    scu->setAETitle("PoolTestSCU");
+    scu->setPeerAETitle("PoolTestSCP");
+    scu->setPeerHostName("localhost");
+    scu->setPeerPort(11112);
+    OFList<OFString> xfers;
+    if (withExplicitVR)
+        xfers.push_back(UID_LittleEndianExplicitTransferSyntax);
+    xfers.push_back(UID_LittleEndianImplicitTransferSyntax);
+    scu->addPresentationContext(UID_VerificationSOPClass, xfers);
+    return scu;
+}
+
+
+/* create an SCU that is configured to connect to the test pool */
+static DcmSCU *createSCU(const OFBool withExplicitVR)
+{
+    return configureSCU(new DcmSCU, withExplicitVR);
+}
+
+
+/* Test starts an SCP pool and obtains associations to it from an SCU pool.
+ * Associations handed back to the SCU pool must be reused for SCUs with the
+ * same configuration, but not for SCUs requesting different presentation
+ * contexts or being of a different class.
+ */
+OFTEST_FLAGS(dcmnet_scu_pool, EF_Slow)
+{
+    TestSCPPool scpPool;
+    DcmSCPConfig& config = scpPool.getConfig();
+    config.setAETitle("PoolTestSCP");
+    config.setPort(11112);
+    config.setConnectionBlockingMode(DUL_NOBLOCK);
+    config.setConnectionTimeout(1);
+    scpPool.setMaxThreads(4);
+    OFList<OFString> xfers;
+    xfers.push_back(UID_LittleEndianExplicitTransferSyntax);
+    xfers.push_back(UID_LittleEndianImplicitTransferSyntax);
+    config.addPresentationContext(UID_VerificationSOPClass, xfers);
+    scpPool.start();
+
+    DcmSCUPool pool;
+    pool.setHealthCheckInterval(0);
+
+    // wait for the SCP pool to accept associations
+    DcmSCU *first = createSCU(OFTrue);
+    OFCondition result = pool.acquire(first);
+    for (int retry = 0; result.bad() && (retry < 10); ++retry)
+    {
+        OFStandard::sleep(1);
+        result = pool.acquire(first);
+    }
+    OFCHECK(result.good());
+    OFCHECK(first->isConnected());
+    OFCHECK(first->sendECHORequest(0).good());
+    pool.release(first);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 1);
+
+    // same configuration: the idle association is reused (after a C-ECHO health check)
+    // and takes over the request related settings of the SCU passed
+    DcmTranscodingCache cache;
+    DcmSCU *second = createSCU(OFTrue);
+    second->setDIMSETimeout(42);
+    second->setACSETimeout(43);
+    second->setDIMSEBlockingMode(DIMSE_NONBLOCKING);
+    second->setStorageDir("storage");
+    second->setStorageMode(DCMSCU_STORAGE_BIT_PRESERVING);
+    second->setVerbosePCMode(OFTrue);
+    second->setDatasetConversionMode(OFTrue);
+    second->setTranscodingCache(&cache);
+    second->setProgressNotificationMode(OFFalse);
+    OFCHECK(pool.acquire(second).good());
+    OFCHECK(second == first);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 0);
+    OFCHECK_EQUAL(second->getDIMSETimeout(), 42);
+    OFCHECK_EQUAL(second->getACSETimeout(), 43);
+    OFCHECK(second->getDIMSEBlockingMode() == DIMSE_NONBLOCKING);
+    OFCHECK_EQUAL(second->getStorageDir(), "storage");
+    OFCHECK(second->getStorageMode() == DCMSCU_STORAGE_BIT_PRESERVING);
+    OFCHECK(second->getVerbosePCMode());
+    OFCHECK(second->getDatasetConversionMode());
+    OFCHECK(second->getTranscodingCache() == &cache);
+    OFCHECK(!second->getProgressNotificationMode());
+    second->setDIMSEBlockingMode(DIMSE_BLOCKING);
+    second->setTranscodingCache(NULL);
+
+    // different presentation contexts: a new association is negotiated
+    DcmSCU *third = createSCU(OFFalse);
+    OFCHECK(pool.acquire(third).good());
+    OFCHECK(third != second);
+    OFCHECK(third->isConnected());
+    OFCHECK(third->sendECHORequest(0).good());
+
+    pool.release(second);
+    pool.release(third);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 2);
+
+    // associations that are not reusable are closed immediately
+    DcmSCU *fourth = createSCU(OFFalse);
+    OFCHECK(pool.acquire(fourth).good());
+    OFCHECK(fourth == third);
+    pool.release(fourth, OFFalse);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 1);
+
+    // associations are only handed out to SCUs of the same class
+    DcmSCU *derived = configureSCU(new TestDerivedSCU, OFFalse);
+    OFCHECK(pool.acquire(derived).good());
+    pool.release(derived);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 2);
+    DcmSCU *plain = createSCU(OFFalse);
+    OFCHECK(pool.acquire(plain).good());
+    OFCHECK(plain != derived);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 2);
+    DcmSCU *derived2 = configureSCU(new TestDerivedSCU, OFFalse);
+    OFCHECK(pool.acquire(derived2).good());
+    OFCHECK(derived2 == derived);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 1);
+    pool.release(plain);
+    pool.release(derived2);
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 3);
+
+    // idle associations are closed after the maximum idle time
+    pool.setMaxIdleTime(0);
+    OFStandard::sleep(2);
+    DcmSCU *fifth = createSCU(OFFalse);
+    OFCHECK(pool.acquire(fifth).good());
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 0);
+    pool.release(fifth);
+    pool.closeIdleAssociations();
+    OFCHECK_EQUAL(pool.getNumberOfIdleAssociations(), 0);
+
+    scpPool.stopAfterCurrentAssociations();
+    scpPool.join();
+    OFCHECK(scpPool.result.good());
+}
+
+#endif // WITH_THREADS
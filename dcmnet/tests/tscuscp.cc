@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2017, OFFIS e.V.
+ *  Copyright (C) 2017-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -24,6 +24,7 @@
 #ifdef WITH_THREADS
 
 #define INCLUDE_CMATH
+#define INCLUDE_CSTDIO
 #include "dcmtk/ofstd/ofstdinc.h"
 #include "dcmtk/ofstd/oftest.h"
 #include "dcmtk/ofstd/oftimer.h"
@@ -81,7 +82,9 @@ struct TestSCP: DcmSCP, OFThread
         m_stop_after_assoc_result(OFFalse),
         m_stop_after_timeout_result(OFFalse),
         m_notify_connection_timeout_result(OFFalse),
-        m_notify_assoc_termination_result(OFFalse)
+        m_notify_assoc_termination_result(OFFalse),
+        m_notify_assoc_statistics_result(OFFalse),
+        m_assoc_statistics()
     {
     }
 
@@ -97,6 +100,8 @@ struct TestSCP: DcmSCP, OFThread
         m_stop_after_timeout_result = OFFalse;
         m_notify_connection_timeout_result = OFFalse;
         m_notify_assoc_termination_result = OFFalse;
+        m_notify_assoc_statistics_result = OFFalse;
+        m_assoc_statistics.clear();
     }
 
     /** Overwrite method from DcmSCP in order to test feature to stop after current
@@ -149,6 +154,16 @@ struct TestSCP: DcmSCP, OFThread
         m_notify_assoc_termination_result = OFTrue;
     }
 
+    /** Overwrite method from DcmSCP in order to test feature that SCP reports
+     *  the performance counters of an association.
+     *  @param stats The performance counters of the association
+     */
+    virtual void notifyAssociationStatistics(const DcmAssociationStatistics& stats)
+    {
+        m_notify_assoc_statistics_result = OFTrue;
+        m_assoc_statistics.merge(stats);
+    }
+
     /** Overwrite method from DcmSCP in order to test feature that SCP rejects
      *  a forbidden host.
      *  @param hostOrIP The host name or IP address to be checked
@@ -187,6 +202,10 @@ struct TestSCP: DcmSCP, OFThread
     OFBool m_notify_connection_timeout_result;
     /// Indicator whether related virtual notifier function was called
     OFBool m_notify_assoc_termination_result;
+    /// Indicator whether related virtual notifier function was called
+    OFBool m_notify_assoc_statistics_result;
+    /// Performance counters reported by the SCP
+    DcmAssociationStatistics m_assoc_statistics;
 
     /** Method called by OFThread to start SCP operation. Starts listen() loop of DcmSCP.
     */
@@ -300,6 +319,74 @@ OFTEST_FLAGS(dcmnet_scp_stop_after_current_association, EF_Slow)
 }
 
 
+// Test case that checks whether server collects performance counters for an
+// association if configured accordingly
+OFTEST_FLAGS(dcmnet_scp_association_statistics, EF_Slow)
+{
+    TestSCP scp;
+    DcmSCPConfig& config = scp.getConfig();
+    configure_scp_for_echo(config);
+    config.setAETitle("STATISTICS");
+    config.setConnectionBlockingMode(DUL_BLOCK);
+    config.setStatisticsEnabled(OFTrue);
+    scp.m_set_stop_after_assoc = OFTrue;
+    scp.start();
+    scu_sends_echo("STATISTICS");
+    scp.join();
+
+    OFCHECK(scp.m_listen_result == NET_EC_StopAfterAssociation);
+    OFCHECK(scp.m_notify_assoc_statistics_result == OFTrue);
+    const DcmAssociationStatistics& stats = scp.m_assoc_statistics;
+    // C-ECHO-RQ received and C-ECHO-RSP sent
+    OFCHECK_EQUAL(stats.getMessagesReceived(), 1);
+    OFCHECK_EQUAL(stats.getMessagesSent(), 1);
+    // P-DATA and A-RELEASE-RQ received, A-ASSOCIATE-AC, P-DATA and A-RELEASE-RP sent
+    OFCHECK_EQUAL(stats.getPDUsReceived(), 2);
+    OFCHECK_EQUAL(stats.getPDUsSent(), 3);
+    OFCHECK(stats.getBytesReceived() > 0);
+    OFCHECK(stats.getBytesSent() > 0);
+    OFCHECK_EQUAL(stats.getPerformedLatencies(DcmAssociationStatistics::EO_CEcho).Count, 1);
+    OFCHECK_EQUAL(stats.getRequestedLatencies(DcmAssociationStatistics::EO_CEcho).Count, 0);
+    OFCHECK_EQUAL(stats.getPerformedLatencies(DcmAssociationStatistics::EO_CStore).Count, 0);
+    OFCHECK(stats.getPhaseTime(DcmAssociationStatistics::EP_Network) > 0);
+    OFCHECK(scp.getAssociationStatistics().getMessagesReceived() == 1);
+
+    OFOStringStream stream;
+    stats.writePrometheus(stream, "aetitle=\"STATISTICS\"");
+    OFSTRINGSTREAM_GETOFSTRING(stream, text)
+    OFCHECK(text.find("dcmtk_net_dimse_messages_total{direction=\"received\",aetitle=\"STATISTICS\"} 1") != OFString_npos);
+    OFCHECK(text.find("operation=\"C-ECHO\",role=\"performed\",aetitle=\"STATISTICS\",le=\"+Inf\"} 1") != OFString_npos);
+    OFCHECK(text.find("operation=\"C-STORE\"") == OFString_npos);
+
+    // an existing file is replaced
+    const OFFilename filename("tscuscp_stats.prom");
+    OFFilename tempFilename;
+    OFStandard::appendFilenameExtension(tempFilename, filename, ".tmp");
+    OFCHECK(stats.savePrometheusFile(filename).good());
+    OFCHECK(stats.savePrometheusFile(filename, "aetitle=\"STATISTICS\"").good());
+    OFCHECK(OFStandard::fileExists(filename));
+    OFCHECK(!OFStandard::fileExists(tempFilename));
+    OFString content;
+    STD_NAMESPACE ifstream in(filename.getCharPointer());
+    char c;
+    while (in.get(c)) content += c;
+    in.close();
+    OFCHECK_EQUAL(content, text);
+    OFStandard::deleteFile(filename);
+
+    // the temporary file is kept if it cannot replace the existing one
+    // (here: a directory with the same name)
+    const OFFilename dirName("tscuscp_stats.dir");
+    OFStandard::appendFilenameExtension(tempFilename, dirName, ".tmp");
+    OFCHECK(OFStandard::createDirectory(dirName, "").good());
+    OFCHECK(stats.savePrometheusFile(dirName) == NET_EC_CannotWriteStatistics);
+    OFCHECK(OFStandard::dirExists(dirName));
+    OFCHECK(OFStandard::fileExists(tempFilename));
+    OFStandard::deleteFile(tempFilename);
+    STDIO_NAMESPACE remove(dirName.getCharPointer());
+}
+
+
 // Test case that checks whether server returns with the correct error code if
 // configured with an invalid configuration (here: no presentation contexts)
 OFTEST_FLAGS(dcmnet_scp_fail_on_invalid_association_configuration, EF_Slow)
@@ -0,0 +1,261 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: test program for the resumption of TLS sessions
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#if defined(WITH_THREADS) && defined(WITH_OPENSSL)
+
+#define INCLUDE_CSTDIO
+#include "dcmtk/ofstd/ofstdinc.h"
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/ofstd/oftempf.h"
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/dcmnet/scp.h"
+#include "dcmtk/dcmnet/assoc.h"
+#include "dcmtk/dcmnet/dul.h"
+#include "dcmtk/dcmtls/tlslayer.h"
+#include "dcmtk/dcmtls/tlstrans.h"
+
+BEGIN_EXTERN_C
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+END_EXTERN_C
+
+
+/* SCP accepting TLS associations in its own thread until requestStop() is called */
+struct TLSTestSCP : DcmSCP, OFThread
+{
+    TLSTestSCP()
+    : DcmSCP()
+    , OFThread()
+    , m_result(EC_Normal)
+    , m_mutex()
+    , m_stop(OFFalse)
+    {
+    }
+
+    void requestStop()
+    {
+        m_mutex.lock();
+        m_stop = OFTrue;
+        m_mutex.unlock();
+    }
+
+    OFCondition m_result;
+
+protected:
+
+    virtual void run()
+    {
+        m_result = listen();
+    }
+
+    OFBool stopRequested()
+    {
+        m_mutex.lock();
+        const OFBool result = m_stop;
+        m_mutex.unlock();
+        return result;
+    }
+
+    virtual OFBool stopAfterCurrentAssociation()
+    {
+        return stopRequested();
+    }
+
+    virtual OFBool stopAfterConnectionTimeout()
+    {
+        return stopRequested();
+    }
+
+private:
+
+    OFMutex m_mutex;
+    OFBool m_stop;
+};
+
+
+/* create a private key and a self-signed certificate in PEM format */
+static OFBool createCertificate(const OFString& keyFile,
+                                const OFString& certFile)
+{
+    OFBool ok = OFFalse;
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+    if (ctx && (EVP_PKEY_keygen_init(ctx) > 0) && (EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) > 0))
+        EVP_PKEY_keygen(ctx, &pkey);
+    EVP_PKEY_CTX_free(ctx);
+    X509 *cert = X509_new();
+    if (pkey && cert)
+    {
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_get_notBefore(cert), 0);
+        X509_gmtime_adj(X509_get_notAfter(cert), 86400L);
+        X509_set_pubkey(cert, pkey);
+        X509_NAME *name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+            OFreinterpret_cast(const unsigned char *, "dcmnet_tests"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        if (X509_sign(cert, pkey, EVP_sha256()) > 0)
+        {
+            FILE *f = fopen(keyFile.c_str(), "wb");
+            ok = (f != NULL) && PEM_write_PrivateKey(f, pkey, NULL, NULL, 0, NULL, NULL);
+            if (f) fclose(f);
+            f = fopen(certFile.c_str(), "wb");
+            ok = ok && (f != NULL) && PEM_write_X509(f, cert);
+            if (f) fclose(f);
+        }
+    }
+    X509_free(cert);
+    EVP_PKEY_free(pkey);
+    return ok;
+}
+
+
+/* request a TLS association to the test SCP and release it again */
+static OFCondition requestAssociation(DcmTLSTransportLayer& tLayer,
+                                      OFBool& reused)
+{
+    reused = OFFalse;
+    T_ASC_Network *net = NULL;
+    T_ASC_Parameters *params = NULL;
+    T_ASC_Association *assoc = NULL;
+    OFCondition cond = ASC_initializeNetwork(NET_REQUESTOR, 0, 30, &net);
+    if (cond.good())
+        cond = ASC_setTransportLayer(net, &tLayer, 0 /* takeoverOwnership */);
+    if (cond.good())
+        cond = ASC_createAssociationParameters(&params, ASC_DEFAULTMAXPDU);
+    if (cond.good())
+    {
+        const char *xfers[] = { UID_LittleEndianImplicitTransferSyntax };
+        ASC_setAPTitles(params, "TLSTESTSCU", "TLSTESTSCP", NULL);
+        ASC_setPresentationAddresses(params, "localhost", "localhost:11112");
+        cond = ASC_setTransportLayerType(params, OFTrue);
+        if (cond.good())
+            cond = ASC_addPresentationContext(params, 1, UID_VerificationSOPClass, xfers, 1);
+    }
+    if (cond.good())
+    {
+        cond = ASC_requestAssociation(net, params, &assoc);
+        if (cond.good())
+        {
+            DcmTransportConnection *conn = DUL_getTransportConnection(assoc->DULassociation);
+            // only TLS connections are requested by this test
+            if ((conn != NULL) && !conn->isTransparentConnection())
+                reused = OFstatic_cast(DcmTLSConnection *, conn)->isSessionReused();
+            cond = ASC_releaseAssociation(assoc);
+        }
+    }
+    if (assoc != NULL)
+        ASC_destroyAssociation(&assoc);
+    else if (params != NULL)
+        ASC_destroyAssociationParameters(&params);
+    ASC_dropNetwork(&net);
+    return cond;
+}
+
+
+/* create a TLS transport layer that does not check certificates */
+static DcmTLSTransportLayer *createTransportLayer(const T_ASC_NetworkRole role,
+                                                  const OFString& keyFile,
+                                                  const OFString& certFile)
+{
+    DcmTLSTransportLayer *tLayer = new DcmTLSTransportLayer(role, NULL, OFFalse);
+    OFCHECK(tLayer->setTLSProfile(TSP_Profile_BCP195) == TCS_ok);
+    OFCHECK(tLayer->activateCipherSuites() == TCS_ok);
+    if (role == NET_ACCEPTOR)
+    {
+        OFCHECK(tLayer->setPrivateKeyFile(keyFile.c_str(), DCF_Filetype_PEM) == TCS_ok);
+        OFCHECK(tLayer->setCertificateFile(certFile.c_str(), DCF_Filetype_PEM) == TCS_ok);
+    }
+    tLayer->setCertificateVerification(DCV_ignoreCertificate);
+    return tLayer;
+}
+
+
+/* Test starts a TLS SCP and requests two associations with session caching
+ * enabled on both sides. The second association must resume the session of
+ * the first one. Without session caching on the requestor side, no session
+ * is resumed.
+ */
+OFTEST(dcmnet_tls_session_resumption)
+{
+    DcmTLSTransportLayer::initializeOpenSSL();
+    OFTempFile keyFile(O_RDWR, "", "ttls_", ".key");
+    OFTempFile certFile(O_RDWR, "", "ttls_", ".pem");
+    OFCHECK(createCertificate(keyFile.getFilename(), certFile.getFilename()));
+
+    DcmTLSTransportLayer *scpLayer = createTransportLayer(NET_ACCEPTOR, keyFile.getFilename(), certFile.getFilename());
+    DcmTLSTransportLayer *scuLayer = createTransportLayer(NET_REQUESTOR, "", "");
+    DcmTLSTransportLayer *plainScuLayer = createTransportLayer(NET_REQUESTOR, "", "");
+    OFCHECK(scpLayer->setSessionCaching(OFTrue) == TCS_ok);
+    OFCHECK(scuLayer->setSessionCaching(OFTrue) == TCS_ok);
+    OFCHECK(scpLayer->setReadAhead(OFTrue) == TCS_ok);
+    OFCHECK(scuLayer->setReadAhead(OFTrue) == TCS_ok);
+
+    TLSTestSCP scp;
+    DcmSCPConfig& config = scp.getConfig();
+    config.setAETitle("TLSTESTSCP");
+    config.setPort(11112);
+    config.setConnectionBlockingMode(DUL_NOBLOCK);
+    config.setConnectionTimeout(1);
+    OFList<OFString> xfers;
+    xfers.push_back(UID_LittleEndianImplicitTransferSyntax);
+    config.addPresentationContext(UID_VerificationSOPClass, xfers);
+    OFCHECK(scp.useSecureConnection(scpLayer).good());
+    scp.start();
+
+    // wait for the SCP to accept associations
+    OFBool reused = OFTrue;
+    OFCondition cond = requestAssociation(*scuLayer, reused);
+    for (int retry = 0; cond.bad() && (retry < 10); ++retry)
+    {
+        OFStandard::sleep(1);
+        cond = requestAssociation(*scuLayer, reused);
+    }
+    OFCHECK(cond.good());
+    OFCHECK(!reused);
+
+    // the second association to the same peer resumes the session
+    OFCHECK(requestAssociation(*scuLayer, reused).good());
+    OFCHECK(reused);
+    OFCHECK(requestAssociation(*scuLayer, reused).good());
+    OFCHECK(reused);
+
+    // without session caching, the requestor does not offer a session
+    OFCHECK(requestAssociation(*plainScuLayer, reused).good());
+    OFCHECK(!reused);
+    OFCHECK(requestAssociation(*plainScuLayer, reused).good());
+    OFCHECK(!reused);
+
+    scp.requestStop();
+    scp.join();
+    OFCHECK((scp.m_result == NET_EC_StopAfterConnectionTimeout) || (scp.m_result == NET_EC_StopAfterAssociation));
+    delete plainScuLayer;
+    delete scuLayer;
+    delete scpLayer;
+}
+
+#endif // WITH_THREADS && WITH_OPENSSL
@@ -0,0 +1,90 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmnet
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: test program for class DcmTranscodingCache
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/dcmnet/dctrcach.h"
+
+
+/* create a dataset with the given SOP Instance UID and about the given number of bytes */
+static DcmDataset *createDataset(const char *sopInstanceUID, const size_t size)
+{
+    DcmDataset *dataset = new DcmDataset;
+    dataset->putAndInsertString(DCM_SOPInstanceUID, sopInstanceUID);
+    OFString value(size, 'x');
+    dataset->putAndInsertString(DCM_ImageComments, value.c_str());
+    dataset->chooseRepresentation(EXS_LittleEndianExplicit, NULL);
+    return dataset;
+}
+
+
+OFTEST(dcmnet_transcodingCache)
+{
+    DcmTranscodingCache cache(3000);
+    DcmDataset *first = createDataset("1.2.3.1", 1000);
+    DcmDataset *second = createDataset("1.2.3.2", 1000);
+    DcmDataset *third = createDataset("1.2.3.3", 1000);
+    DcmDataset *large = createDataset("1.2.3.4", 4000);
+    DcmDataset result;
+    OFString value;
+
+    // entries are found by SOP Instance UID and transfer syntax
+    cache.put("1.2.3.1", EXS_LittleEndianExplicit, *first);
+    OFCHECK_EQUAL(cache.getNumberOfEntries(), 1);
+    OFCHECK(!cache.get("1.2.3.1", EXS_LittleEndianImplicit, result));
+    OFCHECK(!cache.get("1.2.3.2", EXS_LittleEndianExplicit, result));
+    OFCHECK(cache.get("1.2.3.1", EXS_LittleEndianExplicit, result));
+    OFCHECK(result.findAndGetOFString(DCM_SOPInstanceUID, value).good());
+    OFCHECK_EQUAL(value, "1.2.3.1");
+    OFCHECK_EQUAL(result.getCurrentXfer(), EXS_LittleEndianExplicit);
+
+    // the least recently used entry is removed if the maximum size is exceeded
+    cache.put("1.2.3.2", EXS_LittleEndianExplicit, *second);
+    OFCHECK(cache.get("1.2.3.1", EXS_LittleEndianExplicit, result));
+    cache.put("1.2.3.3", EXS_LittleEndianExplicit, *third);
+    OFCHECK_EQUAL(cache.getNumberOfEntries(), 2);
+    OFCHECK(cache.getSize() <= cache.getMaxSize());
+    OFCHECK(cache.get("1.2.3.1", EXS_LittleEndianExplicit, result));
+    OFCHECK(!cache.get("1.2.3.2", EXS_LittleEndianExplicit, result));
+    OFCHECK(cache.get("1.2.3.3", EXS_LittleEndianExplicit, result));
+
+    // datasets larger than the cache are not stored
+    cache.put("1.2.3.4", EXS_LittleEndianExplicit, *large);
+    OFCHECK(!cache.get("1.2.3.4", EXS_LittleEndianExplicit, result));
+    OFCHECK_EQUAL(cache.getNumberOfEntries(), 2);
+
+    // reducing the maximum size removes entries
+    cache.setMaxSize(1500);
+    OFCHECK_EQUAL(cache.getNumberOfEntries(), 1);
+    OFCHECK(cache.get("1.2.3.3", EXS_LittleEndianExplicit, result));
+    cache.clear();
+    OFCHECK_EQUAL(cache.getNumberOfEntries(), 0);
+    OFCHECK_EQUAL(cache.getSize(), 0);
+
+    delete first;
+    delete second;
+    delete third;
+    delete large;
+}
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -69,6 +69,7 @@ int main (int argc, char *argv[])
     const char *opt_storageArea = NULL;
     OFBool opt_print = OFFalse;
     OFBool opt_isNewFlag = OFTrue;
+    OFBool opt_upgrade = OFFalse;
 
 #ifdef WITH_TCPWRAPPER
     // this code makes sure that the linker cannot optimize away
@@ -91,6 +92,7 @@ int main (int argc, char *argv[])
      OFLog::addOptions(cmd);
      cmd.addOption("--print",   "-p", "list contents of database index file");
      cmd.addOption("--not-new", "-n", "set instance reviewed status to 'not new'");
+     cmd.addOption("--upgrade", "-u", "convert index file to current format");
 
     /* evaluate command line */
     prepareCmdLineArgs(argc, argv, OFFIS_CONSOLE_APPLICATION);
@@ -128,6 +130,9 @@ int main (int argc, char *argv[])
 
         if (cmd.findOption("--not-new"))
             opt_isNewFlag = OFFalse;
+
+        if (cmd.findOption("--upgrade"))
+            opt_upgrade = OFTrue;
     }
 
     /* print resource identifier */
@@ -141,6 +146,17 @@ int main (int argc, char *argv[])
     }
 
     OFCondition cond;
+    if (opt_upgrade)
+    {
+        OFLOG_INFO(dcmqridxLogger, "converting index file in storage area: " << opt_storageArea);
+        cond = DcmQueryRetrieveIndexDatabaseHandle::upgradeIndexFile(opt_storageArea);
+        if (cond.bad())
+        {
+            OFLOG_FATAL(dcmqridxLogger, "cannot convert index file: " << cond.text());
+            return 1;
+        }
+    }
+
     DcmQueryRetrieveIndexDatabaseHandle hdl(opt_storageArea, DB_UpperMaxStudies, DB_UpperMaxBytesPerStudy, cond);
     if (cond.good())
     {
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -94,6 +94,7 @@ static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v"
 const char *opt_configFileName = DEFAULT_CONFIGURATION_DIR "dcmqrscp.cfg";
 OFBool      opt_checkFindIdentifier = OFFalse;
 OFBool      opt_checkMoveIdentifier = OFFalse;
+OFBool      opt_purgeInBackground = OFFalse;
 OFCmdUnsignedInt opt_port = 0;
 
 #define SHORTCOL 4
@@ -178,6 +179,16 @@ main(int argc, char *argv[])
       cmd.addOption("--move-aetitle",           "-ZA",     "restrict move dest. to requesting AE title");
       cmd.addOption("--move-host",              "-ZH",     "restrict move destination to requesting host");
       cmd.addOption("--move-vendor",            "-ZV",     "restrict move destination to requesting vendor");
+#ifdef WITH_THREADS
+    cmd.addSubGroup("performance of move sub-operations:");
+      cmd.addOption("--sub-associations",       "-Zs",  1, "[n]umber: integer (1..64, default: 1)",
+                                                           "send instances over up to n parallel\nsub-associations");
+      cmd.addOption("--read-ahead",             "-Zr",  1, "[n]umber: integer (0..1024, default: 0)",
+                                                           "read up to n files ahead of the sub-operations\ncurrently in progress");
+    cmd.addSubGroup("deletion of files exceeding the quota:");
+      cmd.addOption("--purge-in-foreground",               "delete files before responding (default)");
+      cmd.addOption("--purge-in-background",               "delete files in a background thread");
+#endif
     cmd.addSubGroup("restriction of query/retrieve models:");
       cmd.addOption("--no-patient-root",        "-QP",     "do not support Patient Root Q/R models");
       cmd.addOption("--no-study-root",          "-QS",     "do not support Study Root Q/R models");
@@ -394,6 +405,14 @@ main(int argc, char *argv[])
       if (cmd.findOption("--move-host")) options.restrictMoveToSameHost_ = OFTrue;
       if (cmd.findOption("--move-vendor")) options.restrictMoveToSameVendor_ = OFTrue;
       cmd.endOptionBlock();
+#ifdef WITH_THREADS
+      if (cmd.findOption("--sub-associations")) app.checkValue(cmd.getValueAndCheckMinMax(options.maxMoveSubAssociations_, 1, 64));
+      if (cmd.findOption("--read-ahead")) app.checkValue(cmd.getValueAndCheckMinMax(options.moveReadAhead_, 0, 1024));
+      cmd.beginOptionBlock();
+      if (cmd.findOption("--purge-in-foreground")) opt_purgeInBackground = OFFalse;
+      if (cmd.findOption("--purge-in-background")) opt_purgeInBackground = OFTrue;
+      cmd.endOptionBlock();
+#endif
 
       if (cmd.findOption("--no-patient-root")) options.supportPatientRoot_ = OFFalse;
       if (cmd.findOption("--no-study-root")) options.supportStudyRoot_ = OFFalse;
@@ -902,6 +921,7 @@ main(int argc, char *argv[])
 #else
     // use linear index database (index.dat)
     DcmQueryRetrieveIndexDatabaseHandleFactory factory(&config);
+    factory.setBackgroundPurge(opt_purgeInBackground);
 #endif
 
     DcmQueryRetrieveSCP scp(config, options, factory, asccfg);
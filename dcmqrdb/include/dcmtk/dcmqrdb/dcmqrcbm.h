@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -31,6 +31,9 @@ class DcmQueryRetrieveDatabaseHandle;
 class DcmQueryRetrieveOptions;
 class DcmQueryRetrieveConfig;
 class DcmQueryRetrieveDatabaseStatus;
+class DcmQueryRetrieveMoveWorker;
+class DcmQueryRetrieveMoveWorkerPool;
+struct DcmQueryRetrieveMoveSubOp;
 
 /** this class maintains the context information that is passed to the
  *  callback function called by DIMSE_moveProvider.
@@ -75,12 +78,21 @@ public:
     , nCompleted(0)
     , nFailed(0)
     , nWarning(0)
+    , workerPool(NULL)
+    , dbFinished(OFFalse)
     {
       origAETitle[0] = '\0';
       origHostName[0] = '\0';
       dstAETitle[0] = '\0';
+      dstPresentationAddress[0] = '\0';
     }
 
+    /** destructor. Closes the sub-associations if the move operation has
+     *  not been completed regularly, e.g. because the original association
+     *  has been aborted.
+     */
+    ~DcmQueryRetrieveMoveContext();
+
     /** callback handler called by the DIMSE_storeProvider callback function.
      *  @param cancelled (in) flag indicating whether a C-CANCEL was received
      *  @param request original move request (in)
@@ -108,6 +120,21 @@ public:
 
 private:
 
+    friend class DcmQueryRetrieveMoveWorker;
+    friend class DcmQueryRetrieveMoveWorkerPool;
+    friend struct DcmQueryRetrieveMoveSubOp;
+
+    /// result of a single C-STORE sub-operation
+    enum E_SubOpResult
+    {
+      /// sub-operation completed successfully
+      ESR_Completed,
+      /// sub-operation completed with a warning
+      ESR_Warning,
+      /// sub-operation failed
+      ESR_Failed
+    };
+
     /// private undefined copy constructor
     DcmQueryRetrieveMoveContext(const DcmQueryRetrieveMoveContext& other);
 
@@ -116,9 +143,18 @@ private:
 
     void addFailedUIDInstance(const char *sopInstance);
     OFCondition performMoveSubOp(DIC_UI sopClass, DIC_UI sopInstance, char *fname);
+    OFCondition storeSubOp(T_ASC_Association *assoc, const char *sopClass,
+      const char *sopInstance, const char *fname, E_SubOpResult& result) const;
+    void countSubOp(E_SubOpResult result, const char *sopInstance);
     OFCondition buildSubAssociation(T_DIMSE_C_MoveRQ *request);
+    OFCondition requestSubAssociation(T_ASC_Association **assoc);
+    OFCondition releaseSubAssociation(T_ASC_Association **assoc);
     OFCondition closeSubAssociation();
     void moveNextImage(DcmQueryRetrieveDatabaseStatus * dbStatus);
+    void moveNextImages(DcmQueryRetrieveDatabaseStatus * dbStatus);
+    void startWorkerPool();
+    void collectSubOpResult();
+    DIC_US remainingSubOperations() const;
     void failAllSubOperations(DcmQueryRetrieveDatabaseStatus * dbStatus);
     void buildFailedInstanceList(DcmDataset ** rspIds);
     OFBool mapMoveDestination(
@@ -168,6 +204,9 @@ private:
     /// destination title for move
     DIC_AE dstAETitle;
 
+    /// presentation address (host and port) of move destination
+    DIC_NODENAME dstPresentationAddress;
+
     /// instance UIDs of failed store sub-ops
     char *failedUIDs;
 
@@ -183,6 +222,14 @@ private:
     /// number of completed sub-operations that causes warnings
     DIC_US nWarning;
 
+    /** worker threads performing the sub-operations in parallel, NULL if the
+     *  sub-operations are performed sequentially by the calling thread
+     */
+    DcmQueryRetrieveMoveWorkerPool *workerPool;
+
+    /// true if all matching instances have been fetched from the database
+    OFBool dbFinished;
+
 };
 
 #endif
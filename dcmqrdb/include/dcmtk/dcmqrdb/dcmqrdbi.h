@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2017, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -35,14 +35,21 @@ struct DB_SmallDcmElmt;
 struct IdxRecord;
 struct DB_ElementList;
 class DcmQueryRetrieveConfig;
+class DcmQueryRetrieveIndexDatabasePurger;
 
 /* ENSURE THAT DBVERSION IS INCREMENTED WHENEVER ONE OF THE INDEX FILE STRUCTS IS MODIFIED */
 
 #define DBINDEXFILE  "index.dat"
 #define DBMAGIC      "QRDB"
-#define DBVERSION    5
+#define DBVERSION    6
 #define DBHEADERSIZE 6
 
+/* index files of this version store each instance record as a binary copy of
+ * struct IdxRecord. They can be converted to the current version using
+ * DcmQueryRetrieveIndexDatabaseHandle::upgradeIndexFile().
+ */
+#define DBVERSION_FIXEDSIZERECORDS 5
+
 #if DBVERSION > 0xFF
 #error maximum database version reached, you have to invent a new mechanism
 #endif
@@ -261,10 +268,35 @@ public:
    */
   void enableQuotaSystem(OFBool enable);
 
+  /** enable/disable the deletion of image files in a background thread
+   *  (default: disabled). If enabled, files removed from the database by the
+   *  quota mechanism or replaced by a duplicate SOP instance are queued and
+   *  deleted by a separate thread, so that storeRequest() does not wait for
+   *  the file system. Pending deletions are completed when the handle is
+   *  destroyed. This method has no effect if DCMTK was compiled without
+   *  thread support.
+   *  @param enable OFTrue to delete files in the background, OFFalse to delete
+   *    them immediately
+   */
+  void enableBackgroundPurge(OFBool enable);
+
   /** dump database index file to stdout.
    *  @param storeArea name of storage area, must not be NULL
    */
   static void printIndexFile (char *storeArea);
+
+  /** convert the index file of the given storage area from the format with
+   *  fixed-size instance records (version 5) to the current compact format.
+   *  Unused instance records are removed during the conversion, so the
+   *  record numbers may change. The index file is locked exclusively while
+   *  it is converted, i.e. processes accessing the storage area do not have
+   *  to be stopped. A copy of the original file is kept with the file name
+   *  extension ".v5". Index files that already use the current format are
+   *  left unchanged.
+   *  @param storeArea name of storage area, must not be NULL
+   *  @return EC_Normal upon success, an error code otherwise
+   */
+  static OFCondition upgradeIndexFile(const char *storeArea);
   
   /** search for a SOP class and SOP instance UIDs in index file. 
   *  @param storeArea name of storage area, must not be NULL
@@ -403,6 +435,9 @@ private:
   /// flag indicating whether or not the quota system is enabled
   OFBool quotaSystemEnabled;
 
+  /// thread deleting image files in the background, NULL if files are deleted immediately
+  DcmQueryRetrieveIndexDatabasePurger *purger_;
+
   /// flag indicating whether or not the check function for FIND requests is enabled
   OFBool doCheckFindIdentifier;
 
@@ -450,10 +485,20 @@ public:
     const char *calledAETitle,
     OFCondition& result) const;
 
+  /** enable/disable the deletion of image files in a background thread for
+   *  all database handles created by this factory (default: disabled).
+   *  @param enable OFTrue to delete files in the background, OFFalse otherwise
+   *  @see DcmQueryRetrieveIndexDatabaseHandle::enableBackgroundPurge()
+   */
+  void setBackgroundPurge(OFBool enable);
+
 private:
 
   /// pointer to system configuration
   const DcmQueryRetrieveConfig *config_;
+
+  /// flag indicating whether database handles delete files in the background
+  OFBool backgroundPurge_;
 };
 
 #endif
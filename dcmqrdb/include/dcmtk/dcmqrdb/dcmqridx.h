@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -25,6 +25,9 @@
 #include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
 
 #include "dcmtk/ofstd/ofoption.h"
+#include "dcmtk/ofstd/ofvector.h"
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofmap.h"
 #include "dcmtk/dcmnet/dicom.h"
 #include "dcmtk/dcmdata/dcdatset.h"
 #include "dcmtk/dcmdata/dcuid.h"
@@ -227,6 +230,18 @@ struct DCMTK_DCMQRDB_EXPORT DB_FindAttr
 
 /* ENSURE THAT DBVERSION IS INCREMENTED WHENEVER ONE OF THESE STRUCTS IS MODIFIED */
 
+/** reference to an instance record, used to determine the order in which
+ *  the images of a study are deleted by the quota mechanism
+ */
+struct DCMTK_DCMQRDB_EXPORT ImagesofStudyArray
+{
+    Uint32 idxCounter ;
+    double RecordedDate ;
+    Uint32 ImageSize ;
+};
+
+/* ENSURE THAT DBVERSION IS INCREMENTED WHENEVER ONE OF THESE STRUCTS IS MODIFIED */
+
 struct DCMTK_DCMQRDB_EXPORT DB_Private_Handle
 {
     int pidx ;
@@ -244,6 +259,16 @@ struct DCMTK_DCMQRDB_EXPORT DB_Private_Handle
     int NumberRemainOperations ;
     DB_QUERY_CLASS rootLevel ;
     DB_UidList *uidList ;
+    /* file offsets of the instance records visited so far, followed by the
+     * offset of the first record not yet visited (see DB_IdxReadSlot())
+     */
+    OFVector<long> recordOffsets ;
+    /* images of each study in the index file, oldest first. Built on demand
+     * by the quota mechanism and kept up to date by this handle as long as
+     * evictionIndexValid is set (see DB_EvictionIndexGetStudy()).
+     */
+    OFMap<OFString, OFList<ImagesofStudyArray> > evictionIndex ;
+    OFBool evictionIndexValid ;
 
     DB_Private_Handle()
     : pidx(0)
@@ -261,6 +286,9 @@ struct DCMTK_DCMQRDB_EXPORT DB_Private_Handle
     , NumberRemainOperations(0)
     , rootLevel(STUDY_ROOT)
     , uidList(NULL)
+    , recordOffsets()
+    , evictionIndex()
+    , evictionIndexValid(OFFalse)
     {
     }
 };
@@ -286,15 +314,6 @@ struct DCMTK_DCMQRDB_EXPORT StudyDescRecord
     Uint32 NumberofRegistratedImages ;
 };
 
-/* ENSURE THAT DBVERSION IS INCREMENTED WHENEVER ONE OF THESE STRUCTS IS MODIFIED */
-
-struct DCMTK_DCMQRDB_EXPORT ImagesofStudyArray
-{
-    Uint32 idxCounter ;
-    double RecordedDate ;
-    Uint32 ImageSize ;
-};
-
 
 /* the following constants define which array element
  * of the param[] array in the IdxRecord structure
@@ -350,8 +369,9 @@ struct DCMTK_DCMQRDB_EXPORT ImagesofStudyArray
 /* ENSURE THAT DBVERSION IS INCREMENTED WHENEVER ONE OF THESE STRUCTS IS MODIFIED */
 
 /** this class manages an instance entry of the index file.
- *  Each instance/image record within the index.dat file is
- *  a direct (binary) copy of this structure.
+ *  Within the index.dat file, each instance/image record is stored in
+ *  a compact format with variable-length strings (see dcmqrdbi.cc).
+ *  Index files of version 5 contained a direct (binary) copy of this structure.
  */
 struct DCMTK_DCMQRDB_EXPORT IdxRecord
 {
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2017, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -87,6 +87,18 @@ public:
   /// maximum PDU size
   OFCmdUnsignedInt  maxPDU_;
 
+  /** maximum number of parallel sub-associations for the C-STORE
+   *  sub-operations of a C-MOVE request (only used if compiled with
+   *  thread support)
+   */
+  OFCmdUnsignedInt  maxMoveSubAssociations_;
+
+  /** number of files to be read ahead of the C-STORE sub-operations of a
+   *  C-MOVE request, i.e.\ loaded into the file system cache while other
+   *  files are being sent (only used if compiled with thread support)
+   */
+  OFCmdUnsignedInt  moveReadAhead_;
+
   /// pointer to network structure used for requesting C-STORE sub-associations
   T_ASC_Network *   net_;
 
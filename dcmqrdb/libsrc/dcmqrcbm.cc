@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -31,6 +31,13 @@
 #include "dcmtk/dcmqrdb/dcmqrdbs.h"
 #include "dcmtk/dcmqrdb/dcmqrdbi.h"
 #include "dcmtk/ofstd/ofstd.h"
+#include "dcmtk/ofstd/offile.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#include "dcmtk/ofstd/oflist.h"
+#include "dcmtk/ofstd/ofvector.h"
+#endif
 
 BEGIN_EXTERN_C
 #ifdef HAVE_FCNTL_H
@@ -67,6 +74,409 @@ static void moveSubOpProgressCallback(void * /* callbackData */,
   }
 }
 
+#ifdef WITH_THREADS
+
+/** a single C-STORE sub-operation of a C-MOVE request that is performed by
+ *  one of the worker threads of class DcmQueryRetrieveMoveWorkerPool
+ */
+struct DcmQueryRetrieveMoveSubOp
+{
+    DcmQueryRetrieveMoveSubOp(const char *sopClass, const char *sopInstance, const char *fileName)
+    : sopClassUID(sopClass)
+    , sopInstanceUID(sopInstance)
+    , imageFileName(fileName)
+    , readAhead(OFFalse)
+    , result(DcmQueryRetrieveMoveContext::ESR_Failed)
+    , cond(EC_Normal)
+    {
+    }
+
+    /// SOP class UID of the instance to be sent
+    OFString sopClassUID;
+
+    /// SOP instance UID of the instance to be sent
+    OFString sopInstanceUID;
+
+    /// name of the file to be sent
+    OFString imageFileName;
+
+    /// true if the file has already been read ahead
+    OFBool readAhead;
+
+    /// result of the sub-operation
+    DcmQueryRetrieveMoveContext::E_SubOpResult result;
+
+    /// condition returned by the C-STORE operation
+    OFCondition cond;
+};
+
+/** a thread that performs C-STORE sub-operations on its own sub-association
+ */
+class DcmQueryRetrieveMoveWorker : public OFThread
+{
+public:
+    /** constructor
+     *  @param pool the pool providing the sub-operations
+     *  @param context the move context, used for sending the instances
+     *  @param assoc the sub-association used by this thread
+     *  @param owned true if the sub-association should be released by the pool
+     */
+    DcmQueryRetrieveMoveWorker(DcmQueryRetrieveMoveWorkerPool& pool,
+                               const DcmQueryRetrieveMoveContext& context,
+                               T_ASC_Association *assoc,
+                               OFBool owned)
+    : OFThread()
+    , pool_(pool)
+    , context_(context)
+    , assoc_(assoc)
+    , owned_(owned)
+    {
+    }
+
+    /// returns the sub-association used by this thread
+    T_ASC_Association *association() const { return assoc_; }
+
+    /// returns true if the sub-association should be released by the pool
+    OFBool ownsAssociation() const { return owned_; }
+
+protected:
+    /// performs sub-operations until the pool is shut down
+    virtual void run();
+
+private:
+    /// private undefined copy constructor
+    DcmQueryRetrieveMoveWorker(const DcmQueryRetrieveMoveWorker& other);
+
+    /// private undefined assignment operator
+    DcmQueryRetrieveMoveWorker& operator=(const DcmQueryRetrieveMoveWorker& other);
+
+    /// the pool providing the sub-operations
+    DcmQueryRetrieveMoveWorkerPool& pool_;
+
+    /// the move context
+    const DcmQueryRetrieveMoveContext& context_;
+
+    /// the sub-association used by this thread
+    T_ASC_Association *assoc_;
+
+    /// true if the sub-association should be released by the pool
+    OFBool owned_;
+};
+
+/** a set of worker threads, each of them sending instances to the move
+ *  destination on its own sub-association. The queue of sub-operations is
+ *  filled and the results are collected by the thread handling the C-MOVE
+ *  request, which is also the only thread accessing the database. While
+ *  waiting for results, this thread reads the files of the next queued
+ *  sub-operations in order to load them into the file system cache.
+ */
+class DcmQueryRetrieveMoveWorkerPool
+{
+public:
+    /** constructor
+     *  @param context the move context
+     *  @param readAhead number of queued files to be read ahead
+     */
+    DcmQueryRetrieveMoveWorkerPool(DcmQueryRetrieveMoveContext& context, size_t readAhead)
+    : context_(context)
+    , readAhead_(readAhead)
+    , workers_()
+    , queue_()
+    , finished_()
+    , mutex_()
+    , queued_(0)
+    , done_(0)
+    , outstanding_(0)
+    , activeWorkers_(0)
+    {
+    }
+
+    /// destructor, stops all worker threads and releases their sub-associations
+    ~DcmQueryRetrieveMoveWorkerPool();
+
+    /** starts a worker thread for the given sub-association
+     *  @param assoc sub-association, released by the pool if owned is true
+     *  @param owned true if the sub-association should be released by the pool
+     *  @return OFTrue if the thread has been started, OFFalse otherwise
+     */
+    OFBool addWorker(T_ASC_Association *assoc, OFBool owned);
+
+    /// returns the number of sub-operations queued or in progress
+    size_t outstanding() const { return outstanding_; }
+
+    /** returns the number of sub-operations that should be queued or in progress
+     *  in order to keep all worker threads busy
+     */
+    size_t capacity() const { return 2 * workers_.size() + readAhead_; }
+
+    /** adds a sub-operation to the queue
+     *  @param sopClass SOP class UID of the instance to be sent
+     *  @param sopInstance SOP instance UID of the instance to be sent
+     *  @param fileName name of the file to be sent
+     */
+    void enqueue(const char *sopClass, const char *sopInstance, const char *fileName);
+
+    /** removes all sub-operations from the queue that have not been started yet
+     *  @return number of sub-operations removed
+     */
+    size_t cancelPending();
+
+    /** waits until a sub-operation has been finished. Reads ahead the files
+     *  of the next queued sub-operations while waiting.
+     *  @return the finished sub-operation, to be deleted by the caller.
+     *    NULL if no sub-operation is outstanding.
+     */
+    DcmQueryRetrieveMoveSubOp *waitForResult();
+
+    // --- methods called by the worker threads
+
+    /** returns the next sub-operation to be performed, waits if the queue is empty
+     *  @return next sub-operation, NULL if the thread should terminate
+     */
+    DcmQueryRetrieveMoveSubOp *nextSubOp();
+
+    /** reports that a sub-operation has been finished
+     *  @param subOp the sub-operation
+     */
+    void finishSubOp(DcmQueryRetrieveMoveSubOp *subOp);
+
+    /** reports that a worker thread terminates because its sub-association
+     *  cannot be used anymore. If this was the last worker thread, all
+     *  queued sub-operations are marked as failed.
+     */
+    void workerFailed();
+
+private:
+    /// private undefined copy constructor
+    DcmQueryRetrieveMoveWorkerPool(const DcmQueryRetrieveMoveWorkerPool& other);
+
+    /// private undefined assignment operator
+    DcmQueryRetrieveMoveWorkerPool& operator=(const DcmQueryRetrieveMoveWorkerPool& other);
+
+    /// fails all queued sub-operations, mutex must be locked by the caller
+    void failQueued();
+
+    /// the move context
+    DcmQueryRetrieveMoveContext& context_;
+
+    /// number of queued files to be read ahead
+    size_t readAhead_;
+
+    /// worker threads
+    OFVector<DcmQueryRetrieveMoveWorker *> workers_;
+
+    /// sub-operations not yet started, protected by mutex_
+    OFList<DcmQueryRetrieveMoveSubOp *> queue_;
+
+    /// sub-operations finished but not yet collected, protected by mutex_
+    OFList<DcmQueryRetrieveMoveSubOp *> finished_;
+
+    /// mutex protecting the lists and the number of active workers
+    OFMutex mutex_;
+
+    /// posted for each queued sub-operation and for each thread to be stopped
+    OFSemaphore queued_;
+
+    /// posted for each finished sub-operation
+    OFSemaphore done_;
+
+    /// number of sub-operations queued or in progress (only used by the calling thread)
+    size_t outstanding_;
+
+    /// number of worker threads that are still able to perform sub-operations
+    size_t activeWorkers_;
+};
+
+/** reads a file completely in order to load it into the file system cache
+ *  @param fileName name of the file
+ */
+static void readAheadFile(const OFString& fileName)
+{
+    OFFile file;
+    if (file.fopen(fileName, "rb"))
+    {
+        char buffer[65536];
+        while (file.fread(buffer, 1, sizeof(buffer)) == sizeof(buffer))
+            /* nothing to do */;
+        file.fclose();
+    }
+}
+
+void DcmQueryRetrieveMoveWorker::run()
+{
+    DcmQueryRetrieveMoveSubOp *subOp;
+    while ((subOp = pool_.nextSubOp()) != NULL)
+    {
+        subOp->cond = context_.storeSubOp(assoc_, subOp->sopClassUID.c_str(),
+            subOp->sopInstanceUID.c_str(), subOp->imageFileName.c_str(), subOp->result);
+        /* any error except a missing presentation context means that the
+         * sub-association cannot be used anymore
+         */
+        const OFBool failed = subOp->cond.bad() && (subOp->cond != DIMSE_NOVALIDPRESENTATIONCONTEXTID);
+        pool_.finishSubOp(subOp);
+        if (failed)
+        {
+            pool_.workerFailed();
+            return;
+        }
+    }
+}
+
+DcmQueryRetrieveMoveWorkerPool::~DcmQueryRetrieveMoveWorkerPool()
+{
+    size_t i;
+    /* the queue is empty, so each thread terminates after receiving a post */
+    for (i = 0; i < workers_.size(); i++)
+        queued_.post();
+    for (i = 0; i < workers_.size(); i++)
+    {
+        DcmQueryRetrieveMoveWorker *worker = workers_[i];
+        worker->join();
+        if (worker->ownsAssociation())
+        {
+            T_ASC_Association *assoc = worker->association();
+            context_.releaseSubAssociation(&assoc);
+        }
+        delete worker;
+    }
+    OFListIterator(DcmQueryRetrieveMoveSubOp *) it = finished_.begin();
+    while (it != finished_.end())
+        delete *it++;
+}
+
+OFBool DcmQueryRetrieveMoveWorkerPool::addWorker(T_ASC_Association *assoc, OFBool owned)
+{
+    DcmQueryRetrieveMoveWorker *worker = new DcmQueryRetrieveMoveWorker(*this, context_, assoc, owned);
+    mutex_.lock();
+    activeWorkers_++;
+    mutex_.unlock();
+    if (worker->start() != 0)
+    {
+        DCMQRDB_ERROR("moveSCP: cannot start thread for sub-association");
+        mutex_.lock();
+        activeWorkers_--;
+        mutex_.unlock();
+        delete worker;
+        return OFFalse;
+    }
+    workers_.push_back(worker);
+    return OFTrue;
+}
+
+void DcmQueryRetrieveMoveWorkerPool::enqueue(const char *sopClass, const char *sopInstance, const char *fileName)
+{
+    outstanding_++;
+    mutex_.lock();
+    queue_.push_back(new DcmQueryRetrieveMoveSubOp(sopClass, sopInstance, fileName));
+    if (activeWorkers_ == 0)
+        failQueued();
+    mutex_.unlock();
+    queued_.post();
+}
+
+size_t DcmQueryRetrieveMoveWorkerPool::cancelPending()
+{
+    mutex_.lock();
+    const size_t count = queue_.size();
+    OFListIterator(DcmQueryRetrieveMoveSubOp *) it = queue_.begin();
+    while (it != queue_.end())
+        delete *it++;
+    queue_.clear();
+    mutex_.unlock();
+    outstanding_ -= count;
+    return count;
+}
+
+DcmQueryRetrieveMoveSubOp *DcmQueryRetrieveMoveWorkerPool::waitForResult()
+{
+    if (outstanding_ == 0)
+        return NULL;
+
+    if (readAhead_ > 0)
+    {
+        /* determine the files to be read ahead, the worker threads may
+         * start sending them in the meantime but this does no harm
+         */
+        OFList<OFString> fileNames;
+        mutex_.lock();
+        size_t count = 0;
+        OFListIterator(DcmQueryRetrieveMoveSubOp *) it = queue_.begin();
+        while ((it != queue_.end()) && (count < readAhead_))
+        {
+            if (!(*it)->readAhead)
+            {
+                (*it)->readAhead = OFTrue;
+                fileNames.push_back((*it)->imageFileName);
+            }
+            ++it;
+            ++count;
+        }
+        mutex_.unlock();
+        OFListIterator(OFString) name = fileNames.begin();
+        while (name != fileNames.end())
+            readAheadFile(*name++);
+    }
+
+    done_.wait();
+    mutex_.lock();
+    DcmQueryRetrieveMoveSubOp *subOp = finished_.front();
+    finished_.pop_front();
+    mutex_.unlock();
+    outstanding_--;
+    return subOp;
+}
+
+DcmQueryRetrieveMoveSubOp *DcmQueryRetrieveMoveWorkerPool::nextSubOp()
+{
+    DcmQueryRetrieveMoveSubOp *subOp = NULL;
+    queued_.wait();
+    mutex_.lock();
+    if (!queue_.empty())
+    {
+        subOp = queue_.front();
+        queue_.pop_front();
+    }
+    mutex_.unlock();
+    return subOp;
+}
+
+void DcmQueryRetrieveMoveWorkerPool::finishSubOp(DcmQueryRetrieveMoveSubOp *subOp)
+{
+    mutex_.lock();
+    finished_.push_back(subOp);
+    mutex_.unlock();
+    done_.post();
+}
+
+void DcmQueryRetrieveMoveWorkerPool::workerFailed()
+{
+    mutex_.lock();
+    if (--activeWorkers_ == 0)
+        failQueued();
+    mutex_.unlock();
+}
+
+void DcmQueryRetrieveMoveWorkerPool::failQueued()
+{
+    while (!queue_.empty())
+    {
+        DcmQueryRetrieveMoveSubOp *subOp = queue_.front();
+        queue_.pop_front();
+        DCMQRDB_ERROR("Move SCP: storeSCU: [file: " << subOp->imageFileName << "]: no sub-association available");
+        subOp->result = DcmQueryRetrieveMoveContext::ESR_Failed;
+        finished_.push_back(subOp);
+        done_.post();
+    }
+}
+
+#endif /* WITH_THREADS */
+
+DcmQueryRetrieveMoveContext::~DcmQueryRetrieveMoveContext()
+{
+    closeSubAssociation();
+    free(failedUIDs);
+}
+
 void DcmQueryRetrieveMoveContext::callbackHandler(
     /* in */
     OFBool cancelled, T_DIMSE_C_MoveRQ *request,
@@ -146,7 +556,7 @@ void DcmQueryRetrieveMoveContext::callbackHandler(
 
     /* set response status */
     response->DimseStatus = dbStatus.status();
-    response->NumberOfRemainingSubOperations = nRemaining;
+    response->NumberOfRemainingSubOperations = remainingSubOperations();
     response->NumberOfCompletedSubOperations = nCompleted;
     response->NumberOfFailedSubOperations = nFailed;
     response->NumberOfWarningSubOperations = nWarning;
@@ -188,6 +598,15 @@ void DcmQueryRetrieveMoveContext::addFailedUIDInstance(const char *sopInstance)
 }
 
 OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_UI sopInstance, char *fname)
+{
+    E_SubOpResult result = ESR_Failed;
+    OFCondition cond = storeSubOp(subAssoc, sopClass, sopInstance, fname, result);
+    countSubOp(result, sopInstance);
+    return cond;
+}
+
+OFCondition DcmQueryRetrieveMoveContext::storeSubOp(T_ASC_Association *assoc, const char *sopClass,
+    const char *sopInstance, const char *fname, E_SubOpResult& result) const
 {
     OFCondition cond = EC_Normal;
     T_DIMSE_C_StoreRQ req;
@@ -196,6 +615,8 @@ OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_U
     T_ASC_PresentationContextID presId;
     DcmDataset *stDetail = NULL;
 
+    result = ESR_Failed;
+
 #ifdef LOCK_IMAGE_FILES
     /* shared lock image file */
     int lockfd;
@@ -208,21 +629,17 @@ OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_U
         /* due to quota system the file could have been deleted */
         DCMQRDB_ERROR("Move SCP: storeSCU: [file: " << fname << "]: "
             << OFStandard::getLastSystemErrorCode().message());
-        nFailed++;
-        addFailedUIDInstance(sopInstance);
         return EC_Normal;
     }
     dcmtk_flock(lockfd, LOCK_SH);
 #endif
 
-    msgId = subAssoc->nextMsgID++;
+    msgId = assoc->nextMsgID++;
 
     /* which presentation context should be used */
-    presId = ASC_findAcceptedPresentationContextID(subAssoc,
+    presId = ASC_findAcceptedPresentationContextID(assoc,
         sopClass);
     if (presId == 0) {
-        nFailed++;
-        addFailedUIDInstance(sopInstance);
         DCMQRDB_ERROR("Move SCP: storeSCU: [file: " << fname << "] No presentation context for: ("
             << dcmSOPClassUIDToModality(sopClass, "OT") << ") " << sopClass);
         return DIMSE_NOVALIDPRESENTATIONCONTEXTID;
@@ -240,8 +657,8 @@ OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_U
     DCMQRDB_INFO("Store SCU RQ: MsgID " << msgId << ", ("
         << dcmSOPClassUIDToModality(sopClass, "OT") << ")");
 
-    cond = DIMSE_storeUser(subAssoc, presId, &req,
-        fname, NULL, moveSubOpProgressCallback, this,
+    cond = DIMSE_storeUser(assoc, presId, &req,
+        fname, NULL, moveSubOpProgressCallback, OFconst_cast(DcmQueryRetrieveMoveContext *, this),
         options_.blockMode_, options_.dimse_timeout_,
         &rsp, &stDetail);
 
@@ -256,22 +673,18 @@ OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_U
             << DU_cstoreStatusString(rsp.DimseStatus) << "]");
         if (rsp.DimseStatus == STATUS_Success) {
             /* everything ok */
-            nCompleted++;
+            result = ESR_Completed;
         } else if ((rsp.DimseStatus & 0xf000) == 0xb000) {
             /* a warning status message */
-            nWarning++;
+            result = ESR_Warning;
             DCMQRDB_ERROR("Move SCP: Store Warning: Response Status: " <<
                     DU_cstoreStatusString(rsp.DimseStatus));
         } else {
-            nFailed++;
-            addFailedUIDInstance(sopInstance);
             /* print a status message */
             DCMQRDB_ERROR("Move SCP: Store Failed: Response Status: " <<
                 DU_cstoreStatusString(rsp.DimseStatus));
         }
     } else {
-        nFailed++;
-        addFailedUIDInstance(sopInstance);
         OFString temp_str;
         DCMQRDB_ERROR("Move SCP: storeSCU: Store Request Failed: " << DimseCondition::dump(temp_str, cond));
     }
@@ -282,14 +695,27 @@ OFCondition DcmQueryRetrieveMoveContext::performMoveSubOp(DIC_UI sopClass, DIC_U
     return cond;
 }
 
+void DcmQueryRetrieveMoveContext::countSubOp(E_SubOpResult result, const char *sopInstance)
+{
+    switch (result)
+    {
+      case ESR_Completed:
+        nCompleted++;
+        break;
+      case ESR_Warning:
+        nWarning++;
+        break;
+      case ESR_Failed:
+        nFailed++;
+        addFailedUIDInstance(sopInstance);
+        break;
+    }
+}
+
 OFCondition DcmQueryRetrieveMoveContext::buildSubAssociation(T_DIMSE_C_MoveRQ *request)
 {
-    OFCondition cond = EC_Normal;
     DIC_NODENAME dstHostName;
-    DIC_NODENAME dstHostNamePlusPort;
     int dstPortNumber;
-    T_ASC_Parameters *params;
-    OFString temp_str;
 
     OFStandard::strlcpy(dstAETitle, request->MoveDestination, DIC_AE_LEN + 1);
 
@@ -310,16 +736,28 @@ OFCondition DcmQueryRetrieveMoveContext::buildSubAssociation(T_DIMSE_C_MoveRQ *r
         request->MoveDestination, dstHostName, DIC_NODENAME_LEN + 1, &dstPortNumber)) {
         return QR_EC_InvalidPeer;
     }
+    OFStandard::snprintf(dstPresentationAddress, sizeof(DIC_NODENAME), "%s:%d", dstHostName, dstPortNumber);
+
+    OFCondition cond = requestSubAssociation(&subAssoc);
     if (cond.good()) {
-        cond = ASC_createAssociationParameters(&params, ASC_DEFAULTMAXPDU);
-        if (cond.bad()) {
-            DCMQRDB_ERROR("moveSCP: Cannot create Association-params for sub-ops: " << DimseCondition::dump(temp_str, cond));
-        }
+        assocStarted = OFTrue;
+    }
+    return cond;
+}
+
+OFCondition DcmQueryRetrieveMoveContext::requestSubAssociation(T_ASC_Association **assoc)
+{
+    OFCondition cond = EC_Normal;
+    T_ASC_Parameters *params;
+    OFString temp_str;
+
+    cond = ASC_createAssociationParameters(&params, ASC_DEFAULTMAXPDU);
+    if (cond.bad()) {
+        DCMQRDB_ERROR("moveSCP: Cannot create Association-params for sub-ops: " << DimseCondition::dump(temp_str, cond));
     }
     if (cond.good()) {
-        OFStandard::snprintf(dstHostNamePlusPort, sizeof(DIC_NODENAME), "%s:%d", dstHostName, dstPortNumber);
         ASC_setPresentationAddresses(params, OFStandard::getHostName().c_str(),
-            dstHostNamePlusPort);
+            dstPresentationAddress);
         ASC_setAPTitles(params, ourAETitle.c_str(), dstAETitle,NULL);
 
         if (options_.outgoingProfile.empty()) {
@@ -335,7 +773,7 @@ OFCondition DcmQueryRetrieveMoveContext::buildSubAssociation(T_DIMSE_C_MoveRQ *r
     if (cond.good()) {
         /* create association */
         DCMQRDB_INFO("Requesting Sub-Association");
-        cond = ASC_requestAssociation(options_.net_, params, &subAssoc);
+        cond = ASC_requestAssociation(options_.net_, params, assoc);
         if (cond.bad()) {
             if (cond == DUL_ASSOCIATIONREJECTED) {
                 T_ASC_RejectParameters rej;
@@ -347,34 +785,51 @@ OFCondition DcmQueryRetrieveMoveContext::buildSubAssociation(T_DIMSE_C_MoveRQ *r
             }
         }
     }
-
-    if (cond.good()) {
-        assocStarted = OFTrue;
-    }
     return cond;
 }
 
-OFCondition DcmQueryRetrieveMoveContext::closeSubAssociation()
+OFCondition DcmQueryRetrieveMoveContext::releaseSubAssociation(T_ASC_Association **assoc)
 {
     OFCondition cond = EC_Normal;
 
-    if (subAssoc != NULL) {
+    if (*assoc != NULL) {
         /* release association */
         OFString temp_str;
         DCMQRDB_INFO("Releasing Sub-Association");
-        cond = ASC_releaseAssociation(subAssoc);
+        cond = ASC_releaseAssociation(*assoc);
         if (cond.bad()) {
             DCMQRDB_ERROR("moveSCP: Sub-Association Release Failed: " << DimseCondition::dump(temp_str, cond));
         }
-        cond = ASC_dropAssociation(subAssoc);
+        cond = ASC_dropAssociation(*assoc);
         if (cond.bad()) {
             DCMQRDB_ERROR("moveSCP: Sub-Association Drop Failed: " << DimseCondition::dump(temp_str, cond));
         }
-        cond = ASC_destroyAssociation(&subAssoc);
+        cond = ASC_destroyAssociation(assoc);
         if (cond.bad()) {
             DCMQRDB_ERROR("moveSCP: Sub-Association Destroy Failed: " << DimseCondition::dump(temp_str, cond));
         }
     }
+    return cond;
+}
+
+OFCondition DcmQueryRetrieveMoveContext::closeSubAssociation()
+{
+#ifdef WITH_THREADS
+    if (workerPool != NULL) {
+        /* sub-operations that have not been started yet are not performed
+         * anymore, wait for those that are currently in progress
+         */
+        nRemaining = OFstatic_cast(DIC_US, nRemaining + workerPool->cancelPending());
+        while (workerPool->outstanding() > 0) {
+            collectSubOpResult();
+        }
+        /* the additional sub-associations are released by the pool */
+        delete workerPool;
+        workerPool = NULL;
+    }
+#endif
+
+    OFCondition cond = releaseSubAssociation(&subAssoc);
 
     if (assocStarted) {
         assocStarted = OFFalse;
@@ -385,6 +840,13 @@ OFCondition DcmQueryRetrieveMoveContext::closeSubAssociation()
 
 void DcmQueryRetrieveMoveContext::moveNextImage(DcmQueryRetrieveDatabaseStatus * dbStatus)
 {
+#ifdef WITH_THREADS
+    if ((options_.maxMoveSubAssociations_ > 1) || (options_.moveReadAhead_ > 0)) {
+        moveNextImages(dbStatus);
+        return;
+    }
+#endif
+
     OFCondition cond = EC_Normal;
     OFCondition dbcond = EC_Normal;
     DIC_UI subImgSOPClass;      /* sub-operation image SOP Class */
@@ -415,6 +877,105 @@ void DcmQueryRetrieveMoveContext::moveNextImage(DcmQueryRetrieveDatabaseStatus *
     }
 }
 
+void DcmQueryRetrieveMoveContext::moveNextImages(DcmQueryRetrieveDatabaseStatus * dbStatus)
+{
+#ifdef WITH_THREADS
+    OFCondition dbcond = EC_Normal;
+    DIC_UI subImgSOPClass;      /* sub-operation image SOP Class */
+    DIC_UI subImgSOPInstance;   /* sub-operation image SOP Instance */
+    char subImgFileName[MAXPATHLEN + 1];    /* sub-operation image file */
+
+    /* fill the queue of the worker threads from the database */
+    while (!dbFinished && (dbStatus->status() == STATUS_Pending) &&
+        ((workerPool == NULL) || (workerPool->outstanding() < workerPool->capacity()))) {
+        /* clear out strings */
+        bzero(subImgFileName, sizeof(subImgFileName));
+        bzero(subImgSOPClass, sizeof(subImgSOPClass));
+        bzero(subImgSOPInstance, sizeof(subImgSOPInstance));
+
+        /* get DB response */
+        dbcond = dbHandle.nextMoveResponse(
+            subImgSOPClass, sizeof(subImgSOPClass), subImgSOPInstance, sizeof(subImgSOPInstance), subImgFileName, sizeof(subImgFileName), &nRemaining, dbStatus);
+        if (dbcond.bad()) {
+            DCMQRDB_ERROR("moveSCP: Database: nextMoveResponse Failed ("
+                    << DU_cmoveStatusString(dbStatus->status()) << "):");
+        }
+
+        if (dbStatus->status() == STATUS_Pending) {
+            /* the number of remaining matches is known now */
+            if (workerPool == NULL) startWorkerPool();
+            workerPool->enqueue(subImgSOPClass, subImgSOPInstance, subImgFileName);
+        } else if (dbStatus->status() == STATUS_Success) {
+            dbFinished = OFTrue;
+        }
+    }
+
+    /* a database failure terminates the move operation, the sub-operations
+     * in progress are completed in closeSubAssociation()
+     */
+    if (dbFinished || (dbStatus->status() == STATUS_Pending)) {
+        collectSubOpResult();
+        if (remainingSubOperations() > 0 || !dbFinished) {
+            dbStatus->setStatus(STATUS_Pending);
+        } else {
+            dbStatus->setStatus(STATUS_Success);
+        }
+    }
+#else
+    moveNextImage(dbStatus);
+#endif
+}
+
+void DcmQueryRetrieveMoveContext::startWorkerPool()
+{
+#ifdef WITH_THREADS
+    workerPool = new DcmQueryRetrieveMoveWorkerPool(*this, options_.moveReadAhead_);
+    workerPool->addWorker(subAssoc, OFFalse /* released by closeSubAssociation() */);
+
+    /* open additional sub-associations, but not more than needed */
+    size_t count = options_.maxMoveSubAssociations_;
+    if (count > OFstatic_cast(size_t, nRemaining) + 1) count = OFstatic_cast(size_t, nRemaining) + 1;
+    for (size_t i = 1; i < count; i++) {
+        T_ASC_Association *assoc = NULL;
+        if (requestSubAssociation(&assoc).bad()) {
+            /* continue with the sub-associations established so far */
+            DCMQRDB_WARN("moveSCP: using " << i << " parallel sub-associations only");
+            break;
+        }
+        if (!workerPool->addWorker(assoc, OFTrue)) {
+            releaseSubAssociation(&assoc);
+            break;
+        }
+    }
+    DCMQRDB_DEBUG("moveSCP: started worker pool for sub-operations (read ahead: " << options_.moveReadAhead_ << " files)");
+#endif
+}
+
+void DcmQueryRetrieveMoveContext::collectSubOpResult()
+{
+#ifdef WITH_THREADS
+    DcmQueryRetrieveMoveSubOp *subOp = (workerPool != NULL) ? workerPool->waitForResult() : NULL;
+    if (subOp != NULL) {
+        countSubOp(subOp->result, subOp->sopInstanceUID.c_str());
+        if (subOp->cond != EC_Normal) {
+            OFString temp_str;
+            DCMQRDB_ERROR("moveSCP: Move Sub-Op Failed: " << DimseCondition::dump(temp_str, subOp->cond));
+        }
+        delete subOp;
+    }
+#endif
+}
+
+DIC_US DcmQueryRetrieveMoveContext::remainingSubOperations() const
+{
+#ifdef WITH_THREADS
+    /* the sub-operations queued or in progress have already been fetched from the database */
+    if (workerPool != NULL)
+        return OFstatic_cast(DIC_US, nRemaining + workerPool->outstanding());
+#endif
+    return nRemaining;
+}
+
 void DcmQueryRetrieveMoveContext::failAllSubOperations(DcmQueryRetrieveDatabaseStatus * dbStatus)
 {
     OFCondition dbcond = EC_Normal;
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2018, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -49,6 +49,10 @@ END_EXTERN_C
 #include "dcmtk/dcmdata/dcfilefo.h"
 #include "dcmtk/dcmdata/dcmatch.h"
 
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
+
 /* ========================= static data ========================= */
 
 /**** The TbFindAttr table contains the description of tags (keys) supported
@@ -417,30 +421,234 @@ static long DB_lseek(int fildes, long offset, int whence)
 }
 
 /******************************
- *      Read an Index record
+ *      Instance records in the index file
+ *
+ * The instance records follow the study descriptors. Each record starts
+ * with a header of DB_IDXHEADERSIZE bytes containing the capacity of the
+ * record slot and the length of the record data, both stored as Uint32 in
+ * local byte order. A length of zero marks an unused slot that can be
+ * reused for any record fitting into its capacity. The record data consists
+ * of RecordedDate, ImageSize and hstat, followed by the string values of
+ * filename, SOPClassUID, all param[] fields (in order of the RECORDIDX_xxx
+ * constants) and InstanceDescription. Each string is stored as a Uint16
+ * length followed by the characters without a terminating NUL byte.
+ * Slots are never moved or resized, so the record number of an instance
+ * remains valid as long as the instance is registered.
  */
 
-OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord *idxRec)
-{
+#define DB_IDXHEADERSIZE   (2 * sizeof(Uint32))
+#define DB_IDXSTATUSOFFSET (sizeof(double) + sizeof(Uint32))
+#define DB_IDXFIXEDSIZE    (DB_IDXSTATUSOFFSET + 1)
 
-    /*** Goto the right index in file
-    **/
+/* the record data is always shorter than an IdxRecord since the strings
+ * are stored without padding
+ */
+#define DB_IDXMAXDATASIZE  SIZEOF_IDXRECORD
 
-    DB_lseek (handle_ -> pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC + idx * SIZEOF_IDXRECORD), SEEK_SET) ;
+/* buffer size sufficient for header and data of any instance record */
+#define DB_IDXBUFFERSIZE   (DB_IDXHEADERSIZE + DB_IDXMAXDATASIZE)
 
-    /*** Read the record
-    **/
+static OFBool DB_IdxPutString(char *buffer, size_t& pos, const char *value, size_t maxLength)
+{
+    size_t length = 0;
+    while ((length < maxLength) && (value[length] != '\0'))
+        length++;
+    const Uint16 length16 = OFstatic_cast(Uint16, length);
+    if ((length > 0xffff) || (pos + sizeof(length16) + length > DB_IDXMAXDATASIZE))
+        return OFFalse;
+    memcpy(buffer + pos, &length16, sizeof(length16));
+    memcpy(buffer + pos + sizeof(length16), value, length);
+    pos += sizeof(length16) + length;
+    return OFTrue;
+}
 
-    if (read (handle_ -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) != SIZEOF_IDXRECORD)
-        return (QR_EC_IndexDatabaseError) ;
+static OFBool DB_IdxGetString(const char *buffer, size_t& pos, size_t dataLength, char *value, size_t size)
+{
+    Uint16 length16;
+    if (pos + sizeof(length16) > dataLength)
+        return OFFalse;
+    memcpy(&length16, buffer + pos, sizeof(length16));
+    pos += sizeof(length16);
+    if (pos + length16 > dataLength)
+        return OFFalse;
+    /* silently truncate values that do not fit into the record */
+    const size_t length = (length16 < size) ? length16 : size - 1;
+    memcpy(value, buffer + pos, length);
+    value[length] = '\0';
+    pos += length16;
+    return OFTrue;
+}
 
-    DB_lseek (handle_ -> pidx, OFstatic_cast(long, DBHEADERSIZE), SEEK_SET) ;
+/******************************
+ *      Convert an IdxRecord into the record data stored in the index file.
+ *      Returns the length of the record data, 0 in case of error.
+ */
 
-    /*** Initialize record links
-    **/
+static Uint32 DB_IdxPackRecord (const IdxRecord *idxRec, char *buffer)
+{
+    size_t pos = DB_IDXFIXEDSIZE;
+    memcpy(buffer, &idxRec -> RecordedDate, sizeof(double));
+    memcpy(buffer + sizeof(double), &idxRec -> ImageSize, sizeof(Uint32));
+    buffer[DB_IDXSTATUSOFFSET] = idxRec -> hstat;
+
+    OFBool ok = DB_IdxPutString(buffer, pos, idxRec -> filename, DBC_MAXSTRING) &&
+                DB_IdxPutString(buffer, pos, idxRec -> SOPClassUID, UI_MAX_LENGTH);
+    for (int i = 0; ok && (i < NBPARAMETERS); i++)
+        ok = DB_IdxPutString(buffer, pos, idxRec -> param[i]. PValueField, idxRec -> param[i]. ValueLength);
+    ok = ok && DB_IdxPutString(buffer, pos, idxRec -> InstanceDescription, DESCRIPTION_MAX_LENGTH);
+
+    return ok ? OFstatic_cast(Uint32, pos) : 0;
+}
 
+/******************************
+ *      Convert record data read from the index file into an IdxRecord
+ */
+
+static OFCondition DB_IdxUnpackRecord (const char *buffer, size_t length, IdxRecord *idxRec)
+{
+    DB_IdxInitRecord (idxRec, 0) ;
     DB_IdxInitRecord (idxRec, 1) ;
-    return EC_Normal ;
+
+    if (length < DB_IDXFIXEDSIZE)
+        return QR_EC_IndexDatabaseError;
+    memcpy(&idxRec -> RecordedDate, buffer, sizeof(double));
+    memcpy(&idxRec -> ImageSize, buffer + sizeof(double), sizeof(Uint32));
+    idxRec -> hstat = buffer[DB_IDXSTATUSOFFSET];
+
+    size_t pos = DB_IDXFIXEDSIZE;
+    OFBool ok = DB_IdxGetString(buffer, pos, length, idxRec -> filename, sizeof(idxRec -> filename)) &&
+                DB_IdxGetString(buffer, pos, length, idxRec -> SOPClassUID, sizeof(idxRec -> SOPClassUID));
+    for (int i = 0; ok && (i < NBPARAMETERS); i++)
+    {
+        /* DB_IdxInitRecord() has set ValueLength to the maximum length of the value */
+        DB_SmallDcmElmt *se = idxRec -> param + i;
+        ok = DB_IdxGetString(buffer, pos, length, se -> PValueField, se -> ValueLength + 1);
+        se -> ValueLength = OFstatic_cast(Uint32, strlen(se -> PValueField));
+    }
+    ok = ok && DB_IdxGetString(buffer, pos, length, idxRec -> InstanceDescription, sizeof(idxRec -> InstanceDescription));
+
+    return ok ? EC_Normal : QR_EC_IndexDatabaseError;
+}
+
+/******************************
+ *      Read the header and optionally the data of an instance record.
+ *      The header is stored at the beginning of the buffer, followed by the
+ *      record data. 'found' is set to OFFalse if the index file contains
+ *      less than idx+1 records.
+ */
+
+static OFCondition DB_IdxReadSlot (DB_Private_Handle *phandle, size_t idx, char *buffer, Uint32& length, OFBool readData, OFBool& found)
+{
+    OFVector<long>& offsets = phandle -> recordOffsets ;
+    if (offsets.empty())
+        offsets.push_back(OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC));
+
+    found = OFTrue;
+    while (found && (offsets.size() <= idx))
+    {
+        /* position of the requested record is not yet known, walk through the preceding records */
+        OFCondition cond = DB_IdxReadSlot (phandle, offsets.size() - 1, buffer, length, OFFalse, found) ;
+        if (cond.bad())
+            return cond;
+    }
+    if (!found)
+        return EC_Normal;
+
+    /* slot size is known for all but the last record visited so far */
+    const OFBool sizeKnown = (idx + 1 < offsets.size());
+    size_t count = DB_IDXHEADERSIZE;
+    if (readData && sizeKnown)
+        count = OFstatic_cast(size_t, offsets[idx + 1] - offsets[idx]);
+
+    /* use plain lseek() rather than DB_lseek() since this is called for every record of a scan */
+    if (lseek (phandle -> pidx, offsets[idx], SEEK_SET) < 0)
+        return QR_EC_IndexDatabaseError;
+    const long bytesRead = OFstatic_cast(long, read (phandle -> pidx, buffer, OFstatic_cast(unsigned int, count))) ;
+    if (bytesRead == 0)
+    {
+        /* end of file */
+        found = OFFalse;
+        return EC_Normal;
+    }
+
+    Uint32 capacity = 0;
+    if (bytesRead == OFstatic_cast(long, count))
+    {
+        memcpy(&capacity, buffer, sizeof(Uint32));
+        memcpy(&length, buffer + sizeof(Uint32), sizeof(Uint32));
+    }
+    if ((bytesRead != OFstatic_cast(long, count)) || (capacity > DB_IDXMAXDATASIZE) || (length > capacity) ||
+        (sizeKnown && (offsets[idx] + OFstatic_cast(long, DB_IDXHEADERSIZE + capacity) != offsets[idx + 1])))
+    {
+        DCMQRDB_ERROR("DB: invalid instance record " << idx << " in index file " << phandle -> indexFilename);
+        return QR_EC_IndexDatabaseError;
+    }
+
+    if (!sizeKnown)
+    {
+        offsets.push_back(offsets[idx] + OFstatic_cast(long, DB_IDXHEADERSIZE + capacity));
+        if (readData && (length > 0) &&
+            (read (phandle -> pidx, buffer + DB_IDXHEADERSIZE, length) != OFstatic_cast(long, length)))
+        {
+            DCMQRDB_ERROR("DB: truncated instance record " << idx << " in index file " << phandle -> indexFilename);
+            return QR_EC_IndexDatabaseError;
+        }
+    }
+    return EC_Normal;
+}
+
+/******************************
+ *      Write header and data of an instance record to the given slot.
+ *      The data is expected at offset DB_IDXHEADERSIZE of the buffer.
+ */
+
+static OFCondition DB_IdxWriteSlot (DB_Private_Handle *phandle, size_t idx, char *buffer, Uint32 capacity, Uint32 length)
+{
+    memcpy(buffer, &capacity, sizeof(Uint32));
+    memcpy(buffer + sizeof(Uint32), &length, sizeof(Uint32));
+
+    const size_t count = DB_IDXHEADERSIZE + length;
+    if ((DB_lseek (phandle -> pidx, phandle -> recordOffsets[idx], SEEK_SET) < 0) ||
+        (write (phandle -> pidx, buffer, OFstatic_cast(unsigned int, count)) != OFstatic_cast(long, count)))
+        return QR_EC_IndexDatabaseError;
+    return EC_Normal;
+}
+
+/******************************
+ *      Read an Index record
+ */
+
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord *idxRec)
+{
+    char buffer[DB_IDXBUFFERSIZE];
+    Uint32 length = 0;
+    OFBool found = OFFalse;
+
+    if (idx < 0)
+        return QR_EC_IndexDatabaseError;
+
+    OFCondition cond = DB_IdxReadSlot (handle_, OFstatic_cast(size_t, idx), buffer, length, OFTrue, found) ;
+    if (cond.bad())
+        return cond;
+    if (!found)
+        return QR_EC_IndexDatabaseError;
+
+    if (length == 0)
+    {
+        /*** Unused slot, return an empty record
+        **/
+        DB_IdxInitRecord (idxRec, 0) ;
+        DB_IdxInitRecord (idxRec, 1) ;
+        idxRec -> filename[0] = '\0' ;
+        idxRec -> SOPClassUID[0] = '\0' ;
+        idxRec -> InstanceDescription[0] = '\0' ;
+        idxRec -> RecordedDate = 0.0 ;
+        idxRec -> ImageSize = 0 ;
+        idxRec -> hstat = DVIF_objectIsNotNew ;
+        return EC_Normal ;
+    }
+
+    return DB_IdxUnpackRecord (buffer + DB_IDXHEADERSIZE, length, idxRec) ;
 }
 
 
@@ -451,31 +659,46 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRead (int idx, IdxRecord
 
 static OFCondition DB_IdxAdd (DB_Private_Handle *phandle, int *idx, IdxRecord *idxRec)
 {
-    IdxRecord   rec ;
+    char        buffer[DB_IDXBUFFERSIZE] ;
+    char        header[DB_IDXHEADERSIZE] ;
+    Uint32      slotLength = 0 ;
+    OFBool      found = OFTrue ;
     OFCondition cond = EC_Normal;
 
+    const Uint32 length = DB_IdxPackRecord (idxRec, buffer + DB_IDXHEADERSIZE) ;
+    if (length == 0)
+        return QR_EC_IndexDatabaseError ;
+
     /*** Find free place for the record
-    *** A place is free if filename is empty
+    *** A place is free if it is unused and large enough
     **/
 
-    *idx = 0 ;
-
-    DB_lseek (phandle -> pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC), SEEK_SET) ;
-    while (read (phandle -> pidx, (char *) &rec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD) {
-        if (rec. filename [0] == '\0')
+    size_t i = 0 ;
+    while (found)
+    {
+        cond = DB_IdxReadSlot (phandle, i, header, slotLength, OFFalse, found) ;
+        if (cond.bad())
+            return cond ;
+        if (found && (slotLength == 0) &&
+            (phandle -> recordOffsets[i + 1] - phandle -> recordOffsets[i] >= OFstatic_cast(long, DB_IDXHEADERSIZE + length)))
             break ;
-        (*idx)++ ;
+        i++ ;
     }
 
     /*** We have either found a free place or we are at the end of file. **/
 
-
-    DB_lseek (phandle -> pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC + (*idx) * SIZEOF_IDXRECORD), SEEK_SET) ;
-
-    if (write (phandle -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) != SIZEOF_IDXRECORD)
-        cond = QR_EC_IndexDatabaseError ;
+    Uint32 capacity = length ;
+    if (found)
+        capacity = OFstatic_cast(Uint32, phandle -> recordOffsets[i + 1] - phandle -> recordOffsets[i] - DB_IDXHEADERSIZE) ;
     else
-        cond = EC_Normal ;
+    {
+        /* append new slot, the offset of the end of file is the last one known */
+        i = phandle -> recordOffsets.size() - 1 ;
+        phandle -> recordOffsets.push_back(phandle -> recordOffsets[i] + OFstatic_cast(long, DB_IDXHEADERSIZE + length)) ;
+    }
+
+    *idx = OFstatic_cast(int, i) ;
+    cond = DB_IdxWriteSlot (phandle, i, buffer, capacity, length) ;
 
     DB_lseek (phandle -> pidx, OFstatic_cast(long, DBHEADERSIZE), SEEK_SET) ;
 
@@ -515,15 +738,14 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxInitLoop(int *idx)
 
 OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxGetNext(int *idx, IdxRecord *idxRec)
 {
+    char buffer[DB_IDXBUFFERSIZE];
+    Uint32 length = 0;
+    OFBool found = OFFalse;
 
     (*idx)++ ;
-    DB_lseek (handle_ -> pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC + OFstatic_cast(long, *idx) * SIZEOF_IDXRECORD), SEEK_SET) ;
-    while (read (handle_ -> pidx, (char *) idxRec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD) {
-        if (idxRec -> filename [0] != '\0') {
-            DB_IdxInitRecord (idxRec, 1) ;
-
-            return EC_Normal ;
-        }
+    while (DB_IdxReadSlot (handle_, OFstatic_cast(size_t, *idx), buffer, length, OFTrue, found).good() && found) {
+        if (length > 0)
+            return DB_IdxUnpackRecord (buffer + DB_IDXHEADERSIZE, length, idxRec) ;
         (*idx)++ ;
     }
 
@@ -553,22 +775,28 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_GetStudyDesc (StudyDescRecor
 
 /******************************
  *      Remove an Index record
- *      Just put a record with filename == ""
+ *      Just mark the slot as unused (record length 0)
  */
 
 OFCondition DcmQueryRetrieveIndexDatabaseHandle::DB_IdxRemove(int idx)
 {
-    IdxRecord   rec ;
-    OFCondition cond = EC_Normal;
+    char        header[DB_IDXHEADERSIZE] ;
+    Uint32      length = 0 ;
+    OFBool      found = OFFalse ;
 
-    DB_lseek (handle_ -> pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC + OFstatic_cast(long, idx) * SIZEOF_IDXRECORD), SEEK_SET) ;
-    DB_IdxInitRecord (&rec, 0) ;
+    if (idx < 0)
+        return QR_EC_IndexDatabaseError ;
 
-    rec. filename [0] = '\0' ;
-    if (write (handle_ -> pidx, (char *) &rec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD)
-        cond = EC_Normal ;
-    else
+    OFCondition cond = DB_IdxReadSlot (handle_, OFstatic_cast(size_t, idx), header, length, OFFalse, found) ;
+    if (cond.good() && !found)
         cond = QR_EC_IndexDatabaseError ;
+    if (cond.good() && (length > 0))
+    {
+        length = 0 ;
+        if ((DB_lseek (handle_ -> pidx, handle_ -> recordOffsets[idx] + OFstatic_cast(long, sizeof(Uint32)), SEEK_SET) < 0) ||
+            (write (handle_ -> pidx, (char *) &length, sizeof(length)) != sizeof(length)))
+            cond = QR_EC_IndexDatabaseError ;
+    }
 
     DB_lseek (handle_ -> pidx, OFstatic_cast(long, DBHEADERSIZE), SEEK_SET) ;
 
@@ -2331,15 +2559,8 @@ void DcmQueryRetrieveIndexDatabaseHandle::enableQuotaSystem(OFBool enable)
 */
 
 
-OFCondition DcmQueryRetrieveIndexDatabaseHandle::deleteImageFile(char* imgFile)
+static OFCondition DB_DeleteFile(const char *imgFile)
 {
-    if (!quotaSystemEnabled) {
-      DCMQRDB_WARN("file delete operations are disabled, keeping file: " << imgFile << " despite duplicate SOP Instance UID");
-      return EC_Normal;
-    } else {
-      DCMQRDB_WARN("Deleting file: " << imgFile << " due to quota or duplicate SOP instance UID");
-    }
-
 #ifdef LOCK_IMAGE_FILES
     int lockfd;
 #ifdef O_BINARY
@@ -2375,6 +2596,275 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::deleteImageFile(char* imgFile)
 }
 
 
+#ifdef WITH_THREADS
+
+/** a thread that deletes the image files queued by a database handle
+ */
+class DcmQueryRetrieveIndexDatabasePurger : public OFThread
+{
+public:
+    /// constructor
+    DcmQueryRetrieveIndexDatabasePurger()
+    : OFThread()
+    , files_()
+    , mutex_()
+    , queued_(0)
+    , stopping_(OFFalse)
+    {
+    }
+
+    /** queues a file for deletion
+     *  @param imgFile name of the file to be deleted
+     */
+    void purge(const char *imgFile)
+    {
+        mutex_.lock();
+        files_.push_back(imgFile);
+        mutex_.unlock();
+        queued_.post();
+    }
+
+    /** deletes all files still queued and terminates the thread
+     */
+    void stop()
+    {
+        mutex_.lock();
+        stopping_ = OFTrue;
+        mutex_.unlock();
+        queued_.post();
+        join();
+    }
+
+protected:
+    /// deletes queued files until stop() is called
+    virtual void run()
+    {
+        for (;;)
+        {
+            queued_.wait();
+            mutex_.lock();
+            if (files_.empty())
+            {
+                /* the semaphore is posted once per file and once by stop() */
+                const OFBool done = stopping_;
+                mutex_.unlock();
+                if (done) break;
+                continue;
+            }
+            const OFString imgFile = files_.front();
+            files_.pop_front();
+            mutex_.unlock();
+            DB_DeleteFile(imgFile.c_str());
+        }
+    }
+
+private:
+    /// private undefined copy constructor
+    DcmQueryRetrieveIndexDatabasePurger(const DcmQueryRetrieveIndexDatabasePurger& other);
+
+    /// private undefined assignment operator
+    DcmQueryRetrieveIndexDatabasePurger& operator=(const DcmQueryRetrieveIndexDatabasePurger& other);
+
+    /// files to be deleted
+    OFList<OFString> files_;
+
+    /// mutex protecting files_ and stopping_
+    OFMutex mutex_;
+
+    /// semaphore counting the files queued
+    OFSemaphore queued_;
+
+    /// true if the thread should terminate when all files are deleted
+    OFBool stopping_;
+};
+
+#endif
+
+
+void DcmQueryRetrieveIndexDatabaseHandle::enableBackgroundPurge(OFBool enable)
+{
+#ifdef WITH_THREADS
+    if (enable && (purger_ == NULL))
+    {
+        purger_ = new DcmQueryRetrieveIndexDatabasePurger();
+        if (purger_->start() != 0)
+        {
+            DCMQRDB_WARN("cannot start thread for deleting files in the background");
+            delete purger_;
+            purger_ = NULL;
+        }
+    }
+    else if (!enable && (purger_ != NULL))
+    {
+        purger_->stop();
+        delete purger_;
+        purger_ = NULL;
+    }
+#else
+    if (enable)
+        DCMQRDB_WARN("deleting files in the background requires thread support");
+#endif
+}
+
+
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::deleteImageFile(char* imgFile)
+{
+    if (!quotaSystemEnabled) {
+      DCMQRDB_WARN("file delete operations are disabled, keeping file: " << imgFile << " despite duplicate SOP Instance UID");
+      return EC_Normal;
+    } else {
+      DCMQRDB_WARN("Deleting file: " << imgFile << " due to quota or duplicate SOP instance UID");
+    }
+
+#ifdef WITH_THREADS
+    if (purger_)
+    {
+        purger_->purge(imgFile);
+        return EC_Normal;
+    }
+#endif
+
+    return DB_DeleteFile(imgFile);
+}
+
+
+/*************************
+**   Eviction index
+**
+**   The quota mechanism deletes the oldest images of a study or all images
+**   of the oldest study. In order to avoid a scan of the complete index file
+**   for each image to be deleted, the handle keeps a list of the images of
+**   each study ordered by RecordedDate. The list is built on first use and
+**   then updated by this handle. Since other processes may modify the index
+**   file in the meantime, the number of images of a study is compared with
+**   the study descriptor and each record is checked before it is deleted.
+**   The index is rebuilt if a difference is detected.
+ */
+
+static OFCondition DB_EvictionIndexBuild (DB_Private_Handle *phandle)
+{
+    char buffer[DB_IDXBUFFERSIZE] ;
+    Uint32 length = 0 ;
+    OFBool found = OFTrue ;
+    IdxRecord idxRec ;
+    OFCondition cond = EC_Normal ;
+    OFMap<OFString, OFVector<ImagesofStudyArray> > studies ;
+
+#ifdef DEBUG
+    DCMQRDB_DEBUG("DB_EvictionIndexBuild");
+#endif
+    phandle -> evictionIndex.clear() ;
+    phandle -> evictionIndexValid = OFFalse ;
+
+    for (size_t idx = 0 ; cond.good() ; idx++ )
+    {
+        cond = DB_IdxReadSlot (phandle, idx, buffer, length, OFTrue, found) ;
+        if (cond.bad() || !found)
+            break ;
+        if (length == 0)
+            continue ;
+        cond = DB_IdxUnpackRecord (buffer + DB_IDXHEADERSIZE, length, &idxRec) ;
+        if (cond.good())
+        {
+            ImagesofStudyArray image ;
+            image. idxCounter = OFstatic_cast(Uint32, idx) ;
+            image. RecordedDate = idxRec. RecordedDate ;
+            image. ImageSize = idxRec. ImageSize ;
+            studies[idxRec. StudyInstanceUID]. push_back(image) ;
+        }
+    }
+    DB_lseek (phandle -> pidx, OFstatic_cast(long, DBHEADERSIZE), SEEK_SET) ;
+    if (cond.bad())
+        return cond ;
+
+    /* records are mostly, but not necessarily, in chronological order since unused slots are reused */
+    for (OFMap<OFString, OFVector<ImagesofStudyArray> >::iterator it = studies.begin() ; it != studies.end() ; ++it)
+    {
+        OFVector<ImagesofStudyArray>& images = it -> second ;
+        qsort(&images[0], images.size(), sizeof(ImagesofStudyArray), DB_Compare) ;
+        OFList<ImagesofStudyArray>& list = phandle -> evictionIndex[it -> first] ;
+        for (size_t i = 0 ; i < images.size() ; i++)
+            list.push_back(images[i]) ;
+    }
+    phandle -> evictionIndexValid = OFTrue ;
+    return EC_Normal ;
+}
+
+/*
+ *  Returns the images of the given study, oldest first. The eviction index is
+ *  (re)built if it does not match the number of images in the study descriptor.
+ */
+static OFList<ImagesofStudyArray> *DB_EvictionIndexGetStudy (DB_Private_Handle *phandle, const StudyDescRecord& studyDesc)
+{
+    if (phandle -> evictionIndexValid)
+    {
+        OFMap<OFString, OFList<ImagesofStudyArray> >::iterator it = phandle -> evictionIndex.find(studyDesc. StudyInstanceUID) ;
+        const size_t count = (it == phandle -> evictionIndex.end()) ? 0 : it -> second.size() ;
+        if (count == studyDesc. NumberofRegistratedImages)
+            return (it == phandle -> evictionIndex.end()) ? &phandle -> evictionIndex[studyDesc. StudyInstanceUID] : &it -> second ;
+        DCMQRDB_DEBUG("DB: eviction index is out of date for study " << studyDesc. StudyInstanceUID);
+    }
+    if (DB_EvictionIndexBuild (phandle).bad())
+        return NULL ;
+    return &phandle -> evictionIndex[studyDesc. StudyInstanceUID] ;
+}
+
+/*
+ *  Returns true if the record read from the index file is the one referenced
+ *  by the eviction index, i.e. if it has not been replaced by another process
+ */
+static OFBool DB_EvictionIndexMatches (const IdxRecord& idxRec, const char *StudyUID, const ImagesofStudyArray& image)
+{
+    return ( idxRec. filename[0] != '\0' ) &&
+           ( strcmp(idxRec. StudyInstanceUID, StudyUID) == 0 ) &&
+           ( idxRec. RecordedDate == image. RecordedDate ) ;
+}
+
+static void DB_EvictionIndexAdd (DB_Private_Handle *phandle, const char *StudyUID, int idx, double RecordedDate, Uint32 ImageSize)
+{
+    if (! phandle -> evictionIndexValid)
+        return ;
+
+    ImagesofStudyArray image ;
+    image. idxCounter = OFstatic_cast(Uint32, idx) ;
+    image. RecordedDate = RecordedDate ;
+    image. ImageSize = ImageSize ;
+
+    /* new images are usually the most recent ones, so search from the end */
+    OFList<ImagesofStudyArray>& images = phandle -> evictionIndex[StudyUID] ;
+    OFListIterator(ImagesofStudyArray) it = images.end() ;
+    while (it != images.begin())
+    {
+        OFListIterator(ImagesofStudyArray) prev = it ;
+        if ((--prev) -> RecordedDate <= RecordedDate)
+            break ;
+        it = prev ;
+    }
+    images.insert(it, image) ;
+}
+
+static void DB_EvictionIndexRemove (DB_Private_Handle *phandle, const char *StudyUID, int idx)
+{
+    if (! phandle -> evictionIndexValid)
+        return ;
+
+    OFMap<OFString, OFList<ImagesofStudyArray> >::iterator study = phandle -> evictionIndex.find(StudyUID) ;
+    if (study == phandle -> evictionIndex.end())
+        return ;
+    OFList<ImagesofStudyArray>& images = study -> second ;
+    for (OFListIterator(ImagesofStudyArray) it = images.begin() ; it != images.end() ; ++it)
+    {
+        if (it -> idxCounter == OFstatic_cast(Uint32, idx))
+        {
+            images.erase(it) ;
+            break ;
+        }
+    }
+    if (images.empty())
+        phandle -> evictionIndex.erase(study) ;
+}
+
+
 /*************************
 **   Delete oldest study in database
  */
@@ -2385,9 +2875,8 @@ int DcmQueryRetrieveIndexDatabaseHandle::deleteOldestStudy(StudyDescRecord *pStu
     int oldestStudy ;
     double OldestDate ;
     int s ;
-    size_t n ;
-    int idx = 0 ;
     IdxRecord idxRec ;
+    OFBool rebuilt = OFFalse ;
 
     oldestStudy = 0 ;
     OldestDate = 0.0 ;
@@ -2408,15 +2897,28 @@ int DcmQueryRetrieveIndexDatabaseHandle::deleteOldestStudy(StudyDescRecord *pStu
     DCMQRDB_DEBUG("deleteOldestStudy oldestStudy = " << oldestStudy);
 #endif
 
-    n = strlen(pStudyDesc[oldestStudy].StudyInstanceUID) ;
-    while ( DB_IdxRead (idx, &idxRec) == EC_Normal ) {
-
-    if ( ! ( strncmp(idxRec. StudyInstanceUID, pStudyDesc[oldestStudy].StudyInstanceUID, n) ) ) {
-        DB_IdxRemove (idx) ;
-        deleteImageFile(idxRec.filename);
+    const OFString StudyUID = pStudyDesc[oldestStudy]. StudyInstanceUID ;
+    OFList<ImagesofStudyArray> *images = DB_EvictionIndexGetStudy (handle_, pStudyDesc[oldestStudy]) ;
+    while ( images && ! images -> empty() ) {
+
+    const ImagesofStudyArray image = images -> front() ;
+    if ( ( DB_IdxRead (OFstatic_cast(int, image. idxCounter), &idxRec) != EC_Normal ) ||
+         ! DB_EvictionIndexMatches (idxRec, StudyUID.c_str(), image) ) {
+        /* index file has been modified by another process */
+        if ( ! rebuilt && DB_EvictionIndexBuild (handle_).good() ) {
+            images = &handle_ -> evictionIndex[StudyUID] ;
+            rebuilt = OFTrue ;
+        }
+        else
+            images -> pop_front() ;
+        continue ;
     }
-    idx++ ;
+
+    images -> pop_front() ;
+    DB_IdxRemove (OFstatic_cast(int, image. idxCounter)) ;
+    deleteImageFile(idxRec.filename);
     }
+    handle_ -> evictionIndex.erase(StudyUID) ;
 
     pStudyDesc[oldestStudy].NumberofRegistratedImages = 0 ;
     pStudyDesc[oldestStudy].StudySize = 0 ;
@@ -2433,74 +2935,55 @@ int DcmQueryRetrieveIndexDatabaseHandle::deleteOldestStudy(StudyDescRecord *pStu
 OFCondition DcmQueryRetrieveIndexDatabaseHandle::deleteOldestImages(StudyDescRecord *pStudyDesc, int StudyNum, char *StudyUID, long RequiredSize)
 {
 
-    ImagesofStudyArray *StudyArray ;
-    IdxRecord idxRec ;
-    int nbimages = 0 , s = 0;
-    size_t n ;
+    IdxRecord idxRemoveRec ;
     long DeletedSize ;
+    OFBool rebuilt = OFFalse ;
 
 #ifdef DEBUG
     DCMQRDB_DEBUG("deleteOldestImages RequiredSize = " << RequiredSize);
 #endif
-    n = strlen(StudyUID) ;
-    StudyArray = (ImagesofStudyArray *)malloc(MAX_NUMBER_OF_IMAGES * sizeof(ImagesofStudyArray)) ;
 
-    if (StudyArray == NULL) {
-        DCMQRDB_WARN("deleteOldestImages: out of memory");
-        return QR_EC_IndexDatabaseError;
-    }
-
-    /** Find all images having the same StudyUID
+    /** Get all images having the same StudyUID, oldest images first
      */
 
-    DB_IdxInitLoop (&(handle_ -> idxCounter)) ;
-    while ( DB_IdxGetNext(&(handle_ -> idxCounter), &idxRec) == EC_Normal ) {
-    if ( ! ( strncmp(idxRec. StudyInstanceUID, StudyUID, n) ) ) {
-
-        StudyArray[nbimages]. idxCounter = handle_ -> idxCounter ;
-        StudyArray[nbimages]. RecordedDate = idxRec. RecordedDate ;
-        StudyArray[nbimages++]. ImageSize = idxRec. ImageSize ;
-    }
-    }
-
-    /** Sort the StudyArray in order to have the oldest images first
-     */
-    qsort((char *)StudyArray, nbimages, sizeof(ImagesofStudyArray), DB_Compare) ;
-
-#ifdef DEBUG
-    {
-        int i ;
-        DCMQRDB_DEBUG("deleteOldestImages : Sorted images ref array");
-        for (i = 0 ; i < nbimages ; i++)
-            DCMQRDB_DEBUG("[" << STD_NAMESPACE setw(2) << i << "] :   Size " << StudyArray[i].ImageSize
-                << "   Date " << STD_NAMESPACE setw(20) << STD_NAMESPACE setprecision(3) << StudyArray[i].RecordedDate
-                << "   Ref " << StudyArray[i].idxCounter);
-        DCMQRDB_DEBUG("deleteOldestImages : end of ref array");
+    OFList<ImagesofStudyArray> *images = DB_EvictionIndexGetStudy (handle_, pStudyDesc[StudyNum]) ;
+    if (images == NULL) {
+        DCMQRDB_WARN("deleteOldestImages: cannot read index file");
+        return QR_EC_IndexDatabaseError;
     }
-#endif
 
-    s = 0 ;
     DeletedSize = 0 ;
 
-    while ( DeletedSize < RequiredSize ) {
+    while ( ( DeletedSize < RequiredSize ) && ! images -> empty() ) {
+
+    const ImagesofStudyArray image = images -> front() ;
+    if ( ( DB_IdxRead (OFstatic_cast(int, image. idxCounter), &idxRemoveRec) != EC_Normal ) ||
+         ! DB_EvictionIndexMatches (idxRemoveRec, StudyUID, image) ) {
+        /* index file has been modified by another process */
+        if ( ! rebuilt && DB_EvictionIndexBuild (handle_).good() ) {
+            images = &handle_ -> evictionIndex[StudyUID] ;
+            rebuilt = OFTrue ;
+        }
+        else
+            images -> pop_front() ;
+        continue ;
+    }
 
-    IdxRecord idxRemoveRec ;
-    DB_IdxRead (StudyArray[s]. idxCounter, &idxRemoveRec) ;
 #ifdef DEBUG
     DCMQRDB_DEBUG("Removing file : " << idxRemoveRec. filename);
 #endif
+    images -> pop_front() ;
     deleteImageFile(idxRemoveRec.filename);
 
-    DB_IdxRemove (StudyArray[s]. idxCounter) ;
+    DB_IdxRemove (OFstatic_cast(int, image. idxCounter)) ;
     pStudyDesc[StudyNum].NumberofRegistratedImages -= 1 ;
-    pStudyDesc[StudyNum].StudySize -= StudyArray[s]. ImageSize ;
-    DeletedSize += StudyArray[s++]. ImageSize ;
+    pStudyDesc[StudyNum].StudySize -= idxRemoveRec. ImageSize ;
+    DeletedSize += idxRemoveRec. ImageSize ;
     }
 
 #ifdef DEBUG
     DCMQRDB_DEBUG("deleteOldestImages DeletedSize = " << (int)DeletedSize);
 #endif
-    free(StudyArray) ;
     return( EC_Normal ) ;
 
 }
@@ -2634,6 +3117,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::removeDuplicateImage(
 #endif
         /* remove the idx record  */
         DB_IdxRemove (idx);
+        DB_EvictionIndexRemove (handle_, idxRec.StudyInstanceUID, idx);
         /* only remove the image file if it is different than that
          * being entered into the database.
          */
@@ -2865,6 +3349,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::storeRequest (
 
     if (DB_IdxAdd (handle_, &i, &idxRec) == EC_Normal)
     {
+        DB_EvictionIndexAdd (handle_, idxRec.StudyInstanceUID, i, idxRec.RecordedDate, idxRec.ImageSize);
         status->setStatus(STATUS_Success);
         DB_unlock();
         return (EC_Normal) ;
@@ -2928,6 +3413,7 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::pruneInvalidRecords()
 
         /* remove the idx record  */
         DB_IdxRemove (idx);
+        DB_EvictionIndexRemove (handle_, idxRec.StudyInstanceUID, idx);
       }
       idx++;
     }
@@ -3008,6 +3494,142 @@ void DcmQueryRetrieveIndexDatabaseHandle::printIndexFile (char *storeArea)
 
 }
 
+/************************
+ *      Convert an index file with fixed-size instance records (version 5)
+ *      to the current format
+ */
+
+OFCondition DcmQueryRetrieveIndexDatabaseHandle::upgradeIndexFile(const char *storeArea)
+{
+    char indexFilename[DBC_MAXSTRING+1];
+    sprintf(indexFilename, "%s%c%s", storeArea, PATH_SEPARATOR, DBINDEXFILE);
+
+#ifdef O_BINARY
+    int fd = open(indexFilename, O_RDWR | O_BINARY);
+#else
+    int fd = open(indexFilename, O_RDWR);
+#endif
+    if (fd == -1)
+    {
+        DCMQRDB_ERROR(indexFilename << ": " << OFStandard::getLastSystemErrorCode().message());
+        return QR_EC_IndexDatabaseError;
+    }
+
+    /* keep other processes from accessing the index file during the conversion */
+    if (dcmtk_flock(fd, LOCK_EX) < 0)
+    {
+        dcmtk_plockerr("upgradeIndexFile");
+        close(fd);
+        return QR_EC_IndexDatabaseError;
+    }
+
+    OFCondition result = EC_Normal;
+    char header[DBHEADERSIZE+1] = {};
+    unsigned int version = 0;
+    if (read(fd, header, DBHEADERSIZE) != DBHEADERSIZE ||
+        strncmp(header, DBMAGIC, strlen(DBMAGIC)) != 0 ||
+        sscanf(header + strlen(DBMAGIC), "%x", &version) != 1)
+    {
+        DCMQRDB_ERROR(indexFilename << ": unknown/legacy QRDB database file format");
+        result = QR_EC_IndexDatabaseError;
+    }
+    else if (version == DBVERSION)
+    {
+        DCMQRDB_INFO(indexFilename << ": QRDB database version " << version << " is up to date");
+    }
+    else if (version != DBVERSION_FIXEDSIZERECORDS)
+    {
+        DCMQRDB_ERROR(indexFilename << ": invalid/unsupported QRDB database version " << version);
+        result = QR_EC_IndexDatabaseError;
+    }
+    else
+    {
+        /* keep a copy of the original file in case the conversion is interrupted */
+        OFString backupFilename(indexFilename);
+        backupFilename += ".v5";
+        if (!OFStandard::copyFile(indexFilename, backupFilename))
+        {
+            DCMQRDB_ERROR(backupFilename << ": cannot create backup of index file: "
+                << OFStandard::getLastSystemErrorCode().message());
+            result = QR_EC_IndexDatabaseError;
+        }
+        else
+        {
+            DCMQRDB_INFO(indexFilename << ": converting QRDB database version " << version
+                << " to version " << DBVERSION << ", backup stored in " << backupFilename);
+
+            /* The study descriptors remain unchanged. Since a converted record is
+             * always smaller than an IdxRecord, the instance records can be converted
+             * in place without overwriting records that have not been read yet.
+             * Unused records are dropped.
+             */
+            IdxRecord rec;
+            char buffer[DB_IDXBUFFERSIZE];
+            long readPos = OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC);
+            long writePos = readPos;
+            unsigned long records = 0;
+            while (result.good() && (DB_lseek(fd, readPos, SEEK_SET) >= 0) &&
+                   (read(fd, (char *) &rec, SIZEOF_IDXRECORD) == SIZEOF_IDXRECORD))
+            {
+                readPos += OFstatic_cast(long, SIZEOF_IDXRECORD);
+                if (rec.filename[0] == '\0')
+                    continue;
+
+                /* the pointers stored in the file are meaningless */
+                DB_IdxInitRecord(&rec, 1);
+                const Uint32 length = DB_IdxPackRecord(&rec, buffer + DB_IDXHEADERSIZE);
+                memcpy(buffer, &length, sizeof(Uint32));
+                memcpy(buffer + sizeof(Uint32), &length, sizeof(Uint32));
+                const long count = OFstatic_cast(long, DB_IDXHEADERSIZE + length);
+                if ((length == 0) ||
+                    (DB_lseek(fd, writePos, SEEK_SET) < 0) ||
+                    (write(fd, buffer, OFstatic_cast(unsigned int, count)) != count))
+                {
+                    DCMQRDB_ERROR(indexFilename << ": cannot convert instance record " << records);
+                    result = QR_EC_IndexDatabaseError;
+                }
+                writePos += count;
+                records++;
+            }
+
+            if (result.good())
+            {
+#ifdef _WIN32
+                if (_chsize(fd, writePos) != 0)
+#else
+                if (ftruncate(fd, writePos) != 0)
+#endif
+                {
+                    DCMQRDB_ERROR(indexFilename << ": " << OFStandard::getLastSystemErrorCode().message());
+                    result = QR_EC_IndexDatabaseError;
+                }
+            }
+            if (result.good())
+            {
+                sprintf(header, DBMAGIC "%.2X", DBVERSION);
+                if ((DB_lseek(fd, 0L, SEEK_SET) < 0) || (write(fd, header, DBHEADERSIZE) != DBHEADERSIZE))
+                {
+                    DCMQRDB_ERROR(indexFilename << ": " << OFStandard::getLastSystemErrorCode().message());
+                    result = QR_EC_IndexDatabaseError;
+                }
+            }
+            if (result.good())
+            {
+                DCMQRDB_INFO(indexFilename << ": converted " << records << " instance records, file size reduced from "
+                    << readPos << " to " << writePos << " bytes");
+            }
+            else
+            {
+                DCMQRDB_ERROR(indexFilename << ": conversion failed, restore the index file from " << backupFilename);
+            }
+        }
+    }
+
+    dcmtk_flock(fd, LOCK_UN);
+    close(fd);
+    return result;
+}
+
 /************************
  *      Search in index file for SOP Class UID and SOP Instance UID. Used for the storage commitment server
  */
@@ -3073,6 +3695,7 @@ DcmQueryRetrieveIndexDatabaseHandle::DcmQueryRetrieveIndexDatabaseHandle(
     OFCondition& result)
 : handle_(NULL)
 , quotaSystemEnabled(OFTrue)
+, purger_(NULL)
 , doCheckFindIdentifier(OFFalse)
 , doCheckMoveIdentifier(OFFalse)
 , fnamecreator()
@@ -3153,7 +3776,10 @@ DcmQueryRetrieveIndexDatabaseHandle::DcmQueryRetrieveIndexDatabaseHandle(
                 )
                 {
                     DB_unlock();
-                    if ( version )
+                    if ( version == DBVERSION_FIXEDSIZERECORDS )
+                        DCMQRDB_ERROR(handle_->indexFilename << ": outdated QRDB database version " << version
+                            << ", use 'dcmqridx --upgrade' to convert the index file");
+                    else if ( version )
                         DCMQRDB_ERROR(handle_->indexFilename << ": invalid/unsupported QRDB database version " << version);
                     else
                         DCMQRDB_ERROR(handle_->indexFilename << ": unknown/legacy QRDB database file format");
@@ -3201,6 +3827,9 @@ DcmQueryRetrieveIndexDatabaseHandle::DcmQueryRetrieveIndexDatabaseHandle(
 
 DcmQueryRetrieveIndexDatabaseHandle::~DcmQueryRetrieveIndexDatabaseHandle()
 {
+    /* complete pending deletions */
+    enableBackgroundPurge(OFFalse);
+
     if (handle_)
     {
 #ifndef _WIN32
@@ -3265,9 +3894,11 @@ OFCondition DcmQueryRetrieveIndexDatabaseHandle::instanceReviewed(int idx)
       result = DB_lock(OFTrue);
       if (result.bad()) return result;
 
-      record.hstat = DVIF_objectIsNotNew;
-      DB_lseek(handle_->pidx, OFstatic_cast(long, DBHEADERSIZE + SIZEOF_STUDYDESC + idx * SIZEOF_IDXRECORD), SEEK_SET);
-      if (write(handle_->pidx, OFreinterpret_cast(char *, &record), SIZEOF_IDXRECORD) != SIZEOF_IDXRECORD)
+      // the status flag has a fixed position within the record data,
+      // so there is no need to rewrite the complete record
+      const char hstat = DVIF_objectIsNotNew;
+      DB_lseek(handle_->pidx, handle_->recordOffsets[idx] + OFstatic_cast(long, DB_IDXHEADERSIZE + DB_IDXSTATUSOFFSET), SEEK_SET);
+      if (write(handle_->pidx, &hstat, 1) != 1)
           result = QR_EC_IndexDatabaseError;
       DB_lseek(handle_->pidx, OFstatic_cast(long, DBHEADERSIZE), SEEK_SET);
       DB_unlock();
@@ -3299,6 +3930,7 @@ DB_SmallDcmElmt::DB_SmallDcmElmt()
 DcmQueryRetrieveIndexDatabaseHandleFactory::DcmQueryRetrieveIndexDatabaseHandleFactory(const DcmQueryRetrieveConfig *config)
 : DcmQueryRetrieveDatabaseHandleFactory()
 , config_(config)
+, backgroundPurge_(OFFalse)
 {
 }
 
@@ -3311,8 +3943,16 @@ DcmQueryRetrieveDatabaseHandle *DcmQueryRetrieveIndexDatabaseHandleFactory::crea
     const char *calledAETitle,
     OFCondition& result) const
 {
-  return new DcmQueryRetrieveIndexDatabaseHandle(
+  DcmQueryRetrieveIndexDatabaseHandle *handle = new DcmQueryRetrieveIndexDatabaseHandle(
     config_->getStorageArea(calledAETitle),
     config_->getMaxStudies(calledAETitle),
     config_->getMaxBytesPerStudy(calledAETitle), result);
+  if (result.good() && backgroundPurge_)
+    handle->enableBackgroundPurge(OFTrue);
+  return handle;
+}
+
+void DcmQueryRetrieveIndexDatabaseHandleFactory::setBackgroundPurge(OFBool enable)
+{
+  backgroundPurge_ = enable;
 }
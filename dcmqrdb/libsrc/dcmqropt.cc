@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1993-2017, OFFIS e.V.
+ *  Copyright (C) 1993-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -39,6 +39,8 @@ DcmQueryRetrieveOptions::DcmQueryRetrieveOptions()
 , itempad_(0)
 , maxAssociations_(20)
 , maxPDU_(ASC_DEFAULTMAXPDU)
+, maxMoveSubAssociations_(1)
+, moveReadAhead_(0)
 , net_(NULL)
 , networkTransferSyntax_(EXS_Unknown)
 #ifndef DISABLE_COMPRESSION_EXTENSION
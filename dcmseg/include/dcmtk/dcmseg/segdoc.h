@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2019, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -24,6 +24,7 @@
 
 #include "dcmtk/config/osconfig.h"              // include OS configuration first
 #include "dcmtk/ofstd/ofvector.h"               // for OFVector
+#include "dcmtk/ofstd/ofmap.h"                  // for OFMap
 #include "dcmtk/dcmiod/iodimage.h"              // common image IOD attribute access
 #include "dcmtk/dcmiod/iodmacro.h"
 #include "dcmtk/dcmiod/modimagepixel.h"
@@ -265,13 +266,32 @@ public:
    */
   virtual SOPInstanceReferenceMacro& getReferencedPPS();
 
-  /** Get (const) frame data of a specific frame
+  /** Get (const) frame data of a specific frame. When reading a segmentation
+   *  object, the frames are not extracted from the pixel data before they
+   *  are requested for the first time, so only the frames actually accessed
+   *  occupy memory of their own.
    *  @param  frameNo The number of the frame to get (starting with 0)
    *  @return The frame requested or NULL if not existing
    */
   virtual const DcmIODTypes::Frame* getFrame(const size_t& frameNo);
 
-  /** Get the frame numbers that belong to a specific segment number
+  /** Get the runs of set pixels of a specific frame of a binary segmentation.
+   *  This is the most efficient way to access sparse frames since frames
+   *  added to this object are stored as such runs, and frames read from a
+   *  dataset are scanned without extracting them.
+   *  @param  frameNo The number of the frame (starting with 0)
+   *  @param  runs Receives the runs of set pixels, sorted by their start
+   *          position
+   *  @return EC_Normal if successful, EC_IllegalCall if segmentation is not
+   *          binary, error otherwise
+   */
+  virtual OFCondition getFrameRuns(const size_t& frameNo,
+                                   OFVector<DcmSegTypes::PixelRun>& runs);
+
+  /** Get the frame numbers that belong to a specific segment number. The
+   *  frames of all segments are indexed once when reading the object
+   *  (and whenever a frame is added), so the per-frame functional groups do
+   *  not have to be examined for every call.
    *  @param  segmentNumber The segment to search frames for
    *  @param  frameNumbers  The frame numbers belonging to that segment
    */
@@ -299,7 +319,9 @@ public:
    *  @param  pixData Pixel data to be added. Length must be rows*columns bytes.
    *          For binary segmentations (bit depth i.e.\ Bits
    *          Allocated/Stored=1), each byte equal to 0 will be interpreted as
-   *          "not set", while every other value is interpreted as "set". For
+   *          "not set", while every other value is interpreted as "set".
+   *          Binary frames are kept as runs of set pixels and are only
+   *          converted to bit-packed pixel data when writing the object. For
    *          fractional segmentations the full byte is copied as is.
    *  @param  segmentNumber The logical segment number (>=1) this frame refers to.
    *          The segment identified by the segmentNumber must already exist.
@@ -554,6 +576,19 @@ protected:
    */
   virtual OFCondition addFrame(Uint8* pixData);
 
+  /** Extract a frame from the pixel data that was read from the dataset (or
+   *  pack a frame added as runs of set pixels) and store it in the list of
+   *  frames, if this has not been done before.
+   *  @param  frameNo The number of the frame to load (starting with 0)
+   *  @return EC_Normal if frame is available now, error otherwise
+   */
+  virtual OFCondition loadFrame(const size_t frameNo);
+
+  /** Extract all frames not loaded so far, see loadFrame()
+   *  @return EC_Normal if all frames are available now, error otherwise
+   */
+  virtual OFCondition loadAllFrames();
+
 private:
 
   // Modules supported:
@@ -586,9 +621,32 @@ private:
   /// Multi-frame Dimension Module
   IODMultiframeDimensionModule m_DimensionModule;
 
-  /// Binary frame data
+  /// Binary frame data. Entries are NULL for frames that have been read from
+  /// the dataset but have not been loaded (i.e.\ extracted) yet, and for
+  /// binary frames added as runs of set pixels that have not been packed.
   OFVector<DcmIODTypes::Frame*> m_Frames;
 
+  /// Binary frames added to this object, stored as runs of set pixels. NULL
+  /// for all other frames. Might contain less entries than m_Frames.
+  OFVector<OFVector<DcmSegTypes::PixelRun>*> m_FrameRuns;
+
+  /// Copy of the Pixel Data read from the dataset, frames are extracted on
+  /// demand. NULL if no Pixel Data has been read.
+  Uint8* m_ReadPixelData;
+
+  /// Number of bytes in m_ReadPixelData
+  size_t m_ReadPixelDataLength;
+
+  /// Number of frames (at the beginning of m_Frames) contained in
+  /// m_ReadPixelData
+  size_t m_NumReadFrames;
+
+  /// Frame numbers (starting with 0) for each segment number
+  OFMap<Uint16, OFVector<size_t> > m_SegmentFrameIndex;
+
+  /// Whether m_SegmentFrameIndex is valid, i.e.\ contains all frames
+  OFBool m_SegmentFrameIndexValid;
+
   /* Image level information */
 
   /// Image Type: (CS, VM 2-n, Type 1), in Segmentations fixed to "DERIVED\PRIMARY"
@@ -659,6 +717,19 @@ private:
                                     const Uint32& numberOfFrames,
                                     size_t& bytesRequired);
 
+  /** Build the index of frames per segment (m_SegmentFrameIndex) from the
+   *  Segment Identification Sequence of the shared or per-frame functional
+   *  groups in the given dataset. This avoids creating the functional groups
+   *  of all frames just in order to find the frames of a segment.
+   *  @param  dataset The dataset to read from
+   */
+  void readSegmentFrameIndex(DcmItem& dataset);
+
+  /** Free the Pixel Data read from the dataset (without touching the frames
+   *  already loaded)
+   */
+  void clearReadPixelData();
+
   /** Read Fractional Type of segmentation.
    *  @param  item The item to read from
    *  @return EC_Normal if type could be read, EC_TagNotFound if tag is not present,
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2018, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -123,6 +123,19 @@ class DCMTK_DCMSEG_EXPORT DcmSegTypes
       SFT_OCCUPANCY
     };
 
+    /** Run of consecutive pixels set in a binary segmentation frame. A frame
+     *  is described by a list of such runs sorted by their start position and
+     *  not overlapping each other, which requires much less memory than the
+     *  frame itself if only few pixels are set.
+     */
+    struct PixelRun
+    {
+      /// Position of the first pixel of the run, i.e.\ (row * columns) + column
+      Uint32 start;
+      /// Number of consecutive pixels set (at least 1)
+      Uint32 length;
+    };
+
 
     // -- helper functions --
 
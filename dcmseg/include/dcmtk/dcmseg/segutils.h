@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2018, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -24,6 +24,7 @@
 
 #include "dcmtk/config/osconfig.h"
 #include "dcmtk/dcmseg/segdef.h"
+#include "dcmtk/ofstd/ofvector.h"
 #include "dcmtk/dcmseg/segtypes.h"
 
 /** Class that contains helper functionality for the dcmseg module
@@ -44,6 +45,83 @@ public:
                                              const Uint16 rows,
                                              const Uint16 columns);
 
+  /** Pack the given unpacked binary pixels into the bit-packed format expected
+   *  by DICOM, i.e.\ the first pixel is stored in the least significant bit of
+   *  the first byte. Eight pixels are processed at once, so this is
+   *  considerably faster than setting the bits one by one.
+   *  @param  pixelData Pixel data in unpacked format (one byte per pixel, every
+   *          value other than 0 is interpreted as "set")
+   *  @param  numPixels The number of pixels to be packed
+   *  @param  result Buffer receiving the packed pixels. Must provide at least
+   *          getBytesForBinaryFrame(numPixels) bytes. Unused bits of the last
+   *          byte are set to 0.
+   */
+  static void packBits(const Uint8* pixelData,
+                       const size_t numPixels,
+                       Uint8* result);
+
+  /** Unpack the given bit-packed binary pixels into one byte per pixel, being
+   *  either 0 (not set) or 1 (set). This is the counterpart of packBits().
+   *  @param  packedData Pixel data in packed format. Must provide at least
+   *          getBytesForBinaryFrame(numPixels) bytes.
+   *  @param  numPixels The number of pixels to be unpacked
+   *  @param  result Buffer receiving the unpacked pixels. Must provide at least
+   *          numPixels bytes.
+   */
+  static void unpackBits(const Uint8* packedData,
+                         const size_t numPixels,
+                         Uint8* result);
+
+  /** Pack the given runs of set pixels into a binary segmentation frame in
+   *  the packed format expected by DICOM
+   *  @param  runs The runs of set pixels, sorted and not overlapping
+   *  @param  rows Number of rows of the frame
+   *  @param  columns The number of columns of the frame
+   *  @return The frame data if successful, NULL if an error occurs
+   */
+  static DcmIODTypes::Frame* packBinaryFrame(const OFVector<DcmSegTypes::PixelRun>& runs,
+                                             const Uint16 rows,
+                                             const Uint16 columns);
+
+  /** Determine the runs of set pixels in the given unpacked pixel data
+   *  @param  pixelData Pixel data in unpacked format (one byte per pixel, every
+   *          value other than 0 is interpreted as "set")
+   *  @param  numPixels The number of pixels
+   *  @param  runs Receives the runs of set pixels (sorted). Any previous
+   *          content is removed.
+   */
+  static void getRunsFromPixels(const Uint8* pixelData,
+                                const size_t numPixels,
+                                OFVector<DcmSegTypes::PixelRun>& runs);
+
+  /** Determine the runs of set pixels in the given bit-packed pixel data.
+   *  Bytes not set at all or completely set are skipped at once.
+   *  @param  packedData Pixel data in packed format
+   *  @param  bitOffset Position of the first pixel's bit within packedData,
+   *          e.g.\ frame number * rows * columns for frames concatenated as
+   *          in the Pixel Data element
+   *  @param  numPixels The number of pixels to examine
+   *  @param  runs Receives the runs of set pixels (sorted), with their start
+   *          relative to bitOffset. Any previous content is removed.
+   */
+  static void getRunsFromBits(const Uint8* packedData,
+                              const size_t bitOffset,
+                              const size_t numPixels,
+                              OFVector<DcmSegTypes::PixelRun>& runs);
+
+  /** Set the bits of all pixels covered by the given runs in a bit-packed
+   *  buffer. Other bits are not modified, so the buffer is usually zeroed
+   *  before. Whole bytes covered by a run are filled at once.
+   *  @param  runs The runs of set pixels
+   *  @param  packedData The buffer to be modified. Must be large enough to
+   *          hold the bits of all runs.
+   *  @param  bitOffset Position of the bit corresponding to pixel 0 of the
+   *          runs within packedData
+   */
+  static void setBitsFromRuns(const OFVector<DcmSegTypes::PixelRun>& runs,
+                              Uint8* packedData,
+                              const size_t bitOffset);
+
   /** Compute the number of bytes required for a binary pixel data frame,
    *  given the number of pixels
    *  @param  numPixels The total number of pixels
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2019, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -39,6 +39,12 @@ DcmSegmentation::DcmSegmentation()
   m_FG(DcmSegmentation::IODImage::getData(), DcmSegmentation::IODImage::getRules()),
   m_DimensionModule(DcmSegmentation::IODImage::getData(), DcmSegmentation::IODImage::getRules()),
   m_Frames(),
+  m_FrameRuns(),
+  m_ReadPixelData(NULL),
+  m_ReadPixelDataLength(0),
+  m_NumReadFrames(0),
+  m_SegmentFrameIndex(),
+  m_SegmentFrameIndexValid(OFTrue),
   m_ImageType("DERIVED\\PRIMARY"),
   m_ContentIdentificationMacro(),
   m_SegmentationType(DcmSegTypes::ST_BINARY),
@@ -245,6 +251,8 @@ OFCondition DcmSegmentation::read(DcmItem &dataset)
 
   readFrames(dataset);
 
+  readSegmentFrameIndex(dataset);
+
   readSegmentationFractionalType(dataset);
 
   m_ContentIdentificationMacro.read(dataset);
@@ -380,12 +388,19 @@ OFCondition DcmSegmentation::addFrame(Uint8* pixData)
   if (getImagePixel().getRows(rows).good() && getImagePixel().getColumns(cols).good())
   {
     DcmIODTypes::Frame* frame = NULL;
+    OFVector<DcmSegTypes::PixelRun>* runs = NULL;
     if (m_SegmentationType == DcmSegTypes::ST_BINARY)
     {
-      frame = DcmSegUtils::packBinaryFrame(pixData, rows, cols);
-      if (!frame)
+      // Binary frames are stored as runs of set pixels and only packed
+      // when writing (or if the frame is requested via getFrame())
+      runs = new OFVector<DcmSegTypes::PixelRun>();
+      if (runs)
+      {
+        DcmSegUtils::getRunsFromPixels(pixData, OFstatic_cast(size_t, rows) * cols, *runs);
+      }
+      else
       {
-        result = IOD_EC_CannotInsertFrame;
+        result = EC_MemoryExhausted;
       }
     }
     else // fractional
@@ -401,7 +416,10 @@ OFCondition DcmSegmentation::addFrame(Uint8* pixData)
     }
     if (result.good())
     {
+      // Make sure both lists have the same size, e.g. after reading
+      m_FrameRuns.resize(m_Frames.size(), NULL);
       m_Frames.push_back(frame);
+      m_FrameRuns.push_back(runs);
     }
   }
   else
@@ -420,9 +438,58 @@ SOPInstanceReferenceMacro& DcmSegmentation::getReferencedPPS()
 }
 
 
+OFCondition DcmSegmentation::getFrameRuns(const size_t& frameNo,
+                                          OFVector<DcmSegTypes::PixelRun>& runs)
+{
+  runs.clear();
+  if (m_SegmentationType != DcmSegTypes::ST_BINARY)
+  {
+    DCMSEG_ERROR("Cannot get runs of set pixels, segmentation is not binary");
+    return EC_IllegalCall;
+  }
+  if (frameNo >= m_Frames.size())
+  {
+    return EC_IllegalParameter;
+  }
+  // Frame added as runs of set pixels
+  if ( (frameNo < m_FrameRuns.size()) && (m_FrameRuns[frameNo] != NULL) )
+  {
+    runs = *m_FrameRuns[frameNo];
+    return EC_Normal;
+  }
+  Uint16 rows, cols;
+  rows = cols = 0;
+  getImagePixel().getRows(rows);
+  getImagePixel().getColumns(cols);
+  const size_t pixelsPerFrame = OFstatic_cast(size_t, rows) * cols;
+  // Frame read from the dataset, no need to extract it
+  if ( (frameNo < m_NumReadFrames) && (m_ReadPixelData != NULL) )
+  {
+    if (DcmSegUtils::getBytesForBinaryFrame((frameNo + 1) * pixelsPerFrame) > m_ReadPixelDataLength)
+      return IOD_EC_InvalidPixelData;
+    DcmSegUtils::getRunsFromBits(m_ReadPixelData, frameNo * pixelsPerFrame, pixelsPerFrame, runs);
+    return EC_Normal;
+  }
+  // Packed frame
+  if (m_Frames[frameNo] != NULL)
+  {
+    if (m_Frames[frameNo]->length < DcmSegUtils::getBytesForBinaryFrame(pixelsPerFrame))
+      return IOD_EC_InvalidPixelData;
+    DcmSegUtils::getRunsFromBits(m_Frames[frameNo]->pixData, 0, pixelsPerFrame, runs);
+    return EC_Normal;
+  }
+  return IOD_EC_InvalidPixelData;
+}
+
+
 const DcmIODTypes::Frame* DcmSegmentation::getFrame(const size_t& frameNo)
 {
-  if (frameNo > m_Frames.size() - 1)
+  if (frameNo >= m_Frames.size())
+  {
+    return NULL;
+  }
+
+  if (loadFrame(frameNo).bad())
   {
     return NULL;
   }
@@ -434,6 +501,20 @@ const DcmIODTypes::Frame* DcmSegmentation::getFrame(const size_t& frameNo)
 void DcmSegmentation::getFramesForSegment(const size_t& segmentNumber,
                                           OFVector<size_t>& frameNumbers)
 {
+  if (m_SegmentFrameIndexValid)
+  {
+    if (segmentNumber <= 0xFFFF)
+    {
+      OFMap<Uint16, OFVector<size_t> >::const_iterator it = m_SegmentFrameIndex.find(OFstatic_cast(Uint16, segmentNumber));
+      if (it != m_SegmentFrameIndex.end())
+      {
+        frameNumbers.insert(frameNumbers.end(), (*it).second.begin(), (*it).second.end());
+      }
+    }
+    return;
+  }
+
+  // No index available, examine functional groups of all frames
   size_t numFrames = getNumberOfFrames();
   for (size_t count = 0; count < numFrames; count++)
   {
@@ -521,6 +602,12 @@ OFCondition DcmSegmentation::addFrame(Uint8* pixData,
     result = addFrame(pixData);
   }
 
+  // Keep index of frames per segment up to date
+  if (result.good() && m_SegmentFrameIndexValid)
+  {
+    m_SegmentFrameIndex[segmentNumber].push_back(frameNo);
+  }
+
   // Cleanup any per-frame groups that might have been inserted and return
   if (result.bad())
   {
@@ -766,39 +853,126 @@ OFCondition DcmSegmentation::readFrames(DcmItem& dataset)
     return result;
   }
 
-  /* Read all frames into dedicated data structure */
-  size_t pixelsPerFrame = OFstatic_cast(size_t, rows) * cols;
+  /* Keep a copy of the pixel data, frames are extracted on demand */
+  size_t numBytes = 0;
+  result = getTotalBytesRequired(rows, cols, numberOfFrames, numBytes);
+  if (result.bad())
+    return result;
+  clearReadPixelData();
+  DcmIODUtil::freeContainer(m_Frames);
+  DcmIODUtil::freeContainer(m_FrameRuns);
+  m_ReadPixelData = new Uint8[numBytes];
+  if (m_ReadPixelData == NULL)
+    return EC_MemoryExhausted;
+  memcpy(m_ReadPixelData, pixels, numBytes);
+  m_ReadPixelDataLength = numBytes;
+  m_NumReadFrames = numberOfFrames;
+  m_Frames.resize(numberOfFrames, NULL);
+
+  return result;
+}
+
+
+OFCondition DcmSegmentation::loadFrame(const size_t frameNo)
+{
+  if (frameNo >= m_Frames.size())
+    return EC_IllegalParameter;
+  // Nothing to do if frame has been loaded before
+  if (m_Frames[frameNo] != NULL)
+    return EC_Normal;
+
+  Uint16 rows, cols;
+  rows = cols = 0;
+  getImagePixel().getRows(rows);
+  getImagePixel().getColumns(cols);
+  // Pack frame that has been added as runs of set pixels
+  if ( (frameNo < m_FrameRuns.size()) && (m_FrameRuns[frameNo] != NULL) )
+  {
+    m_Frames[frameNo] = DcmSegUtils::packBinaryFrame(*m_FrameRuns[frameNo], rows, cols);
+    return (m_Frames[frameNo] != NULL) ? EC_Normal : IOD_EC_InvalidPixelData;
+  }
+  // Nothing to do if frame has not been read from the dataset
+  if ( (frameNo >= m_NumReadFrames) || (m_ReadPixelData == NULL) )
+    return EC_Normal;
+
+  const size_t pixelsPerFrame = OFstatic_cast(size_t, rows) * cols;
+  DcmIODTypes::Frame* frame = new DcmIODTypes::Frame();
+  if (frame == NULL)
+    return EC_MemoryExhausted;
   if (m_SegmentationType == DcmSegTypes::ST_BINARY)
   {
-      result = extractFrames(pixels, numberOfFrames, pixelsPerFrame, m_Frames);
-      if (result.bad())
+    // All frames are concatenated bit by bit, so the frame might start
+    // in the middle of a byte
+    const size_t startBit = frameNo * pixelsPerFrame;
+    const size_t startByte = startBit / 8;
+    const Uint8 bitShift = OFstatic_cast(Uint8, startBit % 8);
+    frame->length = DcmSegUtils::getBytesForBinaryFrame(pixelsPerFrame);
+    if (startByte + frame->length > m_ReadPixelDataLength)
+    {
+      frame->pixData = NULL;
+      delete frame;
+      return IOD_EC_InvalidPixelData;
+    }
+    frame->pixData = new Uint8[frame->length];
+    if (frame->pixData == NULL)
+    {
+      delete frame;
+      return EC_MemoryExhausted;
+    }
+    const Uint8* src = m_ReadPixelData + startByte;
+    if (bitShift == 0)
+    {
+      memcpy(frame->pixData, src, frame->length);
+    }
+    else
+    {
+      // Align frame on byte boundary, taking over the first bits from the
+      // following byte (if existing)
+      const size_t available = m_ReadPixelDataLength - startByte;
+      for (size_t x = 0; x < frame->length; x++)
       {
-        return result;
+        Uint8 next = (x + 1 < available) ? src[x + 1] : 0;
+        frame->pixData[x] = OFstatic_cast(Uint8, (src[x] >> bitShift) | (next << (8 - bitShift)));
+      }
     }
+    // Zero out unused bits in last byte (belonging to the next frame)
+    const Uint8 unusedBits = OFstatic_cast(Uint8, (8 - (pixelsPerFrame % 8)) % 8);
+    frame->pixData[frame->length - 1] &= OFstatic_cast(Uint8, 0xFF >> unusedBits);
   }
-  else if (m_SegmentationType == DcmSegTypes::ST_FRACTIONAL)
+  else
   {
-    for (size_t count = 0; count < numberOfFrames; count++)
+    frame->length = pixelsPerFrame;
+    if ((frameNo + 1) * pixelsPerFrame > m_ReadPixelDataLength)
     {
-      DcmIODTypes::Frame *frame = new DcmIODTypes::Frame();
-      if (!frame) return EC_MemoryExhausted;
-      frame->length = pixelsPerFrame;
-      frame->pixData= new Uint8[pixelsPerFrame];
-      if (!frame->pixData)
-      {
-          delete frame;
-          return EC_MemoryExhausted;
-      }
-      memcpy(frame->pixData, pixels + count* pixelsPerFrame, pixelsPerFrame);
-      m_Frames.push_back(frame);
+      frame->pixData = NULL;
+      delete frame;
+      return IOD_EC_InvalidPixelData;
     }
+    frame->pixData = new Uint8[frame->length];
+    if (frame->pixData == NULL)
+    {
+      delete frame;
+      return EC_MemoryExhausted;
+    }
+    memcpy(frame->pixData, m_ReadPixelData + frameNo * pixelsPerFrame, frame->length);
   }
+  m_Frames[frameNo] = frame;
+  return EC_Normal;
+}
+
 
+OFCondition DcmSegmentation::loadAllFrames()
+{
+  OFCondition result;
+  const size_t numFrames = m_Frames.size();
+  for (size_t count = 0; result.good() && (count < numFrames); count++)
+  {
+    result = loadFrame(count);
+  }
   return result;
 }
 
 
-
 OFCondition DcmSegmentation::getAndCheckImagePixelAttributes(DcmItem& dataset,
                                                              Uint16& allocated,
                                                              Uint16& stored,
@@ -947,6 +1121,14 @@ OFCondition DcmSegmentation::writeFractionalFrames(DcmItem& dataset)
     DCMSEG_ERROR("Cannot store Segmentation objects with more than 4 GB pixel data (compression for writing not supported)");
     return EC_TooManyBytesRequested;
   }
+  // If no frames have been added since reading, the pixel data read can be
+  // written as is
+  if ( (m_ReadPixelData != NULL) && (m_NumReadFrames == numFrames) && (m_ReadPixelDataLength == numBytes) )
+  {
+    return dataset.putAndInsertUint8Array(DCM_PixelData, m_ReadPixelData, OFstatic_cast(unsigned long, numBytes), OFTrue);
+  }
+  result = loadAllFrames();
+  if (result.bad()) return result;
   Uint8* pixdata = new Uint8[numBytes];
   OFVector<DcmIODTypes::Frame*>::iterator it = m_Frames.begin();
   // Just copy bytes for each frame as is
@@ -978,14 +1160,53 @@ OFCondition DcmSegmentation::writeBinaryFrames(DcmItem& dataset)
     DCMSEG_ERROR("Cannot store Segmentation objects with more than 4 GB pixel data (compression for writing not supported)");
     return EC_TooManyBytesRequested;
   }
+  // If no frames have been added since reading, the pixel data read is
+  // already packed as required
+  if ( (m_ReadPixelData != NULL) && (m_NumReadFrames == numFrames) && (m_ReadPixelDataLength == numBytes) )
+  {
+    return dataset.putAndInsertUint8Array(DCM_PixelData, m_ReadPixelData, OFstatic_cast(unsigned long, numBytes), OFTrue);
+  }
   // Holds the pixels for all frames. Each bit represents a pixel which is either
   // 1 (part of segment) or 0 (not part of segment. All frames are directly
   // concatenated, i.e. there are no unused bits between the frames.
   Uint8* pixdata = new Uint8[numBytes];
   memset(pixdata, 0, numBytes);
 
-  // Fill Pixel Data Element
-  concatFrames(m_Frames, pixdata, rows*cols);
+  // Frames read from the dataset cannot be modified, so copy their bits as is
+  const size_t pixelsPerFrame = OFstatic_cast(size_t, rows) * cols;
+  size_t frameNo = 0;
+  if (m_ReadPixelData != NULL)
+  {
+    if (m_NumReadFrames < numFrames) frameNo = m_NumReadFrames;
+    else frameNo = numFrames;
+    const size_t numBits = frameNo * pixelsPerFrame;
+    memcpy(pixdata, m_ReadPixelData, numBits / 8);
+    if (numBits % 8 > 0)
+    {
+      pixdata[numBits / 8] = m_ReadPixelData[numBits / 8] & OFstatic_cast(Uint8, 0xFF >> (8 - numBits % 8));
+    }
+  }
+  // Set the bits of all other frames
+  OFVector<DcmSegTypes::PixelRun> runs;
+  for (; frameNo < numFrames; frameNo++)
+  {
+    const size_t bitOffset = frameNo * pixelsPerFrame;
+    if ( (frameNo < m_FrameRuns.size()) && (m_FrameRuns[frameNo] != NULL) )
+    {
+      DcmSegUtils::setBitsFromRuns(*m_FrameRuns[frameNo], pixdata, bitOffset);
+    }
+    else if ( (m_Frames[frameNo] != NULL) && (m_Frames[frameNo]->length >= DcmSegUtils::getBytesForBinaryFrame(pixelsPerFrame)) )
+    {
+      DcmSegUtils::getRunsFromBits(m_Frames[frameNo]->pixData, 0, pixelsPerFrame, runs);
+      DcmSegUtils::setBitsFromRuns(runs, pixdata, bitOffset);
+    }
+    else
+    {
+      DCMSEG_ERROR("Cannot write binary frame #" << frameNo + 1 << ": No frame data");
+      delete[] pixdata;
+      return IOD_EC_InvalidPixelData;
+    }
+  }
   result = dataset.putAndInsertUint8Array(DCM_PixelData, pixdata, OFstatic_cast(unsigned long, numBytes), OFTrue);
   delete [] pixdata;
   return result;
@@ -1091,6 +1312,10 @@ void DcmSegmentation::clearData()
   m_FG.clearData();
   m_FGInterface.clear();
   DcmIODUtil::freeContainer(m_Frames);
+  DcmIODUtil::freeContainer(m_FrameRuns);
+  clearReadPixelData();
+  m_SegmentFrameIndex.clear();
+  m_SegmentFrameIndexValid = OFTrue;
   DcmIODUtil::freeContainer(m_Segments);
   m_MaximumFractionalValue.clear();
   m_SegmentationFractionalType = DcmSegTypes::SFT_UNKNOWN;
@@ -1183,6 +1408,65 @@ OFCondition DcmSegmentation::loadFile(DcmFileFormat& dcmff,
 }
 
 
+void DcmSegmentation::readSegmentFrameIndex(DcmItem& dataset)
+{
+  m_SegmentFrameIndex.clear();
+  m_SegmentFrameIndexValid = OFFalse;
+  const size_t numFrames = getNumberOfFrames();
+  Uint16 segmentNumber = 0;
+  // If the segment is identified in the shared functional groups, all frames
+  // belong to the same segment
+  DcmItem* fgItem = NULL;
+  DcmItem* segItem = NULL;
+  if (dataset.findAndGetSequenceItem(DCM_SharedFunctionalGroupsSequence, fgItem, 0).good() &&
+      fgItem->findAndGetSequenceItem(DCM_SegmentIdentificationSequence, segItem, 0).good() &&
+      segItem->findAndGetUint16(DCM_ReferencedSegmentNumber, segmentNumber).good())
+  {
+    OFVector<size_t>& frames = m_SegmentFrameIndex[segmentNumber];
+    for (size_t count = 0; count < numFrames; count++)
+    {
+      frames.push_back(count);
+    }
+    m_SegmentFrameIndexValid = OFTrue;
+    return;
+  }
+  // Otherwise each item of the per-frame functional groups identifies the
+  // segment of the related frame
+  DcmSequenceOfItems* perFrame = NULL;
+  if (dataset.findAndGetSequence(DCM_PerFrameFunctionalGroupsSequence, perFrame).bad() ||
+      (perFrame->card() != numFrames))
+  {
+    DCMSEG_WARN("Cannot build index of frames per segment, number of per-frame functional group items does not match number of frames");
+    return;
+  }
+  DcmObject* obj = NULL;
+  size_t count = 0;
+  while ( (obj = perFrame->nextInContainer(obj)) != NULL )
+  {
+    fgItem = OFstatic_cast(DcmItem*, obj);
+    if (fgItem->findAndGetSequenceItem(DCM_SegmentIdentificationSequence, segItem, 0).bad() ||
+        segItem->findAndGetUint16(DCM_ReferencedSegmentNumber, segmentNumber).bad())
+    {
+      DCMSEG_WARN("Cannot build index of frames per segment, Referenced Segment Number missing for frame #" << count + 1);
+      m_SegmentFrameIndex.clear();
+      return;
+    }
+    m_SegmentFrameIndex[segmentNumber].push_back(count);
+    count++;
+  }
+  m_SegmentFrameIndexValid = OFTrue;
+}
+
+
+void DcmSegmentation::clearReadPixelData()
+{
+  delete[] m_ReadPixelData;
+  m_ReadPixelData = NULL;
+  m_ReadPixelDataLength = 0;
+  m_NumReadFrames = 0;
+}
+
+
 OFCondition DcmSegmentation::readSegmentationFractionalType(DcmItem& item)
 {
   m_SegmentationFractionalType = DcmSegTypes::SFT_UNKNOWN;
@@ -1399,7 +1683,7 @@ OFCondition DcmSegmentation::extractFrames(Uint8* pixData,
     }
     // Adapt last byte by masking out unused bits (i.e. those belonging to next frame).
     // A reader should ignore those unused bits anyway.
-    frame->pixData[frame->length-1] = (frame->pixData[frame->length-1] << (overlapBits)) >> (overlapBits);
+    frame->pixData[frame->length-1] &= OFstatic_cast(Uint8, 0xFF >> overlapBits);
     // Store frame
     results.push_back(frame);
     // Compute the bitshift created by this frame
@@ -1437,7 +1721,7 @@ void DcmSegmentation::concatFrames(OFVector< DcmIODTypes::Frame* > frames,
     // previous frame; mask out those bits not belonging to previous frame.
     // This will potentially create some empty bits on the left of the byte,
     // that the current frame can use to store the its own first bits.
-    firstByte = (writePos[0] << freeBits) >> freeBits;
+    firstByte = writePos[0] & OFstatic_cast(Uint8, 0xFF >> freeBits);
     memcpy(writePos, (*frame)->pixData, (*frame)->length);
     // If the previous frame left over some unused bits, shift the current frame
     // that number of bits to the left, and restore the original bits of the
@@ -1464,9 +1748,10 @@ void DcmSegmentation::concatFrames(OFVector< DcmIODTypes::Frame* > frames,
     frame++;
   }
   // Through shifting we can have non-zero bits within the unused bits of the
-  // last byte. Fill them with zeros (though not required by the standard).
+  // last byte (i.e. the leftmost bits). Fill them with zeros (though not
+  // required by the standard).
   if (freeBits > 0)
   {
-    *writePos = (*writePos >> freeBits) << freeBits;
+    *writePos &= OFstatic_cast(Uint8, 0xFF >> freeBits);
   }
 }
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2018, Open Connections GmbH
+ *  Copyright (C) 2015-2026, Open Connections GmbH
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation are maintained by
@@ -53,16 +53,67 @@ DcmIODTypes::Frame* DcmSegUtils::packBinaryFrame(const Uint8* pixelData,
     delete frame;
     return NULL;
   }
-  memset(frame->pixData, 0, frame->length);
+  packBits(pixelData, numPixels, frame->pixData);
+  return frame;
+}
 
-  size_t bytePos = 0;
-  for (size_t count = 0; count < numPixels; count++)
+
+void DcmSegUtils::packBits(const Uint8* pixelData,
+                           const size_t numPixels,
+                           Uint8* result)
+{
+  const size_t numFullBytes = numPixels / 8;
+  const Uint8* src = pixelData;
+  // Pack eight pixels per iteration, the first one goes into bit 0
+  for (size_t bytePos = 0; bytePos < numFullBytes; bytePos++)
   {
-    // Compute byte position
-    bytePos = count / 8;
-    frame->pixData[bytePos] |= (pixelData[count] != 0) /* value to set */ << (count % 8 /* bit position (0-7) within byte */);
+    result[bytePos] = OFstatic_cast(Uint8,
+        (src[0] != 0)        | ((src[1] != 0) << 1) |
+        ((src[2] != 0) << 2) | ((src[3] != 0) << 3) |
+        ((src[4] != 0) << 4) | ((src[5] != 0) << 5) |
+        ((src[6] != 0) << 6) | ((src[7] != 0) << 7));
+    src += 8;
+  }
+  // Pack remaining pixels, leaving the unused bits 0
+  const size_t remainder = numPixels % 8;
+  if (remainder > 0)
+  {
+    Uint8 last = 0;
+    for (size_t bitPos = 0; bitPos < remainder; bitPos++)
+    {
+      last |= OFstatic_cast(Uint8, (src[bitPos] != 0) << bitPos);
+    }
+    result[numFullBytes] = last;
+  }
+}
+
+
+void DcmSegUtils::unpackBits(const Uint8* packedData,
+                             const size_t numPixels,
+                             Uint8* result)
+{
+  const size_t numFullBytes = numPixels / 8;
+  Uint8* dest = result;
+  // Unpack eight pixels per iteration
+  for (size_t bytePos = 0; bytePos < numFullBytes; bytePos++)
+  {
+    const Uint8 b = packedData[bytePos];
+    dest[0] = b & 1;
+    dest[1] = (b >> 1) & 1;
+    dest[2] = (b >> 2) & 1;
+    dest[3] = (b >> 3) & 1;
+    dest[4] = (b >> 4) & 1;
+    dest[5] = (b >> 5) & 1;
+    dest[6] = (b >> 6) & 1;
+    dest[7] = (b >> 7) & 1;
+    dest += 8;
+  }
+  // Unpack remaining pixels
+  const size_t remainder = numPixels % 8;
+  for (size_t bitPos = 0; bitPos < remainder; bitPos++)
+  {
+    dest[bitPos] = (packedData[numFullBytes] >> bitPos) & 1;
   }
-  return frame;
 }
 
 
@@ -95,26 +146,156 @@ DcmIODTypes::Frame* DcmSegUtils::unpackBinaryFrame(const DcmIODTypes::Frame* fra
     DCMSEG_ERROR("Cannot unpack binary frame, memory exhausted");
     return NULL;
   }
-  memset(result->pixData, 0, result->length);
+  if (frame->length < getBytesForBinaryFrame(numBits))
+  {
+    DCMSEG_ERROR("Cannot unpack binary frame, frame data too short");
+    delete result;
+    return NULL;
+  }
 
   // Transform and copy from packed frame to unpacked result frame
-  size_t bytePos = 0;
-  for (size_t count = 0; count < numBits; count++)
-  {
-    // Compute byte position
-    bytePos = count / 8;
-    // Bit position (0-7) within byte
-    Uint8 bitpos = (count % 8);
-    if ( (frame->pixData[bytePos] & (1 << bitpos) /* check whether bit at bitpos is set*/) )
+  unpackBits(frame->pixData, numBits, result->pixData);
+  return result;
+}
+
+
+DcmIODTypes::Frame* DcmSegUtils::packBinaryFrame(const OFVector<DcmSegTypes::PixelRun>& runs,
+                                                 const Uint16 rows,
+                                                 const Uint16 columns)
+{
+  const size_t numPixels = OFstatic_cast(size_t, rows) * columns;
+  if (numPixels == 0)
+  {
+    DCMSEG_ERROR("Unable to pack binary segmentation frame: Rows or Columns is 0");
+    return NULL;
+  }
+  if (!runs.empty() && (OFstatic_cast(size_t, runs.back().start) + runs.back().length > numPixels))
+  {
+    DCMSEG_ERROR("Unable to pack binary segmentation frame: Pixel runs exceed frame size");
+    return NULL;
+  }
+  DcmIODTypes::Frame* frame = new DcmIODTypes::Frame();
+  if (frame == NULL)
+  {
+    DCMSEG_ERROR("Could not pack binary segmentation frame: Memory exhausted");
+    return NULL;
+  }
+  frame->length = getBytesForBinaryFrame(numPixels);
+  frame->pixData = new Uint8[frame->length];
+  if (frame->pixData == 0)
+  {
+    delete frame;
+    return NULL;
+  }
+  memset(frame->pixData, 0, frame->length);
+  setBitsFromRuns(runs, frame->pixData, 0);
+  return frame;
+}
+
+
+void DcmSegUtils::getRunsFromPixels(const Uint8* pixelData,
+                                    const size_t numPixels,
+                                    OFVector<DcmSegTypes::PixelRun>& runs)
+{
+  runs.clear();
+  DcmSegTypes::PixelRun run;
+  size_t pos = 0;
+  while (pos < numPixels)
+  {
+    // Skip pixels not set
+    while ( (pos < numPixels) && (pixelData[pos] == 0) )
+      pos++;
+    if (pos == numPixels)
+      break;
+    // Collect pixels set
+    run.start = OFstatic_cast(Uint32, pos);
+    while ( (pos < numPixels) && (pixelData[pos] != 0) )
+      pos++;
+    run.length = OFstatic_cast(Uint32, pos - run.start);
+    runs.push_back(run);
+  }
+}
+
+
+void DcmSegUtils::getRunsFromBits(const Uint8* packedData,
+                                  const size_t bitOffset,
+                                  const size_t numPixels,
+                                  OFVector<DcmSegTypes::PixelRun>& runs)
+{
+  runs.clear();
+  DcmSegTypes::PixelRun run;
+  OFBool inRun = OFFalse;
+  size_t runStart = 0;
+  size_t pos = 0;
+  while (pos < numPixels)
+  {
+    const size_t bit = bitOffset + pos;
+    const Uint8 byte = packedData[bit / 8];
+    OFBool set;
+    size_t count = 1;
+    // Handle a whole byte at once if it is not set at all or completely set
+    if ( (bit % 8 == 0) && (pos + 8 <= numPixels) && ((byte == 0) || (byte == 0xFF)) )
     {
-      result->pixData[count] = 1;
+      set = (byte != 0);
+      count = 8;
     }
     else
     {
-      result->pixData[count] = 0;
+      set = ((byte >> (bit % 8)) & 1) != 0;
+    }
+    if (set && !inRun)
+    {
+      runStart = pos;
+      inRun = OFTrue;
+    }
+    else if (!set && inRun)
+    {
+      run.start = OFstatic_cast(Uint32, runStart);
+      run.length = OFstatic_cast(Uint32, pos - runStart);
+      runs.push_back(run);
+      inRun = OFFalse;
     }
+    pos += count;
+  }
+  if (inRun)
+  {
+    run.start = OFstatic_cast(Uint32, runStart);
+    run.length = OFstatic_cast(Uint32, numPixels - runStart);
+    runs.push_back(run);
+  }
+}
+
+
+void DcmSegUtils::setBitsFromRuns(const OFVector<DcmSegTypes::PixelRun>& runs,
+                                  Uint8* packedData,
+                                  const size_t bitOffset)
+{
+  OFVector<DcmSegTypes::PixelRun>::const_iterator it = runs.begin();
+  while (it != runs.end())
+  {
+    size_t bit = bitOffset + (*it).start;
+    const size_t end = bit + (*it).length;
+    // Bits up to the next byte boundary
+    while ( (bit < end) && (bit % 8 != 0) )
+    {
+      packedData[bit / 8] |= OFstatic_cast(Uint8, 1 << (bit % 8));
+      bit++;
+    }
+    // Whole bytes
+    const size_t numBytes = (end - bit) / 8;
+    if (numBytes > 0)
+    {
+      memset(packedData + bit / 8, 0xFF, numBytes);
+      bit += numBytes * 8;
+    }
+    // Remaining bits
+    while (bit < end)
+    {
+      packedData[bit / 8] |= OFstatic_cast(Uint8, 1 << (bit % 8));
+      bit++;
+    }
+    it++;
   }
-  return result;
 }
 
 
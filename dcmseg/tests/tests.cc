@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015, OFFIS e.V.
+ *  Copyright (C) 2015-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -23,4 +23,7 @@
 #include "dcmtk/ofstd/oftest.h"
 
 OFTEST_REGISTER(dcmseg_utils);
+OFTEST_REGISTER(dcmseg_packBits);
+OFTEST_REGISTER(dcmseg_pixelRuns);
+OFTEST_REGISTER(dcmseg_frames);
 OFTEST_MAIN("dcmseg")
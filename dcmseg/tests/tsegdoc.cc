@@ -0,0 +1,207 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module:  dcmseg
+ *
+ *  Author:  OFFIS e.V.
+ *
+ *  Purpose: tests for reading and writing frames of DcmSegmentation
+ *
+ */
+
+
+#include "dcmtk/config/osconfig.h"    /* make sure OS specific configuration is included first */
+
+#include "dcmtk/ofstd/oftest.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcuid.h"
+#include "dcmtk/dcmseg/segdoc.h"
+#include "dcmtk/dcmseg/segment.h"
+#include "dcmtk/dcmseg/segutils.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/dcmfg/fgfracon.h"
+#include "dcmtk/dcmfg/fgpixmsr.h"
+#include "dcmtk/dcmfg/fgplanor.h"
+#include "dcmtk/dcmfg/fgplanpo.h"
+
+// 3x3 pixels, so that frames do not start at byte boundaries
+static const Uint16 ROWS = 3;
+static const Uint16 COLS = 3;
+static const size_t NUM_PIXELS = ROWS * COLS;
+static const size_t NUM_FRAMES = 5;
+
+static void fillFrame(Uint8* pixels, const size_t frameNo)
+{
+  for (size_t i = 0; i < NUM_PIXELS; i++)
+    pixels[i] = ((i + frameNo) % 3 == 0) ? 1 : 0;
+}
+
+static OFCondition addFrame(DcmSegmentation& seg, const size_t frameNo)
+{
+  Uint8 pixels[NUM_PIXELS];
+  fillFrame(pixels, frameNo);
+  FGPlanePosPatient planPo;
+  char buf[20];
+  sprintf(buf, "%u", OFstatic_cast(unsigned int, frameNo));
+  planPo.setImagePositionPatient("0", "0", buf);
+  // even frames belong to segment 1, odd frames to segment 2
+  const Uint16 segmentNumber = OFstatic_cast(Uint16, (frameNo % 2) + 1);
+  FGFrameContent fracon;
+  fracon.setDimensionIndexValues(segmentNumber, 0);
+  fracon.setDimensionIndexValues(OFstatic_cast(Uint32, frameNo + 1), 1);
+  OFVector<FGBase*> perFrame;
+  perFrame.push_back(&planPo);
+  perFrame.push_back(&fracon);
+  return seg.addFrame(pixels, segmentNumber, perFrame);
+}
+
+static void checkFrame(DcmSegmentation& seg, const size_t frameNo)
+{
+  const DcmIODTypes::Frame* frame = seg.getFrame(frameNo);
+  OFCHECK(frame != NULL);
+  if (frame == NULL)
+    return;
+  DcmIODTypes::Frame* unpacked = DcmSegUtils::unpackBinaryFrame(frame, ROWS, COLS);
+  OFCHECK(unpacked != NULL);
+  if (unpacked == NULL)
+    return;
+  Uint8 expected[NUM_PIXELS];
+  fillFrame(expected, frameNo);
+  OFCHECK(memcmp(unpacked->pixData, expected, NUM_PIXELS) == 0);
+  delete unpacked;
+  // Runs of set pixels must match, too
+  OFVector<DcmSegTypes::PixelRun> runs;
+  OFVector<DcmSegTypes::PixelRun> expectedRuns;
+  OFCHECK(seg.getFrameRuns(frameNo, runs).good());
+  DcmSegUtils::getRunsFromPixels(expected, NUM_PIXELS, expectedRuns);
+  OFCHECK_EQUAL(runs.size(), expectedRuns.size());
+  for (size_t i = 0; (i < runs.size()) && (i < expectedRuns.size()); i++)
+  {
+    OFCHECK_EQUAL(runs[i].start, expectedRuns[i].start);
+    OFCHECK_EQUAL(runs[i].length, expectedRuns[i].length);
+  }
+}
+
+static DcmSegmentation* createSegmentation()
+{
+  DcmSegmentation* seg = NULL;
+  IODGeneralEquipmentModule::EquipmentInfo equipment("Manufacturer", "Model", "SerialNo", "1.0");
+  ContentIdentificationMacro content("1", "LABEL", "Description", "Creator");
+  OFCHECK(DcmSegmentation::createBinarySegmentation(seg, ROWS, COLS, equipment, content).good());
+  if (seg == NULL)
+    return NULL;
+  OFCHECK(seg->getSegmentationSeriesModule().setSeriesNumber("1").good());
+  char uid[100];
+  OFCHECK(seg->getFrameOfReference().setFrameOfReferenceUID(dcmGenerateUniqueIdentifier(uid)).good());
+  OFString dimUID(dcmGenerateUniqueIdentifier(uid));
+  OFCHECK(seg->getDimensions().addDimensionIndex(DCM_ReferencedSegmentNumber, dimUID, DCM_SegmentIdentificationSequence).good());
+  OFCHECK(seg->getDimensions().addDimensionIndex(DCM_ImagePositionPatient, dimUID, DCM_PlanePositionSequence).good());
+  CodeSequenceMacro category("85756007", "SCT", "Tissue");
+  CodeSequenceMacro type("85756007", "SCT", "Tissue");
+  for (Uint16 count = 0; count < 2; count++)
+  {
+    DcmSegment* segment = NULL;
+    Uint16 segmentNumber = 0;
+    OFCHECK(DcmSegment::create(segment, "Segment", category, type, DcmSegTypes::SAT_MANUAL).good());
+    OFCHECK(seg->addSegment(segment, segmentNumber).good());
+    OFCHECK_EQUAL(segmentNumber, count + 1);
+  }
+  FGPixelMeasures pixMsr;
+  OFCHECK(pixMsr.setPixelSpacing("1\\1").good());
+  OFCHECK(pixMsr.setSliceThickness("1").good());
+  OFCHECK(seg->addForAllFrames(pixMsr).good());
+  FGPlaneOrientationPatient planOr;
+  OFCHECK(planOr.setImageOrientationPatient("1", "0", "0", "0", "1", "0").good());
+  OFCHECK(seg->addForAllFrames(planOr).good());
+  for (size_t frameNo = 0; frameNo < NUM_FRAMES; frameNo++)
+  {
+    OFCHECK(addFrame(*seg, frameNo).good());
+  }
+  return seg;
+}
+
+
+OFTEST(dcmseg_frames)
+{
+  DcmSegmentation* seg = createSegmentation();
+  OFCHECK(seg != NULL);
+  if (seg == NULL)
+    return;
+  // Frames added are kept as runs of set pixels
+  OFVector<DcmSegTypes::PixelRun> runs;
+  OFCHECK(seg->getFrameRuns(2, runs).good());
+  OFCHECK_EQUAL(runs.size(), 3);
+  checkFrame(*seg, 2);
+  OFVector<size_t> frames;
+  seg->getFramesForSegment(2, frames);
+  OFCHECK_EQUAL(frames.size(), 2);
+  DcmDataset original;
+  OFCHECK(seg->writeDataset(original).good());
+  delete seg;
+
+  // Read the object again, frames are extracted on demand
+  DcmSegmentation* read = NULL;
+  OFCHECK(DcmSegmentation::loadDataset(original, read).good());
+  OFCHECK(read != NULL);
+  if (read == NULL)
+    return;
+  OFCHECK_EQUAL(read->getNumberOfFrames(), NUM_FRAMES);
+  frames.clear();
+  read->getFramesForSegment(1, frames);
+  OFCHECK_EQUAL(frames.size(), 3);
+  if (frames.size() == 3)
+  {
+    OFCHECK_EQUAL(frames[0], 0);
+    OFCHECK_EQUAL(frames[1], 2);
+    OFCHECK_EQUAL(frames[2], 4);
+  }
+  frames.clear();
+  read->getFramesForSegment(3, frames);
+  OFCHECK(frames.empty());
+  checkFrame(*read, 3);
+  checkFrame(*read, 1);
+  checkFrame(*read, 4);
+  OFCHECK(read->getFrame(NUM_FRAMES) == NULL);
+
+  // Writing without adding frames results in the same pixel data
+  DcmDataset unchanged;
+  OFCHECK(read->writeDataset(unchanged).good());
+  const Uint8* origPixels = NULL;
+  const Uint8* newPixels = NULL;
+  unsigned long origLength = 0;
+  unsigned long newLength = 0;
+  OFCHECK(original.findAndGetUint8Array(DCM_PixelData, origPixels, &origLength).good());
+  OFCHECK(unchanged.findAndGetUint8Array(DCM_PixelData, newPixels, &newLength).good());
+  OFCHECK_EQUAL(origLength, newLength);
+  OFCHECK(origLength == newLength && memcmp(origPixels, newPixels, origLength) == 0);
+
+  // Add another frame, so that frames read and added are written together
+  OFCHECK(addFrame(*read, NUM_FRAMES).good());
+  frames.clear();
+  read->getFramesForSegment(2, frames);
+  OFCHECK(frames.size() == 3 && frames[2] == NUM_FRAMES);
+  DcmDataset extended;
+  OFCHECK(read->writeDataset(extended).good());
+  delete read;
+  read = NULL;
+  OFCHECK(DcmSegmentation::loadDataset(extended, read).good());
+  OFCHECK(read != NULL);
+  if (read == NULL)
+    return;
+  OFCHECK_EQUAL(read->getNumberOfFrames(), NUM_FRAMES + 1);
+  for (size_t frameNo = 0; frameNo <= NUM_FRAMES; frameNo++)
+  {
+    checkFrame(*read, frameNo);
+  }
+  delete read;
+}
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2015-2018, OFFIS e.V.
+ *  Copyright (C) 2015-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -71,3 +71,114 @@ OFTEST(dcmseg_utils)
   OFCHECK(buf[3] == 0);
 
 }
+
+
+OFTEST(dcmseg_packBits)
+{
+  // 21 pixels, i.e. two full bytes and 5 bits of a third byte
+  const size_t numPixels = 21;
+  Uint8 pixels[numPixels];
+  for (size_t i = 0; i < numPixels; i++)
+    pixels[i] = (i % 3 == 0) ? 1 : 0;
+  pixels[4] = 255; // every non-zero value is "set"
+
+  Uint8 packed[3];
+  OFCHECK_EQUAL(DcmSegUtils::getBytesForBinaryFrame(numPixels), 3);
+  DcmSegUtils::packBits(pixels, numPixels, packed);
+  OFCHECK(packed[0] == 89);  // 01011001
+  OFCHECK(packed[1] == 146); // 10010010
+  OFCHECK(packed[2] == 4);   // 00000100 (unused bits zeroed)
+
+  Uint8 unpacked[numPixels];
+  DcmSegUtils::unpackBits(packed, numPixels, unpacked);
+  for (size_t i = 0; i < numPixels; i++)
+    OFCHECK_EQUAL(unpacked[i], (pixels[i] != 0) ? 1 : 0);
+
+  // Frame-based functions use the same format
+  DcmIODTypes::Frame* frame = DcmSegUtils::packBinaryFrame(pixels, 3, 7);
+  OFCHECK(frame != NULL);
+  if (frame != NULL)
+  {
+    OFCHECK_EQUAL(frame->length, 3);
+    OFCHECK(memcmp(frame->pixData, packed, 3) == 0);
+    DcmIODTypes::Frame* result = DcmSegUtils::unpackBinaryFrame(frame, 3, 7);
+    OFCHECK(result != NULL);
+    if (result != NULL)
+    {
+      OFCHECK(memcmp(result->pixData, unpacked, numPixels) == 0);
+      delete result;
+    }
+    delete frame;
+  }
+}
+
+
+OFTEST(dcmseg_pixelRuns)
+{
+  // 20 pixels: runs at 0-1, 5, 8-17 (crossing two byte boundaries) and 19
+  const size_t numPixels = 20;
+  Uint8 pixels[numPixels];
+  memset(pixels, 0, numPixels);
+  pixels[0] = pixels[1] = pixels[5] = pixels[19] = 1;
+  for (size_t i = 8; i <= 17; i++)
+    pixels[i] = 1;
+
+  OFVector<DcmSegTypes::PixelRun> runs;
+  DcmSegUtils::getRunsFromPixels(pixels, numPixels, runs);
+  OFCHECK_EQUAL(runs.size(), 4);
+  if (runs.size() == 4)
+  {
+    OFCHECK(runs[0].start == 0 && runs[0].length == 2);
+    OFCHECK(runs[1].start == 5 && runs[1].length == 1);
+    OFCHECK(runs[2].start == 8 && runs[2].length == 10);
+    OFCHECK(runs[3].start == 19 && runs[3].length == 1);
+  }
+
+  // Set bits at an offset not aligned to a byte boundary and read them back
+  Uint8 packed[4];
+  memset(packed, 0, sizeof(packed));
+  DcmSegUtils::setBitsFromRuns(runs, packed, 3);
+  Uint8 expected[4];
+  memset(expected, 0, sizeof(expected));
+  Uint8 shiftedPixels[32];
+  memset(shiftedPixels, 0, sizeof(shiftedPixels));
+  memcpy(shiftedPixels + 3, pixels, numPixels);
+  DcmSegUtils::packBits(shiftedPixels, 32, expected);
+  OFCHECK(memcmp(packed, expected, sizeof(packed)) == 0);
+
+  OFVector<DcmSegTypes::PixelRun> result;
+  DcmSegUtils::getRunsFromBits(packed, 3, numPixels, result);
+  OFCHECK_EQUAL(result.size(), runs.size());
+  for (size_t i = 0; (i < result.size()) && (i < runs.size()); i++)
+  {
+    OFCHECK_EQUAL(result[i].start, runs[i].start);
+    OFCHECK_EQUAL(result[i].length, runs[i].length);
+  }
+
+  // Reading from the start of the buffer yields the runs shifted by the offset
+  OFVector<DcmSegTypes::PixelRun> shifted(runs);
+  for (size_t i = 0; i < shifted.size(); i++)
+    shifted[i].start += 3;
+  DcmSegUtils::getRunsFromBits(packed, 0, numPixels + 3, result);
+  OFCHECK_EQUAL(result.size(), shifted.size());
+  for (size_t i = 0; (i < result.size()) && (i < shifted.size()); i++)
+  {
+    OFCHECK_EQUAL(result[i].start, shifted[i].start);
+    OFCHECK_EQUAL(result[i].length, shifted[i].length);
+  }
+
+  // Packing runs results in the same frame as packing the pixels
+  DcmIODTypes::Frame* fromRuns = DcmSegUtils::packBinaryFrame(runs, 4, 5);
+  DcmIODTypes::Frame* fromPixels = DcmSegUtils::packBinaryFrame(pixels, 4, 5);
+  OFCHECK(fromRuns != NULL && fromPixels != NULL);
+  if (fromRuns != NULL && fromPixels != NULL)
+  {
+    OFCHECK_EQUAL(fromRuns->length, fromPixels->length);
+    OFCHECK(memcmp(fromRuns->pixData, fromPixels->pixData, fromPixels->length) == 0);
+  }
+  delete fromRuns;
+  delete fromPixels;
+
+  // Runs exceeding the frame are rejected
+  OFCHECK(DcmSegUtils::packBinaryFrame(runs, 4, 4) == NULL);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2000-2018, OFFIS e.V.
+ *  Copyright (C) 2000-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -36,6 +36,10 @@
 #include <zlib.h>                     /* for zlibVersion() */
 #endif
 
+#if defined (HAVE_WINDOWS_H) || defined(HAVE_FNMATCH_H)
+#define PATTERN_MATCHING_AVAILABLE
+#endif
+
 #define OFFIS_CONSOLE_APPLICATION "dcmsign"
 
 static char rcsid[] = "$dcmtk: " OFFIS_CONSOLE_APPLICATION " v"
@@ -62,7 +66,9 @@ static OFLogger dcmsignLogger = OFLog::getLogger("dcmtk.apps." OFFIS_CONSOLE_APP
 #include "dcmtk/dcmsign/siripemd.h"
 #include "dcmtk/dcmsign/siprivat.h"
 #include "dcmtk/dcmsign/sicert.h"
+#include "dcmtk/dcmsign/sibatchv.h"
 #include "dcmtk/dcmdata/dctk.h"
+#include "dcmtk/ofstd/ofstd.h"
 
 
 BEGIN_EXTERN_C
@@ -686,6 +692,54 @@ static int do_remove(
   return 1;
 }
 
+/* verify all signatures of all files in the given directory, print a summary per file.
+ * @param dirName directory to be scanned for DICOM files
+ * @param pattern pattern for filename matching, empty for all files
+ * @param recurse flag indicating whether to recurse into subdirectories
+ * @param numThreads number of threads used for verifying the files
+ * @return 0 if all files could be loaded and verified successfully, a program exit code otherwise
+ */
+static int do_verify_batch(
+  const char *dirName,
+  const OFString& pattern,
+  OFBool recurse,
+  unsigned int numThreads)
+{
+  if (!OFStandard::dirExists(dirName))
+  {
+    OFLOG_FATAL(dcmsignLogger, "directory does not exist: " << dirName);
+    return 1;
+  }
+  OFList<OFString> fileList;
+  OFStandard::searchDirectoryRecursively(dirName, fileList, pattern, "" /* dirPrefix */, recurse);
+  OFLOG_INFO(dcmsignLogger, "found " << fileList.size() << " files in directory " << dirName);
+
+  SiBatchVerifier verifier;
+  for (OFListIterator(OFString) it = fileList.begin(); it != fileList.end(); ++it)
+    verifier.addFile(*it);
+  verifier.setNumberOfThreads(numThreads);
+  verifier.verify();
+
+  for (size_t i = 0; i < verifier.getNumberOfFiles(); i++)
+  {
+    const OFFilename& filename = verifier.getFilename(i);
+    const OFCondition status = verifier.getFileStatus(i);
+    const unsigned long counter = verifier.getNumberOfSignatures(i);
+    if (status.bad() && (counter == 0))
+      OFLOG_ERROR(dcmsignLogger, filename << ": " << status.text());
+    else if (status.bad())
+      OFLOG_ERROR(dcmsignLogger, filename << ": " << counter << " signatures verified, "
+        << verifier.getNumberOfCorruptSignatures(i) << " corrupted (" << status.text() << ")");
+    else if (counter == 0)
+      OFLOG_WARN(dcmsignLogger, filename << ": no signatures found");
+    else
+      OFLOG_INFO(dcmsignLogger, filename << ": " << counter << " signatures verified, 0 corrupted");
+  }
+  const size_t failures = verifier.getNumberOfFailedFiles();
+  OFLOG_INFO(dcmsignLogger, verifier.getNumberOfFiles() << " files verified, " << failures << " failed.");
+  return (failures > 0) ? 1 : 0;
+}
+
 
 #define SHORTCOL 4
 #define LONGCOL 21
@@ -716,6 +770,10 @@ int main(int argc, char *argv[])
   DcmAttributeTag *             opt_tagList = NULL; // list of attribute tags
   E_TransferSyntax              opt_signatureXfer = EXS_Unknown;
   FILE *                        opt_dumpFile = NULL;
+  OFBool                        opt_scanDir = OFFalse;   // verify all files in a directory
+  OFString                      opt_scanPattern;
+  OFBool                        opt_recurse = OFFalse;
+  OFCmdUnsignedInt              opt_threads = 1;
   int result = 0;
 
   OFConsoleApplication app(OFFIS_CONSOLE_APPLICATION , APPLICATION_ABSTRACT, rcsid);
@@ -723,7 +781,7 @@ int main(int argc, char *argv[])
   cmd.setOptionColumns(LONGCOL, SHORTCOL);
   cmd.setParamColumn(LONGCOL + SHORTCOL + 4);
 
-  cmd.addParam("dcmfile-in",  "DICOM input filename to be processed");
+  cmd.addParam("dcmfile-in",  "DICOM input filename to be processed\n(or directory, if --scan-directories is given)");
   cmd.addParam("dcmfile-out", "DICOM output filename", OFCmdParam::PM_Optional);
 
   cmd.addGroup("general options:", LONGCOL, SHORTCOL + 2);
@@ -752,6 +810,19 @@ int main(int argc, char *argv[])
       cmd.addOption("--remove",                    "+r",     1, "[s]ignature UID: string", "remove signature");
       cmd.addOption("--remove-all",                "+ra",       "remove all signatures from data set");
 
+  cmd.addGroup("batch verification options (only with --verify):");
+      cmd.addOption("--scan-directories",          "+sd",       "verify all files in directory dcmfile-in");
+#ifdef PATTERN_MATCHING_AVAILABLE
+      cmd.addOption("--scan-pattern",              "+sp",    1, "[p]attern: string (only with --scan-directories)",
+                                                                "pattern for filename matching (wildcards)");
+#endif
+      cmd.addOption("--no-recurse",                             "do not recurse within directories (default)");
+      cmd.addOption("--recurse",                                "recurse within specified directories");
+#ifdef WITH_THREADS
+      cmd.addOption("--threads",                   "+pt",    1, "[n]umber: integer (1..64, default: 1)",
+                                                                "use n threads for verifying files");
+#endif
+
   cmd.addGroup("signature creation options (only with --sign or --sign-item):");
     cmd.addSubGroup("private key password:");
       cmd.addOption("--std-passwd",               "+ps",        "prompt user to type password on stdin (default)");
@@ -890,6 +961,38 @@ int main(int argc, char *argv[])
 
     if ((opt_operation == DSO_verify) && opt_ofname) app.printError("parameter dcmfile-out not allowed for --verify");
 
+    if (cmd.findOption("--scan-directories"))
+    {
+      app.checkDependence("--scan-directories", "--verify", opt_operation == DSO_verify);
+      opt_scanDir = OFTrue;
+    }
+#ifdef PATTERN_MATCHING_AVAILABLE
+    if (cmd.findOption("--scan-pattern"))
+    {
+      app.checkDependence("--scan-pattern", "--scan-directories", opt_scanDir);
+      app.checkValue(cmd.getValue(opt_scanPattern));
+    }
+#endif
+    cmd.beginOptionBlock();
+    if (cmd.findOption("--no-recurse"))
+    {
+      app.checkDependence("--no-recurse", "--scan-directories", opt_scanDir);
+      opt_recurse = OFFalse;
+    }
+    if (cmd.findOption("--recurse"))
+    {
+      app.checkDependence("--recurse", "--scan-directories", opt_scanDir);
+      opt_recurse = OFTrue;
+    }
+    cmd.endOptionBlock();
+#ifdef WITH_THREADS
+    if (cmd.findOption("--threads"))
+    {
+      app.checkDependence("--threads", "--scan-directories", opt_scanDir);
+      app.checkValue(cmd.getValueAndCheckMinMax(opt_threads, 1, 64));
+    }
+#endif
+
     cmd.beginOptionBlock();
     if (cmd.findOption("--std-passwd"))
     {
@@ -1047,6 +1150,12 @@ int main(int argc, char *argv[])
     return 1;
   }
 
+  if (opt_scanDir)
+  {
+    OFLOG_INFO(dcmsignLogger, "verifying all signatures of all files in directory " << opt_ifname);
+    return do_verify_batch(opt_ifname, opt_scanPattern, opt_recurse, OFstatic_cast(unsigned int, opt_threads));
+  }
+
   OFLOG_INFO(dcmsignLogger, "open input file " << opt_ifname);
 
   DcmFileFormat *fileformat = new DcmFileFormat;
@@ -0,0 +1,168 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module: dcmsign
+ *
+ *  Author: OFFIS e.V.
+ *
+ *  Purpose:
+ *    classes: SiBatchVerifier
+ *
+ */
+
+#ifndef SIBATCHV_H
+#define SIBATCHV_H
+
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmsign/sitypes.h"
+
+#ifdef WITH_OPENSSL
+
+#include "dcmtk/ofstd/offile.h"      /* for OFFilename */
+#include "dcmtk/ofstd/ofvector.h"
+
+/** a class that verifies all digital signatures contained in a batch of
+ *  DICOM files. The files are loaded and verified independently of each
+ *  other, optionally distributed over a number of threads.
+ *  @remark this class is only available if DCMTK is compiled with
+ *  OpenSSL support enabled.
+ */
+class DCMTK_DCMSIGN_EXPORT SiBatchVerifier
+{
+public:
+
+  /// default constructor
+  SiBatchVerifier();
+
+  /// destructor
+  virtual ~SiBatchVerifier();
+
+  /** adds a DICOM file to the batch. The results of a previous call
+   *  to verify() for this file are not available anymore.
+   *  @param filename name of the DICOM file
+   */
+  void addFile(const OFFilename& filename);
+
+  /** removes all files and results from the batch.
+   */
+  void clear();
+
+  /** sets the number of threads used by verify(). A value of 0 or 1
+   *  means that all files are verified sequentially by the calling thread.
+   *  If DCMTK is compiled without thread support, this setting is ignored.
+   *  @param numberOfThreads number of threads, default: 1
+   */
+  void setNumberOfThreads(unsigned int numberOfThreads);
+
+  /** loads all files of the batch and verifies all digital signatures
+   *  contained in them, including the signatures in nested items.
+   *  The results are available per file, see getFileStatus().
+   *  @return EC_Normal if all files could be loaded and all signatures
+   *    were verified successfully, the status of the first failed file otherwise
+   */
+  OFCondition verify();
+
+  /** returns the number of files in the batch.
+   *  @return number of files
+   */
+  size_t getNumberOfFiles() const;
+
+  /** returns the name of the given file.
+   *  @param idx index of the file, must be < getNumberOfFiles()
+   *  @return name of the file
+   */
+  const OFFilename& getFilename(size_t idx) const;
+
+  /** returns the result of the verification of the given file, i.e.
+   *  the error code when loading the file or the result of the first
+   *  signature that could not be verified. A file without signatures
+   *  is not considered an error.
+   *  @param idx index of the file, must be < getNumberOfFiles()
+   *  @return status of the file, EC_IllegalCall if verify() was not called yet
+   */
+  OFCondition getFileStatus(size_t idx) const;
+
+  /** returns the number of signatures found in the given file.
+   *  @param idx index of the file, must be < getNumberOfFiles()
+   *  @return number of signatures
+   */
+  unsigned long getNumberOfSignatures(size_t idx) const;
+
+  /** returns the number of signatures in the given file that could not
+   *  be verified.
+   *  @param idx index of the file, must be < getNumberOfFiles()
+   *  @return number of corrupted signatures
+   */
+  unsigned long getNumberOfCorruptSignatures(size_t idx) const;
+
+  /** returns the number of files that could not be loaded or contain
+   *  at least one signature that could not be verified.
+   *  @return number of failed files
+   */
+  size_t getNumberOfFailedFiles() const;
+
+  /** loads a single DICOM file and verifies all digital signatures contained in it.
+   *  This method is used by verify() and may be called from multiple threads
+   *  in parallel.
+   *  @param filename name of the DICOM file
+   *  @param numSignatures returns the number of signatures found
+   *  @param numCorrupt returns the number of signatures that could not be verified
+   *  @return EC_Normal if successful, an error code otherwise
+   */
+  static OFCondition verifyFile(
+    const OFFilename& filename,
+    unsigned long& numSignatures,
+    unsigned long& numCorrupt);
+
+  /** result of the verification of a single file
+   */
+  struct FileEntry
+  {
+    /// default constructor
+    FileEntry();
+
+    /** constructor
+     *  @param filename name of the DICOM file
+     */
+    FileEntry(const OFFilename& filename);
+
+    /// name of the DICOM file
+    OFFilename Filename;
+
+    /// status of the verification
+    OFCondition Status;
+
+    /// number of signatures found in the file
+    unsigned long NumSignatures;
+
+    /// number of signatures that could not be verified
+    unsigned long NumCorrupt;
+  };
+
+private:
+
+  /// private undefined copy constructor
+  SiBatchVerifier(const SiBatchVerifier& arg);
+
+  /// private undefined copy assignment operator
+  SiBatchVerifier& operator=(const SiBatchVerifier& arg);
+
+  /// the files of the batch and their results
+  OFVector<FileEntry> files;
+
+  /// number of threads used by verify()
+  unsigned int numThreads;
+};
+
+#endif
+#endif
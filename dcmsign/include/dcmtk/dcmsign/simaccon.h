@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2018, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -16,7 +16,7 @@
  *  Author: Marco Eichelberg
  *
  *  Purpose:
- *    classes: SiMACConstructor
+ *    classes: SiMACConsumer, SiMACOutputStream, SiMACConstructor
  *
  */
 
@@ -28,7 +28,7 @@
 
 #ifdef WITH_OPENSSL
 
-#include "dcmtk/dcmdata/dcostrmb.h"  /* for DcmOutputBufferStream */
+#include "dcmtk/dcmdata/dcostrma.h"  /* for DcmOutputStream, DcmConsumer */
 #include "dcmtk/dcmdata/dcxfer.h"    /* for E_TransferSyntax */
 #include "dcmtk/dcmdata/dcdeftag.h"
 
@@ -40,6 +40,146 @@ class DcmItem;
 class DcmElement;
 class DcmAttributeTag;
 
+/** consumer class that feeds all data written to it directly into a MAC
+ *  codec (and optionally into a dump file). Small blocks, such as tag and
+ *  length fields, are collected in an internal buffer; large blocks, such as
+ *  the values of bulk data elements, are passed to the MAC without being
+ *  copied. Since the consumer never suspends, avail() always reports a large
+ *  amount of free space.
+ *  @remark this class is only available if DCMTK is compiled with
+ *  OpenSSL support enabled.
+ */
+class DCMTK_DCMSIGN_EXPORT SiMACConsumer: public DcmConsumer
+{
+public:
+
+  /// constructor
+  SiMACConsumer();
+
+  /// destructor
+  virtual ~SiMACConsumer();
+
+  /** sets the MAC codec into which all data is fed. If the MAC codec
+   *  changes, the status of the consumer is reset. The internal buffer
+   *  should be flushed before the MAC codec is changed.
+   *  @param mac pointer to MAC codec, may be NULL
+   */
+  void setMAC(SiMAC *mac);
+
+  /** dump all data that is fed into the MAC algorithm into the given file,
+   *  which must be opened and closed by caller.
+   *  @param f pointer to file already opened for writing; may be NULL.
+   */
+  void setDumpFile(FILE *f);
+
+  /** returns the status of the consumer. Unless the status is good,
+   *  the consumer will not permit any operation.
+   *  @return status, true if good
+   */
+  virtual OFBool good() const;
+
+  /** returns the status of the consumer as an OFCondition object.
+   *  Unless the status is good, the consumer will not permit any operation.
+   *  @return status, EC_Normal if good
+   */
+  virtual OFCondition status() const;
+
+  /** returns true if the consumer is flushed, i.e. has no more data
+   *  pending in it's internal buffer that still needs to be fed into the MAC.
+   *  @return true if consumer is flushed, false otherwise
+   */
+  virtual OFBool isFlushed() const;
+
+  /** returns the minimum number of bytes that can be written with the
+   *  next call to write(). Since data is passed to the MAC immediately,
+   *  this is always a large constant value.
+   *  @return minimum of space available in consumer
+   */
+  virtual offile_off_t avail() const;
+
+  /** processes the given input block. Blocks that are at least as large
+   *  as the internal buffer are fed into the MAC without copying.
+   *  @param buf pointer to memory block, must not be NULL
+   *  @param buflen length of memory block
+   *  @return number of bytes actually processed.
+   */
+  virtual offile_off_t write(const void *buf, offile_off_t buflen);
+
+  /** feeds the content of the internal buffer into the MAC codec.
+   */
+  virtual void flush();
+
+private:
+
+  /// private unimplemented copy constructor
+  SiMACConsumer(const SiMACConsumer&);
+
+  /// private unimplemented copy assignment operator
+  SiMACConsumer& operator=(const SiMACConsumer&);
+
+  /** feeds the given block into the MAC and the dump file, if any.
+   *  @param data pointer to memory block
+   *  @param length length of memory block
+   */
+  void digest(const unsigned char *data, offile_off_t length);
+
+  /// the MAC codec, not owned by this object
+  SiMAC *mac_;
+
+  /// if nonzero, the data fed to the MAC algorithm is also stored in this file
+  FILE *dumpFile_;
+
+  /// buffer for small blocks
+  unsigned char *buffer_;
+
+  /// number of bytes filled in buffer
+  offile_off_t filled_;
+
+  /// status
+  OFCondition status_;
+};
+
+
+/** output stream that feeds all data written into a MAC codec,
+ *  see class SiMACConsumer.
+ *  @remark this class is only available if DCMTK is compiled with
+ *  OpenSSL support enabled.
+ */
+class DCMTK_DCMSIGN_EXPORT SiMACOutputStream: public DcmOutputStream
+{
+public:
+
+  /// constructor
+  SiMACOutputStream();
+
+  /// destructor
+  virtual ~SiMACOutputStream();
+
+  /** sets the MAC codec into which all data is fed.
+   *  @param mac pointer to MAC codec, may be NULL
+   */
+  void setMAC(SiMAC *mac);
+
+  /** dump all data that is fed into the MAC algorithm into the given file,
+   *  which must be opened and closed by caller.
+   *  @param f pointer to file already opened for writing; may be NULL.
+   */
+  void setDumpFile(FILE *f);
+
+private:
+
+  /// private unimplemented copy constructor
+  SiMACOutputStream(const SiMACOutputStream&);
+
+  /// private unimplemented copy assignment operator
+  SiMACOutputStream& operator=(const SiMACOutputStream&);
+
+  /// the final consumer of the filter chain
+  SiMACConsumer consumer_;
+
+};
+
+
 /** a class that allows to feed selected parts of a DICOM dataset into the MAC generation code
  *  @remark this class is only available if DCMTK is compiled with
  *  OpenSSL support enabled.
@@ -124,7 +264,8 @@ private:
   /// private undefined copy assignment operator
   SiMACConstructor& operator=(SiMACConstructor& arg);
 
-  /** flushes the internal buffer to the given MAC and to dumpFile if open
+  /** flushes the internal buffer of the stream to the given MAC and to
+   *  the dump file if open
    *  @param mac MAC to which the buffer content is added
    *  @return error code from MAC
    */
@@ -149,16 +290,8 @@ private:
    */
   static OFBool inTagList(const DcmElement *element, DcmAttributeTag *tagList);
 
-  /// the buffer to which data is written
-  unsigned char *buf;
-
-  /// the internal buffer stream
-  DcmOutputBufferStream stream;
-  
-  /** if nonzero, the data fed to the MAC algorithm
-   *  is also stored in this file.
-   */
-  FILE *dumpFile;
+  /// the stream feeding all data into the MAC codec
+  SiMACOutputStream stream;
 };
 
 
@@ -0,0 +1,284 @@
+/*
+ *
+ *  Copyright (C) 2026, OFFIS e.V.
+ *  All rights reserved.  See COPYRIGHT file for details.
+ *
+ *  This software and supporting documentation were developed by
+ *
+ *    OFFIS e.V.
+ *    R&D Division Health
+ *    Escherweg 2
+ *    D-26121 Oldenburg, Germany
+ *
+ *
+ *  Module: dcmsign
+ *
+ *  Author: OFFIS e.V.
+ *
+ *  Purpose:
+ *    classes: SiBatchVerifier
+ *
+ */
+
+#include "dcmtk/config/osconfig.h"
+
+#ifdef WITH_OPENSSL
+
+#include "dcmtk/dcmsign/sibatchv.h"
+#include "dcmtk/dcmsign/dcsignat.h"
+#include "dcmtk/dcmdata/dcfilefo.h"
+#include "dcmtk/dcmdata/dcstack.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
+
+
+SiBatchVerifier::FileEntry::FileEntry()
+: Filename()
+, Status(EC_IllegalCall)
+, NumSignatures(0)
+, NumCorrupt(0)
+{
+}
+
+
+SiBatchVerifier::FileEntry::FileEntry(const OFFilename& filename)
+: Filename(filename)
+, Status(EC_IllegalCall)
+, NumSignatures(0)
+, NumCorrupt(0)
+{
+}
+
+
+#ifdef WITH_THREADS
+
+/** worker thread that verifies the files of a SiBatchVerifier.
+ *  All workers share the index of the next file to be verified.
+ *  Each result is written only by the thread that verified the file.
+ */
+class SiBatchVerifierWorker : public OFThread
+{
+public:
+
+  /** constructor
+   *  @param files files to be verified
+   *  @param nextFile index of the next file to be verified (protected by mutex)
+   *  @param mutex mutex protecting nextFile
+   */
+  SiBatchVerifierWorker(
+    OFVector<SiBatchVerifier::FileEntry>& files,
+    size_t& nextFile,
+    OFMutex& mutex)
+  : OFThread()
+  , files_(files)
+  , nextFile_(nextFile)
+  , mutex_(mutex)
+  {
+  }
+
+protected:
+
+  /** verify files until all files are processed
+   */
+  virtual void run()
+  {
+    for (;;)
+    {
+      mutex_.lock();
+      const size_t index = nextFile_;
+      if (index < files_.size()) ++nextFile_;
+      mutex_.unlock();
+      if (index >= files_.size()) break;
+      SiBatchVerifier::FileEntry& entry = files_[index];
+      entry.Status = SiBatchVerifier::verifyFile(entry.Filename, entry.NumSignatures, entry.NumCorrupt);
+    }
+  }
+
+private:
+
+  /// files to be verified
+  OFVector<SiBatchVerifier::FileEntry>& files_;
+
+  /// index of the next file to be verified
+  size_t& nextFile_;
+
+  /// mutex protecting nextFile_
+  OFMutex& mutex_;
+};
+
+#endif
+
+
+SiBatchVerifier::SiBatchVerifier()
+: files()
+, numThreads(1)
+{
+}
+
+
+SiBatchVerifier::~SiBatchVerifier()
+{
+}
+
+
+void SiBatchVerifier::addFile(const OFFilename& filename)
+{
+  files.push_back(FileEntry(filename));
+}
+
+
+void SiBatchVerifier::clear()
+{
+  files.clear();
+}
+
+
+void SiBatchVerifier::setNumberOfThreads(unsigned int numberOfThreads)
+{
+  numThreads = numberOfThreads;
+}
+
+
+OFCondition SiBatchVerifier::verifyFile(
+  const OFFilename& filename,
+  unsigned long& numSignatures,
+  unsigned long& numCorrupt)
+{
+  numSignatures = 0;
+  numCorrupt = 0;
+  DcmFileFormat fileformat;
+  OFCondition result = fileformat.loadFile(filename);
+  if (result.bad())
+  {
+    DCMSIGN_WARN("cannot load file " << filename << ": " << result.text());
+    return result;
+  }
+  DcmItem *dataset = fileformat.getDataset();
+  DcmStack stack;
+  DcmSignature signer;
+  OFCondition sicond;
+  unsigned long numSigItem = 0;
+  DcmItem *sigItem = DcmSignature::findFirstSignatureItem(*dataset, stack);
+  while (sigItem)
+  {
+    signer.attach(sigItem);
+    numSigItem = signer.numberOfSignatures();
+    for (unsigned long l = 0; l < numSigItem; l++)
+    {
+      if (signer.selectSignature(l).good())
+      {
+        ++numSignatures;
+        sicond = signer.verifyCurrent();
+        if (sicond.bad())
+        {
+          ++numCorrupt;
+          DCMSIGN_DEBUG("signature #" << numSignatures << " in file " << filename << " could not be verified: " << sicond.text());
+          if (result.good()) result = sicond;
+        }
+      }
+    }
+    signer.detach();
+    sigItem = DcmSignature::findNextSignatureItem(*dataset, stack);
+  }
+  return result;
+}
+
+
+OFCondition SiBatchVerifier::verify()
+{
+  const size_t count = files.size();
+  OFBool done = OFFalse;
+#ifdef WITH_THREADS
+  if ((numThreads > 1) && (count > 1))
+  {
+    size_t nextFile = 0;
+    OFMutex mutex;
+    OFVector<SiBatchVerifierWorker *> workers;
+    for (unsigned int i = 0; (i < numThreads) && (i < count); ++i)
+    {
+      SiBatchVerifierWorker *worker = new SiBatchVerifierWorker(files, nextFile, mutex);
+      if (worker->start() == 0)
+        workers.push_back(worker);
+      else
+        delete worker;
+    }
+    if (!workers.empty())
+    {
+      DCMSIGN_DEBUG("verifying " << count << " files with " << workers.size() << " thread(s)");
+      done = OFTrue;
+    }
+    else
+    {
+      DCMSIGN_WARN("cannot start threads, verifying files sequentially");
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+      workers[i]->join();
+      delete workers[i];
+    }
+    // if no thread could be started, the files are verified below
+  }
+#endif
+  OFCondition result = EC_Normal;
+  for (size_t i = 0; i < count; ++i)
+  {
+    FileEntry& entry = files[i];
+    if (!done)
+      entry.Status = verifyFile(entry.Filename, entry.NumSignatures, entry.NumCorrupt);
+    if (entry.Status.bad() && result.good())
+      result = entry.Status;
+  }
+  return result;
+}
+
+
+size_t SiBatchVerifier::getNumberOfFiles() const
+{
+  return files.size();
+}
+
+
+const OFFilename& SiBatchVerifier::getFilename(size_t idx) const
+{
+  return files[idx].Filename;
+}
+
+
+OFCondition SiBatchVerifier::getFileStatus(size_t idx) const
+{
+  if (idx >= files.size()) return EC_IllegalParameter;
+  return files[idx].Status;
+}
+
+
+unsigned long SiBatchVerifier::getNumberOfSignatures(size_t idx) const
+{
+  if (idx >= files.size()) return 0;
+  return files[idx].NumSignatures;
+}
+
+
+unsigned long SiBatchVerifier::getNumberOfCorruptSignatures(size_t idx) const
+{
+  if (idx >= files.size()) return 0;
+  return files[idx].NumCorrupt;
+}
+
+
+size_t SiBatchVerifier::getNumberOfFailedFiles() const
+{
+  size_t result = 0;
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    if (files[i].Status.bad()) ++result;
+  }
+  return result;
+}
+
+#else /* WITH_OPENSSL */
+
+int sibatchv_cc_dummy_to_keep_linker_from_moaning = 0;
+
+#endif
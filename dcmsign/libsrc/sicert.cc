@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2016, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -86,24 +86,27 @@ SiAlgorithm *SiCertificate::createAlgorithmForPublicKey()
 {
   if (x509)
   {
-    EVP_PKEY *pkey = X509_extract_key(x509);
+    SiAlgorithm *result = NULL;
+    EVP_PKEY *pkey = X509_extract_key(x509); // creates copy of public key
     if (pkey)
     {
       switch(EVP_PKEY_id(pkey))
       {
         case EVP_PKEY_RSA:
-          return new SiRSA(EVP_PKEY_get1_RSA(pkey));
-          /* break; */
+          result = new SiRSA(EVP_PKEY_get1_RSA(pkey));
+          break;
         case EVP_PKEY_DSA:
-          return new SiDSA(EVP_PKEY_get1_DSA(pkey));
-          /* break; */
+          result = new SiDSA(EVP_PKEY_get1_DSA(pkey));
+          break;
         case EVP_PKEY_DH:
         default:
           /* nothing */
           break;
       }
+      // the algorithm object holds its own reference to the key
       EVP_PKEY_free(pkey);
-    }    
+    }
+    return result;
   }
   return NULL;
 }
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2019, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -16,7 +16,7 @@
  *  Author: Marco Eichelberg
  *
  *  Purpose:
- *    classes: SiMACConstructor
+ *    classes: SiMACConsumer, SiMACOutputStream, SiMACConstructor
  *
  */
 
@@ -30,50 +30,170 @@
 #include "dcmtk/dcmdata/dcvrat.h"
 #include "dcmtk/dcmdata/dcwcache.h"
 
+#define INCLUDE_CSTRING
+#include "dcmtk/ofstd/ofstdinc.h"
+
 // block size used for the memory buffer
-#define SiMACConstructor_BlockSize 16384
+#define SiMACConsumer_BlockSize 16384
 
+// amount of space reported as available by SiMACConsumer
+#define SiMACConsumer_Avail 0x40000000
 
-SiMACConstructor::SiMACConstructor()
-: buf(new unsigned char[SiMACConstructor_BlockSize])
-, stream(buf, SiMACConstructor_BlockSize)
-, dumpFile(NULL)
+
+SiMACConsumer::SiMACConsumer()
+: DcmConsumer()
+, mac_(NULL)
+, dumpFile_(NULL)
+, buffer_(new unsigned char[SiMACConsumer_BlockSize])
+, filled_(0)
+, status_(EC_Normal)
 {
 }
 
 
-SiMACConstructor::~SiMACConstructor()
+SiMACConsumer::~SiMACConsumer()
 {
-  delete[] buf;
+  delete[] buffer_;
 }
 
-void SiMACConstructor::setDumpFile(FILE *f)
+
+void SiMACConsumer::setMAC(SiMAC *mac)
 {
-  dumpFile = f;
+  if (mac != mac_)
+  {
+    mac_ = mac;
+    status_ = EC_Normal;
+  }
 }
 
 
-OFCondition SiMACConstructor::flushBuffer(SiMAC& mac)
+void SiMACConsumer::setDumpFile(FILE *f)
 {
-  OFCondition result = EC_Normal;
-  void *bufptr = NULL;
-  offile_off_t bufLen = 0;
-  stream.flushBuffer(bufptr, bufLen);
-  if (bufLen > 0)
+  dumpFile_ = f;
+}
+
+
+OFBool SiMACConsumer::good() const
+{
+  return status_.good();
+}
+
+
+OFCondition SiMACConsumer::status() const
+{
+  return status_;
+}
+
+
+OFBool SiMACConsumer::isFlushed() const
+{
+  return (filled_ == 0);
+}
+
+
+offile_off_t SiMACConsumer::avail() const
+{
+  if (status_.good()) return SiMACConsumer_Avail; else return 0;
+}
+
+
+void SiMACConsumer::digest(const unsigned char *data, offile_off_t length)
+{
+  if (dumpFile_)
   {
-    if (dumpFile)
+    if (fwrite(data, 1, OFstatic_cast(size_t, length), dumpFile_) != OFstatic_cast(size_t, length))
     {
-      if (fwrite(bufptr, 1, OFstatic_cast(size_t, bufLen), dumpFile) != OFstatic_cast(size_t, bufLen))
-      {
-        // We are apparently unable to write the byte stream to a dump file.
-        // This does not prevent us, however, from creating a valid digital signature.
-        // Therefore, issue a warning but continue.
-        DCMSIGN_WARN("Write error while dumping byte stream to file");
-      }
+      // We are apparently unable to write the byte stream to a dump file.
+      // This does not prevent us, however, from creating a valid digital signature.
+      // Therefore, issue a warning but continue.
+      DCMSIGN_WARN("Write error while dumping byte stream to file");
     }
-    result = mac.digest((unsigned char *)bufptr, (unsigned long)bufLen);
   }
-  return result;
+  if (mac_) status_ = mac_->digest(data, OFstatic_cast(unsigned long, length));
+  else status_ = EC_IllegalCall;
+}
+
+
+offile_off_t SiMACConsumer::write(const void *buf, offile_off_t buflen)
+{
+  if (status_.bad() || (buf == NULL) || (buflen <= 0)) return 0;
+  if (buflen > SiMACConsumer_Avail) buflen = SiMACConsumer_Avail;
+  const unsigned char *data = OFstatic_cast(const unsigned char *, buf);
+  if (filled_ + buflen > SiMACConsumer_BlockSize)
+  {
+    // not enough space left, feed the buffer content into the MAC first
+    flush();
+    if (status_.bad()) return 0;
+  }
+  if (buflen >= SiMACConsumer_BlockSize)
+  {
+    // large block, feed directly into the MAC without copying
+    digest(data, buflen);
+  }
+  else
+  {
+    memcpy(buffer_ + filled_, data, OFstatic_cast(size_t, buflen));
+    filled_ += buflen;
+  }
+  return (status_.good() ? buflen : 0);
+}
+
+
+void SiMACConsumer::flush()
+{
+  if (filled_ > 0 && status_.good())
+  {
+    digest(buffer_, filled_);
+    filled_ = 0;
+  }
+}
+
+
+SiMACOutputStream::SiMACOutputStream()
+: DcmOutputStream(&consumer_) // safe because DcmOutputStream only stores pointer
+, consumer_()
+{
+}
+
+
+SiMACOutputStream::~SiMACOutputStream()
+{
+}
+
+
+void SiMACOutputStream::setMAC(SiMAC *mac)
+{
+  consumer_.setMAC(mac);
+}
+
+
+void SiMACOutputStream::setDumpFile(FILE *f)
+{
+  consumer_.setDumpFile(f);
+}
+
+
+SiMACConstructor::SiMACConstructor()
+: stream()
+{
+}
+
+
+SiMACConstructor::~SiMACConstructor()
+{
+}
+
+void SiMACConstructor::setDumpFile(FILE *f)
+{
+  stream.setDumpFile(f);
+}
+
+
+OFCondition SiMACConstructor::flushBuffer(SiMAC& mac)
+{
+  stream.setMAC(&mac);
+  stream.flush();
+  return stream.status();
 }
 
 
@@ -86,6 +206,8 @@ OFCondition SiMACConstructor::encodeElement(DcmElement *element, SiMAC& mac, E_T
   element->transferInit();
   while (!last)
   {
+    // the stream feeds large values into the MAC directly, so suspension
+    // only occurs for element values exceeding the space reported as available
     result = element->writeSignatureFormat(stream, oxfer, EET_ExplicitLength, &wcache);
     if (result == EC_StreamNotifyClient) result = flushBuffer(mac);
     else
@@ -100,13 +222,7 @@ OFCondition SiMACConstructor::encodeElement(DcmElement *element, SiMAC& mac, E_T
 
 OFCondition SiMACConstructor::flush(SiMAC& mac)
 {
-  OFCondition result = EC_Normal;
-  while (! stream.isFlushed() && result.good())
-  {
-    stream.flush();
-    result = flushBuffer(mac);
-  }
-  return result;
+  return flushBuffer(mac);
 }
 
 
@@ -132,6 +248,7 @@ OFCondition SiMACConstructor::encodeDigitalSignatureItem(
 {
   if (! signatureItem.canWriteXfer(oxfer, EXS_Unknown)) return SI_EC_WrongTransferSyntax;
   OFCondition result = EC_Normal;
+  stream.setMAC(&mac);
   signatureItem.transferInit();
   unsigned long numElements = signatureItem.card();
   DcmElement *element;
@@ -172,6 +289,7 @@ OFCondition SiMACConstructor::encodeDataset(
   tagListOut.clear();
   if (! item.canWriteXfer(oxfer, EXS_Unknown)) return SI_EC_WrongTransferSyntax;
   OFCondition result = EC_Normal;
+  stream.setMAC(&mac);
   item.transferInit();
   unsigned long numElements = item.card();
   DcmElement *element;
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2019, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -40,6 +40,8 @@ typedef struct ssl_ctx_st SSL_CTX;
 struct x509_st;
 typedef struct x509_st X509;
 
+class DcmTLSSessionCache;
+
 extern DCMTK_DCMTLS_EXPORT OFLogger DCM_dcmtlsLogger;
 
 #define DCMTLS_TRACE(msg) OFLOG_TRACE(DCM_dcmtlsLogger, msg)
@@ -337,6 +339,51 @@ public:
    */
   OFBool setTempDHParameters(const char *filename);
 
+  /** enables or disables the resumption of TLS sessions. If enabled, the
+   *  server side session cache and session tickets are activated, and the
+   *  sessions negotiated for outgoing connections are kept per peer address
+   *  and offered again when a new connection to the same peer is created.
+   *  A resumed session skips the full handshake, including the key exchange
+   *  and certificate verification. If disabled, every connection performs a
+   *  full handshake. By default, OpenSSL maintains a server side session cache,
+   *  but sessions are never offered for outgoing connections.
+   *  @param enable OFTrue to enable session resumption, OFFalse to disable it
+   *  @return TCS_ok if successful, an error code otherwise
+   */
+  DcmTransportLayerStatus setSessionCaching(OFBool enable);
+
+  /** sets the maximum number of sessions kept in the server side session
+   *  cache and, if enabled, in the cache for outgoing connections.
+   *  @param size maximum number of sessions, 0 for unlimited
+   *  @return TCS_ok if successful, an error code otherwise
+   */
+  DcmTransportLayerStatus setSessionCacheSize(long size);
+
+  /** sets the lifetime of new TLS sessions, after which they cannot be
+   *  resumed anymore.
+   *  @param seconds session lifetime in seconds
+   *  @return TCS_ok if successful, an error code otherwise
+   */
+  DcmTransportLayerStatus setSessionTimeout(long seconds);
+
+  /** enables or disables read-ahead for TLS connections. If enabled, OpenSSL
+   *  reads as many bytes from the socket as are available and fit into its
+   *  buffer instead of reading each TLS record separately, which reduces the
+   *  number of system calls when receiving large amounts of data.
+   *  @param enable OFTrue to enable read-ahead, OFFalse to disable it (default)
+   *  @return TCS_ok if successful, an error code otherwise
+   */
+  DcmTransportLayerStatus setReadAhead(OFBool enable);
+
+  /** sets the maximum size of the plaintext fragment sent in a single
+   *  TLS record. Smaller records reduce the latency until the first bytes
+   *  can be decrypted by the peer, larger records reduce the overhead.
+   *  @param size maximum fragment size in bytes, must be in the range 512..16384
+   *    (default: 16384)
+   *  @return TCS_ok if successful, an error code otherwise
+   */
+  DcmTransportLayerStatus setMaxSendFragment(long size);
+
   /** print a list of supported ciphersuites to the given output stream.
    *  @param os output stream
    */
@@ -439,6 +486,9 @@ private:
 
   /// network role for this TLS layer
   T_ASC_NetworkRole role;
+
+  /// cache of sessions for outgoing connections, NULL if session caching is not enabled
+  DcmTLSSessionCache *sessionCache;
 };
 
 #endif /* WITH_OPENSSL */
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2017-2018, OFFIS e.V.
+ *  Copyright (C) 2017-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -188,6 +188,16 @@ private:
     /// OpenSSL support enabled.
     OFBool opt_secureConnection;
 
+    /// a flag indicating whether TLS sessions should be resumed
+    /// @remark this member is only available if DCMTK is compiled with
+    /// OpenSSL support enabled.
+    OFBool opt_sessionResumption;
+
+    /// a flag indicating whether TLS read-ahead should be enabled
+    /// @remark this member is only available if DCMTK is compiled with
+    /// OpenSSL support enabled.
+    OFBool opt_readAhead;
+
     /// indicates whether we act as client, server or both
     T_ASC_NetworkRole opt_networkRole;
 
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2018, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -132,6 +132,13 @@ public:
    */
   virtual OFString& dumpConnectionParameters(OFString& str);
 
+  /** checks whether the TLS session of this connection has been resumed,
+   *  i.e.\ whether the full handshake has been skipped
+   *  (see DcmTLSTransportLayer::setSessionCaching()).
+   *  @return OFTrue if the session has been resumed, OFFalse otherwise
+   */
+  OFBool isSessionReused() const;
+
   /** returns an error string for a given error code.
    *  @param code error code
    *  @return description for error code
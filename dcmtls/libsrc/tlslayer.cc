@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2019, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -44,6 +44,12 @@ END_EXTERN_C
 #include "dcmtk/dcmtls/tlslayer.h"
 #include "dcmtk/dcmtls/tlstrans.h"
 #include "dcmtk/dcmnet/dicom.h"
+#include "dcmtk/dcmnet/dcompat.h"    /* for getpeername() */
+#include "dcmtk/ofstd/ofmap.h"
+
+#ifdef WITH_THREADS
+#include "dcmtk/ofstd/ofthread.h"
+#endif
 
 #ifdef HAVE_SSL_CTX_GET0_PARAM
 #define DCMTK_SSL_CTX_get0_param SSL_CTX_get0_param
@@ -53,6 +59,7 @@ END_EXTERN_C
 
 #if OPENSSL_VERSION_NUMBER < 0x10002000L || defined(LIBRESSL_VERSION_NUMBER)
 #define X509_get_signature_nid(x509) OBJ_obj2nid((x509)->sig_alg->algorithm)
+#define SSL_is_server(ssl) (ssl)->server
 #endif
 
 #if OPENSSL_VERSION_NUMBER < 0x10100000L || defined(LIBRESSL_VERSION_NUMBER)
@@ -163,6 +170,166 @@ int DcmTLSTransportLayer_passwordCallback(char *buf, int size, int /* rwflag */,
 }
 
 
+/* default number of sessions kept for outgoing connections */
+#define DCMTLS_DEFAULT_SESSION_CACHE_SIZE 1024
+
+/** cache of TLS sessions negotiated for outgoing connections, indexed by
+ *  the address of the peer. OpenSSL maintains the server side session cache
+ *  itself, but never looks up a session for a new client connection.
+ *  The cache is shared by all connections created by a transport layer,
+ *  which may be used by multiple threads.
+ */
+class DcmTLSSessionCache
+{
+public:
+
+  /// constructor
+  DcmTLSSessionCache()
+  : sessions()
+  , maxEntries(DCMTLS_DEFAULT_SESSION_CACHE_SIZE)
+#ifdef WITH_THREADS
+  , mutex()
+#endif
+  {
+  }
+
+  /// destructor, frees all sessions
+  ~DcmTLSSessionCache()
+  {
+    OFMap<OFString, SSL_SESSION *>::iterator it = sessions.begin();
+    while (it != sessions.end())
+    {
+      SSL_SESSION_free((*it).second);
+      ++it;
+    }
+  }
+
+  /** sets the maximum number of sessions kept in the cache
+   *  @param size maximum number of sessions, 0 for unlimited
+   */
+  void setMaxEntries(size_t size)
+  {
+    maxEntries = size;
+  }
+
+  /** stores the session for the given peer, replacing any previous session.
+   *  @param peer address of the peer
+   *  @param session session to be stored, the cache takes over the reference
+   */
+  void store(const OFString& peer, SSL_SESSION *session)
+  {
+#ifdef WITH_THREADS
+    mutex.lock();
+#endif
+    OFMap<OFString, SSL_SESSION *>::iterator it = sessions.find(peer);
+    if (it != sessions.end())
+    {
+      SSL_SESSION_free((*it).second);
+      (*it).second = session;
+    }
+    else
+    {
+      // evict an arbitrary entry if the cache is full
+      if ((maxEntries > 0) && (sessions.size() >= maxEntries))
+      {
+        SSL_SESSION_free((*sessions.begin()).second);
+        sessions.erase(sessions.begin());
+      }
+      sessions[peer] = session;
+    }
+#ifdef WITH_THREADS
+    mutex.unlock();
+#endif
+  }
+
+  /** offers the session stored for the given peer (if any) on the given connection.
+   *  @param peer address of the peer
+   *  @param connection new TLS connection, not yet connected
+   *  @return OFTrue if a session was found, OFFalse otherwise
+   */
+  OFBool resume(const OFString& peer, SSL *connection)
+  {
+    OFBool result = OFFalse;
+#ifdef WITH_THREADS
+    mutex.lock();
+#endif
+    OFMap<OFString, SSL_SESSION *>::iterator it = sessions.find(peer);
+    if (it != sessions.end())
+    {
+      // SSL_set_session() obtains its own reference to the session
+      result = (SSL_set_session(connection, (*it).second) == 1);
+    }
+#ifdef WITH_THREADS
+    mutex.unlock();
+#endif
+    return result;
+  }
+
+  /** determines the key under which the session for the peer of the given
+   *  socket is stored, i.e. the IP address and port number of the peer.
+   *  @param socket connected socket
+   *  @param peer key returned in this parameter
+   *  @return OFTrue if successful, OFFalse otherwise
+   */
+  static OFBool getPeer(DcmNativeSocketType socket, OFString& peer)
+  {
+    struct sockaddr_in from;
+#ifdef HAVE_DECLARATION_SOCKLEN_T
+    socklen_t len = sizeof(from);
+#elif !defined(HAVE_PROTOTYPE_ACCEPT) || defined(HAVE_INTP_ACCEPT)
+    int len = sizeof(from);
+#else
+    size_t len = sizeof(from);
+#endif
+    memset(&from, 0, sizeof(from));
+    if (getpeername(socket, OFreinterpret_cast(struct sockaddr *, &from), &len) != 0) return OFFalse;
+    if (from.sin_family != AF_INET) return OFFalse;
+    const unsigned long addr = OFstatic_cast(unsigned long, ntohl(from.sin_addr.s_addr));
+    char buf[32];
+    OFStandard::snprintf(buf, sizeof(buf), "%lu.%lu.%lu.%lu:%u", (addr >> 24) & 0xff, (addr >> 16) & 0xff,
+      (addr >> 8) & 0xff, addr & 0xff, OFstatic_cast(unsigned int, ntohs(from.sin_port)));
+    peer = buf;
+    return OFTrue;
+  }
+
+private:
+
+  /// private undefined copy constructor
+  DcmTLSSessionCache(const DcmTLSSessionCache&);
+
+  /// private undefined assignment operator
+  DcmTLSSessionCache& operator=(const DcmTLSSessionCache&);
+
+  /// sessions, indexed by peer address
+  OFMap<OFString, SSL_SESSION *> sessions;
+
+  /// maximum number of sessions, 0 for unlimited
+  size_t maxEntries;
+
+#ifdef WITH_THREADS
+  /// mutex protecting the sessions
+  OFMutex mutex;
+#endif
+};
+
+/* ssl     : the TLS connection for which a new session has been negotiated
+ * session : the new session
+ * returns : 1 if the callback keeps the reference to the session, 0 otherwise
+ */
+extern "C" int DcmTLSTransportLayer_newSessionCallback(SSL *ssl, SSL_SESSION *session);
+
+int DcmTLSTransportLayer_newSessionCallback(SSL *ssl, SSL_SESSION *session)
+{
+  // the server side sessions are kept in the internal cache of OpenSSL
+  if (SSL_is_server(ssl)) return 0;
+  DcmTLSSessionCache *cache = OFreinterpret_cast(DcmTLSSessionCache *, SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  OFString peer;
+  if ((cache == NULL) || !DcmTLSSessionCache::getPeer(SSL_get_fd(ssl), peer)) return 0;
+  cache->store(peer, session);
+  return 1;
+}
+
+
 // The TLS Supported Elliptic Curves extension (RFC 4492) is only supported in OpenSSL 1.0.2 and newer.
 // When compiling with OpenSSL 1.0.1, we are not using computeEllipticCurveList().
 #if OPENSSL_VERSION_NUMBER >= 0x10002000L && !defined(LIBRESSL_VERSION_NUMBER)
@@ -229,6 +396,7 @@ DcmTLSTransportLayer::DcmTLSTransportLayer()
 , canWriteRandseed(OFFalse)
 , privateKeyPasswd()
 , role(NET_ACCEPTORREQUESTOR)
+, sessionCache(NULL)
 {
 }
 
@@ -238,6 +406,7 @@ DcmTLSTransportLayer::DcmTLSTransportLayer(T_ASC_NetworkRole networkRole, const
 , canWriteRandseed(OFFalse)
 , privateKeyPasswd()
 , role(networkRole)
+, sessionCache(NULL)
 {
    if (initOpenSSL) initializeOpenSSL();
    if (randFile) seedPRNG(randFile);
@@ -382,6 +551,14 @@ DcmTLSTransportLayer::DcmTLSTransportLayer(T_ASC_NetworkRole networkRole, const
       {
         DCMTLS_ERROR("unable to configure the TLS layer to select ciphersuites by server preference.");
       }
+
+      // A session ID context is required for resuming sessions when peer certificates are
+      // verified. Without it, a client offering a cached session would fail the handshake.
+      static const unsigned char sessionIdContext[] = "DCMTK";
+      if (0 == SSL_CTX_set_session_id_context(transportLayerContext, sessionIdContext, sizeof(sessionIdContext) - 1))
+      {
+        DCMTLS_ERROR("unable to set the TLS session ID context.");
+      }
     }
 
   } /* transportLayerContext != NULL */
@@ -392,8 +569,10 @@ DcmTLSTransportLayer::DcmTLSTransportLayer(OFrvalue_ref(DcmTLSTransportLayer) rh
 , transportLayerContext(rhs.transportLayerContext)
 , canWriteRandseed(OFmove(OFrvalue_access(rhs).canWriteRandseed))
 , privateKeyPasswd(OFmove(OFrvalue_access(rhs).privateKeyPasswd))
+, sessionCache(rhs.sessionCache)
 {
   OFrvalue_access(rhs).transportLayerContext = NULL;
+  OFrvalue_access(rhs).sessionCache = NULL;
 }
 
 DcmTLSTransportLayer& DcmTLSTransportLayer::operator=(OFrvalue_ref(DcmTLSTransportLayer) rhs)
@@ -405,7 +584,9 @@ DcmTLSTransportLayer& DcmTLSTransportLayer::operator=(OFrvalue_ref(DcmTLSTranspo
     transportLayerContext = rhs.transportLayerContext;
     canWriteRandseed = OFmove(OFrvalue_access(rhs).canWriteRandseed);
     privateKeyPasswd = OFmove(OFrvalue_access(rhs).privateKeyPasswd);
+    sessionCache = rhs.sessionCache;
     OFrvalue_access(rhs).transportLayerContext = NULL;
+    OFrvalue_access(rhs).sessionCache = NULL;
   }
   return *this;
 }
@@ -419,6 +600,8 @@ void DcmTLSTransportLayer::clear()
     canWriteRandseed = OFFalse;
     privateKeyPasswd.clear();
   }
+  delete sessionCache;
+  sessionCache = NULL;
 }
 
 DcmTLSTransportLayer::operator OFBool() const
@@ -706,6 +889,16 @@ DcmTransportConnection *DcmTLSTransportLayer::createConnection(DcmNativeSocketTy
           DCMTLS_ERROR("Conversion of 64-bit socket type to int in OpenSSL API causes loss of information.");
         }
         SSL_set_fd(newConnection, s);
+        if (sessionCache && (role != NET_ACCEPTOR))
+        {
+          // offer the session negotiated with this peer before, if any.
+          // Incoming connections never match since the peer uses an ephemeral port.
+          OFString peer;
+          if (DcmTLSSessionCache::getPeer(openSocket, peer) && sessionCache->resume(peer, newConnection))
+          {
+            DCMTLS_DEBUG("offering cached TLS session for peer " << peer);
+          }
+        }
         return new DcmTLSConnection(openSocket, newConnection);
       }
     }
@@ -838,6 +1031,62 @@ DcmTransportLayerStatus DcmTLSTransportLayer::addCipherSuite(const char *suite)
   return ciphersuites.addCipherSuite(suite);
 }
 
+DcmTransportLayerStatus DcmTLSTransportLayer::setSessionCaching(OFBool enable)
+{
+  if (transportLayerContext == NULL) return TCS_illegalCall;
+  if (enable)
+  {
+    if (sessionCache == NULL) sessionCache = new DcmTLSSessionCache();
+    SSL_CTX_set_app_data(transportLayerContext, sessionCache);
+    SSL_CTX_set_session_cache_mode(transportLayerContext, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_sess_set_new_cb(transportLayerContext, DcmTLSTransportLayer_newSessionCallback);
+    SSL_CTX_clear_options(transportLayerContext, SSL_OP_NO_TICKET);
+  }
+  else
+  {
+    SSL_CTX_set_session_cache_mode(transportLayerContext, SSL_SESS_CACHE_OFF);
+    SSL_CTX_sess_set_new_cb(transportLayerContext, NULL);
+    SSL_CTX_set_options(transportLayerContext, SSL_OP_NO_TICKET);
+    SSL_CTX_set_app_data(transportLayerContext, NULL);
+    delete sessionCache;
+    sessionCache = NULL;
+  }
+  return TCS_ok;
+}
+
+DcmTransportLayerStatus DcmTLSTransportLayer::setSessionCacheSize(long size)
+{
+  if ((transportLayerContext == NULL) || (size < 0)) return TCS_illegalCall;
+  SSL_CTX_sess_set_cache_size(transportLayerContext, size);
+  if (sessionCache) sessionCache->setMaxEntries(OFstatic_cast(size_t, size));
+  return TCS_ok;
+}
+
+DcmTransportLayerStatus DcmTLSTransportLayer::setSessionTimeout(long seconds)
+{
+  if ((transportLayerContext == NULL) || (seconds <= 0)) return TCS_illegalCall;
+  SSL_CTX_set_timeout(transportLayerContext, seconds);
+  return TCS_ok;
+}
+
+DcmTransportLayerStatus DcmTLSTransportLayer::setReadAhead(OFBool enable)
+{
+  if (transportLayerContext == NULL) return TCS_illegalCall;
+  SSL_CTX_set_read_ahead(transportLayerContext, enable ? 1 : 0);
+  return TCS_ok;
+}
+
+DcmTransportLayerStatus DcmTLSTransportLayer::setMaxSendFragment(long size)
+{
+  if (transportLayerContext == NULL) return TCS_illegalCall;
+  if (! SSL_CTX_set_max_send_fragment(transportLayerContext, size))
+  {
+    DCMTLS_ERROR("unable to set the maximum TLS send fragment size to " << size << " bytes.");
+    return TCS_tlsError;
+  }
+  return TCS_ok;
+}
+
 DcmTLSTransportLayer::native_handle_type DcmTLSTransportLayer::getNativeHandle()
 {
   return transportLayerContext;
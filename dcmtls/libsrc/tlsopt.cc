@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 2017-2019, OFFIS e.V.
+ *  Copyright (C) 2017-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -46,6 +46,8 @@ DcmTLSOptions::DcmTLSOptions(T_ASC_NetworkRole networkRole)
 , opt_certVerification( DCV_requireCertificate )
 , opt_dhparam( OFnullptr )
 , opt_secureConnection( OFFalse ) // default: no secure connection
+, opt_sessionResumption( OFFalse )
+, opt_readAhead( OFFalse )
 , opt_networkRole( networkRole )
 , tLayer( OFnullptr )
 #endif
@@ -127,6 +129,14 @@ void DcmTLSOptions::addTLSCommandlineOptions(OFCommandLine& cmd)
         cmd.addOption("--verify-peer-cert", "-vc",     "verify peer certificate if present");
       }
       cmd.addOption("--ignore-peer-cert",   "-ic",     "don't verify peer certificate");
+    cmd.addSubGroup("performance:");
+      if (opt_networkRole != NET_REQUESTOR)
+      {
+        // sessions are only kept in memory, and the requestor tools only
+        // negotiate a single association per process
+        cmd.addOption("--session-resumption", "+tsr",  "allow peers to resume previous TLS sessions");
+      }
+      cmd.addOption("--read-ahead",         "+tra",    "enable TLS read-ahead");
 
 #endif // WITH_OPENSSL
 }
@@ -269,6 +279,17 @@ void DcmTLSOptions::parseArguments(OFConsoleApplication& app, OFCommandLine& cmd
     }
     cmd.endOptionBlock();
 
+    if( (opt_networkRole != NET_REQUESTOR) && cmd.findOption( "--session-resumption" ) )
+    {
+        app.checkDependence("--session-resumption", tlsopts, opt_secureConnection);
+        opt_sessionResumption = OFTrue;
+    }
+    if( cmd.findOption( "--read-ahead" ) )
+    {
+        app.checkDependence("--read-ahead", tlsopts, opt_secureConnection);
+        opt_readAhead = OFTrue;
+    }
+
     // check the other TLS specific options that will only be evaluated
     // later in DcmTLSOptions::createTransportLayer().
     if (cmd.findOption("--add-cert-file", 0, OFCommandLine::FOM_First))
@@ -364,6 +385,11 @@ OFCondition DcmTLSOptions::createTransportLayer(
 
       tLayer->setCertificateVerification(opt_certVerification);
 
+      if (opt_sessionResumption && (TCS_ok != tLayer->setSessionCaching(OFTrue)))
+         DCMTLS_WARN("unable to enable TLS session resumption, ignoring");
+      if (opt_readAhead && (TCS_ok != tLayer->setReadAhead(OFTrue)))
+         DCMTLS_WARN("unable to enable TLS read-ahead, ignoring");
+
       if (net)
       {
         OFCondition cond = ASC_setTransportLayer(net, tLayer, 0);
@@ -1,6 +1,6 @@
 /*
  *
- *  Copyright (C) 1998-2018, OFFIS e.V.
+ *  Copyright (C) 1998-2026, OFFIS e.V.
  *  All rights reserved.  See COPYRIGHT file for details.
  *
  *  This software and supporting documentation were developed by
@@ -263,6 +263,12 @@ OFBool DcmTLSConnection::networkDataAvailable(int timeout)
    */
   if (tlsConnection == NULL) return OFFalse;
   if (SSL_pending(tlsConnection)) return OFTrue;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(LIBRESSL_VERSION_NUMBER)
+  /* with read-ahead enabled, OpenSSL may have read (but not yet
+   * decrypted) data from the socket, which select() would not report.
+   */
+  if (SSL_has_pending(tlsConnection)) return OFTrue;
+#endif
 
   struct timeval t;
   int nfound;
@@ -327,6 +333,7 @@ OFString& DcmTLSConnection::dumpConnectionParameters(OFString& str)
          << "  Protocol    : " << SSL_get_version(tlsConnection) << OFendl
          << "  Ciphersuite : " << SSL_CIPHER_get_name(SSL_get_current_cipher(tlsConnection))
          << ", encryption: " << SSL_CIPHER_get_bits(SSL_get_current_cipher(tlsConnection), NULL) << " bits" << OFendl
+         << "  Session     : " << (SSL_session_reused(tlsConnection) ? "resumed" : "new") << OFendl
          << DcmTLSTransportLayer::dumpX509Certificate(peerCert);
   // stream << OFendl << "Certificate verification: " << X509_verify_cert_error_string(SSL_get_verify_result(tlsConnection));
   X509_free(peerCert);
@@ -337,6 +344,11 @@ OFString& DcmTLSConnection::dumpConnectionParameters(OFString& str)
   return str;
 }
 
+OFBool DcmTLSConnection::isSessionReused() const
+{
+  return (tlsConnection != NULL) && SSL_session_reused(tlsConnection);
+}
+
 const char *DcmTLSConnection::errorString(DcmTransportLayerStatus code)
 {
   switch (code)
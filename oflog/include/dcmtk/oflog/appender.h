@@ -136,7 +136,13 @@ namespace log4cplus {
          * delegating actual logging to the subclasses specific {@link
          * #append} method.
          */
-        void doAppend(const log4cplus::spi::InternalLoggingEvent& event);
+        virtual void doAppend(const log4cplus::spi::InternalLoggingEvent& event);
+
+        /**
+         * Flush any output buffered by this appender. The default
+         * implementation does nothing.
+         */
+        virtual void flush();
 
         /**
          * Get the name of this appender. The name uniquely identifies the
@@ -56,6 +56,25 @@ namespace log4cplus
 {
 
 
+/**
+ * AsyncAppender passes logging events to a queue from which a separate
+ * thread forwards them to the attached appenders.
+ *
+ * <h3>Properties</h3>
+ * <dl>
+ * <dt><tt>Appender</tt></dt>
+ * <dd>Name of the attached appender class. Its properties are
+ * taken from the <tt>Appender.</tt> subset.</dd>
+ *
+ * <dt><tt>QueueLimit</tt></dt>
+ * <dd>Maximal number of events in the queue, default is 100.</dd>
+ * </dl>
+ *
+ * The attached appenders are flushed after each batch of events taken
+ * from the queue. It is therefore recommended to set
+ * <tt>ImmediateFlush</tt> to <tt>false</tt> for an attached
+ * FileAppender, so that events are written in batches.
+ */
 class DCMTK_LOG4CPLUS_EXPORT AsyncAppender
     : public Appender
     , public helpers::AppenderAttachableImpl
@@ -67,6 +86,11 @@ public:
 
     virtual void close ();
 
+    //! Checks threshold and filters and puts the event into the queue.
+    //! Unlike Appender::doAppend() this does not lock the appender, so
+    //! that concurrent callers are only synchronized by the queue.
+    virtual void doAppend (spi::InternalLoggingEvent const &);
+
 protected:
     virtual void append (spi::InternalLoggingEvent const &);
 
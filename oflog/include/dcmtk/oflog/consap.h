@@ -63,6 +63,7 @@ namespace log4cplus {
 
       // Methods
         virtual void close();
+        virtual void flush();
 
         //! This mutex is used by ConsoleAppender and helpers::LogLog
         //! classes to synchronize output to console.
@@ -0,0 +1,205 @@
+// -*- C++ -*-
+//  Copyright (C) 2009-2010, Vaclav Haisman. All rights reserved.
+//  
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//  
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//  
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//  
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef DCMTK_LOG4CPLUS_HELPERS_ATOMIC_H
+#define DCMTK_LOG4CPLUS_HELPERS_ATOMIC_H
+
+#include "dcmtk/oflog/config.h"
+
+#if defined (DCMTK_LOG4CPLUS_HAVE_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#if ! defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+#if defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+#include <atomic>
+#elif defined (_WIN32)
+#include "dcmtk/oflog/config/windowsh.h"
+#endif
+
+#if defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS) \
+    || defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH) \
+    || defined (_WIN32)
+//! Defined if the functions below are atomic. Otherwise, all accesses
+//! to an atomic_ulong must be protected by a mutex.
+#define DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS
+#endif
+#endif
+
+
+namespace dcmtk {
+namespace log4cplus { namespace helpers {
+
+
+#if ! defined (DCMTK_LOG4CPLUS_SINGLE_THREADED) \
+    && defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+//! Type of unsigned long values accessed by multiple threads.
+typedef STD_NAMESPACE atomic<unsigned long> atomic_ulong;
+#else
+//! Type of unsigned long values accessed by multiple threads.
+typedef unsigned long volatile atomic_ulong;
+#endif
+
+
+//! Loads value with acquire semantics.
+inline
+unsigned long
+load_acquire (atomic_ulong const & v)
+{
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+    return v;
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+    return v.load (STD_NAMESPACE memory_order_acquire);
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH)
+    unsigned long const x = v;
+    __sync_synchronize ();
+    return x;
+
+#elif defined (_WIN32)
+    unsigned long const x = v;
+    MemoryBarrier ();
+    return x;
+
+#else
+    return v;
+
+#endif
+}
+
+
+//! Stores value with release semantics.
+inline
+void
+store_release (atomic_ulong & v, unsigned long x)
+{
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+    v = x;
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+    v.store (x, STD_NAMESPACE memory_order_release);
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH)
+    __sync_synchronize ();
+    v = x;
+
+#elif defined (_WIN32)
+    MemoryBarrier ();
+    v = x;
+
+#else
+    v = x;
+
+#endif
+}
+
+
+//! Full memory barrier, orders preceding stores before following loads.
+inline
+void
+full_fence ()
+{
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+    STD_NAMESPACE atomic_thread_fence (STD_NAMESPACE memory_order_seq_cst);
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH)
+    __sync_synchronize ();
+
+#elif defined (_WIN32)
+    MemoryBarrier ();
+
+#endif
+}
+
+
+//! Atomically replaces <code>expected</code> by <code>desired</code>.
+//! \return true if successful.
+inline
+bool
+compare_and_swap (atomic_ulong & v, unsigned long expected,
+    unsigned long desired)
+{
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+    if (v != expected)
+        return false;
+    v = desired;
+    return true;
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+    return v.compare_exchange_strong (expected, desired);
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH)
+    return __sync_bool_compare_and_swap (&v, expected, desired);
+
+#elif defined (_WIN32)
+    return OFstatic_cast (unsigned long, InterlockedCompareExchange (
+        OFreinterpret_cast (LONG volatile *, &v),
+        OFstatic_cast (LONG, desired), OFstatic_cast (LONG, expected)))
+        == expected;
+
+#else
+    if (v != expected)
+        return false;
+    v = desired;
+    return true;
+
+#endif
+}
+
+
+//! Atomically adds <code>x</code> to <code>v</code> (with full
+//! memory barrier). Unsigned overflow wraps around, so adding
+//! <code>~0UL</code> decrements the value.
+//! \return The new value.
+inline
+unsigned long
+add_and_fetch (atomic_ulong & v, unsigned long x)
+{
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED)
+    return v += x;
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE_CXX11_ATOMICS)
+    return v.fetch_add (x) + x;
+
+#elif defined (DCMTK_LOG4CPLUS_HAVE___SYNC_ADD_AND_FETCH)
+    return __sync_add_and_fetch (&v, x);
+
+#else
+    unsigned long old = load_acquire (v);
+    while (! compare_and_swap (v, old, old + x))
+        old = load_acquire (v);
+    return old + x;
+
+#endif
+}
+
+
+} } // namespace log4cplus { namespace helpers {
+} // end namespace dcmtk
+
+
+#endif // DCMTK_LOG4CPLUS_HELPERS_ATOMIC_H
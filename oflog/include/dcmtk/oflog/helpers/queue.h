@@ -36,6 +36,7 @@
 #include "dcmtk/oflog/spi/logevent.h"
 #include "dcmtk/oflog/thread/threads.h"
 #include "dcmtk/oflog/thread/syncprim.h"
+#include "dcmtk/oflog/helpers/atomic.h"
 #include "dcmtk/ofstd/ofvector.h"
 
 
@@ -44,6 +45,13 @@ namespace log4cplus { namespace thread {
 
 
 //! Single consumer, multiple producers queue.
+//!
+//! The queue is a bounded ring buffer. Producers claim a slot by
+//! atomically advancing the tail index and publish the event by
+//! updating the sequence number of the slot, so that they never
+//! block each other on a mutex. The consumer only waits on the
+//! internal event object if it finds the queue empty, and producers
+//! only wait on another event object if they find the queue full.
 class DCMTK_LOG4CPLUS_EXPORT Queue
     : public virtual helpers::SharedObject
 {
@@ -54,19 +62,27 @@ public:
     //! Queue storage type.
     typedef OFVector<spi::InternalLoggingEvent> queue_storage_type;
 
+    //! Type of the ring buffer indices and sequence numbers.
+    typedef unsigned long index_type;
+
+    //! Type of the fields accessed by multiple threads.
+    typedef helpers::atomic_ulong atomic_index_type;
+
+    //! \param len Maximal number of events in the queue, rounded up
+    //! to the next power of two.
     Queue (unsigned len = 100);
     virtual ~Queue ();
 
     // Producers' methods.
 
     //! Puts event <code>ev</code> into queue, sets QUEUE flag and
-    //! sets internal event object into signaled state. If the EXIT
-    //! flags is already set upon entering the function, nothing is
-    //! inserted into the queue. The function can block on internal
-    //! semaphore if the queue has reached maximal allowed
-    //! length. Calling thread is unblocked either by consumer thread
-    //! removing item from queue or by any other thread calling
-    //! signal_exit().
+    //! sets internal event object into signaled state if the consumer
+    //! is waiting. If the EXIT flags is already set upon entering the
+    //! function, nothing is inserted into the queue. If the queue has
+    //! reached maximal allowed length, the function yields the processor
+    //! a few times and then blocks. Calling thread continues either when
+    //! the consumer thread removes items from queue or when any other
+    //! thread calls signal_exit().
     //!
     //! \param ev spi::InternalLoggingEvent to be put into the queue.
     //! \return Flags.
@@ -81,7 +97,8 @@ public:
     // Consumer's methods.
 
     //! The get_events() function is used by queue's consumer. It
-    //! fills <code>buf</code> argument and sets EVENT flag in return
+    //! replaces the content of <code>buf</code> argument by all events
+    //! currently in the queue and sets EVENT flag in return
     //! value. If EXIT flag is already set in flags member upon
     //! entering the function then depending on DRAIN flag it either
     //! fills <code>buf</code> argument or does not fill the argument,
@@ -127,20 +144,56 @@ public:
     };
 
 protected:
-    //! Queue storage.
-    queue_storage_type queue;
+    //! Slot of the ring buffer.
+    struct Slot
+    {
+        Slot ();
+
+        //! Sequence number. Equals the index of the next event to be
+        //! stored in this slot if the slot is free, and the index of
+        //! the event plus one if the slot contains an event.
+        atomic_index_type seq;
+
+        //! The event.
+        spi::InternalLoggingEvent ev;
+    };
+
+    //! Returns true if the slot at the head of the queue contains an event.
+    bool event_available () const;
+
+    //! Ring buffer.
+    Slot * slots;
 
-    //! Mutex protecting queue and flags.
+    //! Number of slots minus one, the number of slots is a power of two.
+    index_type mask;
+
+    //! Index of the next slot to be claimed by a producer.
+    atomic_index_type tail;
+
+    //! Index of the next slot to be read by the consumer. It is only
+    //! accessed by the consumer thread.
+    index_type head;
+
+    //! State flags, only modified while holding the mutex.
+    atomic_index_type flags;
+
+    //! Set while the consumer is (about to be) waiting on ev_consumer.
+    atomic_index_type consumer_waiting;
+
+    //! Number of producers (about to be) waiting on ev_producers.
+    atomic_index_type producers_waiting;
+
+    //! Mutex serializing signal_exit() calls. It also protects all
+    //! fields above on platforms without atomic operations.
     Mutex mutex;
 
     //! Event on which consumer can wait if it finds queue empty.
     ManualResetEvent ev_consumer;
 
-    //! Semaphore that limits the queue length.
-    Semaphore sem;
-
-    //! State flags.
-    flags_type flags;
+    //! Event on which producers can wait if they find queue full. It is
+    //! reset by the producers before they wait and signaled by the
+    //! consumer whenever it removes events while producers are waiting.
+    ManualResetEvent ev_producers;
 
 private:
     Queue (Queue const &);
@@ -32,6 +32,7 @@
 
 #include "dcmtk/oflog/logger.h"
 #include "dcmtk/oflog/thread/syncprim.h"
+#include "dcmtk/oflog/helpers/atomic.h"
 #include "dcmtk/ofstd/ofmap.h"
 #include <memory>
 #include "dcmtk/ofstd/ofvector.h"
@@ -305,6 +306,13 @@ namespace log4cplus {
 
         int disableValue;
 
+        /**
+         * Incremented (atomically) whenever the log level or the parent
+         * of a logger changes. Loggers cache their chained log level
+         * until this value changes.
+         */
+        helpers::atomic_ulong logLevelGeneration;
+
         bool emittedNoAppenderWarning;
 
         // Disallow copying of instances of this class
@@ -33,6 +33,7 @@
 #include "dcmtk/oflog/tstring.h"
 #include "dcmtk/oflog/helpers/apndimpl.h"
 #include "dcmtk/oflog/helpers/pointer.h"
+#include "dcmtk/oflog/helpers/atomic.h"
 #include "dcmtk/oflog/spi/logfact.h"
 #include <memory>
 #include "dcmtk/ofstd/ofvector.h"
@@ -116,7 +117,7 @@ namespace log4cplus {
             /**
              * Set the LogLevel of this Logger.
              */
-            void setLogLevel(LogLevel _ll) { this->ll = _ll; }
+            void setLogLevel(LogLevel _ll);
 
             /**
              * Return the the {@link Hierarchy} where this <code>Logger</code>
@@ -178,6 +179,14 @@ namespace log4cplus {
              */
             LogLevel ll;
 
+            /**
+             * The chained LogLevel of this logger as computed by the last
+             * call to isEnabledFor(), combined with the generation of the
+             * hierarchy it was computed for. Both are kept in a single word
+             * so that they are always read and written together atomically.
+             */
+            mutable helpers::atomic_ulong cachedChainedLL;
+
             /**
              * The parent of this logger. All loggers have at least one
              * ancestor which is the root logger. 
@@ -284,6 +284,12 @@ Appender::doAppend(const log4cplus::spi::InternalLoggingEvent& event)
 }
 
 
+void
+Appender::flush()
+{
+}
+
+
 tstring &
 Appender::formatEvent (const spi::InternalLoggingEvent& event) const
 {
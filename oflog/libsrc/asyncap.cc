@@ -77,6 +77,14 @@ QueueThread::run()
             for (ev_buf_type::const_iterator it = ev_buf.begin ();
                 it != ev_buf_end; ++it)
                 appenders->appendLoopOnAppenders (*it);
+
+            // Flush the attached appenders once per batch of events
+            // instead of once per event.
+            SharedAppenderPtrList const attached
+                = appenders->getAllAppenders ();
+            for (SharedAppenderPtrList::const_iterator it = attached.begin ();
+                it != attached.end (); ++it)
+                (*it)->flush ();
         }
 
         if (((thread::Queue::EXIT | thread::Queue::DRAIN
@@ -161,6 +169,11 @@ AsyncAppender::init_queue_thread (unsigned queue_len)
 void
 AsyncAppender::close ()
 {
+    {
+        thread::MutexGuard guard (access_mutex);
+        closed = true;
+    }
+
     unsigned ret = queue->signal_exit ();
     if (ret & (thread::Queue::ERROR_BIT | thread::Queue::ERROR_AFTER))
         getErrorHandler ()->error (
@@ -169,6 +182,36 @@ AsyncAppender::close ()
 }
 
 
+void
+AsyncAppender::doAppend (spi::InternalLoggingEvent const & ev)
+{
+    // The mutex is only held while reading the flag, the event is put
+    // into the queue without serializing the producers.
+    bool is_closed;
+    {
+        thread::MutexGuard guard (access_mutex);
+        is_closed = closed;
+    }
+
+    if (is_closed)
+    {
+        helpers::getLogLog ().error (
+            DCMTK_LOG4CPLUS_TEXT ("Attempted to append to closed appender named [")
+            + name
+            + DCMTK_LOG4CPLUS_TEXT ("]."));
+        return;
+    }
+
+    if (! isAsSevereAsThreshold (ev.getLogLevel ()))
+        return;
+
+    if (spi::checkFilter (filter.get (), ev) == spi::DENY)
+        return;
+
+    append (ev);
+}
+
+
 void
 AsyncAppender::append (spi::InternalLoggingEvent const & ev)
 {
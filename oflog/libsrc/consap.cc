@@ -95,6 +95,17 @@ ConsoleAppender::close()
 
 
 
+void
+ConsoleAppender::flush()
+{
+    thread::MutexGuard guard (getOutputMutex ());
+
+    tostream& output = (logToStdErr ? tcerr : tcout);
+    output.flush();
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////////
 // ConsoleAppender protected methods
 //////////////////////////////////////////////////////////////////////////////
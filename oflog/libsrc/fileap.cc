@@ -345,6 +345,16 @@ FileAppender::close()
 }
 
 
+void
+FileAppender::flush()
+{
+    thread::MutexGuard guard (access_mutex);
+
+    if (! closed)
+        out.flush();
+}
+
+
 STD_NAMESPACE locale
 FileAppender::imbue(STD_NAMESPACE locale const& loc)
 {
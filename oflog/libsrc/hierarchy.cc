@@ -74,6 +74,7 @@ Hierarchy::Hierarchy()
   , root(NULL)
   // Don't disable any LogLevel level by default.
   , disableValue(DISABLE_OFF)
+  , logLevelGeneration(0)
   , emittedNoAppenderWarning(false)
 {
     root = Logger( new spi::RootLogger(*this, DEBUG_LOG_LEVEL) );
@@ -372,6 +373,9 @@ Hierarchy::updateChildren(ProvisionNode& pn, Logger const & logger)
             c.value->parent = logger.value;
         }
     }
+
+    // the chained log levels of the children might have changed
+    helpers::add_and_fetch(logLevelGeneration, 1);
 }
 
 
@@ -37,6 +37,7 @@ namespace log4cplus { namespace spi {
 LoggerImpl::LoggerImpl(const log4cplus::tstring& name_, Hierarchy& h)
   : name(name_),
     ll(NOT_SET_LOG_LEVEL),
+    cachedChainedLL(0),
     parent(NULL),
     additive(true), 
     hierarchy(h)
@@ -88,13 +89,48 @@ LoggerImpl::closeNestedAppenders()
 }
 
 
+namespace
+{
+
+// Number of bits of LoggerImpl::cachedChainedLL holding the log level.
+static const unsigned CACHED_LL_BITS = 16;
+
+// Mask of the log level bits of LoggerImpl::cachedChainedLL.
+static const unsigned long CACHED_LL_MASK = (1UL << CACHED_LL_BITS) - 1;
+
+} // namespace
+
+
 bool 
 LoggerImpl::isEnabledFor(LogLevel loglevel) const
 {
     if(hierarchy.disableValue >= loglevel) {
         return false;
     }
+
+    // The chained log level only changes if a log level or the parent
+    // of a logger changes, so it is cached until the generation of the
+    // hierarchy changes. A cached log level of 0 means "not cached".
+    // Without atomic operations, the cache cannot be used safely by
+    // multiple threads.
+#if defined (DCMTK_LOG4CPLUS_SINGLE_THREADED) \
+    || defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
+    unsigned long const generation =
+        helpers::load_acquire(hierarchy.logLevelGeneration) & (~0UL >> CACHED_LL_BITS);
+    unsigned long const cached = helpers::load_acquire(cachedChainedLL);
+    if((cached >> CACHED_LL_BITS) == generation && (cached & CACHED_LL_MASK) != 0) {
+        return loglevel >= OFstatic_cast(LogLevel, (cached & CACHED_LL_MASK) - 1);
+    }
+
+    LogLevel const chained = getChainedLogLevel();
+    if(chained >= 0 && OFstatic_cast(unsigned long, chained) < CACHED_LL_MASK) {
+        helpers::store_release(cachedChainedLL, (generation << CACHED_LL_BITS)
+            | (OFstatic_cast(unsigned long, chained) + 1));
+    }
+    return loglevel >= chained;
+#else
     return loglevel >= getChainedLogLevel();
+#endif
 }
 
 
@@ -134,6 +170,18 @@ LoggerImpl::getChainedLogLevel() const
 }
 
 
+void 
+LoggerImpl::setLogLevel(LogLevel _ll)
+{
+    ll = _ll;
+    // invalidate the chained log levels cached by all loggers. The
+    // increment is atomic and orders the new log level before the new
+    // generation, so that a logger that sees the new generation also
+    // sees the new log level.
+    helpers::add_and_fetch(hierarchy.logLevelGeneration, 1);
+}
+
+
 Hierarchy& 
 LoggerImpl::getHierarchy() const
 { 
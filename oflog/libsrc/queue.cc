@@ -36,17 +36,72 @@ namespace dcmtk {
 namespace log4cplus { namespace thread {
 
 
+using helpers::load_acquire;
+using helpers::store_release;
+using helpers::full_fence;
+using helpers::compare_and_swap;
+using helpers::add_and_fetch;
+
+
+namespace
+{
+
+//! Number of times a thread yields the processor while waiting for the
+//! queue before it blocks on an event object.
+static unsigned const spin_limit = 16;
+
+
+//! Difference of two indices that may have wrapped around.
+static inline
+long
+index_diff (Queue::index_type a, Queue::index_type b)
+{
+    return OFstatic_cast (long, a - b);
+}
+
+} // namespace
+
+
+Queue::Slot::Slot ()
+    : seq (0)
+    , ev ()
+{ }
+
+
 Queue::Queue (unsigned len)
-    : queue()
+    : slots (0)
+    , mask (0)
+    , tail (0)
+    , head (0)
+    , flags (DRAIN)
+    , consumer_waiting (0)
+    , producers_waiting (0)
     , mutex (Mutex::DEFAULT)
     , ev_consumer (false)
-    , sem (len, len) 
-    , flags (DRAIN)
-{ }
+    , ev_producers (false)
+{
+    index_type size = 1;
+    while (size < len)
+        size <<= 1;
+
+    slots = new Slot[size];
+    mask = size - 1;
+    for (index_type i = 0; i != size; ++i)
+        store_release (slots[i].seq, i);
+}
 
 
 Queue::~Queue ()
-{ }
+{
+    delete[] slots;
+}
+
+
+bool
+Queue::event_available () const
+{
+    return load_acquire (slots[head & mask].seq) == head + 1;
+}
 
 
 Queue::flags_type
@@ -56,28 +111,101 @@ Queue::put_event (spi::InternalLoggingEvent const & ev)
     try
     {
         ev.gatherThreadSpecificData ();
-        
-        SemaphoreGuard semguard (sem);
+
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
         MutexGuard mguard (mutex);
+#endif
 
-        ret_flags |= flags;
-        
-        if (flags & EXIT)
+        // Claim a free slot at the tail of the queue.
+        Slot * slot = 0;
+        index_type pos = load_acquire (tail);
+        unsigned spins = 0;
+        while (true)
         {
-            ret_flags &= ~(ERROR_BIT | ERROR_AFTER);
-            return ret_flags;
+            if (load_acquire (flags) & EXIT)
+            {
+                ret_flags |= load_acquire (flags);
+                ret_flags &= ~(ERROR_BIT | ERROR_AFTER);
+                return ret_flags;
+            }
+
+            slot = &slots[pos & mask];
+            long const diff = index_diff (load_acquire (slot->seq), pos);
+            if (diff == 0)
+            {
+                if (compare_and_swap (tail, pos, pos + 1))
+                    break;
+                pos = load_acquire (tail);
+            }
+            else if (diff < 0)
+            {
+                // The queue is full. Give the consumer a chance to run
+                // and block if it does not remove any event soon.
+                if (++spins < spin_limit)
+                {
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
+                    mguard.unlock ();
+                    thread::yield ();
+                    mguard.lock ();
+#else
+                    thread::yield ();
+#endif
+                }
+                else
+                {
+                    // Register as waiting producer before checking the
+                    // slot again, so that either the consumer sees this
+                    // producer waiting or this producer sees the free slot.
+                    // If another producer misses a signal because of the
+                    // reset, the consumer signals again after removing
+                    // the events that made the queue full.
+                    ev_producers.reset ();
+                    add_and_fetch (producers_waiting, 1);
+                    full_fence ();
+                    if (load_acquire (flags) & EXIT)
+                    {
+                        // Signal again in case the reset has hidden the
+                        // signal of signal_exit() from another producer.
+                        ev_producers.signal ();
+                    }
+                    else if (index_diff (load_acquire (slot->seq), pos) < 0)
+                    {
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
+                        mguard.unlock ();
+                        ev_producers.wait ();
+                        mguard.lock ();
+#else
+                        ev_producers.wait ();
+#endif
+                    }
+                    add_and_fetch (producers_waiting, ~0UL);
+                    spins = 0;
+                }
+                pos = load_acquire (tail);
+            }
+            else
+                pos = load_acquire (tail);
         }
-        else
+
+        ret_flags |= ERROR_AFTER;
+        try
         {
-            queue.push_back (ev);
-            ret_flags |= ERROR_AFTER;
-            semguard.detach ();
-            flags |= QUEUE;
-            ret_flags |= flags;
-            mguard.unlock ();
-            mguard.detach ();
-            ev_consumer.signal ();
+            slot->ev = ev;
+        }
+        catch (...)
+        {
+            // The slot has been claimed and must be published anyway,
+            // otherwise the consumer would stall on it.
+            store_release (slot->seq, pos + 1);
+            throw;
         }
+        store_release (slot->seq, pos + 1);
+        ret_flags |= load_acquire (flags) | QUEUE;
+
+        // Wake up the consumer only if it is waiting for events.
+        full_fence ();
+        if (load_acquire (consumer_waiting))
+            ev_consumer.signal ();
     }
     catch (STD_NAMESPACE runtime_error const & e)
     {
@@ -99,19 +227,25 @@ Queue::signal_exit (bool drain)
     {
         MutexGuard mguard (mutex);
 
-        ret_flags |= flags;
+        flags_type state = OFstatic_cast (flags_type, load_acquire (flags));
+        ret_flags |= state;
 
-        if (! (flags & EXIT))
+        if (! (state & EXIT))
         {
             if (drain)
-                flags |= DRAIN;
+                state |= DRAIN;
             else
-                flags &= ~DRAIN;
-            flags |= EXIT;
-            ret_flags = flags;
+                state &= ~DRAIN;
+            state |= EXIT;
+            store_release (flags, state);
+            ret_flags = state;
             mguard.unlock ();
             mguard.detach ();
             ev_consumer.signal ();
+
+            // Wake up producers waiting for a free slot.
+            full_fence ();
+            ev_producers.signal ();
         }
     }
     catch (STD_NAMESPACE runtime_error const & e)
@@ -129,48 +263,90 @@ Queue::flags_type
 Queue::get_events (queue_storage_type * buf)
 {
     flags_type ret_flags = 0;
+    unsigned spins = 0;
 
     try
     {
         while (true)
         {
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
             MutexGuard mguard (mutex);
+#endif
+            flags_type const state
+                = OFstatic_cast (flags_type, load_acquire (flags));
+            ret_flags = state;
 
-            ret_flags = flags;
-
-            if (((QUEUE & flags) && ! (EXIT & flags))
-                || ((EXIT | DRAIN | QUEUE) & flags) == (EXIT | DRAIN | QUEUE))
+            // Move all published events into the buffer. The events
+            // already in the buffer are swapped into the free slots, so
+            // that their storage is reused by the producers.
+            size_t count = 0;
+            while (event_available ())
             {
-                assert (! queue.empty ());
+                Slot & slot = slots[head & mask];
+                if (! (state & EXIT) || (state & DRAIN))
+                {
+                    if (count == buf->size ())
+                        buf->push_back (spi::InternalLoggingEvent ());
+                    (*buf)[count].swap (slot.ev);
+                    ++count;
+                }
+                store_release (slot.seq, head + mask + 1);
+                ++head;
+            }
+            buf->resize (count);
 
-                size_t const cnt = queue.size ();
-                queue.swap (*buf);
-                queue.clear ();
-                flags &= ~QUEUE;
-                for (size_t i = 0; i != cnt; ++i)
-                    sem.unlock ();
+            // Wake up producers waiting for free slots.
+            full_fence ();
+            if (load_acquire (producers_waiting) != 0)
+                ev_producers.signal ();
 
-                ret_flags = flags | EVENT;
+            if (count != 0)
+            {
+                ret_flags = state | EVENT;
                 break;
             }
-            else if (((EXIT | QUEUE) & flags) == (EXIT | QUEUE))
+            else if (state & EXIT)
             {
-                assert (! queue.empty ());
-                queue.clear ();
-                flags &= ~QUEUE;
-                ev_consumer.reset ();
-                sem.unlock ();
-                ret_flags = flags;
+                // A producer might still be storing an event into a slot
+                // it has claimed before the EXIT flag was set.
+                // It publishes the event and wakes up the consumer soon.
+                if ((state & DRAIN) && load_acquire (tail) != head)
+                {
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
+                    mguard.unlock ();
+                    mguard.detach ();
+#endif
+                    if (++spins < spin_limit)
+                        thread::yield ();
+                    else
+                    {
+                        ev_consumer.reset ();
+                        store_release (consumer_waiting, 1);
+                        full_fence ();
+                        if (! event_available ())
+                            ev_consumer.wait ();
+                        store_release (consumer_waiting, 0);
+                        spins = 0;
+                    }
+                    continue;
+                }
+
                 break;
             }
-            else if (EXIT & flags)
-                break;
             else
             {
                 ev_consumer.reset ();
-                mguard.unlock ();
-                mguard.detach ();
-                ev_consumer.wait ();
+                store_release (consumer_waiting, 1);
+                full_fence ();
+                if (! event_available () && ! (load_acquire (flags) & EXIT))
+                {
+#if ! defined (DCMTK_LOG4CPLUS_HAVE_LOCK_FREE_ATOMICS)
+                    mguard.unlock ();
+                    mguard.detach ();
+#endif
+                    ev_consumer.wait ();
+                }
+                store_release (consumer_waiting, 0);
             }
         }
     }